@@ -0,0 +1,243 @@
+#include <catch2/catch_all.hpp>
+#include "Math/Simd.h"
+#include "Physics/Collision.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Broadphase cost per step: move a fraction of the proxies, then UpdatePairs().
+ * Proxy density is constant, so larger scenes only add more of the same.
+ * Coherent motion favours sweep and prune; teleporting proxies favour the tree.
+ */
+
+namespace {
+
+    struct Scene {
+        std::unique_ptr<Physics::Broadphase> broadphase;
+        std::vector<Math::AABB>              bounds;
+        std::vector<float>                   speed;
+        std::vector<Physics::ProxyId>        proxies;
+        std::vector<Physics::ProxyPair>      pairs;
+        std::mt19937                         rng{ 3 };
+    };
+
+    void Populate(Scene& scene, Physics::BroadphaseType type, uint32_t count) {
+        scene.broadphase = Physics::Broadphase::Create(type);
+        const float half = std::sqrt(static_cast<float>(count)) * 2.5f;
+        std::uniform_real_distribution<float> p(-half, half);
+        std::uniform_real_distribution<float> h(0.0f, 6.0f);
+        std::uniform_real_distribution<float> e(0.3f, 1.2f);
+        std::uniform_real_distribution<float> v(0.02f, 0.15f);
+        for (uint32_t i = 0; i < count; ++i) {
+            scene.speed.push_back(v(scene.rng));
+            scene.bounds.push_back(Math::AABB::FromCenterExtents({ p(scene.rng), h(scene.rng), p(scene.rng) }, { e(scene.rng), e(scene.rng), e(scene.rng) }));
+            scene.proxies.push_back(scene.broadphase->CreateProxy(scene.bounds.back(), i));
+        }
+        scene.broadphase->UpdatePairs(scene.pairs);
+    }
+
+    // Moves the first `moving` proxies by a frame's worth of velocity and updates pairs
+    size_t Step(Scene& scene, uint32_t moving, int frame) {
+        for (uint32_t i = 0; i < moving; ++i) {
+            // Smooth per-proxy wander, like a crowd; varied speeds keep fat-box
+            // re-insertions spread over frames instead of all at once
+            const float angle = 0.37f * i + 0.05f * frame;
+            const Math::Vec3 d = Math::Vec3(std::cos(angle), 0.0f, std::sin(angle)) * scene.speed[i];
+            scene.bounds[i] = Math::AABB(scene.bounds[i].min + d, scene.bounds[i].max + d);
+            scene.broadphase->MoveProxy(scene.proxies[i], scene.bounds[i], d);
+        }
+        scene.broadphase->UpdatePairs(scene.pairs);
+        return scene.pairs.size();
+    }
+
+    // Respawns `count` proxies at random places (incoherent motion)
+    size_t Teleport(Scene& scene, uint32_t count, int frame) {
+        const float half = std::sqrt(static_cast<float>(scene.proxies.size())) * 2.5f;
+        std::uniform_real_distribution<float> p(-half, half);
+        for (uint32_t k = 0; k < count; ++k) {
+            const uint32_t i = static_cast<uint32_t>((uint64_t(frame) * count + k) % scene.proxies.size());
+            const Math::Vec3 d = Math::Vec3(p(scene.rng), 0.0f, p(scene.rng)) - scene.bounds[i].Center();
+            scene.bounds[i] = Math::AABB(scene.bounds[i].min + d, scene.bounds[i].max + d);
+            scene.broadphase->MoveProxy(scene.proxies[i], scene.bounds[i], Math::Vec3(0.0f));
+        }
+        scene.broadphase->UpdatePairs(scene.pairs);
+        return scene.pairs.size();
+    }
+
+    void RunBroadphaseBenchmarks(Physics::BroadphaseType type, const char* name) {
+        for (uint32_t count : { 10000u, 50000u, 200000u }) {
+            Scene scene;
+            Populate(scene, type, count);
+            for (uint32_t percent : { 1u, 10u, 50u }) {
+                const uint32_t moving = count * percent / 100;
+                int frame = 0;
+                while (frame < 30)
+                    Step(scene, moving, frame++);
+                BENCHMARK(std::string(name) + " " + std::to_string(count / 1000) + "k, " + std::to_string(percent) + "% moving") {
+                    return Step(scene, moving, frame++);
+                };
+            }
+            if (count <= 50000) {
+                int frame = 0;
+                BENCHMARK(std::string(name) + " " + std::to_string(count / 1000) + "k, 1% teleporting") {
+                    return Teleport(scene, count / 100, frame++);
+                };
+            }
+        }
+    }
+
+} // namespace
+
+TEST_CASE("Dynamic AABB tree broadphase", "[broadphase][!benchmark]") {
+    Threading::JobSystem::Init();
+    RunBroadphaseBenchmarks(Physics::BroadphaseType::DynamicTree, "Tree");
+    Threading::JobSystem::Shutdown();
+}
+
+TEST_CASE("Sweep and prune broadphase", "[broadphase][!benchmark]") {
+    RunBroadphaseBenchmarks(Physics::BroadphaseType::SweepAndPrune, "SAP");
+}
+
+/*
+ * Narrowphase: the batched kernels against their scalar references on 64k pairs,
+ * then full NarrowPhase::Collide() on broadphase pairs of a dense mixed scene.
+ */
+
+namespace {
+
+    Math::Vec3 RandomPoint(std::mt19937& rng, float range) {
+        std::uniform_real_distribution<float> p(-range, range);
+        return { p(rng), p(rng), p(rng) };
+    }
+
+    Physics::SegmentPairBatch MakeSegmentBatch(size_t count) {
+        std::mt19937 rng(11);
+        Physics::SegmentPairBatch batch;
+        batch.Resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Math::Vec3 ca = RandomPoint(rng, 1.0f), cb = RandomPoint(rng, 1.0f);
+            const Math::Vec3 axisA = RandomPoint(rng, 0.5f), axisB = (i % 2) ? RandomPoint(rng, 0.5f) : Math::Vec3(0.0f);
+            for (int k = 0; k < 3; ++k) {
+                batch.a0[k][i] = ca[k] - axisA[k];
+                batch.a1[k][i] = ca[k] + axisA[k];
+                batch.b0[k][i] = cb[k] - axisB[k];
+                batch.b1[k][i] = cb[k] + axisB[k];
+            }
+            batch.radiusA[i] = 0.3f;
+            batch.radiusB[i] = 0.4f;
+        }
+        return batch;
+    }
+
+    Physics::SphereBoxBatch MakeSphereBoxBatch(size_t count) {
+        std::mt19937 rng(12);
+        std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+        Physics::SphereBoxBatch batch;
+        batch.Resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Math::Quat q = Math::Quat::FromAxisAngle(Math::Normalize(RandomPoint(rng, 1.0f) + Math::Vec3(0.0f, 0.01f, 0.0f)), angle(rng));
+            const Math::Vec3 center = RandomPoint(rng, 1.5f);
+            const Math::Vec3 axes[3] = { Math::Rotate(q, { 1, 0, 0 }), Math::Rotate(q, { 0, 1, 0 }), Math::Rotate(q, { 0, 0, 1 }) };
+            for (int k = 0; k < 3; ++k) {
+                batch.center[k][i] = center[k];
+                batch.boxCenter[k][i] = 0.0f;
+                batch.axisX[k][i] = axes[0][k];
+                batch.axisY[k][i] = axes[1][k];
+                batch.axisZ[k][i] = axes[2][k];
+                batch.halfExtents[k][i] = 0.5f;
+            }
+            batch.radius[i] = 0.5f;
+        }
+        return batch;
+    }
+
+} // namespace
+
+TEST_CASE("Narrowphase kernels", "[narrowphase][!benchmark]") {
+    const size_t count = 65536;
+    Physics::SegmentPairBatch segments = MakeSegmentBatch(count);
+    Physics::SphereBoxBatch sphereBoxes = MakeSphereBoxBatch(count);
+
+    BENCHMARK(std::string("Segment pairs 64k, ") + Math::GetSimdName()) {
+        Physics::CollideSegments(segments, 0, count);
+        return segments.depth[count - 1];
+    };
+    BENCHMARK("Segment pairs 64k, scalar reference") {
+        Physics::Scalar::CollideSegments(segments, 0, count);
+        return segments.depth[count - 1];
+    };
+    BENCHMARK(std::string("Sphere-box pairs 64k, ") + Math::GetSimdName()) {
+        Physics::CollideSphereBoxes(sphereBoxes, 0, count);
+        return sphereBoxes.depth[count - 1];
+    };
+    BENCHMARK("Sphere-box pairs 64k, scalar reference") {
+        Physics::Scalar::CollideSphereBoxes(sphereBoxes, 0, count);
+        return sphereBoxes.depth[count - 1];
+    };
+}
+
+TEST_CASE("Narrowphase step", "[narrowphase][!benchmark]") {
+    static const Math::Vec3 kHull[8] = {
+        { -0.4f, -0.4f, -0.4f }, { 0.4f, -0.4f, -0.4f }, { -0.4f, 0.4f, -0.4f }, { 0.4f, 0.4f, -0.4f },
+        { -0.4f, -0.4f, 0.4f },  { 0.4f, -0.4f, 0.4f },  { -0.4f, 0.4f, 0.4f },  { 0.4f, 0.4f, 0.4f },
+    };
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+
+    // Spheres and capsules first, so the scene can be cut down to kernel-only pairs
+    const uint32_t count = 40000;
+    std::vector<Physics::CollisionShape> shapes;
+    std::vector<Math::Vec3> positions;
+    std::vector<Math::Quat> rotations;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float kind = float(i) / count;
+        if (kind < 0.4f)
+            shapes.push_back(Physics::CollisionShape::Sphere(0.4f));
+        else if (kind < 0.6f)
+            shapes.push_back(Physics::CollisionShape::Capsule(0.3f, 0.4f));
+        else if (kind < 0.95f)
+            shapes.push_back(Physics::CollisionShape::Box({ 0.3f + 0.2f * unit(rng), 0.3f + 0.2f * unit(rng), 0.3f + 0.2f * unit(rng) }));
+        else
+            shapes.push_back(Physics::CollisionShape::ConvexHull(kHull, 8));
+        positions.push_back(RandomPoint(rng, 22.0f));
+        rotations.push_back(Math::Quat::FromAxisAngle(Math::Normalize(RandomPoint(rng, 1.0f) + Math::Vec3(0.0f, 0.01f, 0.0f)), angle(rng)));
+    }
+    std::shuffle(positions.begin(), positions.end(), rng);
+
+    Physics::DynamicAABBTree tree;
+    for (uint32_t i = 0; i < count; ++i)
+        tree.CreateProxy(shapes[i].ComputeAABB(positions[i], rotations[i]), i);
+    std::vector<Physics::ProxyPair> proxyPairs;
+    tree.UpdatePairs(proxyPairs);
+    std::vector<Physics::BodyPair> all, primitives;
+    for (const Physics::ProxyPair& pair : proxyPairs) {
+        const Physics::BodyPair bodies = { tree.GetUserData(pair.a), tree.GetUserData(pair.b) };
+        all.push_back(bodies);
+        if (std::max(bodies.a, bodies.b) < count * 6 / 10)
+            primitives.push_back(bodies);
+    }
+    WARN("Narrowphase scene: " << all.size() << " pairs, " << primitives.size() << " sphere/capsule pairs");
+
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        if (threaded)
+            Threading::JobSystem::Init();
+        const std::string suffix = threaded ? ", job system" : ", one thread";
+        Physics::NarrowPhase narrowPhase;
+        BENCHMARK("Sphere/capsule pairs" + suffix) {
+            narrowPhase.Collide(shapes.data(), positions.data(), rotations.data(), primitives.data(), static_cast<uint32_t>(primitives.size()));
+            return narrowPhase.GetManifolds().size();
+        };
+        BENCHMARK("Mixed pairs" + suffix) {
+            narrowPhase.Collide(shapes.data(), positions.data(), rotations.data(), all.data(), static_cast<uint32_t>(all.size()));
+            return narrowPhase.GetManifolds().size();
+        };
+        if (threaded)
+            Threading::JobSystem::Shutdown();
+    }
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch_all.hpp>
+#include "Math/Batch.h"
+#include "Memory/LinearAllocator.h"
+#include "Renderer/CommandBucket.h"
+#include "Renderer/Culling.h"
+#include "Threading/JobSystem.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * Frustum culling of a large open scene, and culling feeding the command bucket.
+ */
+
+TEST_CASE("BVH frustum culling", "[culling][!benchmark]") {
+    Threading::JobSystem::Init();
+
+    const uint32_t count = 250000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> p(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> e(0.5f, 4.0f);
+
+    Renderer::CullingBVH bvh;
+    std::vector<Renderer::CullProxy> proxies(count);
+    for (uint32_t i = 0; i < count; ++i)
+        proxies[i] = bvh.Insert(Math::AABB::FromCenterExtents({ p(rng), p(rng) * 0.05f, p(rng) }, { e(rng), e(rng), e(rng) }), i);
+    bvh.Update();
+
+    Math::Mat4 viewProj = Math::Mat4::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 600.0f)
+                        * Math::Mat4::LookAt({ 0.0f, 20.0f, 0.0f }, { 100.0f, 0.0f, 60.0f }, { 0.0f, 1.0f, 0.0f });
+    Math::Frustum frustum = Math::Frustum::FromMatrix(viewProj);
+    LinearAllocator scratch(count * sizeof(uint32_t) * 2, "CullScratch");
+
+    BENCHMARK("Brute-force CullAABBs 250k") {
+        // Reference point: SoA kernel over every object, no hierarchy
+        static std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+        if (minX.empty()) {
+            for (Renderer::CullProxy proxy : proxies) {
+                const Math::AABB& b = bvh.GetBounds(proxy);
+                minX.push_back(b.min.x); minY.push_back(b.min.y); minZ.push_back(b.min.z);
+                maxX.push_back(b.max.x); maxY.push_back(b.max.y); maxZ.push_back(b.max.z);
+            }
+        }
+        scratch.Reset();
+        uint32_t* out = scratch.AllocateArray<uint32_t>(count);
+        return Math::CullAABBs(frustum, { minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() }, count, out);
+    };
+
+    BENCHMARK("BVH cull 250k") {
+        scratch.Reset();
+        return bvh.Cull(frustum, scratch).count;
+    };
+
+    BENCHMARK("Move 10% + refit 250k") {
+        for (uint32_t i = 0; i < count; i += 10) {
+            Math::AABB b = bvh.GetBounds(proxies[i]);
+            Math::Vec3 offset(0.01f, 0.0f, -0.01f);
+            bvh.Move(proxies[i], { b.min + offset, b.max + offset });
+        }
+        bvh.Update();
+    };
+
+    BENCHMARK("Full rebuild 250k") {
+        bvh.Remove(bvh.Insert(Math::AABB(), 0));
+        bvh.Update();
+    };
+
+    Renderer::CommandBucket bucket;
+    BENCHMARK("Cull + record + sort 250k") {
+        scratch.Reset();
+        bucket.Reset();
+        Renderer::VisibleList visible = bvh.Cull(frustum, scratch);
+
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, visible.count, 1024, [&](Threading::JobArgs args) {
+            uint32_t item = visible.items[args.jobIndex];
+            Renderer::DrawCommand command;
+            command.shader = item % 32;
+            command.material = item % 512;
+            command.mesh = item;
+            bucket.Submit(Renderer::SortKey::Make(0, 0, command.shader, command.material, 0), command);
+        });
+        Threading::JobSystem::Wait(ctx);
+        bucket.Sort();
+        return bucket.GetCount();
+    };
+
+    Threading::JobSystem::Shutdown();
+}
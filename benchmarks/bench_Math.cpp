@@ -0,0 +1,89 @@
+#include <catch2/catch_all.hpp>
+#include "Math/Batch.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * Per-kernel benchmarks: each batch kernel against its Math::Scalar reference.
+ * The compiled SIMD path is part of the benchmark names (see Math::GetSimdName()).
+ */
+
+namespace {
+
+    constexpr size_t kCount = 100000;
+
+    struct BenchData {
+        std::vector<float> x, y, z, outX, outY, outZ;
+        std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+        std::vector<Math::Mat4> a, b, product;
+        std::vector<uint32_t> indices;
+
+        BenchData() {
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+            std::uniform_real_distribution<float> size(0.1f, 5.0f);
+
+            for (auto* v : { &x, &y, &z, &outX, &outY, &outZ, &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+                v->resize(kCount);
+            for (size_t i = 0; i < kCount; ++i) {
+                x[i] = pos(rng); y[i] = pos(rng); z[i] = pos(rng);
+                minX[i] = x[i]; minY[i] = y[i]; minZ[i] = z[i];
+                maxX[i] = x[i] + size(rng); maxY[i] = y[i] + size(rng); maxZ[i] = z[i] + size(rng);
+            }
+
+            a.resize(kCount);
+            b.resize(kCount);
+            product.resize(kCount);
+            for (size_t i = 0; i < kCount; ++i) {
+                a[i] = Math::Mat4::FromTRS({ pos(rng), pos(rng), pos(rng) },
+                    Math::Quat::FromAxisAngle({ pos(rng), pos(rng), 1.0f }, pos(rng)), Math::Vec3(size(rng)));
+                b[i] = Math::Mat4::Translation({ pos(rng), pos(rng), pos(rng) });
+            }
+            indices.resize(kCount);
+        }
+
+        Math::AABBSoA Boxes() const {
+            return { minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() };
+        }
+    };
+
+} // namespace
+
+TEST_CASE("Math batch kernels", "[math][!benchmark]") {
+    static BenchData data;
+    const Math::Mat4 m = Math::Mat4::FromTRS({ 1.0f, 2.0f, 3.0f },
+        Math::Quat::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, 0.5f), Math::Vec3(2.0f));
+    const Math::AABB query({ -20.0f, -20.0f, -20.0f }, { 20.0f, 20.0f, 20.0f });
+    const std::string simd = Math::GetSimdName();
+
+    BENCHMARK("TransformPoints 100k [" + simd + "]") {
+        Math::TransformPoints(m, { data.x.data(), data.y.data(), data.z.data() },
+                              { data.outX.data(), data.outY.data(), data.outZ.data() }, kCount);
+        return data.outX[kCount - 1];
+    };
+
+    BENCHMARK("TransformPoints 100k [Scalar reference]") {
+        Math::Scalar::TransformPoints(m, { data.x.data(), data.y.data(), data.z.data() },
+                                      { data.outX.data(), data.outY.data(), data.outZ.data() }, kCount);
+        return data.outX[kCount - 1];
+    };
+
+    BENCHMARK("MultiplyMatrices 100k [" + simd + "]") {
+        Math::MultiplyMatrices(data.a.data(), data.b.data(), data.product.data(), kCount);
+        return data.product[kCount - 1].columns[3].x;
+    };
+
+    BENCHMARK("MultiplyMatrices 100k [Scalar reference]") {
+        Math::Scalar::MultiplyMatrices(data.a.data(), data.b.data(), data.product.data(), kCount);
+        return data.product[kCount - 1].columns[3].x;
+    };
+
+    BENCHMARK("OverlapAABBs 100k [" + simd + "]") {
+        return Math::OverlapAABBs(query, data.Boxes(), kCount, data.indices.data());
+    };
+
+    BENCHMARK("OverlapAABBs 100k [Scalar reference]") {
+        return Math::Scalar::OverlapAABBs(query, data.Boxes(), kCount, data.indices.data());
+    };
+}
@@ -0,0 +1,229 @@
+#include <catch2/catch_all.hpp>
+#include "IO/AssetLoader.h"
+#include "IO/ContentCooker.h"
+#include "IO/CookedAsset.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstring>
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Offline mesh import stages on a ~500k triangle height field, plus the
+ * vertex-cache win they buy (ACMR, reported once). Then loading a mesh at
+ * runtime from OBJ source against loading its cooked blob, and incremental
+ * content builds.
+ */
+
+namespace {
+
+    IO::MeshData MakeTerrain(uint32_t n) {
+        IO::MeshData mesh;
+        mesh.vertices.reserve((n + 1) * (n + 1));
+        for (uint32_t z = 0; z <= n; ++z) {
+            for (uint32_t x = 0; x <= n; ++x) {
+                IO::MeshVertex v;
+                v.position = { float(x), 4.0f * std::sin(x * 0.05f) * std::cos(z * 0.07f) + std::sin(x * 0.9f + z * 0.4f) * 0.3f, float(z) };
+                v.normal = { 0.0f, 1.0f, 0.0f };
+                v.u = float(x) / n;
+                v.v = float(z) / n;
+                mesh.vertices.push_back(v);
+            }
+        }
+        // Shuffled triangle order, as a naive exporter might write it
+        std::vector<uint32_t> quads(n * n);
+        for (uint32_t i = 0; i < quads.size(); ++i)
+            quads[i] = i;
+        std::shuffle(quads.begin(), quads.end(), std::mt19937(5));
+        for (uint32_t q : quads) {
+            const uint32_t i = (q / n) * (n + 1) + q % n;
+            mesh.indices.insert(mesh.indices.end(), { i, i + n + 1, i + 1, i + 1, i + n + 1, i + n + 2 });
+        }
+        return mesh;
+    }
+
+    void WriteOBJ(const IO::MeshData& mesh, const std::string& path) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        for (const IO::MeshVertex& v : mesh.vertices) {
+            out << "v " << v.position.x << ' ' << v.position.y << ' ' << v.position.z << "\nvt " << v.u << ' ' << v.v
+                << "\nvn " << v.normal.x << ' ' << v.normal.y << ' ' << v.normal.z << '\n';
+        }
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            out << 'f';
+            for (size_t k = 0; k < 3; ++k) {
+                const uint32_t index = mesh.indices[i + k] + 1;
+                out << ' ' << index << '/' << index << '/' << index;
+            }
+            out << '\n';
+        }
+    }
+
+#if defined(__linux__)
+    // A field of /proc/self/status, in KiB
+    long ReadStatusKiB(const char* field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind(field, 0) == 0)
+                return std::stol(line.substr(std::strlen(field) + 1));
+        }
+        return 0;
+    }
+#endif
+
+    // Peak resident memory added by running fn once, in KiB, measured in a
+    // forked child so nothing it allocates or frees lingers in the benchmark
+    long PeakMemoryKiB(const std::function<void()>& fn) {
+#if defined(__linux__)
+        int channel[2];
+        if (::pipe(channel) != 0)
+            return 0;
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            // Freed heap pages would be reused without showing up as new residency;
+            // then the high-water mark is reset to what is left
+            ::malloc_trim(0);
+            std::ofstream("/proc/self/clear_refs") << "5";
+            const long before = ReadStatusKiB("VmRSS:");
+            fn();
+            const long peak = ReadStatusKiB("VmHWM:") - before;
+            (void)!::write(channel[1], &peak, sizeof(peak));
+            ::_exit(0);
+        }
+        long peak = 0;
+        if (::read(channel[0], &peak, sizeof(peak)) != sizeof(peak))
+            peak = 0;
+        ::waitpid(pid, nullptr, 0);
+        ::close(channel[0]);
+        ::close(channel[1]);
+        return peak;
+#else
+        (void)fn;
+        return 0;
+#endif
+    }
+
+} // namespace
+
+TEST_CASE("Mesh import stages", "[mesh][!benchmark]") {
+    const IO::MeshData source = MakeTerrain(500);
+    const size_t triangles = source.indices.size() / 3;
+
+    {
+        std::vector<uint32_t> indices = source.indices;
+        const float before = IO::ComputeACMR(indices.data(), indices.size(), source.vertices.size());
+        IO::OptimizeVertexCache(indices.data(), indices.size(), source.vertices.size());
+        const float after = IO::ComputeACMR(indices.data(), indices.size(), source.vertices.size());
+        WARN("ACMR (16-entry FIFO) " << before << " -> " << after << " on " << triangles << " triangles");
+    }
+
+    BENCHMARK("OptimizeVertexCache 500k tris") {
+        std::vector<uint32_t> indices = source.indices;
+        IO::OptimizeVertexCache(indices.data(), indices.size(), source.vertices.size());
+        return indices[0];
+    };
+
+    BENCHMARK("OptimizeVertexFetch 500k tris") {
+        IO::MeshData mesh = source;
+        return IO::OptimizeVertexFetch(mesh);
+    };
+
+    BENCHMARK("Quantize 250k verts") {
+        return IO::Quantize(source).vertices.size();
+    };
+
+    BENCHMARK("Simplify 500k -> 250k tris") {
+        return IO::Simplify(source, source.indices, source.indices.size() / 2).size();
+    };
+
+    BENCHMARK("BuildMeshlets 500k tris") {
+        return IO::BuildMeshlets(source, source.indices.data(), source.indices.size()).meshlets.size();
+    };
+
+    BENCHMARK("Full ImportMesh 500k tris") {
+        return IO::AssetLoader::ImportMesh(source).lods.size();
+    };
+}
+
+TEST_CASE("Runtime mesh load: OBJ source vs cooked blob", "[mesh][!benchmark]") {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string objPath = (dir / "engine_bench_terrain.obj").string();
+    const std::string cookedPath = (dir / "engine_bench_terrain.mesh").string();
+    WriteOBJ(MakeTerrain(200), objPath);
+    {
+        IO::MeshData mesh;
+        IO::AssetLoader::LoadOBJ(objPath, mesh);
+        const std::vector<uint8_t> blob = IO::CookMesh(IO::AssetLoader::ImportMesh(std::move(mesh)));
+        std::ofstream(cookedPath, std::ios::binary).write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    }
+    WARN("OBJ " << std::filesystem::file_size(objPath) / 1024 << " KiB, cooked " << std::filesystem::file_size(cookedPath) / 1024 << " KiB");
+
+    auto loadSource = [&] {
+        IO::MeshData mesh;
+        IO::AssetLoader::LoadOBJ(objPath, mesh);
+        return IO::AssetLoader::ImportMesh(std::move(mesh)).lods.size();
+    };
+    auto loadCooked = [&] { return IO::LoadCookedMesh(cookedPath)->lods.size(); };
+    WARN("Peak memory: OBJ parse + import " << PeakMemoryKiB([&] { loadSource(); }) << " KiB, cooked load "
+         << PeakMemoryKiB([&] { loadCooked(); }) << " KiB");
+
+    BENCHMARK("OBJ parse only, 80k tris") {
+        IO::MeshData mesh;
+        IO::AssetLoader::LoadOBJ(objPath, mesh);
+        return mesh.indices.size();
+    };
+    BENCHMARK("OBJ parse + ImportMesh, 80k tris") {
+        return loadSource();
+    };
+    BENCHMARK("Cooked load + fixup, 80k tris") {
+        return loadCooked();
+    };
+}
+
+TEST_CASE("Content build: full vs incremental", "[mesh][!benchmark]") {
+    namespace fs = std::filesystem;
+    const fs::path source = fs::temp_directory_path() / "engine_bench_content";
+    const fs::path output = fs::temp_directory_path() / "engine_bench_content_cooked";
+    fs::remove_all(source);
+    fs::remove_all(output);
+    fs::create_directories(source / "meshes");
+    fs::create_directories(source / "textures");
+    const IO::MeshData terrain = MakeTerrain(64);
+    for (int i = 0; i < 16; ++i)
+        WriteOBJ(terrain, (source / ("meshes/terrain" + std::to_string(i) + ".obj")).string());
+    const std::string texture(1 << 20, 't');
+    for (int i = 0; i < 16; ++i)
+        std::ofstream(source / ("textures/albedo" + std::to_string(i) + ".dds"), std::ios::binary) << texture;
+
+    Threading::JobSystem::Init();
+    IO::ContentCooker cooker(source.string(), output.string());
+    cooker.Cook();
+
+    BENCHMARK("Full rebuild, 16 meshes + 16 MiB textures") {
+        fs::remove_all(output);
+        return cooker.Cook().cooked;
+    };
+    BENCHMARK("No-op build") {
+        return cooker.Cook().upToDate;
+    };
+    uint32_t edit = 0;
+    BENCHMARK("One texture changed") {
+        std::ofstream(source / "textures/albedo3.dds", std::ios::binary) << texture << ++edit;
+        return cooker.Cook().cooked;
+    };
+    Threading::JobSystem::Shutdown();
+    fs::remove_all(source);
+    fs::remove_all(output);
+}
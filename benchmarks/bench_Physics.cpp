@@ -0,0 +1,326 @@
+#include <catch2/catch_all.hpp>
+#include "Physics/Physics.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Rigid-body step cost against the number of threads. Islands are the unit of
+ * parallelism, so both scenes are many independent piles: box stacks, and heaps
+ * of jointed capsule ragdolls. Sleeping is off so every body is solved every step.
+ * One thread runs without the job system; N threads are N - 1 workers plus the
+ * caller.
+ */
+
+namespace {
+
+    constexpr float kDt = 1.0f / 60.0f;
+
+    void AddGround(Physics::PhysicsWorld& world) {
+        Physics::BodyDesc desc;
+        desc.type = Physics::BodyType::Static;
+        desc.shape = Physics::CollisionShape::Box({ 200.0f, 0.5f, 200.0f });
+        desc.position = { 0.0f, -0.5f, 0.0f };
+        world.CreateBody(desc);
+    }
+
+    // 100 stacks of 10 boxes
+    std::unique_ptr<Physics::PhysicsWorld> MakeStacks() {
+        auto world = std::make_unique<Physics::PhysicsWorld>();
+        AddGround(*world);
+        Physics::BodyDesc desc;
+        desc.shape = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+        desc.allowSleep = false;
+        for (int x = 0; x < 10; ++x) {
+            for (int z = 0; z < 10; ++z) {
+                for (int i = 0; i < 10; ++i) {
+                    desc.position = { x * 3.0f, 0.5f + 1.001f * i, z * 3.0f };
+                    world->CreateBody(desc);
+                }
+            }
+        }
+        return world;
+    }
+
+    // 25 heaps of 8 ragdolls: a capsule torso with a head, arms and legs on ball joints
+    std::unique_ptr<Physics::PhysicsWorld> MakeRagdolls() {
+        auto world = std::make_unique<Physics::PhysicsWorld>();
+        AddGround(*world);
+        Physics::BodyDesc desc;
+        desc.allowSleep = false;
+        for (int heap = 0; heap < 25; ++heap) {
+            const Math::Vec3 base((heap % 5) * 8.0f, 1.0f, (heap / 5) * 8.0f);
+            for (int doll = 0; doll < 8; ++doll) {
+                const Math::Quat turn = Math::Quat::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, doll * 0.8f);
+                const Math::Vec3 origin = base + Math::Vec3(0.0f, doll * 1.2f, 0.0f);
+                auto at = [&](float x, float y) { return origin + Math::Rotate(turn, { x, 0.0f, y }); };
+                // Lying flat: the body axis runs along local z
+                const Math::Quat flat = turn * Math::Quat::FromAxisAngle({ 1.0f, 0.0f, 0.0f }, 1.5707963f);
+
+                desc.rotation = flat;
+                desc.shape = Physics::CollisionShape::Capsule(0.2f, 0.3f);
+                desc.position = at(0.0f, 0.0f);
+                const Physics::BodyId torso = world->CreateBody(desc);
+                desc.shape = Physics::CollisionShape::Sphere(0.15f);
+                desc.position = at(0.0f, 0.7f);
+                world->CreateBallJoint(torso, world->CreateBody(desc), at(0.0f, 0.55f));
+
+                desc.shape = Physics::CollisionShape::Capsule(0.08f, 0.25f);
+                for (float side : { -1.0f, 1.0f }) {
+                    desc.position = at(side * 0.32f, 0.05f);
+                    world->CreateBallJoint(torso, world->CreateBody(desc), at(side * 0.32f, 0.38f));
+                    desc.position = at(side * 0.12f, -0.88f);
+                    world->CreateBallJoint(torso, world->CreateBody(desc), at(side * 0.12f, -0.55f));
+                }
+            }
+        }
+        return world;
+    }
+
+    template <typename MakeScene>
+    void RunScalingBenchmarks(const std::string& name, MakeScene makeScene) {
+        const uint32_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+        for (uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+            if (threads > 1)
+                Threading::JobSystem::Init(threads - 1);
+            std::unique_ptr<Physics::PhysicsWorld> world = makeScene();
+            for (int i = 0; i < 90; ++i)
+                world->Step(kDt);
+            if (threads == 1) {
+                const uint32_t bodies = world->GetBodyCount(), islands = world->GetIslandCount(), contacts = world->GetContactCount();
+                WARN(name << ": " << bodies << " bodies, " << islands << " islands, " << contacts << " manifolds");
+            }
+            BENCHMARK(name + ", " + std::to_string(threads) + (threads == 1 ? " thread" : " threads")) {
+                world->Step(kDt);
+                return world->GetContactCount();
+            };
+            if (threads > 1)
+                Threading::JobSystem::Shutdown();
+        }
+    }
+
+} // namespace
+
+TEST_CASE("Rigid-body step scaling", "[physics][!benchmark]") {
+    RunScalingBenchmarks("Box stacks", MakeStacks);
+    RunScalingBenchmarks("Ragdoll heaps", MakeRagdolls);
+}
+
+/*
+ * Scene query throughput on a static field of 20k mixed shapes. Coherent rays are
+ * a 128x128 camera grid in scanline order, so each SIMD packet shares a tree path;
+ * incoherent rays start and point anywhere. Issuing the same rays one call at a
+ * time shows what the batch saves.
+ */
+
+namespace {
+
+    std::unique_ptr<Physics::PhysicsWorld> MakeQueryField() {
+        static const Math::Vec3 kHull[8] = {
+            { -0.4f, -0.4f, -0.4f }, { 0.4f, -0.4f, -0.4f }, { -0.4f, 0.4f, -0.4f }, { 0.4f, 0.4f, -0.4f },
+            { -0.4f, -0.4f, 0.4f },  { 0.4f, -0.4f, 0.4f },  { -0.4f, 0.4f, 0.4f },  { 0.4f, 0.4f, 0.4f },
+        };
+        auto world = std::make_unique<Physics::PhysicsWorld>();
+        AddGround(*world);
+        std::mt19937 rng(29);
+        std::uniform_real_distribution<float> p(-100.0f, 100.0f), h(0.0f, 4.0f), size(0.3f, 1.0f), angle(-3.0f, 3.0f);
+        Physics::BodyDesc desc;
+        desc.type = Physics::BodyType::Static;
+        for (int i = 0; i < 20000; ++i) {
+            switch (i % 8) {
+            case 0: case 1: case 2: desc.shape = Physics::CollisionShape::Box({ size(rng), size(rng) * 2.0f, size(rng) }); break;
+            case 3: case 4: desc.shape = Physics::CollisionShape::Capsule(size(rng) * 0.5f, size(rng)); break;
+            case 5: case 6: desc.shape = Physics::CollisionShape::Sphere(size(rng)); break;
+            default: desc.shape = Physics::CollisionShape::ConvexHull(kHull, 8); break;
+            }
+            desc.position = { p(rng), h(rng), p(rng) };
+            desc.rotation = Math::Quat::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, angle(rng));
+            world->CreateBody(desc);
+        }
+        return world;
+    }
+
+    std::vector<Physics::RayQuery> MakeCameraRays() {
+        std::vector<Physics::RayQuery> rays;
+        const Math::Vec3 eye(-90.0f, 6.0f, -90.0f);
+        const Math::Vec3 forward = Math::Normalize(Math::Vec3(1.0f, -0.08f, 1.0f));
+        const Math::Vec3 right = Math::Normalize(Math::Cross(forward, { 0.0f, 1.0f, 0.0f }));
+        const Math::Vec3 up = Math::Cross(right, forward);
+        for (int y = 0; y < 128; ++y) {
+            for (int x = 0; x < 128; ++x) {
+                Physics::RayQuery ray;
+                ray.origin = eye;
+                ray.direction = Math::Normalize(forward + right * ((x - 63.5f) / 128.0f) + up * ((y - 63.5f) / 256.0f));
+                ray.maxDistance = 300.0f;
+                rays.push_back(ray);
+            }
+        }
+        return rays;
+    }
+
+    std::vector<Physics::RayQuery> MakeRandomRays(size_t count) {
+        std::mt19937 rng(31);
+        std::uniform_real_distribution<float> p(-100.0f, 100.0f), d(-1.0f, 1.0f), h(0.5f, 8.0f);
+        std::vector<Physics::RayQuery> rays(count);
+        for (Physics::RayQuery& ray : rays) {
+            ray.origin = { p(rng), h(rng), p(rng) };
+            ray.direction = Math::Normalize(Math::Vec3(d(rng), d(rng) * 0.3f - 0.05f, d(rng)));
+            ray.maxDistance = 60.0f;
+        }
+        return rays;
+    }
+
+} // namespace
+
+TEST_CASE("Scene queries", "[physics][!benchmark]") {
+    std::unique_ptr<Physics::PhysicsWorld> world = MakeQueryField();
+    const std::vector<Physics::RayQuery> coherent = MakeCameraRays();
+    const std::vector<Physics::RayQuery> incoherent = MakeRandomRays(coherent.size());
+    std::vector<Physics::QueryHit> hits(coherent.size());
+    const uint32_t count = static_cast<uint32_t>(coherent.size());
+
+    std::vector<Physics::ShapeCastQuery> casts(1024);
+    std::vector<Physics::OverlapQuery> overlaps(1024);
+    for (size_t i = 0; i < casts.size(); ++i) {
+        casts[i].shape = Physics::CollisionShape::Capsule(0.3f, 0.6f);
+        casts[i].position = incoherent[i].origin;
+        casts[i].direction = incoherent[i].direction;
+        casts[i].maxDistance = 20.0f;
+        overlaps[i].shape = Physics::CollisionShape::Sphere(2.0f);
+        overlaps[i].position = incoherent[i].origin;
+    }
+    std::vector<Physics::BodyId> touching(overlaps.size() * 16);
+    std::vector<uint32_t> touchingCounts(overlaps.size());
+
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        if (threaded)
+            Threading::JobSystem::Init();
+        const std::string suffix = threaded ? ", job system" : ", one thread";
+        BENCHMARK("16k coherent rays" + suffix) {
+            world->RayCast(coherent.data(), count, hits.data());
+            return hits.back().distance;
+        };
+        BENCHMARK("16k incoherent rays" + suffix) {
+            world->RayCast(incoherent.data(), count, hits.data());
+            return hits.back().distance;
+        };
+        BENCHMARK("1k capsule casts" + suffix) {
+            world->ShapeCast(casts.data(), static_cast<uint32_t>(casts.size()), hits.data());
+            return hits.front().distance;
+        };
+        BENCHMARK("1k sphere overlaps" + suffix) {
+            world->Overlap(overlaps.data(), static_cast<uint32_t>(overlaps.size()), touching.data(), 16, touchingCounts.data());
+            return touchingCounts.back();
+        };
+        if (threaded)
+            Threading::JobSystem::Shutdown();
+    }
+
+    BENCHMARK("16k coherent rays, one call per ray") {
+        for (uint32_t i = 0; i < count; ++i)
+            world->RayCast(&coherent[i], 1, &hits[i]);
+        return hits.back().distance;
+    };
+}
+
+/*
+ * Rollback on a 5k-body scene: 2.5k static props, 150 sleeping box stacks and
+ * 1k spheres that never sleep. A rollback restores the snapshot from 8 frames
+ * back and resimulates those frames, saving each into a ring of 8 snapshots.
+ * Delta snapshots copy only the bodies that moved since the ring slot was last
+ * written, so the sleeping and static bodies cost nothing.
+ */
+
+namespace {
+
+    std::unique_ptr<Physics::PhysicsWorld> MakeRollbackScene() {
+        auto world = std::make_unique<Physics::PhysicsWorld>();
+        AddGround(*world);
+        std::mt19937 rng(37);
+        std::uniform_real_distribution<float> p(0.0f, 1.0f), v(-2.0f, 2.0f);
+
+        Physics::BodyDesc desc;
+        desc.type = Physics::BodyType::Static;
+        for (int i = 0; i < 2500; ++i) {
+            desc.shape = Physics::CollisionShape::Box({ 0.2f + 0.5f * p(rng), 0.5f + p(rng), 0.2f + 0.5f * p(rng) });
+            desc.position = { -100.0f + 200.0f * p(rng), 0.5f, 50.0f + 50.0f * p(rng) };
+            world->CreateBody(desc);
+        }
+
+        desc = Physics::BodyDesc();
+        desc.shape = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+        for (int s = 0; s < 150; ++s) {
+            for (int i = 0; i < 10; ++i) {
+                desc.position = { (s % 15) * 3.0f, 0.5f + 1.001f * i, (s / 15) * 3.0f };
+                world->CreateBody(desc);
+            }
+        }
+        for (int i = 0; i < 90 * 4; ++i)
+            world->Step(kDt);
+
+        desc.shape = Physics::CollisionShape::Sphere(0.4f);
+        desc.allowSleep = false;
+        for (int i = 0; i < 1000; ++i) {
+            desc.position = { -90.0f + 50.0f * p(rng), 0.4f + 2.0f * p(rng), -40.0f + 80.0f * p(rng) };
+            desc.linearVelocity = { v(rng), 0.0f, v(rng) };
+            world->CreateBody(desc);
+        }
+        for (int i = 0; i < 30; ++i)
+            world->Step(kDt);
+        return world;
+    }
+
+} // namespace
+
+TEST_CASE("Physics rollback", "[physics][!benchmark]") {
+    constexpr int kRollbackFrames = 8;
+    std::unique_ptr<Physics::PhysicsWorld> world = MakeRollbackScene();
+    WARN(world->GetBodyCount() << " bodies, " << world->GetAwakeBodyCount() << " awake, "
+         << world->GetSleepingIslandCount() << " sleeping islands");
+
+    for (Physics::SnapshotMode mode : { Physics::SnapshotMode::Full, Physics::SnapshotMode::Delta }) {
+        const std::string name = (mode == Physics::SnapshotMode::Full) ? "full" : "delta";
+        std::vector<Physics::PhysicsSnapshot> ring(kRollbackFrames);
+        for (int frame = 0; frame < kRollbackFrames; ++frame) {
+            world->SaveSnapshot(ring[frame], mode);
+            world->Step(kDt);
+        }
+        if (mode == Physics::SnapshotMode::Full)
+            WARN("Snapshot: " << ring[0].GetSize() / 1024 << " KiB");
+
+        BENCHMARK("Save and step, " + name) {
+            world->SaveSnapshot(ring[0], mode);
+            world->Step(kDt);
+            return world->GetContactCount();
+        };
+        BENCHMARK("8-frame rollback, " + name) {
+            world->RestoreSnapshot(ring[0], mode);
+            for (int frame = 0; frame < kRollbackFrames; ++frame) {
+                world->SaveSnapshot(ring[frame], mode);
+                world->Step(kDt);
+            }
+            return world->GetContactCount();
+        };
+    }
+
+    Physics::PhysicsSnapshot snapshot;
+    world->SaveSnapshot(snapshot);
+    BENCHMARK("Save, full") {
+        world->SaveSnapshot(snapshot);
+        return snapshot.GetSize();
+    };
+    BENCHMARK("Restore, full") {
+        world->RestoreSnapshot(snapshot);
+        return world->GetBodyCount();
+    };
+    BENCHMARK("Step") {
+        world->Step(kDt);
+        return world->GetContactCount();
+    };
+}
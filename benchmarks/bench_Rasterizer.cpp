@@ -0,0 +1,100 @@
+#include <catch2/catch_all.hpp>
+#include "Renderer/SoftwareRasterizer.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+/*
+ * Reference scene: a city block grid of box occluders rasterized into a
+ * low-resolution depth buffer, then small occludees scattered between them.
+ */
+
+namespace {
+
+    void AppendBox(const Math::AABB& box, std::vector<Math::Vec3>& positions, std::vector<uint32_t>& indices) {
+        const uint32_t base = static_cast<uint32_t>(positions.size());
+        for (int i = 0; i < 8; ++i) {
+            positions.emplace_back((i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y, (i & 4) ? box.max.z : box.min.z);
+        }
+        // Counter-clockwise seen from outside
+        const uint32_t faces[36] = { 0, 4, 6, 0, 6, 2,  1, 3, 7, 1, 7, 5,  0, 1, 5, 0, 5, 4,
+                                     2, 6, 7, 2, 7, 3,  0, 2, 3, 0, 3, 1,  4, 5, 7, 4, 7, 6 };
+        for (uint32_t index : faces)
+            indices.push_back(base + index);
+    }
+
+} // namespace
+
+TEST_CASE("Software rasterizer occlusion scene", "[rasterizer][!benchmark]") {
+    Threading::JobSystem::Init();
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> height(4.0f, 30.0f);
+
+    // 64x64 blocks of buildings, 12 triangles each
+    std::vector<Math::Vec3> positions;
+    std::vector<uint32_t> indices;
+    for (int z = 0; z < 64; ++z) {
+        for (int x = 0; x < 64; ++x) {
+            const Math::Vec3 corner(float(x) * 12.0f - 384.0f, 0.0f, float(z) * -12.0f - 8.0f);
+            AppendBox({ corner, corner + Math::Vec3(8.0f, height(rng), 8.0f) }, positions, indices);
+        }
+    }
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+    // Camera looks down one of the streets
+    const Math::Mat4 viewProj = Math::Mat4::Perspective(1.1f, 16.0f / 9.0f, 0.5f, 1000.0f)
+                              * Math::Mat4::LookAt({ 10.0f, 6.0f, 20.0f }, { 10.0f, 4.0f, -200.0f }, { 0.0f, 1.0f, 0.0f });
+    const Math::Frustum frustum = Math::Frustum::FromMatrix(viewProj);
+
+    // Occludees: small props along the streets; only those inside the frustum are queried
+    std::uniform_int_distribution<int> street(0, 63);
+    std::uniform_real_distribution<float> pz(-768.0f, 0.0f);
+    std::vector<Math::AABB> occludees;
+    while (occludees.size() < 20000) {
+        Math::AABB box = Math::AABB::FromCenterExtents({ float(street(rng)) * 12.0f - 374.0f, 1.0f, pz(rng) }, Math::Vec3(1.0f));
+        if (frustum.Test(box) != Math::Containment::Outside)
+            occludees.push_back(box);
+    }
+    std::vector<uint8_t> visible(occludees.size());
+
+    Renderer::SoftwareRasterizer depthOnly(320, 180);
+    depthOnly.SetColorEnabled(false);
+    auto renderOccluders = [&]() {
+        depthOnly.Clear();
+        depthOnly.SubmitTriangles(viewProj, positions.data(), indices.data(), static_cast<uint32_t>(indices.size()));
+        depthOnly.Rasterize();
+    };
+
+    BENCHMARK("Occluders 49k tris @ 320x180 depth only") {
+        renderOccluders();
+    };
+
+    BENCHMARK("Occlusion test 20k boxes") {
+        return depthOnly.TestAABBs(viewProj, occludees.data(), static_cast<uint32_t>(occludees.size()), visible.data());
+    };
+
+    Renderer::SoftwareRasterizer color(1280, 720);
+    BENCHMARK("Scene 49k tris @ 1280x720 colour") {
+        color.Clear();
+        color.SubmitTriangles(viewProj, positions.data(), indices.data(), static_cast<uint32_t>(indices.size()), 0xFF808080u);
+        color.Rasterize();
+    };
+
+    // Throughput and rejection summary, on the same scene
+    const int iterations = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        renderOccluders();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint32_t culled = depthOnly.TestAABBs(viewProj, occludees.data(), static_cast<uint32_t>(occludees.size()), visible.data());
+
+    LOG_PROFILE_INFO("[Rasterizer] {} ({}): {:.2f} M submitted tris/s, {} binned of {}, occlusion rejected {:.1f}% of {} in-frustum boxes",
+        Math::GetSimdName(), Threading::JobSystem::GetMaxThreadCount(), triangleCount * iterations / seconds / 1e6,
+        depthOnly.GetTriangleCount(), triangleCount, 100.0 * culled / occludees.size(), occludees.size());
+
+    Threading::JobSystem::Shutdown();
+}
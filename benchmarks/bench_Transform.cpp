@@ -0,0 +1,40 @@
+#include <catch2/catch_all.hpp>
+#include "Core/Transform.h"
+#include "Threading/JobSystem.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * Incremental vs. full world-matrix updates on a 100k node hierarchy.
+ */
+
+TEST_CASE("TransformHierarchy update", "[transform][!benchmark]") {
+    Threading::JobSystem::Init();
+
+    std::mt19937 rng(5);
+    Core::TransformHierarchy hierarchy;
+    std::vector<Core::TransformHandle> nodes;
+    for (int i = 0; i < 100000; ++i) {
+        Core::TransformHandle parent = (i < 64) ? Core::InvalidTransform : nodes[rng() % nodes.size()];
+        nodes.push_back(hierarchy.Create(parent));
+    }
+    hierarchy.Update();
+
+    auto touch = [&](size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            hierarchy.SetLocalPosition(nodes[rng() % nodes.size()], { 1.0f, 2.0f, 3.0f });
+    };
+
+    BENCHMARK("100k nodes, 5% dirty") {
+        touch(nodes.size() / 20);
+        return hierarchy.Update();
+    };
+
+    BENCHMARK("100k nodes, all dirty") {
+        touch(nodes.size());
+        return hierarchy.Update();
+    };
+
+    Threading::JobSystem::Shutdown();
+}
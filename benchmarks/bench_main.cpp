@@ -0,0 +1,12 @@
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch_all.hpp>
+
+#include "Utils/Logger.h"
+
+int main(int argc, char* argv[])
+{
+    // 1) Benchmarks share the engine loggers with the code they measure
+    Logger::Init();
+    // 2) Run the selected benchmark cases
+    return Catch::Session().run(argc, argv);
+}
@@ -1,26 +1,103 @@
 #pragma once
 
+#include "Core/Startup.h"
 #include "Core/Window.h"
+#include "ECS/SystemScheduler.h"
+#include "ECS/World.h"
+#include "IO/CookedAsset.h"
+#include "IO/FileSystem.h"
+#include "Utils/Telemetry.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
 
 namespace Core {
 
+    /**
+     * @struct ApplicationSettings
+     * @brief What Application::Init() brings up. Empty paths skip their step.
+     */
+    struct ApplicationSettings {
+        std::string title = "My GLFW Window";
+        int         width = 1280;
+        int         height = 720;
+        bool        headless = false;           // No window: servers, tests, replays
+        uint32_t    workerCount = 0;            // JobSystem workers; 0 picks one per core
+        uint32_t    startupThreads = 3;         // Helpers running startup steps besides the caller
+        uint32_t    maxFrames = 0;              // Run() returns after this many frames; 0 for no limit
+
+        std::string contentArchive;             // Mounted into the FileSystem
+        std::string looseRoot;                  // Overrides archive entries in development
+        std::string manifestDirectory;          // Cooked output holding the asset manifest
+        std::string startupTracePath;           // Chrome trace of the startup steps
+        std::string telemetryEndpoint;          // Live profiler stream, "unix:<path>" or "tcp:<port>"
+    };
+
     /**
      * @class Application
      * @brief Manages the main engine loop (initialization, update, shutdown).
      */
     class Application {
     public:
-        Application();
+        explicit Application(const ApplicationSettings& settings = ApplicationSettings());
         ~Application();
 
+        /**
+         * @brief Brings subsystems up as a StartupGraph: the logger, the memory
+         *        manager, the JobSystem, the file system and its mounts, the asset
+         *        manifest, the telemetry server and the window, independent ones
+         *        concurrently.
+         * @return False if any step failed.
+         */
         bool Init();
+
+        /**
+         * @brief Runs frames until the window closes, RequestStop() is called or
+         *        ApplicationSettings::maxFrames frames ran. Headless, there is no
+         *        window to poll, so only the last two end the loop.
+         */
         void Run();
+
+        /** @brief Makes Run() return after the current frame. Callable from any thread. */
+        void RequestStop() { m_StopRequested = true; }
+
         void Shutdown();
 
         Window* GetWindow() const { return m_Window; }
 
+        IO::FileSystem*           GetFileSystem() const { return m_FileSystem.get(); }
+        const IO::AssetManifest&  GetAssetManifest() const { return m_Manifest; }
+
+        /** @brief Null unless ApplicationSettings::telemetryEndpoint is set. */
+        TelemetryServer*          GetTelemetry() const { return m_Telemetry.get(); }
+
+        /** @brief Steps and timings of the last Init(). */
+        const StartupGraph&       GetStartup() const { return m_Startup; }
+
+        // Game state and the systems that update it every frame
+        ECS::World&           GetWorld() { return m_World; }
+        ECS::SystemScheduler& GetScheduler() { return m_Scheduler; }
+
+        /**
+         * @brief Runs one update step of all registered systems.
+         * @param deltaTime Seconds since the previous update.
+         */
+        void Update(float deltaTime);
+
     private:
+        ApplicationSettings m_Settings;
         Window* m_Window;  // Pointer to your window object
+        ECS::World           m_World;
+        ECS::SystemScheduler m_Scheduler;
+
+        std::unique_ptr<IO::FileSystem> m_FileSystem;
+        IO::AssetManifest               m_Manifest;
+        std::unique_ptr<TelemetryServer> m_Telemetry;
+        StartupGraph                    m_Startup;
+        std::chrono::steady_clock::time_point m_InitStart;
+        std::atomic<bool>               m_StopRequested{ false };
     };
 
 } // namespace Core
@@ -9,10 +9,30 @@ namespace Core {
         MAX_KEYS // Keep this last to define array sizes, etc.
     };
 
+    /**
+     * @struct InputState
+     * @brief Everything Input reports in one frame, for recording and replaying it.
+     */
+    struct InputState {
+        bool  keysDown[(int)KeyCode::MAX_KEYS] = {};
+        bool  mouseButtons[5] = {};
+        float mouseX = 0.0f;
+        float mouseY = 0.0f;
+    };
+
     class Input {
     public:
         static void Update();
 
+        /** @brief The state as of the last Update() or SetState(). */
+        static InputState GetState();
+
+        /**
+         * @brief Replaces the state until the next Update() polls the window; without
+         *        a window it stays until the next SetState().
+         */
+        static void SetState(const InputState& state);
+
         static bool IsKeyDown(KeyCode key);
         static bool IsKeyUp(KeyCode key);
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Core/Input.h"
+#include "Physics/Physics.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Core {
+
+    /**
+     * @struct ReplayScene
+     * @brief The simulation a replay starts from: rigid bodies, one of which
+     *        may be driven by the input (WASD pushes it, SPACE makes it jump).
+     *        Convex hulls cannot be saved.
+     */
+    struct ReplayScene {
+        Physics::WorldSettings         physics;
+        std::vector<Physics::BodyDesc> bodies;
+        Physics::BodyId                player = Physics::InvalidBody;
+    };
+
+    /**
+     * @struct Replay
+     * @brief A scene and the input of every frame played on it.
+     */
+    struct Replay {
+        ReplayScene             scene;
+        float                   deltaTime = 1.0f / 60.0f;  // Fixed, whatever the frames really take
+        std::vector<InputState> input;                      // One per frame: its size is the frame count
+    };
+
+    /**
+     * @brief Writes a replay as text; floats are written so they read back exactly.
+     *        Input is stored only for frames where it changed.
+     */
+    bool SaveReplay(const std::string& path, const Replay& replay);
+
+    /** @return False if the file cannot be read or is not a replay. */
+    bool LoadReplay(const std::string& path, Replay& replay);
+
+    /**
+     * @brief A workload for benchmarks: a ground, stacks of boxes, spheres and
+     *        capsules raining on them, and a player body steered by scripted
+     *        input. The same arguments always give the same replay.
+     */
+    Replay MakeBenchmarkReplay(uint32_t bodyCount, uint32_t frameCount, uint32_t seed = 1);
+
+    /**
+     * @struct ReplayOptions
+     * @brief How to run a replay.
+     */
+    struct ReplayOptions {
+        uint32_t workerCount = 0;       // JobSystem workers; 0 picks one per core
+        uint32_t warmupFrames = 0;      // Simulated and checksummed, but left out of the timings
+    };
+
+    /**
+     * @struct ScopeTiming
+     * @brief Distribution over frames of the time one named scope took per frame
+     *        (summed over threads when it ran several times in a frame).
+     */
+    struct ScopeTiming {
+        std::string name;
+        uint32_t    frames = 0;         // Timed frames the scope ran in
+        double      p50Ms = 0.0;
+        double      p90Ms = 0.0;
+        double      p99Ms = 0.0;
+        double      maxMs = 0.0;
+        double      totalMs = 0.0;
+    };
+
+    /**
+     * @struct ReplayReport
+     * @brief Frame times and simulation checksums of one run of a replay.
+     */
+    struct ReplayReport {
+        uint32_t                 frames = 0;
+        uint32_t                 workerCount = 0;
+        std::vector<ScopeTiming> scopes;            // "Frame" (the whole update) first, then by total time
+        std::vector<uint64_t>    frameChecksums;    // Of the simulation state after each frame
+        uint64_t                 checksum = 0;      // After the last frame
+    };
+
+    /**
+     * @brief Runs the replay in a headless Application for its frame count.
+     *
+     * Every frame sets the recorded input, then runs the scheduler with fixed
+     * deltaTime: a player system, the physics step, and chunked systems copying
+     * body poses and bounds into ECS components. The checksum covers every body's
+     * pose and velocities and those components, bit for bit, so runs agree on it
+     * exactly when they simulated the same thing, whatever the thread count.
+     *
+     * Brings the JobSystem up and down, so nothing else may be using it.
+     */
+    ReplayReport RunReplay(const Replay& replay, const ReplayOptions& options = ReplayOptions());
+
+    /** @brief First frame whose checksums differ, or the shorter frame count if none does. */
+    uint32_t FindDivergence(const ReplayReport& a, const ReplayReport& b);
+
+    /** @brief The report as a table, one scope per line. */
+    std::string FormatReplayReport(const ReplayReport& report);
+
+} // namespace Core
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Utils/Profiling.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Core {
+
+    /**
+     * @struct StartupStep
+     * @brief One step of engine startup and how it went.
+     */
+    struct StartupStep {
+        std::string              name;
+        std::vector<std::string> dependencies;
+        std::function<bool()>    run;                   // False fails startup
+        bool                     mainThread = false;    // Must run on the thread calling Run() (windowing)
+
+        // ------ RESULTS ------
+        bool     succeeded = false;
+        bool     skipped = false;                       // A dependency failed
+        uint32_t threadIndex = 0;                       // 0 for the calling thread
+        double   startMs = 0.0;                         // Relative to the start of Run()
+        double   durationMs = 0.0;
+    };
+
+    /**
+     * @class StartupGraph
+     * @brief Engine initialization declared as steps with dependencies; steps
+     *        whose dependencies are done run concurrently.
+     *
+     * Run() blocks the calling thread, which runs main-thread steps and helps
+     * with the others, alongside a few helper threads that exist only during
+     * startup (the JobSystem is usually one of the steps). A failed step skips
+     * everything that depends on it.
+     *
+     * Each step is timed and recorded as a Profiling event; ExportTrace()
+     * writes them as a Chrome trace with one track per thread.
+     */
+    class StartupGraph {
+    public:
+        /** @brief Dependencies must have been added before. */
+        void Add(std::string name, std::vector<std::string> dependencies, std::function<bool()> run, bool mainThread = false);
+
+        /**
+         * @param helperThreads Threads besides the caller; 0 runs every step on the caller, in order.
+         * @return True if every step succeeded.
+         */
+        bool Run(uint32_t helperThreads);
+
+        const std::vector<StartupStep>& GetSteps() const { return m_Steps; }
+
+        /** @brief Wall time of the last Run(). */
+        double GetTotalMs() const { return m_TotalMs; }
+
+        /** @brief Longest chain of dependent steps: the shortest Run() can get with more threads. */
+        double GetCriticalPathMs() const;
+
+        bool ExportTrace(const std::string& path) const;
+
+    private:
+        std::vector<StartupStep> m_Steps;
+        std::vector<std::vector<uint32_t>> m_Dependencies;  // Step indices, parallel to m_Steps
+        double m_TotalMs = 0.0;
+    };
+
+} // namespace Core
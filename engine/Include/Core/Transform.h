@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Math/Matrix.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+
+    using TransformHandle = uint32_t;
+    constexpr TransformHandle InvalidTransform = 0xFFFFFFFFu;
+
+    /**
+     * @class TransformHierarchy
+     * @brief Scene-graph transforms with incremental local-to-world updates.
+     *
+     * Nodes live in flat arrays sorted by depth, so one linear pass always visits
+     * a parent before its children. Setting a local transform only marks the node
+     * dirty; Update() recomputes world matrices for dirty nodes and their
+     * descendants and leaves everything else untouched. Each depth level is split
+     * across the Threading::JobSystem when it is large enough, so independent
+     * subtrees update in parallel.
+     *
+     * Handles stay valid until the node is destroyed. Structural changes (Create,
+     * Destroy, SetParent) re-sort the arrays on the next Update().
+     */
+    class TransformHierarchy {
+    public:
+        TransformHierarchy() = default;
+
+        /**
+         * @brief Creates a node with an identity local transform.
+         * @param parent Parent node, or InvalidTransform for a root.
+         */
+        TransformHandle Create(TransformHandle parent = InvalidTransform);
+
+        /**
+         * @brief Destroys a node together with its whole subtree. Every node of the
+         *        subtree is invalid and out of GetCount() at once; their slots are
+         *        released by the next Update().
+         */
+        void Destroy(TransformHandle handle);
+
+        /**
+         * @brief Re-parents a node (InvalidTransform makes it a root). The node keeps
+         *        its local transform, so its world transform changes with the parent.
+         */
+        void SetParent(TransformHandle handle, TransformHandle parent);
+
+        bool            IsValid(TransformHandle handle) const;
+        TransformHandle GetParent(TransformHandle handle) const;
+        uint32_t        GetCount() const { return m_AliveCount; }
+
+        // Local transform (relative to the parent); setters mark the node dirty
+        void SetLocal(TransformHandle handle, const Math::Vec3& position, const Math::Quat& rotation, const Math::Vec3& scale);
+        void SetLocalPosition(TransformHandle handle, const Math::Vec3& position);
+        void SetLocalRotation(TransformHandle handle, const Math::Quat& rotation);
+        void SetLocalScale(TransformHandle handle, const Math::Vec3& scale);
+
+        const Math::Vec3& GetLocalPosition(TransformHandle handle) const { return m_Position[m_SlotOf[handle]]; }
+        const Math::Quat& GetLocalRotation(TransformHandle handle) const { return m_Rotation[m_SlotOf[handle]]; }
+        const Math::Vec3& GetLocalScale(TransformHandle handle) const { return m_Scale[m_SlotOf[handle]]; }
+
+        /**
+         * @brief Local-to-world matrix as of the last Update().
+         */
+        const Math::Mat4& GetWorldMatrix(TransformHandle handle) const { return m_World[m_SlotOf[handle]]; }
+
+        /**
+         * @brief True if the node's world matrix was recomputed by the last Update().
+         */
+        bool WasUpdated(TransformHandle handle) const { return m_Updated[m_SlotOf[handle]] != 0; }
+
+        /**
+         * @brief Recomputes the world matrices of dirty subtrees.
+         * @return Number of world matrices recomputed (also published to Profiling
+         *         as the "Transforms.Updated" counter).
+         */
+        uint32_t Update();
+
+        /** @brief Depth of the deepest node after the last Update(), 0 for roots only. */
+        uint32_t GetMaxDepth() const;
+
+    private:
+        void MarkDirty(TransformHandle handle);
+        void LinkChild(TransformHandle handle, TransformHandle parent);
+        void UnlinkChild(TransformHandle handle);
+        void Rebuild();
+        uint32_t UpdateRange(uint32_t begin, uint32_t end);
+
+        // ---- Per slot, sorted by depth once the structure is clean ----
+        std::vector<uint32_t>   m_ParentSlot; // Slot of the parent, or InvalidTransform
+        std::vector<Math::Vec3> m_Position;
+        std::vector<Math::Quat> m_Rotation;
+        std::vector<Math::Vec3> m_Scale;
+        std::vector<Math::Mat4> m_World;
+        std::vector<uint8_t>    m_Dirty;      // Local transform changed since last Update()
+        std::vector<uint8_t>    m_Updated;    // World matrix recomputed by the last Update()
+        std::vector<TransformHandle> m_HandleOf;
+
+        // First slot of every depth level; the last entry is the slot count
+        std::vector<uint32_t>   m_LevelOffsets;
+
+        // ---- Per handle ----
+        std::vector<uint32_t>        m_SlotOf;
+        std::vector<TransformHandle> m_Parent;
+        std::vector<TransformHandle> m_FirstChild;   // Children form a doubly linked list
+        std::vector<TransformHandle> m_NextSibling;
+        std::vector<TransformHandle> m_PrevSibling;
+        std::vector<uint8_t>         m_Alive;
+        std::vector<TransformHandle> m_FreeHandles;
+
+        uint32_t m_AliveCount = 0;
+        bool     m_StructureDirty = false;
+    };
+
+} // namespace Core
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "ECS/World.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ECS {
+
+    /**
+     * @class SystemAccess
+     * @brief The set of component types a system reads and writes.
+     *
+     *   ECS::SystemAccess().Read<Velocity>().Write<Position>()
+     */
+    class SystemAccess {
+    public:
+        template<typename T>
+        SystemAccess& Read() {
+            m_Reads |= GetComponentMask<T>();
+            m_PreparePools.push_back(&PreparePool<T>);
+            return *this;
+        }
+
+        template<typename T>
+        SystemAccess& Write() {
+            m_Writes |= GetComponentMask<T>();
+            m_PreparePools.push_back(&PreparePool<T>);
+            return *this;
+        }
+
+        ComponentMask GetReads() const { return m_Reads; }
+        ComponentMask GetWrites() const { return m_Writes; }
+
+        /**
+         * @brief Two systems conflict when either one writes a component the other touches.
+         */
+        bool ConflictsWith(const SystemAccess& other) const {
+            return (m_Writes & (other.m_Reads | other.m_Writes)) != 0
+                || (other.m_Writes & m_Reads) != 0;
+        }
+
+        /**
+         * @brief Creates every declared pool up front so no structural change
+         *        happens while systems run in parallel.
+         */
+        void PreparePools(World& world) const {
+            for (auto prepare : m_PreparePools)
+                prepare(world);
+        }
+
+    private:
+        template<typename T>
+        static void PreparePool(World& world) { world.GetPool<T>(); }
+
+        ComponentMask m_Reads = 0;
+        ComponentMask m_Writes = 0;
+        std::vector<void(*)(World&)> m_PreparePools;
+    };
+
+    /**
+     * @struct SystemContext
+     * @brief Passed to a system invocation. Plain systems get [0, 1); chunked
+     *        systems get the element range of their chunk.
+     */
+    struct SystemContext {
+        World&   world;
+        float    deltaTime;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /**
+     * @class SystemScheduler
+     * @brief Builds a conflict-free execution schedule from the declared component
+     *        access of every system and runs it on the Threading::JobSystem.
+     *
+     * Systems keep their registration order wherever they conflict: a system is
+     * placed in the stage after the last earlier system it conflicts with. Systems
+     * in the same stage (and the chunks of chunked systems) run in parallel.
+     *
+     * Every run publishes to Profiling:
+     *  - one "ECS::<system>" event per system invocation/chunk,
+     *  - counters "ECS.FrameMs", "ECS.CriticalPathMs", "ECS.Stages", "ECS.Conflicts".
+     * Conflicting pairs are logged to the profile logger whenever the schedule is rebuilt.
+     */
+    class SystemScheduler {
+    public:
+        using SystemId = uint32_t;
+        using SystemFn = std::function<void(const SystemContext&)>;
+        using CountFn = std::function<uint32_t(World&)>;
+
+        SystemScheduler();
+        ~SystemScheduler();
+
+        /**
+         * @brief Registers a system that runs as a single job per frame.
+         */
+        SystemId AddSystem(const std::string& name, const SystemAccess& access, SystemFn fn);
+
+        /**
+         * @brief Registers a system whose work is split into chunks of chunkSize
+         *        elements, count(world) elements in total, that run in parallel.
+         */
+        SystemId AddChunkedSystem(const std::string& name, const SystemAccess& access,
+                                  CountFn count, uint32_t chunkSize, SystemFn fn);
+
+        /**
+         * @brief Computes conflicts and stages. Called lazily by Run() after registration changes.
+         */
+        void Build();
+
+        /**
+         * @brief Runs every system once, stage by stage.
+         */
+        void Run(World& world, float deltaTime);
+
+        uint32_t GetSystemCount() const { return static_cast<uint32_t>(m_Systems.size()); }
+        const std::string& GetSystemName(SystemId id) const;
+
+        /** @brief Systems grouped into stages; each inner list runs concurrently. */
+        const std::vector<std::vector<SystemId>>& GetStages() const { return m_Stages; }
+
+        /** @brief Every conflicting (earlier, later) system pair. */
+        const std::vector<std::pair<SystemId, SystemId>>& GetConflicts() const { return m_Conflicts; }
+
+        /** @brief Wall time of a system during the last Run(), first chunk start to last chunk end. */
+        double GetSystemTimeMs(SystemId id) const;
+
+        /**
+         * @brief Longest chain of conflicting systems in the last Run(), weighted by
+         *        their measured times. This is the lower bound on frame update time.
+         */
+        const std::vector<SystemId>& GetCriticalPath() const { return m_CriticalPath; }
+        double GetCriticalPathMs() const { return m_CriticalPathMs; }
+
+    private:
+        struct System;
+
+        void RunStage(const std::vector<SystemId>& stage, World& world, float deltaTime);
+        void UpdateCriticalPath();
+
+        std::vector<std::unique_ptr<System>>       m_Systems;
+        std::vector<std::vector<SystemId>>         m_Stages;
+        std::vector<std::pair<SystemId, SystemId>> m_Conflicts;
+        std::vector<SystemId>                      m_CriticalPath;
+        double                                     m_CriticalPathMs = 0.0;
+        bool                                       m_Dirty = true;
+    };
+
+} // namespace ECS
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ECS {
+
+    using Entity = uint32_t;
+    using ComponentTypeId = uint32_t;
+    using ComponentMask = uint64_t;
+
+    constexpr Entity   InvalidEntity = 0xFFFFFFFFu;
+    constexpr uint32_t MaxComponentTypes = 64; // One bit per type in a ComponentMask
+
+    namespace Detail {
+        inline ComponentTypeId NextComponentTypeId() {
+            static std::atomic<ComponentTypeId> s_Counter{ 0 };
+            ComponentTypeId id = s_Counter.fetch_add(1);
+            assert(id < MaxComponentTypes && "Too many component types; widen ComponentMask");
+            return id;
+        }
+    } // namespace Detail
+
+    /**
+     * @brief Returns a process-wide, dense id for component type T.
+     */
+    template<typename T>
+    ComponentTypeId GetComponentTypeId() {
+        static const ComponentTypeId s_Id = Detail::NextComponentTypeId();
+        return s_Id;
+    }
+
+    /** @brief Returns the ComponentMask bit of component type T. */
+    template<typename T>
+    ComponentMask GetComponentMask() {
+        return ComponentMask(1) << GetComponentTypeId<T>();
+    }
+
+    /**
+     * @class IComponentPool
+     * @brief Type-erased interface so World can remove components of any type.
+     */
+    class IComponentPool {
+    public:
+        virtual ~IComponentPool() = default;
+        virtual void Remove(Entity entity) = 0;
+        virtual bool Has(Entity entity) const = 0;
+        virtual uint32_t Size() const = 0;
+    };
+
+    /**
+     * @class ComponentPool
+     * @brief Sparse-set storage: components of one type packed densely so systems
+     *        can iterate (and split into chunks) by index.
+     */
+    template<typename T>
+    class ComponentPool : public IComponentPool {
+    public:
+        T& Add(Entity entity, T value) {
+            if (entity >= m_Sparse.size())
+                m_Sparse.resize(entity + 1, InvalidEntity);
+
+            if (m_Sparse[entity] != InvalidEntity) {
+                m_Data[m_Sparse[entity]] = std::move(value);
+                return m_Data[m_Sparse[entity]];
+            }
+
+            m_Sparse[entity] = static_cast<uint32_t>(m_Dense.size());
+            m_Dense.push_back(entity);
+            m_Data.push_back(std::move(value));
+            return m_Data.back();
+        }
+
+        void Remove(Entity entity) override {
+            if (!Has(entity))
+                return;
+
+            // Swap-and-pop keeps the dense arrays packed
+            uint32_t index = m_Sparse[entity];
+            uint32_t last = static_cast<uint32_t>(m_Dense.size()) - 1;
+            if (index != last) {
+                m_Dense[index] = m_Dense[last];
+                m_Data[index] = std::move(m_Data[last]);
+                m_Sparse[m_Dense[index]] = index;
+            }
+            m_Dense.pop_back();
+            m_Data.pop_back();
+            m_Sparse[entity] = InvalidEntity;
+        }
+
+        bool Has(Entity entity) const override {
+            return entity < m_Sparse.size() && m_Sparse[entity] != InvalidEntity;
+        }
+
+        uint32_t Size() const override { return static_cast<uint32_t>(m_Dense.size()); }
+
+        T& Get(Entity entity) {
+            assert(Has(entity));
+            return m_Data[m_Sparse[entity]];
+        }
+
+        const T& Get(Entity entity) const {
+            assert(Has(entity));
+            return m_Data[m_Sparse[entity]];
+        }
+
+        // Dense access, valid for index < Size()
+        T&       At(uint32_t index) { return m_Data[index]; }
+        const T& At(uint32_t index) const { return m_Data[index]; }
+        Entity   EntityAt(uint32_t index) const { return m_Dense[index]; }
+
+        T*       Data() { return m_Data.data(); }
+        const T* Data() const { return m_Data.data(); }
+
+    private:
+        std::vector<uint32_t> m_Sparse; // Entity -> dense index
+        std::vector<Entity>   m_Dense;  // Dense index -> entity
+        std::vector<T>        m_Data;   // Dense index -> component
+    };
+
+    /**
+     * @class World
+     * @brief Owns entities and one ComponentPool per component type.
+     *
+     * Structural changes (creating entities, adding/removing components, creating
+     * pools) must happen on one thread. During SystemScheduler::Run systems may
+     * only read or write component data of the pools they declared.
+     */
+    class World {
+    public:
+        Entity CreateEntity() {
+            if (!m_FreeEntities.empty()) {
+                Entity entity = m_FreeEntities.back();
+                m_FreeEntities.pop_back();
+                m_Alive[entity] = true;
+                return entity;
+            }
+            m_Alive.push_back(true);
+            return static_cast<Entity>(m_Alive.size() - 1);
+        }
+
+        void DestroyEntity(Entity entity) {
+            if (!IsAlive(entity))
+                return;
+            for (auto& pool : m_Pools) {
+                if (pool)
+                    pool->Remove(entity);
+            }
+            m_Alive[entity] = false;
+            m_FreeEntities.push_back(entity);
+        }
+
+        bool IsAlive(Entity entity) const {
+            return entity < m_Alive.size() && m_Alive[entity];
+        }
+
+        uint32_t GetEntityCount() const {
+            return static_cast<uint32_t>(m_Alive.size() - m_FreeEntities.size());
+        }
+
+        template<typename T>
+        T& AddComponent(Entity entity, T value = T{}) {
+            assert(IsAlive(entity));
+            return GetPool<T>().Add(entity, std::move(value));
+        }
+
+        template<typename T>
+        void RemoveComponent(Entity entity) {
+            GetPool<T>().Remove(entity);
+        }
+
+        template<typename T>
+        bool HasComponent(Entity entity) const {
+            const IComponentPool* pool = m_Pools[GetComponentTypeId<T>()].get();
+            return pool && pool->Has(entity);
+        }
+
+        template<typename T>
+        T& GetComponent(Entity entity) {
+            return GetPool<T>().Get(entity);
+        }
+
+        /**
+         * @brief Returns the pool for T, creating it on first use (structural change).
+         */
+        template<typename T>
+        ComponentPool<T>& GetPool() {
+            auto& slot = m_Pools[GetComponentTypeId<T>()];
+            if (!slot)
+                slot = std::make_unique<ComponentPool<T>>();
+            return static_cast<ComponentPool<T>&>(*slot);
+        }
+
+    private:
+        std::array<std::unique_ptr<IComponentPool>, MaxComponentTypes> m_Pools;
+        std::vector<bool>   m_Alive;
+        std::vector<Entity> m_FreeEntities;
+    };
+
+} // namespace ECS
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "IO/Compression.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace IO {
+
+    /**
+     * @brief 64-bit FNV-1a hash of an archive path. Paths use '/' separators and
+     *        are relative to the packed root (e.g. "meshes/rock.obj").
+     */
+    constexpr uint64_t HashPath(std::string_view path) {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : path) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /** @brief 64-bit hash of bytes (FNV-1a, like HashPath()); chain calls through seed. */
+    uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+    /** @brief '\\' to '/', leading "./" and '/' removed. */
+    std::string NormalizePath(std::string_view path);
+
+    // ------ ON-DISK FORMAT (little endian) ------
+
+    constexpr uint32_t kArchiveMagic = 0x4B415045;   // "EPAK"
+    constexpr uint32_t kArchiveVersion = 2;
+    constexpr uint32_t kArchiveTocAlignment = 64;
+
+    /**
+     * @struct ArchiveHeader
+     * @brief Start of an archive. The table of contents follows at a 64-byte
+     *        boundary, then the path names, then the entry data.
+     */
+    struct ArchiveHeader {
+        uint32_t magic = kArchiveMagic;
+        uint32_t version = kArchiveVersion;
+        uint32_t entryCount = 0;
+        uint32_t alignment = 0;       // Of every entry's data
+        uint64_t tocOffset = 0;       // ArchiveEntry[entryCount], sorted by pathHash
+        uint64_t namesOffset = 0;     // Paths, not terminated
+        uint64_t namesSize = 0;
+        uint64_t fileSize = 0;
+    };
+
+    struct ArchiveEntry {
+        uint64_t pathHash;
+        uint64_t offset;              // Of the data, from the start of the archive
+        uint64_t size;                // Stored bytes: a block stream unless codec is None
+        uint64_t rawSize;             // Bytes of the file itself
+        uint32_t nameOffset;          // Into the names block
+        uint16_t nameLength;
+        Codec    codec;
+        uint8_t  reserved;
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 48 && sizeof(ArchiveEntry) == 40, "archive layout is part of the format");
+
+    /**
+     * @struct PackSettings
+     * @brief How Archive::Build() lays out and compresses entries.
+     */
+    struct PackSettings {
+        uint32_t                               alignment = 16;               // Power of two; every entry's data starts at a multiple
+        std::function<Codec(std::string_view)> chooseCodec = ChooseCodec;    // Per path; entries that do not shrink are stored
+    };
+
+    /**
+     * @struct ArchiveView
+     * @brief Bytes of one entry, pointing into the mapped archive (or a mapped
+     *        loose file). Valid while whatever produced it is alive.
+     */
+    struct ArchiveView {
+        const uint8_t* data = nullptr;
+        uint64_t       size = 0;
+    };
+
+    /**
+     * @class MappedFile
+     * @brief A whole file mapped read-only. Falls back to reading the file into
+     *        memory where mmap is not available.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& path);
+        void Close();
+
+        const uint8_t* GetData() const { return m_Data; }
+        uint64_t       GetSize() const { return m_Size; }
+
+    private:
+        const uint8_t*       m_Data = nullptr;
+        uint64_t             m_Size = 0;
+        bool                 m_Mapped = false;
+        std::vector<uint8_t> m_Copy;            // Fallback storage
+    };
+
+    /**
+     * @class Archive
+     * @brief A mapped pack file. Lookups binary-search the hash-sorted table of
+     *        contents and return views into the mapping, without copying or any
+     *        syscall. Const methods are safe from any thread.
+     */
+    class Archive {
+    public:
+        /** @brief Maps and validates an archive; false if it is missing or malformed. */
+        bool Open(const std::string& path);
+
+        /** @brief Entry of a path hash, or null. */
+        const ArchiveEntry* Find(uint64_t pathHash) const;
+
+        /** @brief Entry of a path, or null. Also checks the stored name, so a hash collision cannot return the wrong file. */
+        const ArchiveEntry* Find(std::string_view path) const;
+
+        /** @brief Stored bytes of an entry: the file itself only if its codec is None. */
+        ArchiveView GetData(const ArchiveEntry& entry) const { return { m_File.GetData() + entry.offset, entry.size }; }
+        std::string_view GetPath(const ArchiveEntry& entry) const;
+
+        /** @brief Decompresses an entry on the calling thread into rawSize bytes. */
+        bool Extract(const ArchiveEntry& entry, uint8_t* destination) const;
+
+        /** @brief Path the archive was opened from. */
+        const std::string& GetFilePath() const { return m_Path; }
+
+        uint32_t            GetEntryCount() const { return m_Header.entryCount; }
+        const ArchiveEntry* GetEntries() const { return m_Entries; }
+        uint32_t            GetAlignment() const { return m_Header.alignment; }
+
+        /**
+         * @brief Packs files into an archive. Entries are laid out in path order,
+         *        so files of one directory stay together on disk.
+         * @param root       Directory the paths are relative to.
+         * @param paths      Files to pack, relative to root (normalized here).
+         * @param settings   Alignment and codec choice.
+         * @param outError   Why packing failed (unreadable file, hash collision, ...).
+         */
+        static bool Build(const std::string& root, const std::vector<std::string>& paths, const std::string& outputPath,
+                          const PackSettings& settings, std::string& outError);
+
+        /** @brief Every regular file below root, relative and normalized, sorted. */
+        static std::vector<std::string> ListFiles(const std::string& root);
+
+    private:
+        std::string         m_Path;
+        MappedFile          m_File;
+        ArchiveHeader       m_Header;
+        const ArchiveEntry* m_Entries = nullptr;
+    };
+
+} // namespace IO
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "IO/AssetLoader.h"
+#include "IO/FileSystem.h"
+#include "Threading/ThreadPool.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace IO {
+
+    /**
+     * @brief Reference to a cached asset: slot index in the low 32 bits, slot
+     *        generation in the high 32. Every handle returned by AssetCache holds
+     *        one reference, given back with Release().
+     */
+    using AssetHandle = uint64_t;
+    constexpr AssetHandle InvalidAsset = ~0ull;
+
+    using AssetType = uint32_t;
+
+    enum class AssetState : uint8_t {
+        Loading,
+        Ready,
+        Failed
+    };
+
+    /**
+     * @struct AssetPayload
+     * @brief What a loader produces: the object, and the bytes it keeps resident
+     *        (counted against the type's budget).
+     */
+    struct AssetPayload {
+        std::shared_ptr<void> object;
+        uint64_t              size = 0;
+    };
+
+    /** @brief Runs on a loader thread; may block on the FileSystem. */
+    using AssetLoadFn = std::function<bool(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload)>;
+
+    /**
+     * @struct AssetTypeDesc
+     * @brief One kind of asset: how to load it and how much of it may stay resident.
+     */
+    struct AssetTypeDesc {
+        std::string name;                   // Counters are published as Assets.<name>.*
+        AssetLoadFn load;
+        uint64_t    budget = ~0ull;         // Resident bytes before unreferenced assets are evicted
+    };
+
+    /** @brief Loads the raw bytes of a file, as a std::vector<uint8_t>. */
+    bool LoadBytesAsset(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload);
+
+    /** @brief Loads and parses an OBJ file, as a MeshData. */
+    bool LoadMeshAsset(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload);
+
+    /**
+     * @struct AssetCacheStats
+     * @brief Totals since the cache was created; also published through Profiling.
+     */
+    struct AssetCacheStats {
+        uint64_t hits = 0;                  // Requests served by a resident asset
+        uint64_t misses = 0;                // Requests that started a load
+        uint64_t coalesced = 0;             // Requests that joined a load already in flight
+        uint64_t evictions = 0;
+        uint64_t residentBytes = 0;         // Every type
+    };
+
+    /**
+     * @class AssetCache
+     * @brief Reference-counted assets keyed by path hash, loaded on a small pool
+     *        of loader threads.
+     *
+     * Request() never blocks. Requesting an asset that is resident is a hit;
+     * requesting one that is already loading joins that load, so identical
+     * requests are loaded once. Assets stay resident after their last Release(),
+     * so coming back to an area does not reload it, until their type goes over
+     * its budget: then unreferenced assets are evicted least recently released
+     * first. Referenced assets are never evicted.
+     *
+     * All methods are safe from any thread. Get() is valid while the caller
+     * holds its reference.
+     */
+    class AssetCache {
+    public:
+        explicit AssetCache(FileSystem& fileSystem, uint32_t loaderThreads = 2);
+
+        /** @brief Waits for loads in flight; every handle is invalid afterwards. */
+        ~AssetCache();
+
+        AssetCache(const AssetCache&) = delete;
+        AssetCache& operator=(const AssetCache&) = delete;
+
+        AssetType RegisterType(const AssetTypeDesc& desc);
+
+        /** @brief Changes a type's budget, evicting at once if it is now exceeded. */
+        void SetBudget(AssetType type, uint64_t budget);
+
+        /**
+         * @brief Takes a reference to an asset, starting its load if it is not
+         *        resident or loading already.
+         * @return InvalidAsset if the path hash collides with a different path, or
+         *         if the cache has no free slot left for a new asset (both logged).
+         */
+        AssetHandle Request(AssetType type, const std::string& path);
+
+        /** @brief Request() and Wait(). */
+        AssetHandle Load(AssetType type, const std::string& path);
+
+        /** @brief Another reference to the same asset. */
+        AssetHandle Acquire(AssetHandle handle);
+
+        /** @brief Gives a reference back; the asset may be evicted once none are left. */
+        void Release(AssetHandle handle);
+
+        /** @brief Blocks until the asset is loaded or failed. */
+        AssetState Wait(AssetHandle handle);
+
+        AssetState GetState(AssetHandle handle) const;
+
+        /** @brief The loaded object, or null while loading or if the load failed. */
+        template <typename T>
+        T* Get(AssetHandle handle) const { return static_cast<T*>(GetObject(handle)); }
+
+        uint64_t        GetResidentBytes(AssetType type) const;
+        AssetCacheStats GetStats() const;
+
+    private:
+        static constexpr uint32_t kSlotBits = 32;
+        static constexpr uint32_t kMaxSlots = ~0u - 1;     // kNoSlot and above are never slot indices
+        static constexpr uint32_t kNoSlot = ~0u;
+
+        struct Slot {
+            std::string  path;
+            uint64_t     key = 0;
+            AssetType    type = 0;
+            uint32_t     generation = 0;
+            uint32_t     refs = 0;
+            AssetState   state = AssetState::Loading;
+            AssetPayload payload;
+            uint32_t     lruPrev = kNoSlot;     // Unreferenced resident assets of the type, oldest first
+            uint32_t     lruNext = kNoSlot;
+        };
+
+        struct TypeState {
+            AssetTypeDesc desc;
+            std::string   residentCounter;
+            uint64_t      residentBytes = 0;
+            uint32_t      lruHead = kNoSlot;
+            uint32_t      lruTail = kNoSlot;
+        };
+
+        void*       GetObject(AssetHandle handle) const;
+        AssetHandle MakeHandle(uint32_t slot) const;  // Under m_Mutex
+        uint32_t SlotOf(AssetHandle handle) const;   // Under m_Mutex
+        void     LoadSlot(uint32_t slot);            // On a loader thread
+
+        // Under m_Mutex
+        void LinkLru(uint32_t slot);
+        void UnlinkLru(uint32_t slot);
+        void EnforceBudget(AssetType type);
+        void FreeSlot(uint32_t slot);
+        void PublishRequestCounters() const;
+        void PublishResidentCounters(AssetType type) const;
+
+        FileSystem&                            m_FileSystem;
+        mutable std::mutex                     m_Mutex;
+        std::condition_variable                m_LoadedCondition;
+        std::vector<TypeState>                 m_Types;
+        std::vector<Slot>                      m_Slots;
+        std::vector<uint32_t>                  m_FreeSlots;
+        std::unordered_map<uint64_t, uint32_t> m_Lookup;    // Key of (type, path hash) to slot
+        AssetCacheStats                        m_Stats;
+
+        // Last, so it is joined before anything its tasks touch is destroyed
+        Threading::ThreadPool                  m_Loaders;
+    };
+
+} // namespace IO
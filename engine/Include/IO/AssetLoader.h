@@ -0,0 +1,70 @@
+#pragma once
+
+#include "IO/MeshOptimizer.h"
+
+#include <string>
+
+namespace IO {
+
+    /**
+     * @struct MeshImportSettings
+     * @brief Controls the offline processing applied by AssetLoader::ImportMesh.
+     */
+    struct MeshImportSettings {
+        bool     optimizeVertexCache = true;
+        bool     optimizeVertexFetch = true;
+        bool     quantize = true;
+        uint32_t lodCount = 4;              // Including the full-detail mesh
+        float    lodReduction = 0.5f;       // Triangle ratio between consecutive LODs
+        uint32_t meshletMaxVertices = 64;
+        uint32_t meshletMaxTriangles = 124;
+    };
+
+    /**
+     * @struct MeshLod
+     * @brief One level of detail: a range of ImportedMesh::indices and of its meshlets.
+     */
+    struct MeshLod {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float    error = 0.0f;              // Simplification error in world units (0 for LOD 0)
+        uint32_t firstMeshlet = 0;
+        uint32_t meshletCount = 0;
+    };
+
+    /**
+     * @struct ImportedMesh
+     * @brief GPU-ready result of the import stage. All LODs share one vertex buffer
+     *        and one concatenated index buffer.
+     */
+    struct ImportedMesh {
+        MeshData              mesh;         // Full-precision vertices; indices hold every LOD
+        QuantizedMesh         quantized;    // Empty unless settings.quantize
+        std::vector<MeshLod>  lods;
+        MeshletData           meshlets;     // Meshlets of every LOD, see MeshLod
+    };
+
+    /**
+     * @class AssetLoader
+     * @brief Reads source assets and runs the offline import stage on them.
+     */
+    class AssetLoader {
+    public:
+        /**
+         * @brief Parses Wavefront OBJ text (v/vt/vn/f; polygons are fanned into
+         *        triangles). Missing normals are generated from the faces.
+         * @return False if the text holds no triangles or has invalid indices.
+         */
+        static bool ParseOBJ(const std::string& text, MeshData& outMesh);
+
+        /** @brief Reads and parses an OBJ file. */
+        static bool LoadOBJ(const std::string& path, MeshData& outMesh);
+
+        /**
+         * @brief Vertex cache/fetch optimization, LOD chain, meshlets and quantization.
+         *        Each stage is timed with ProfileScope.
+         */
+        static ImportedMesh ImportMesh(MeshData mesh, const MeshImportSettings& settings = {});
+    };
+
+} // namespace IO
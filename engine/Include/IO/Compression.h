@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace IO {
+
+    enum class Codec : uint8_t {
+        None,   // Stored
+        LZ4,    // LZ4 block format, greedy matching: fast to pack
+        LZ4HC   // Same format and decoder, deeper match search: smaller, slower to pack
+    };
+
+    /**
+     * @brief Codec for an asset by file type. Formats that are already compressed
+     *        are stored; textures and cooked data are packed once and loaded
+     *        often, so they get LZ4HC; everything else gets LZ4.
+     */
+    Codec ChooseCodec(std::string_view path);
+
+    // ------ SINGLE BLOCKS ------
+
+    /** @brief Largest compressed size of size bytes. */
+    constexpr size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+    /**
+     * @brief Compresses one block (LZ4 block format, at most 64 KiB so offsets fit).
+     * @return Compressed size, or 0 if it does not fit in capacity.
+     */
+    size_t CompressBlock(Codec codec, const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+    /**
+     * @brief Decompresses one block into exactly dstSize bytes. Malformed input
+     *        fails instead of reading or writing out of bounds.
+     */
+    bool DecompressBlock(Codec codec, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+    // ------ BLOCK STREAMS ------
+
+    /*
+     * Compressed entries are cut into independent blocks so they can be
+     * decompressed in parallel, each straight into its slice of the destination:
+     *
+     *   uint32_t blockCount
+     *   uint32_t blockEnd[blockCount]   // Stored bytes of blocks 0..i, after the table
+     *   block data
+     *
+     * Block i holds bytes [i * kCompressionBlockSize, ...) of the raw data. A block
+     * whose stored size equals its raw size did not compress and is stored as is.
+     */
+    constexpr uint32_t kCompressionBlockSize = 64 * 1024;
+
+    inline uint32_t GetBlockCount(uint64_t rawSize) {
+        return static_cast<uint32_t>((rawSize + kCompressionBlockSize - 1) / kCompressionBlockSize);
+    }
+
+    inline size_t GetBlockRawSize(uint64_t rawSize, uint32_t block) {
+        const uint64_t remaining = rawSize - uint64_t(block) * kCompressionBlockSize;
+        return static_cast<size_t>(remaining < kCompressionBlockSize ? remaining : kCompressionBlockSize);
+    }
+
+    /** @brief Codec of one block of a stream: blocks that did not shrink are stored. */
+    inline Codec GetBlockCodec(Codec codec, size_t storedSize, size_t rawSize) {
+        return storedSize == rawSize ? Codec::None : codec;
+    }
+
+    /** @brief Compresses data into a block stream. */
+    std::vector<uint8_t> CompressBlocks(Codec codec, const uint8_t* data, size_t size);
+
+    /** @brief Decompresses a whole block stream on the calling thread. */
+    bool DecompressBlocks(Codec codec, const uint8_t* stream, size_t streamSize, uint8_t* dst, size_t rawSize);
+
+} // namespace IO
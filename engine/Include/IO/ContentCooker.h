@@ -0,0 +1,61 @@
+#pragma once
+
+#include "IO/CookedAsset.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace IO {
+
+    /** @brief Bumped whenever cooking code changes what it writes; every output is then re-cooked. */
+    constexpr uint32_t kCookerVersion = 1;
+
+    /**
+     * @struct CookReport
+     * @brief What one ContentCooker::Cook() did.
+     */
+    struct CookReport {
+        uint32_t cooked = 0;        // Outputs written
+        uint32_t upToDate = 0;      // Skipped: same key as the last build
+        uint32_t failed = 0;
+        uint32_t removed = 0;       // Outputs of sources that no longer exist
+        uint32_t hashedInputs = 0;  // Inputs read to hash (the rest matched size and time)
+        double   seconds = 0.0;
+    };
+
+    /**
+     * @class ContentCooker
+     * @brief Incremental build of a source content tree into runtime assets.
+     *
+     * Every source file is an asset. An asset's inputs are the file itself and,
+     * for meshes, the settings files that apply to it: "cook.settings" in its
+     * directory, then "<file>.settings" next to it, one "key value" per line
+     * (the fields of MeshImportSettings: lodCount, lodReduction, quantize,
+     * optimizeVertexCache, optimizeVertexFetch, meshletMaxVertices,
+     * meshletMaxTriangles). One settings file may feed many assets.
+     *
+     * Each output is keyed by a hash of its inputs' contents, its effective
+     * settings and the cooker and format versions. Assets whose key matches the
+     * last build's manifest, with the output still there, are skipped. An
+     * input whose size and modification time are unchanged reuses its recorded
+     * hash, so a no-op build reads nothing but the directory tree. The rest are
+     * hashed and cooked in parallel on the JobSystem.
+     *
+     * OBJ meshes are imported and cooked (CookMesh) to "<name>.mesh"; any other
+     * file is copied as is. The build ends by writing the manifest read by
+     * AssetManifest, and by deleting outputs of sources that are gone.
+     */
+    class ContentCooker {
+    public:
+        ContentCooker(std::string sourceRoot, std::string outputRoot);
+
+        /** @brief Brings the output directory up to date with the sources; blocks until done. */
+        CookReport Cook();
+
+    private:
+        std::string m_SourceRoot;
+        std::string m_OutputRoot;
+    };
+
+} // namespace IO
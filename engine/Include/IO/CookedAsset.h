@@ -0,0 +1,144 @@
+#pragma once
+
+#include "IO/AssetLoader.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace IO {
+
+    class FileSystem;
+    struct AssetPayload;
+
+    /*
+     * Cooked assets are one contiguous blob, laid out exactly as the runtime uses
+     * it. Arrays are stored as offsets from the start of the blob; loading reads
+     * the blob with a single read and fixes those offsets up into pointers in
+     * place. Nothing is parsed field by field and nothing is allocated per object.
+     *
+     * The blob is little endian with 64-bit pointers, like every platform the
+     * engine ships on. Any change to a cooked struct bumps its version, and
+     * blobs of another version are rejected rather than misread.
+     */
+
+    constexpr uint32_t kCookedMagic = 0x4B4F4F43;   // "COOK"
+    constexpr uint32_t kCookedAlignment = 16;       // Of the blob and of every array in it
+
+    enum class CookedType : uint32_t {
+        Mesh = 1
+    };
+
+    constexpr uint32_t kCookedMeshVersion = 1;
+
+    struct CookedHeader {
+        uint32_t   magic = kCookedMagic;
+        CookedType type = CookedType::Mesh;
+        uint32_t   version = 0;
+        uint32_t   reserved = 0;
+        uint64_t   size = 0;                    // Of the whole blob
+    };
+
+    /**
+     * @struct CookedArray
+     * @brief An array inside a cooked blob: an offset from the start of the blob
+     *        on disk, its address once fixed up.
+     */
+    template <typename T>
+    struct CookedArray {
+        static_assert(std::is_trivially_copyable<T>::value, "cooked data is copied as bytes");
+
+        uint64_t value = 0;
+        uint64_t count = 0;
+
+        T*       data() const { return reinterpret_cast<T*>(static_cast<uintptr_t>(value)); }
+        uint64_t size() const { return count; }
+        bool     empty() const { return count == 0; }
+        T*       begin() const { return data(); }
+        T*       end() const { return data() + count; }
+        T&       operator[](uint64_t i) const { return data()[i]; }
+    };
+
+    /**
+     * @struct CookedMesh
+     * @brief Root of a cooked mesh: everything ImportMesh() produced.
+     */
+    struct CookedMesh {
+        CookedHeader                  header;
+        Math::Vec3                    positionOffset;      // Quantization bounds, see QuantizedMesh
+        Math::Vec3                    positionScale;
+        uint32_t                      reserved[2] = {};
+        CookedArray<MeshVertex>       vertices;
+        CookedArray<uint32_t>         indices;             // Every LOD
+        CookedArray<QuantizedVertex>  quantizedVertices;   // Empty unless quantized
+        CookedArray<MeshLod>          lods;
+        CookedArray<Meshlet>          meshlets;
+        CookedArray<uint32_t>         meshletVertices;
+        CookedArray<uint8_t>          meshletTriangles;
+    };
+
+    static_assert(sizeof(void*) == 8, "cooked blobs hold 64-bit pointers once fixed up");
+    static_assert(sizeof(CookedHeader) == 24 && sizeof(CookedMesh) == 168, "cooked layout is part of the format");
+
+    /** @brief Lays an imported mesh out as one cooked blob. */
+    std::vector<uint8_t> CookMesh(const ImportedMesh& mesh);
+
+    /**
+     * @brief Checks the header and that every array lies inside the blob, then
+     *        turns the offsets into pointers in place. The blob must be
+     *        kCookedAlignment-aligned and outlive the returned mesh.
+     * @return Null if this is not a cooked mesh of this version, or is malformed.
+     */
+    CookedMesh* FixupCookedMesh(void* blob, uint64_t size);
+
+    /**
+     * @brief Reads a cooked mesh file into one aligned allocation with a single
+     *        read, and fixes it up. The mesh frees the blob when released.
+     */
+    std::shared_ptr<CookedMesh> LoadCookedMesh(const std::string& path);
+
+    /** @brief AssetCache loader for cooked meshes (archive entries or loose files), as a CookedMesh. */
+    bool LoadCookedMeshAsset(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload);
+
+    /** @brief Written by ContentCooker at the root of its output directory. */
+    constexpr const char* kAssetManifestName = "manifest.txt";
+
+    /**
+     * @class AssetManifest
+     * @brief Runtime side of a content build: where each source asset was cooked to.
+     *
+     * The manifest is text, one asset per line, tab separated: source path,
+     * output path, key in hex, then the inputs the key was computed from
+     * (which only the cooker reads). Paths are relative and use '/'.
+     */
+    class AssetManifest {
+    public:
+        struct Entry {
+            std::string source;         // Relative to the source root, e.g. "meshes/rock.obj"
+            std::string output;         // Relative to the output root, e.g. "meshes/rock.mesh"
+            uint64_t    key = 0;        // Content hash the output was cooked from
+        };
+
+        /** @brief Reads the manifest of a cooked output directory. */
+        bool Load(const std::string& outputRoot);
+
+        /** @brief Entry of a source path, or null. */
+        const Entry* Find(std::string_view sourcePath) const;
+
+        /** @brief Path of the cooked output of a source path (under the output root), or empty. */
+        std::string Resolve(std::string_view sourcePath) const;
+
+        const std::vector<Entry>& GetEntries() const { return m_Entries; }
+
+    private:
+        std::string        m_OutputRoot;
+        std::vector<Entry> m_Entries;   // Sorted by source
+    };
+
+    /** @brief Loads the cooked mesh a manifest lists for a source OBJ path. */
+    std::shared_ptr<CookedMesh> LoadCookedMesh(const AssetManifest& manifest, std::string_view sourcePath);
+
+} // namespace IO
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "IO/Archive.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace IO {
+
+    enum class IOPriority : uint8_t {
+        Low,        // Prefetch, background streaming
+        Normal,
+        High,       // Needed for the next few frames
+        Critical    // Blocking the frame right now
+    };
+    constexpr uint32_t kIOPriorityCount = 4;
+
+    enum class IOStatus : uint8_t {
+        Idle,       // Never submitted
+        Queued,     // Waiting for a free backend slot; can still be cancelled
+        InFlight,   // Being read; the destination buffer belongs to the backend
+        Completed,
+        Failed,
+        Cancelled
+    };
+
+    enum class IOBackendType : uint8_t {
+        Auto,       // io_uring where the kernel allows it, else ThreadPool
+        IoUring,    // Linux 5.6+; falls back to ThreadPool if the ring cannot be set up
+        ThreadPool  // Blocking positional reads on a few dedicated threads
+    };
+
+    constexpr uint64_t kReadWholeFile = ~0ull;
+
+    struct ReadRequest;
+    /**
+     * @brief Called once per request on the thread that finished it (an IO thread,
+     *        or the caller of Cancel()). Keep it short: hand heavy work to the
+     *        JobSystem. The request may be reused or destroyed once it returns.
+     */
+    using ReadCallback = std::function<void(ReadRequest& request, IOStatus status)>;
+
+    /**
+     * @struct ReadRequest
+     * @brief One asynchronous read. Owned by the caller, who must keep it alive
+     *        until it is done; it may be reused after that.
+     *
+     * With a null buffer the FileSystem allocates one of the right size through
+     * the MemoryManager; the caller releases it with FileSystem::FreeBuffer().
+     */
+    struct ReadRequest {
+        std::string  path;
+        uint64_t     offset = 0;
+        uint64_t     size = kReadWholeFile;    // Bytes to read; stops early at the end of the file
+        void*        buffer = nullptr;         // Destination, at least size bytes
+        IOPriority   priority = IOPriority::Normal;
+        ReadCallback onComplete;
+
+        // ------ RESULTS (valid once done) ------
+        void*                 data = nullptr;  // buffer, or the block allocated for it
+        uint64_t              bytesRead = 0;
+        int                   error = 0;       // errno of a failed read
+        std::atomic<IOStatus> status{ IOStatus::Idle };
+    };
+
+    /**
+     * @struct FileView
+     * @brief Read-only bytes of a file, without a copy: they point into a mounted
+     *        archive, or into a mapped loose file that the view keeps alive.
+     */
+    struct FileView {
+        const uint8_t*                    data = nullptr;
+        uint64_t                          size = 0;
+        std::shared_ptr<const MappedFile> looseFile;   // Set for loose overrides
+    };
+
+    /**
+     * @struct FileSystemSettings
+     * @brief Backend choice and concurrency of a FileSystem.
+     */
+    struct FileSystemSettings {
+        IOBackendType backend = IOBackendType::Auto;
+        uint32_t      queueDepth = 64;      // Reads in flight at once (io_uring)
+        uint32_t      threadCount = 4;      // Reader threads (ThreadPool backend)
+    };
+
+    /**
+     * @class FileSystem
+     * @brief Asynchronous file reads with priorities and cancellation.
+     *
+     * Read() only queues the request, so it never blocks on the disk. Queued
+     * requests are started highest priority first (FIFO within a priority) as
+     * backend slots free up. Data is read straight into the destination buffer.
+     * Completion is reported through the request's callback, and can be polled
+     * with IsDone() or waited for with Wait().
+     *
+     * The io_uring backend drives one ring from a single IO thread using raw
+     * syscalls. The ThreadPool backend runs blocking positional reads instead.
+     * Both give the same results.
+     *
+     * Shipped content lives in mounted archives, and OpenView() returns their
+     * entries as views into the mapping, with no syscall per file. In
+     * development, a loose root directory overrides archive entries file by file.
+     *
+     * Compressed entries are loaded with ReadEntry(), which streams them: windows
+     * of blocks are read asynchronously, and as each window lands its blocks are
+     * decompressed on JobSystem workers straight into the destination, while the
+     * next windows are still being read.
+     */
+    class FileSystem {
+    public:
+        explicit FileSystem(const FileSystemSettings& settings = FileSystemSettings());
+
+        /** @brief Cancels queued reads and waits for those in flight. */
+        ~FileSystem();
+
+        FileSystem(const FileSystem&) = delete;
+        FileSystem& operator=(const FileSystem&) = delete;
+
+        /**
+         * @brief Queues a read.
+         * @return False if the request is still queued or in flight.
+         */
+        bool Read(ReadRequest& request);
+
+        /**
+         * @brief Cancels a queued read; its callback runs here with Cancelled.
+         * @return False if the read already started or finished. Started reads
+         *         cannot be stopped, since the kernel owns their buffer.
+         */
+        bool Cancel(ReadRequest& request);
+
+        /** @brief Blocks until the request is done. */
+        void Wait(const ReadRequest& request);
+
+        static bool IsDone(const ReadRequest& request) {
+            const IOStatus status = request.status.load(std::memory_order_acquire);
+            return status != IOStatus::Queued && status != IOStatus::InFlight;
+        }
+
+        /** @brief Backend actually in use (never Auto). */
+        IOBackendType GetBackendType() const { return m_BackendType; }
+
+        /** @brief Requests queued or in flight. */
+        uint32_t GetPendingCount() const { return m_Pending.load(std::memory_order_relaxed); }
+
+        // ------ ARCHIVES ------
+        // Mount and set the loose root before looking anything up; lookups are
+        // then safe from any thread
+
+        /** @brief Maps an archive. Later mounts take precedence over earlier ones. */
+        bool Mount(const std::string& archivePath);
+
+        /** @brief Files under this directory override archive entries; empty disables. */
+        void SetLooseRoot(const std::string& directory) { m_LooseRoot = directory; }
+
+        /** @brief Loose override (if a loose root is set), else the newest archive holding the path. */
+        bool OpenView(const std::string& path, FileView& outView) const;
+
+        /** @brief Archives only, by HashPath() of the path. */
+        bool OpenView(uint64_t pathHash, FileView& outView) const;
+
+        // OpenView() fails on compressed entries, which have no bytes to point at
+
+        /** @brief Size of a file once decompressed, from the same source OpenView() would use. */
+        bool GetEntrySize(const std::string& path, uint64_t& outSize) const;
+
+        /**
+         * @brief Reads a whole file into destination, decompressing it if needed.
+         *        Blocks until done; run it from a loading thread. Publishes the
+         *        IO.ReadMBps, IO.DecompressMBps (per thread) and IO.EndToEndMBps
+         *        counters for compressed entries.
+         * @param capacity  Bytes available at destination, at least GetEntrySize().
+         */
+        bool ReadEntry(const std::string& path, void* destination, uint64_t capacity,
+                       IOPriority priority = IOPriority::Normal);
+
+        /** @brief Releases a buffer the FileSystem allocated for a request. */
+        static void FreeBuffer(void* data);
+
+        // ------ BLOCKING HELPERS ------
+        static bool GetFileSize(const std::string& path, uint64_t& outSize);
+        static bool ReadFile(const std::string& path, std::vector<uint8_t>& outData);
+
+    private:
+        struct Backend;
+        struct IoUringBackend;
+        struct ThreadPoolBackend;
+
+        // Newest archive holding the path, or null
+        const Archive* FindEntry(const std::string& normalized, const ArchiveEntry*& outEntry) const;
+        bool StreamEntry(const Archive& archive, const ArchiveEntry& entry, uint8_t* destination, IOPriority priority);
+
+        ReadRequest* PopQueued();
+        // Runs the callback, then publishes the status; the request is not touched after
+        void Finish(ReadRequest& request, IOStatus status);
+
+        std::deque<ReadRequest*>  m_Queues[kIOPriorityCount];
+        std::mutex                m_QueueMutex;
+        std::mutex                m_DoneMutex;
+        std::condition_variable   m_DoneCondition;
+        std::atomic<uint32_t>     m_Pending{ 0 };
+
+        IOBackendType             m_BackendType = IOBackendType::ThreadPool;
+        std::unique_ptr<Backend>  m_Backend;
+
+        std::vector<std::unique_ptr<Archive>> m_Archives;   // Newest last
+        std::string                           m_LooseRoot;
+    };
+
+} // namespace IO
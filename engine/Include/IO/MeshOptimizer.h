@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Math/Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Offline mesh processing used by the asset import stage (see IO/AssetLoader.h).
+ * Everything here is plain CPU work on indexed triangle lists.
+ */
+namespace IO {
+
+    struct MeshVertex {
+        Math::Vec3 position;
+        Math::Vec3 normal;
+        float      u = 0.0f;
+        float      v = 0.0f;
+    };
+
+    struct MeshData {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t>   indices;
+    };
+
+    // ----------------------------------------------------------
+    // Vertex cache and fetch order
+    // ----------------------------------------------------------
+
+    /**
+     * @brief Reorders triangles for the post-transform vertex cache (Forsyth's
+     *        linear-speed algorithm). Triangles keep their winding.
+     */
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+    /**
+     * @brief Average cache miss ratio: transformed vertices per triangle for a FIFO
+     *        cache of cacheSize entries (3.0 worst, ~0.5 best on regular grids).
+     */
+    float ComputeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+    /**
+     * @brief Reorders vertices by first use in the index buffer (and drops unused
+     *        ones) so vertex fetch walks memory linearly. Indices are rewritten.
+     * @return The new vertex count.
+     */
+    size_t OptimizeVertexFetch(MeshData& mesh);
+
+    // ----------------------------------------------------------
+    // Quantization
+    // ----------------------------------------------------------
+
+    /**
+     * @struct QuantizedVertex
+     * @brief 12-byte vertex: 16-bit unorm position inside the mesh bounds,
+     *        octahedral 8-bit snorm normal and half-float UVs.
+     */
+    struct QuantizedVertex {
+        uint16_t position[3];
+        int8_t   normal[2];
+        uint16_t uv[2];
+    };
+    static_assert(sizeof(QuantizedVertex) == 12, "QuantizedVertex must stay tightly packed");
+
+    struct QuantizedMesh {
+        std::vector<QuantizedVertex> vertices;
+        Math::Vec3                   positionOffset; // Bounds minimum
+        Math::Vec3                   positionScale;  // Bounds size
+    };
+
+    QuantizedMesh Quantize(const MeshData& mesh);
+    MeshVertex    Dequantize(const QuantizedMesh& mesh, size_t index);
+
+    uint16_t FloatToHalf(float value);
+    float    HalfToFloat(uint16_t value);
+
+    // ----------------------------------------------------------
+    // Simplification
+    // ----------------------------------------------------------
+
+    /**
+     * @brief Quadric-error edge collapse onto existing vertices. Vertices on open
+     *        borders or attribute seams are locked, so the silhouette is preserved.
+     * @param targetIndexCount Stop once the index count reaches this (it may stay
+     *        above it if no valid collapses remain).
+     * @param outError If not null, receives the largest collapse error (world units).
+     * @return Index buffer of the simplified mesh, referencing the same vertices.
+     */
+    std::vector<uint32_t> Simplify(const MeshData& mesh, const std::vector<uint32_t>& indices,
+                                   size_t targetIndexCount, float* outError = nullptr);
+
+    // ----------------------------------------------------------
+    // Meshlets
+    // ----------------------------------------------------------
+
+    /**
+     * @struct Meshlet
+     * @brief A small cluster of triangles with its own vertex list, bounding sphere
+     *        and normal cone. The cone is unusable (never culls) when coneCutoff >= 1.
+     */
+    struct Meshlet {
+        uint32_t   vertexOffset = 0;   // Into MeshletData::vertices
+        uint32_t   triangleOffset = 0; // Into MeshletData::triangles (3 bytes per triangle)
+        uint32_t   vertexCount = 0;
+        uint32_t   triangleCount = 0;
+
+        Math::Vec3 center;
+        float      radius = 0.0f;
+        Math::Vec3 coneAxis;
+        float      coneCutoff = 1.0f;  // sin of the cone half-angle
+    };
+
+    struct MeshletData {
+        std::vector<Meshlet>  meshlets;
+        std::vector<uint32_t> vertices;  // Mesh vertex index per meshlet vertex
+        std::vector<uint8_t>  triangles; // Meshlet-local vertex indices
+    };
+
+    /**
+     * @brief Splits a triangle list into meshlets in index order (run
+     *        OptimizeVertexCache first for tight clusters).
+     * @param maxVertices At most 255.
+     */
+    MeshletData BuildMeshlets(const MeshData& mesh, const uint32_t* indices, size_t indexCount,
+                              uint32_t maxVertices = 64, uint32_t maxTriangles = 124);
+
+    /**
+     * @brief Conservative cone test: true only if every triangle of the meshlet
+     *        faces away from cameraPosition.
+     */
+    bool IsMeshletBackfacing(const Meshlet& meshlet, const Math::Vec3& cameraPosition);
+
+} // namespace IO
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "IO/AssetLoader.h"
+#include "IO/FileSystem.h"
+#include "Math/Vector.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace IO {
+
+    /**
+     * @struct StreamingLevel
+     * @brief One detail level of a streamable asset: a byte range of its file,
+     *        and how coarse it is.
+     */
+    struct StreamingLevel {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        float    error = 0.0f;          // World-space error of drawing with this level (texel size, LOD error)
+    };
+
+    /**
+     * @brief Mip chain of a texture stored finest first from offset.
+     * @param worldSize Extent the texture covers in the world; a mip's error is the size of its texels.
+     */
+    std::vector<StreamingLevel> BuildMipLevels(uint32_t width, uint32_t height, uint32_t bitsPerTexel, float worldSize,
+                                               uint64_t offset);
+
+    /** @brief LOD index ranges of an imported mesh whose index buffer starts at indexOffset. */
+    std::vector<StreamingLevel> BuildLodLevels(const std::vector<MeshLod>& lods, uint64_t indexOffset);
+
+    /**
+     * @struct StreamingView
+     * @brief The camera detail is selected for.
+     */
+    struct StreamingView {
+        Math::Vec3 position;
+        float      projectionScale = 1000.0f;   // Pixels per world unit at distance 1: viewportHeight / (2 tan(fovY / 2))
+        float      maxPixelError = 1.0f;        // Coarsest detail allowed on screen
+    };
+
+    /**
+     * @brief Coarsest level whose error projects to at most maxPixelError pixels.
+     * @param levels Finest first, errors increasing.
+     */
+    uint32_t SelectStreamingLevel(const std::vector<StreamingLevel>& levels, float distance, const StreamingView& view);
+
+    using StreamableHandle = uint32_t;
+    constexpr StreamableHandle InvalidStreamable = 0xFFFFFFFFu;
+
+    /**
+     * @struct StreamingStats
+     * @brief Totals since the manager was created, and the residency after the last Update().
+     */
+    struct StreamingStats {
+        uint64_t bytesStreamed = 0;
+        uint64_t bytesEvicted = 0;
+        uint64_t readsIssued = 0;
+        uint64_t readsCancelled = 0;
+        uint64_t residentBytes = 0;
+        uint64_t pendingBytes = 0;      // Of reads in flight
+        uint64_t missingBytes = 0;      // Wanted but neither resident nor being read
+        uint32_t assetsAtWantedLevel = 0;
+    };
+
+    /**
+     * @class StreamingManager
+     * @brief Keeps the detail levels of textures and meshes resident that the
+     *        camera needs, within a memory budget.
+     *
+     * An asset's resident levels are always a run from its coarsest level up
+     * to its resident level. The coarsest level is read by the first Update()
+     * after the asset is registered, whatever the budget, and is never
+     * evicted. Every Update() selects each asset's wanted level from its
+     * distance to the camera, then reads the next finer level of assets short
+     * of it, one level at a time. Largest assets on
+     * screen go first, with an IO priority that grows with how far the asset is
+     * from its wanted detail. Reads that are no longer wanted are cancelled
+     * while still queued.
+     *
+     * Levels finer than wanted stay resident, in case the camera comes back,
+     * until the budget is exceeded: then they are evicted first, then the
+     * finest levels of the smallest assets on screen, but never to make room
+     * for an asset smaller on screen than the one losing detail.
+     *
+     * Register(), Update() and the getters belong to one thread; reads complete
+     * on FileSystem threads and are applied by the next Update().
+     */
+    class StreamingManager {
+    public:
+        StreamingManager(FileSystem& fileSystem, uint64_t budget, uint32_t maxReadsInFlight = 32);
+
+        /** @brief Cancels queued reads and waits for those in flight. */
+        ~StreamingManager();
+
+        StreamingManager(const StreamingManager&) = delete;
+        StreamingManager& operator=(const StreamingManager&) = delete;
+
+        /**
+         * @param levels Finest first, errors increasing; byte ranges of path.
+         * @param center Bounding sphere of the asset in the world.
+         */
+        StreamableHandle Register(const std::string& path, std::vector<StreamingLevel> levels, const Math::Vec3& center,
+                                  float radius);
+
+        /** @brief Changes the budget; the next Update() evicts down to it. */
+        void SetBudget(uint64_t budget) { m_Budget = budget; }
+
+        /** @brief Applies finished reads, reselects wanted levels, evicts and issues reads. */
+        void Update(const StreamingView& view);
+
+        /** @brief Finest resident level, or the level count while nothing is resident. */
+        uint32_t GetResidentLevel(StreamableHandle handle) const { return m_Assets[handle].residentLevel; }
+        uint32_t GetWantedLevel(StreamableHandle handle) const { return m_Assets[handle].wantedLevel; }
+
+        /** @brief Bytes of a resident level, or null. */
+        const void* GetLevelData(StreamableHandle handle, uint32_t level) const;
+
+        const StreamingStats& GetStats() const { return m_Stats; }
+
+    private:
+        struct Asset {
+            std::string                  path;
+            std::vector<StreamingLevel>  levels;
+            std::vector<void*>           data;                  // Per level, null unless resident
+            Math::Vec3                   center;
+            float                        radius = 0.0f;
+            float                        screenSize = 0.0f;     // Projected radius in pixels, at the last Update()
+            uint32_t                     residentLevel = 0;
+            uint32_t                     wantedLevel = 0;
+            uint32_t                     loadingLevel = 0;      // Level being read, if request is in flight
+            bool                         loading = false;
+            bool                         failed = false;
+            std::unique_ptr<ReadRequest> request;
+        };
+
+        struct Completion {
+            StreamableHandle handle;
+            IOStatus         status;
+        };
+
+        void ApplyCompletions();
+        void Issue(StreamableHandle handle);
+
+        FileSystem&             m_FileSystem;
+        uint64_t                m_Budget;
+        uint32_t                m_MaxReadsInFlight;
+        uint32_t                m_ReadsInFlight = 0;
+        std::vector<Asset>      m_Assets;
+        StreamingStats          m_Stats;
+
+        std::mutex              m_CompletionMutex;
+        std::vector<Completion> m_Completions;                  // Filled by FileSystem callbacks
+    };
+
+} // namespace IO
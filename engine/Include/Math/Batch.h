@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Math/Geometry.h"
+#include "Math/Matrix.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Structure-of-arrays batch kernels for hot loops. Each kernel has a SIMD
+ * implementation selected at compile time (see Math/Simd.h) and a reference
+ * version in Math::Scalar that always exists for testing and benchmarking.
+ * The arrays need no particular alignment.
+ */
+
+namespace Math {
+
+    /** @brief Writable SoA view of points. */
+    struct PointsSoA {
+        float* x;
+        float* y;
+        float* z;
+    };
+
+    /** @brief Read-only SoA view of points. */
+    struct ConstPointsSoA {
+        const float* x;
+        const float* y;
+        const float* z;
+    };
+
+    /** @brief Read-only SoA view of boxes. */
+    struct AABBSoA {
+        const float* minX;
+        const float* minY;
+        const float* minZ;
+        const float* maxX;
+        const float* maxY;
+        const float* maxZ;
+    };
+
+    /**
+     * @brief out[i] = m * (in[i], 1), dropping w. in and out may alias.
+     */
+    void TransformPoints(const Mat4& m, const ConstPointsSoA& in, const PointsSoA& out, size_t count);
+
+    /**
+     * @brief out[i] = a[i] * b[i]. out may alias a or b.
+     */
+    void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+
+    /**
+     * @brief Tests query against count boxes and writes the indices of the overlapping
+     *        ones, in ascending order, to outIndices (capacity count).
+     * @return Number of indices written.
+     */
+    size_t OverlapAABBs(const AABB& query, const AABBSoA& boxes, size_t count, uint32_t* outIndices);
+
+    /**
+     * @brief Frustum-culls count boxes (p-vertex test against all six planes) and
+     *        writes the indices of the boxes not fully outside, in ascending order.
+     * @return Number of indices written.
+     */
+    size_t CullAABBs(const Frustum& frustum, const AABBSoA& boxes, size_t count, uint32_t* outIndices);
+
+    namespace Scalar {
+
+        void TransformPoints(const Mat4& m, const ConstPointsSoA& in, const PointsSoA& out, size_t count);
+        void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+        size_t OverlapAABBs(const AABB& query, const AABBSoA& boxes, size_t count, uint32_t* outIndices);
+        size_t CullAABBs(const Frustum& frustum, const AABBSoA& boxes, size_t count, uint32_t* outIndices);
+
+    } // namespace Scalar
+
+} // namespace Math
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Math/Matrix.h"
+#include "Math/Vector.h"
+
+#include <cfloat>
+
+namespace Math {
+
+    /**
+     * @struct AABB
+     * @brief Axis-aligned bounding box. A default-constructed box is empty
+     *        (min > max) so it can be grown with Merge().
+     */
+    struct AABB {
+        Vec3 min{ FLT_MAX };
+        Vec3 max{ -FLT_MAX };
+
+        AABB() = default;
+        AABB(const Vec3& min_, const Vec3& max_) : min(min_), max(max_) {}
+
+        static AABB FromCenterExtents(const Vec3& center, const Vec3& extents) {
+            return { center - extents, center + extents };
+        }
+
+        bool IsEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+        Vec3 Center() const { return (min + max) * 0.5f; }
+        Vec3 Extents() const { return (max - min) * 0.5f; }
+
+        float SurfaceArea() const {
+            Vec3 d = max - min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        bool Contains(const Vec3& p) const {
+            return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+        }
+
+        bool Contains(const AABB& o) const {
+            return o.min.x >= min.x && o.max.x <= max.x && o.min.y >= min.y && o.max.y <= max.y
+                && o.min.z >= min.z && o.max.z <= max.z;
+        }
+
+        bool Overlaps(const AABB& o) const {
+            return min.x <= o.max.x && max.x >= o.min.x && min.y <= o.max.y && max.y >= o.min.y
+                && min.z <= o.max.z && max.z >= o.min.z;
+        }
+
+        void Merge(const Vec3& p) { min = Min(min, p); max = Max(max, p); }
+        void Merge(const AABB& o) { min = Min(min, o.min); max = Max(max, o.max); }
+
+        AABB Expanded(float margin) const { return { min - Vec3(margin), max + Vec3(margin) }; }
+    };
+
+    inline AABB Union(const AABB& a, const AABB& b) { return { Min(a.min, b.min), Max(a.max, b.max) }; }
+
+    /**
+     * @struct Plane
+     * @brief Plane n.p + d = 0; points with a positive distance are on the inside.
+     */
+    struct Plane {
+        Vec3  normal{ 0.0f, 1.0f, 0.0f };
+        float d = 0.0f;
+
+        float Distance(const Vec3& p) const { return Dot(normal, p) + d; }
+
+        Plane Normalized() const {
+            float len = Length(normal);
+            return (len > 0.0f) ? Plane{ normal / len, d / len } : *this;
+        }
+    };
+
+    enum class Containment { Outside, Intersects, Inside };
+
+    /**
+     * @struct Frustum
+     * @brief Six inward-facing planes (left, right, bottom, top, near, far).
+     */
+    struct Frustum {
+        Plane planes[6];
+
+        /**
+         * @brief Extracts the planes of a view-projection matrix (OpenGL clip depth).
+         */
+        static Frustum FromMatrix(const Mat4& viewProjection) {
+            // Gribb/Hartmann: each plane is row 3 +/- row i of the matrix
+            auto row = [&](int r) {
+                return Vec4(viewProjection.At(r, 0), viewProjection.At(r, 1), viewProjection.At(r, 2), viewProjection.At(r, 3));
+            };
+            const Vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+            const Vec4 p[6] = { r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2 };
+
+            Frustum f;
+            for (int i = 0; i < 6; ++i)
+                f.planes[i] = Plane{ p[i].XYZ(), p[i].w }.Normalized();
+            return f;
+        }
+
+        /**
+         * @brief Classifies a box with the p/n-vertex test (conservative: boxes near a
+         *        frustum corner may report Intersects while being outside).
+         */
+        Containment Test(const AABB& box) const {
+            Containment result = Containment::Inside;
+            for (const Plane& plane : planes) {
+                // Corner furthest along the normal (p) and furthest against it (n)
+                Vec3 positive(plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                              plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                              plane.normal.z >= 0.0f ? box.max.z : box.min.z);
+                if (plane.Distance(positive) < 0.0f)
+                    return Containment::Outside;
+
+                Vec3 negative(plane.normal.x >= 0.0f ? box.min.x : box.max.x,
+                              plane.normal.y >= 0.0f ? box.min.y : box.max.y,
+                              plane.normal.z >= 0.0f ? box.min.z : box.max.z);
+                if (plane.Distance(negative) < 0.0f)
+                    result = Containment::Intersects;
+            }
+            return result;
+        }
+    };
+
+} // namespace Math
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Math/Quaternion.h"
+#include "Math/Vector.h"
+
+#include <cmath>
+
+namespace Math {
+
+    /**
+     * @struct Mat4
+     * @brief Column-major 4x4 matrix (OpenGL layout): columns[c][r], vectors are
+     *        column vectors and transforms compose right-to-left (P * V * M).
+     */
+    struct alignas(16) Mat4 {
+        Vec4 columns[4] = {
+            { 1.0f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, 1.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f, 1.0f }
+        };
+
+        Mat4() = default;
+        Mat4(const Vec4& c0, const Vec4& c1, const Vec4& c2, const Vec4& c3)
+            : columns{ c0, c1, c2, c3 } {}
+
+        Vec4&       operator[](int column) { return columns[column]; }
+        const Vec4& operator[](int column) const { return columns[column]; }
+
+        // Element access by (row, column)
+        float&       At(int row, int column) { return columns[column][row]; }
+        const float& At(int row, int column) const { return columns[column][row]; }
+
+        const float* Data() const { return &columns[0].x; }
+
+        static Mat4 Identity() { return {}; }
+
+        static Mat4 Translation(const Vec3& t) {
+            Mat4 m;
+            m.columns[3] = Vec4(t, 1.0f);
+            return m;
+        }
+
+        static Mat4 Scale(const Vec3& s) {
+            Mat4 m;
+            m.columns[0].x = s.x;
+            m.columns[1].y = s.y;
+            m.columns[2].z = s.z;
+            return m;
+        }
+
+        static Mat4 Rotation(const Quat& q) {
+            const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+            const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+            const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+            return {
+                { 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz),        2.0f * (xz - wy),        0.0f },
+                { 2.0f * (xy - wz),        1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx),        0.0f },
+                { 2.0f * (xz + wy),        2.0f * (yz - wx),        1.0f - 2.0f * (xx + yy), 0.0f },
+                { 0.0f, 0.0f, 0.0f, 1.0f }
+            };
+        }
+
+        /** @brief Translation * Rotation * Scale, built directly without two matrix products. */
+        static Mat4 FromTRS(const Vec3& t, const Quat& r, const Vec3& s) {
+            Mat4 m = Rotation(r);
+            m.columns[0] *= s.x;
+            m.columns[1] *= s.y;
+            m.columns[2] *= s.z;
+            m.columns[3] = Vec4(t, 1.0f);
+            return m;
+        }
+
+        /** @brief Right-handed perspective projection with OpenGL clip depth [-1, 1]. */
+        static Mat4 Perspective(float fovYRadians, float aspect, float zNear, float zFar) {
+            const float f = 1.0f / std::tan(fovYRadians * 0.5f);
+            Mat4 m;
+            m.columns[0] = { f / aspect, 0.0f, 0.0f, 0.0f };
+            m.columns[1] = { 0.0f, f, 0.0f, 0.0f };
+            m.columns[2] = { 0.0f, 0.0f, (zFar + zNear) / (zNear - zFar), -1.0f };
+            m.columns[3] = { 0.0f, 0.0f, (2.0f * zFar * zNear) / (zNear - zFar), 0.0f };
+            return m;
+        }
+
+        /** @brief Right-handed orthographic projection with OpenGL clip depth [-1, 1]. */
+        static Mat4 Orthographic(float left, float right, float bottom, float top, float zNear, float zFar) {
+            Mat4 m;
+            m.columns[0].x = 2.0f / (right - left);
+            m.columns[1].y = 2.0f / (top - bottom);
+            m.columns[2].z = -2.0f / (zFar - zNear);
+            m.columns[3] = { -(right + left) / (right - left), -(top + bottom) / (top - bottom),
+                             -(zFar + zNear) / (zFar - zNear), 1.0f };
+            return m;
+        }
+
+        /** @brief Right-handed view matrix looking from eye towards target. */
+        static Mat4 LookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+            const Vec3 f = Normalize(target - eye);
+            const Vec3 s = Normalize(Cross(f, up));
+            const Vec3 u = Cross(s, f);
+            return {
+                { s.x, u.x, -f.x, 0.0f },
+                { s.y, u.y, -f.y, 0.0f },
+                { s.z, u.z, -f.z, 0.0f },
+                { -Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1.0f }
+            };
+        }
+    };
+
+    /*
+     * Reference implementations. They are always compiled so the SIMD paths can be
+     * checked against them, and they are what Mat4 uses on the scalar path.
+     */
+    namespace Scalar {
+
+        inline Vec4 Transform(const Mat4& m, const Vec4& v) {
+            Vec4 r;
+            for (int row = 0; row < 4; ++row) {
+                r[row] = m.columns[0][row] * v.x + m.columns[1][row] * v.y
+                       + m.columns[2][row] * v.z + m.columns[3][row] * v.w;
+            }
+            return r;
+        }
+
+        inline Mat4 Multiply(const Mat4& a, const Mat4& b) {
+            Mat4 r;
+            for (int c = 0; c < 4; ++c)
+                r.columns[c] = Transform(a, b.columns[c]);
+            return r;
+        }
+
+    } // namespace Scalar
+
+    inline Vec4 operator*(const Mat4& m, const Vec4& v) {
+#if MATH_SIMD_SSE
+        __m128 r = _mm_mul_ps(m.columns[0].Load(), _mm_set1_ps(v.x));
+        r = _mm_add_ps(r, _mm_mul_ps(m.columns[1].Load(), _mm_set1_ps(v.y)));
+        r = _mm_add_ps(r, _mm_mul_ps(m.columns[2].Load(), _mm_set1_ps(v.z)));
+        r = _mm_add_ps(r, _mm_mul_ps(m.columns[3].Load(), _mm_set1_ps(v.w)));
+        return Vec4(r);
+#else
+        return Scalar::Transform(m, v);
+#endif
+    }
+
+    inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+#if MATH_SIMD_SSE
+        Mat4 r;
+        for (int c = 0; c < 4; ++c)
+            r.columns[c] = a * b.columns[c];
+        return r;
+#else
+        return Scalar::Multiply(a, b);
+#endif
+    }
+
+    inline Vec3 TransformPoint(const Mat4& m, const Vec3& p) { return (m * Vec4(p, 1.0f)).XYZ(); }
+    inline Vec3 TransformVector(const Mat4& m, const Vec3& v) { return (m * Vec4(v, 0.0f)).XYZ(); }
+
+    inline Mat4 Transpose(const Mat4& m) {
+        Mat4 r;
+        for (int c = 0; c < 4; ++c) {
+            for (int row = 0; row < 4; ++row)
+                r.columns[c][row] = m.columns[row][c];
+        }
+        return r;
+    }
+
+    /**
+     * @brief General 4x4 inverse (cofactor expansion). Returns identity for singular input.
+     */
+    Mat4 Inverse(const Mat4& m);
+
+    /**
+     * @brief Inverse of a matrix built from rotation, translation and non-zero scale.
+     *        Cheaper than Inverse(); the last row must be (0, 0, 0, 1).
+     */
+    Mat4 InverseAffine(const Mat4& m);
+
+} // namespace Math
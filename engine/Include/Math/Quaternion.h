@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Math/Vector.h"
+
+#include <cmath>
+
+namespace Math {
+
+    /**
+     * @struct Quat
+     * @brief Rotation quaternion (x, y, z = vector part, w = scalar part).
+     */
+    struct alignas(16) Quat {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 1.0f;
+
+        Quat() = default;
+        constexpr Quat(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+        static Quat Identity() { return {}; }
+
+        /**
+         * @brief Rotation of angleRadians around axis (axis need not be normalized).
+         */
+        static Quat FromAxisAngle(const Vec3& axis, float angleRadians) {
+            Vec3 n = Normalize(axis);
+            float s = std::sin(angleRadians * 0.5f);
+            return { n.x * s, n.y * s, n.z * s, std::cos(angleRadians * 0.5f) };
+        }
+
+        /** @brief Hamilton product; (a * b) applies b first, then a. */
+        Quat operator*(const Quat& b) const {
+            return {
+                w * b.x + x * b.w + y * b.z - z * b.y,
+                w * b.y - x * b.z + y * b.w + z * b.x,
+                w * b.z + x * b.y - y * b.x + z * b.w,
+                w * b.w - x * b.x - y * b.y - z * b.z
+            };
+        }
+
+        bool operator==(const Quat& o) const { return x == o.x && y == o.y && z == o.z && w == o.w; }
+        bool operator!=(const Quat& o) const { return !(*this == o); }
+    };
+
+    inline float Dot(const Quat& a, const Quat& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    inline Quat Normalize(const Quat& q) {
+        float len = std::sqrt(Dot(q, q));
+        if (len <= 0.0f)
+            return Quat::Identity();
+        float inv = 1.0f / len;
+        return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+    }
+
+    inline Quat Conjugate(const Quat& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+    /** @brief Rotates v by the unit quaternion q. */
+    inline Vec3 Rotate(const Quat& q, const Vec3& v) {
+        // v' = v + 2w(u x v) + 2(u x (u x v)), u = vector part
+        Vec3 u(q.x, q.y, q.z);
+        Vec3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    /** @brief Shortest-arc spherical interpolation between unit quaternions. */
+    inline Quat Slerp(const Quat& a, const Quat& b, float t) {
+        Quat end = b;
+        float cosTheta = Dot(a, b);
+        if (cosTheta < 0.0f) {
+            end = { -b.x, -b.y, -b.z, -b.w };
+            cosTheta = -cosTheta;
+        }
+
+        float wa, wb;
+        if (cosTheta > 0.9995f) {
+            // Nearly parallel: fall back to normalized lerp
+            wa = 1.0f - t;
+            wb = t;
+        } else {
+            float theta = std::acos(cosTheta);
+            float invSin = 1.0f / std::sin(theta);
+            wa = std::sin((1.0f - t) * theta) * invSin;
+            wb = std::sin(t * theta) * invSin;
+        }
+
+        return Normalize(Quat(a.x * wa + end.x * wb, a.y * wa + end.y * wb,
+                              a.z * wa + end.z * wb, a.w * wa + end.w * wb));
+    }
+
+} // namespace Math
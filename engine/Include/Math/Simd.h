@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+ * Compile-time SIMD selection for the Math module.
+ *
+ * The build picks one level through the ENGINE_SIMD CMake option, which defines
+ * ENGINE_SIMD_AVX2, ENGINE_SIMD_SSE or ENGINE_SIMD_SCALAR. Without any of them
+ * the level follows what the compiler already targets. Requests that the target
+ * cannot honour (e.g. SSE on ARM) fall back to the scalar path.
+ *
+ *   MATH_SIMD_LEVEL  2 = AVX2 + FMA, 1 = SSE2, 0 = scalar
+ *   MATH_SIMD_WIDTH  floats processed per batch-kernel iteration
+ */
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define MATH_ARCH_X86 1
+#else
+    #define MATH_ARCH_X86 0
+#endif
+
+#if defined(ENGINE_SIMD_SCALAR) || !MATH_ARCH_X86
+    #define MATH_SIMD_LEVEL 0
+#elif defined(ENGINE_SIMD_AVX2) || (!defined(ENGINE_SIMD_SSE) && defined(__AVX2__))
+    #define MATH_SIMD_LEVEL 2
+#elif defined(ENGINE_SIMD_SSE) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MATH_SIMD_LEVEL 1
+#else
+    #define MATH_SIMD_LEVEL 0
+#endif
+
+#if MATH_SIMD_LEVEL >= 2
+    #include <immintrin.h>
+    #define MATH_SIMD_WIDTH 8
+#elif MATH_SIMD_LEVEL >= 1
+    #include <emmintrin.h>
+    #define MATH_SIMD_WIDTH 4
+#else
+    #define MATH_SIMD_WIDTH 1
+#endif
+
+#define MATH_SIMD_SSE  (MATH_SIMD_LEVEL >= 1)
+#define MATH_SIMD_AVX2 (MATH_SIMD_LEVEL >= 2)
+
+namespace Math {
+
+    /** @brief Human readable name of the compiled SIMD path ("AVX2", "SSE", "Scalar"). */
+    constexpr const char* GetSimdName() {
+        return MATH_SIMD_LEVEL == 2 ? "AVX2" : (MATH_SIMD_LEVEL == 1 ? "SSE" : "Scalar");
+    }
+
+} // namespace Math
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Math/Simd.h"
+
+#include <cmath>
+
+namespace Math {
+
+    /**
+     * @struct Vec3
+     * @brief Plain 3-component float vector. Tightly packed (12 bytes) so it can be
+     *        used in vertex data and SoA conversions without padding.
+     */
+    struct Vec3 {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+
+        Vec3() = default;
+        constexpr Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+        constexpr explicit Vec3(float s) : x(s), y(s), z(s) {}
+
+        float&       operator[](int i) { return (&x)[i]; }
+        const float& operator[](int i) const { return (&x)[i]; }
+
+        Vec3 operator-() const { return { -x, -y, -z }; }
+        Vec3 operator+(const Vec3& o) const { return { x + o.x, y + o.y, z + o.z }; }
+        Vec3 operator-(const Vec3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+        Vec3 operator*(const Vec3& o) const { return { x * o.x, y * o.y, z * o.z }; }
+        Vec3 operator/(const Vec3& o) const { return { x / o.x, y / o.y, z / o.z }; }
+        Vec3 operator*(float s) const { return { x * s, y * s, z * s }; }
+        Vec3 operator/(float s) const { float inv = 1.0f / s; return { x * inv, y * inv, z * inv }; }
+
+        Vec3& operator+=(const Vec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+        Vec3& operator-=(const Vec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+        Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+
+        bool operator==(const Vec3& o) const { return x == o.x && y == o.y && z == o.z; }
+        bool operator!=(const Vec3& o) const { return !(*this == o); }
+    };
+
+    inline Vec3 operator*(float s, const Vec3& v) { return v * s; }
+
+    inline float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    inline Vec3 Cross(const Vec3& a, const Vec3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    inline float LengthSquared(const Vec3& v) { return Dot(v, v); }
+    inline float Length(const Vec3& v) { return std::sqrt(Dot(v, v)); }
+
+    inline Vec3 Normalize(const Vec3& v) {
+        float len = Length(v);
+        return (len > 0.0f) ? v / len : Vec3();
+    }
+
+    inline Vec3 Min(const Vec3& a, const Vec3& b) {
+        return { std::fmin(a.x, b.x), std::fmin(a.y, b.y), std::fmin(a.z, b.z) };
+    }
+
+    inline Vec3 Max(const Vec3& a, const Vec3& b) {
+        return { std::fmax(a.x, b.x), std::fmax(a.y, b.y), std::fmax(a.z, b.z) };
+    }
+
+    inline Vec3 Abs(const Vec3& v) { return { std::fabs(v.x), std::fabs(v.y), std::fabs(v.z) }; }
+
+    inline Vec3 Lerp(const Vec3& a, const Vec3& b, float t) { return a + (b - a) * t; }
+
+    /**
+     * @struct Vec4
+     * @brief 16-byte aligned 4-component vector; arithmetic uses one SSE register
+     *        when the SIMD path is enabled.
+     */
+    struct alignas(16) Vec4 {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 0.0f;
+
+        Vec4() = default;
+        constexpr Vec4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+        constexpr Vec4(const Vec3& v, float w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+        constexpr explicit Vec4(float s) : x(s), y(s), z(s), w(s) {}
+
+        float&       operator[](int i) { return (&x)[i]; }
+        const float& operator[](int i) const { return (&x)[i]; }
+
+        Vec3 XYZ() const { return { x, y, z }; }
+
+#if MATH_SIMD_SSE
+        explicit Vec4(__m128 v) { _mm_store_ps(&x, v); }
+        __m128 Load() const { return _mm_load_ps(&x); }
+
+        Vec4 operator+(const Vec4& o) const { return Vec4(_mm_add_ps(Load(), o.Load())); }
+        Vec4 operator-(const Vec4& o) const { return Vec4(_mm_sub_ps(Load(), o.Load())); }
+        Vec4 operator*(const Vec4& o) const { return Vec4(_mm_mul_ps(Load(), o.Load())); }
+        Vec4 operator*(float s) const { return Vec4(_mm_mul_ps(Load(), _mm_set1_ps(s))); }
+#else
+        Vec4 operator+(const Vec4& o) const { return { x + o.x, y + o.y, z + o.z, w + o.w }; }
+        Vec4 operator-(const Vec4& o) const { return { x - o.x, y - o.y, z - o.z, w - o.w }; }
+        Vec4 operator*(const Vec4& o) const { return { x * o.x, y * o.y, z * o.z, w * o.w }; }
+        Vec4 operator*(float s) const { return { x * s, y * s, z * s, w * s }; }
+#endif
+        Vec4 operator-() const { return *this * -1.0f; }
+
+        Vec4& operator+=(const Vec4& o) { *this = *this + o; return *this; }
+        Vec4& operator-=(const Vec4& o) { *this = *this - o; return *this; }
+        Vec4& operator*=(float s) { *this = *this * s; return *this; }
+
+        bool operator==(const Vec4& o) const { return x == o.x && y == o.y && z == o.z && w == o.w; }
+        bool operator!=(const Vec4& o) const { return !(*this == o); }
+    };
+
+    inline Vec4 operator*(float s, const Vec4& v) { return v * s; }
+
+    inline float Dot(const Vec4& a, const Vec4& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    inline float Length(const Vec4& v) { return std::sqrt(Dot(v, v)); }
+
+} // namespace Math
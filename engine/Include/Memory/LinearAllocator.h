@@ -0,0 +1,52 @@
+#ifndef LINEAR_ALLOCATOR_H
+#define LINEAR_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LinearAllocator
+ * @brief A fixed-capacity bump allocator for per-frame scratch memory.
+ *
+ * Allocate() is lock-free and may be called from any thread; individual blocks
+ * are never freed, the whole arena is released at once with Reset() (typically
+ * at the start of each frame). The backing block comes from the MemoryManager.
+ */
+class LinearAllocator {
+public:
+    /**
+     * @param capacity Size of the arena in bytes.
+     * @param tag      MemoryManager tag for the backing block.
+     */
+    explicit LinearAllocator(size_t capacity, const char* tag = "LinearAllocator");
+    ~LinearAllocator();
+
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+    /**
+     * @brief Allocates size bytes aligned to alignment (a power of two).
+     * @return Pointer into the arena, or nullptr if it is exhausted.
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /** @brief Typed helper: uninitialized storage for count objects of T. */
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /** @brief Releases every allocation. Not thread-safe with concurrent Allocate(). */
+    void Reset();
+
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetUsed() const { return m_Offset.load(std::memory_order_relaxed); }
+
+private:
+    uint8_t*            m_Buffer;
+    size_t              m_Capacity;
+    std::atomic<size_t> m_Offset{ 0 };
+};
+
+#endif // LINEAR_ALLOCATOR_H
@@ -0,0 +1,531 @@
+#pragma once
+
+#include "Math/Geometry.h"
+#include "Math/Quaternion.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Physics {
+
+    using ProxyId = uint32_t;
+    constexpr ProxyId InvalidProxy = 0xFFFFFFFFu;
+
+    // ----------------------------------------------------------
+    // Saved state
+    // ----------------------------------------------------------
+
+    /**
+     * @class StateWriter
+     * @brief Appends plain-data values and arrays to a byte buffer, one memcpy
+     *        each. The buffer only grows, so rewriting a state of the same size
+     *        does not allocate.
+     */
+    class StateWriter {
+    public:
+        explicit StateWriter(std::vector<uint8_t>& buffer, size_t offset = 0) : m_Buffer(buffer), m_Offset(offset) {}
+
+        void WriteBytes(const void* data, size_t size) {
+            if (m_Offset + size > m_Buffer.size())
+                m_Buffer.resize(std::max(m_Offset + size, m_Buffer.size() * 2));
+            if (size > 0)
+                std::memcpy(m_Buffer.data() + m_Offset, data, size);
+            m_Offset += size;
+        }
+
+        template <typename T>
+        void Write(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "saved state must be plain data");
+            WriteBytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void WriteArray(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable<T>::value, "saved state must be plain data");
+            Write(static_cast<uint64_t>(values.size()));
+            WriteBytes(values.data(), values.size() * sizeof(T));
+        }
+
+        size_t GetOffset() const { return m_Offset; }
+
+    private:
+        std::vector<uint8_t>& m_Buffer;
+        size_t                m_Offset;
+    };
+
+    /** @class StateReader @brief Reads back what a StateWriter wrote, in the same order. */
+    class StateReader {
+    public:
+        StateReader(const uint8_t* data, size_t offset = 0) : m_Data(data), m_Offset(offset) {}
+
+        void ReadBytes(void* data, size_t size) {
+            if (size > 0)
+                std::memcpy(data, m_Data + m_Offset, size);
+            m_Offset += size;
+        }
+
+        template <typename T>
+        void Read(T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "saved state must be plain data");
+            ReadBytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void ReadArray(std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable<T>::value, "saved state must be plain data");
+            uint64_t count;
+            Read(count);
+            values.resize(static_cast<size_t>(count));
+            ReadBytes(values.data(), values.size() * sizeof(T));
+        }
+
+        size_t GetOffset() const { return m_Offset; }
+
+    private:
+        const uint8_t* m_Data;
+        size_t         m_Offset;
+    };
+
+    /**
+     * @struct ProxyPair
+     * @brief Two broadphase proxies whose fat bounds overlap (a < b).
+     */
+    struct ProxyPair {
+        ProxyId a;
+        ProxyId b;
+
+        bool operator==(const ProxyPair& o) const { return a == o.a && b == o.b; }
+        bool operator<(const ProxyPair& o) const { return a < o.a || (a == o.a && b < o.b); }
+    };
+
+    enum class BroadphaseType {
+        DynamicTree,   // General purpose; cost scales with the number of moving proxies
+        SweepAndPrune  // Cheapest when almost everything is static and motion is coherent
+    };
+
+    /**
+     * @struct BroadphaseRay
+     * @brief A ray, or a box swept along it, for Broadphase::RayCast().
+     */
+    struct BroadphaseRay {
+        Math::Vec3 origin;
+        Math::Vec3 direction;          // Unit length
+        Math::Vec3 extents;            // Half size of the swept box; zero for a plain ray
+        float      maxDistance = 0.0f;
+    };
+
+    /**
+     * Called for each proxy whose fat box ray `ray` reaches within maxDistance.
+     * Returns the ray's new maximum distance: a hit distance to clip the ray, or
+     * maxDistance to keep going.
+     */
+    using RayCastCallback = std::function<float(uint32_t ray, ProxyId proxy, float maxDistance)>;
+
+    /**
+     * @class Broadphase
+     * @brief Finds potentially colliding pairs from bounding boxes.
+     *
+     * Every proxy stores a "fat" box: its bounds grown by kAabbMargin and stretched
+     * along its predicted displacement. MoveProxy() only does work once the real
+     * bounds leave the fat box, so slow objects rarely touch the structure.
+     *
+     * UpdatePairs() reports, sorted and without duplicates, every pair whose fat
+     * boxes overlap and that involves at least one proxy created or re-fattened
+     * since the previous call. Pairs between two untouched proxies are not reported
+     * again: the caller keeps its pairs and drops one once TestOverlap() fails.
+     */
+    class Broadphase {
+    public:
+        static constexpr float kAabbMargin = 0.1f;
+        static constexpr float kDisplacementMultiplier = 4.0f;
+
+        virtual ~Broadphase() = default;
+
+        static std::unique_ptr<Broadphase> Create(BroadphaseType type);
+
+        /** @brief Adds a proxy; it takes part in the next UpdatePairs(). */
+        virtual ProxyId CreateProxy(const Math::AABB& bounds, uint32_t userData) = 0;
+        virtual void    DestroyProxy(ProxyId proxy) = 0;
+
+        /**
+         * @brief Updates a proxy's bounds.
+         * @param displacement Movement expected over the next step; the fat box is
+         *                     extended along it.
+         * @return True if the fat box had to change (the proxy is reported again).
+         */
+        virtual bool MoveProxy(ProxyId proxy, const Math::AABB& bounds, const Math::Vec3& displacement) = 0;
+
+        /** @brief Replaces outPairs with the new pairs since the last call. */
+        virtual void UpdatePairs(std::vector<ProxyPair>& outPairs) = 0;
+
+        /** @brief Appends every proxy whose fat box overlaps bounds. */
+        virtual void Query(const Math::AABB& bounds, std::vector<ProxyId>& outProxies) const = 0;
+
+        /**
+         * @brief Visits the fat boxes each ray reaches. Clipping a ray through the
+         *        callback prunes everything behind the hit. Const and allocation
+         *        free, so batches may be cast from several threads at once.
+         */
+        virtual void RayCast(const BroadphaseRay* rays, uint32_t count, const RayCastCallback& callback) const = 0;
+
+        /**
+         * @brief Saves or restores the whole structure (proxies, fat boxes, pending
+         *        moves). Restoring needs a state saved by the same broadphase type.
+         */
+        virtual void SaveState(StateWriter& writer) const = 0;
+        virtual void LoadState(StateReader& reader) = 0;
+
+        virtual const Math::AABB& GetFatAABB(ProxyId proxy) const = 0;
+        virtual uint32_t          GetUserData(ProxyId proxy) const = 0;
+        virtual uint32_t          GetProxyCount() const = 0;
+        virtual BroadphaseType    GetType() const = 0;
+
+        bool TestOverlap(ProxyId a, ProxyId b) const { return GetFatAABB(a).Overlaps(GetFatAABB(b)); }
+
+    protected:
+        static Math::AABB Fatten(const Math::AABB& bounds, const Math::Vec3& displacement);
+
+        /** @brief True if fat still contains bounds and is not much larger than needed. */
+        static bool FatBoxStillValid(const Math::AABB& fat, const Math::AABB& bounds, const Math::Vec3& displacement);
+    };
+
+    /**
+     * @class DynamicAABBTree
+     * @brief Binary tree of fat boxes (one leaf per proxy). Leaves are inserted next
+     *        to the sibling that grows the total surface area least, and AVL-style
+     *        rotations on the way back up keep the tree balanced incrementally.
+     *
+     * UpdatePairs() queries the tree once per moved proxy; large move sets are split
+     * across the Threading::JobSystem. RayCast() walks the tree with packets of
+     * MATH_SIMD_WIDTH adjacent rays, testing one node against the whole packet.
+     */
+    class DynamicAABBTree final : public Broadphase {
+    public:
+        ProxyId CreateProxy(const Math::AABB& bounds, uint32_t userData) override;
+        void    DestroyProxy(ProxyId proxy) override;
+        bool    MoveProxy(ProxyId proxy, const Math::AABB& bounds, const Math::Vec3& displacement) override;
+        void    UpdatePairs(std::vector<ProxyPair>& outPairs) override;
+        void    Query(const Math::AABB& bounds, std::vector<ProxyId>& outProxies) const override;
+        void    RayCast(const BroadphaseRay* rays, uint32_t count, const RayCastCallback& callback) const override;
+        void    SaveState(StateWriter& writer) const override;
+        void    LoadState(StateReader& reader) override;
+
+        const Math::AABB& GetFatAABB(ProxyId proxy) const override { return m_Nodes[proxy].box; }
+        uint32_t          GetUserData(ProxyId proxy) const override { return m_Nodes[proxy].userData; }
+        uint32_t          GetProxyCount() const override { return m_ProxyCount; }
+        BroadphaseType    GetType() const override { return BroadphaseType::DynamicTree; }
+
+        /** @brief Height of the root (0 for a single leaf). */
+        uint32_t GetHeight() const;
+
+        /** @brief Summed surface area of internal nodes over the root's; lower is better. */
+        float GetAreaRatio() const;
+
+    private:
+        static constexpr uint32_t kNullNode = 0xFFFFFFFFu;
+
+        struct Node {
+            Math::AABB box;
+            uint32_t   parent;    // Next free node while on the free list
+            uint32_t   child1;
+            uint32_t   child2;
+            int32_t    height;    // 0 for leaves, -1 for free nodes
+            uint32_t   userData;
+            uint32_t   moved;
+
+            bool IsLeaf() const { return child1 == kNullNode; }
+        };
+
+        uint32_t AllocateNode();
+        void     FreeNode(uint32_t node);
+        void     InsertLeaf(uint32_t leaf);
+        void     RemoveLeaf(uint32_t leaf);
+        uint32_t Balance(uint32_t node);
+        void     QueryPairs(ProxyId proxy, std::vector<ProxyPair>& outPairs) const;
+
+        template <typename Visitor>
+        void Traverse(const Math::AABB& bounds, Visitor&& visitor) const;
+
+        std::vector<Node>    m_Nodes;
+        uint32_t             m_Root = kNullNode;
+        uint32_t             m_FreeList = kNullNode;
+        uint32_t             m_ProxyCount = 0;
+        std::vector<ProxyId> m_MoveBuffer;
+    };
+
+    /**
+     * @class SweepAndPruneBroadphase
+     * @brief Proxies kept sorted by the x minimum of their fat box. UpdatePairs()
+     *        re-sorts with an insertion sort (near linear when motion is coherent)
+     *        and sweeps the moved proxies against the sorted list, so a mostly
+     *        static scene costs one linear pass per step. Teleporting many proxies
+     *        far along x degrades the sort; use the tree for such scenes. Rays have
+     *        no hierarchy to descend and test every box, so ray-heavy scenes also
+     *        want the tree.
+     */
+    class SweepAndPruneBroadphase final : public Broadphase {
+    public:
+        ProxyId CreateProxy(const Math::AABB& bounds, uint32_t userData) override;
+        void    DestroyProxy(ProxyId proxy) override;
+        bool    MoveProxy(ProxyId proxy, const Math::AABB& bounds, const Math::Vec3& displacement) override;
+        void    UpdatePairs(std::vector<ProxyPair>& outPairs) override;
+        void    Query(const Math::AABB& bounds, std::vector<ProxyId>& outProxies) const override;
+        void    RayCast(const BroadphaseRay* rays, uint32_t count, const RayCastCallback& callback) const override;
+        void    SaveState(StateWriter& writer) const override;
+        void    LoadState(StateReader& reader) override;
+
+        const Math::AABB& GetFatAABB(ProxyId proxy) const override { return m_Sorted[m_Proxies[proxy].sortedIndex].box; }
+        uint32_t          GetUserData(ProxyId proxy) const override { return m_Proxies[proxy].userData; }
+        uint32_t          GetProxyCount() const override { return m_ProxyCount; }
+        BroadphaseType    GetType() const override { return BroadphaseType::SweepAndPrune; }
+
+    private:
+        struct Entry {
+            Math::AABB box;
+            ProxyId    proxy;     // InvalidProxy once destroyed (compacted on update)
+        };
+
+        struct Proxy {
+            uint32_t sortedIndex; // Next free proxy while on the free list
+            uint32_t userData;
+            uint32_t moved;
+        };
+
+        void Sort();
+
+        std::vector<Entry>   m_Sorted;
+        std::vector<Proxy>   m_Proxies;
+        std::vector<ProxyId> m_MoveBuffer;
+        std::vector<Entry>   m_MovedEntries;  // Scratch for UpdatePairs()
+        uint32_t             m_FreeList = InvalidProxy;
+        uint32_t             m_ProxyCount = 0;
+        uint32_t             m_Appended = 0;  // Entries pushed unsorted since the last Sort()
+        uint32_t             m_Destroyed = 0; // Dead entries waiting for compaction
+    };
+
+    // ----------------------------------------------------------
+    // Shapes and contacts
+    // ----------------------------------------------------------
+
+    enum class ShapeType : uint8_t {
+        Sphere,
+        Capsule,    // Segment along the local Y axis, inflated by radius
+        Box,
+        ConvexHull,
+        Count
+    };
+
+    /**
+     * @struct CollisionShape
+     * @brief Local-space collision shape. Spheres and capsules are a core point or
+     *        segment plus a radius; boxes and hulls have no radius. Hull vertices
+     *        are not owned and must outlive the shape.
+     */
+    struct CollisionShape {
+        ShapeType         type = ShapeType::Sphere;
+        float             radius = 0.5f;         // Sphere, capsule
+        float             halfHeight = 0.0f;     // Capsule: half the core segment length
+        Math::Vec3        halfExtents{ 0.5f };   // Box
+        const Math::Vec3* hullVertices = nullptr;
+        uint32_t          hullVertexCount = 0;
+
+        static CollisionShape Sphere(float radius);
+        static CollisionShape Capsule(float radius, float halfHeight);
+        static CollisionShape Box(const Math::Vec3& halfExtents);
+        static CollisionShape ConvexHull(const Math::Vec3* vertices, uint32_t count);
+
+        /** @brief World-space bounds of the shape at the given pose. */
+        Math::AABB ComputeAABB(const Math::Vec3& position, const Math::Quat& rotation) const;
+    };
+
+    /**
+     * @struct ContactPoint
+     * @brief One contact. Anchors are stored in body space so the point can be
+     *        tracked across frames; the impulses are the solver's accumulated
+     *        results, carried over for warm starting.
+     */
+    struct ContactPoint {
+        Math::Vec3 localA;            // Surface point of A, in A's frame
+        Math::Vec3 localB;            // Surface point of B, in B's frame
+        Math::Vec3 position;          // World, halfway between the surfaces
+        float      depth = 0.0f;      // Penetration (> 0) or separation (< 0)
+        float      normalImpulse = 0.0f;
+        float      tangentImpulse[2] = { 0.0f, 0.0f };
+    };
+
+    constexpr uint32_t kMaxManifoldPoints = 4;
+    // Separation below which contacts are still reported (speculative contacts)
+    constexpr float kContactMargin = 0.02f;
+
+    /**
+     * @struct ContactManifold
+     * @brief Contacts between two bodies sharing one normal (from A towards B).
+     *        Plain data, so manifold arrays can be copied wholesale.
+     */
+    struct ContactManifold {
+        uint32_t     bodyA = 0;
+        uint32_t     bodyB = 0;
+        Math::Vec3   normal;
+        uint32_t     pointCount = 0;
+        ContactPoint points[kMaxManifoldPoints];
+    };
+
+    /**
+     * @brief Generates the contact manifold of one posed shape pair (scalar path,
+     *        any shape types). Boxes use SAT with face clipping; pairs involving a
+     *        hull, and capsule-box, use GJK on the core shapes with EPA once the
+     *        cores overlap.
+     * @return False if the shapes are separated by more than margin.
+     */
+    bool Collide(const CollisionShape& shapeA, const Math::Vec3& positionA, const Math::Quat& rotationA,
+                 const CollisionShape& shapeB, const Math::Vec3& positionB, const Math::Quat& rotationB,
+                 float margin, ContactManifold& outManifold);
+
+    /**
+     * @struct CastHit
+     * @brief Where a ray or swept shape first touches a posed shape.
+     */
+    struct CastHit {
+        float      distance = 0.0f;   // Along the cast direction; 0 when it starts inside
+        Math::Vec3 position;          // On the surface of the shape that was hit
+        Math::Vec3 normal;            // Surface normal there; minus the direction when it starts inside
+    };
+
+    // Distance from the surface at which a shape cast counts as a hit
+    constexpr float kCastTolerance = 0.001f;
+
+    /**
+     * @brief First hit of a ray (unit direction) with a posed shape within
+     *        maxDistance. Spheres, capsules and boxes are intersected analytically;
+     *        hulls go through ShapeCast() with a point.
+     */
+    bool RayCast(const CollisionShape& shape, const Math::Vec3& position, const Math::Quat& rotation,
+                 const Math::Vec3& origin, const Math::Vec3& direction, float maxDistance, CastHit& outHit);
+
+    /**
+     * @brief First hit of castShape, translated along a unit direction, with a posed
+     *        shape. Conservative advancement on the GJK distance: each step moves the
+     *        shape up to the plane separating the closest points, so it never tunnels,
+     *        and stops within kCastTolerance of the surface.
+     */
+    bool ShapeCast(const CollisionShape& castShape, const Math::Vec3& castPosition, const Math::Quat& castRotation,
+                   const Math::Vec3& direction, float maxDistance,
+                   const CollisionShape& shape, const Math::Vec3& position, const Math::Quat& rotation, CastHit& outHit);
+
+    // ----------------------------------------------------------
+    // Batched kernels
+    // ----------------------------------------------------------
+
+    /**
+     * @struct SegmentPairBatch
+     * @brief SoA batch of sphere/capsule pairs, reduced to core segments plus radii
+     *        (a sphere is a zero-length segment). One contact per pair.
+     */
+    struct SegmentPairBatch {
+        // Inputs
+        std::vector<float> a0[3], a1[3], radiusA;
+        std::vector<float> b0[3], b1[3], radiusB;
+        // Outputs: normal from A to B, depth, and the surface points of A and B
+        std::vector<float> normal[3], depth, pointA[3], pointB[3];
+
+        void   Resize(size_t count);
+        size_t Size() const { return radiusA.size(); }
+    };
+
+    /**
+     * @struct SphereBoxBatch
+     * @brief SoA batch of sphere (A) against oriented box (B) pairs. The box
+     *        rotation is given as its three world-space axes.
+     */
+    struct SphereBoxBatch {
+        // Inputs
+        std::vector<float> center[3], radius;
+        std::vector<float> boxCenter[3], axisX[3], axisY[3], axisZ[3], halfExtents[3];
+        // Outputs, as in SegmentPairBatch
+        std::vector<float> normal[3], depth, pointA[3], pointB[3];
+
+        void   Resize(size_t count);
+        size_t Size() const { return radius.size(); }
+    };
+
+    /** @brief Closest points of [begin, end) in 4 or 8 lanes (see Math/Simd.h). */
+    void CollideSegments(SegmentPairBatch& batch, size_t begin, size_t end);
+    void CollideSphereBoxes(SphereBoxBatch& batch, size_t begin, size_t end);
+
+    /** @brief Reference implementations of the batched kernels. */
+    namespace Scalar {
+        void CollideSegments(SegmentPairBatch& batch, size_t begin, size_t end);
+        void CollideSphereBoxes(SphereBoxBatch& batch, size_t begin, size_t end);
+    }
+
+    // ----------------------------------------------------------
+    // Narrowphase
+    // ----------------------------------------------------------
+
+    struct BodyPair {
+        uint32_t a;
+        uint32_t b;
+    };
+
+    /**
+     * @class NarrowPhase
+     * @brief Turns candidate body pairs into contact manifolds and keeps them
+     *        across frames.
+     *
+     * Pairs are bucketed by shape types: sphere/capsule pairs and sphere-box pairs
+     * are gathered into SoA batches and run through the SIMD kernels, everything
+     * else goes through Collide(). Buckets are split across the
+     * Threading::JobSystem; every pair owns its output slot, so results do not
+     * depend on the thread count.
+     *
+     * A new manifold inherits accumulated impulses from last frame's manifold of
+     * the same body pair, matched by contact anchors. Pairs that produce a single
+     * contact per frame (capsules, GJK) keep still-valid older contacts, so a
+     * resting box or capsule builds up a full manifold over a few frames.
+     */
+    class NarrowPhase {
+    public:
+        /**
+         * @brief Replaces the manifolds with the contacts of the given pairs.
+         * @param shapes, positions, rotations Per-body arrays indexed by BodyPair.
+         */
+        void Collide(const CollisionShape* shapes, const Math::Vec3* positions, const Math::Quat* rotations,
+                     const BodyPair* pairs, uint32_t pairCount, float margin = kContactMargin);
+
+        /**
+         * @brief Touching pairs only, sorted by (bodyA, bodyB); bodyA < bodyB.
+         *        The solver writes its impulses back here; the array itself must
+         *        keep its size and order until the next Collide().
+         */
+        std::vector<ContactManifold>&       GetManifolds() { return m_Manifolds; }
+        const std::vector<ContactManifold>& GetManifolds() const { return m_Manifolds; }
+
+        void Clear() {
+            m_Manifolds.clear();
+            m_ManifoldKeys.clear();
+        }
+
+        /** @brief Saves or restores the cached manifolds (everything kept between frames). */
+        void SaveState(StateWriter& writer) const;
+        void LoadState(StateReader& reader);
+
+    private:
+        std::vector<ContactManifold> m_Manifolds;
+        std::vector<uint64_t>        m_ManifoldKeys;    // (bodyA << 32 | bodyB) per manifold
+        std::vector<ContactManifold> m_Fresh;           // One slot per input pair
+        std::vector<ContactManifold> m_Previous;
+        std::vector<uint64_t>        m_PreviousKeys;
+        std::vector<uint32_t>        m_SegmentPairs, m_SphereBoxPairs, m_GeneralPairs;
+        std::vector<uint8_t>         m_Swapped;    // Pair computed as (b, a)
+        std::vector<std::pair<uint64_t, uint32_t>> m_SortKeys;
+        SegmentPairBatch             m_SegmentBatch;
+        SphereBoxBatch               m_SphereBoxBatch;
+    };
+
+} // namespace Physics
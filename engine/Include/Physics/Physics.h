@@ -0,0 +1,360 @@
+#pragma once
+
+#include "Physics/Collision.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Physics {
+
+    using BodyId = uint32_t;
+    using JointId = uint32_t;
+    constexpr BodyId InvalidBody = 0xFFFFFFFFu;
+
+    enum class BodyType : uint8_t {
+        Static,     // Never moves; infinite mass
+        Dynamic
+    };
+
+    /**
+     * @struct BodyDesc
+     * @brief Everything needed to create a rigid body. Mass is ignored for
+     *        static bodies; the inertia tensor follows from the shape.
+     */
+    struct BodyDesc {
+        BodyType       type = BodyType::Dynamic;
+        CollisionShape shape;
+        Math::Vec3     position;
+        Math::Quat     rotation;
+        Math::Vec3     linearVelocity;
+        Math::Vec3     angularVelocity;
+        float          mass = 1.0f;
+        float          friction = 0.6f;
+        float          restitution = 0.0f;
+        float          linearDamping = 0.0f;
+        float          angularDamping = 0.05f;
+        bool           allowSleep = true;
+    };
+
+    /**
+     * @struct WorldSettings
+     * @brief Solver and sleeping parameters of a PhysicsWorld.
+     */
+    struct WorldSettings {
+        Math::Vec3     gravity{ 0.0f, -9.81f, 0.0f };
+        uint32_t       velocityIterations = 10;
+        float          baumgarte = 0.2f;               // Fraction of penetration removed per step
+        float          linearSlop = 0.005f;            // Penetration left alone, for stable contact
+        float          maxCorrectionVelocity = 2.0f;   // Cap on the push-out velocity (m/s)
+        float          restitutionThreshold = 1.0f;    // Slower impacts do not bounce (m/s)
+        float          sleepLinearVelocity = 0.05f;    // m/s
+        float          sleepAngularVelocity = 0.05f;   // rad/s
+        float          timeToSleep = 0.5f;             // Seconds an island must stay slow
+        BroadphaseType broadphase = BroadphaseType::DynamicTree;
+    };
+
+    // ------ SCENE QUERIES ------
+
+    struct RayQuery {
+        Math::Vec3 origin;
+        Math::Vec3 direction;              // Unit length
+        float      maxDistance = 1000.0f;
+        BodyId     ignore = InvalidBody;   // E.g. the body a line of sight starts from
+    };
+
+    struct ShapeCastQuery {
+        CollisionShape shape;
+        Math::Vec3     position;
+        Math::Quat     rotation;
+        Math::Vec3     direction;          // Unit length
+        float          maxDistance = 1000.0f;
+        BodyId         ignore = InvalidBody;
+    };
+
+    struct OverlapQuery {
+        CollisionShape shape;
+        Math::Vec3     position;
+        Math::Quat     rotation;
+        BodyId         ignore = InvalidBody;
+    };
+
+    /**
+     * @struct QueryHit
+     * @brief Closest hit of a ray or shape cast; body is InvalidBody on a miss.
+     *        Casts that start inside a body report distance 0 and the reversed
+     *        cast direction as normal.
+     */
+    struct QueryHit {
+        BodyId     body = InvalidBody;
+        float      distance = 0.0f;
+        Math::Vec3 position;
+        Math::Vec3 normal;
+    };
+
+    // ------ SNAPSHOTS ------
+
+    enum class SnapshotMode {
+        Full,   // Copy every body
+        Delta   // Copy only bodies changed since the snapshot was last saved
+    };
+
+    /**
+     * @class PhysicsSnapshot
+     * @brief Saved state of a PhysicsWorld, for rollback. Opaque; its buffers are
+     *        kept between saves, so reusing a snapshot does not allocate once it
+     *        has grown to the size of the world.
+     */
+    class PhysicsSnapshot {
+    public:
+        /** @brief Bytes of saved state. */
+        size_t GetSize() const { return m_BodyData.size() + m_SharedSize; }
+        uint32_t GetBodyCount() const { return m_BodyCount; }
+
+    private:
+        friend class PhysicsWorld;
+
+        uint64_t             m_WorldId = 0;     // 0 until first saved
+        uint64_t             m_Version = 0;     // World version at the last save
+        uint32_t             m_BodyCount = 0;
+        std::vector<uint8_t> m_BodyData;        // One block per per-body array, bodyCount entries each
+        std::vector<uint8_t> m_Shared;          // Joints, pairs, contacts, sleeping islands, broadphase
+        size_t               m_SharedSize = 0;  // Used part of m_Shared
+    };
+
+    /**
+     * @class PhysicsWorld
+     * @brief Rigid-body simulation with contact and joint islands.
+     *
+     * A step collides the awake bodies (broadphase, then NarrowPhase), links
+     * touching dynamic bodies and joints into islands, and solves every island
+     * on its own with a sequential-impulse solver. Islands run in parallel on the
+     * Threading::JobSystem; each one touches only its own bodies, so results are
+     * the same for any thread count.
+     *
+     * An island whose bodies all stay slow for timeToSleep goes to sleep: its
+     * bodies drop out of every stage of the step and its contacts are set aside
+     * unchanged. It wakes as a whole when an awake body touches it, through a
+     * joint, or when one of its bodies is changed through the API.
+     *
+     * Scene queries take whole batches, run them against the broadphase and the
+     * poses of the last step, and write into caller-owned arrays. Each query owns
+     * its result slots, so batches are split across the job system.
+     *
+     * Per-body state is kept in parallel arrays indexed by BodyId. Snapshots copy
+     * each array with one memcpy; every body carries the version in which it last
+     * changed, so a delta snapshot copies only the runs of bodies that moved.
+     */
+    class PhysicsWorld {
+    public:
+        explicit PhysicsWorld(const WorldSettings& settings = WorldSettings());
+
+        BodyId CreateBody(const BodyDesc& desc);
+
+        /**
+         * @brief Connects two bodies at a world-space point (ball-and-socket).
+         *        Jointed bodies do not collide with each other.
+         */
+        JointId CreateBallJoint(BodyId a, BodyId b, const Math::Vec3& worldAnchor);
+
+        /** @brief Advances the simulation by dt seconds. */
+        void Step(float dt);
+
+        // ------ BODIES ------
+        uint32_t          GetBodyCount() const { return static_cast<uint32_t>(m_Positions.size()); }
+        BodyType          GetBodyType(BodyId body) const;
+        const Math::Vec3& GetPosition(BodyId body) const { return m_Positions[body]; }
+        const Math::Quat& GetRotation(BodyId body) const { return m_Rotations[body]; }
+        const Math::Vec3& GetLinearVelocity(BodyId body) const { return m_LinearVelocities[body]; }
+        const Math::Vec3& GetAngularVelocity(BodyId body) const { return m_AngularVelocities[body]; }
+        const CollisionShape& GetShape(BodyId body) const { return m_Shapes[body]; }
+
+        // Setters wake the body (and its island)
+        void SetTransform(BodyId body, const Math::Vec3& position, const Math::Quat& rotation);
+        void SetLinearVelocity(BodyId body, const Math::Vec3& velocity);
+        void SetAngularVelocity(BodyId body, const Math::Vec3& velocity);
+        void ApplyLinearImpulse(BodyId body, const Math::Vec3& impulse, const Math::Vec3& worldPoint);
+
+        bool IsAwake(BodyId body) const;
+        void WakeBody(BodyId body);
+
+        // ------ STATISTICS (of the last step) ------
+        uint32_t GetAwakeBodyCount() const { return static_cast<uint32_t>(m_AwakeBodies.size()); }
+        uint32_t GetIslandCount() const { return m_IslandCount; }
+        uint32_t GetSleepingIslandCount() const;
+        uint32_t GetContactCount() const { return static_cast<uint32_t>(m_Contacts.size()); }
+
+        const WorldSettings& GetSettings() const { return m_Settings; }
+
+        // ------ SCENE QUERIES ------
+
+        /**
+         * @brief Closest hit of each ray. Adjacent rays share one tree traversal
+         *        (packets of MATH_SIMD_WIDTH), so batches ordered by origin and
+         *        direction run fastest.
+         */
+        void RayCast(const RayQuery* rays, uint32_t count, QueryHit* outHits) const;
+
+        /** @brief First hit of each shape translated along its direction. */
+        void ShapeCast(const ShapeCastQuery* casts, uint32_t count, QueryHit* outHits) const;
+
+        /**
+         * @brief Bodies touching each shape, sorted by id. Query i writes up to
+         *        maxBodiesPerQuery ids to outBodies + i * maxBodiesPerQuery, and its
+         *        full count (which may be larger) to outCounts[i].
+         */
+        void Overlap(const OverlapQuery* queries, uint32_t count, BodyId* outBodies, uint32_t maxBodiesPerQuery, uint32_t* outCounts) const;
+
+        // ------ SNAPSHOTS ------
+
+        /**
+         * @brief Saves the whole simulation state: bodies, joints, cached contacts,
+         *        sleeping islands and the broadphase. Settings are not saved.
+         *        Delta mode rewrites only the bodies changed since the snapshot was
+         *        last saved; it falls back to a full save for a
+         *        snapshot of another world or another body count.
+         */
+        void SaveSnapshot(PhysicsSnapshot& snapshot, SnapshotMode mode = SnapshotMode::Full);
+
+        /**
+         * @brief Puts the world back into the saved state; stepping afterwards gives
+         *        the same results as stepping after the save did. Bodies created
+         *        since are removed. Delta mode copies back only the bodies changed
+         *        since, and falls back like SaveSnapshot(). The snapshot must come
+         *        from a world with the same broadphase type. Island and contact
+         *        statistics read zero until the next step.
+         */
+        void RestoreSnapshot(const PhysicsSnapshot& snapshot, SnapshotMode mode = SnapshotMode::Full);
+
+    private:
+        struct BallJoint {
+            BodyId     bodyA;
+            BodyId     bodyB;
+            Math::Vec3 localAnchorA;
+            Math::Vec3 localAnchorB;
+            Math::Vec3 impulse;        // Accumulated, for warm starting
+        };
+
+        // An island at rest: its bodies and the contacts it had when it fell
+        // asleep, as ranges of m_SleepingBodies and m_SleepingContacts. Freed
+        // islands have empty ranges.
+        struct SleepingIsland {
+            uint32_t bodyStart = 0, bodyCount = 0;
+            uint32_t contactStart = 0, contactCount = 0;
+        };
+
+        // ------ SOLVER STATE (rebuilt every step) ------
+        static constexpr uint32_t kAwake = 0xFFFFFFFFu;
+        static constexpr uint32_t kStaticSlot = 0xFFFFFFFFu;
+
+        // Velocities of an awake dynamic body while its island is solved
+        struct SolverBody {
+            Math::Vec3 linearVelocity;
+            Math::Vec3 angularVelocity;
+            Math::Vec3 invInertia[3];   // World-space inverse inertia, by rows
+            float      invMass;
+        };
+
+        struct ContactConstraintPoint {
+            Math::Vec3 rA, rB;          // From the centres of mass to the contact
+            float      normalMass;
+            float      tangentMass[2];
+            float      velocityBias;
+        };
+
+        struct ContactConstraint {
+            ContactManifold*       manifold;
+            uint32_t               slotA, slotB;    // Into m_SolverBodies, or kStaticSlot
+            Math::Vec3             tangent[2];
+            float                  friction;
+            ContactConstraintPoint points[kMaxManifoldPoints];
+        };
+
+        struct JointConstraint {
+            uint32_t   joint;
+            uint32_t   slotA, slotB;
+            Math::Vec3 rA, rB;
+            Math::Vec3 mass[3];         // Inverse of the 3x3 effective mass, by rows
+            Math::Vec3 bias;
+        };
+
+        bool IsDynamic(BodyId body) const { return m_InvMasses[body] > 0.0f; }
+        bool IsAwakeDynamic(BodyId body) const { return IsDynamic(body) && m_SleepingIsland[body] == kAwake; }
+        bool ShouldCollide(BodyId a, BodyId b) const;
+        void WakeIsland(uint32_t sleepingIsland);
+
+        void UpdatePairs();
+        void MoveProxies(float dt);
+        void Collide();
+        void BuildIslands();
+        void SolveIsland(uint32_t island, float dt);
+        void SleepIslands();
+        void CompactSleepingIslands();
+        void FindChangedRuns(uint64_t since);
+
+        // Calls f(array) for every persistent per-body array
+        template <typename F>
+        void ForEachBodyArray(F&& f);
+
+        WorldSettings m_Settings;
+
+        // Per body
+        std::vector<Math::Vec3>     m_Positions;
+        std::vector<Math::Quat>     m_Rotations;
+        std::vector<Math::Vec3>     m_LinearVelocities;
+        std::vector<Math::Vec3>     m_AngularVelocities;
+        std::vector<CollisionShape> m_Shapes;
+        std::vector<float>          m_InvMasses;          // 0 for static bodies
+        std::vector<Math::Vec3>     m_InvInertiaLocal;    // Diagonal, in body space
+        std::vector<float>          m_Friction;
+        std::vector<float>          m_Restitution;
+        std::vector<float>          m_LinearDamping;
+        std::vector<float>          m_AngularDamping;
+        std::vector<uint8_t>        m_AllowSleep;
+        std::vector<float>          m_SleepTime;
+        std::vector<uint32_t>       m_SleepingIsland;     // kAwake, or index into m_SleepingIslands
+        std::vector<ProxyId>        m_Proxies;
+        std::vector<uint32_t>       m_Parent;             // Union-find, then island index
+        std::vector<uint32_t>       m_Slot;               // Position in m_IslandBodies
+        std::vector<uint64_t>       m_Changed;            // m_Version of the last change
+
+        std::vector<BallJoint>      m_Joints;
+        std::vector<BodyPair>       m_JointPairs;         // Sorted, for ShouldCollide()
+
+        // Collision
+        std::unique_ptr<Broadphase>   m_Broadphase;
+        NarrowPhase                   m_NarrowPhase;
+        std::vector<ProxyPair>        m_NewProxyPairs;
+        std::vector<BodyPair>         m_Pairs;            // Persistent, sorted by (a, b)
+        std::vector<BodyPair>         m_NewPairs;
+        std::vector<BodyPair>         m_ActivePairs;      // Pairs with an awake dynamic body
+        std::vector<ContactManifold>  m_WokenContacts;    // Of islands woken this step
+        std::vector<ContactManifold*> m_Contacts;         // Touching, with an awake body
+
+        // Islands of the current step: CSR ranges into the flat arrays below
+        std::vector<BodyId>            m_AwakeBodies;     // Sorted
+        uint32_t                       m_IslandCount = 0;
+        std::vector<uint32_t>          m_IslandBodyStart, m_IslandContactStart, m_IslandJointStart;
+        std::vector<BodyId>            m_IslandBodies;
+        std::vector<ContactManifold*>  m_IslandContacts;
+        std::vector<uint32_t>          m_IslandJoints;
+        std::vector<uint8_t>           m_IslandSleepy;
+        std::vector<uint32_t>          m_Cursor;
+        std::vector<uint32_t>          m_IslandOrder;     // Largest first, for load balance
+        std::vector<uint32_t>          m_JobStart;        // Ranges of m_IslandOrder per job
+        std::vector<SolverBody>        m_SolverBodies;
+        std::vector<ContactConstraint> m_ContactConstraints;
+        std::vector<JointConstraint>   m_JointConstraints;
+
+        std::vector<SleepingIsland>  m_SleepingIslands;
+        std::vector<uint32_t>        m_FreeSleepingIslands;
+        std::vector<BodyId>          m_SleepingBodies;
+        std::vector<ContactManifold> m_SleepingContacts;
+
+        // Snapshots
+        uint64_t                     m_WorldId;
+        uint64_t                     m_Version = 1;     // Bumped by every save
+        std::vector<uint32_t>        m_ChangedRuns;     // (start, count) pairs, scratch
+    };
+
+} // namespace Physics
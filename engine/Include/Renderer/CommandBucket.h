@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Renderer/RenderCommand.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Renderer {
+
+    class RenderBackend;
+
+    /**
+     * @class CommandBucket
+     * @brief Collects draw commands from many threads and replays them sorted.
+     *
+     * Per frame:
+     *  - any job/worker calls Submit(key, command); each thread appends to its own
+     *    list (indexed by Threading::JobSystem::GetThreadIndex()), so no locking,
+     *  - the owning thread calls Sort() once: the lists are merged and radix-sorted by key,
+     *  - Execute(backend) replays the sorted stream,
+     *  - Reset() empties the bucket but keeps its capacity for the next frame.
+     *
+     * Equal keys keep submission order within a thread; their order across threads
+     * is unspecified.
+     *
+     * The thread lists are sized at Reset(). A thread with no list of its own (the
+     * bucket was reset before JobSystem::Init(), or with fewer workers) records
+     * into a shared list under a lock instead, and a warning is logged once per frame.
+     */
+    class CommandBucket {
+    public:
+        CommandBucket();
+
+        /** @brief Records one draw. Thread-safe across job-system threads. */
+        void Submit(uint64_t key, const DrawCommand& command);
+
+        /**
+         * @brief Merges the per-thread keys and sorts them by key. Commands are not
+         *        copied; they stay in their thread list until Reset(). Not thread-safe.
+         */
+        void Sort();
+
+        /** @brief Replays the sorted commands, binding shader/material only on change. */
+        void Execute(RenderBackend& backend) const;
+
+        /** @brief Drops all commands, keeping allocations. Also adapts to the current thread count. */
+        void Reset();
+
+        /** @brief Number of commands (valid after Sort()). */
+        size_t GetCount() const { return m_SortedKeys.size(); }
+
+        // Sorted access, valid after Sort()
+        uint64_t           GetKey(size_t i) const { return m_SortedKeys[i]; }
+        const DrawCommand& GetCommand(size_t i) const { return Resolve(m_SortedIndices[i]); }
+
+    private:
+        // Sorted values reference commands in place: thread in the top 8 bits, index below
+        static constexpr uint32_t kThreadShift = 24;
+        static constexpr uint32_t kIndexMask = (1u << kThreadShift) - 1;
+        static constexpr uint32_t kSharedList = (1u << (32 - kThreadShift)) - 1;
+
+        const DrawCommand& Resolve(uint32_t ref) const {
+            const uint32_t thread = ref >> kThreadShift;
+            return (thread == kSharedList ? m_SharedList : m_ThreadLists[thread]).commands[ref & kIndexMask];
+        }
+
+        struct alignas(64) ThreadList {
+            std::vector<uint64_t>    keys;
+            std::vector<DrawCommand> commands;
+        };
+
+        std::vector<ThreadList>  m_ThreadLists;
+
+        // Threads without a list of their own
+        ThreadList               m_SharedList;
+        std::mutex               m_SharedMutex;
+        bool                     m_SharedWarned = false;
+
+        // Merged keys and command references filled by Sort()
+        std::vector<uint64_t>    m_SortedKeys;
+        std::vector<uint32_t>    m_SortedIndices;
+
+        // Radix sort ping-pong buffers
+        std::vector<uint64_t>    m_ScratchKeys;
+        std::vector<uint32_t>    m_ScratchIndices;
+    };
+
+    /**
+     * @brief Stable LSD radix sort of (key, value) pairs by key, 8 bits per pass.
+     *        Passes whose byte is identical for every key are skipped.
+     *        scratch buffers must hold count elements; the result ends up in keys/values.
+     */
+    void RadixSort(uint64_t* keys, uint32_t* values, uint64_t* scratchKeys, uint32_t* scratchValues, size_t count);
+
+} // namespace Renderer
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Math/Geometry.h"
+
+#include <cstdint>
+#include <vector>
+
+class LinearAllocator;
+
+namespace Renderer {
+
+    using CullProxy = uint32_t;
+    constexpr CullProxy InvalidCullProxy = 0xFFFFFFFFu;
+
+    /**
+     * @struct VisibleList
+     * @brief Result of a cull: user data of the visible proxies, in tree order.
+     *        The storage belongs to the scratch allocator passed to Cull().
+     */
+    struct VisibleList {
+        const uint32_t* items = nullptr;
+        uint32_t        count = 0;
+    };
+
+    /**
+     * @class CullingBVH
+     * @brief Bounding-volume hierarchy over renderable bounds for frustum culling.
+     *
+     * Nodes are stored in depth-first order (left child = node + 1) and every node
+     * owns a contiguous range of objects, whose bounds are kept in SoA arrays so a
+     * leaf is tested with the Math::CullAABBs batch kernel (4 or 8 boxes at a time).
+     *
+     * Insert()/Remove() change the structure and trigger a full rebuild on the next
+     * Update(); Move() only refits the affected leaves and their ancestors. When
+     * refitting has inflated the tree too much it is rebuilt as well.
+     *
+     * Cull() splits the tree into subtrees and traverses them in parallel on the
+     * Threading::JobSystem; each job writes into its own slice of scratch memory.
+     */
+    class CullingBVH {
+    public:
+        CullingBVH() = default;
+
+        /** @brief Adds a proxy; userData is what Cull() reports when it is visible. */
+        CullProxy Insert(const Math::AABB& bounds, uint32_t userData);
+
+        /** @brief Updates the bounds of a proxy (refit on the next Update()). */
+        void Move(CullProxy proxy, const Math::AABB& bounds);
+
+        void Remove(CullProxy proxy);
+
+        bool              IsValid(CullProxy proxy) const;
+        const Math::AABB& GetBounds(CullProxy proxy) const { return m_Bounds[proxy]; }
+        uint32_t          GetCount() const { return m_AliveCount; }
+
+        /**
+         * @brief Applies pending changes: rebuilds after structural changes (or heavy
+         *        refit degradation), otherwise refits the moved leaves only.
+         */
+        void Update();
+
+        /**
+         * @brief Returns the user data of every proxy whose bounds are not fully
+         *        outside the frustum (conservative, as of the last Update()).
+         *        Publishes the "Culling.Visible" and "Culling.Tested" counters.
+         * @param scratch Per-frame allocator that receives the result.
+         */
+        VisibleList Cull(const Math::Frustum& frustum, LinearAllocator& scratch) const;
+
+        uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Nodes.size()); }
+        uint32_t GetRebuildCount() const { return m_RebuildCount; }
+
+    private:
+        struct Node {
+            Math::AABB bounds;
+            uint32_t   first = 0; // First object position
+            uint32_t   count = 0; // Number of objects in the subtree
+            uint32_t   skip = 0;  // Node after this subtree; node + 1 means leaf
+        };
+
+        struct BuildItem {
+            Math::AABB bounds;
+            CullProxy  proxy;
+        };
+
+        void     Rebuild();
+        uint32_t BuildNode(BuildItem* items, uint32_t first, uint32_t count);
+        void     Refit();
+        float    ComputeCost() const;
+
+        // Traverses the subtree of rootNode; returns the number of items written
+        uint32_t CullSubtree(const Math::Frustum& frustum, uint32_t rootNode, uint32_t* out, uint32_t& tested) const;
+
+        // ---- Per proxy ----
+        std::vector<Math::AABB> m_Bounds;
+        std::vector<uint32_t>   m_UserData;
+        std::vector<uint32_t>   m_LeafOf;   // Leaf node holding the proxy
+        std::vector<uint32_t>   m_PositionOf;
+        std::vector<uint8_t>    m_Alive;
+        std::vector<CullProxy>  m_FreeProxies;
+
+        // ---- Per object position, in tree order ----
+        std::vector<float>      m_MinX, m_MinY, m_MinZ, m_MaxX, m_MaxY, m_MaxZ;
+        std::vector<uint32_t>   m_ItemOf;   // User data
+
+        std::vector<Node>       m_Nodes;
+        std::vector<uint8_t>    m_NodeDirty;
+
+        float    m_BuiltCost = 0.0f;
+        uint32_t m_AliveCount = 0;
+        uint32_t m_RebuildCount = 0;
+        bool     m_StructureDirty = false;
+        bool     m_BoundsDirty = false;
+    };
+
+} // namespace Renderer
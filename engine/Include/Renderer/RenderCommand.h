@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Math/Matrix.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Renderer {
+
+    /**
+     * @brief 64-bit draw sort key. Fields from most to least significant:
+     *
+     *   | layer:4 | pass:4 | shader:12 | material:20 | depth:24 |
+     *
+     * Sorting keys ascending therefore groups draws by layer, then pass, then
+     * shader and material (minimizing state changes), and finally by depth.
+     */
+    namespace SortKey {
+
+        constexpr uint32_t kLayerBits = 4;
+        constexpr uint32_t kPassBits = 4;
+        constexpr uint32_t kShaderBits = 12;
+        constexpr uint32_t kMaterialBits = 20;
+        constexpr uint32_t kDepthBits = 24;
+
+        constexpr uint32_t kDepthShift = 0;
+        constexpr uint32_t kMaterialShift = kDepthShift + kDepthBits;
+        constexpr uint32_t kShaderShift = kMaterialShift + kMaterialBits;
+        constexpr uint32_t kPassShift = kShaderShift + kShaderBits;
+        constexpr uint32_t kLayerShift = kPassShift + kPassBits;
+
+        constexpr uint64_t Mask(uint32_t bits) { return (uint64_t(1) << bits) - 1; }
+
+        /** @brief Packs the fields; values wider than their field are truncated. */
+        constexpr uint64_t Make(uint32_t layer, uint32_t pass, uint32_t shader, uint32_t material, uint32_t depth) {
+            return ((uint64_t(layer) & Mask(kLayerBits)) << kLayerShift)
+                 | ((uint64_t(pass) & Mask(kPassBits)) << kPassShift)
+                 | ((uint64_t(shader) & Mask(kShaderBits)) << kShaderShift)
+                 | ((uint64_t(material) & Mask(kMaterialBits)) << kMaterialShift)
+                 | ((uint64_t(depth) & Mask(kDepthBits)) << kDepthShift);
+        }
+
+        /**
+         * @brief Maps a normalized depth in [0, 1] to the depth field. Opaque passes
+         *        sort front-to-back; translucent passes want backToFront = true.
+         */
+        inline uint32_t QuantizeDepth(float depth01, bool backToFront = false) {
+            depth01 = std::min(std::max(depth01, 0.0f), 1.0f);
+            uint32_t d = static_cast<uint32_t>(depth01 * float(Mask(kDepthBits)));
+            return backToFront ? uint32_t(Mask(kDepthBits)) - d : d;
+        }
+
+        constexpr uint32_t GetLayer(uint64_t key) { return uint32_t((key >> kLayerShift) & Mask(kLayerBits)); }
+        constexpr uint32_t GetPass(uint64_t key) { return uint32_t((key >> kPassShift) & Mask(kPassBits)); }
+        constexpr uint32_t GetShader(uint64_t key) { return uint32_t((key >> kShaderShift) & Mask(kShaderBits)); }
+        constexpr uint32_t GetMaterial(uint64_t key) { return uint32_t((key >> kMaterialShift) & Mask(kMaterialBits)); }
+        constexpr uint32_t GetDepth(uint64_t key) { return uint32_t((key >> kDepthShift) & Mask(kDepthBits)); }
+
+    } // namespace SortKey
+
+    /**
+     * @struct DrawCommand
+     * @brief One backend-agnostic draw. Resource ids are whatever the backend
+     *        registered them as (e.g. GL names or software-rasterizer mesh slots).
+     */
+    struct DrawCommand {
+        Math::Mat4 world;              // Object-to-world transform
+        uint32_t   shader = 0;
+        uint32_t   material = 0;
+        uint32_t   mesh = 0;
+        uint32_t   firstIndex = 0;
+        uint32_t   indexCount = 0;
+        uint32_t   instanceCount = 1;
+    };
+
+} // namespace Renderer
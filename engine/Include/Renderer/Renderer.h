@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Renderer/RenderCommand.h"
+#include "Renderer/SoftwareRasterizer.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Renderer {
+
+    /**
+     * @class RenderBackend
+     * @brief Consumer of a sorted command stream. CommandBucket::Execute() only
+     *        calls BindShader/BindMaterial when the bound id actually changes.
+     */
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() = default;
+
+        virtual void BeginFrame() = 0;
+        virtual void BindShader(uint32_t shader) = 0;
+        virtual void BindMaterial(uint32_t material) = 0;
+        virtual void Draw(const DrawCommand& command) = 0;
+        virtual void EndFrame() = 0;
+    };
+
+    /**
+     * @class NullRenderBackend
+     * @brief GPU-less backend that counts (and optionally records) what it is asked
+     *        to do, so the whole command pipeline can be tested and benchmarked headless.
+     */
+    class NullRenderBackend : public RenderBackend {
+    public:
+        struct Stats {
+            uint32_t frames = 0;
+            uint32_t draws = 0;
+            uint32_t shaderBinds = 0;
+            uint32_t materialBinds = 0;
+        };
+
+        /**
+         * @param recordDraws Keep a copy of every draw of the current frame (tests);
+         *                    leave off for benchmarks.
+         */
+        explicit NullRenderBackend(bool recordDraws = false) : m_RecordDraws(recordDraws) {}
+
+        void BeginFrame() override;
+        void BindShader(uint32_t shader) override;
+        void BindMaterial(uint32_t material) override;
+        void Draw(const DrawCommand& command) override;
+        void EndFrame() override;
+
+        const Stats& GetStats() const { return m_Stats; }
+        const std::vector<DrawCommand>& GetRecordedDraws() const { return m_Draws; }
+
+    private:
+        bool                     m_RecordDraws;
+        Stats                    m_Stats;
+        std::vector<DrawCommand> m_Draws;
+    };
+
+    /**
+     * @class SoftwareRenderBackend
+     * @brief Headless backend that draws registered meshes with the SoftwareRasterizer,
+     *        flat-shaded per triangle in the material colour under a fixed directional
+     *        light. Used for golden-image tests without a GPU.
+     */
+    class SoftwareRenderBackend : public RenderBackend {
+    public:
+        SoftwareRenderBackend(uint32_t width, uint32_t height) : m_Rasterizer(width, height) {}
+
+        /** @brief Makes a triangle list available to DrawCommand::mesh == mesh. */
+        void RegisterMesh(uint32_t mesh, std::vector<Math::Vec3> positions, std::vector<uint32_t> indices);
+
+        void SetViewProjection(const Math::Mat4& viewProjection) { m_ViewProjection = viewProjection; }
+
+        /** @brief Overrides the colour of a material (0xAABBGGRR); others get a stable palette colour. */
+        void SetMaterialColor(uint32_t material, uint32_t color) { m_MaterialColors[material] = color; }
+
+        void BeginFrame() override;
+        void BindShader(uint32_t shader) override;
+        void BindMaterial(uint32_t material) override;
+        void Draw(const DrawCommand& command) override;
+        void EndFrame() override;
+
+        const SoftwareRasterizer& GetRasterizer() const { return m_Rasterizer; }
+
+    private:
+        struct Mesh {
+            std::vector<Math::Vec3> positions;
+            std::vector<uint32_t>   indices;
+        };
+
+        SoftwareRasterizer                     m_Rasterizer;
+        Math::Mat4                             m_ViewProjection;
+        std::unordered_map<uint32_t, Mesh>     m_Meshes;
+        std::unordered_map<uint32_t, uint32_t> m_MaterialColors;
+        uint32_t                               m_Color = 0xFFFFFFFFu;
+    };
+
+} // namespace Renderer
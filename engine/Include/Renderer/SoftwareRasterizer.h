@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Math/Geometry.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Renderer {
+
+    /**
+     * @class SoftwareRasterizer
+     * @brief Tile-based CPU rasterizer with a depth buffer and an optional colour buffer.
+     *
+     * Per frame:
+     *  - Clear(),
+     *  - SubmitTriangles() any number of times: vertices are transformed, clipped
+     *    against the near plane, back-face culled, set up and binned into screen
+     *    tiles (kTileSize pixels square) on the calling thread,
+     *  - Rasterize(): tiles are rasterized in parallel on the Threading::JobSystem
+     *    with SIMD edge functions (8 or 4 pixels at a time, see Math/Simd.h). Each
+     *    tile owns its pixels and replays its triangles in submission order, so the
+     *    image does not depend on the thread count.
+     *
+     * After Rasterize() the depth buffer can be used for occlusion queries
+     * (TestAABB/TestAABBs) and the colour buffer as a headless framebuffer.
+     *
+     * Depth is NDC z remapped to [0, 1] (OpenGL clip space), compared with less-than.
+     * Pixel (0, 0) is the top-left corner; colours are 0xAABBGGRR.
+     */
+    class SoftwareRasterizer {
+    public:
+        static constexpr uint32_t kTileSize = 32;
+
+        SoftwareRasterizer(uint32_t width, uint32_t height);
+
+        /** @brief Resets depth and colour and drops all binned triangles. */
+        void Clear(float depth = 1.0f, uint32_t color = 0xFF000000u);
+
+        /**
+         * @brief Bins indexed triangles (counter-clockwise front faces) for the next Rasterize().
+         * @param modelViewProjection Object to clip space transform.
+         * @param color Flat colour written for every covered pixel (ignored when
+         *              the colour buffer is disabled).
+         */
+        void SubmitTriangles(const Math::Mat4& modelViewProjection, const Math::Vec3* positions,
+                             const uint32_t* indices, uint32_t indexCount, uint32_t color = 0xFFFFFFFFu);
+
+        /**
+         * @brief Rasterizes everything binned since the last Rasterize()/Clear().
+         *        Publishes the "Rasterizer.Triangles" counter.
+         */
+        void Rasterize();
+
+        /**
+         * @brief Conservative occlusion query against the depth buffer.
+         * @return False only if every pixel the box could cover already holds
+         *         something closer than the nearest point of the box.
+         */
+        bool TestAABB(const Math::Mat4& viewProjection, const Math::AABB& box) const;
+
+        /**
+         * @brief Tests count boxes in parallel; visible[i] is 1 if box i may be visible.
+         *        Publishes the "Occlusion.Tested" and "Occlusion.Culled" counters.
+         * @return Number of boxes culled.
+         */
+        uint32_t TestAABBs(const Math::Mat4& viewProjection, const Math::AABB* boxes, uint32_t count, uint8_t* visible) const;
+
+        /** @brief Disables the colour buffer (depth-only occlusion rendering). */
+        void SetColorEnabled(bool enabled) { m_ColorEnabled = enabled; }
+
+        uint32_t GetWidth() const { return m_Width; }
+        uint32_t GetHeight() const { return m_Height; }
+        float    GetDepth(uint32_t x, uint32_t y) const { return m_Depth[y * m_Stride + x]; }
+        uint32_t GetColor(uint32_t x, uint32_t y) const { return m_Color[y * m_Stride + x]; }
+
+        /** @brief Triangles binned since the last Clear() (after clipping and culling). */
+        uint32_t GetTriangleCount() const { return static_cast<uint32_t>(m_Triangles.size()); }
+
+        /** @brief Copies the visible colour image into tightly packed rows. */
+        std::vector<uint32_t> ReadColor() const;
+
+        /** @brief Writes the colour image as a binary PPM. */
+        bool SaveColorPPM(const std::string& path) const;
+
+    private:
+        // Screen-space setup shared by all tiles a triangle touches
+        struct Triangle {
+            float    edgeA[3], edgeB[3], edgeC[3];
+            float    edgeBias[3];        // 0 for top-left edges, smallest positive float otherwise
+            float    depthA, depthB, depthC;
+            int32_t  minX, minY, maxX, maxY;
+            uint32_t color;
+        };
+
+        struct Tile {
+            std::vector<uint32_t> triangles;
+            float                 maxDepth = 1.0f;
+        };
+
+        void SetupTriangle(const Math::Vec4& c0, const Math::Vec4& c1, const Math::Vec4& c2, uint32_t color);
+        void RasterizeTile(uint32_t tileIndex);
+
+        uint32_t m_Width;
+        uint32_t m_Height;
+        uint32_t m_Stride;     // Padded to whole tiles
+        uint32_t m_TilesX;
+        uint32_t m_TilesY;
+        bool     m_ColorEnabled = true;
+
+        std::vector<float>    m_Depth;
+        std::vector<uint32_t> m_Color;
+        std::vector<Triangle> m_Triangles;
+        std::vector<Tile>     m_Tiles;
+        size_t                m_RasterizedCount = 0;
+    };
+
+} // namespace Renderer
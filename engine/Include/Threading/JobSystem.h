@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace Threading {
+
+    /**
+     * @struct JobArgs
+     * @brief Arguments handed to every job launched through JobSystem::Dispatch.
+     */
+    struct JobArgs {
+        uint32_t jobIndex;    // Index of this job within the whole dispatch
+        uint32_t groupIndex;  // Index of the group this job belongs to
+        uint32_t groupID;     // Index of this job inside its group
+    };
+
+    /**
+     * @struct JobContext
+     * @brief Tracks the outstanding jobs of one batch so callers can wait on it.
+     *        A context may be reused once Wait() has returned.
+     */
+    struct JobContext {
+        std::atomic<uint32_t> pending{ 0 };
+    };
+
+    /**
+     * @class JobSystem
+     * @brief A static fixed-size worker pool that runs small jobs.
+     *
+     * Typical usage:
+     *  - Once at startup:   Threading::JobSystem::Init();
+     *  - Fire jobs:         JobSystem::Execute(ctx, []{ ... });
+     *                       JobSystem::Dispatch(ctx, count, 64, [](JobArgs a){ ... });
+     *  - Join:              JobSystem::Wait(ctx);
+     *
+     * If Init() was never called (or zero workers were requested) every job runs
+     * inline on the calling thread, so code using the job system stays valid in
+     * tools and tests that do not want threads.
+     */
+    class JobSystem {
+    public:
+        using Job = std::function<void()>;
+        using DispatchJob = std::function<void(JobArgs)>;
+
+        /**
+         * @brief Spawns the worker threads. Safe to call more than once.
+         * @param workerCount Number of workers; 0 picks hardware_concurrency() - 1.
+         */
+        static void Init(uint32_t workerCount = 0);
+
+        /**
+         * @brief Drains the queue and joins all workers. Safe to call more than once.
+         */
+        static void Shutdown();
+
+        /** @brief Returns true between Init() and Shutdown(). */
+        static bool IsInitialized();
+
+        /** @brief Number of worker threads (not counting the calling thread). */
+        static uint32_t GetWorkerCount();
+
+        /**
+         * @brief Upper bound for GetThreadIndex() + 1. Use it to size per-thread storage.
+         */
+        static uint32_t GetMaxThreadCount();
+
+        /**
+         * @brief Index of the calling thread: 0 for any non-worker thread,
+         *        1..GetWorkerCount() for workers.
+         */
+        static uint32_t GetThreadIndex();
+
+        /**
+         * @brief Queues a single job.
+         */
+        static void Execute(JobContext& ctx, Job job);
+
+        /**
+         * @brief Splits jobCount jobs into groups of groupSize and queues one task per group.
+         */
+        static void Dispatch(JobContext& ctx, uint32_t jobCount, uint32_t groupSize, const DispatchJob& job);
+
+        /** @brief Returns true while jobs of this context are still pending. */
+        static bool IsBusy(const JobContext& ctx);
+
+        /**
+         * @brief Blocks until every job of the context has finished. The calling
+         *        thread executes queued jobs while it waits.
+         */
+        static void Wait(const JobContext& ctx);
+
+    private:
+        static bool RunOneJob();
+        static void WorkerLoop(uint32_t threadIndex);
+    };
+
+} // namespace Threading
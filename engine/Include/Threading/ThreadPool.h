@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threading {
+
+    /**
+     * @class ThreadPool
+     * @brief A small pool of threads for blocking work (file reads, sockets) that
+     *        would otherwise stall JobSystem workers. Tasks run in FIFO order.
+     *
+     * Unlike the JobSystem it is an object: each subsystem that blocks owns its
+     * own pool, sized for how much it blocks rather than for the core count.
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        explicit ThreadPool(uint32_t threadCount);
+
+        /** @brief Runs every task still queued, then joins the threads. */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void Submit(Task task);
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Threads.size()); }
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_Threads;
+        std::deque<Task>         m_Tasks;
+        std::mutex               m_Mutex;
+        std::condition_variable  m_WakeCondition;
+        bool                     m_Running = true;
+    };
+
+} // namespace Threading
@@ -2,11 +2,24 @@
 #define PROFILING_H
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 #include <spdlog/spdlog.h>
 
+/**
+ * @struct ProfileEvent
+ * @brief A completed, named time span recorded during the current frame.
+ */
+struct ProfileEvent {
+    std::string name;        // Scope name, e.g. "ECS::Movement"
+    uint32_t    threadIndex; // Threading::JobSystem thread index that ran the scope
+    double      startMs;     // Start offset relative to Profiling::StartFrame()
+    double      durationMs;  // Length of the span
+};
+
 /**
  * @class Profiling
  * @brief A singleton utility class for basic frame timing (FPS),
@@ -21,9 +34,20 @@
  *      Profiling::EndTimer("Physics");
  *  - Query MemoryManager stats:
  *      Profiling::LogMemoryUsage();
+ *  - Record spans from any thread (kept until the next StartFrame, at most
+ *    kMaxFrameEvents of them; later ones are only counted):
+ *      { ProfileScope scope("Culling"); ... }
+ *  - Publish named values:
+ *      Profiling::SetCounter("ECS.CriticalPathMs", ms);
  */
 class Profiling {
 public:
+    /**
+     * @brief Events kept per frame. Code that never calls StartFrame() (tools,
+     *        benchmarks, libraries used outside Application) stays bounded.
+     */
+    static constexpr size_t kMaxFrameEvents = 65536;
+
     /**
      * @brief Get the singleton instance of the Profiling system.
      * @return A reference to the single Profiling object.
@@ -60,6 +84,54 @@ public:
      */
     static void LogMemoryUsage();
 
+    /**
+     * @brief Records a completed span as a frame event. Thread-safe.
+     * @param name  The scope name.
+     * @param start When the span began.
+     * @param end   When the span finished.
+     */
+    static void RecordEvent(const std::string& name,
+        std::chrono::high_resolution_clock::time_point start,
+        std::chrono::high_resolution_clock::time_point end);
+
+    /**
+     * @brief Returns a copy of the events recorded since the last StartFrame().
+     */
+    static std::vector<ProfileEvent> GetFrameEvents();
+
+    /**
+     * @brief Events dropped since the last StartFrame() because the frame already
+     *        held kMaxFrameEvents (also the "Profiling.DroppedEvents" counter).
+     */
+    static uint64_t GetDroppedEvents();
+
+    /**
+     * @brief Writes events as a Chrome trace (chrome://tracing, Perfetto), one
+     *        track per thread index.
+     * @return False if the file cannot be written.
+     */
+    static bool ExportTrace(const std::string& path, const std::vector<ProfileEvent>& events);
+
+    /**
+     * @brief Sets a named counter (frame stats, cache hit rates, ...). Thread-safe.
+     */
+    static void SetCounter(const std::string& name, double value);
+
+    /**
+     * @brief Adds delta to a named counter, creating it at zero if needed. Thread-safe.
+     */
+    static void AddCounter(const std::string& name, double delta);
+
+    /**
+     * @brief Returns the value of a named counter, or 0 if it was never set.
+     */
+    static double GetCounter(const std::string& name);
+
+    /**
+     * @brief Returns a copy of every counter.
+     */
+    static std::unordered_map<std::string, double> GetCounters();
+
 private:
     // Private constructor & destructor ensure singleton usage
     Profiling() = default;
@@ -74,6 +146,7 @@ private:
     using TimePoint = std::chrono::time_point<HighResClock>;
     using Duration = std::chrono::duration<double>;
     using TimerMap = std::unordered_map<std::string, TimePoint>;
+    using CounterMap = std::unordered_map<std::string, double>;
 
     // ------------------- STATIC MEMBERS -------------------
 
@@ -98,10 +171,49 @@ private:
      */
     static TimerMap       s_Timers;
 
+    /**
+     * @brief Spans recorded through RecordEvent() since the last StartFrame().
+     */
+    static std::vector<ProfileEvent> s_FrameEvents;
+
+    /**
+     * @brief RecordEvent() calls past kMaxFrameEvents since the last StartFrame().
+     */
+    static uint64_t       s_DroppedEvents;
+
+    /**
+     * @brief Named counters published through SetCounter()/AddCounter().
+     */
+    static CounterMap     s_Counters;
+
     /**
      * @brief A mutex to guard shared data (s_Timers) in multi-threaded scenarios.
      */
     static std::mutex     s_Mutex;
 };
 
+/**
+ * @class ProfileScope
+ * @brief RAII helper that records a Profiling event covering its lifetime.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : m_Name(name)
+        , m_Start(std::chrono::high_resolution_clock::now())
+    {
+    }
+
+    ~ProfileScope() {
+        Profiling::RecordEvent(m_Name, m_Start, std::chrono::high_resolution_clock::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    std::chrono::high_resolution_clock::time_point m_Start;
+};
+
 #endif // PROFILING_H
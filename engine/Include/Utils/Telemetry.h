@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Utils/Profiling.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * Telemetry stream, as sent by TelemetryServer and saved by the
+ * TelemetryRecorder tool (a capture is the stream verbatim):
+ *
+ *   "ETLM", u8 version
+ *   then messages: u8 type, varint payload size, payload
+ *
+ *   String (1): varint id, name bytes
+ *   Frame  (2): varint index, f64 frame ms,
+ *               varint event count,   per event:   varint name id, varint thread, zigzag varint start ns, varint duration ns
+ *               varint counter count, per counter: varint name id, f64 value
+ *
+ * Varints are LEB128; floats are little-endian. Names are sent once per
+ * connection, before the first frame using them. Unknown message types are
+ * skipped, so newer servers can add some.
+ */
+
+constexpr uint8_t kTelemetryVersion = 1;
+
+/**
+ * @struct TelemetryFrame
+ * @brief What one frame publishes: its profiler events and every counter.
+ */
+struct TelemetryFrame {
+    uint64_t                                    index = 0;
+    double                                      frameMs = 0.0;
+    std::vector<ProfileEvent>                   events;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+/**
+ * @class TelemetryServer
+ * @brief Streams frames to any number of local viewers and recorders while
+ *        the process runs.
+ *
+ * Endpoints are "unix:<socket path>" or "tcp:<port>"; TCP listens on the
+ * loopback address only, and port 0 picks a free one (see GetEndpoint()).
+ * An existing file at a Unix socket path is replaced only if it is a socket
+ * nothing listens on.
+ *
+ * Publish() only queues the frame: a thread of the server accepts
+ * connections, encodes and sends. Nothing waits on a viewer. A viewer too
+ * slow to keep up misses whole frames, as does everyone when the queue is
+ * full; both are counted in GetDroppedFrames(). Without viewers, publishing
+ * costs nothing.
+ *
+ * Sockets are POSIX only; elsewhere Start() fails.
+ */
+class TelemetryServer {
+public:
+    TelemetryServer() = default;
+
+    /** @brief Stops the server. */
+    ~TelemetryServer();
+
+    TelemetryServer(const TelemetryServer&) = delete;
+    TelemetryServer& operator=(const TelemetryServer&) = delete;
+
+    /** @return False if the endpoint is malformed or cannot be listened on. */
+    bool Start(const std::string& endpoint);
+
+    /** @brief Sends what is queued (waiting briefly on slow viewers), then disconnects them. */
+    void Stop();
+
+    bool IsRunning() const { return m_Thread.joinable(); }
+
+    /** @brief The endpoint listened on, with the port picked for "tcp:0". */
+    const std::string& GetEndpoint() const { return m_Endpoint; }
+
+    uint32_t GetClientCount() const { return m_ClientCount.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedFrames() const { return m_DroppedFrames.load(std::memory_order_relaxed); }
+
+    /** @brief Numbers the frame after the previous one and queues it for every connected viewer. Thread-safe. */
+    void Publish(TelemetryFrame frame);
+
+    /**
+     * @brief Publishes the Profiling events since the last StartFrame(), every
+     *        Profiling counter and the MemoryManager totals as the next frame.
+     */
+    void PublishProfilingFrame(double frameMs);
+
+private:
+    struct Client {
+        int                  socket = -1;
+        std::vector<uint8_t> outbox;            // Encoded bytes not sent yet, from sent onwards
+        size_t               sent = 0;
+        uint32_t             namesSent = 0;     // Interned names this client knows
+    };
+
+    void ThreadMain();
+    void Accept();
+    void Send(const std::vector<TelemetryFrame>& frames);
+    bool Flush(Client& client);                 // False once the client is gone
+    void Disconnect(Client& client);
+
+    std::string                     m_Endpoint;
+    std::string                     m_SocketPath;   // Unix socket to remove on Stop()
+    int                             m_Listener = -1;
+    int                             m_Wake[2] = { -1, -1 };  // Pipe waking the thread
+    std::thread                     m_Thread;
+
+    std::mutex                      m_QueueMutex;
+    std::deque<TelemetryFrame>      m_Queue;
+    bool                            m_Stopping = false;
+    uint64_t                        m_NextFrame = 0;
+
+    std::atomic<uint32_t>           m_ClientCount{ 0 };
+    std::atomic<uint64_t>           m_DroppedFrames{ 0 };
+
+    // ------ SERVER THREAD ------
+    std::vector<Client>             m_Clients;
+    std::vector<std::string>        m_Names;        // Interned, by id
+    std::unordered_map<std::string, uint32_t> m_NameIds;
+};
+
+/**
+ * @class TelemetryDecoder
+ * @brief Turns a telemetry stream back into frames, from chunks of any size.
+ */
+class TelemetryDecoder {
+public:
+    /**
+     * @brief Decodes every frame completed by these bytes.
+     * @return False once the stream is malformed; nothing more is decoded.
+     */
+    bool Feed(const void* data, size_t size, const std::function<void(const TelemetryFrame&)>& onFrame);
+
+private:
+    std::vector<uint8_t>     m_Pending;     // Bytes of an incomplete message
+    std::vector<std::string> m_Names;
+    bool                     m_HeaderRead = false;
+    bool                     m_Broken = false;
+};
+
+/**
+ * @class TelemetryClient
+ * @brief Connection to a TelemetryServer endpoint.
+ */
+class TelemetryClient {
+public:
+    TelemetryClient() = default;
+    ~TelemetryClient() { Close(); }
+
+    TelemetryClient(const TelemetryClient&) = delete;
+    TelemetryClient& operator=(const TelemetryClient&) = delete;
+
+    bool Connect(const std::string& endpoint);
+    void Close();
+
+    /**
+     * @brief Appends whatever arrives within timeoutMs to bytes.
+     * @return False once the server has closed the connection.
+     */
+    bool Receive(std::vector<uint8_t>& bytes, int timeoutMs);
+
+private:
+    int m_Socket = -1;
+};
@@ -1,14 +1,20 @@
 #include "Core/Application.h"
 #include "Core/Input.h"       // If you need input in your loop
 #include "Utils/Logger.h"     // For logging macros
+#include "Memory/MemoryManager.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <chrono>
 
 namespace Core {
 
 	void* g_WindowHandle = nullptr; // Global pointer to the active GLFW window
 
     // Constructor
-    Application::Application()
-        : m_Window(nullptr)
+    Application::Application(const ApplicationSettings& settings)
+        : m_Settings(settings)
+        , m_Window(nullptr)
     {
     }
 
@@ -19,44 +25,123 @@ namespace Core {
     }
 
     bool Application::Init() {
-        // Optional: Initialize your logger system if you haven't done so already:
-        // Logger::Init();
-
-        m_Window = new Window("My GLFW Window", 1280, 720);
-        if (!m_Window->Init()) {
-            LOG_ENGINE_ERROR("Failed to initialize the Window!");
-            return false;
-        }
+        m_InitStart = std::chrono::steady_clock::now();
+        m_Startup = StartupGraph();
 
-        LOG_ENGINE_INFO("Window initialized successfully!");
+        // Everything logs, so everything waits for the logger
+        m_Startup.Add("Logger", {}, [] {
+            Logger::Init();
+            return true;
+        });
+        m_Startup.Add("Memory", { "Logger" }, [] {
+            MemoryManager::GetInstance();
+            return true;
+        });
+        // Workers for the system scheduler (and anything else that dispatches jobs)
+        m_Startup.Add("JobSystem", { "Logger", "Memory" }, [this] {
+            Threading::JobSystem::Init(m_Settings.workerCount);
+            return true;
+        });
+        m_Startup.Add("FileSystem", { "Logger", "Memory" }, [this] {
+            m_FileSystem = std::make_unique<IO::FileSystem>();
+            m_FileSystem->SetLooseRoot(m_Settings.looseRoot);
+            if (!m_Settings.contentArchive.empty() && !m_FileSystem->Mount(m_Settings.contentArchive)) {
+                LOG_ENGINE_ERROR("Failed to mount '{}'!", m_Settings.contentArchive);
+                return false;
+            }
+            return true;
+        });
+        m_Startup.Add("AssetManifest", { "Logger" }, [this] {
+            return m_Settings.manifestDirectory.empty() || m_Manifest.Load(m_Settings.manifestDirectory);
+        });
+        // Optional: a server that cannot listen logs why, and the engine runs without it
+        m_Startup.Add("Telemetry", { "Logger" }, [this] {
+            if (m_Settings.telemetryEndpoint.empty())
+                return true;
+            m_Telemetry = std::make_unique<TelemetryServer>();
+            if (!m_Telemetry->Start(m_Settings.telemetryEndpoint))
+                m_Telemetry.reset();
+            return true;
+        });
+        // GLFW only works from the main thread
+        m_Startup.Add("Window", { "Logger" }, [this] {
+            if (m_Settings.headless)
+                return true;
+            m_Window = new Window(m_Settings.title, m_Settings.width, m_Settings.height);
+            if (!m_Window->Init()) {
+                LOG_ENGINE_ERROR("Failed to initialize the Window!");
+                return false;
+            }
+            LOG_ENGINE_INFO("Window initialized successfully!");
+            return true;
+        }, true);
 
-        return true;
+        const bool succeeded = m_Startup.Run(m_Settings.startupThreads);
+        for (const StartupStep& step : m_Startup.GetSteps()) {
+            if (step.skipped)
+                LOG_ENGINE_WARN("[Startup] {} skipped: a dependency failed.", step.name);
+        }
+        LOG_ENGINE_INFO("[Startup] {} steps in {:.2f} ms (critical path {:.2f} ms).", m_Startup.GetSteps().size(),
+                        m_Startup.GetTotalMs(), m_Startup.GetCriticalPathMs());
+        if (!m_Settings.startupTracePath.empty() && !m_Startup.ExportTrace(m_Settings.startupTracePath))
+            LOG_ENGINE_WARN("[Startup] Cannot write trace '{}'.", m_Settings.startupTracePath);
+        return succeeded;
     }
 
     void Application::Run() {
+        auto lastTime = std::chrono::steady_clock::now();
+        uint64_t frame = 0;
+
         // Main game/engine loop
-        while (!m_Window->ShouldClose()) {
-            // 1) Poll window events
-            m_Window->PollEvents();
+        while (!m_StopRequested && (m_Settings.maxFrames == 0 || frame < m_Settings.maxFrames) &&
+               !(m_Window && m_Window->ShouldClose())) {
+            // Scheduler events are kept per frame
+            Profiling::StartFrame();
 
-            // 2) Update input states
-            Input::Update();
+            // 1) Poll window events and 2) update input states; headless there are none
+            if (m_Window) {
+                m_Window->PollEvents();
+                Input::Update();
+            }
 
             // 3) Update your game logic
-            // ...
+            auto now = std::chrono::steady_clock::now();
+            const std::chrono::duration<float> deltaTime = now - lastTime;
+            Update(deltaTime.count());
+            lastTime = now;
 
             // 4) Render
             // ...
+
+            // 5) Stream this frame's events and counters to any connected viewer
+            if (m_Telemetry)
+                m_Telemetry->PublishProfilingFrame(deltaTime.count() * 1000.0);
+
+            if (frame++ == 0) {
+                Profiling::SetCounter("Startup.TimeToFirstFrameMs",
+                                      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_InitStart).count());
+            }
         }
+        m_StopRequested = false;
+    }
+
+    void Application::Update(float deltaTime) {
+        // Runs non-conflicting systems (and chunks of chunked systems) in parallel
+        m_Scheduler.Run(m_World, deltaTime);
     }
 
     void Application::Shutdown() {
+        m_Telemetry.reset();
+
         if (m_Window) {
             m_Window->Shutdown();
             delete m_Window;
             m_Window = nullptr;
             LOG_ENGINE_INFO("Window shut down successfully!");
         }
+
+        m_FileSystem.reset();
+        Threading::JobSystem::Shutdown();
     }
 
 } // namespace Core
@@ -1,6 +1,9 @@
 #include "Core/Input.h"
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace Core {
 
     // Define static data
@@ -65,4 +68,20 @@ namespace Core {
         return s_MouseY;
     }
 
+    InputState Input::GetState() {
+        InputState state;
+        std::copy(std::begin(s_KeysDown), std::end(s_KeysDown), state.keysDown);
+        std::copy(std::begin(s_MouseButtons), std::end(s_MouseButtons), state.mouseButtons);
+        state.mouseX = s_MouseX;
+        state.mouseY = s_MouseY;
+        return state;
+    }
+
+    void Input::SetState(const InputState& state) {
+        std::copy(std::begin(state.keysDown), std::end(state.keysDown), s_KeysDown);
+        std::copy(std::begin(state.mouseButtons), std::end(state.mouseButtons), s_MouseButtons);
+        s_MouseX = state.mouseX;
+        s_MouseY = state.mouseY;
+    }
+
 } // namespace Core
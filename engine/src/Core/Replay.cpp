@@ -0,0 +1,448 @@
+#include "Core/Replay.h"
+#include "Core/Application.h"
+#include "IO/Archive.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace Core {
+
+    namespace {
+
+        constexpr const char* kReplayHeader = "# replay (version 1)";
+        constexpr float       kPlayerAcceleration = 12.0f;  // m/s^2 while a direction key is held
+        constexpr float       kPlayerJumpSpeed = 5.0f;
+        constexpr uint32_t    kChunkSize = 64;
+
+        // ECS side of a replayed body
+        struct ReplayBody {
+            Physics::BodyId id;
+        };
+
+        struct ReplayPose {
+            Math::Vec3 position;
+            Math::Quat rotation;
+        };
+
+        struct ReplayBounds {
+            Math::AABB box;
+        };
+
+        // Small and fully specified, so scenes are the same with every standard library
+        class Random {
+        public:
+            explicit Random(uint32_t seed) : m_State(seed * 747796405u + 2891336453u) {}
+
+            float Next(float min, float max) {
+                m_State ^= m_State << 13;
+                m_State ^= m_State >> 17;
+                m_State ^= m_State << 5;
+                return min + (max - min) * float(m_State >> 8) * (1.0f / 16777216.0f);
+            }
+
+        private:
+            uint32_t m_State;
+        };
+
+        const char* ShapeName(Physics::ShapeType type) {
+            switch (type) {
+                case Physics::ShapeType::Sphere:  return "sphere";
+                case Physics::ShapeType::Capsule: return "capsule";
+                case Physics::ShapeType::Box:     return "box";
+                default:                          return nullptr;
+            }
+        }
+
+        uint32_t KeyBits(const InputState& state) {
+            uint32_t bits = 0;
+            for (int key = 0; key < (int)KeyCode::MAX_KEYS; ++key)
+                bits |= uint32_t(state.keysDown[key]) << key;
+            return bits;
+        }
+
+        uint32_t ButtonBits(const InputState& state) {
+            uint32_t bits = 0;
+            for (int button = 0; button < 5; ++button)
+                bits |= uint32_t(state.mouseButtons[button]) << button;
+            return bits;
+        }
+
+        bool SameInput(const InputState& a, const InputState& b) {
+            return KeyBits(a) == KeyBits(b) && ButtonBits(a) == ButtonBits(b) && a.mouseX == b.mouseX && a.mouseY == b.mouseY;
+        }
+
+        std::ostream& operator<<(std::ostream& out, const Math::Vec3& v) {
+            return out << v.x << '\t' << v.y << '\t' << v.z;
+        }
+
+        std::istream& operator>>(std::istream& in, Math::Vec3& v) {
+            return in >> v.x >> v.y >> v.z;
+        }
+
+        // Nearest rank, of sorted samples
+        double Percentile(const std::vector<double>& sorted, double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+        }
+
+        ScopeTiming Summarize(std::string name, std::vector<double> samples) {
+            std::sort(samples.begin(), samples.end());
+            ScopeTiming timing;
+            timing.name = std::move(name);
+            timing.frames = static_cast<uint32_t>(samples.size());
+            timing.p50Ms = Percentile(samples, 0.50);
+            timing.p90Ms = Percentile(samples, 0.90);
+            timing.p99Ms = Percentile(samples, 0.99);
+            timing.maxMs = samples.back();
+            for (double sample : samples)
+                timing.totalMs += sample;
+            return timing;
+        }
+
+        // Bit patterns of everything simulated, in body order
+        uint64_t Checksum(const Physics::PhysicsWorld& physics, ECS::World& world) {
+            uint64_t hash = IO::HashBytes(nullptr, 0);
+            auto mix = [&hash](const auto& value) { hash = IO::HashBytes(&value, sizeof(value), hash); };
+            for (Physics::BodyId body = 0; body < physics.GetBodyCount(); ++body) {
+                mix(physics.GetPosition(body));
+                mix(physics.GetRotation(body));
+                mix(physics.GetLinearVelocity(body));
+                mix(physics.GetAngularVelocity(body));
+            }
+            const ECS::ComponentPool<ReplayPose>& poses = world.GetPool<ReplayPose>();
+            const ECS::ComponentPool<ReplayBounds>& bounds = world.GetPool<ReplayBounds>();
+            for (uint32_t i = 0; i < poses.Size(); ++i) {
+                mix(poses.At(i).position);
+                mix(poses.At(i).rotation);
+                mix(bounds.At(i).box.min);
+                mix(bounds.At(i).box.max);
+            }
+            return hash;
+        }
+
+    } // namespace
+
+    // ----------------------------------------------------------
+    // FILES
+    // ----------------------------------------------------------
+
+    bool SaveReplay(const std::string& path, const Replay& replay) {
+        std::ostringstream out;
+        // Nine significant digits read back to the same float
+        out << std::setprecision(9) << kReplayHeader << '\n';
+        out << "deltaTime\t" << replay.deltaTime << '\n';
+        const Physics::WorldSettings& settings = replay.scene.physics;
+        out << "physics\t" << settings.gravity << '\t' << settings.velocityIterations << '\t' << settings.baumgarte << '\t'
+            << settings.linearSlop << '\t' << settings.maxCorrectionVelocity << '\t' << settings.restitutionThreshold << '\t'
+            << settings.sleepLinearVelocity << '\t' << settings.sleepAngularVelocity << '\t' << settings.timeToSleep << '\t'
+            << int(settings.broadphase) << '\n';
+        for (const Physics::BodyDesc& body : replay.scene.bodies) {
+            const char* shape = ShapeName(body.shape.type);
+            if (!shape) {
+                LOG_ENGINE_ERROR("[Replay] Cannot save '{}': convex hull bodies are not supported.", path);
+                return false;
+            }
+            const Math::Quat& q = body.rotation;
+            out << "body\t" << (body.type == Physics::BodyType::Static ? "static" : "dynamic") << '\t' << shape << '\t'
+                << body.shape.radius << '\t' << body.shape.halfHeight << '\t' << body.shape.halfExtents << '\t' << body.position << '\t'
+                << q.x << '\t' << q.y << '\t' << q.z << '\t' << q.w << '\t' << body.linearVelocity << '\t' << body.angularVelocity << '\t'
+                << body.mass << '\t' << body.friction << '\t' << body.restitution << '\t' << body.linearDamping << '\t'
+                << body.angularDamping << '\t' << int(body.allowSleep) << '\n';
+        }
+        if (replay.scene.player != Physics::InvalidBody)
+            out << "player\t" << replay.scene.player << '\n';
+        out << "frames\t" << replay.input.size() << '\n';
+        for (size_t frame = 0; frame < replay.input.size(); ++frame) {
+            const InputState& state = replay.input[frame];
+            if (frame > 0 && SameInput(state, replay.input[frame - 1]))
+                continue;
+            out << "input\t" << frame << '\t' << KeyBits(state) << '\t' << ButtonBits(state) << '\t' << state.mouseX << '\t'
+                << state.mouseY << '\n';
+        }
+
+        std::ofstream file(path, std::ios::trunc);
+        const std::string text = out.str();
+        if (!file.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+            LOG_ENGINE_ERROR("[Replay] Cannot write '{}'.", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool LoadReplay(const std::string& path, Replay& replay) {
+        std::ifstream file(path);
+        std::string line;
+        if (!std::getline(file, line) || line != kReplayHeader) {
+            LOG_ENGINE_ERROR("[Replay] '{}' is not a replay.", path);
+            return false;
+        }
+
+        replay = Replay();
+        std::vector<bool> recorded;     // Frames with an input line; the others repeat the frame before
+        uint32_t lineNumber = 1;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            std::istringstream in(line);
+            std::string kind;
+            in >> kind;
+            if (kind == "deltaTime") {
+                in >> replay.deltaTime;
+            } else if (kind == "physics") {
+                Physics::WorldSettings& settings = replay.scene.physics;
+                int broadphase = 0;
+                in >> settings.gravity >> settings.velocityIterations >> settings.baumgarte >> settings.linearSlop
+                   >> settings.maxCorrectionVelocity >> settings.restitutionThreshold >> settings.sleepLinearVelocity
+                   >> settings.sleepAngularVelocity >> settings.timeToSleep >> broadphase;
+                settings.broadphase = static_cast<Physics::BroadphaseType>(broadphase);
+            } else if (kind == "body") {
+                Physics::BodyDesc body;
+                std::string type, shape;
+                int allowSleep = 1;
+                in >> type >> shape >> body.shape.radius >> body.shape.halfHeight >> body.shape.halfExtents >> body.position
+                   >> body.rotation.x >> body.rotation.y >> body.rotation.z >> body.rotation.w >> body.linearVelocity
+                   >> body.angularVelocity >> body.mass >> body.friction >> body.restitution >> body.linearDamping
+                   >> body.angularDamping >> allowSleep;
+                body.type = type == "static" ? Physics::BodyType::Static : Physics::BodyType::Dynamic;
+                body.shape.type = shape == "capsule" ? Physics::ShapeType::Capsule
+                                : shape == "box"     ? Physics::ShapeType::Box
+                                                     : Physics::ShapeType::Sphere;
+                body.allowSleep = allowSleep != 0;
+                if (!in || (shape != "sphere" && shape != "capsule" && shape != "box"))
+                    in.setstate(std::ios::failbit);
+                replay.scene.bodies.push_back(body);
+            } else if (kind == "player") {
+                in >> replay.scene.player;
+            } else if (kind == "frames") {
+                size_t frames = 0;
+                in >> frames;
+                replay.input.assign(frames, InputState());
+                recorded.assign(frames, false);
+            } else if (kind == "input") {
+                size_t frame = 0;
+                uint32_t keys = 0, buttons = 0;
+                InputState state;
+                in >> frame >> keys >> buttons >> state.mouseX >> state.mouseY;
+                for (int key = 0; key < (int)KeyCode::MAX_KEYS; ++key)
+                    state.keysDown[key] = (keys >> key) & 1;
+                for (int button = 0; button < 5; ++button)
+                    state.mouseButtons[button] = (buttons >> button) & 1;
+                if (frame >= replay.input.size())
+                    in.setstate(std::ios::failbit);
+                else {
+                    replay.input[frame] = state;
+                    recorded[frame] = true;
+                }
+            } else if (!kind.empty() && kind[0] != '#') {
+                in.setstate(std::ios::failbit);
+            }
+            if (in.fail()) {
+                LOG_ENGINE_ERROR("[Replay] '{}' line {} is malformed.", path, lineNumber);
+                return false;
+            }
+        }
+        for (size_t frame = 1; frame < replay.input.size(); ++frame) {
+            if (!recorded[frame])
+                replay.input[frame] = replay.input[frame - 1];
+        }
+        if (replay.scene.player != Physics::InvalidBody && replay.scene.player >= replay.scene.bodies.size()) {
+            LOG_ENGINE_ERROR("[Replay] '{}' names player body {} of {}.", path, replay.scene.player, replay.scene.bodies.size());
+            return false;
+        }
+        return true;
+    }
+
+    Replay MakeBenchmarkReplay(uint32_t bodyCount, uint32_t frameCount, uint32_t seed) {
+        Replay replay;
+        Random random(seed);
+        std::vector<Physics::BodyDesc>& bodies = replay.scene.bodies;
+
+        Physics::BodyDesc ground;
+        ground.type = Physics::BodyType::Static;
+        ground.shape = Physics::CollisionShape::Box({ 40.0f, 1.0f, 40.0f });
+        ground.position = { 0.0f, -1.0f, 0.0f };
+        bodies.push_back(ground);
+
+        Physics::BodyDesc player;
+        player.shape = Physics::CollisionShape::Sphere(0.6f);
+        player.position = { 0.0f, 0.6f, 0.0f };
+        player.mass = 5.0f;
+        player.allowSleep = false;
+        replay.scene.player = static_cast<Physics::BodyId>(bodies.size());
+        bodies.push_back(player);
+
+        // Half the rest stand in stacks of five, half rain down on them
+        const uint32_t rest = bodyCount > 2 ? bodyCount - 2 : 0;
+        const uint32_t stacked = rest / 2 / 5 * 5;
+        for (uint32_t i = 0; i < stacked; ++i) {
+            const uint32_t stack = i / 5;
+            Physics::BodyDesc box;
+            box.shape = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+            box.position = { float(stack % 12) * 3.0f - 16.5f, 0.5f + float(i % 5) * 1.0f, float(stack / 12) * 3.0f - 16.5f };
+            bodies.push_back(box);
+        }
+        for (uint32_t i = stacked; i < rest; ++i) {
+            Physics::BodyDesc body;
+            const float kind = random.Next(0.0f, 3.0f);
+            body.shape = kind < 1.0f ? Physics::CollisionShape::Sphere(random.Next(0.3f, 0.7f))
+                       : kind < 2.0f ? Physics::CollisionShape::Capsule(random.Next(0.2f, 0.4f), random.Next(0.2f, 0.5f))
+                                     : Physics::CollisionShape::Box({ random.Next(0.2f, 0.6f), random.Next(0.2f, 0.6f), random.Next(0.2f, 0.6f) });
+            body.position = { random.Next(-18.0f, 18.0f), random.Next(4.0f, 30.0f), random.Next(-18.0f, 18.0f) };
+            body.rotation = Math::Quat::FromAxisAngle(Math::Normalize(Math::Vec3(random.Next(-1.0f, 1.0f), 1.0f, random.Next(-1.0f, 1.0f))),
+                                                      random.Next(0.0f, 3.14159265f));
+            body.linearVelocity = { random.Next(-2.0f, 2.0f), 0.0f, random.Next(-2.0f, 2.0f) };
+            body.restitution = random.Next(0.0f, 0.4f);
+            bodies.push_back(body);
+        }
+
+        // The player circles through the scene, jumping now and then
+        const KeyCode directions[] = { KeyCode::W, KeyCode::D, KeyCode::S, KeyCode::A };
+        replay.input.resize(frameCount);
+        for (uint32_t frame = 0; frame < frameCount; ++frame) {
+            InputState& state = replay.input[frame];
+            state.keysDown[(int)directions[(frame / 90) % 4]] = true;
+            state.keysDown[(int)KeyCode::SPACE] = frame % 120 == 60;
+            state.mouseX = float(frame % 640);
+            state.mouseY = 360.0f;
+        }
+        return replay;
+    }
+
+    // ----------------------------------------------------------
+    // RUNNING
+    // ----------------------------------------------------------
+
+    ReplayReport RunReplay(const Replay& replay, const ReplayOptions& options) {
+        ReplayReport report;
+        ApplicationSettings settings;
+        settings.headless = true;
+        settings.workerCount = options.workerCount;
+        Application app(settings);
+        if (!app.Init()) {
+            LOG_ENGINE_ERROR("[Replay] The application did not start.");
+            return report;
+        }
+        report.workerCount = Threading::JobSystem::GetWorkerCount();
+
+        Physics::PhysicsWorld physics(replay.scene.physics);
+        ECS::World& world = app.GetWorld();
+        for (const Physics::BodyDesc& desc : replay.scene.bodies) {
+            const ECS::Entity entity = world.CreateEntity();
+            world.AddComponent(entity, ReplayBody{ physics.CreateBody(desc) });
+            world.AddComponent(entity, ReplayPose{});
+            world.AddComponent(entity, ReplayBounds{});
+        }
+
+        // The physics world belongs to whoever writes ReplayBody
+        ECS::SystemScheduler& scheduler = app.GetScheduler();
+        const Physics::BodyId player = replay.scene.player;
+        bool jumpHeld = false;
+        if (player != Physics::InvalidBody) {
+            scheduler.AddSystem("Replay::Player", ECS::SystemAccess().Write<ReplayBody>(), [&](const ECS::SystemContext& ctx) {
+                const float mass = replay.scene.bodies[player].mass;
+                Math::Vec3 impulse{ float(Input::IsKeyDown(KeyCode::D)) - float(Input::IsKeyDown(KeyCode::A)), 0.0f,
+                                    float(Input::IsKeyDown(KeyCode::S)) - float(Input::IsKeyDown(KeyCode::W)) };
+                impulse = impulse * (kPlayerAcceleration * mass * ctx.deltaTime);
+                const bool jump = Input::IsKeyDown(KeyCode::SPACE);
+                if (jump && !jumpHeld)
+                    impulse.y += kPlayerJumpSpeed * mass;
+                jumpHeld = jump;
+                if (impulse.x != 0.0f || impulse.y != 0.0f || impulse.z != 0.0f)
+                    physics.ApplyLinearImpulse(player, impulse, physics.GetPosition(player));
+            });
+        }
+        scheduler.AddSystem("Replay::Physics", ECS::SystemAccess().Write<ReplayBody>(), [&](const ECS::SystemContext& ctx) {
+            physics.Step(ctx.deltaTime);
+        });
+        auto bodyCount = [](ECS::World& w) { return w.GetPool<ReplayBody>().Size(); };
+        scheduler.AddChunkedSystem("Replay::Poses", ECS::SystemAccess().Read<ReplayBody>().Write<ReplayPose>(), bodyCount, kChunkSize,
+                                   [&](const ECS::SystemContext& ctx) {
+            ECS::ComponentPool<ReplayBody>& bodies = ctx.world.GetPool<ReplayBody>();
+            ECS::ComponentPool<ReplayPose>& poses = ctx.world.GetPool<ReplayPose>();
+            for (uint32_t i = ctx.begin; i < ctx.end; ++i) {
+                const Physics::BodyId id = bodies.At(i).id;
+                poses.Get(bodies.EntityAt(i)) = { physics.GetPosition(id), physics.GetRotation(id) };
+            }
+        });
+        scheduler.AddChunkedSystem("Replay::Bounds", ECS::SystemAccess().Read<ReplayBody>().Read<ReplayPose>().Write<ReplayBounds>(),
+                                   bodyCount, kChunkSize, [&](const ECS::SystemContext& ctx) {
+            ECS::ComponentPool<ReplayBody>& bodies = ctx.world.GetPool<ReplayBody>();
+            ECS::ComponentPool<ReplayPose>& poses = ctx.world.GetPool<ReplayPose>();
+            ECS::ComponentPool<ReplayBounds>& bounds = ctx.world.GetPool<ReplayBounds>();
+            for (uint32_t i = ctx.begin; i < ctx.end; ++i) {
+                const ECS::Entity entity = bodies.EntityAt(i);
+                const ReplayPose& pose = poses.Get(entity);
+                bounds.Get(entity).box = physics.GetShape(bodies.At(i).id).ComputeAABB(pose.position, pose.rotation);
+            }
+        });
+
+        using Clock = std::chrono::high_resolution_clock;
+        std::vector<double> frameMs;
+        std::map<std::string, std::vector<double>> scopeMs;
+        std::map<std::string, double> inFrame;
+        report.frames = static_cast<uint32_t>(replay.input.size());
+        report.frameChecksums.reserve(replay.input.size());
+        for (uint32_t frame = 0; frame < report.frames; ++frame) {
+            Input::SetState(replay.input[frame]);
+            Profiling::StartFrame();
+            const Clock::time_point start = Clock::now();
+            app.Update(replay.deltaTime);
+            const Clock::time_point end = Clock::now();
+
+            if (frame >= options.warmupFrames) {
+                frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                inFrame.clear();
+                for (const ProfileEvent& event : Profiling::GetFrameEvents())
+                    inFrame[event.name] += event.durationMs;
+                for (const auto& [name, ms] : inFrame)
+                    scopeMs[name].push_back(ms);
+            }
+            report.frameChecksums.push_back(Checksum(physics, world));
+        }
+        Input::SetState(InputState());
+        app.Shutdown();
+
+        if (!report.frameChecksums.empty())
+            report.checksum = report.frameChecksums.back();
+        if (!frameMs.empty())
+            report.scopes.push_back(Summarize("Frame", std::move(frameMs)));
+        for (auto& [name, samples] : scopeMs)
+            report.scopes.push_back(Summarize(name, std::move(samples)));
+        std::sort(report.scopes.begin() + std::min<size_t>(1, report.scopes.size()), report.scopes.end(),
+                  [](const ScopeTiming& a, const ScopeTiming& b) { return a.totalMs > b.totalMs; });
+        return report;
+    }
+
+    uint32_t FindDivergence(const ReplayReport& a, const ReplayReport& b) {
+        const size_t frames = std::min(a.frameChecksums.size(), b.frameChecksums.size());
+        size_t frame = 0;
+        while (frame < frames && a.frameChecksums[frame] == b.frameChecksums[frame])
+            ++frame;
+        return static_cast<uint32_t>(frame);
+    }
+
+    std::string FormatReplayReport(const ReplayReport& report) {
+        std::string text;
+        char line[256];
+        std::snprintf(line, sizeof(line), "%u frames, %u workers, checksum %016llx\n", report.frames, report.workerCount,
+                      (unsigned long long)report.checksum);
+        text += line;
+        std::snprintf(line, sizeof(line), "%-32s %7s %10s %10s %10s %10s\n", "scope", "frames", "p50 ms", "p90 ms", "p99 ms", "max ms");
+        text += line;
+        for (const ScopeTiming& scope : report.scopes) {
+            std::snprintf(line, sizeof(line), "%-32s %7u %10.3f %10.3f %10.3f %10.3f\n", scope.name.c_str(), scope.frames, scope.p50Ms,
+                          scope.p90Ms, scope.p99Ms, scope.maxMs);
+            text += line;
+        }
+        return text;
+    }
+
+} // namespace Core
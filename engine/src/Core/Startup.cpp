@@ -0,0 +1,139 @@
+#include "Core/Startup.h"
+#include "Threading/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace Core {
+
+    void StartupGraph::Add(std::string name, std::vector<std::string> dependencies, std::function<bool()> run, bool mainThread) {
+        std::vector<uint32_t> indices;
+        for (const std::string& dependency : dependencies) {
+            auto it = std::find_if(m_Steps.begin(), m_Steps.end(), [&](const StartupStep& step) { return step.name == dependency; });
+            assert(it != m_Steps.end() && "startup dependencies must be added first");
+            indices.push_back(static_cast<uint32_t>(it - m_Steps.begin()));
+        }
+        StartupStep step;
+        step.name = std::move(name);
+        step.dependencies = std::move(dependencies);
+        step.run = std::move(run);
+        step.mainThread = mainThread;
+        m_Steps.push_back(std::move(step));
+        m_Dependencies.push_back(std::move(indices));
+    }
+
+    bool StartupGraph::Run(uint32_t helperThreads) {
+        using Clock = std::chrono::high_resolution_clock;
+        const Clock::time_point start = Clock::now();
+        const uint32_t count = static_cast<uint32_t>(m_Steps.size());
+
+        std::vector<uint32_t> remaining(count);
+        std::vector<std::vector<uint32_t>> dependents(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            StartupStep& step = m_Steps[i];
+            step.succeeded = step.skipped = false;
+            remaining[i] = static_cast<uint32_t>(m_Dependencies[i].size());
+            for (uint32_t dependency : m_Dependencies[i])
+                dependents[dependency].push_back(i);
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<uint32_t> ready, readyMain;
+        uint32_t finished = 0;
+        auto push = [&](uint32_t i) { (m_Steps[i].mainThread ? readyMain : ready).push_back(i); };
+        for (uint32_t i = 0; i < count; ++i) {
+            if (remaining[i] == 0)
+                push(i);
+        }
+
+        // Under the lock: releases the dependents of a finished step, and skips those of a failed one
+        auto finish = [&](uint32_t i) {
+            std::vector<uint32_t> stack{ i };
+            while (!stack.empty()) {
+                const uint32_t done = stack.back();
+                stack.pop_back();
+                ++finished;
+                for (uint32_t dependent : dependents[done]) {
+                    m_Steps[dependent].skipped |= !m_Steps[done].succeeded;
+                    if (--remaining[dependent] == 0) {
+                        if (m_Steps[dependent].skipped)
+                            stack.push_back(dependent);
+                        else
+                            push(dependent);
+                    }
+                }
+            }
+        };
+
+        auto work = [&](uint32_t threadIndex) {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&] { return finished == count || !ready.empty() || (threadIndex == 0 && !readyMain.empty()); });
+                std::deque<uint32_t>& queue = threadIndex == 0 && !readyMain.empty() ? readyMain : ready;
+                if (queue.empty())
+                    return;
+                const uint32_t i = queue.front();
+                queue.pop_front();
+                lock.unlock();
+
+                const Clock::time_point stepStart = Clock::now();
+                const bool succeeded = !m_Steps[i].run || m_Steps[i].run();
+                const Clock::time_point stepEnd = Clock::now();
+                Profiling::RecordEvent(m_Steps[i].name, stepStart, stepEnd);
+
+                lock.lock();
+                StartupStep& step = m_Steps[i];
+                step.succeeded = succeeded;
+                step.threadIndex = threadIndex;
+                step.startMs = std::chrono::duration<double, std::milli>(stepStart - start).count();
+                step.durationMs = std::chrono::duration<double, std::milli>(stepEnd - stepStart).count();
+                finish(i);
+                wake.notify_all();
+            }
+        };
+
+        {
+            std::unique_ptr<Threading::ThreadPool> helpers;
+            if (helperThreads > 0) {
+                helpers = std::make_unique<Threading::ThreadPool>(helperThreads);
+                for (uint32_t i = 1; i <= helperThreads; ++i)
+                    helpers->Submit([&work, i] { work(i); });
+            }
+            work(0);
+        }
+
+        m_TotalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        Profiling::SetCounter("Startup.TotalMs", m_TotalMs);
+        Profiling::SetCounter("Startup.CriticalPathMs", GetCriticalPathMs());
+        return std::all_of(m_Steps.begin(), m_Steps.end(), [](const StartupStep& step) { return step.succeeded; });
+    }
+
+    double StartupGraph::GetCriticalPathMs() const {
+        // Steps are in dependency order, since dependencies are added first
+        std::vector<double> finish(m_Steps.size(), 0.0);
+        double longest = 0.0;
+        for (size_t i = 0; i < m_Steps.size(); ++i) {
+            for (uint32_t dependency : m_Dependencies[i])
+                finish[i] = std::max(finish[i], finish[dependency]);
+            finish[i] += m_Steps[i].durationMs;
+            longest = std::max(longest, finish[i]);
+        }
+        return longest;
+    }
+
+    bool StartupGraph::ExportTrace(const std::string& path) const {
+        std::vector<ProfileEvent> events;
+        for (const StartupStep& step : m_Steps) {
+            if (!step.skipped)
+                events.push_back({ step.name, step.threadIndex, step.startMs, step.durationMs });
+        }
+        return Profiling::ExportTrace(path, events);
+    }
+
+} // namespace Core
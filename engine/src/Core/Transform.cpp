@@ -0,0 +1,309 @@
+#include "Core/Transform.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Core {
+
+    // Levels smaller than this are updated inline; splitting them costs more than it saves
+    static constexpr uint32_t kParallelGrain = 1024;
+
+    TransformHandle TransformHierarchy::Create(TransformHandle parent) {
+        TransformHandle handle;
+        if (!m_FreeHandles.empty()) {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+        } else {
+            handle = static_cast<TransformHandle>(m_SlotOf.size());
+            m_SlotOf.push_back(InvalidTransform);
+            m_Parent.push_back(InvalidTransform);
+            m_FirstChild.push_back(InvalidTransform);
+            m_NextSibling.push_back(InvalidTransform);
+            m_PrevSibling.push_back(InvalidTransform);
+            m_Alive.push_back(0);
+        }
+
+        if (parent != InvalidTransform && !IsValid(parent))
+            parent = InvalidTransform;
+
+        // Append unsorted; the next Update() moves it into its depth level
+        const uint32_t slot = static_cast<uint32_t>(m_HandleOf.size());
+        m_SlotOf[handle] = slot;
+        m_Parent[handle] = parent;
+        m_FirstChild[handle] = InvalidTransform;
+        m_Alive[handle] = 1;
+        LinkChild(handle, parent);
+
+        m_ParentSlot.push_back(parent != InvalidTransform ? m_SlotOf[parent] : InvalidTransform);
+        m_Position.emplace_back(0.0f);
+        m_Rotation.push_back(Math::Quat::Identity());
+        m_Scale.emplace_back(1.0f);
+        m_World.push_back(Math::Mat4::Identity());
+        m_Dirty.push_back(1);
+        m_Updated.push_back(0);
+        m_HandleOf.push_back(handle);
+
+        ++m_AliveCount;
+        m_StructureDirty = true;
+        return handle;
+    }
+
+    void TransformHierarchy::Destroy(TransformHandle handle) {
+        if (!IsValid(handle))
+            return;
+
+        // The subtree dies now; the next Rebuild() releases its slots and handles
+        UnlinkChild(handle);
+        std::vector<TransformHandle> pending{ handle };
+        while (!pending.empty()) {
+            const TransformHandle current = pending.back();
+            pending.pop_back();
+            m_Alive[current] = 0;
+            --m_AliveCount;
+            for (TransformHandle child = m_FirstChild[current]; child != InvalidTransform; child = m_NextSibling[child])
+                pending.push_back(child);
+        }
+        m_StructureDirty = true;
+    }
+
+    void TransformHierarchy::SetParent(TransformHandle handle, TransformHandle parent) {
+        if (!IsValid(handle))
+            return;
+        if (parent != InvalidTransform && !IsValid(parent))
+            return;
+
+        // Refuse to create a cycle
+        for (TransformHandle ancestor = parent; ancestor != InvalidTransform; ancestor = m_Parent[ancestor]) {
+            if (ancestor == handle) {
+                LOG_ENGINE_WARN("[TransformHierarchy] SetParent({}, {}) would create a cycle; ignored.", handle, parent);
+                return;
+            }
+        }
+
+        UnlinkChild(handle);
+        m_Parent[handle] = parent;
+        LinkChild(handle, parent);
+        m_ParentSlot[m_SlotOf[handle]] = (parent != InvalidTransform) ? m_SlotOf[parent] : InvalidTransform;
+        MarkDirty(handle);
+        m_StructureDirty = true;
+    }
+
+    bool TransformHierarchy::IsValid(TransformHandle handle) const {
+        return handle < m_Alive.size() && m_Alive[handle] != 0;
+    }
+
+    TransformHandle TransformHierarchy::GetParent(TransformHandle handle) const {
+        return m_Parent[handle];
+    }
+
+    void TransformHierarchy::SetLocal(TransformHandle handle, const Math::Vec3& position, const Math::Quat& rotation, const Math::Vec3& scale) {
+        const uint32_t slot = m_SlotOf[handle];
+        m_Position[slot] = position;
+        m_Rotation[slot] = rotation;
+        m_Scale[slot] = scale;
+        m_Dirty[slot] = 1;
+    }
+
+    void TransformHierarchy::SetLocalPosition(TransformHandle handle, const Math::Vec3& position) {
+        m_Position[m_SlotOf[handle]] = position;
+        MarkDirty(handle);
+    }
+
+    void TransformHierarchy::SetLocalRotation(TransformHandle handle, const Math::Quat& rotation) {
+        m_Rotation[m_SlotOf[handle]] = rotation;
+        MarkDirty(handle);
+    }
+
+    void TransformHierarchy::SetLocalScale(TransformHandle handle, const Math::Vec3& scale) {
+        m_Scale[m_SlotOf[handle]] = scale;
+        MarkDirty(handle);
+    }
+
+    void TransformHierarchy::MarkDirty(TransformHandle handle) {
+        m_Dirty[m_SlotOf[handle]] = 1;
+    }
+
+    void TransformHierarchy::LinkChild(TransformHandle handle, TransformHandle parent) {
+        m_PrevSibling[handle] = InvalidTransform;
+        m_NextSibling[handle] = InvalidTransform;
+        if (parent == InvalidTransform)
+            return;
+        const TransformHandle next = m_FirstChild[parent];
+        m_NextSibling[handle] = next;
+        if (next != InvalidTransform)
+            m_PrevSibling[next] = handle;
+        m_FirstChild[parent] = handle;
+    }
+
+    void TransformHierarchy::UnlinkChild(TransformHandle handle) {
+        const TransformHandle prev = m_PrevSibling[handle];
+        const TransformHandle next = m_NextSibling[handle];
+        if (prev != InvalidTransform)
+            m_NextSibling[prev] = next;
+        else if (m_Parent[handle] != InvalidTransform)
+            m_FirstChild[m_Parent[handle]] = next;
+        if (next != InvalidTransform)
+            m_PrevSibling[next] = prev;
+        m_PrevSibling[handle] = InvalidTransform;
+        m_NextSibling[handle] = InvalidTransform;
+    }
+
+    uint32_t TransformHierarchy::GetMaxDepth() const {
+        return (m_LevelOffsets.size() > 2) ? static_cast<uint32_t>(m_LevelOffsets.size() - 2) : 0;
+    }
+
+    void TransformHierarchy::Rebuild() {
+        const uint32_t slotCount = static_cast<uint32_t>(m_HandleOf.size());
+        const uint32_t handleCount = static_cast<uint32_t>(m_SlotOf.size());
+
+        // 1) Depth of every live handle; Destroy() already marked whole subtrees dead
+        constexpr uint32_t kUnknown = 0xFFFFFFFFu;
+        constexpr uint32_t kDead = 0xFFFFFFFEu;
+        std::vector<uint32_t> depth(handleCount, kUnknown);
+        std::vector<TransformHandle> chain;
+
+        for (uint32_t slot = 0; slot < slotCount; ++slot) {
+            TransformHandle handle = m_HandleOf[slot];
+            if (depth[handle] != kUnknown)
+                continue;
+
+            // Walk up until a node with a known depth (or a root) is found
+            chain.clear();
+            TransformHandle current = handle;
+            uint32_t base = kUnknown;
+            while (true) {
+                if (!m_Alive[current]) { base = kDead; chain.push_back(current); break; }
+                if (depth[current] != kUnknown) { base = depth[current]; break; }
+                chain.push_back(current);
+                if (m_Parent[current] == InvalidTransform) { base = kUnknown; break; }
+                current = m_Parent[current];
+            }
+
+            // Assign from the top of the chain down
+            uint32_t d = base;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                if (d == kDead || !m_Alive[*it])
+                    d = kDead;
+                else
+                    d = (d == kUnknown) ? 0 : d + 1;
+                depth[*it] = d;
+            }
+        }
+
+        // 2) Counting sort by depth, stable in the old slot order to keep locality
+        uint32_t levels = 0;
+        for (uint32_t slot = 0; slot < slotCount; ++slot) {
+            uint32_t d = depth[m_HandleOf[slot]];
+            if (d != kDead)
+                levels = std::max(levels, d + 1);
+        }
+
+        m_LevelOffsets.assign(levels + 1, 0);
+        for (uint32_t slot = 0; slot < slotCount; ++slot) {
+            uint32_t d = depth[m_HandleOf[slot]];
+            if (d != kDead)
+                m_LevelOffsets[d + 1]++;
+        }
+        for (uint32_t level = 0; level < levels; ++level)
+            m_LevelOffsets[level + 1] += m_LevelOffsets[level];
+
+        std::vector<uint32_t> cursor(m_LevelOffsets.begin(), m_LevelOffsets.end() - 1);
+        std::vector<uint32_t> newSlotOf(slotCount, InvalidTransform); // old slot -> new slot
+        for (uint32_t slot = 0; slot < slotCount; ++slot) {
+            TransformHandle handle = m_HandleOf[slot];
+            uint32_t d = depth[handle];
+            if (d == kDead) {
+                m_Alive[handle] = 0;
+                m_SlotOf[handle] = InvalidTransform;
+                m_FreeHandles.push_back(handle);
+                continue;
+            }
+            newSlotOf[slot] = cursor[d]++;
+        }
+
+        // 3) Permute the per-slot arrays
+        const uint32_t newCount = m_LevelOffsets.back();
+        auto permute = [&](auto& array) {
+            std::remove_reference_t<decltype(array)> sorted(newCount);
+            for (uint32_t slot = 0; slot < slotCount; ++slot) {
+                if (newSlotOf[slot] != InvalidTransform)
+                    sorted[newSlotOf[slot]] = array[slot];
+            }
+            array.swap(sorted);
+        };
+        permute(m_Position);
+        permute(m_Rotation);
+        permute(m_Scale);
+        permute(m_World);
+        permute(m_Dirty);
+        permute(m_HandleOf);
+        m_Updated.assign(newCount, 0);
+
+        m_ParentSlot.resize(newCount);
+        for (uint32_t slot = 0; slot < newCount; ++slot) {
+            TransformHandle handle = m_HandleOf[slot];
+            m_SlotOf[handle] = slot;
+        }
+        for (uint32_t slot = 0; slot < newCount; ++slot) {
+            TransformHandle parent = m_Parent[m_HandleOf[slot]];
+            m_ParentSlot[slot] = (parent != InvalidTransform) ? m_SlotOf[parent] : InvalidTransform;
+        }
+
+        m_AliveCount = newCount;
+        m_StructureDirty = false;
+    }
+
+    uint32_t TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end) {
+        uint32_t updated = 0;
+        for (uint32_t slot = begin; slot < end; ++slot) {
+            const uint32_t parent = m_ParentSlot[slot];
+            // Parents live in an earlier level, so their flag is already final
+            const bool dirty = m_Dirty[slot] || (parent != InvalidTransform && m_Updated[parent]);
+            m_Dirty[slot] = 0;
+            m_Updated[slot] = dirty ? 1 : 0;
+            if (!dirty)
+                continue;
+
+            Math::Mat4 local = Math::Mat4::FromTRS(m_Position[slot], m_Rotation[slot], m_Scale[slot]);
+            m_World[slot] = (parent != InvalidTransform) ? m_World[parent] * local : local;
+            ++updated;
+        }
+        return updated;
+    }
+
+    uint32_t TransformHierarchy::Update() {
+        if (m_StructureDirty)
+            Rebuild();
+
+        std::atomic<uint32_t> updated{ 0 };
+        const bool parallel = Threading::JobSystem::IsInitialized();
+
+        for (size_t level = 0; level + 1 < m_LevelOffsets.size(); ++level) {
+            const uint32_t begin = m_LevelOffsets[level];
+            const uint32_t end = m_LevelOffsets[level + 1];
+            const uint32_t count = end - begin;
+
+            if (!parallel || count < 2 * kParallelGrain) {
+                updated += UpdateRange(begin, end);
+                continue;
+            }
+
+            // Nodes of one level never depend on each other
+            Threading::JobContext ctx;
+            const uint32_t chunks = (count + kParallelGrain - 1) / kParallelGrain;
+            Threading::JobSystem::Dispatch(ctx, chunks, 1, [&, begin, end](Threading::JobArgs args) {
+                const uint32_t chunkBegin = begin + args.jobIndex * kParallelGrain;
+                const uint32_t chunkEnd = std::min(chunkBegin + kParallelGrain, end);
+                updated += UpdateRange(chunkBegin, chunkEnd);
+            });
+            Threading::JobSystem::Wait(ctx);
+        }
+
+        Profiling::SetCounter("Transforms.Updated", static_cast<double>(updated.load()));
+        return updated.load();
+    }
+
+} // namespace Core
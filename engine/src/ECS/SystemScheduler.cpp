@@ -0,0 +1,196 @@
+#include "ECS/SystemScheduler.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace ECS {
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    namespace {
+
+        void AtomicMin(std::atomic<int64_t>& target, int64_t value) {
+            int64_t current = target.load(std::memory_order_relaxed);
+            while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+
+        void AtomicMax(std::atomic<int64_t>& target, int64_t value) {
+            int64_t current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+
+    } // namespace
+
+    struct SystemScheduler::System {
+        std::string  name;
+        std::string  eventName;  // "ECS::<name>", kept so chunks don't rebuild it
+        SystemAccess access;
+        SystemFn     fn;
+        CountFn      count;      // Empty for plain systems
+        uint32_t     chunkSize = 1;
+
+        // Nanoseconds relative to the start of the current stage
+        std::atomic<int64_t> firstStartNs{ 0 };
+        std::atomic<int64_t> lastEndNs{ 0 };
+        double               lastTimeMs = 0.0;
+    };
+
+    SystemScheduler::SystemScheduler() = default;
+    SystemScheduler::~SystemScheduler() = default;
+
+    SystemScheduler::SystemId SystemScheduler::AddSystem(const std::string& name, const SystemAccess& access, SystemFn fn) {
+        return AddChunkedSystem(name, access, nullptr, 1, std::move(fn));
+    }
+
+    SystemScheduler::SystemId SystemScheduler::AddChunkedSystem(const std::string& name, const SystemAccess& access,
+                                                                CountFn count, uint32_t chunkSize, SystemFn fn) {
+        auto system = std::make_unique<System>();
+        system->name = name;
+        system->eventName = "ECS::" + name;
+        system->access = access;
+        system->fn = std::move(fn);
+        system->count = std::move(count);
+        system->chunkSize = std::max(chunkSize, 1u);
+
+        m_Systems.push_back(std::move(system));
+        m_Dirty = true;
+        return static_cast<SystemId>(m_Systems.size() - 1);
+    }
+
+    const std::string& SystemScheduler::GetSystemName(SystemId id) const {
+        return m_Systems[id]->name;
+    }
+
+    double SystemScheduler::GetSystemTimeMs(SystemId id) const {
+        return m_Systems[id]->lastTimeMs;
+    }
+
+    void SystemScheduler::Build() {
+        m_Stages.clear();
+        m_Conflicts.clear();
+
+        // A system lands one stage after the latest earlier system it conflicts with,
+        // which keeps registration order for every conflicting pair.
+        std::vector<uint32_t> stageOf(m_Systems.size(), 0);
+        for (SystemId j = 0; j < m_Systems.size(); ++j) {
+            uint32_t stage = 0;
+            for (SystemId i = 0; i < j; ++i) {
+                if (m_Systems[i]->access.ConflictsWith(m_Systems[j]->access)) {
+                    m_Conflicts.emplace_back(i, j);
+                    stage = std::max(stage, stageOf[i] + 1);
+                }
+            }
+            stageOf[j] = stage;
+            if (stage >= m_Stages.size())
+                m_Stages.resize(stage + 1);
+            m_Stages[stage].push_back(j);
+        }
+
+        for (const auto& [first, second] : m_Conflicts) {
+            LOG_PROFILE_INFO("[SystemScheduler] '{}' conflicts with '{}' (runs after it)",
+                m_Systems[first]->name, m_Systems[second]->name);
+        }
+        LOG_PROFILE_INFO("[SystemScheduler] {} systems in {} stages, {} conflicts",
+            m_Systems.size(), m_Stages.size(), m_Conflicts.size());
+
+        Profiling::SetCounter("ECS.Stages", static_cast<double>(m_Stages.size()));
+        Profiling::SetCounter("ECS.Conflicts", static_cast<double>(m_Conflicts.size()));
+
+        m_Dirty = false;
+    }
+
+    void SystemScheduler::Run(World& world, float deltaTime) {
+        if (m_Dirty)
+            Build();
+
+        // Pools must exist before anything runs in parallel
+        for (auto& system : m_Systems)
+            system->access.PreparePools(world);
+
+        auto frameStart = Clock::now();
+        for (const auto& stage : m_Stages)
+            RunStage(stage, world, deltaTime);
+        auto frameEnd = Clock::now();
+
+        UpdateCriticalPath();
+
+        Profiling::SetCounter("ECS.FrameMs", std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+        Profiling::SetCounter("ECS.CriticalPathMs", m_CriticalPathMs);
+    }
+
+    void SystemScheduler::RunStage(const std::vector<SystemId>& stage, World& world, float deltaTime) {
+        const auto stageStart = Clock::now();
+        Threading::JobContext ctx;
+
+        for (SystemId id : stage) {
+            System* system = m_Systems[id].get();
+            system->firstStartNs.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+            system->lastEndNs.store(0, std::memory_order_relaxed);
+
+            const uint32_t count = system->count ? system->count(world) : 1;
+            const uint32_t chunkSize = system->count ? system->chunkSize : 1;
+            const uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+            Threading::JobSystem::Dispatch(ctx, chunkCount, 1, [=, &world](Threading::JobArgs args) {
+                const auto start = Clock::now();
+
+                SystemContext context{ world, deltaTime, args.jobIndex * chunkSize,
+                                       std::min((args.jobIndex + 1) * chunkSize, count) };
+                system->fn(context);
+
+                const auto end = Clock::now();
+                Profiling::RecordEvent(system->eventName, start, end);
+                AtomicMin(system->firstStartNs, std::chrono::duration_cast<std::chrono::nanoseconds>(start - stageStart).count());
+                AtomicMax(system->lastEndNs, std::chrono::duration_cast<std::chrono::nanoseconds>(end - stageStart).count());
+            });
+        }
+
+        Threading::JobSystem::Wait(ctx);
+
+        for (SystemId id : stage) {
+            System* system = m_Systems[id].get();
+            int64_t first = system->firstStartNs.load(std::memory_order_relaxed);
+            int64_t last = system->lastEndNs.load(std::memory_order_relaxed);
+            system->lastTimeMs = (last > first) ? (last - first) / 1.0e6 : 0.0;
+        }
+    }
+
+    void SystemScheduler::UpdateCriticalPath() {
+        // Longest weighted path through the conflict DAG (edges only go forward in
+        // registration order, so one pass in that order is a topological walk).
+        const size_t count = m_Systems.size();
+        std::vector<double>   longest(count, 0.0);
+        std::vector<SystemId> previous(count, std::numeric_limits<SystemId>::max());
+
+        // Build() emits m_Conflicts ordered by the later system, so each system's
+        // incoming edges form one contiguous run.
+        size_t edge = 0;
+        for (SystemId j = 0; j < count; ++j) {
+            double best = 0.0;
+            for (; edge < m_Conflicts.size() && m_Conflicts[edge].second == j; ++edge) {
+                SystemId i = m_Conflicts[edge].first;
+                if (longest[i] > best) {
+                    best = longest[i];
+                    previous[j] = i;
+                }
+            }
+            longest[j] = best + m_Systems[j]->lastTimeMs;
+        }
+
+        m_CriticalPath.clear();
+        m_CriticalPathMs = 0.0;
+        if (count == 0)
+            return;
+
+        SystemId tail = static_cast<SystemId>(std::max_element(longest.begin(), longest.end()) - longest.begin());
+        m_CriticalPathMs = longest[tail];
+        for (SystemId id = tail; id != std::numeric_limits<SystemId>::max(); id = previous[id])
+            m_CriticalPath.push_back(id);
+        std::reverse(m_CriticalPath.begin(), m_CriticalPath.end());
+    }
+
+} // namespace ECS
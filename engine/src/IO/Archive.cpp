@@ -0,0 +1,276 @@
+#include "IO/Archive.h"
+#include "IO/FileSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ENGINE_IO_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IO {
+
+    uint64_t HashBytes(const void* data, size_t size, uint64_t seed) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string NormalizePath(std::string_view path) {
+        std::string normalized(path);
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        size_t start = 0;
+        while (true) {
+            if (normalized.compare(start, 2, "./") == 0)
+                start += 2;
+            else if (start < normalized.size() && normalized[start] == '/')
+                ++start;
+            else
+                break;
+        }
+        return normalized.substr(start);
+    }
+
+    // ----------------------------------------------------------
+    // MAPPED FILE
+    // ----------------------------------------------------------
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string& path) {
+        Close();
+#if ENGINE_IO_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        m_Size = static_cast<uint64_t>(info.st_size);
+        if (m_Size > 0) {
+            void* mapping = ::mmap(nullptr, static_cast<size_t>(m_Size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                m_Size = 0;
+                return false;
+            }
+            m_Data = static_cast<const uint8_t*>(mapping);
+            m_Mapped = true;
+        }
+        // The mapping keeps the file alive
+        ::close(fd);
+        return true;
+#else
+        if (!FileSystem::ReadFile(path, m_Copy))
+            return false;
+        m_Data = m_Copy.data();
+        m_Size = m_Copy.size();
+        return true;
+#endif
+    }
+
+    void MappedFile::Close() {
+#if ENGINE_IO_MMAP
+        if (m_Mapped)
+            ::munmap(const_cast<uint8_t*>(m_Data), static_cast<size_t>(m_Size));
+#endif
+        m_Copy.clear();
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Mapped = false;
+    }
+
+    // ----------------------------------------------------------
+    // ARCHIVE
+    // ----------------------------------------------------------
+
+    bool Archive::Open(const std::string& path) {
+        ProfileScope scope("Archive::Open");
+        m_Entries = nullptr;
+        m_Header = ArchiveHeader();
+        m_Path = path;
+        if (!m_File.Open(path))
+            return false;
+
+        // Validate everything lookups rely on, once, so they need no checks
+        const uint64_t size = m_File.GetSize();
+        ArchiveHeader header;
+        if (size < sizeof(header))
+            return false;
+        std::memcpy(&header, m_File.GetData(), sizeof(header));
+        if (header.magic != kArchiveMagic || header.version != kArchiveVersion || header.fileSize != size)
+            return false;
+        if (header.tocOffset % alignof(ArchiveEntry) != 0 || header.tocOffset > size ||
+            header.entryCount > (size - header.tocOffset) / sizeof(ArchiveEntry) ||
+            header.namesOffset > size || header.namesSize > size - header.namesOffset)
+            return false;
+        const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(m_File.GetData() + header.tocOffset);
+        for (uint32_t i = 0; i < header.entryCount; ++i) {
+            const ArchiveEntry& entry = entries[i];
+            if (entry.offset > size || entry.size > size - entry.offset ||
+                uint64_t(entry.nameOffset) + entry.nameLength > header.namesSize ||
+                entry.codec > Codec::LZ4HC || (entry.codec == Codec::None && entry.size != entry.rawSize) ||
+                (i > 0 && entries[i - 1].pathHash >= entry.pathHash))
+                return false;
+        }
+
+        m_Header = header;
+        m_Entries = entries;
+        return true;
+    }
+
+    const ArchiveEntry* Archive::Find(uint64_t pathHash) const {
+        const ArchiveEntry* end = m_Entries + m_Header.entryCount;
+        const ArchiveEntry* it = std::lower_bound(m_Entries, end, pathHash, [](const ArchiveEntry& entry, uint64_t hash) {
+            return entry.pathHash < hash;
+        });
+        return (it != end && it->pathHash == pathHash) ? it : nullptr;
+    }
+
+    const ArchiveEntry* Archive::Find(std::string_view path) const {
+        const ArchiveEntry* entry = Find(HashPath(path));
+        return (entry && GetPath(*entry) == path) ? entry : nullptr;
+    }
+
+    std::string_view Archive::GetPath(const ArchiveEntry& entry) const {
+        const char* names = reinterpret_cast<const char*>(m_File.GetData() + m_Header.namesOffset);
+        return { names + entry.nameOffset, entry.nameLength };
+    }
+
+    bool Archive::Extract(const ArchiveEntry& entry, uint8_t* destination) const {
+        const ArchiveView stored = GetData(entry);
+        if (entry.codec == Codec::None) {
+            std::memcpy(destination, stored.data, static_cast<size_t>(stored.size));
+            return true;
+        }
+        return DecompressBlocks(entry.codec, stored.data, static_cast<size_t>(stored.size), destination, static_cast<size_t>(entry.rawSize));
+    }
+
+    std::vector<std::string> Archive::ListFiles(const std::string& root) {
+        std::vector<std::string> paths;
+        std::error_code error;
+        for (std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+            if (it->is_regular_file(error))
+                paths.push_back(NormalizePath(std::filesystem::relative(it->path(), root, error).generic_string()));
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    bool Archive::Build(const std::string& root, const std::vector<std::string>& inputPaths, const std::string& outputPath,
+                        const PackSettings& settings, std::string& outError) {
+        ProfileScope scope("Archive::Build");
+        const uint32_t alignment = settings.alignment;
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            outError = "alignment must be a power of two";
+            return false;
+        }
+        auto alignUp = [](uint64_t value, uint64_t to) { return (value + to - 1) & ~(to - 1); };
+
+        // Data in path order; the table of contents in hash order
+        std::vector<std::string> paths;
+        for (const std::string& path : inputPaths)
+            paths.push_back(NormalizePath(path));
+        std::sort(paths.begin(), paths.end());
+        paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+        ArchiveHeader header;
+        header.entryCount = static_cast<uint32_t>(paths.size());
+        header.alignment = alignment;
+        header.tocOffset = alignUp(sizeof(ArchiveHeader), kArchiveTocAlignment);
+        header.namesOffset = header.tocOffset + paths.size() * sizeof(ArchiveEntry);
+
+        std::vector<ArchiveEntry> entries(paths.size());
+        std::string names;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (paths[i].size() > UINT16_MAX) {
+                outError = "path too long: " + paths[i];
+                return false;
+            }
+            entries[i] = { HashPath(paths[i]), 0, 0, 0, static_cast<uint32_t>(names.size()), static_cast<uint16_t>(paths[i].size()), Codec::None, 0 };
+            names += paths[i];
+        }
+        header.namesSize = names.size();
+
+        std::vector<ArchiveEntry> sorted = entries;
+        std::sort(sorted.begin(), sorted.end(), [](const ArchiveEntry& l, const ArchiveEntry& r) { return l.pathHash < r.pathHash; });
+        for (size_t i = 1; i < sorted.size(); ++i) {
+            if (sorted[i].pathHash == sorted[i - 1].pathHash) {
+                outError = "path hash collision: " + names.substr(sorted[i].nameOffset, sorted[i].nameLength) + " and " +
+                           names.substr(sorted[i - 1].nameOffset, sorted[i - 1].nameLength);
+                return false;
+            }
+        }
+
+        std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            outError = "cannot write " + outputPath;
+            return false;
+        }
+        std::vector<char> padding(std::max<size_t>(alignment, kArchiveTocAlignment), 0);
+        auto padTo = [&](uint64_t position) {
+            for (uint64_t at = static_cast<uint64_t>(out.tellp()); at < position;) {
+                const uint64_t count = std::min<uint64_t>(position - at, padding.size());
+                out.write(padding.data(), static_cast<std::streamsize>(count));
+                at += count;
+            }
+        };
+
+        // Stored sizes are only known once compressed, so the data goes first
+        // and the table of contents is written over its placeholder at the end
+        padTo(header.namesOffset);
+        out.write(names.data(), static_cast<std::streamsize>(names.size()));
+        uint64_t offset = header.namesOffset + header.namesSize;
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> compressed;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            ArchiveEntry& entry = entries[i];
+            if (!FileSystem::ReadFile(root + "/" + paths[i], data)) {
+                outError = "cannot read " + paths[i];
+                return false;
+            }
+            entry.rawSize = data.size();
+            entry.codec = settings.chooseCodec ? settings.chooseCodec(paths[i]) : Codec::None;
+            if (entry.codec != Codec::None) {
+                compressed = CompressBlocks(entry.codec, data.data(), data.size());
+                if (compressed.size() < data.size())
+                    data.swap(compressed);
+                else
+                    entry.codec = Codec::None;
+            }
+            entry.size = data.size();
+            entry.offset = alignUp(offset, alignment);
+            padTo(entry.offset);
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            offset = entry.offset + entry.size;
+        }
+        header.fileSize = offset;
+
+        std::sort(entries.begin(), entries.end(), [](const ArchiveEntry& l, const ArchiveEntry& r) { return l.pathHash < r.pathHash; });
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.seekp(static_cast<std::streamoff>(header.tocOffset));
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry)));
+        if (!out.flush()) {
+            outError = "cannot write " + outputPath;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace IO
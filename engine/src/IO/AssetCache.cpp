@@ -0,0 +1,274 @@
+#include "IO/AssetCache.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <cassert>
+
+namespace IO {
+
+    bool LoadBytesAsset(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload) {
+        uint64_t size = 0;
+        if (!fileSystem.GetEntrySize(path, size))
+            return false;
+        auto bytes = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(size));
+        if (!fileSystem.ReadEntry(path, bytes->data(), size))
+            return false;
+        outPayload = { bytes, size };
+        return true;
+    }
+
+    bool LoadMeshAsset(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload) {
+        AssetPayload bytes;
+        if (!LoadBytesAsset(fileSystem, path, bytes))
+            return false;
+        const auto& data = *static_cast<const std::vector<uint8_t>*>(bytes.object.get());
+        auto mesh = std::make_shared<MeshData>();
+        if (!AssetLoader::ParseOBJ(std::string(data.begin(), data.end()), *mesh))
+            return false;
+        const uint64_t size = mesh->vertices.size() * sizeof(MeshVertex) + mesh->indices.size() * sizeof(uint32_t);
+        outPayload = { mesh, size };
+        return true;
+    }
+
+    AssetCache::AssetCache(FileSystem& fileSystem, uint32_t loaderThreads)
+        : m_FileSystem(fileSystem), m_Loaders(loaderThreads) {
+    }
+
+    AssetCache::~AssetCache() = default;
+
+    AssetType AssetCache::RegisterType(const AssetTypeDesc& desc) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Types.push_back({ desc, "Assets." + desc.name + ".ResidentBytes" });
+        return static_cast<AssetType>(m_Types.size() - 1);
+    }
+
+    void AssetCache::SetBudget(AssetType type, uint64_t budget) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Types[type].desc.budget = budget;
+        EnforceBudget(type);
+    }
+
+    // ----------------------------------------------------------
+    // REFERENCES
+    // ----------------------------------------------------------
+
+    AssetHandle AssetCache::Request(AssetType type, const std::string& path) {
+        const std::string normalized = NormalizePath(path);
+        const uint64_t key = HashPath(normalized) ^ ((uint64_t(type) + 1) * 0x9E3779B97F4A7C15ull);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Lookup.find(key);
+        if (it != m_Lookup.end()) {
+            Slot& slot = m_Slots[it->second];
+            if (slot.path != normalized) {
+                LOG_ENGINE_ERROR("[AssetCache] '{}' and '{}' have the same path hash; rename one.", normalized, slot.path);
+                return InvalidAsset;
+            }
+            if (slot.state == AssetState::Loading) {
+                ++m_Stats.coalesced;
+            } else {
+                ++m_Stats.hits;
+                if (slot.refs == 0)
+                    UnlinkLru(it->second);
+            }
+            ++slot.refs;
+            PublishRequestCounters();
+            return MakeHandle(it->second);
+        }
+
+        uint32_t index;
+        if (!m_FreeSlots.empty()) {
+            index = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        } else {
+            if (m_Slots.size() >= kMaxSlots) {
+                LOG_ENGINE_ERROR("[AssetCache] Out of slots; cannot request '{}'.", normalized);
+                return InvalidAsset;
+            }
+            index = static_cast<uint32_t>(m_Slots.size());
+            m_Slots.emplace_back();
+        }
+        Slot& slot = m_Slots[index];
+        slot.path = normalized;
+        slot.key = key;
+        slot.type = type;
+        slot.refs = 1;
+        slot.state = AssetState::Loading;
+        m_Lookup.emplace(key, index);
+        ++m_Stats.misses;
+        PublishRequestCounters();
+
+        m_Loaders.Submit([this, index] { LoadSlot(index); });
+        return MakeHandle(index);
+    }
+
+    AssetHandle AssetCache::Load(AssetType type, const std::string& path) {
+        const AssetHandle handle = Request(type, path);
+        if (handle != InvalidAsset)
+            Wait(handle);
+        return handle;
+    }
+
+    AssetHandle AssetCache::Acquire(AssetHandle handle) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_Slots[SlotOf(handle)].refs;
+        return handle;
+    }
+
+    void AssetCache::Release(AssetHandle handle) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        const uint32_t index = SlotOf(handle);
+        Slot& slot = m_Slots[index];
+        if (--slot.refs > 0 || slot.state == AssetState::Loading)
+            return;   // A load that finishes unreferenced is cached by LoadSlot()
+        if (slot.state == AssetState::Failed) {
+            // Not cached, so the next request tries again
+            FreeSlot(index);
+            return;
+        }
+        LinkLru(index);
+        EnforceBudget(slot.type);
+    }
+
+    AssetState AssetCache::Wait(AssetHandle handle) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        const uint32_t index = SlotOf(handle);
+        m_LoadedCondition.wait(lock, [&] { return m_Slots[index].state != AssetState::Loading; });
+        return m_Slots[index].state;
+    }
+
+    AssetState AssetCache::GetState(AssetHandle handle) const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Slots[SlotOf(handle)].state;
+    }
+
+    void* AssetCache::GetObject(AssetHandle handle) const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        const Slot& slot = m_Slots[SlotOf(handle)];
+        return slot.state == AssetState::Ready ? slot.payload.object.get() : nullptr;
+    }
+
+    AssetHandle AssetCache::MakeHandle(uint32_t slot) const {
+        return (AssetHandle(m_Slots[slot].generation) << kSlotBits) | slot;
+    }
+
+    uint32_t AssetCache::SlotOf(AssetHandle handle) const {
+        const uint32_t index = static_cast<uint32_t>(handle);
+        assert(handle != InvalidAsset && index < m_Slots.size() && m_Slots[index].generation == (handle >> kSlotBits) &&
+               m_Slots[index].refs > 0 && "Stale or released asset handle");
+        return index;
+    }
+
+    uint64_t AssetCache::GetResidentBytes(AssetType type) const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Types[type].residentBytes;
+    }
+
+    AssetCacheStats AssetCache::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Stats;
+    }
+
+    // ----------------------------------------------------------
+    // LOADING
+    // ----------------------------------------------------------
+
+    void AssetCache::LoadSlot(uint32_t index) {
+        ProfileScope scope("AssetCache::Load");
+        std::string path;
+        AssetLoadFn load;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            path = m_Slots[index].path;
+            load = m_Types[m_Slots[index].type].desc.load;
+        }
+
+        AssetPayload payload;
+        const bool loaded = load && load(m_FileSystem, path, payload);
+        if (!loaded)
+            LOG_ENGINE_WARN("[AssetCache] Cannot load '{}'.", path);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            Slot& slot = m_Slots[index];
+            if (loaded) {
+                slot.payload = std::move(payload);
+                slot.state = AssetState::Ready;
+                m_Types[slot.type].residentBytes += slot.payload.size;
+                m_Stats.residentBytes += slot.payload.size;
+                if (slot.refs == 0)
+                    LinkLru(index);
+                EnforceBudget(slot.type);
+            } else {
+                slot.state = AssetState::Failed;
+                if (slot.refs == 0)
+                    FreeSlot(index);
+            }
+        }
+        m_LoadedCondition.notify_all();
+    }
+
+    // ----------------------------------------------------------
+    // EVICTION
+    // ----------------------------------------------------------
+
+    void AssetCache::LinkLru(uint32_t index) {
+        Slot& slot = m_Slots[index];
+        TypeState& type = m_Types[slot.type];
+        slot.lruPrev = type.lruTail;
+        slot.lruNext = kNoSlot;
+        if (type.lruTail != kNoSlot)
+            m_Slots[type.lruTail].lruNext = index;
+        else
+            type.lruHead = index;
+        type.lruTail = index;
+    }
+
+    void AssetCache::UnlinkLru(uint32_t index) {
+        Slot& slot = m_Slots[index];
+        TypeState& type = m_Types[slot.type];
+        (slot.lruPrev != kNoSlot ? m_Slots[slot.lruPrev].lruNext : type.lruHead) = slot.lruNext;
+        (slot.lruNext != kNoSlot ? m_Slots[slot.lruNext].lruPrev : type.lruTail) = slot.lruPrev;
+        slot.lruPrev = slot.lruNext = kNoSlot;
+    }
+
+    void AssetCache::EnforceBudget(AssetType type) {
+        TypeState& state = m_Types[type];
+        while (state.residentBytes > state.desc.budget && state.lruHead != kNoSlot) {
+            const uint32_t oldest = state.lruHead;
+            UnlinkLru(oldest);
+            FreeSlot(oldest);
+            ++m_Stats.evictions;
+        }
+        PublishResidentCounters(type);
+    }
+
+    void AssetCache::FreeSlot(uint32_t index) {
+        Slot& slot = m_Slots[index];
+        m_Types[slot.type].residentBytes -= slot.payload.size;
+        m_Stats.residentBytes -= slot.payload.size;
+        m_Lookup.erase(slot.key);
+        slot.payload = AssetPayload();
+        slot.path.clear();
+        // Handles to the old asset no longer match; a generation of all ones is
+        // skipped so no handle can equal InvalidAsset
+        if (++slot.generation == ~0u)
+            slot.generation = 0;
+        m_FreeSlots.push_back(index);
+    }
+
+    void AssetCache::PublishRequestCounters() const {
+        const uint64_t requests = m_Stats.hits + m_Stats.misses + m_Stats.coalesced;
+        Profiling::SetCounter("Assets.Hits", double(m_Stats.hits));
+        Profiling::SetCounter("Assets.Misses", double(m_Stats.misses));
+        Profiling::SetCounter("Assets.Coalesced", double(m_Stats.coalesced));
+        Profiling::SetCounter("Assets.HitRate", double(m_Stats.hits + m_Stats.coalesced) / double(requests));
+    }
+
+    void AssetCache::PublishResidentCounters(AssetType type) const {
+        Profiling::SetCounter("Assets.Evictions", double(m_Stats.evictions));
+        Profiling::SetCounter("Assets.ResidentBytes", double(m_Stats.residentBytes));
+        Profiling::SetCounter(m_Types[type].residentCounter, double(m_Types[type].residentBytes));
+    }
+
+} // namespace IO
@@ -0,0 +1,282 @@
+#include "IO/AssetLoader.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace IO {
+
+    // ----------------------------------------------------------
+    // OBJ
+    // ----------------------------------------------------------
+
+    namespace {
+
+        bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        const char* SkipSpaces(const char* p, const char* end) {
+            while (p < end && IsSpace(*p))
+                ++p;
+            return p;
+        }
+
+        // Parses "v", "v/vt", "v//vn" or "v/vt/vn" (1-based, negative = relative).
+        // Missing components are left at 0.
+        bool ParseFaceVertex(const char*& p, const char* end, long out[3]) {
+            out[0] = out[1] = out[2] = 0;
+            for (int component = 0; component < 3; ++component) {
+                if (p < end && *p != '/' && !IsSpace(*p)) {
+                    char* next = nullptr;
+                    out[component] = std::strtol(p, &next, 10);
+                    if (next == p)
+                        return false;
+                    p = next;
+                }
+                if (p >= end || *p != '/')
+                    break;
+                ++p;
+            }
+            return out[0] != 0;
+        }
+
+        struct ObjKey {
+            uint32_t position, uv, normal;
+            bool operator==(const ObjKey& o) const { return position == o.position && uv == o.uv && normal == o.normal; }
+        };
+
+        struct ObjKeyHash {
+            size_t operator()(const ObjKey& k) const {
+                return (k.position * 73856093u) ^ (k.uv * 19349663u) ^ (k.normal * 83492791u);
+            }
+        };
+
+    } // namespace
+
+    bool AssetLoader::ParseOBJ(const std::string& text, MeshData& outMesh) {
+        ProfileScope scope("AssetLoader::ParseOBJ");
+
+        outMesh.vertices.clear();
+        outMesh.indices.clear();
+
+        std::vector<Math::Vec3> positions, normals;
+        std::vector<float> uvs;
+        std::unordered_map<ObjKey, uint32_t, ObjKeyHash> vertexOf;
+        std::vector<uint32_t> polygon;
+        std::vector<uint32_t> positionOf; // OBJ position per mesh vertex, for generated normals
+        bool missingNormals = false;
+
+        // 1-based after resolving; 0 means absent or out of range
+        auto resolve = [](long index, size_t count) -> uint32_t {
+            const long resolved = (index < 0) ? static_cast<long>(count) + index + 1 : index;
+            return (resolved >= 1 && resolved <= static_cast<long>(count)) ? static_cast<uint32_t>(resolved) : 0;
+        };
+
+        const char* p = text.data();
+        const char* const end = p + text.size();
+        while (p < end) {
+            const char* lineEnd = std::find(p, end, '\n');
+            const char* cursor = SkipSpaces(p, lineEnd);
+            p = (lineEnd < end) ? lineEnd + 1 : end;
+
+            const char* keyword = cursor;
+            while (cursor < lineEnd && !IsSpace(*cursor))
+                ++cursor;
+            const std::string_view key(keyword, static_cast<size_t>(cursor - keyword));
+
+            if (key == "v" || key == "vn" || key == "vt") {
+                float value[3] = { 0.0f, 0.0f, 0.0f };
+                const int count = (key == "vt") ? 2 : 3;
+                for (int i = 0; i < count; ++i) {
+                    cursor = SkipSpaces(cursor, lineEnd);
+                    char* next = nullptr;
+                    value[i] = std::strtof(cursor, &next);
+                    if (next == cursor)
+                        break;
+                    cursor = next;
+                }
+                if (key == "v")
+                    positions.emplace_back(value[0], value[1], value[2]);
+                else if (key == "vn")
+                    normals.emplace_back(value[0], value[1], value[2]);
+                else
+                    uvs.insert(uvs.end(), { value[0], value[1] });
+            }
+            else if (key == "f") {
+                polygon.clear();
+                while (true) {
+                    cursor = SkipSpaces(cursor, lineEnd);
+                    if (cursor >= lineEnd)
+                        break;
+                    long raw[3];
+                    if (!ParseFaceVertex(cursor, lineEnd, raw)) {
+                        LOG_ENGINE_ERROR("[AssetLoader] Malformed OBJ face.");
+                        return false;
+                    }
+
+                    const ObjKey objKey = { resolve(raw[0], positions.size()),
+                                            raw[1] ? resolve(raw[1], uvs.size() / 2) : 0,
+                                            raw[2] ? resolve(raw[2], normals.size()) : 0 };
+                    if (objKey.position == 0 || (raw[1] && objKey.uv == 0) || (raw[2] && objKey.normal == 0)) {
+                        LOG_ENGINE_ERROR("[AssetLoader] OBJ face index out of range.");
+                        return false;
+                    }
+
+                    auto [it, inserted] = vertexOf.emplace(objKey, static_cast<uint32_t>(outMesh.vertices.size()));
+                    if (inserted) {
+                        MeshVertex vertex;
+                        vertex.position = positions[objKey.position - 1];
+                        if (objKey.normal)
+                            vertex.normal = normals[objKey.normal - 1];
+                        else
+                            missingNormals = true;
+                        if (objKey.uv) {
+                            vertex.u = uvs[(objKey.uv - 1) * 2];
+                            vertex.v = uvs[(objKey.uv - 1) * 2 + 1];
+                        }
+                        outMesh.vertices.push_back(vertex);
+                        positionOf.push_back(objKey.position);
+                    }
+                    polygon.push_back(it->second);
+                }
+
+                for (size_t i = 2; i < polygon.size(); ++i)
+                    outMesh.indices.insert(outMesh.indices.end(), { polygon[0], polygon[i - 1], polygon[i] });
+            }
+            // Groups, materials, smoothing groups etc. are ignored
+        }
+
+        if (outMesh.indices.empty())
+            return false;
+
+        if (missingNormals) {
+            // Area-weighted face normals, shared by every vertex at the same OBJ position
+            std::vector<Math::Vec3> accumulated(positions.size() + 1, Math::Vec3(0.0f));
+            for (size_t i = 0; i < outMesh.indices.size(); i += 3) {
+                const uint32_t a = outMesh.indices[i], b = outMesh.indices[i + 1], c = outMesh.indices[i + 2];
+                const Math::Vec3& pa = outMesh.vertices[a].position;
+                const Math::Vec3 n = Math::Cross(outMesh.vertices[b].position - pa, outMesh.vertices[c].position - pa);
+                accumulated[positionOf[a]] += n;
+                accumulated[positionOf[b]] += n;
+                accumulated[positionOf[c]] += n;
+            }
+            for (size_t v = 0; v < outMesh.vertices.size(); ++v) {
+                if (Math::LengthSquared(outMesh.vertices[v].normal) == 0.0f)
+                    outMesh.vertices[v].normal = Math::Normalize(accumulated[positionOf[v]]);
+            }
+        }
+        return true;
+    }
+
+    bool AssetLoader::LoadOBJ(const std::string& path, MeshData& outMesh) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            LOG_ENGINE_ERROR("[AssetLoader] Cannot open '{}'.", path);
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        if (!ParseOBJ(buffer.str(), outMesh)) {
+            LOG_ENGINE_ERROR("[AssetLoader] '{}' holds no valid triangles.", path);
+            return false;
+        }
+        return true;
+    }
+
+    // ----------------------------------------------------------
+    // IMPORT STAGE
+    // ----------------------------------------------------------
+
+    ImportedMesh AssetLoader::ImportMesh(MeshData mesh, const MeshImportSettings& settings) {
+        ProfileScope scope("AssetLoader::ImportMesh");
+
+        ImportedMesh result;
+        const size_t sourceVertexBytes = mesh.vertices.size() * sizeof(MeshVertex);
+        const float acmrBefore = ComputeACMR(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+        // 1) LOD chain; each level is simplified from the previous one
+        std::vector<std::vector<uint32_t>> lodIndices;
+        std::vector<float> lodErrors;
+        lodIndices.push_back(std::move(mesh.indices));
+        lodErrors.push_back(0.0f);
+        {
+            ProfileScope lodScope("AssetLoader::SimplifyLods");
+            while (lodIndices.size() < std::max(settings.lodCount, 1u)) {
+                const std::vector<uint32_t>& previous = lodIndices.back();
+                const size_t target = static_cast<size_t>(previous.size() / 3 * settings.lodReduction) * 3;
+                float error = 0.0f;
+                std::vector<uint32_t> lod = Simplify(mesh, previous, target, &error);
+                // Stop once simplification stalls (locked borders, tiny meshes)
+                if (lod.empty() || lod.size() * 10 > previous.size() * 9)
+                    break;
+                lodIndices.push_back(std::move(lod));
+                lodErrors.push_back(std::max(error, lodErrors.back()));
+            }
+        }
+
+        // 2) Triangle order per LOD
+        if (settings.optimizeVertexCache) {
+            ProfileScope cacheScope("AssetLoader::OptimizeVertexCache");
+            for (std::vector<uint32_t>& lod : lodIndices)
+                OptimizeVertexCache(lod.data(), lod.size(), mesh.vertices.size());
+        }
+        const float acmrAfter = ComputeACMR(lodIndices[0].data(), lodIndices[0].size(), mesh.vertices.size());
+
+        // 3) One shared index buffer; vertex order follows first use, LOD 0 first
+        mesh.indices.clear();
+        for (size_t level = 0; level < lodIndices.size(); ++level) {
+            MeshLod lod;
+            lod.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+            lod.indexCount = static_cast<uint32_t>(lodIndices[level].size());
+            lod.error = lodErrors[level];
+            result.lods.push_back(lod);
+            mesh.indices.insert(mesh.indices.end(), lodIndices[level].begin(), lodIndices[level].end());
+        }
+        if (settings.optimizeVertexFetch) {
+            ProfileScope fetchScope("AssetLoader::OptimizeVertexFetch");
+            OptimizeVertexFetch(mesh);
+        }
+
+        // 4) Meshlets per LOD, appended into one set of buffers
+        {
+            ProfileScope meshletScope("AssetLoader::BuildMeshlets");
+            for (MeshLod& lod : result.lods) {
+                MeshletData data = BuildMeshlets(mesh, mesh.indices.data() + lod.firstIndex, lod.indexCount,
+                                                 settings.meshletMaxVertices, settings.meshletMaxTriangles);
+                lod.firstMeshlet = static_cast<uint32_t>(result.meshlets.meshlets.size());
+                lod.meshletCount = static_cast<uint32_t>(data.meshlets.size());
+
+                const uint32_t vertexBase = static_cast<uint32_t>(result.meshlets.vertices.size());
+                const uint32_t triangleBase = static_cast<uint32_t>(result.meshlets.triangles.size());
+                for (Meshlet& meshlet : data.meshlets) {
+                    meshlet.vertexOffset += vertexBase;
+                    meshlet.triangleOffset += triangleBase;
+                    result.meshlets.meshlets.push_back(meshlet);
+                }
+                result.meshlets.vertices.insert(result.meshlets.vertices.end(), data.vertices.begin(), data.vertices.end());
+                result.meshlets.triangles.insert(result.meshlets.triangles.end(), data.triangles.begin(), data.triangles.end());
+            }
+        }
+
+        // 5) Compact vertex format
+        if (settings.quantize) {
+            ProfileScope quantizeScope("AssetLoader::Quantize");
+            result.quantized = Quantize(mesh);
+        }
+
+        const size_t vertexBytes = settings.quantize ? result.quantized.vertices.size() * sizeof(QuantizedVertex)
+                                                     : mesh.vertices.size() * sizeof(MeshVertex);
+        LOG_ENGINE_INFO("[AssetLoader] Imported mesh: {} vertices, {} triangles, ACMR {:.3f} -> {:.3f}, "
+                        "{} LODs, {} meshlets, vertex data {} -> {} bytes.",
+                        mesh.vertices.size(), result.lods[0].indexCount / 3, acmrBefore, acmrAfter,
+                        result.lods.size(), result.meshlets.meshlets.size(), sourceVertexBytes, vertexBytes);
+
+        result.mesh = std::move(mesh);
+        return result;
+    }
+
+} // namespace IO
@@ -0,0 +1,314 @@
+#include "IO/Compression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace IO {
+
+    namespace {
+
+        // LZ4 block format limits
+        constexpr size_t kMinMatch = 4;
+        constexpr size_t kLastLiterals = 5;     // The block always ends with at least this many literals
+        constexpr size_t kMatchStartLimit = 12; // No match starts in the last 12 bytes
+        constexpr size_t kMaxOffset = 65535;
+
+        constexpr uint32_t kHashBits = 16;
+        constexpr uint32_t kNoPosition = ~0u;
+        constexpr uint32_t kFastDepth = 1;
+        constexpr uint32_t kHighDepth = 256;
+
+        uint32_t Read32(const uint8_t* p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t Hash4(const uint8_t* p) {
+            return (Read32(p) * 2654435761u) >> (32 - kHashBits);
+        }
+
+        size_t MatchLength(const uint8_t* a, const uint8_t* b, const uint8_t* bEnd) {
+            const uint8_t* start = b;
+            while (b < bEnd && *a == *b) {
+                ++a;
+                ++b;
+            }
+            return static_cast<size_t>(b - start);
+        }
+
+        // Length continuation bytes after a 15 in the token
+        bool WriteLength(uint8_t*& op, const uint8_t* oend, size_t length) {
+            for (; length >= 255; length -= 255) {
+                if (op >= oend)
+                    return false;
+                *op++ = 255;
+            }
+            if (op >= oend)
+                return false;
+            *op++ = static_cast<uint8_t>(length);
+            return true;
+        }
+
+        bool WriteSequence(uint8_t*& op, const uint8_t* oend, const uint8_t* literals, size_t literalCount,
+                           size_t offset, size_t matchLength) {
+            if (op >= oend)
+                return false;
+            uint8_t* token = op++;
+            *token = static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4);
+            if (literalCount >= 15 && !WriteLength(op, oend, literalCount - 15))
+                return false;
+            if (literalCount > static_cast<size_t>(oend - op))
+                return false;
+            std::memcpy(op, literals, literalCount);
+            op += literalCount;
+            if (matchLength == 0)
+                return true;   // Last sequence: literals only
+
+            if (oend - op < 2)
+                return false;
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            const size_t extra = matchLength - kMinMatch;
+            *token |= static_cast<uint8_t>(std::min<size_t>(extra, 15));
+            return extra < 15 || WriteLength(op, oend, extra - 15);
+        }
+
+        /*
+         * One matcher for both codecs: hash heads chained through previous
+         * positions. LZ4 looks at the newest candidate only and does not index
+         * inside matches; LZ4HC walks the chain and indexes every position.
+         */
+        size_t CompressLZ4(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity, uint32_t depth) {
+            uint8_t* op = dst;
+            const uint8_t* oend = dst + capacity;
+            size_t anchor = 0;
+
+            if (size > kMatchStartLimit) {
+                const size_t matchStartEnd = size - kMatchStartLimit;
+                const uint8_t* matchEnd = src + size - kLastLiterals;
+                std::vector<uint32_t> heads(size_t(1) << kHashBits, kNoPosition);
+                std::vector<uint32_t> chain(depth > 1 ? size : 0, kNoPosition);
+                auto insert = [&](size_t position) {
+                    const uint32_t hash = Hash4(src + position);
+                    if (depth > 1)
+                        chain[position] = heads[hash];
+                    heads[hash] = static_cast<uint32_t>(position);
+                };
+
+                size_t ip = 0;
+                while (ip < matchStartEnd) {
+                    const uint32_t value = Read32(src + ip);
+                    size_t bestLength = 0;
+                    size_t bestPosition = 0;
+                    uint32_t candidate = heads[Hash4(src + ip)];
+                    for (uint32_t attempts = depth; candidate != kNoPosition && attempts > 0; --attempts) {
+                        if (ip - candidate > kMaxOffset)
+                            break;
+                        if (Read32(src + candidate) == value) {
+                            const size_t length = kMinMatch + MatchLength(src + candidate + kMinMatch, src + ip + kMinMatch, matchEnd);
+                            if (length > bestLength) {
+                                bestLength = length;
+                                bestPosition = candidate;
+                            }
+                        }
+                        candidate = depth > 1 ? chain[candidate] : kNoPosition;
+                    }
+                    insert(ip);
+                    if (bestLength == 0) {
+                        ++ip;
+                        continue;
+                    }
+
+                    if (!WriteSequence(op, oend, src + anchor, ip - anchor, ip - bestPosition, bestLength))
+                        return 0;
+                    if (depth > 1) {
+                        for (size_t p = ip + 1; p < ip + bestLength && p < matchStartEnd; ++p)
+                            insert(p);
+                    }
+                    ip += bestLength;
+                    anchor = ip;
+                }
+            }
+
+            if (!WriteSequence(op, oend, src + anchor, size - anchor, 0, 0))
+                return 0;
+            return static_cast<size_t>(op - dst);
+        }
+
+        bool ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) {
+            uint8_t byte;
+            do {
+                if (ip >= iend)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        bool DecompressLZ4(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+            const uint8_t* ip = src;
+            const uint8_t* iend = src + srcSize;
+            uint8_t* op = dst;
+            uint8_t* oend = dst + dstSize;
+
+            while (ip < iend) {
+                const uint8_t token = *ip++;
+
+                size_t literals = token >> 4;
+                if (literals == 15 && !ReadLength(ip, iend, literals))
+                    return false;
+                if (literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op))
+                    return false;
+                // Short runs are copied as one fixed 16 bytes when both buffers have room past them
+                if (literals <= 16 && iend - ip >= 16 && oend - op >= 16)
+                    std::memcpy(op, ip, 16);
+                else
+                    std::memcpy(op, ip, literals);
+                ip += literals;
+                op += literals;
+                if (ip == iend)
+                    break;   // The last sequence has no match
+
+                if (iend - ip < 2)
+                    return false;
+                const size_t offset = ip[0] | (size_t(ip[1]) << 8);
+                ip += 2;
+                size_t length = token & 15;
+                if (length == 15 && !ReadLength(ip, iend, length))
+                    return false;
+                length += kMinMatch;
+                if (offset == 0 || offset > static_cast<size_t>(op - dst) || length > static_cast<size_t>(oend - op))
+                    return false;
+
+                const uint8_t* match = op - offset;
+                uint8_t* copyEnd = op + length;
+                if (offset >= 8 && oend - copyEnd >= 8) {
+                    // 8 bytes at a time, never overlapping the bytes they copy from. The
+                    // last chunk may run past the match; what follows overwrites it
+                    do {
+                        std::memcpy(op, match, 8);
+                        op += 8;
+                        match += 8;
+                    } while (op < copyEnd);
+                    op = copyEnd;
+                } else {
+                    while (op < copyEnd)
+                        *op++ = *match++;
+                }
+            }
+            return op == oend;
+        }
+
+    } // namespace
+
+    Codec ChooseCodec(std::string_view path) {
+        const size_t dot = path.find_last_of('.');
+        const size_t slash = path.find_last_of('/');
+        if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash))
+            return Codec::LZ4;
+        std::string extension(path.substr(dot + 1));
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+
+        static const char* const kStored[] = { "png", "jpg", "jpeg", "ogg", "mp3", "zip", "gz", "lz4", "zst" };
+        static const char* const kHighRatio[] = { "dds", "ktx", "ktx2", "tex", "mesh", "bin" };
+        for (const char* stored : kStored) {
+            if (extension == stored)
+                return Codec::None;
+        }
+        for (const char* high : kHighRatio) {
+            if (extension == high)
+                return Codec::LZ4HC;
+        }
+        return Codec::LZ4;
+    }
+
+    // ----------------------------------------------------------
+    // SINGLE BLOCKS
+    // ----------------------------------------------------------
+
+    size_t CompressBlock(Codec codec, const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+        switch (codec) {
+        case Codec::None:
+            if (size > capacity)
+                return 0;
+            std::memcpy(dst, src, size);
+            return size;
+        case Codec::LZ4:
+            return CompressLZ4(src, size, dst, capacity, kFastDepth);
+        case Codec::LZ4HC:
+            return CompressLZ4(src, size, dst, capacity, kHighDepth);
+        }
+        return 0;
+    }
+
+    bool DecompressBlock(Codec codec, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+        switch (codec) {
+        case Codec::None:
+            if (srcSize != dstSize)
+                return false;
+            std::memcpy(dst, src, dstSize);
+            return true;
+        case Codec::LZ4:
+        case Codec::LZ4HC:
+            return DecompressLZ4(src, srcSize, dst, dstSize);
+        }
+        return false;
+    }
+
+    // ----------------------------------------------------------
+    // BLOCK STREAMS
+    // ----------------------------------------------------------
+
+    std::vector<uint8_t> CompressBlocks(Codec codec, const uint8_t* data, size_t size) {
+        const uint32_t blockCount = GetBlockCount(size);
+        const size_t tableSize = sizeof(uint32_t) * (size_t(1) + blockCount);
+        std::vector<uint8_t> stream(tableSize);
+        std::memcpy(stream.data(), &blockCount, sizeof(blockCount));
+
+        std::vector<uint8_t> scratch(CompressBound(kCompressionBlockSize));
+        for (uint32_t block = 0; block < blockCount; ++block) {
+            const uint8_t* raw = data + size_t(block) * kCompressionBlockSize;
+            const size_t rawSize = GetBlockRawSize(size, block);
+            // Stored when compression does not shrink it; the decoder tells by the size
+            size_t stored = CompressBlock(codec, raw, rawSize, scratch.data(), rawSize - 1);
+            const uint8_t* bytes = scratch.data();
+            if (stored == 0) {
+                stored = rawSize;
+                bytes = raw;
+            }
+            stream.insert(stream.end(), bytes, bytes + stored);
+            const uint32_t end = static_cast<uint32_t>(stream.size() - tableSize);
+            std::memcpy(stream.data() + sizeof(uint32_t) * (size_t(1) + block), &end, sizeof(end));
+        }
+        return stream;
+    }
+
+    bool DecompressBlocks(Codec codec, const uint8_t* stream, size_t streamSize, uint8_t* dst, size_t rawSize) {
+        const uint32_t blockCount = GetBlockCount(rawSize);
+        const size_t tableSize = sizeof(uint32_t) * (size_t(1) + blockCount);
+        uint32_t storedCount = 0;
+        if (streamSize < tableSize || (std::memcpy(&storedCount, stream, sizeof(storedCount)), storedCount != blockCount))
+            return false;
+
+        const uint8_t* blocks = stream + tableSize;
+        const size_t blocksSize = streamSize - tableSize;
+        uint32_t begin = 0;
+        for (uint32_t block = 0; block < blockCount; ++block) {
+            uint32_t end;
+            std::memcpy(&end, stream + sizeof(uint32_t) * (size_t(1) + block), sizeof(end));
+            const size_t size = GetBlockRawSize(rawSize, block);
+            if (end < begin || end > blocksSize)
+                return false;
+            uint8_t* out = dst + size_t(block) * kCompressionBlockSize;
+            if (!DecompressBlock(GetBlockCodec(codec, end - begin, size), blocks + begin, end - begin, out, size))
+                return false;
+            begin = end;
+        }
+        return true;
+    }
+
+} // namespace IO
@@ -0,0 +1,346 @@
+#include "IO/ContentCooker.h"
+#include "IO/Archive.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace IO {
+
+    namespace {
+
+        namespace fs = std::filesystem;
+
+        constexpr const char* kDirectorySettings = "cook.settings";
+        constexpr const char* kSettingsExtension = ".settings";
+        constexpr const char* kManifestHeader = "# content manifest";
+
+        // A file some output depends on. Shared between every asset it feeds.
+        struct Input {
+            std::string path;           // Relative to the source root
+            uint64_t    size = 0;
+            uint64_t    time = 0;       // Last write time, in file clock ticks
+            uint64_t    hash = 0;
+            bool        valid = true;
+        };
+
+        struct Asset {
+            std::string           source;
+            std::string           output;
+            bool                  mesh = false;
+            std::vector<uint32_t> inputs;       // Into the input table; the source first, then settings in order
+            uint64_t              key = 0;
+            bool                  cooked = true;
+        };
+
+        struct ManifestLine {
+            std::string        output;
+            uint64_t           key = 0;
+            std::vector<Input> inputs;
+        };
+
+        bool IsSettingsFile(const fs::path& path) {
+            return path.filename() == kDirectorySettings || path.extension() == kSettingsExtension;
+        }
+
+        bool IsMeshSource(const fs::path& path) {
+            std::string extension = path.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+            return extension == ".obj";
+        }
+
+        bool ReadWholeFile(const std::string& path, std::string& outData) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                return false;
+            outData.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            return static_cast<bool>(file.read(outData.data(), static_cast<std::streamsize>(outData.size())));
+        }
+
+        bool ParseBool(const std::string& value, bool& out) {
+            if (value == "true" || value == "1")
+                out = true;
+            else if (value == "false" || value == "0")
+                out = false;
+            else
+                return false;
+            return true;
+        }
+
+        bool ApplySetting(MeshImportSettings& settings, const std::string& name, const std::string& value) {
+            char* end = nullptr;
+            if (name == "optimizeVertexCache")
+                return ParseBool(value, settings.optimizeVertexCache);
+            if (name == "optimizeVertexFetch")
+                return ParseBool(value, settings.optimizeVertexFetch);
+            if (name == "quantize")
+                return ParseBool(value, settings.quantize);
+            if (name == "lodReduction") {
+                settings.lodReduction = std::strtof(value.c_str(), &end);
+                return *end == '\0' && settings.lodReduction > 0.0f && settings.lodReduction <= 1.0f;
+            }
+            uint32_t* field = name == "lodCount"            ? &settings.lodCount
+                            : name == "meshletMaxVertices"  ? &settings.meshletMaxVertices
+                            : name == "meshletMaxTriangles" ? &settings.meshletMaxTriangles
+                                                            : nullptr;
+            if (!field)
+                return false;
+            *field = static_cast<uint32_t>(std::strtoul(value.c_str(), &end, 10));
+            return *end == '\0' && *field > 0;
+        }
+
+        // Settings files are applied in order; later ones override earlier ones
+        bool ParseSettings(const std::string& text, const std::string& path, MeshImportSettings& settings) {
+            std::istringstream lines(text);
+            std::string line;
+            for (uint32_t number = 1; std::getline(lines, line); ++number) {
+                std::istringstream fields(line);
+                std::string name, value, extra;
+                if (!(fields >> name) || name[0] == '#')
+                    continue;
+                if (!(fields >> value) || (fields >> extra) || !ApplySetting(settings, name, value)) {
+                    LOG_ENGINE_ERROR("[ContentCooker] {}:{}: invalid setting '{}'.", path, number, line);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Every field of the defaults goes into each mesh key, so changing one re-cooks
+        uint64_t HashSettings(const MeshImportSettings& settings, uint64_t seed) {
+            seed = HashBytes(&settings.optimizeVertexCache, sizeof(bool), seed);
+            seed = HashBytes(&settings.optimizeVertexFetch, sizeof(bool), seed);
+            seed = HashBytes(&settings.quantize, sizeof(bool), seed);
+            seed = HashBytes(&settings.lodCount, sizeof(uint32_t), seed);
+            seed = HashBytes(&settings.lodReduction, sizeof(float), seed);
+            seed = HashBytes(&settings.meshletMaxVertices, sizeof(uint32_t), seed);
+            return HashBytes(&settings.meshletMaxTriangles, sizeof(uint32_t), seed);
+        }
+
+        std::unordered_map<std::string, ManifestLine> ReadPreviousManifest(const std::string& outputRoot) {
+            std::unordered_map<std::string, ManifestLine> lines;
+            std::ifstream file(outputRoot + "/" + kAssetManifestName);
+            std::string line;
+            while (std::getline(file, line)) {
+                if (line.empty() || line[0] == '#')
+                    continue;
+                std::vector<std::string> fields;
+                std::istringstream stream(line);
+                for (std::string field; std::getline(stream, field, '\t');)
+                    fields.push_back(std::move(field));
+                // source, output, key, then (path, size, time, hash) per input
+                if (fields.size() < 3 || (fields.size() - 3) % 4 != 0)
+                    continue;
+                ManifestLine& entry = lines[fields[0]];
+                entry.output = fields[1];
+                entry.key = std::strtoull(fields[2].c_str(), nullptr, 16);
+                for (size_t i = 3; i < fields.size(); i += 4) {
+                    Input input;
+                    input.path = fields[i];
+                    input.size = std::strtoull(fields[i + 1].c_str(), nullptr, 10);
+                    input.time = std::strtoull(fields[i + 2].c_str(), nullptr, 10);
+                    input.hash = std::strtoull(fields[i + 3].c_str(), nullptr, 16);
+                    entry.inputs.push_back(std::move(input));
+                }
+            }
+            return lines;
+        }
+
+        std::string Hex(uint64_t value) {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016" PRIx64, value);
+            return text;
+        }
+
+    } // namespace
+
+    // ----------------------------------------------------------
+    // CONTENT COOKER
+    // ----------------------------------------------------------
+
+    ContentCooker::ContentCooker(std::string sourceRoot, std::string outputRoot)
+        : m_SourceRoot(std::move(sourceRoot)), m_OutputRoot(std::move(outputRoot)) {}
+
+    CookReport ContentCooker::Cook() {
+        ProfileScope scope("ContentCooker::Cook");
+        const auto start = std::chrono::steady_clock::now();
+        CookReport report;
+
+        std::error_code error;
+        if (!fs::is_directory(m_SourceRoot, error)) {
+            LOG_ENGINE_ERROR("[ContentCooker] '{}' is not a directory.", m_SourceRoot);
+            report.failed = 1;
+            return report;
+        }
+
+        // Graph: every source file is an asset; it and its settings files are inputs
+        std::vector<std::string> sources;
+        for (auto it = fs::recursive_directory_iterator(m_SourceRoot, error); !error && it != fs::recursive_directory_iterator();
+             it.increment(error)) {
+            if (it->is_regular_file(error) && !IsSettingsFile(it->path()))
+                sources.push_back(fs::relative(it->path(), m_SourceRoot, error).generic_string());
+        }
+        std::sort(sources.begin(), sources.end());
+
+        std::vector<Input> inputs;
+        std::unordered_map<std::string, uint32_t> inputLookup;
+        auto addInput = [&](const std::string& path) {
+            auto [it, inserted] = inputLookup.emplace(path, static_cast<uint32_t>(inputs.size()));
+            if (inserted)
+                inputs.push_back({ path });
+            return it->second;
+        };
+
+        std::vector<Asset> assets(sources.size());
+        for (size_t i = 0; i < sources.size(); ++i) {
+            Asset& asset = assets[i];
+            asset.source = sources[i];
+            asset.mesh = IsMeshSource(asset.source);
+            asset.output = asset.mesh ? fs::path(asset.source).replace_extension(".mesh").generic_string() : asset.source;
+            asset.inputs.push_back(addInput(asset.source));
+            if (asset.mesh) {
+                const fs::path directory = fs::path(asset.source).parent_path();
+                for (const std::string& settings : { (directory / kDirectorySettings).generic_string(), asset.source + kSettingsExtension }) {
+                    if (fs::is_regular_file(fs::path(m_SourceRoot) / settings, error))
+                        asset.inputs.push_back(addInput(settings));
+                }
+            }
+        }
+
+        // Hash only inputs whose size or time differ from the last build
+        const std::unordered_map<std::string, ManifestLine> previous = ReadPreviousManifest(m_OutputRoot);
+        std::unordered_map<std::string, const Input*> previousInputs;
+        for (const auto& [source, line] : previous) {
+            for (const Input& input : line.inputs)
+                previousInputs.emplace(input.path, &input);
+        }
+
+        std::vector<uint32_t> toHash;
+        for (uint32_t i = 0; i < inputs.size(); ++i) {
+            Input& input = inputs[i];
+            const fs::path path = fs::path(m_SourceRoot) / input.path;
+            input.size = fs::file_size(path, error);
+            const fs::file_time_type time = fs::last_write_time(path, error);
+            input.time = static_cast<uint64_t>(time.time_since_epoch().count());
+            auto known = previousInputs.find(input.path);
+            if (known != previousInputs.end() && known->second->size == input.size && known->second->time == input.time)
+                input.hash = known->second->hash;
+            else
+                toHash.push_back(i);
+        }
+
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, static_cast<uint32_t>(toHash.size()), 1, [&](Threading::JobArgs args) {
+            Input& input = inputs[toHash[args.jobIndex]];
+            std::string data;
+            input.valid = ReadWholeFile(m_SourceRoot + "/" + input.path, data);
+            input.hash = HashBytes(data.data(), data.size());
+        });
+        Threading::JobSystem::Wait(ctx);
+        report.hashedInputs = static_cast<uint32_t>(toHash.size());
+
+        // Key every output; cook those whose key or file does not match
+        static const uint64_t kMeshSeed = HashSettings(MeshImportSettings{}, HashBytes(&kCookedMeshVersion, sizeof(uint32_t),
+                                                                                        HashBytes(&kCookerVersion, sizeof(uint32_t))));
+        static const uint64_t kCopySeed = HashBytes(&kCookerVersion, sizeof(uint32_t));
+
+        std::vector<uint32_t> toCook;
+        for (uint32_t i = 0; i < assets.size(); ++i) {
+            Asset& asset = assets[i];
+            asset.key = asset.mesh ? kMeshSeed : kCopySeed;
+            for (uint32_t index : asset.inputs) {
+                asset.key = HashBytes(inputs[index].path.data(), inputs[index].path.size(), asset.key);
+                asset.key = HashBytes(&inputs[index].hash, sizeof(uint64_t), asset.key);
+            }
+            auto last = previous.find(asset.source);
+            const bool upToDate = last != previous.end() && last->second.key == asset.key && last->second.output == asset.output &&
+                                  fs::is_regular_file(fs::path(m_OutputRoot) / asset.output, error);
+            if (upToDate) {
+                ++report.upToDate;
+                continue;
+            }
+            toCook.push_back(i);
+            fs::create_directories((fs::path(m_OutputRoot) / asset.output).parent_path(), error);
+        }
+
+        Threading::JobSystem::Dispatch(ctx, static_cast<uint32_t>(toCook.size()), 1, [&](Threading::JobArgs args) {
+            Asset& asset = assets[toCook[args.jobIndex]];
+            const std::string sourcePath = m_SourceRoot + "/" + asset.source;
+            const std::string outputPath = m_OutputRoot + "/" + asset.output;
+            asset.cooked = std::all_of(asset.inputs.begin(), asset.inputs.end(), [&](uint32_t index) { return inputs[index].valid; });
+            if (asset.cooked && !asset.mesh) {
+                std::error_code copyError;
+                asset.cooked = fs::copy_file(sourcePath, outputPath, fs::copy_options::overwrite_existing, copyError);
+            } else if (asset.cooked) {
+                MeshImportSettings settings;
+                MeshData mesh;
+                for (size_t i = 1; asset.cooked && i < asset.inputs.size(); ++i) {
+                    const std::string& settingsPath = inputs[asset.inputs[i]].path;
+                    std::string text;
+                    asset.cooked = ReadWholeFile(m_SourceRoot + "/" + settingsPath, text) && ParseSettings(text, settingsPath, settings);
+                }
+                asset.cooked = asset.cooked && AssetLoader::LoadOBJ(sourcePath, mesh);
+                if (asset.cooked) {
+                    const std::vector<uint8_t> blob = CookMesh(AssetLoader::ImportMesh(std::move(mesh), settings));
+                    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+                    asset.cooked = static_cast<bool>(file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size())));
+                }
+            }
+            if (!asset.cooked)
+                LOG_ENGINE_ERROR("[ContentCooker] Failed to cook '{}'.", asset.source);
+        });
+        Threading::JobSystem::Wait(ctx);
+
+        // Outputs of sources that are gone, or now cook somewhere else
+        std::unordered_set<std::string> outputs;
+        for (const Asset& asset : assets)
+            outputs.insert(asset.output);
+        for (const auto& [source, line] : previous) {
+            if (!outputs.count(line.output) && fs::remove(fs::path(m_OutputRoot) / line.output, error))
+                ++report.removed;
+        }
+
+        // Failed assets are left out, so the next build tries them again
+        fs::create_directories(m_OutputRoot, error);
+        const std::string manifestPath = m_OutputRoot + "/" + kAssetManifestName;
+        {
+            std::ofstream manifest(manifestPath + ".tmp", std::ios::trunc);
+            manifest << kManifestHeader << " (cooker " << kCookerVersion << ")\n";
+            for (const Asset& asset : assets) {
+                if (!asset.cooked)
+                    continue;
+                manifest << asset.source << '\t' << asset.output << '\t' << Hex(asset.key);
+                for (uint32_t index : asset.inputs) {
+                    const Input& input = inputs[index];
+                    manifest << '\t' << input.path << '\t' << input.size << '\t' << input.time << '\t' << Hex(input.hash);
+                }
+                manifest << '\n';
+            }
+            if (!manifest.flush())
+                LOG_ENGINE_ERROR("[ContentCooker] Cannot write '{}'.", manifestPath);
+        }
+        fs::rename(manifestPath + ".tmp", manifestPath, error);
+
+        for (uint32_t index : toCook)
+            ++(assets[index].cooked ? report.cooked : report.failed);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Profiling::SetCounter("Cook.Cooked", double(report.cooked));
+        Profiling::SetCounter("Cook.UpToDate", double(report.upToDate));
+        LOG_ENGINE_INFO("[ContentCooker] {} cooked, {} up to date, {} failed, {} removed in {:.2f} s.", report.cooked,
+                        report.upToDate, report.failed, report.removed, report.seconds);
+        return report;
+    }
+
+} // namespace IO
@@ -0,0 +1,197 @@
+#include "IO/CookedAsset.h"
+#include "IO/Archive.h"
+#include "IO/AssetCache.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+namespace IO {
+
+    namespace {
+
+        uint64_t AlignUp(uint64_t value) {
+            return (value + kCookedAlignment - 1) & ~uint64_t(kCookedAlignment - 1);
+        }
+
+        // Every array of a cooked mesh, in blob order
+        template <typename Fn>
+        void ForEachArray(CookedMesh& mesh, Fn&& fn) {
+            fn(mesh.vertices);
+            fn(mesh.indices);
+            fn(mesh.quantizedVertices);
+            fn(mesh.lods);
+            fn(mesh.meshlets);
+            fn(mesh.meshletVertices);
+            fn(mesh.meshletTriangles);
+        }
+
+        struct AlignedDelete {
+            void operator()(uint8_t* blob) const { ::operator delete(blob, std::align_val_t(kCookedAlignment)); }
+        };
+        using BlobPtr = std::unique_ptr<uint8_t, AlignedDelete>;
+
+        BlobPtr AllocateBlob(uint64_t size) {
+            return BlobPtr(static_cast<uint8_t*>(::operator new(static_cast<size_t>(size), std::align_val_t(kCookedAlignment))));
+        }
+
+        // The mesh keeps the whole blob alive
+        std::shared_ptr<CookedMesh> AdoptBlob(BlobPtr blob, uint64_t size, const std::string& path) {
+            CookedMesh* mesh = FixupCookedMesh(blob.get(), size);
+            if (!mesh) {
+                LOG_ENGINE_ERROR("[AssetLoader] '{}' is not a cooked mesh of version {}; re-cook it.", path, kCookedMeshVersion);
+                return nullptr;
+            }
+            std::shared_ptr<uint8_t> owner(blob.release(), AlignedDelete());
+            return std::shared_ptr<CookedMesh>(owner, mesh);
+        }
+
+    } // namespace
+
+    std::vector<uint8_t> CookMesh(const ImportedMesh& imported) {
+        ProfileScope scope("CookMesh");
+        CookedMesh root;
+        root.header.type = CookedType::Mesh;
+        root.header.version = kCookedMeshVersion;
+        root.positionOffset = imported.quantized.positionOffset;
+        root.positionScale = imported.quantized.positionScale;
+
+        std::vector<uint8_t> blob(AlignUp(sizeof(CookedMesh)), 0);
+        auto append = [&blob](auto& array, const auto& source) {
+            static_assert(sizeof(*array.data()) == sizeof(source[0]), "cooked and source element types differ");
+            array.value = blob.size();
+            array.count = source.size();
+            const size_t bytes = source.size() * sizeof(source[0]);
+            blob.resize(AlignUp(blob.size() + bytes), 0);
+            if (bytes > 0)
+                std::memcpy(blob.data() + array.value, source.data(), bytes);
+        };
+        append(root.vertices, imported.mesh.vertices);
+        append(root.indices, imported.mesh.indices);
+        append(root.quantizedVertices, imported.quantized.vertices);
+        append(root.lods, imported.lods);
+        append(root.meshlets, imported.meshlets.meshlets);
+        append(root.meshletVertices, imported.meshlets.vertices);
+        append(root.meshletTriangles, imported.meshlets.triangles);
+
+        root.header.size = blob.size();
+        std::memcpy(blob.data(), &root, sizeof(root));
+        return blob;
+    }
+
+    CookedMesh* FixupCookedMesh(void* blob, uint64_t size) {
+        if (reinterpret_cast<uintptr_t>(blob) % kCookedAlignment != 0 || size < sizeof(CookedMesh))
+            return nullptr;
+        CookedMesh* mesh = static_cast<CookedMesh*>(blob);
+        const CookedHeader& header = mesh->header;
+        if (header.magic != kCookedMagic || header.type != CookedType::Mesh || header.version != kCookedMeshVersion ||
+            header.size != size)
+            return nullptr;
+
+        // Check everything before touching anything, so a bad blob is left as it was
+        bool valid = true;
+        ForEachArray(*mesh, [&](auto& array) {
+            const uint64_t elementSize = sizeof(*array.data());
+            valid = valid && array.value % kCookedAlignment == 0 && array.value >= sizeof(CookedMesh) && array.value <= size &&
+                    array.count <= (size - array.value) / elementSize;
+        });
+        if (!valid)
+            return nullptr;
+
+        uint8_t* base = static_cast<uint8_t*>(blob);
+        ForEachArray(*mesh, [&](auto& array) { array.value = reinterpret_cast<uintptr_t>(base + array.value); });
+        return mesh;
+    }
+
+    std::shared_ptr<CookedMesh> LoadCookedMesh(const std::string& path) {
+        ProfileScope scope("LoadCookedMesh");
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            LOG_ENGINE_ERROR("[AssetLoader] Cannot open '{}'.", path);
+            return nullptr;
+        }
+        const uint64_t size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+        BlobPtr blob = AllocateBlob(size);
+        if (!file.read(reinterpret_cast<char*>(blob.get()), static_cast<std::streamsize>(size))) {
+            LOG_ENGINE_ERROR("[AssetLoader] Cannot read '{}'.", path);
+            return nullptr;
+        }
+        return AdoptBlob(std::move(blob), size, path);
+    }
+
+    bool LoadCookedMeshAsset(FileSystem& fileSystem, const std::string& path, AssetPayload& outPayload) {
+        uint64_t size = 0;
+        if (!fileSystem.GetEntrySize(path, size))
+            return false;
+        BlobPtr blob = AllocateBlob(size);
+        if (!fileSystem.ReadEntry(path, blob.get(), size))
+            return false;
+        std::shared_ptr<CookedMesh> mesh = AdoptBlob(std::move(blob), size, path);
+        if (!mesh)
+            return false;
+        outPayload = { mesh, size };
+        return true;
+    }
+
+    // ----------------------------------------------------------
+    // ASSET MANIFEST
+    // ----------------------------------------------------------
+
+    bool AssetManifest::Load(const std::string& outputRoot) {
+        m_OutputRoot = outputRoot;
+        m_Entries.clear();
+        const std::string path = outputRoot + "/" + kAssetManifestName;
+        std::ifstream file(path);
+        if (!file) {
+            LOG_ENGINE_ERROR("[AssetLoader] Cannot open manifest '{}'.", path);
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+            const size_t outputStart = line.find('\t');
+            const size_t keyStart = outputStart == std::string::npos ? outputStart : line.find('\t', outputStart + 1);
+            if (keyStart == std::string::npos) {
+                LOG_ENGINE_ERROR("[AssetLoader] Malformed line in manifest '{}'.", path);
+                m_Entries.clear();
+                return false;
+            }
+            Entry entry;
+            entry.source = line.substr(0, outputStart);
+            entry.output = line.substr(outputStart + 1, keyStart - outputStart - 1);
+            entry.key = std::strtoull(line.c_str() + keyStart + 1, nullptr, 16);
+            m_Entries.push_back(std::move(entry));
+        }
+        std::sort(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b) { return a.source < b.source; });
+        return true;
+    }
+
+    const AssetManifest::Entry* AssetManifest::Find(std::string_view sourcePath) const {
+        const std::string source = NormalizePath(sourcePath);
+        auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), source,
+                                   [](const Entry& entry, const std::string& key) { return entry.source < key; });
+        return it != m_Entries.end() && it->source == source ? &*it : nullptr;
+    }
+
+    std::string AssetManifest::Resolve(std::string_view sourcePath) const {
+        const Entry* entry = Find(sourcePath);
+        return entry ? m_OutputRoot + "/" + entry->output : std::string();
+    }
+
+    std::shared_ptr<CookedMesh> LoadCookedMesh(const AssetManifest& manifest, std::string_view sourcePath) {
+        const std::string path = manifest.Resolve(sourcePath);
+        if (path.empty()) {
+            LOG_ENGINE_ERROR("[AssetLoader] '{}' is not in the content manifest; cook it.", sourcePath);
+            return nullptr;
+        }
+        return LoadCookedMesh(path);
+    }
+
+} // namespace IO
@@ -0,0 +1,701 @@
+#include "IO/FileSystem.h"
+#include "Memory/MemoryManager.h"
+#include "Threading/JobSystem.h"
+#include "Threading/ThreadPool.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ENGINE_IO_POSIX 1
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ENGINE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// Headers older than Linux 5.6 lack IORING_OP_READ
+#ifndef IORING_FEAT_RW_CUR_POS
+#undef ENGINE_IO_URING
+#endif
+#endif
+
+namespace IO {
+
+    namespace {
+
+        // Largest single read handed to the kernel; longer reads continue where it stopped
+        constexpr uint64_t kMaxReadChunk = 1ull << 30;
+
+        // Stored bytes per streamed read of a compressed entry: several blocks, so
+        // the first decompression jobs start long before the entry is read
+        constexpr uint32_t kStreamWindowSize = 256 * 1024;
+
+        // Bytes of the file a request covers, given the file size
+        uint64_t ClampReadSize(const ReadRequest& request, uint64_t fileSize) {
+            if (request.offset >= fileSize)
+                return 0;
+            return std::min(request.size, fileSize - request.offset);
+        }
+
+        // Points request.data at the destination, allocating one if the caller gave none
+        bool PrepareBuffer(ReadRequest& request, uint64_t size) {
+            if (request.buffer) {
+                request.data = request.buffer;
+                return true;
+            }
+            if (size == 0)
+                return true;
+            request.data = MemoryManager::GetInstance().Allocate(static_cast<size_t>(size), "FileSystem");
+            if (!request.data) {
+                request.error = ENOMEM;
+                return false;
+            }
+            return true;
+        }
+
+        // A failed read keeps nothing the FileSystem allocated
+        void ReleaseOnFailure(ReadRequest& request) {
+            if (!request.buffer && request.data)
+                MemoryManager::GetInstance().Deallocate(request.data);
+            request.data = nullptr;
+        }
+
+#if ENGINE_IO_POSIX
+        // Opens the file and sizes the read; -1 with request.error set on failure
+        int OpenForRead(ReadRequest& request, uint64_t& outSize) {
+            const int fd = ::open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                request.error = errno;
+                return -1;
+            }
+            struct stat info;
+            if (::fstat(fd, &info) != 0) {
+                request.error = errno;
+                ::close(fd);
+                return -1;
+            }
+            outSize = ClampReadSize(request, static_cast<uint64_t>(info.st_size));
+            if (!PrepareBuffer(request, outSize)) {
+                ::close(fd);
+                return -1;
+            }
+            return fd;
+        }
+#endif
+
+        // The whole read on the calling thread
+        IOStatus ReadBlocking(ReadRequest& request) {
+#if ENGINE_IO_POSIX
+            uint64_t size = 0;
+            const int fd = OpenForRead(request, size);
+            if (fd < 0)
+                return IOStatus::Failed;
+            uint8_t* dst = static_cast<uint8_t*>(request.data);
+            while (request.bytesRead < size) {
+                const size_t chunk = static_cast<size_t>(std::min(size - request.bytesRead, kMaxReadChunk));
+                const ssize_t result = ::pread(fd, dst + request.bytesRead, chunk, static_cast<off_t>(request.offset + request.bytesRead));
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result < 0) {
+                    request.error = errno;
+                    ::close(fd);
+                    ReleaseOnFailure(request);
+                    return IOStatus::Failed;
+                }
+                if (result == 0)
+                    break;   // Truncated since fstat()
+                request.bytesRead += static_cast<uint64_t>(result);
+            }
+            ::close(fd);
+            return IOStatus::Completed;
+#else
+            std::ifstream file(request.path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                request.error = ENOENT;
+                return IOStatus::Failed;
+            }
+            const uint64_t size = ClampReadSize(request, static_cast<uint64_t>(file.tellg()));
+            if (!PrepareBuffer(request, size))
+                return IOStatus::Failed;
+            file.seekg(static_cast<std::streamoff>(request.offset));
+            file.read(static_cast<char*>(request.data), static_cast<std::streamsize>(size));
+            request.bytesRead = static_cast<uint64_t>(file.gcount());
+            return IOStatus::Completed;
+#endif
+        }
+
+    } // namespace
+
+    // ----------------------------------------------------------
+    // BACKENDS
+    // ----------------------------------------------------------
+
+    // Takes queued requests through FileSystem::PopQueued() and reports them
+    // through FileSystem::Finish()
+    struct FileSystem::Backend {
+        explicit Backend(FileSystem& fileSystem) : m_FileSystem(fileSystem) {}
+        virtual ~Backend() = default;
+
+        /** @brief A request was queued. */
+        virtual void Kick() = 0;
+
+        FileSystem& m_FileSystem;
+    };
+
+    struct FileSystem::ThreadPoolBackend : FileSystem::Backend {
+        ThreadPoolBackend(FileSystem& fileSystem, uint32_t threadCount) : Backend(fileSystem), m_Pool(threadCount) {}
+
+        // One task per queued request; each task takes whichever request ranks
+        // first when it runs, which may be a later, more urgent one
+        void Kick() override {
+            m_Pool.Submit([this] {
+                if (ReadRequest* request = m_FileSystem.PopQueued())
+                    m_FileSystem.Finish(*request, ReadBlocking(*request));
+            });
+        }
+
+        Threading::ThreadPool m_Pool;
+    };
+
+#if ENGINE_IO_URING
+    namespace {
+
+        int IoUringSetup(unsigned entries, io_uring_params* params) {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int IoUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+        }
+
+    } // namespace
+
+    /*
+     * One ring, driven by one IO thread that owns both queues, so no ring access
+     * needs a lock. An 8-byte read of an eventfd is always in flight; Kick()
+     * writes the eventfd, which completes that read and wakes the thread out of
+     * io_uring_enter() to pick up new requests.
+     */
+    struct FileSystem::IoUringBackend : FileSystem::Backend {
+        static constexpr uint64_t kWakeTag = ~0ull;
+
+        // A read in flight
+        struct Slot {
+            ReadRequest* request = nullptr;
+            int          fd = -1;
+            uint64_t     size = 0;    // Bytes to read in total
+        };
+
+        explicit IoUringBackend(FileSystem& fileSystem) : Backend(fileSystem) {}
+
+        ~IoUringBackend() override {
+            if (m_Thread.joinable()) {
+                m_Stopping.store(true, std::memory_order_release);
+                Kick();
+                m_Thread.join();
+            }
+            if (m_Sqes)
+                ::munmap(m_Sqes, m_SqesSize);
+            if (m_CqRing && m_CqRing != m_SqRing)
+                ::munmap(m_CqRing, m_CqRingSize);
+            if (m_SqRing)
+                ::munmap(m_SqRing, m_SqRingSize);
+            if (m_WakeFd >= 0)
+                ::close(m_WakeFd);
+            if (m_RingFd >= 0)
+                ::close(m_RingFd);
+        }
+
+        bool Init(uint32_t queueDepth) {
+            // One extra entry for the wake read
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            m_RingFd = IoUringSetup(queueDepth + 1, &params);
+            if (m_RingFd < 0) {
+                LOG_ENGINE_INFO("[FileSystem] io_uring unavailable ({}); using the thread pool.", std::strerror(errno));
+                return false;
+            }
+            // IORING_OP_READ arrived with the same kernel (5.6) as this feature bit
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+                LOG_ENGINE_INFO("[FileSystem] Kernel io_uring too old; using the thread pool.");
+                return false;
+            }
+
+            m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap)
+                m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+            m_SqRing = ::mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+            if (m_SqRing == MAP_FAILED) {
+                m_SqRing = nullptr;
+                return false;
+            }
+            m_CqRing = singleMap ? m_SqRing
+                                 : ::mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+            if (m_CqRing == MAP_FAILED) {
+                m_CqRing = nullptr;
+                return false;
+            }
+            m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = ::mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED)
+                return false;
+            m_Sqes = static_cast<io_uring_sqe*>(sqes);
+
+            uint8_t* sq = static_cast<uint8_t*>(m_SqRing);
+            uint8_t* cq = static_cast<uint8_t*>(m_CqRing);
+            m_SqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_SqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_SqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_CqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_CqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_CqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            m_WakeFd = ::eventfd(0, EFD_CLOEXEC);
+            if (m_WakeFd < 0)
+                return false;
+
+            m_Slots.resize(queueDepth);
+            for (uint32_t slot = queueDepth; slot-- > 0;)
+                m_FreeSlots.push_back(slot);
+            m_Thread = std::thread(&IoUringBackend::Run, this);
+            LOG_ENGINE_INFO("[FileSystem] Using io_uring with {} reads in flight.", queueDepth);
+            return true;
+        }
+
+        void Kick() override {
+            const uint64_t one = 1;
+            while (::write(m_WakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        }
+
+        io_uring_sqe& NextSqe(uint64_t userData) {
+            // Each slot and the wake read have at most one entry queued, so the
+            // ring (queueDepth + 1 entries) never fills
+            const unsigned tail = *m_SqTail;
+            const unsigned index = tail & m_SqMask;
+            io_uring_sqe& sqe = m_Sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.user_data = userData;
+            m_SqArray[index] = index;
+            __atomic_store_n(m_SqTail, tail + 1, __ATOMIC_RELEASE);
+            ++m_ToSubmit;
+            return sqe;
+        }
+
+        void SubmitWakeRead() {
+            io_uring_sqe& sqe = NextSqe(kWakeTag);
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = m_WakeFd;
+            sqe.addr = reinterpret_cast<uint64_t>(&m_WakeValue);
+            sqe.len = sizeof(m_WakeValue);
+        }
+
+        // Continues the read of a slot where the last chunk stopped
+        void SubmitRead(uint32_t slot) {
+            const Slot& s = m_Slots[slot];
+            ReadRequest& request = *s.request;
+            io_uring_sqe& sqe = NextSqe(slot);
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = s.fd;
+            sqe.addr = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(request.data) + request.bytesRead);
+            sqe.len = static_cast<uint32_t>(std::min(s.size - request.bytesRead, kMaxReadChunk));
+            sqe.off = request.offset + request.bytesRead;
+        }
+
+        void Start(ReadRequest& request) {
+            uint64_t size = 0;
+            const int fd = OpenForRead(request, size);
+            if (fd < 0) {
+                m_FileSystem.Finish(request, IOStatus::Failed);
+                return;
+            }
+            if (size == 0) {
+                ::close(fd);
+                m_FileSystem.Finish(request, IOStatus::Completed);
+                return;
+            }
+            const uint32_t slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+            m_Slots[slot] = { &request, fd, size };
+            SubmitRead(slot);
+        }
+
+        void Complete(uint32_t slot, int result) {
+            Slot& s = m_Slots[slot];
+            ReadRequest& request = *s.request;
+            if (result == -EINTR || result == -EAGAIN) {
+                SubmitRead(slot);
+                return;
+            }
+            IOStatus status = IOStatus::Completed;
+            if (result < 0) {
+                request.error = -result;
+                ReleaseOnFailure(request);
+                status = IOStatus::Failed;
+            } else if (result > 0) {
+                request.bytesRead += static_cast<uint64_t>(result);
+                if (request.bytesRead < s.size) {
+                    SubmitRead(slot);
+                    return;
+                }
+            }
+            // A zero-byte result is the end of a file truncated since fstat()
+            ::close(s.fd);
+            s = Slot();
+            m_FreeSlots.push_back(slot);
+            m_FileSystem.Finish(request, status);
+        }
+
+        void Run() {
+            SubmitWakeRead();
+            while (true) {
+                while (!m_FreeSlots.empty()) {
+                    ReadRequest* request = m_FileSystem.PopQueued();
+                    if (!request)
+                        break;
+                    Start(*request);
+                }
+                // The FileSystem cancels whatever is still queued before stopping
+                if (m_Stopping.load(std::memory_order_acquire) && m_FreeSlots.size() == m_Slots.size())
+                    return;
+
+                const int submitted = IoUringEnter(m_RingFd, m_ToSubmit, 1, IORING_ENTER_GETEVENTS);
+                if (submitted < 0) {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                        continue;
+                    LOG_ENGINE_ERROR("[FileSystem] io_uring_enter failed: {}", std::strerror(errno));
+                    return;
+                }
+                m_ToSubmit -= static_cast<unsigned>(submitted);
+
+                unsigned head = *m_CqHead;
+                const unsigned tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head) {
+                    const io_uring_cqe& cqe = m_Cqes[head & m_CqMask];
+                    if (cqe.user_data == kWakeTag)
+                        SubmitWakeRead();
+                    else
+                        Complete(static_cast<uint32_t>(cqe.user_data), cqe.res);
+                }
+                __atomic_store_n(m_CqHead, head, __ATOMIC_RELEASE);
+            }
+        }
+
+        int           m_RingFd = -1;
+        int           m_WakeFd = -1;
+        uint64_t      m_WakeValue = 0;
+        void*         m_SqRing = nullptr;
+        void*         m_CqRing = nullptr;
+        size_t        m_SqRingSize = 0, m_CqRingSize = 0, m_SqesSize = 0;
+        io_uring_sqe* m_Sqes = nullptr;
+        io_uring_cqe* m_Cqes = nullptr;
+        unsigned*     m_SqTail = nullptr;
+        unsigned*     m_SqArray = nullptr;
+        unsigned*     m_CqHead = nullptr;
+        unsigned*     m_CqTail = nullptr;
+        unsigned      m_SqMask = 0, m_CqMask = 0;
+        unsigned      m_ToSubmit = 0;
+
+        std::vector<Slot>     m_Slots;
+        std::vector<uint32_t> m_FreeSlots;
+        std::atomic<bool>     m_Stopping{ false };
+        std::thread           m_Thread;
+    };
+#endif
+
+    // ----------------------------------------------------------
+    // FILE SYSTEM
+    // ----------------------------------------------------------
+
+    FileSystem::FileSystem(const FileSystemSettings& settings) {
+#if ENGINE_IO_URING
+        if (settings.backend != IOBackendType::ThreadPool) {
+            auto backend = std::make_unique<IoUringBackend>(*this);
+            if (backend->Init(std::max(settings.queueDepth, 1u))) {
+                m_Backend = std::move(backend);
+                m_BackendType = IOBackendType::IoUring;
+                return;
+            }
+        }
+#endif
+        m_Backend = std::make_unique<ThreadPoolBackend>(*this, settings.threadCount);
+        m_BackendType = IOBackendType::ThreadPool;
+    }
+
+    FileSystem::~FileSystem() {
+        while (ReadRequest* request = PopQueued())
+            Finish(*request, IOStatus::Cancelled);
+        m_Backend.reset();
+    }
+
+    bool FileSystem::Read(ReadRequest& request) {
+        if (!IsDone(request))
+            return false;
+        request.data = nullptr;
+        request.bytesRead = 0;
+        request.error = 0;
+        m_Pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            request.status.store(IOStatus::Queued, std::memory_order_relaxed);
+            m_Queues[static_cast<uint32_t>(request.priority)].push_back(&request);
+        }
+        m_Backend->Kick();
+        return true;
+    }
+
+    bool FileSystem::Cancel(ReadRequest& request) {
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            if (request.status.load(std::memory_order_relaxed) != IOStatus::Queued)
+                return false;
+            std::deque<ReadRequest*>& queue = m_Queues[static_cast<uint32_t>(request.priority)];
+            queue.erase(std::find(queue.begin(), queue.end(), &request));
+        }
+        Finish(request, IOStatus::Cancelled);
+        return true;
+    }
+
+    void FileSystem::Wait(const ReadRequest& request) {
+        std::unique_lock<std::mutex> lock(m_DoneMutex);
+        m_DoneCondition.wait(lock, [&] { return IsDone(request); });
+    }
+
+    ReadRequest* FileSystem::PopQueued() {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        for (uint32_t priority = kIOPriorityCount; priority-- > 0;) {
+            std::deque<ReadRequest*>& queue = m_Queues[priority];
+            if (!queue.empty()) {
+                ReadRequest* request = queue.front();
+                queue.pop_front();
+                request->status.store(IOStatus::InFlight, std::memory_order_relaxed);
+                return request;
+            }
+        }
+        return nullptr;
+    }
+
+    void FileSystem::Finish(ReadRequest& request, IOStatus status) {
+        if (request.onComplete)
+            request.onComplete(request, status);
+        m_Pending.fetch_sub(1, std::memory_order_relaxed);
+        {
+            // Under the lock, so a waiter cannot miss the notification
+            std::lock_guard<std::mutex> lock(m_DoneMutex);
+            request.status.store(status, std::memory_order_release);
+        }
+        m_DoneCondition.notify_all();
+    }
+
+    bool FileSystem::Mount(const std::string& archivePath) {
+        auto archive = std::make_unique<Archive>();
+        if (!archive->Open(archivePath)) {
+            LOG_ENGINE_ERROR("[FileSystem] Cannot mount '{}': missing or not an archive.", archivePath);
+            return false;
+        }
+        LOG_ENGINE_INFO("[FileSystem] Mounted '{}' ({} entries).", archivePath, archive->GetEntryCount());
+        m_Archives.push_back(std::move(archive));
+        return true;
+    }
+
+    const Archive* FileSystem::FindEntry(const std::string& normalized, const ArchiveEntry*& outEntry) const {
+        for (auto it = m_Archives.rbegin(); it != m_Archives.rend(); ++it) {
+            if ((outEntry = (*it)->Find(normalized)) != nullptr)
+                return it->get();
+        }
+        return nullptr;
+    }
+
+    bool FileSystem::OpenView(const std::string& path, FileView& outView) const {
+        const std::string normalized = NormalizePath(path);
+        if (!m_LooseRoot.empty()) {
+            auto file = std::make_shared<MappedFile>();
+            if (file->Open(m_LooseRoot + "/" + normalized)) {
+                outView.data = file->GetData();
+                outView.size = file->GetSize();
+                outView.looseFile = std::move(file);
+                return true;
+            }
+        }
+        const ArchiveEntry* entry = nullptr;
+        const Archive* archive = FindEntry(normalized, entry);
+        if (!archive || entry->codec != Codec::None)
+            return false;
+        const ArchiveView view = archive->GetData(*entry);
+        outView = { view.data, view.size, nullptr };
+        return true;
+    }
+
+    bool FileSystem::OpenView(uint64_t pathHash, FileView& outView) const {
+        for (auto it = m_Archives.rbegin(); it != m_Archives.rend(); ++it) {
+            if (const ArchiveEntry* entry = (*it)->Find(pathHash)) {
+                if (entry->codec != Codec::None)
+                    return false;
+                const ArchiveView view = (*it)->GetData(*entry);
+                outView = { view.data, view.size, nullptr };
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ----------------------------------------------------------
+    // COMPRESSED ENTRIES
+    // ----------------------------------------------------------
+
+    bool FileSystem::GetEntrySize(const std::string& path, uint64_t& outSize) const {
+        const std::string normalized = NormalizePath(path);
+        if (!m_LooseRoot.empty() && GetFileSize(m_LooseRoot + "/" + normalized, outSize))
+            return true;
+        const ArchiveEntry* entry = nullptr;
+        if (!FindEntry(normalized, entry))
+            return false;
+        outSize = entry->rawSize;
+        return true;
+    }
+
+    bool FileSystem::ReadEntry(const std::string& path, void* destination, uint64_t capacity, IOPriority priority) {
+        const std::string normalized = NormalizePath(path);
+        if (!m_LooseRoot.empty()) {
+            MappedFile file;
+            if (file.Open(m_LooseRoot + "/" + normalized)) {
+                if (file.GetSize() > capacity)
+                    return false;
+                std::memcpy(destination, file.GetData(), static_cast<size_t>(file.GetSize()));
+                return true;
+            }
+        }
+        const ArchiveEntry* entry = nullptr;
+        const Archive* archive = FindEntry(normalized, entry);
+        if (!archive || entry->rawSize > capacity)
+            return false;
+        if (entry->codec == Codec::None)
+            return archive->Extract(*entry, static_cast<uint8_t*>(destination));
+        if (!StreamEntry(*archive, *entry, static_cast<uint8_t*>(destination), priority)) {
+            LOG_ENGINE_ERROR("[FileSystem] Cannot read '{}' from '{}': corrupt or unreadable.", normalized, archive->GetFilePath());
+            return false;
+        }
+        return true;
+    }
+
+    bool FileSystem::StreamEntry(const Archive& archive, const ArchiveEntry& entry, uint8_t* destination, IOPriority priority) {
+        ProfileScope scope("FileSystem::StreamEntry");
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+
+        // The block table is small and at the front, so it comes from the mapping
+        const ArchiveView stored = archive.GetData(entry);
+        const uint32_t blockCount = GetBlockCount(entry.rawSize);
+        const uint64_t tableSize = sizeof(uint32_t) * (uint64_t(1) + blockCount);
+        uint32_t storedCount = 0;
+        if (stored.size < tableSize || (std::memcpy(&storedCount, stored.data, sizeof(storedCount)), storedCount != blockCount))
+            return false;
+        std::vector<uint32_t> ends(blockCount);
+        std::memcpy(ends.data(), stored.data + sizeof(uint32_t), ends.size() * sizeof(uint32_t));
+        for (uint32_t block = 0; block < blockCount; ++block) {
+            if ((block > 0 && ends[block] < ends[block - 1]) || ends[block] > stored.size - tableSize)
+                return false;
+        }
+        auto blockBegin = [&](uint32_t block) { return block == 0 ? 0u : ends[block - 1]; };
+
+        // Windows of whole blocks, each read into its place in one staging buffer
+        std::vector<uint8_t> staging(static_cast<size_t>(stored.size - tableSize));
+        std::vector<std::pair<uint32_t, uint32_t>> windows;   // First block, end block
+        for (uint32_t first = 0; first < blockCount;) {
+            uint32_t last = first + 1;
+            while (last < blockCount && ends[last - 1] - blockBegin(first) < kStreamWindowSize)
+                ++last;
+            windows.emplace_back(first, last);
+            first = last;
+        }
+
+        std::unique_ptr<ReadRequest[]> requests(new ReadRequest[windows.size()]);
+        Threading::JobContext ctx;
+        std::atomic<bool> failed{ false };
+        std::atomic<int64_t> readNs{ 0 };
+        std::atomic<int64_t> decompressNs{ 0 };
+
+        auto decompress = [&](uint32_t block) {
+            const Clock::time_point blockStart = Clock::now();
+            const uint32_t begin = blockBegin(block);
+            const size_t storedSize = ends[block] - begin;
+            const size_t rawSize = GetBlockRawSize(entry.rawSize, block);
+            if (!DecompressBlock(GetBlockCodec(entry.codec, storedSize, rawSize), staging.data() + begin, storedSize,
+                                 destination + uint64_t(block) * kCompressionBlockSize, rawSize))
+                failed.store(true, std::memory_order_relaxed);
+            decompressNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - blockStart).count(),
+                                   std::memory_order_relaxed);
+        };
+
+        for (size_t i = 0; i < windows.size(); ++i) {
+            const auto [first, last] = windows[i];
+            ReadRequest& request = requests[i];
+            request.path = archive.GetFilePath();
+            request.offset = entry.offset + tableSize + blockBegin(first);
+            request.size = ends[last - 1] - blockBegin(first);
+            request.buffer = staging.data() + blockBegin(first);
+            request.priority = priority;
+            request.onComplete = [&, first = first, last = last](ReadRequest& done, IOStatus status) {
+                const int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                int64_t latest = readNs.load(std::memory_order_relaxed);
+                while (latest < elapsed && !readNs.compare_exchange_weak(latest, elapsed, std::memory_order_relaxed)) {}
+                if (status != IOStatus::Completed || done.bytesRead != done.size) {
+                    failed.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                // Hand the blocks to the workers; the IO thread goes back to reading
+                for (uint32_t block = first; block < last; ++block)
+                    Threading::JobSystem::Execute(ctx, [&decompress, block] { decompress(block); });
+            };
+            Read(request);
+        }
+        // Every job is queued before its read reports done, so this joins them all
+        for (size_t i = 0; i < windows.size(); ++i)
+            Wait(requests[i]);
+        Threading::JobSystem::Wait(ctx);
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double mebibytes = double(entry.rawSize) / (1024.0 * 1024.0);
+        Profiling::SetCounter("IO.ReadMBps", double(stored.size) / (1024.0 * 1024.0) / std::max(readNs.load() * 1e-9, 1e-9));
+        Profiling::SetCounter("IO.DecompressMBps", mebibytes / std::max(decompressNs.load() * 1e-9, 1e-9));
+        Profiling::SetCounter("IO.EndToEndMBps", mebibytes / std::max(seconds, 1e-9));
+        return !failed.load();
+    }
+
+    void FileSystem::FreeBuffer(void* data) {
+        if (data)
+            MemoryManager::GetInstance().Deallocate(data);
+    }
+
+    bool FileSystem::GetFileSize(const std::string& path, uint64_t& outSize) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        outSize = static_cast<uint64_t>(file.tellg());
+        return true;
+    }
+
+    bool FileSystem::ReadFile(const std::string& path, std::vector<uint8_t>& outData) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        outData.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(outData.data()), static_cast<std::streamsize>(outData.size())));
+    }
+
+} // namespace IO
@@ -0,0 +1,644 @@
+#include "IO/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace IO {
+
+    // ----------------------------------------------------------
+    // VERTEX CACHE (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+    // ----------------------------------------------------------
+
+    namespace {
+
+        constexpr int kCacheSize = 32;
+
+        float VertexScore(int cachePosition, uint32_t remainingTriangles) {
+            if (remainingTriangles == 0)
+                return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0) {
+                // The last triangle's vertices get a fixed score so the next
+                // triangle does not simply reuse the same edge
+                score = (cachePosition < 3) ? 0.75f
+                      : std::pow(1.0f - static_cast<float>(cachePosition - 3) / (kCacheSize - 3), 1.5f);
+            }
+            // Prefer vertices with few triangles left, to finish them off
+            return score + 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+        }
+
+    } // namespace
+
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0)
+            return;
+
+        // Vertex -> triangle adjacency; the live range shrinks as triangles are emitted
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+            offsets[indices[i] + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+
+        std::vector<uint32_t> remaining(vertexCount);
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        for (size_t v = 0; v < vertexCount; ++v)
+            remaining[v] = offsets[v + 1] - offsets[v];
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < triangleCount * 3; ++i)
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<int>   cachePosition(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+            vertexScore[v] = VertexScore(-1, remaining[v]);
+
+        std::vector<float>   triangleScore(triangleCount);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        for (size_t t = 0; t < triangleCount; ++t)
+            triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+        std::vector<uint32_t> output;
+        output.reserve(triangleCount * 3);
+
+        uint32_t cache[kCacheSize + 3];
+        int cacheCount = 0;
+        size_t cursor = 0; // Dead-end fallback: next triangle in input order
+
+        int64_t best = static_cast<int64_t>(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+
+        for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+            if (best < 0) {
+                while (emitted[cursor])
+                    ++cursor;
+                best = static_cast<int64_t>(cursor);
+            }
+
+            const uint32_t t = static_cast<uint32_t>(best);
+            const uint32_t tri[3] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+            output.insert(output.end(), tri, tri + 3);
+            emitted[t] = 1;
+
+            // Detach the triangle from its vertices
+            for (uint32_t v : tri) {
+                uint32_t* begin = adjacency.data() + offsets[v];
+                uint32_t* end = begin + remaining[v];
+                uint32_t* it = std::find(begin, end, t);
+                if (it != end) {
+                    *it = *(end - 1);
+                    --remaining[v];
+                }
+            }
+
+            // New LRU order: this triangle first, then the previous entries
+            uint32_t newCache[kCacheSize + 6];
+            int newCount = 0;
+            for (uint32_t v : tri) {
+                if (std::find(newCache, newCache + newCount, v) == newCache + newCount)
+                    newCache[newCount++] = v;
+            }
+            for (int i = 0; i < cacheCount; ++i) {
+                if (std::find(tri, tri + 3, cache[i]) == tri + 3)
+                    newCache[newCount++] = cache[i];
+            }
+
+            // Rescore every vertex that moved or fell out, and their triangles
+            for (int i = 0; i < newCount; ++i) {
+                const uint32_t v = newCache[i];
+                cachePosition[v] = (i < kCacheSize) ? i : -1;
+                const float score = VertexScore(cachePosition[v], remaining[v]);
+                const float delta = score - vertexScore[v];
+                vertexScore[v] = score;
+                for (uint32_t a = 0; a < remaining[v]; ++a)
+                    triangleScore[adjacency[offsets[v] + a]] += delta;
+            }
+
+            cacheCount = std::min(newCount, kCacheSize);
+            for (int i = 0; i < cacheCount; ++i)
+                cache[i] = newCache[i];
+
+            // Best candidate among the triangles touching the cache
+            best = -1;
+            float bestScore = -1.0f;
+            for (int i = 0; i < cacheCount; ++i) {
+                const uint32_t v = cache[i];
+                for (uint32_t a = 0; a < remaining[v]; ++a) {
+                    const uint32_t candidate = adjacency[offsets[v] + a];
+                    if (triangleScore[candidate] > bestScore) {
+                        bestScore = triangleScore[candidate];
+                        best = candidate;
+                    }
+                }
+            }
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    float ComputeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+        if (indexCount < 3)
+            return 0.0f;
+
+        // FIFO: a vertex hits while fewer than cacheSize misses happened since it was loaded
+        std::vector<uint64_t> loadedAt(vertexCount, 0);
+        uint64_t misses = 0;
+        for (size_t i = 0; i < indexCount; ++i) {
+            const uint32_t v = indices[i];
+            if (loadedAt[v] == 0 || misses - loadedAt[v] >= cacheSize) {
+                ++misses;
+                loadedAt[v] = misses;
+            }
+        }
+        return static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+    }
+
+    size_t OptimizeVertexFetch(MeshData& mesh) {
+        constexpr uint32_t kUnused = 0xFFFFFFFFu;
+        std::vector<uint32_t> remap(mesh.vertices.size(), kUnused);
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+
+        for (uint32_t& index : mesh.indices) {
+            if (remap[index] == kUnused) {
+                remap[index] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        mesh.vertices.swap(vertices);
+        return mesh.vertices.size();
+    }
+
+    // ----------------------------------------------------------
+    // QUANTIZATION
+    // ----------------------------------------------------------
+
+    uint16_t FloatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+        if (magnitude >= 0x7F800000u) // Inf / NaN
+            return sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u);
+        if (magnitude >= 0x477FF000u) // Rounds past the largest half
+            return sign | 0x7C00u;
+        if (magnitude < 0x38800000u) { // Half subnormal (or zero)
+            float f;
+            std::memcpy(&f, &magnitude, sizeof(f));
+            return sign | static_cast<uint16_t>(std::lrint(f * 16777216.0f));
+        }
+
+        // Rebias the exponent (127 -> 15) and round the mantissa to nearest even
+        uint32_t half = (magnitude - 0x38000000u) >> 13;
+        const uint32_t rest = magnitude & 0x1FFFu;
+        if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+            ++half;
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    float HalfToFloat(uint16_t value) {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1Fu;
+        const uint32_t mantissa = value & 0x3FFu;
+
+        if (exponent == 0) {
+            const float f = static_cast<float>(mantissa) / 16777216.0f;
+            return sign ? -f : f;
+        }
+
+        const uint32_t bits = (exponent == 31) ? (sign | 0x7F800000u | (mantissa << 13))
+                                               : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    namespace {
+
+        int8_t ToSnorm8(float v) {
+            return static_cast<int8_t>(std::lrint(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+        }
+
+        float SignNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+    } // namespace
+
+    QuantizedMesh Quantize(const MeshData& mesh) {
+        QuantizedMesh result;
+        if (mesh.vertices.empty())
+            return result;
+
+        Math::Vec3 lo = mesh.vertices[0].position, hi = lo;
+        for (const MeshVertex& v : mesh.vertices) {
+            lo = Math::Min(lo, v.position);
+            hi = Math::Max(hi, v.position);
+        }
+        Math::Vec3 size = hi - lo;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (!(size[axis] > 0.0f))
+                size[axis] = 1.0f;
+        }
+        result.positionOffset = lo;
+        result.positionScale = size;
+
+        result.vertices.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+            const MeshVertex& v = mesh.vertices[i];
+            QuantizedVertex& q = result.vertices[i];
+
+            for (int axis = 0; axis < 3; ++axis) {
+                const float t = (v.position[axis] - lo[axis]) / size[axis];
+                q.position[axis] = static_cast<uint16_t>(std::lrint(std::clamp(t, 0.0f, 1.0f) * 65535.0f));
+            }
+
+            // Octahedral mapping: project onto |x|+|y|+|z| = 1 and fold the lower half
+            const Math::Vec3& n = v.normal;
+            const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+            float ox = (l1 > 0.0f) ? n.x / l1 : 0.0f;
+            float oy = (l1 > 0.0f) ? n.y / l1 : 0.0f;
+            if (n.z < 0.0f) {
+                const float fx = (1.0f - std::fabs(oy)) * SignNotZero(ox);
+                const float fy = (1.0f - std::fabs(ox)) * SignNotZero(oy);
+                ox = fx;
+                oy = fy;
+            }
+            q.normal[0] = ToSnorm8(ox);
+            q.normal[1] = ToSnorm8(oy);
+
+            q.uv[0] = FloatToHalf(v.u);
+            q.uv[1] = FloatToHalf(v.v);
+        }
+        return result;
+    }
+
+    MeshVertex Dequantize(const QuantizedMesh& mesh, size_t index) {
+        const QuantizedVertex& q = mesh.vertices[index];
+        MeshVertex v;
+        for (int axis = 0; axis < 3; ++axis)
+            v.position[axis] = mesh.positionOffset[axis] + (q.position[axis] / 65535.0f) * mesh.positionScale[axis];
+
+        float x = q.normal[0] / 127.0f;
+        float y = q.normal[1] / 127.0f;
+        const float z = 1.0f - std::fabs(x) - std::fabs(y);
+        if (z < 0.0f) {
+            const float fx = (1.0f - std::fabs(y)) * SignNotZero(x);
+            const float fy = (1.0f - std::fabs(x)) * SignNotZero(y);
+            x = fx;
+            y = fy;
+        }
+        v.normal = Math::Normalize(Math::Vec3(x, y, z));
+
+        v.u = HalfToFloat(q.uv[0]);
+        v.v = HalfToFloat(q.uv[1]);
+        return v;
+    }
+
+    // ----------------------------------------------------------
+    // SIMPLIFICATION
+    // ----------------------------------------------------------
+
+    namespace {
+
+        // Area-weighted sum of squared plane distances (Garland & Heckbert)
+        struct Quadric {
+            double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+            double b0 = 0, b1 = 0, b2 = 0, c = 0;
+            double weight = 0;
+
+            static Quadric FromPlane(const Math::Vec3& n, float d, double w) {
+                Quadric q;
+                q.a00 = w * n.x * n.x; q.a01 = w * n.x * n.y; q.a02 = w * n.x * n.z;
+                q.a11 = w * n.y * n.y; q.a12 = w * n.y * n.z; q.a22 = w * n.z * n.z;
+                q.b0 = w * n.x * d; q.b1 = w * n.y * d; q.b2 = w * n.z * d;
+                q.c = w * d * d;
+                q.weight = w;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& o) {
+                a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+                b0 += o.b0; b1 += o.b1; b2 += o.b2; c += o.c; weight += o.weight;
+                return *this;
+            }
+
+            // Mean squared distance of p to the accumulated planes
+            double Error(const Math::Vec3& p) const {
+                const double x = p.x, y = p.y, z = p.z;
+                const double e = a00 * x * x + a11 * y * y + a22 * z * z
+                               + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                               + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return (weight > 0.0) ? std::max(0.0, e / weight) : 0.0;
+            }
+        };
+
+        struct PositionKey {
+            uint32_t bits[3];
+            bool operator==(const PositionKey& o) const { return std::memcmp(bits, o.bits, sizeof(bits)) == 0; }
+        };
+
+        struct PositionHash {
+            size_t operator()(const PositionKey& k) const {
+                return (k.bits[0] * 73856093u) ^ (k.bits[1] * 19349663u) ^ (k.bits[2] * 83492791u);
+            }
+        };
+
+        struct Collapse {
+            double   cost;
+            uint32_t source;
+            uint32_t target;
+        };
+
+    } // namespace
+
+    std::vector<uint32_t> Simplify(const MeshData& mesh, const std::vector<uint32_t>& indices,
+                                   size_t targetIndexCount, float* outError) {
+        const size_t vertexCount = mesh.vertices.size();
+        auto position = [&](uint32_t v) -> const Math::Vec3& { return mesh.vertices[v].position; };
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            if (indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i] != indices[i + 2])
+                result.insert(result.end(), { indices[i], indices[i + 1], indices[i + 2] });
+        }
+
+        // 1) Locked vertices: attribute seams (shared positions) and open borders
+        std::vector<uint8_t> locked(vertexCount, 0);
+        {
+            std::unordered_map<PositionKey, uint32_t, PositionHash> firstAt;
+            for (uint32_t index : result) {
+                PositionKey key;
+                std::memcpy(key.bits, &position(index).x, sizeof(key.bits));
+                auto [it, inserted] = firstAt.emplace(key, index);
+                if (!inserted && it->second != index) {
+                    locked[index] = 1;
+                    locked[it->second] = 1;
+                }
+            }
+
+            std::unordered_map<uint64_t, uint32_t> directedEdges;
+            directedEdges.reserve(result.size());
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int e = 0; e < 3; ++e)
+                    directedEdges[(uint64_t(result[i + e]) << 32) | result[i + (e + 1) % 3]]++;
+            }
+            for (const auto& [edge, count] : directedEdges) {
+                const uint32_t a = static_cast<uint32_t>(edge >> 32);
+                const uint32_t b = static_cast<uint32_t>(edge);
+                if (directedEdges.find((uint64_t(b) << 32) | a) == directedEdges.end())
+                    locked[a] = locked[b] = 1;
+            }
+        }
+
+        // 2) Vertex quadrics from the incident triangle planes
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < result.size(); i += 3) {
+            const Math::Vec3& a = position(result[i]);
+            Math::Vec3 n = Math::Cross(position(result[i + 1]) - a, position(result[i + 2]) - a);
+            const float doubleArea = Math::Length(n);
+            if (!(doubleArea > 0.0f))
+                continue;
+            n = n / doubleArea;
+            const Quadric q = Quadric::FromPlane(n, -Math::Dot(n, a), 0.5 * doubleArea);
+            for (int v = 0; v < 3; ++v)
+                quadrics[result[i + v]] += q;
+        }
+
+        // 3) Greedy passes: cheapest independent collapses first
+        double maxError = 0.0;
+        std::vector<uint32_t> offsets, adjacency, remap(vertexCount);
+        std::vector<uint8_t> touched(vertexCount);
+        std::vector<Collapse> collapses;
+
+        while (result.size() > targetIndexCount) {
+            const size_t triangleCount = result.size() / 3;
+
+            offsets.assign(vertexCount + 1, 0);
+            for (uint32_t index : result)
+                offsets[index + 1]++;
+            for (size_t v = 0; v < vertexCount; ++v)
+                offsets[v + 1] += offsets[v];
+            adjacency.resize(result.size());
+            {
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < result.size(); ++i)
+                    adjacency[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int e = 0; e < 3; ++e) {
+                    const uint32_t a = result[i + e];
+                    const uint32_t b = result[i + (e + 1) % 3];
+                    // Each interior edge is seen from both sides; consider a -> b here
+                    if (locked[a])
+                        continue;
+                    Quadric q = quadrics[a];
+                    q += quadrics[b];
+                    collapses.push_back({ q.Error(position(b)), a, b });
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) {
+                return x.cost < y.cost || (x.cost == y.cost && (x.source < y.source || (x.source == y.source && x.target < y.target)));
+            });
+
+            std::iota(remap.begin(), remap.end(), 0u);
+            std::fill(touched.begin(), touched.end(), 0);
+            const size_t trianglesToRemove = triangleCount - targetIndexCount / 3;
+            size_t removed = 0;
+            size_t applied = 0;
+
+            for (const Collapse& collapse : collapses) {
+                if (removed >= trianglesToRemove)
+                    break;
+                if (touched[collapse.source] || touched[collapse.target])
+                    continue;
+
+                // Reject collapses that flip or squash a surviving triangle
+                bool valid = true;
+                size_t vanishing = 0;
+                const Math::Vec3& to = position(collapse.target);
+                for (uint32_t a = offsets[collapse.source]; a < offsets[collapse.source + 1] && valid; ++a) {
+                    const uint32_t* tri = &result[adjacency[a] * 3];
+                    if (tri[0] == collapse.target || tri[1] == collapse.target || tri[2] == collapse.target) {
+                        ++vanishing;
+                        continue;
+                    }
+                    Math::Vec3 p[3], q[3];
+                    for (int v = 0; v < 3; ++v) {
+                        p[v] = position(tri[v]);
+                        q[v] = (tri[v] == collapse.source) ? to : p[v];
+                    }
+                    const Math::Vec3 before = Math::Cross(p[1] - p[0], p[2] - p[0]);
+                    const Math::Vec3 after = Math::Cross(q[1] - q[0], q[2] - q[0]);
+                    valid = Math::Dot(before, after) > 0.25f * Math::Length(before) * Math::Length(after)
+                         && Math::Dot(after, after) > 0.0f;
+                }
+                if (!valid || vanishing == 0)
+                    continue;
+
+                remap[collapse.source] = collapse.target;
+                quadrics[collapse.target] += quadrics[collapse.source];
+                maxError = std::max(maxError, collapse.cost);
+                removed += vanishing;
+                ++applied;
+
+                // The one-ring changes shape; keep it out of this pass
+                touched[collapse.source] = touched[collapse.target] = 1;
+                for (uint32_t a = offsets[collapse.source]; a < offsets[collapse.source + 1]; ++a) {
+                    const uint32_t* tri = &result[adjacency[a] * 3];
+                    touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+                }
+            }
+
+            if (applied == 0)
+                break;
+
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3) {
+                const uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (a == b || b == c || a == c)
+                    continue;
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if (outError)
+            *outError = static_cast<float>(std::sqrt(maxError));
+        return result;
+    }
+
+    // ----------------------------------------------------------
+    // MESHLETS
+    // ----------------------------------------------------------
+
+    namespace {
+
+        void FinishMeshlet(const MeshData& mesh, MeshletData& data, Meshlet& meshlet) {
+            if (meshlet.triangleCount == 0)
+                return;
+
+            const uint32_t* vertices = data.vertices.data() + meshlet.vertexOffset;
+            const uint8_t* triangles = data.triangles.data() + meshlet.triangleOffset;
+
+            // Bounding sphere around the box centre
+            Math::Vec3 lo = mesh.vertices[vertices[0]].position, hi = lo;
+            for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+                lo = Math::Min(lo, mesh.vertices[vertices[i]].position);
+                hi = Math::Max(hi, mesh.vertices[vertices[i]].position);
+            }
+            meshlet.center = (lo + hi) * 0.5f;
+            meshlet.radius = 0.0f;
+            for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+                meshlet.radius = std::max(meshlet.radius, Math::Length(mesh.vertices[vertices[i]].position - meshlet.center));
+
+            // Normal cone: average face normal and the widest deviation from it
+            std::vector<Math::Vec3> normals;
+            normals.reserve(meshlet.triangleCount);
+            Math::Vec3 axis(0.0f);
+            for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+                const Math::Vec3& a = mesh.vertices[vertices[triangles[t * 3]]].position;
+                const Math::Vec3& b = mesh.vertices[vertices[triangles[t * 3 + 1]]].position;
+                const Math::Vec3& c = mesh.vertices[vertices[triangles[t * 3 + 2]]].position;
+                const Math::Vec3 n = Math::Cross(b - a, c - a);
+                const float length = Math::Length(n);
+                if (length > 0.0f) {
+                    normals.push_back(n / length);
+                    axis += normals.back();
+                }
+            }
+
+            meshlet.coneAxis = Math::Vec3(0.0f, 0.0f, 1.0f);
+            meshlet.coneCutoff = 1.0f;
+            const float axisLength = Math::Length(axis);
+            if (normals.empty() || axisLength < 1e-6f)
+                return;
+
+            meshlet.coneAxis = axis / axisLength;
+            float minDot = 1.0f;
+            for (const Math::Vec3& n : normals)
+                minDot = std::min(minDot, Math::Dot(n, meshlet.coneAxis));
+            if (minDot > 0.0f)
+                meshlet.coneCutoff = std::sqrt(std::max(0.0f, 1.0f - minDot * minDot));
+        }
+
+    } // namespace
+
+    MeshletData BuildMeshlets(const MeshData& mesh, const uint32_t* indices, size_t indexCount,
+                              uint32_t maxVertices, uint32_t maxTriangles) {
+        maxVertices = std::clamp(maxVertices, 3u, 255u);
+        maxTriangles = std::max(maxTriangles, 1u);
+
+        MeshletData data;
+        constexpr uint8_t kNotInMeshlet = 0xFF;
+        std::vector<uint8_t> local(mesh.vertices.size(), kNotInMeshlet);
+
+        Meshlet current;
+        auto flush = [&]() {
+            FinishMeshlet(mesh, data, current);
+            if (current.triangleCount > 0)
+                data.meshlets.push_back(current);
+            for (uint32_t i = 0; i < current.vertexCount; ++i)
+                local[data.vertices[current.vertexOffset + i]] = kNotInMeshlet;
+
+            current = Meshlet();
+            current.vertexOffset = static_cast<uint32_t>(data.vertices.size());
+            current.triangleOffset = static_cast<uint32_t>(data.triangles.size());
+        };
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3) {
+            uint32_t newVertices = 0;
+            for (int v = 0; v < 3; ++v)
+                newVertices += (local[indices[i + v]] == kNotInMeshlet) ? 1 : 0;
+            if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles)
+                flush();
+
+            for (int v = 0; v < 3; ++v) {
+                const uint32_t index = indices[i + v];
+                if (local[index] == kNotInMeshlet) {
+                    local[index] = static_cast<uint8_t>(current.vertexCount++);
+                    data.vertices.push_back(index);
+                }
+                data.triangles.push_back(local[index]);
+            }
+            current.triangleCount++;
+        }
+        flush();
+        return data;
+    }
+
+    bool IsMeshletBackfacing(const Meshlet& meshlet, const Math::Vec3& cameraPosition) {
+        if (meshlet.coneCutoff >= 1.0f)
+            return false;
+
+        // Every triangle plane passes within radius of the centre, so the meshlet is
+        // back-facing if max(n . (camera - centre)) over the cone is below -radius
+        const Math::Vec3 toCamera = cameraPosition - meshlet.center;
+        const float distance = Math::Length(toCamera);
+        if (distance <= meshlet.radius)
+            return false;
+
+        const float cosPhi = Math::Dot(toCamera, meshlet.coneAxis) / distance;
+        const float sinPhi = std::sqrt(std::max(0.0f, 1.0f - cosPhi * cosPhi));
+        const float sinTheta = meshlet.coneCutoff;
+        const float cosTheta = std::sqrt(std::max(0.0f, 1.0f - sinTheta * sinTheta));
+        if (cosPhi >= cosTheta)
+            return false; // The camera direction lies inside the cone
+
+        const float cosDifference = cosPhi * cosTheta + sinPhi * sinTheta;
+        return distance * cosDifference < -meshlet.radius;
+    }
+
+} // namespace IO
@@ -0,0 +1,262 @@
+#include "IO/Streaming.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace IO {
+
+    std::vector<StreamingLevel> BuildMipLevels(uint32_t width, uint32_t height, uint32_t bitsPerTexel, float worldSize,
+                                               uint64_t offset) {
+        std::vector<StreamingLevel> levels;
+        while (true) {
+            StreamingLevel level;
+            level.offset = offset;
+            level.size = (uint64_t(width) * height * bitsPerTexel + 7) / 8;
+            level.error = worldSize / float(std::max(width, height));
+            levels.push_back(level);
+            offset += level.size;
+            if (width == 1 && height == 1)
+                return levels;
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+    }
+
+    std::vector<StreamingLevel> BuildLodLevels(const std::vector<MeshLod>& lods, uint64_t indexOffset) {
+        std::vector<StreamingLevel> levels;
+        for (const MeshLod& lod : lods)
+            levels.push_back({ indexOffset + uint64_t(lod.firstIndex) * sizeof(uint32_t), uint64_t(lod.indexCount) * sizeof(uint32_t), lod.error });
+        return levels;
+    }
+
+    uint32_t SelectStreamingLevel(const std::vector<StreamingLevel>& levels, float distance, const StreamingView& view) {
+        assert(!levels.empty() && "an asset needs at least one level");
+        // Pixels per world unit at this distance
+        const float scale = view.projectionScale / std::max(distance, 1e-3f);
+        uint32_t level = static_cast<uint32_t>(levels.size()) - 1;
+        while (level > 0 && levels[level].error * scale > view.maxPixelError)
+            --level;
+        return level;
+    }
+
+    // ----------------------------------------------------------
+    // STREAMING MANAGER
+    // ----------------------------------------------------------
+
+    namespace {
+
+        // A resident level that may be evicted; lower values go first
+        struct EvictionCandidate {
+            float            value;
+            StreamableHandle handle;
+            uint32_t         level;
+        };
+
+    } // namespace
+
+    StreamingManager::StreamingManager(FileSystem& fileSystem, uint64_t budget, uint32_t maxReadsInFlight)
+        : m_FileSystem(fileSystem), m_Budget(budget), m_MaxReadsInFlight(std::max(maxReadsInFlight, 1u)) {}
+
+    StreamingManager::~StreamingManager() {
+        for (Asset& asset : m_Assets) {
+            if (asset.loading && !m_FileSystem.Cancel(*asset.request))
+                m_FileSystem.Wait(*asset.request);
+        }
+        ApplyCompletions();
+        for (Asset& asset : m_Assets) {
+            for (void* data : asset.data)
+                FileSystem::FreeBuffer(data);
+        }
+    }
+
+    StreamableHandle StreamingManager::Register(const std::string& path, std::vector<StreamingLevel> levels,
+                                                const Math::Vec3& center, float radius) {
+        assert(!levels.empty() && "an asset needs at least one level");
+        Asset asset;
+        asset.path = path;
+        asset.data.assign(levels.size(), nullptr);
+        asset.residentLevel = asset.wantedLevel = static_cast<uint32_t>(levels.size());
+        asset.levels = std::move(levels);
+        asset.center = center;
+        asset.radius = radius;
+        asset.request = std::make_unique<ReadRequest>();
+        m_Assets.push_back(std::move(asset));
+        return static_cast<StreamableHandle>(m_Assets.size() - 1);
+    }
+
+    const void* StreamingManager::GetLevelData(StreamableHandle handle, uint32_t level) const {
+        const Asset& asset = m_Assets[handle];
+        return level < asset.data.size() ? asset.data[level] : nullptr;
+    }
+
+    void StreamingManager::ApplyCompletions() {
+        std::vector<Completion> completions;
+        {
+            std::lock_guard<std::mutex> lock(m_CompletionMutex);
+            completions.swap(m_Completions);
+        }
+        for (const Completion& completion : completions) {
+            Asset& asset = m_Assets[completion.handle];
+            ReadRequest& request = *asset.request;
+            // The callback runs just before the status is published
+            m_FileSystem.Wait(request);
+            const StreamingLevel& level = asset.levels[asset.loadingLevel];
+            asset.loading = false;
+            --m_ReadsInFlight;
+            m_Stats.pendingBytes -= level.size;
+
+            if (completion.status == IOStatus::Completed && request.bytesRead == level.size) {
+                asset.data[asset.loadingLevel] = request.data;
+                asset.residentLevel = asset.loadingLevel;
+                m_Stats.residentBytes += level.size;
+                m_Stats.bytesStreamed += level.size;
+            } else if (completion.status == IOStatus::Cancelled) {
+                ++m_Stats.readsCancelled;
+            } else {
+                FileSystem::FreeBuffer(request.data);
+                asset.failed = true;
+                LOG_ENGINE_ERROR("[Streaming] Cannot read level {} of '{}'; it stays at level {}.", asset.loadingLevel, asset.path,
+                                 asset.residentLevel);
+            }
+        }
+    }
+
+    void StreamingManager::Issue(StreamableHandle handle) {
+        Asset& asset = m_Assets[handle];
+        const uint32_t level = asset.residentLevel - 1;
+        ReadRequest& request = *asset.request;
+        request.path = asset.path;
+        request.offset = asset.levels[level].offset;
+        request.size = asset.levels[level].size;
+        request.buffer = nullptr;
+        // Nothing resident yet, or far from the wanted detail: needed now
+        const uint32_t deficit = level - asset.wantedLevel;
+        request.priority = asset.residentLevel == asset.levels.size() ? IOPriority::Critical
+                         : deficit >= 2                               ? IOPriority::High
+                         : deficit == 1                               ? IOPriority::Normal
+                                                                      : IOPriority::Low;
+        request.onComplete = [this, handle](ReadRequest&, IOStatus status) {
+            std::lock_guard<std::mutex> lock(m_CompletionMutex);
+            m_Completions.push_back({ handle, status });
+        };
+        asset.loading = true;
+        asset.loadingLevel = level;
+        ++m_ReadsInFlight;
+        ++m_Stats.readsIssued;
+        m_Stats.pendingBytes += request.size;
+        m_FileSystem.Read(request);
+    }
+
+    void StreamingManager::Update(const StreamingView& view) {
+        ProfileScope scope("StreamingManager::Update");
+        ApplyCompletions();
+
+        // Wanted detail; queued reads that are no longer wanted are dropped
+        for (Asset& asset : m_Assets) {
+            const float distance = Math::Length(asset.center - view.position);
+            asset.screenSize = asset.radius * view.projectionScale / std::max(distance, 1e-3f);
+            asset.wantedLevel = SelectStreamingLevel(asset.levels, distance - asset.radius, view);
+            const bool firstLevel = asset.loadingLevel == asset.levels.size() - 1;
+            if (asset.loading && !firstLevel && asset.loadingLevel < asset.wantedLevel)
+                m_FileSystem.Cancel(*asset.request);
+        }
+        ApplyCompletions();
+
+        // Evictable levels, least useful first: finer than wanted, then the smallest assets on screen
+        std::vector<EvictionCandidate> candidates;
+        std::vector<uint64_t> freedBefore;
+        size_t nextCandidate = 0;
+        bool candidatesBuilt = false;
+        auto makeRoom = [&](uint64_t bytes, float keepAbove) {
+            const uint64_t used = m_Stats.residentBytes + m_Stats.pendingBytes + bytes;
+            if (used <= m_Budget)
+                return true;
+            if (!candidatesBuilt) {
+                candidatesBuilt = true;
+                for (StreamableHandle handle = 0; handle < m_Assets.size(); ++handle) {
+                    const Asset& asset = m_Assets[handle];
+                    if (asset.loading)
+                        continue;
+                    for (uint32_t level = asset.residentLevel; level + 1 < asset.levels.size(); ++level) {
+                        const float value = level < asset.wantedLevel ? -1.0f / (1.0f + asset.screenSize) : asset.screenSize;
+                        candidates.push_back({ value, handle, level });
+                    }
+                }
+                std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& a, const EvictionCandidate& b) {
+                    if (a.value != b.value)
+                        return a.value < b.value;
+                    return a.handle != b.handle ? a.handle < b.handle : a.level < b.level;
+                });
+                freedBefore.resize(candidates.size() + 1, 0);
+                for (size_t i = 0; i < candidates.size(); ++i)
+                    freedBefore[i + 1] = freedBefore[i] + m_Assets[candidates[i].handle].levels[candidates[i].level].size;
+            }
+
+            // Only evict if it is enough
+            const uint64_t needed = used - m_Budget;
+            const size_t limit = std::lower_bound(candidates.begin() + nextCandidate, candidates.end(), keepAbove,
+                                                  [](const EvictionCandidate& c, float value) { return c.value < value; }) -
+                                 candidates.begin();
+            if (freedBefore[limit] - freedBefore[nextCandidate] < needed)
+                return false;
+            const uint64_t target = freedBefore[nextCandidate] + needed;
+            while (freedBefore[nextCandidate] < target) {
+                const EvictionCandidate& candidate = candidates[nextCandidate++];
+                Asset& asset = m_Assets[candidate.handle];
+                assert(!asset.loading && asset.residentLevel == candidate.level && "levels are evicted finest first");
+                FileSystem::FreeBuffer(asset.data[candidate.level]);
+                asset.data[candidate.level] = nullptr;
+                asset.residentLevel = candidate.level + 1;
+                m_Stats.residentBytes -= asset.levels[candidate.level].size;
+                m_Stats.bytesEvicted += asset.levels[candidate.level].size;
+            }
+            return true;
+        };
+        makeRoom(0, std::numeric_limits<float>::infinity());
+
+        // Next finer level of every asset short of its wanted detail; first levels, then largest on screen
+        std::vector<StreamableHandle> wanting;
+        for (StreamableHandle handle = 0; handle < m_Assets.size(); ++handle) {
+            const Asset& asset = m_Assets[handle];
+            if (!asset.loading && !asset.failed && asset.residentLevel > asset.wantedLevel)
+                wanting.push_back(handle);
+        }
+        std::sort(wanting.begin(), wanting.end(), [this](StreamableHandle a, StreamableHandle b) {
+            const bool firstA = m_Assets[a].residentLevel == m_Assets[a].levels.size();
+            const bool firstB = m_Assets[b].residentLevel == m_Assets[b].levels.size();
+            if (firstA != firstB)
+                return firstA;
+            return m_Assets[a].screenSize > m_Assets[b].screenSize;
+        });
+        for (StreamableHandle handle : wanting) {
+            if (m_ReadsInFlight >= m_MaxReadsInFlight)
+                break;
+            const Asset& asset = m_Assets[handle];
+            // First levels are always read, whatever the budget
+            const bool first = asset.residentLevel == asset.levels.size();
+            if (first || makeRoom(asset.levels[asset.residentLevel - 1].size, asset.screenSize))
+                Issue(handle);
+        }
+
+        m_Stats.missingBytes = 0;
+        m_Stats.assetsAtWantedLevel = 0;
+        for (const Asset& asset : m_Assets) {
+            if (asset.residentLevel <= asset.wantedLevel) {
+                ++m_Stats.assetsAtWantedLevel;
+                continue;
+            }
+            for (uint32_t level = asset.wantedLevel; level < asset.residentLevel; ++level) {
+                if (!asset.loading || level != asset.loadingLevel)
+                    m_Stats.missingBytes += asset.levels[level].size;
+            }
+        }
+        Profiling::SetCounter("Streaming.ResidentBytes", double(m_Stats.residentBytes));
+        Profiling::SetCounter("Streaming.PendingBytes", double(m_Stats.pendingBytes));
+        Profiling::SetCounter("Streaming.MissingBytes", double(m_Stats.missingBytes));
+        Profiling::SetCounter("Streaming.BytesStreamed", double(m_Stats.bytesStreamed));
+    }
+
+} // namespace IO
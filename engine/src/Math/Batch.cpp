@@ -0,0 +1,301 @@
+#include "Math/Batch.h"
+
+namespace Math {
+
+    namespace {
+
+        // For one plane, the SoA arrays holding the p-vertex coordinate per axis:
+        // max when the normal points along the axis, min otherwise
+        struct PlaneVertexArrays {
+            const float* x;
+            const float* y;
+            const float* z;
+        };
+
+        PlaneVertexArrays PositiveVertex(const Plane& plane, const AABBSoA& boxes, size_t offset) {
+            return { (plane.normal.x >= 0.0f ? boxes.maxX : boxes.minX) + offset,
+                     (plane.normal.y >= 0.0f ? boxes.maxY : boxes.minY) + offset,
+                     (plane.normal.z >= 0.0f ? boxes.maxZ : boxes.minZ) + offset };
+        }
+
+        AABBSoA Offset(const AABBSoA& boxes, size_t offset) {
+            return { boxes.minX + offset, boxes.minY + offset, boxes.minZ + offset,
+                     boxes.maxX + offset, boxes.maxY + offset, boxes.maxZ + offset };
+        }
+
+    } // namespace
+
+    // ----------------------------------------------------------
+    // SCALAR REFERENCE
+    // ----------------------------------------------------------
+
+    namespace Scalar {
+
+        void TransformPoints(const Mat4& m, const ConstPointsSoA& in, const PointsSoA& out, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const float x = in.x[i], y = in.y[i], z = in.z[i];
+                out.x[i] = m.At(0, 0) * x + m.At(0, 1) * y + m.At(0, 2) * z + m.At(0, 3);
+                out.y[i] = m.At(1, 0) * x + m.At(1, 1) * y + m.At(1, 2) * z + m.At(1, 3);
+                out.z[i] = m.At(2, 0) * x + m.At(2, 1) * y + m.At(2, 2) * z + m.At(2, 3);
+            }
+        }
+
+        void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Multiply(a[i], b[i]);
+        }
+
+        size_t OverlapAABBs(const AABB& query, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+            size_t written = 0;
+            for (size_t i = 0; i < count; ++i) {
+                bool overlap = boxes.minX[i] <= query.max.x && boxes.maxX[i] >= query.min.x
+                            && boxes.minY[i] <= query.max.y && boxes.maxY[i] >= query.min.y
+                            && boxes.minZ[i] <= query.max.z && boxes.maxZ[i] >= query.min.z;
+                if (overlap)
+                    outIndices[written++] = static_cast<uint32_t>(i);
+            }
+            return written;
+        }
+
+        size_t CullAABBs(const Frustum& frustum, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+            size_t written = 0;
+            for (size_t i = 0; i < count; ++i) {
+                bool visible = true;
+                for (const Plane& plane : frustum.planes) {
+                    PlaneVertexArrays p = PositiveVertex(plane, boxes, i);
+                    if (plane.normal.x * *p.x + plane.normal.y * *p.y + plane.normal.z * *p.z + plane.d < 0.0f) {
+                        visible = false;
+                        break;
+                    }
+                }
+                if (visible)
+                    outIndices[written++] = static_cast<uint32_t>(i);
+            }
+            return written;
+        }
+
+    } // namespace Scalar
+
+    // ----------------------------------------------------------
+    // SIMD PATHS
+    // ----------------------------------------------------------
+
+#if MATH_SIMD_AVX2
+
+    void TransformPoints(const Mat4& m, const ConstPointsSoA& in, const PointsSoA& out, size_t count) {
+        __m256 r[3][4];
+        for (int row = 0; row < 3; ++row) {
+            for (int c = 0; c < 4; ++c)
+                r[row][c] = _mm256_set1_ps(m.At(row, c));
+        }
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 x = _mm256_loadu_ps(in.x + i);
+            const __m256 y = _mm256_loadu_ps(in.y + i);
+            const __m256 z = _mm256_loadu_ps(in.z + i);
+            float* dst[3] = { out.x + i, out.y + i, out.z + i };
+            __m256 results[3];
+            for (int row = 0; row < 3; ++row) {
+                __m256 v = _mm256_fmadd_ps(r[row][0], x, r[row][3]);
+                v = _mm256_fmadd_ps(r[row][1], y, v);
+                results[row] = _mm256_fmadd_ps(r[row][2], z, v);
+            }
+            // Store after all loads so in and out may alias
+            for (int row = 0; row < 3; ++row)
+                _mm256_storeu_ps(dst[row], results[row]);
+        }
+
+        Scalar::TransformPoints(m, { in.x + i, in.y + i, in.z + i }, { out.x + i, out.y + i, out.z + i }, count - i);
+    }
+
+    void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            // Each A column is duplicated in both 128-bit lanes so two result columns
+            // are produced per instruction
+            const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[0].x));
+            const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[1].x));
+            const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[2].x));
+            const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[i].columns[3].x));
+
+            const __m256 b01 = _mm256_loadu_ps(&b[i].columns[0].x);
+            const __m256 b23 = _mm256_loadu_ps(&b[i].columns[2].x);
+
+            __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+            r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55), r01);
+            r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xAA), r01);
+            r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, 0xFF), r01);
+
+            __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+            r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55), r23);
+            r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xAA), r23);
+            r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, 0xFF), r23);
+
+            _mm256_storeu_ps(&out[i].columns[0].x, r01);
+            _mm256_storeu_ps(&out[i].columns[2].x, r23);
+        }
+    }
+
+    size_t OverlapAABBs(const AABB& query, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+        const __m256 qMinX = _mm256_set1_ps(query.min.x), qMaxX = _mm256_set1_ps(query.max.x);
+        const __m256 qMinY = _mm256_set1_ps(query.min.y), qMaxY = _mm256_set1_ps(query.max.y);
+        const __m256 qMinZ = _mm256_set1_ps(query.min.z), qMaxZ = _mm256_set1_ps(query.max.z);
+
+        size_t written = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 mask = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.minX + i), qMaxX, _CMP_LE_OQ),
+                                        _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxX + i), qMinX, _CMP_GE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_loadu_ps(boxes.minY + i), qMaxY, _CMP_LE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxY + i), qMinY, _CMP_GE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_loadu_ps(boxes.minZ + i), qMaxZ, _CMP_LE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxZ + i), qMinZ, _CMP_GE_OQ));
+
+            int bits = _mm256_movemask_ps(mask);
+            for (int lane = 0; bits != 0 && lane < 8; ++lane) {
+                if (bits & (1 << lane))
+                    outIndices[written++] = static_cast<uint32_t>(i + lane);
+            }
+        }
+
+        size_t tailCount = Scalar::OverlapAABBs(query, Offset(boxes, i), count - i, outIndices + written);
+        for (size_t t = 0; t < tailCount; ++t)
+            outIndices[written + t] += static_cast<uint32_t>(i);
+        return written + tailCount;
+    }
+
+    size_t CullAABBs(const Frustum& frustum, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+        size_t written = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (const Plane& plane : frustum.planes) {
+                PlaneVertexArrays p = PositiveVertex(plane, boxes, i);
+                __m256 dist = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.x), _mm256_loadu_ps(p.x), _mm256_set1_ps(plane.d));
+                dist = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.y), _mm256_loadu_ps(p.y), dist);
+                dist = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.z), _mm256_loadu_ps(p.z), dist);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+
+            int bits = _mm256_movemask_ps(inside);
+            for (int lane = 0; bits != 0 && lane < 8; ++lane) {
+                if (bits & (1 << lane))
+                    outIndices[written++] = static_cast<uint32_t>(i + lane);
+            }
+        }
+
+        size_t tailCount = Scalar::CullAABBs(frustum, Offset(boxes, i), count - i, outIndices + written);
+        for (size_t t = 0; t < tailCount; ++t)
+            outIndices[written + t] += static_cast<uint32_t>(i);
+        return written + tailCount;
+    }
+
+#elif MATH_SIMD_SSE
+
+    void TransformPoints(const Mat4& m, const ConstPointsSoA& in, const PointsSoA& out, size_t count) {
+        __m128 r[3][4];
+        for (int row = 0; row < 3; ++row) {
+            for (int c = 0; c < 4; ++c)
+                r[row][c] = _mm_set1_ps(m.At(row, c));
+        }
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_loadu_ps(in.x + i);
+            const __m128 y = _mm_loadu_ps(in.y + i);
+            const __m128 z = _mm_loadu_ps(in.z + i);
+            float* dst[3] = { out.x + i, out.y + i, out.z + i };
+            __m128 results[3];
+            for (int row = 0; row < 3; ++row) {
+                __m128 v = _mm_add_ps(_mm_mul_ps(r[row][0], x), r[row][3]);
+                v = _mm_add_ps(_mm_mul_ps(r[row][1], y), v);
+                results[row] = _mm_add_ps(_mm_mul_ps(r[row][2], z), v);
+            }
+            // Store after all loads so in and out may alias
+            for (int row = 0; row < 3; ++row)
+                _mm_storeu_ps(dst[row], results[row]);
+        }
+
+        Scalar::TransformPoints(m, { in.x + i, in.y + i, in.z + i }, { out.x + i, out.y + i, out.z + i }, count - i);
+    }
+
+    void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = a[i] * b[i];
+    }
+
+    size_t OverlapAABBs(const AABB& query, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+        const __m128 qMinX = _mm_set1_ps(query.min.x), qMaxX = _mm_set1_ps(query.max.x);
+        const __m128 qMinY = _mm_set1_ps(query.min.y), qMaxY = _mm_set1_ps(query.max.y);
+        const __m128 qMinZ = _mm_set1_ps(query.min.z), qMaxZ = _mm_set1_ps(query.max.z);
+
+        size_t written = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 mask = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(boxes.minX + i), qMaxX),
+                                     _mm_cmpge_ps(_mm_loadu_ps(boxes.maxX + i), qMinX));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_loadu_ps(boxes.minY + i), qMaxY));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_loadu_ps(boxes.maxY + i), qMinY));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_loadu_ps(boxes.minZ + i), qMaxZ));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_loadu_ps(boxes.maxZ + i), qMinZ));
+
+            int bits = _mm_movemask_ps(mask);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (bits & (1 << lane))
+                    outIndices[written++] = static_cast<uint32_t>(i + lane);
+            }
+        }
+
+        size_t tailCount = Scalar::OverlapAABBs(query, Offset(boxes, i), count - i, outIndices + written);
+        for (size_t t = 0; t < tailCount; ++t)
+            outIndices[written + t] += static_cast<uint32_t>(i);
+        return written + tailCount;
+    }
+
+    size_t CullAABBs(const Frustum& frustum, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+        size_t written = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (const Plane& plane : frustum.planes) {
+                PlaneVertexArrays p = PositiveVertex(plane, boxes, i);
+                __m128 dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal.x), _mm_loadu_ps(p.x)), _mm_set1_ps(plane.d));
+                dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal.y), _mm_loadu_ps(p.y)), dist);
+                dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal.z), _mm_loadu_ps(p.z)), dist);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, _mm_setzero_ps()));
+            }
+
+            int bits = _mm_movemask_ps(inside);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (bits & (1 << lane))
+                    outIndices[written++] = static_cast<uint32_t>(i + lane);
+            }
+        }
+
+        size_t tailCount = Scalar::CullAABBs(frustum, Offset(boxes, i), count - i, outIndices + written);
+        for (size_t t = 0; t < tailCount; ++t)
+            outIndices[written + t] += static_cast<uint32_t>(i);
+        return written + tailCount;
+    }
+
+#else
+
+    void TransformPoints(const Mat4& m, const ConstPointsSoA& in, const PointsSoA& out, size_t count) {
+        Scalar::TransformPoints(m, in, out, count);
+    }
+
+    void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+        Scalar::MultiplyMatrices(a, b, out, count);
+    }
+
+    size_t OverlapAABBs(const AABB& query, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+        return Scalar::OverlapAABBs(query, boxes, count, outIndices);
+    }
+
+    size_t CullAABBs(const Frustum& frustum, const AABBSoA& boxes, size_t count, uint32_t* outIndices) {
+        return Scalar::CullAABBs(frustum, boxes, count, outIndices);
+    }
+
+#endif
+
+} // namespace Math
@@ -0,0 +1,34 @@
+#include "Memory/LinearAllocator.h"
+#include "Memory/MemoryManager.h"
+#include "Utils/Logger.h"
+
+LinearAllocator::LinearAllocator(size_t capacity, const char* tag)
+    : m_Buffer(static_cast<uint8_t*>(MemoryManager::GetInstance().Allocate(capacity, tag)))
+    , m_Capacity(m_Buffer ? capacity : 0)
+{
+}
+
+LinearAllocator::~LinearAllocator() {
+    MemoryManager::GetInstance().Deallocate(m_Buffer);
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment) {
+    // Reserve with a CAS loop so concurrent callers never overlap
+    size_t offset = m_Offset.load(std::memory_order_relaxed);
+    while (true) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_Buffer) + offset;
+        const size_t aligned = offset + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+        const size_t end = aligned + size;
+        if (end > m_Capacity) {
+            LOG_ENGINE_WARN("[LinearAllocator] Out of memory: requested {} bytes, {} of {} used.",
+                size, offset, m_Capacity);
+            return nullptr;
+        }
+        if (m_Offset.compare_exchange_weak(offset, end, std::memory_order_relaxed))
+            return m_Buffer + aligned;
+    }
+}
+
+void LinearAllocator::Reset() {
+    m_Offset.store(0, std::memory_order_relaxed);
+}
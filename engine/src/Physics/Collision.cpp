@@ -0,0 +1,2215 @@
+#include "Physics/Collision.h"
+#include "Math/Simd.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Physics {
+
+    // Moved proxies per job when UpdatePairs() goes parallel
+    static constexpr uint32_t kMinMovesPerJob = 512;
+    // Unsorted insertions after which a full sort beats insertion sort
+    static constexpr uint32_t kMaxInsertionSortAppends = 64;
+
+    // ----------------------------------------------------------
+    // BROADPHASE
+    // ----------------------------------------------------------
+
+    std::unique_ptr<Broadphase> Broadphase::Create(BroadphaseType type) {
+        if (type == BroadphaseType::SweepAndPrune)
+            return std::make_unique<SweepAndPruneBroadphase>();
+        return std::make_unique<DynamicAABBTree>();
+    }
+
+    Math::AABB Broadphase::Fatten(const Math::AABB& bounds, const Math::Vec3& displacement) {
+        Math::AABB fat = bounds.Expanded(kAabbMargin);
+        const Math::Vec3 d = displacement * kDisplacementMultiplier;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (d[axis] < 0.0f)
+                fat.min[axis] += d[axis];
+            else
+                fat.max[axis] += d[axis];
+        }
+        return fat;
+    }
+
+    bool Broadphase::FatBoxStillValid(const Math::AABB& fat, const Math::AABB& bounds, const Math::Vec3& displacement) {
+        if (!fat.Contains(bounds))
+            return false;
+        // A box fattened for a fast object is too loose once it slows down
+        const Math::AABB huge = Fatten(bounds, displacement).Expanded(4.0f * kAabbMargin);
+        return huge.Contains(fat);
+    }
+
+    // ----------------------------------------------------------
+    // DYNAMIC AABB TREE
+    // ----------------------------------------------------------
+
+    uint32_t DynamicAABBTree::AllocateNode() {
+        uint32_t index;
+        if (m_FreeList != kNullNode) {
+            index = m_FreeList;
+            m_FreeList = m_Nodes[index].parent;
+        } else {
+            index = static_cast<uint32_t>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+        Node& node = m_Nodes[index];
+        node.parent = node.child1 = node.child2 = kNullNode;
+        node.height = 0;
+        node.userData = 0;
+        node.moved = 0;
+        return index;
+    }
+
+    void DynamicAABBTree::FreeNode(uint32_t node) {
+        m_Nodes[node].parent = m_FreeList;
+        m_Nodes[node].height = -1;
+        m_FreeList = node;
+    }
+
+    ProxyId DynamicAABBTree::CreateProxy(const Math::AABB& bounds, uint32_t userData) {
+        const uint32_t proxy = AllocateNode();
+        m_Nodes[proxy].box = Fatten(bounds, Math::Vec3(0.0f));
+        m_Nodes[proxy].userData = userData;
+        m_Nodes[proxy].moved = 1;
+        InsertLeaf(proxy);
+        m_MoveBuffer.push_back(proxy);
+        ++m_ProxyCount;
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(ProxyId proxy) {
+        if (m_Nodes[proxy].moved) {
+            auto it = std::find(m_MoveBuffer.begin(), m_MoveBuffer.end(), proxy);
+            *it = m_MoveBuffer.back();
+            m_MoveBuffer.pop_back();
+        }
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --m_ProxyCount;
+    }
+
+    bool DynamicAABBTree::MoveProxy(ProxyId proxy, const Math::AABB& bounds, const Math::Vec3& displacement) {
+        if (FatBoxStillValid(m_Nodes[proxy].box, bounds, displacement))
+            return false;
+
+        RemoveLeaf(proxy);
+        m_Nodes[proxy].box = Fatten(bounds, displacement);
+        InsertLeaf(proxy);
+
+        if (!m_Nodes[proxy].moved) {
+            m_Nodes[proxy].moved = 1;
+            m_MoveBuffer.push_back(proxy);
+        }
+        return true;
+    }
+
+    void DynamicAABBTree::InsertLeaf(uint32_t leaf) {
+        if (m_Root == kNullNode) {
+            m_Root = leaf;
+            m_Nodes[leaf].parent = kNullNode;
+            return;
+        }
+
+        // 1) Descend towards the cheapest sibling (surface area heuristic)
+        const Math::AABB leafBox = m_Nodes[leaf].box;
+        uint32_t index = m_Root;
+        while (!m_Nodes[index].IsLeaf()) {
+            const Node& node = m_Nodes[index];
+            const float area = node.box.SurfaceArea();
+            const float combinedArea = Math::Union(node.box, leafBox).SurfaceArea();
+
+            // Cost of a new parent here, and the growth every deeper choice inherits
+            const float cost = 2.0f * combinedArea;
+            const float inheritance = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](uint32_t child) {
+                const Node& c = m_Nodes[child];
+                const float merged = Math::Union(leafBox, c.box).SurfaceArea();
+                return (c.IsLeaf() ? merged : merged - c.box.SurfaceArea()) + inheritance;
+            };
+            const float cost1 = descendCost(node.child1);
+            const float cost2 = descendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+            index = (cost1 < cost2) ? node.child1 : node.child2;
+        }
+        const uint32_t sibling = index;
+
+        // 2) New parent for the leaf and its sibling
+        const uint32_t oldParent = m_Nodes[sibling].parent;
+        const uint32_t newParent = AllocateNode();
+        m_Nodes[newParent].parent = oldParent;
+        m_Nodes[newParent].box = Math::Union(leafBox, m_Nodes[sibling].box);
+        m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+        m_Nodes[newParent].child1 = sibling;
+        m_Nodes[newParent].child2 = leaf;
+        m_Nodes[sibling].parent = newParent;
+        m_Nodes[leaf].parent = newParent;
+
+        if (oldParent == kNullNode)
+            m_Root = newParent;
+        else if (m_Nodes[oldParent].child1 == sibling)
+            m_Nodes[oldParent].child1 = newParent;
+        else
+            m_Nodes[oldParent].child2 = newParent;
+
+        // 3) Refit and rebalance the ancestors
+        index = m_Nodes[leaf].parent;
+        while (index != kNullNode) {
+            index = Balance(index);
+            Node& node = m_Nodes[index];
+            node.height = 1 + std::max(m_Nodes[node.child1].height, m_Nodes[node.child2].height);
+            node.box = Math::Union(m_Nodes[node.child1].box, m_Nodes[node.child2].box);
+            index = node.parent;
+        }
+    }
+
+    void DynamicAABBTree::RemoveLeaf(uint32_t leaf) {
+        if (leaf == m_Root) {
+            m_Root = kNullNode;
+            return;
+        }
+
+        const uint32_t parent = m_Nodes[leaf].parent;
+        const uint32_t grandParent = m_Nodes[parent].parent;
+        const uint32_t sibling = (m_Nodes[parent].child1 == leaf) ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+        FreeNode(parent);
+        if (grandParent == kNullNode) {
+            m_Root = sibling;
+            m_Nodes[sibling].parent = kNullNode;
+            return;
+        }
+
+        // The sibling takes the parent's place
+        if (m_Nodes[grandParent].child1 == parent)
+            m_Nodes[grandParent].child1 = sibling;
+        else
+            m_Nodes[grandParent].child2 = sibling;
+        m_Nodes[sibling].parent = grandParent;
+
+        uint32_t index = grandParent;
+        while (index != kNullNode) {
+            index = Balance(index);
+            Node& node = m_Nodes[index];
+            node.height = 1 + std::max(m_Nodes[node.child1].height, m_Nodes[node.child2].height);
+            node.box = Math::Union(m_Nodes[node.child1].box, m_Nodes[node.child2].box);
+            index = node.parent;
+        }
+    }
+
+    uint32_t DynamicAABBTree::Balance(uint32_t iA) {
+        Node& A = m_Nodes[iA];
+        if (A.IsLeaf() || A.height < 2)
+            return iA;
+
+        const uint32_t iB = A.child1;
+        const uint32_t iC = A.child2;
+        Node& B = m_Nodes[iB];
+        Node& C = m_Nodes[iC];
+        const int32_t balance = C.height - B.height;
+
+        // Puts `up` in A's place in A's parent
+        auto replaceInParent = [&](uint32_t up) {
+            m_Nodes[up].parent = A.parent;
+            A.parent = up;
+            const uint32_t parent = m_Nodes[up].parent;
+            if (parent == kNullNode)
+                m_Root = up;
+            else if (m_Nodes[parent].child1 == iA)
+                m_Nodes[parent].child1 = up;
+            else
+                m_Nodes[parent].child2 = up;
+        };
+
+        // Rotate C up: A keeps B and the shorter child of C
+        if (balance > 1) {
+            const uint32_t iF = C.child1;
+            const uint32_t iG = C.child2;
+            Node& F = m_Nodes[iF];
+            Node& G = m_Nodes[iG];
+
+            C.child1 = iA;
+            replaceInParent(iC);
+
+            const bool keepF = F.height > G.height;
+            const uint32_t iKeep = keepF ? iF : iG;   // Stays under C
+            const uint32_t iMove = keepF ? iG : iF;   // Moves under A
+            C.child2 = iKeep;
+            A.child2 = iMove;
+            m_Nodes[iMove].parent = iA;
+            A.box = Math::Union(B.box, m_Nodes[iMove].box);
+            C.box = Math::Union(A.box, m_Nodes[iKeep].box);
+            A.height = 1 + std::max(B.height, m_Nodes[iMove].height);
+            C.height = 1 + std::max(A.height, m_Nodes[iKeep].height);
+            return iC;
+        }
+
+        // Rotate B up: A keeps C and the shorter child of B
+        if (balance < -1) {
+            const uint32_t iD = B.child1;
+            const uint32_t iE = B.child2;
+            Node& D = m_Nodes[iD];
+            Node& E = m_Nodes[iE];
+
+            B.child1 = iA;
+            replaceInParent(iB);
+
+            const bool keepD = D.height > E.height;
+            const uint32_t iKeep = keepD ? iD : iE;
+            const uint32_t iMove = keepD ? iE : iD;
+            B.child2 = iKeep;
+            A.child1 = iMove;
+            m_Nodes[iMove].parent = iA;
+            A.box = Math::Union(C.box, m_Nodes[iMove].box);
+            B.box = Math::Union(A.box, m_Nodes[iKeep].box);
+            A.height = 1 + std::max(C.height, m_Nodes[iMove].height);
+            B.height = 1 + std::max(A.height, m_Nodes[iKeep].height);
+            return iB;
+        }
+
+        return iA;
+    }
+
+    template <typename Visitor>
+    void DynamicAABBTree::Traverse(const Math::AABB& bounds, Visitor&& visitor) const {
+        if (m_Root == kNullNode)
+            return;
+
+        // The tree is AVL-balanced, so its height stays far below this
+        constexpr int kMaxStack = 256;
+        uint32_t stack[kMaxStack];
+        int top = 0;
+        stack[top++] = m_Root;
+        while (top > 0) {
+            const Node& node = m_Nodes[stack[--top]];
+            if (!node.box.Overlaps(bounds))
+                continue;
+            if (node.IsLeaf()) {
+                visitor(static_cast<ProxyId>(&node - m_Nodes.data()));
+            } else {
+                stack[top++] = node.child1;
+                stack[top++] = node.child2;
+            }
+        }
+    }
+
+    void DynamicAABBTree::Query(const Math::AABB& bounds, std::vector<ProxyId>& outProxies) const {
+        Traverse(bounds, [&](ProxyId proxy) { outProxies.push_back(proxy); });
+    }
+
+    void DynamicAABBTree::QueryPairs(ProxyId proxy, std::vector<ProxyPair>& outPairs) const {
+        Traverse(m_Nodes[proxy].box, [&](ProxyId other) {
+            // When both moved, only the higher id reports the pair
+            if (other == proxy || (m_Nodes[other].moved && other > proxy))
+                return;
+            outPairs.push_back({ std::min(proxy, other), std::max(proxy, other) });
+        });
+    }
+
+    void DynamicAABBTree::UpdatePairs(std::vector<ProxyPair>& outPairs) {
+        ProfileScope scope("Physics::UpdatePairs");
+        outPairs.clear();
+
+        const uint32_t moveCount = static_cast<uint32_t>(m_MoveBuffer.size());
+        const bool parallel = Threading::JobSystem::IsInitialized() && Threading::JobSystem::GetWorkerCount() > 0;
+        const uint32_t jobCount = parallel ? std::min(moveCount / kMinMovesPerJob, 4 * Threading::JobSystem::GetMaxThreadCount()) : 1;
+
+        if (jobCount > 1) {
+            // Contiguous slices of the move buffer, concatenated in order
+            std::vector<std::vector<ProxyPair>> partial(jobCount);
+            Threading::JobContext ctx;
+            Threading::JobSystem::Dispatch(ctx, jobCount, 1, [&](Threading::JobArgs args) {
+                const uint32_t begin = static_cast<uint32_t>(uint64_t(moveCount) * args.jobIndex / jobCount);
+                const uint32_t end = static_cast<uint32_t>(uint64_t(moveCount) * (args.jobIndex + 1) / jobCount);
+                for (uint32_t i = begin; i < end; ++i)
+                    QueryPairs(m_MoveBuffer[i], partial[args.jobIndex]);
+            });
+            Threading::JobSystem::Wait(ctx);
+            for (const std::vector<ProxyPair>& pairs : partial)
+                outPairs.insert(outPairs.end(), pairs.begin(), pairs.end());
+        } else {
+            for (ProxyId proxy : m_MoveBuffer)
+                QueryPairs(proxy, outPairs);
+        }
+
+        std::sort(outPairs.begin(), outPairs.end());
+
+        for (ProxyId proxy : m_MoveBuffer)
+            m_Nodes[proxy].moved = 0;
+        m_MoveBuffer.clear();
+
+        Profiling::SetCounter("Broadphase.Moved", static_cast<double>(moveCount));
+        Profiling::SetCounter("Broadphase.Pairs", static_cast<double>(outPairs.size()));
+    }
+
+    uint32_t DynamicAABBTree::GetHeight() const {
+        return (m_Root == kNullNode) ? 0u : static_cast<uint32_t>(m_Nodes[m_Root].height);
+    }
+
+    float DynamicAABBTree::GetAreaRatio() const {
+        if (m_Root == kNullNode)
+            return 0.0f;
+        const float rootArea = m_Nodes[m_Root].box.SurfaceArea();
+        float totalArea = 0.0f;
+        for (const Node& node : m_Nodes) {
+            if (node.height > 0)
+                totalArea += node.box.SurfaceArea();
+        }
+        return (rootArea > 0.0f) ? totalArea / rootArea : 0.0f;
+    }
+
+    void DynamicAABBTree::SaveState(StateWriter& writer) const {
+        writer.WriteArray(m_Nodes);
+        writer.Write(m_Root);
+        writer.Write(m_FreeList);
+        writer.Write(m_ProxyCount);
+        writer.WriteArray(m_MoveBuffer);
+    }
+
+    void DynamicAABBTree::LoadState(StateReader& reader) {
+        reader.ReadArray(m_Nodes);
+        reader.Read(m_Root);
+        reader.Read(m_FreeList);
+        reader.Read(m_ProxyCount);
+        reader.ReadArray(m_MoveBuffer);
+    }
+
+    // ----------------------------------------------------------
+    // SWEEP AND PRUNE
+    // ----------------------------------------------------------
+
+    ProxyId SweepAndPruneBroadphase::CreateProxy(const Math::AABB& bounds, uint32_t userData) {
+        ProxyId proxy;
+        if (m_FreeList != InvalidProxy) {
+            proxy = m_FreeList;
+            m_FreeList = m_Proxies[proxy].sortedIndex;
+        } else {
+            proxy = static_cast<ProxyId>(m_Proxies.size());
+            m_Proxies.emplace_back();
+        }
+
+        m_Proxies[proxy].sortedIndex = static_cast<uint32_t>(m_Sorted.size());
+        m_Proxies[proxy].userData = userData;
+        m_Proxies[proxy].moved = 1;
+        m_Sorted.push_back({ Fatten(bounds, Math::Vec3(0.0f)), proxy });
+        m_MoveBuffer.push_back(proxy);
+        ++m_Appended;
+        ++m_ProxyCount;
+        return proxy;
+    }
+
+    void SweepAndPruneBroadphase::DestroyProxy(ProxyId proxy) {
+        Proxy& p = m_Proxies[proxy];
+        if (p.moved) {
+            auto it = std::find(m_MoveBuffer.begin(), m_MoveBuffer.end(), proxy);
+            *it = m_MoveBuffer.back();
+            m_MoveBuffer.pop_back();
+        }
+        m_Sorted[p.sortedIndex].proxy = InvalidProxy;
+        ++m_Destroyed;
+
+        p.moved = 0;
+        p.sortedIndex = m_FreeList;
+        m_FreeList = proxy;
+        --m_ProxyCount;
+    }
+
+    bool SweepAndPruneBroadphase::MoveProxy(ProxyId proxy, const Math::AABB& bounds, const Math::Vec3& displacement) {
+        Proxy& p = m_Proxies[proxy];
+        Entry& entry = m_Sorted[p.sortedIndex];
+        if (FatBoxStillValid(entry.box, bounds, displacement))
+            return false;
+
+        entry.box = Fatten(bounds, displacement);
+        if (!p.moved) {
+            p.moved = 1;
+            m_MoveBuffer.push_back(proxy);
+        }
+        return true;
+    }
+
+    void SweepAndPruneBroadphase::Sort() {
+        if (m_Destroyed > 0) {
+            m_Sorted.erase(std::remove_if(m_Sorted.begin(), m_Sorted.end(), [](const Entry& e) { return e.proxy == InvalidProxy; }),
+                           m_Sorted.end());
+            m_Destroyed = 0;
+        }
+
+        auto less = [](const Entry& a, const Entry& b) { return a.box.min.x < b.box.min.x; };
+        if (m_Appended > kMaxInsertionSortAppends) {
+            std::sort(m_Sorted.begin(), m_Sorted.end(), less);
+        } else {
+            // Coherent motion leaves only a few short inversions
+            for (size_t i = 1; i < m_Sorted.size(); ++i) {
+                if (!less(m_Sorted[i], m_Sorted[i - 1]))
+                    continue;
+                const Entry entry = m_Sorted[i];
+                size_t j = i;
+                for (; j > 0 && less(entry, m_Sorted[j - 1]); --j)
+                    m_Sorted[j] = m_Sorted[j - 1];
+                m_Sorted[j] = entry;
+            }
+        }
+        m_Appended = 0;
+
+        for (uint32_t i = 0; i < m_Sorted.size(); ++i)
+            m_Proxies[m_Sorted[i].proxy].sortedIndex = i;
+    }
+
+    void SweepAndPruneBroadphase::UpdatePairs(std::vector<ProxyPair>& outPairs) {
+        ProfileScope scope("Physics::UpdatePairs");
+        outPairs.clear();
+        Sort();
+
+        const uint32_t moveCount = static_cast<uint32_t>(m_MoveBuffer.size());
+        m_MovedEntries.clear();
+        for (ProxyId proxy : m_MoveBuffer)
+            m_MovedEntries.push_back(m_Sorted[m_Proxies[proxy].sortedIndex]);
+        std::sort(m_MovedEntries.begin(), m_MovedEntries.end(), [](const Entry& a, const Entry& b) {
+            return a.box.min.x < b.box.min.x || (a.box.min.x == b.box.min.x && a.proxy < b.proxy);
+        });
+
+        auto overlapYZ = [](const Math::AABB& a, const Math::AABB& b) {
+            return a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z;
+        };
+        auto emit = [&](ProxyId a, ProxyId b) { outPairs.push_back({ std::min(a, b), std::max(a, b) }); };
+
+        // Two sweeps over the sorted lists cover every x overlap between a moved
+        // entry M and any entry S exactly by where S.min.x falls:
+        //  1) S.min.x in [M.min.x, M.max.x]
+        const size_t count = m_Sorted.size();
+        size_t start = 0;
+        for (const Entry& moved : m_MovedEntries) {
+            while (start < count && m_Sorted[start].box.min.x < moved.box.min.x)
+                ++start;
+            for (size_t i = start; i < count && m_Sorted[i].box.min.x <= moved.box.max.x; ++i) {
+                if (m_Sorted[i].proxy != moved.proxy && overlapYZ(m_Sorted[i].box, moved.box))
+                    emit(m_Sorted[i].proxy, moved.proxy);
+            }
+        }
+
+        //  2) M.min.x in (S.min.x, S.max.x]
+        size_t first = 0;
+        for (const Entry& entry : m_Sorted) {
+            while (first < m_MovedEntries.size() && m_MovedEntries[first].box.min.x <= entry.box.min.x)
+                ++first;
+            for (size_t i = first; i < m_MovedEntries.size() && m_MovedEntries[i].box.min.x <= entry.box.max.x; ++i) {
+                if (overlapYZ(m_MovedEntries[i].box, entry.box))
+                    emit(m_MovedEntries[i].proxy, entry.proxy);
+            }
+        }
+
+        // Pairs of two moved proxies can be found from both sides
+        std::sort(outPairs.begin(), outPairs.end());
+        outPairs.erase(std::unique(outPairs.begin(), outPairs.end()), outPairs.end());
+
+        for (ProxyId proxy : m_MoveBuffer)
+            m_Proxies[proxy].moved = 0;
+        m_MoveBuffer.clear();
+
+        Profiling::SetCounter("Broadphase.Moved", static_cast<double>(moveCount));
+        Profiling::SetCounter("Broadphase.Pairs", static_cast<double>(outPairs.size()));
+    }
+
+    void SweepAndPruneBroadphase::Query(const Math::AABB& bounds, std::vector<ProxyId>& outProxies) const {
+        // Sorted entries only bound the scan from above, and only once pending
+        // creations and moves have been sorted in by UpdatePairs()
+        const bool sorted = (m_Appended == 0 && m_MoveBuffer.empty());
+        for (const Entry& entry : m_Sorted) {
+            if (sorted && entry.box.min.x > bounds.max.x)
+                break;
+            if (entry.proxy != InvalidProxy && entry.box.Overlaps(bounds))
+                outProxies.push_back(entry.proxy);
+        }
+    }
+
+    void SweepAndPruneBroadphase::SaveState(StateWriter& writer) const {
+        writer.WriteArray(m_Sorted);
+        writer.WriteArray(m_Proxies);
+        writer.WriteArray(m_MoveBuffer);
+        writer.Write(m_FreeList);
+        writer.Write(m_ProxyCount);
+        writer.Write(m_Appended);
+        writer.Write(m_Destroyed);
+    }
+
+    void SweepAndPruneBroadphase::LoadState(StateReader& reader) {
+        reader.ReadArray(m_Sorted);
+        reader.ReadArray(m_Proxies);
+        reader.ReadArray(m_MoveBuffer);
+        reader.Read(m_FreeList);
+        reader.Read(m_ProxyCount);
+        reader.Read(m_Appended);
+        reader.Read(m_Destroyed);
+    }
+
+    // ----------------------------------------------------------
+    // SHAPES
+    // ----------------------------------------------------------
+
+    CollisionShape CollisionShape::Sphere(float radius) {
+        CollisionShape shape;
+        shape.type = ShapeType::Sphere;
+        shape.radius = radius;
+        return shape;
+    }
+
+    CollisionShape CollisionShape::Capsule(float radius, float halfHeight) {
+        CollisionShape shape;
+        shape.type = ShapeType::Capsule;
+        shape.radius = radius;
+        shape.halfHeight = halfHeight;
+        return shape;
+    }
+
+    CollisionShape CollisionShape::Box(const Math::Vec3& halfExtents) {
+        CollisionShape shape;
+        shape.type = ShapeType::Box;
+        shape.radius = 0.0f;
+        shape.halfExtents = halfExtents;
+        return shape;
+    }
+
+    CollisionShape CollisionShape::ConvexHull(const Math::Vec3* vertices, uint32_t count) {
+        CollisionShape shape;
+        shape.type = ShapeType::ConvexHull;
+        shape.radius = 0.0f;
+        shape.hullVertices = vertices;
+        shape.hullVertexCount = count;
+        return shape;
+    }
+
+    Math::AABB CollisionShape::ComputeAABB(const Math::Vec3& position, const Math::Quat& rotation) const {
+        switch (type) {
+        case ShapeType::Sphere:
+            return Math::AABB::FromCenterExtents(position, Math::Vec3(radius));
+        case ShapeType::Capsule: {
+            const Math::Vec3 axis = Math::Abs(Math::Rotate(rotation, { 0.0f, halfHeight, 0.0f }));
+            return Math::AABB::FromCenterExtents(position, axis + Math::Vec3(radius));
+        }
+        case ShapeType::Box: {
+            const Math::Vec3 extents = Math::Abs(Math::Rotate(rotation, { halfExtents.x, 0.0f, 0.0f }))
+                                     + Math::Abs(Math::Rotate(rotation, { 0.0f, halfExtents.y, 0.0f }))
+                                     + Math::Abs(Math::Rotate(rotation, { 0.0f, 0.0f, halfExtents.z }));
+            return Math::AABB::FromCenterExtents(position, extents);
+        }
+        default: {
+            Math::AABB bounds(position, position);
+            for (uint32_t i = 0; i < hullVertexCount; ++i)
+                bounds.Merge(position + Math::Rotate(rotation, hullVertices[i]));
+            return bounds;
+        }
+        }
+    }
+
+    // ----------------------------------------------------------
+    // CONTACT GENERATION
+    // ----------------------------------------------------------
+
+    namespace {
+
+        // Squared lengths below this count as zero
+        constexpr float kDegenerateLengthSq = 1e-12f;
+        // sin^2 of the angle below which segments are treated as parallel
+        constexpr float kParallelTolerance = 1e-6f;
+        // Face axes win over edge axes (and A faces over B faces) unless the
+        // other is clearly better, which keeps resting stacks on face contacts
+        constexpr float kSatRelativeTolerance = 0.98f;
+        constexpr float kSatAbsoluteTolerance = 0.001f;
+        // Body-space distance under which contacts of two frames are the same point
+        constexpr float kPersistentThreshold = 0.04f;
+        constexpr int   kGjkMaxIterations = 32;
+        constexpr float kGjkRelativeTolerance = 1e-5f;
+        constexpr float kGjkOverlapDistanceSq = 1e-10f;
+        constexpr int   kEpaMaxIterations = 48;
+        constexpr int   kEpaMaxVertices = 64;
+        constexpr int   kEpaMaxFaces = 128;
+        constexpr float kEpaTolerance = 1e-4f;
+        // Pairs per narrowphase job; kernel chunks stay whole SIMD steps
+        constexpr uint32_t kKernelPairsPerJob = 1024;
+        constexpr uint32_t kGeneralPairsPerJob = 64;
+
+        float Clamp01(float x) { return std::min(std::max(x, 0.0f), 1.0f); }
+
+        // Contacts before reduction to kMaxManifoldPoints, with A/B surface points
+        struct RawContact {
+            Math::Vec3 pointA;
+            Math::Vec3 pointB;
+            float      depth;
+        };
+
+        struct RawManifold {
+            Math::Vec3 normal;
+            uint32_t   count = 0;
+            RawContact points[8];
+        };
+
+        void Flip(RawManifold& manifold) {
+            manifold.normal = -manifold.normal;
+            for (uint32_t i = 0; i < manifold.count; ++i)
+                std::swap(manifold.points[i].pointA, manifold.points[i].pointB);
+        }
+
+        /*
+         * Picks up to four points that keep the deepest one and span the largest
+         * area: deepest, farthest from it, largest triangle, then the point that
+         * adds the most area on the other side of the first edge.
+         */
+        uint32_t SelectFour(const Math::Vec3* positions, const float* depths, uint32_t count, const Math::Vec3& normal, uint32_t out[kMaxManifoldPoints]) {
+            if (count <= kMaxManifoldPoints) {
+                for (uint32_t i = 0; i < count; ++i)
+                    out[i] = i;
+                return count;
+            }
+            uint32_t i0 = 0;
+            for (uint32_t i = 1; i < count; ++i) {
+                if (depths[i] > depths[i0])
+                    i0 = i;
+            }
+            uint32_t i1 = i0;
+            float best = -1.0f;
+            for (uint32_t i = 0; i < count; ++i) {
+                const float d = Math::LengthSquared(positions[i] - positions[i0]);
+                if (i != i0 && d > best) {
+                    best = d;
+                    i1 = i;
+                }
+            }
+            const Math::Vec3 edge = positions[i1] - positions[i0];
+            auto area = [&](uint32_t i) { return Math::Dot(Math::Cross(edge, positions[i] - positions[i0]), normal); };
+            uint32_t i2 = i0;
+            best = -1.0f;
+            for (uint32_t i = 0; i < count; ++i) {
+                const float a = std::fabs(area(i));
+                if (i != i0 && i != i1 && a > best) {
+                    best = a;
+                    i2 = i;
+                }
+            }
+            const float side = area(i2) >= 0.0f ? -1.0f : 1.0f;
+            uint32_t i3 = i0;
+            best = -FLT_MAX;
+            for (uint32_t i = 0; i < count; ++i) {
+                const float a = side * area(i);
+                if (i != i0 && i != i1 && i != i2 && a > best) {
+                    best = a;
+                    i3 = i;
+                }
+            }
+            out[0] = i0;
+            out[1] = i1;
+            out[2] = i2;
+            out[3] = i3;
+            return kMaxManifoldPoints;
+        }
+
+        // Reduces the raw contacts and stores them with body-space anchors
+        void FinishManifold(const RawManifold& raw, const Math::Vec3& positionA, const Math::Quat& rotationA,
+                            const Math::Vec3& positionB, const Math::Quat& rotationB, ContactManifold& out) {
+            Math::Vec3 positions[8];
+            float depths[8];
+            for (uint32_t i = 0; i < raw.count; ++i) {
+                positions[i] = (raw.points[i].pointA + raw.points[i].pointB) * 0.5f;
+                depths[i] = raw.points[i].depth;
+            }
+            uint32_t selected[kMaxManifoldPoints];
+            out.pointCount = SelectFour(positions, depths, raw.count, raw.normal, selected);
+            out.normal = raw.normal;
+            const Math::Quat invA = Math::Conjugate(rotationA), invB = Math::Conjugate(rotationB);
+            for (uint32_t i = 0; i < out.pointCount; ++i) {
+                const RawContact& contact = raw.points[selected[i]];
+                ContactPoint& point = out.points[i];
+                point = ContactPoint();
+                point.localA = Math::Rotate(invA, contact.pointA - positionA);
+                point.localB = Math::Rotate(invB, contact.pointB - positionB);
+                point.position = positions[selected[i]];
+                point.depth = contact.depth;
+            }
+        }
+
+        // ------ SEGMENTS ------
+
+        // Closest points of segments [p1, q1] and [p2, q2] (Ericson, RTCD 5.1.9)
+        void ClosestPointsOnSegments(const Math::Vec3& p1, const Math::Vec3& q1, const Math::Vec3& p2, const Math::Vec3& q2,
+                                     Math::Vec3& outC1, Math::Vec3& outC2) {
+            const Math::Vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+            const float a = Math::Dot(d1, d1), e = Math::Dot(d2, d2), f = Math::Dot(d2, r);
+            float s = 0.0f, t = 0.0f;
+            if (a <= kDegenerateLengthSq && e <= kDegenerateLengthSq) {
+                s = t = 0.0f;
+            } else if (a <= kDegenerateLengthSq) {
+                t = Clamp01(f / e);
+            } else {
+                const float c = Math::Dot(d1, r);
+                if (e <= kDegenerateLengthSq) {
+                    s = Clamp01(-c / a);
+                } else {
+                    const float b = Math::Dot(d1, d2);
+                    const float denom = a * e - b * b;
+                    s = (denom > kParallelTolerance * a * e) ? Clamp01((b * f - c * e) / denom) : 0.0f;
+                    t = (b * s + f) / e;
+                    if (t < 0.0f) {
+                        t = 0.0f;
+                        s = Clamp01(-c / a);
+                    } else if (t > 1.0f) {
+                        t = 1.0f;
+                        s = Clamp01((b - c) / a);
+                    }
+                }
+            }
+            outC1 = p1 + d1 * s;
+            outC2 = p2 + d2 * t;
+        }
+
+        // Rounded segments: the contact between the closest points, pushed out by the radii
+        RawContact SegmentContact(const Math::Vec3& a0, const Math::Vec3& a1, float radiusA,
+                                  const Math::Vec3& b0, const Math::Vec3& b1, float radiusB, Math::Vec3& outNormal) {
+            Math::Vec3 c1, c2;
+            ClosestPointsOnSegments(a0, a1, b0, b1, c1, c2);
+            const Math::Vec3 delta = c2 - c1;
+            const float distSq = Math::LengthSquared(delta);
+            const float dist = std::sqrt(distSq);
+            // Concentric cores have no preferred direction; push along +Y
+            outNormal = (distSq > kDegenerateLengthSq) ? delta / dist : Math::Vec3(0.0f, 1.0f, 0.0f);
+            return { c1 + outNormal * radiusA, c2 - outNormal * radiusB, radiusA + radiusB - dist };
+        }
+
+        void GetSegment(const CollisionShape& shape, const Math::Vec3& position, const Math::Quat& rotation,
+                        Math::Vec3& outP0, Math::Vec3& outP1) {
+            const Math::Vec3 axis = (shape.type == ShapeType::Capsule) ? Math::Rotate(rotation, { 0.0f, shape.halfHeight, 0.0f }) : Math::Vec3(0.0f);
+            outP0 = position - axis;
+            outP1 = position + axis;
+        }
+
+        // ------ BOXES ------
+
+        struct BoxFrame {
+            Math::Vec3 center;
+            Math::Vec3 axes[3];
+            Math::Vec3 half;
+        };
+
+        BoxFrame MakeBoxFrame(const CollisionShape& shape, const Math::Vec3& position, const Math::Quat& rotation) {
+            return { position,
+                     { Math::Rotate(rotation, { 1.0f, 0.0f, 0.0f }), Math::Rotate(rotation, { 0.0f, 1.0f, 0.0f }), Math::Rotate(rotation, { 0.0f, 0.0f, 1.0f }) },
+                     shape.halfExtents };
+        }
+
+        // Sphere against box: clamp into the box, or leave through the nearest face
+        RawContact SphereBoxContact(const Math::Vec3& center, float radius, const BoxFrame& box, Math::Vec3& outNormal) {
+            const Math::Vec3 d = center - box.center;
+            const Math::Vec3 local(Math::Dot(d, box.axes[0]), Math::Dot(d, box.axes[1]), Math::Dot(d, box.axes[2]));
+            Math::Vec3 surface, outward;
+            float depth;
+            const Math::Vec3 clamped = Math::Min(Math::Max(local, -box.half), box.half);
+            if (clamped == local) {
+                int axis = 0;
+                const Math::Vec3 pen = box.half - Math::Abs(local);
+                if (pen.y < pen[axis])
+                    axis = 1;
+                if (pen.z < pen[axis])
+                    axis = 2;
+                const float sign = local[axis] < 0.0f ? -1.0f : 1.0f;
+                surface = local;
+                surface[axis] = sign * box.half[axis];
+                outward = Math::Vec3(0.0f);
+                outward[axis] = sign;
+                depth = radius + pen[axis];
+            } else {
+                const Math::Vec3 delta = local - clamped;
+                const float dist = Math::Length(delta);
+                surface = clamped;
+                outward = delta / dist;
+                depth = radius - dist;
+            }
+            outNormal = -(box.axes[0] * outward.x + box.axes[1] * outward.y + box.axes[2] * outward.z);
+            const Math::Vec3 pointB = box.center + box.axes[0] * surface.x + box.axes[1] * surface.y + box.axes[2] * surface.z;
+            return { center + outNormal * radius, pointB, depth };
+        }
+
+        float ProjectBox(const BoxFrame& box, const Math::Vec3& axis) {
+            return box.half.x * std::fabs(Math::Dot(box.axes[0], axis))
+                 + box.half.y * std::fabs(Math::Dot(box.axes[1], axis))
+                 + box.half.z * std::fabs(Math::Dot(box.axes[2], axis));
+        }
+
+        // Keeps the part of the polygon with Dot(normal, p) <= offset
+        uint32_t ClipPolygon(const Math::Vec3* in, uint32_t count, const Math::Vec3& normal, float offset, Math::Vec3* out) {
+            uint32_t outCount = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                const Math::Vec3& p = in[i];
+                const Math::Vec3& q = in[(i + 1) % count];
+                const float dp = Math::Dot(normal, p) - offset;
+                const float dq = Math::Dot(normal, q) - offset;
+                if (dp <= 0.0f)
+                    out[outCount++] = p;
+                if ((dp < 0.0f && dq > 0.0f) || (dp > 0.0f && dq < 0.0f))
+                    out[outCount++] = p + (q - p) * (dp / (dp - dq));
+            }
+            return outCount;
+        }
+
+        /*
+         * Box-box by separating axes: 3 + 3 face normals and 9 edge cross products.
+         * Face contacts clip the incident face against the sides of the reference
+         * face (up to 8 points); edge contacts take the closest points of the edges.
+         */
+        bool CollideBoxes(const BoxFrame& a, const BoxFrame& b, float margin, RawManifold& out) {
+            const Math::Vec3 t = b.center - a.center;
+
+            float faceSep[2] = { -FLT_MAX, -FLT_MAX };
+            int faceAxis[2] = { 0, 0 };
+            for (int box = 0; box < 2; ++box) {
+                const BoxFrame& self = box == 0 ? a : b;
+                const BoxFrame& other = box == 0 ? b : a;
+                for (int i = 0; i < 3; ++i) {
+                    const float sep = std::fabs(Math::Dot(t, self.axes[i])) - self.half[i] - ProjectBox(other, self.axes[i]);
+                    if (sep > margin)
+                        return false;
+                    if (sep > faceSep[box]) {
+                        faceSep[box] = sep;
+                        faceAxis[box] = i;
+                    }
+                }
+            }
+
+            float edgeSep = -FLT_MAX;
+            int edgeA = 0, edgeB = 0;
+            Math::Vec3 edgeNormal;
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    Math::Vec3 axis = Math::Cross(a.axes[i], b.axes[j]);
+                    const float lengthSq = Math::LengthSquared(axis);
+                    if (lengthSq < 1e-6f)
+                        continue;
+                    axis = axis / std::sqrt(lengthSq);
+                    const float sep = std::fabs(Math::Dot(t, axis)) - ProjectBox(a, axis) - ProjectBox(b, axis);
+                    if (sep > margin)
+                        return false;
+                    if (sep > edgeSep) {
+                        edgeSep = sep;
+                        edgeA = i;
+                        edgeB = j;
+                        edgeNormal = axis;
+                    }
+                }
+            }
+
+            const bool referenceIsA = !(faceSep[1] > kSatRelativeTolerance * faceSep[0] + kSatAbsoluteTolerance);
+            const float bestFace = referenceIsA ? faceSep[0] : faceSep[1];
+            out.count = 0;
+
+            if (edgeSep > kSatRelativeTolerance * bestFace + kSatAbsoluteTolerance) {
+                const Math::Vec3 n = Math::Dot(t, edgeNormal) < 0.0f ? -edgeNormal : edgeNormal;
+                // Edge of A farthest along n, edge of B farthest against it
+                Math::Vec3 ca = a.center, cb = b.center;
+                for (int k = 0; k < 3; ++k) {
+                    if (k != edgeA)
+                        ca += a.axes[k] * (Math::Dot(a.axes[k], n) > 0.0f ? a.half[k] : -a.half[k]);
+                    if (k != edgeB)
+                        cb += b.axes[k] * (Math::Dot(b.axes[k], n) > 0.0f ? -b.half[k] : b.half[k]);
+                }
+                const Math::Vec3 ea = a.axes[edgeA] * a.half[edgeA], eb = b.axes[edgeB] * b.half[edgeB];
+                Math::Vec3 pa, pb;
+                ClosestPointsOnSegments(ca - ea, ca + ea, cb - eb, cb + eb, pa, pb);
+                out.normal = n;
+                out.points[out.count++] = { pa, pb, -Math::Dot(n, pb - pa) };
+                return true;
+            }
+
+            const BoxFrame& ref = referenceIsA ? a : b;
+            const BoxFrame& inc = referenceIsA ? b : a;
+            const int axis = referenceIsA ? faceAxis[0] : faceAxis[1];
+            // Outward normal of the reference face, towards the incident box
+            const Math::Vec3 toIncident = referenceIsA ? t : -t;
+            const Math::Vec3 refN = Math::Dot(toIncident, ref.axes[axis]) < 0.0f ? -ref.axes[axis] : ref.axes[axis];
+            out.normal = referenceIsA ? refN : -refN;
+
+            // Incident face: the one most facing the reference face
+            int incAxis = 0;
+            float bestDot = -1.0f;
+            for (int k = 0; k < 3; ++k) {
+                const float d = std::fabs(Math::Dot(inc.axes[k], refN));
+                if (d > bestDot) {
+                    bestDot = d;
+                    incAxis = k;
+                }
+            }
+            const float incSign = Math::Dot(inc.axes[incAxis], refN) > 0.0f ? -1.0f : 1.0f;
+            const Math::Vec3 incCenter = inc.center + inc.axes[incAxis] * (incSign * inc.half[incAxis]);
+            const Math::Vec3 u = inc.axes[(incAxis + 1) % 3] * inc.half[(incAxis + 1) % 3];
+            const Math::Vec3 v = inc.axes[(incAxis + 2) % 3] * inc.half[(incAxis + 2) % 3];
+
+            Math::Vec3 polygon[8] = { incCenter + u + v, incCenter - u + v, incCenter - u - v, incCenter + u - v };
+            Math::Vec3 scratch[8];
+            uint32_t count = 4;
+            for (int side = 1; side <= 2 && count > 0; ++side) {
+                const int k = (axis + side) % 3;
+                const float centerDot = Math::Dot(ref.axes[k], ref.center);
+                count = ClipPolygon(polygon, count, ref.axes[k], centerDot + ref.half[k], scratch);
+                count = ClipPolygon(scratch, count, -ref.axes[k], -centerDot + ref.half[k], polygon);
+            }
+
+            const Math::Vec3 refCenter = ref.center + refN * ref.half[axis];
+            for (uint32_t i = 0; i < count; ++i) {
+                const float sep = Math::Dot(refN, polygon[i] - refCenter);
+                if (sep > margin)
+                    continue;
+                const Math::Vec3 onReference = polygon[i] - refN * sep;
+                out.points[out.count++] = referenceIsA ? RawContact{ onReference, polygon[i], -sep }
+                                                       : RawContact{ polygon[i], onReference, -sep };
+            }
+            return out.count > 0;
+        }
+
+        // ------ GJK / EPA ------
+
+        struct PosedShape {
+            const CollisionShape* shape;
+            Math::Vec3            position;
+            Math::Quat            rotation;
+        };
+
+        float GetRadius(const CollisionShape& shape) {
+            return (shape.type == ShapeType::Sphere || shape.type == ShapeType::Capsule) ? shape.radius : 0.0f;
+        }
+
+        // Support point of the core shape (without radius), in world space
+        Math::Vec3 CoreSupport(const PosedShape& posed, const Math::Vec3& direction) {
+            const CollisionShape& shape = *posed.shape;
+            const Math::Vec3 d = Math::Rotate(Math::Conjugate(posed.rotation), direction);
+            Math::Vec3 local;
+            switch (shape.type) {
+            case ShapeType::Sphere:
+                break;
+            case ShapeType::Capsule:
+                local.y = d.y >= 0.0f ? shape.halfHeight : -shape.halfHeight;
+                break;
+            case ShapeType::Box:
+                local = { d.x >= 0.0f ? shape.halfExtents.x : -shape.halfExtents.x,
+                          d.y >= 0.0f ? shape.halfExtents.y : -shape.halfExtents.y,
+                          d.z >= 0.0f ? shape.halfExtents.z : -shape.halfExtents.z };
+                break;
+            default: {
+                float best = -FLT_MAX;
+                for (uint32_t i = 0; i < shape.hullVertexCount; ++i) {
+                    const float proj = Math::Dot(shape.hullVertices[i], d);
+                    if (proj > best) {
+                        best = proj;
+                        local = shape.hullVertices[i];
+                    }
+                }
+                break;
+            }
+            }
+            return posed.position + Math::Rotate(posed.rotation, local);
+        }
+
+        // A point of the Minkowski difference A - B with the points of A and B it came from
+        struct SimplexVertex {
+            Math::Vec3 a;
+            Math::Vec3 b;
+            Math::Vec3 w;
+        };
+
+        SimplexVertex CoreVertex(const PosedShape& a, const PosedShape& b, const Math::Vec3& direction) {
+            SimplexVertex v;
+            v.a = CoreSupport(a, direction);
+            v.b = CoreSupport(b, -direction);
+            v.w = v.a - v.b;
+            return v;
+        }
+
+        // Support of the shapes inflated by their radii, for EPA
+        SimplexVertex InflatedVertex(const PosedShape& a, const PosedShape& b, const Math::Vec3& direction) {
+            const Math::Vec3 n = Math::Normalize(direction);
+            SimplexVertex v;
+            v.a = CoreSupport(a, direction) + n * GetRadius(*a.shape);
+            v.b = CoreSupport(b, -direction) - n * GetRadius(*b.shape);
+            v.w = v.a - v.b;
+            return v;
+        }
+
+        struct Simplex {
+            SimplexVertex v[4];
+            float         bary[4];
+            int           count = 0;
+
+            Math::Vec3 Point() const {
+                Math::Vec3 p;
+                for (int i = 0; i < count; ++i)
+                    p += v[i].w * bary[i];
+                return p;
+            }
+        };
+
+        Simplex MakeSimplex(const SimplexVertex& a, float wa) {
+            Simplex s;
+            s.v[0] = a;
+            s.bary[0] = wa;
+            s.count = 1;
+            return s;
+        }
+
+        Simplex MakeSimplex(const SimplexVertex& a, float wa, const SimplexVertex& b, float wb) {
+            Simplex s = MakeSimplex(a, wa);
+            s.v[1] = b;
+            s.bary[1] = wb;
+            s.count = 2;
+            return s;
+        }
+
+        // Sub-simplex of a segment closest to the origin
+        Simplex SolveSegment(const SimplexVertex& a, const SimplexVertex& b) {
+            const Math::Vec3 ab = b.w - a.w;
+            const float lengthSq = Math::LengthSquared(ab);
+            const float t = lengthSq > kDegenerateLengthSq ? -Math::Dot(a.w, ab) / lengthSq : 0.0f;
+            if (t <= 0.0f)
+                return MakeSimplex(a, 1.0f);
+            if (t >= 1.0f)
+                return MakeSimplex(b, 1.0f);
+            return MakeSimplex(a, 1.0f - t, b, t);
+        }
+
+        // Sub-simplex of a triangle closest to the origin (Ericson, RTCD 5.1.5)
+        Simplex SolveTriangle(const SimplexVertex& a, const SimplexVertex& b, const SimplexVertex& c) {
+            const Math::Vec3 ab = b.w - a.w, ac = c.w - a.w;
+            const float d1 = -Math::Dot(ab, a.w), d2 = -Math::Dot(ac, a.w);
+            if (d1 <= 0.0f && d2 <= 0.0f)
+                return MakeSimplex(a, 1.0f);
+            const float d3 = -Math::Dot(ab, b.w), d4 = -Math::Dot(ac, b.w);
+            if (d3 >= 0.0f && d4 <= d3)
+                return MakeSimplex(b, 1.0f);
+            const float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+                const float v = d1 / (d1 - d3);
+                return MakeSimplex(a, 1.0f - v, b, v);
+            }
+            const float d5 = -Math::Dot(ab, c.w), d6 = -Math::Dot(ac, c.w);
+            if (d6 >= 0.0f && d5 <= d6)
+                return MakeSimplex(c, 1.0f);
+            const float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+                const float w = d2 / (d2 - d6);
+                return MakeSimplex(a, 1.0f - w, c, w);
+            }
+            const float va = d3 * d6 - d5 * d4;
+            if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+                const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                return MakeSimplex(b, 1.0f - w, c, w);
+            }
+            const float denom = 1.0f / (va + vb + vc);
+            const float v = vb * denom, w = vc * denom;
+            Simplex s = MakeSimplex(a, 1.0f - v - w, b, v);
+            s.v[2] = c;
+            s.bary[2] = w;
+            s.count = 3;
+            return s;
+        }
+
+        // Reduces the simplex to its part closest to the origin; false if it encloses the origin
+        bool SolveSimplex(Simplex& s) {
+            switch (s.count) {
+            case 1:
+                s.bary[0] = 1.0f;
+                return true;
+            case 2:
+                s = SolveSegment(s.v[0], s.v[1]);
+                return true;
+            case 3:
+                s = SolveTriangle(s.v[0], s.v[1], s.v[2]);
+                return true;
+            default: {
+                static constexpr int kFaces[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+                float bestDistSq = FLT_MAX;
+                Simplex best;
+                for (const int* f : kFaces) {
+                    const Math::Vec3& a = s.v[f[0]].w;
+                    const Math::Vec3 n = Math::Cross(s.v[f[1]].w - a, s.v[f[2]].w - a);
+                    // Faces with the origin on the far side from the fourth vertex
+                    // (all faces, for a flat tetrahedron)
+                    const float side = Math::Dot(s.v[f[3]].w - a, n);
+                    const bool flat = side * side <= 1e-10f * Math::LengthSquared(n);
+                    if (!flat && Math::Dot(-a, n) * side > 0.0f)
+                        continue;
+                    const Simplex candidate = SolveTriangle(s.v[f[0]], s.v[f[1]], s.v[f[2]]);
+                    const float distSq = Math::LengthSquared(candidate.Point());
+                    if (distSq < bestDistSq) {
+                        bestDistSq = distSq;
+                        best = candidate;
+                    }
+                }
+                if (best.count == 0)
+                    return false;
+                s = best;
+                return true;
+            }
+            }
+        }
+
+        struct GjkResult {
+            Simplex    simplex;
+            Math::Vec3 pointA;
+            Math::Vec3 pointB;
+            float      distance = 0.0f;
+            bool       overlap = false;
+        };
+
+        // Distance between the core shapes (Gilbert-Johnson-Keerthi)
+        GjkResult Gjk(const PosedShape& a, const PosedShape& b) {
+            GjkResult result;
+            Simplex& s = result.simplex;
+            Math::Vec3 direction = a.position - b.position;
+            if (Math::LengthSquared(direction) < kDegenerateLengthSq)
+                direction = { 1.0f, 0.0f, 0.0f };
+            s.v[0] = CoreVertex(a, b, direction);
+            s.count = 1;
+
+            Math::Vec3 v;
+            bool converged = false;
+            for (int iteration = 0; iteration < kGjkMaxIterations; ++iteration) {
+                if (!SolveSimplex(s)) {
+                    result.overlap = true;
+                    return result;
+                }
+                v = s.Point();
+                const float vv = Math::Dot(v, v);
+                if (vv < kGjkOverlapDistanceSq) {
+                    result.overlap = true;
+                    return result;
+                }
+                const SimplexVertex next = CoreVertex(a, b, -v);
+                // No progress towards the origin: v is the closest point
+                if (vv - Math::Dot(v, next.w) <= kGjkRelativeTolerance * vv) {
+                    converged = true;
+                    break;
+                }
+                bool duplicate = false;
+                for (int i = 0; i < s.count; ++i)
+                    duplicate |= Math::LengthSquared(s.v[i].w - next.w) < kDegenerateLengthSq;
+                if (duplicate) {
+                    converged = true;
+                    break;
+                }
+                s.v[s.count++] = next;
+            }
+            // Out of iterations: the newest vertex has no barycentric weight yet
+            if (!converged)
+                --s.count;
+
+            for (int i = 0; i < s.count; ++i) {
+                result.pointA += s.v[i].a * s.bary[i];
+                result.pointB += s.v[i].b * s.bary[i];
+            }
+            result.distance = Math::Length(v);
+            return result;
+        }
+
+        // Grows the final GJK simplex (which touches the origin) into a tetrahedron
+        bool CompleteTetrahedron(const PosedShape& a, const PosedShape& b, Simplex& s) {
+            static const Math::Vec3 kAxes[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+            if (s.count == 1) {
+                for (const Math::Vec3& axis : kAxes) {
+                    const SimplexVertex v = InflatedVertex(a, b, axis);
+                    if (Math::LengthSquared(v.w - s.v[0].w) > kDegenerateLengthSq) {
+                        s.v[s.count++] = v;
+                        break;
+                    }
+                }
+            }
+            if (s.count == 2) {
+                const Math::Vec3 line = Math::Normalize(s.v[1].w - s.v[0].w);
+                const Math::Vec3 abs = Math::Abs(line);
+                const Math::Vec3 helper = (abs.x <= abs.y && abs.x <= abs.z) ? kAxes[0] : (abs.y <= abs.z ? kAxes[2] : kAxes[4]);
+                const Math::Vec3 perpendicular = Math::Cross(line, helper);
+                for (int k = 0; k < 6; ++k) {
+                    const Math::Quat turn = Math::Quat::FromAxisAngle(line, k * 1.04719755f);
+                    const SimplexVertex v = InflatedVertex(a, b, Math::Rotate(turn, perpendicular));
+                    if (Math::LengthSquared(Math::Cross(v.w - s.v[0].w, line)) > kDegenerateLengthSq) {
+                        s.v[s.count++] = v;
+                        break;
+                    }
+                }
+            }
+            if (s.count == 3) {
+                const Math::Vec3 n = Math::Normalize(Math::Cross(s.v[1].w - s.v[0].w, s.v[2].w - s.v[0].w));
+                for (float sign : { 1.0f, -1.0f }) {
+                    const SimplexVertex v = InflatedVertex(a, b, n * sign);
+                    if (std::fabs(Math::Dot(v.w - s.v[0].w, n)) > 1e-6f) {
+                        s.v[s.count++] = v;
+                        break;
+                    }
+                }
+            }
+            return s.count == 4;
+        }
+
+        /*
+         * Expanding polytope: grows the Minkowski difference of the inflated shapes
+         * from the GJK tetrahedron until the face nearest the origin is on the
+         * boundary. That face gives the normal, the depth and the contact points.
+         */
+        bool Epa(const PosedShape& a, const PosedShape& b, Simplex simplex, RawManifold& out) {
+            if (!CompleteTetrahedron(a, b, simplex))
+                return false;
+
+            struct Face {
+                int        v[3];
+                Math::Vec3 n;
+                float      d;
+            };
+            SimplexVertex vertices[kEpaMaxVertices];
+            Face faces[kEpaMaxFaces];
+            int vertexCount = 4, faceCount = 0;
+            for (int i = 0; i < 4; ++i)
+                vertices[i] = simplex.v[i];
+            if (Math::Dot(Math::Cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w), vertices[3].w - vertices[0].w) > 0.0f)
+                std::swap(vertices[1], vertices[2]);
+
+            auto addFace = [&](int i0, int i1, int i2) {
+                Face& face = faces[faceCount++];
+                face.v[0] = i0;
+                face.v[1] = i1;
+                face.v[2] = i2;
+                const Math::Vec3 n = Math::Cross(vertices[i1].w - vertices[i0].w, vertices[i2].w - vertices[i0].w);
+                const float length = Math::Length(n);
+                // Slivers keep the polytope closed but are never expanded
+                face.n = length > 1e-9f ? n / length : Math::Vec3(0.0f);
+                face.d = length > 1e-9f ? Math::Dot(face.n, vertices[i0].w) : FLT_MAX;
+            };
+            addFace(0, 1, 2);
+            addFace(0, 3, 1);
+            addFace(0, 2, 3);
+            addFace(1, 3, 2);
+
+            int closest = 0;
+            for (int iteration = 0; iteration < kEpaMaxIterations; ++iteration) {
+                closest = 0;
+                for (int i = 1; i < faceCount; ++i) {
+                    if (faces[i].d < faces[closest].d)
+                        closest = i;
+                }
+                const Face face = faces[closest];
+                const SimplexVertex next = InflatedVertex(a, b, face.n);
+                if (Math::Dot(next.w, face.n) - face.d < kEpaTolerance || vertexCount == kEpaMaxVertices)
+                    break;
+
+                // Remove the faces the new vertex sees, keeping their outline
+                int edges[kEpaMaxFaces * 3][2];
+                int edgeCount = 0;
+                for (int i = 0; i < faceCount;) {
+                    if (Math::Dot(faces[i].n, next.w - vertices[faces[i].v[0]].w) <= 0.0f) {
+                        ++i;
+                        continue;
+                    }
+                    for (int e = 0; e < 3; ++e) {
+                        const int e0 = faces[i].v[e], e1 = faces[i].v[(e + 1) % 3];
+                        bool shared = false;
+                        for (int k = 0; k < edgeCount; ++k) {
+                            if (edges[k][0] == e1 && edges[k][1] == e0) {
+                                edges[k][0] = edges[edgeCount - 1][0];
+                                edges[k][1] = edges[edgeCount - 1][1];
+                                --edgeCount;
+                                shared = true;
+                                break;
+                            }
+                        }
+                        if (!shared) {
+                            edges[edgeCount][0] = e0;
+                            edges[edgeCount][1] = e1;
+                            ++edgeCount;
+                        }
+                    }
+                    faces[i] = faces[--faceCount];
+                }
+                if (faceCount + edgeCount > kEpaMaxFaces) {
+                    faces[faceCount++] = face;
+                    closest = faceCount - 1;
+                    break;
+                }
+                vertices[vertexCount] = next;
+                for (int k = 0; k < edgeCount; ++k)
+                    addFace(edges[k][0], edges[k][1], vertexCount);
+                ++vertexCount;
+            }
+
+            // Origin projected onto the closest face, in barycentric coordinates
+            const Face& face = faces[closest];
+            const SimplexVertex& v0 = vertices[face.v[0]];
+            const SimplexVertex& v1 = vertices[face.v[1]];
+            const SimplexVertex& v2 = vertices[face.v[2]];
+            const Math::Vec3 e0 = v1.w - v0.w, e1 = v2.w - v0.w, p = face.n * face.d - v0.w;
+            const float d00 = Math::Dot(e0, e0), d01 = Math::Dot(e0, e1), d11 = Math::Dot(e1, e1);
+            const float d20 = Math::Dot(p, e0), d21 = Math::Dot(p, e1);
+            const float denom = d00 * d11 - d01 * d01;
+            const float u = denom > kDegenerateLengthSq ? (d11 * d20 - d01 * d21) / denom : 0.0f;
+            const float w = denom > kDegenerateLengthSq ? (d00 * d21 - d01 * d20) / denom : 0.0f;
+
+            out.normal = face.n;
+            out.count = 1;
+            out.points[0] = { v0.a * (1.0f - u - w) + v1.a * u + v2.a * w,
+                              v0.b * (1.0f - u - w) + v1.b * u + v2.b * w,
+                              face.d };
+            return true;
+        }
+
+        // Any convex pair: GJK between the cores, EPA when the cores overlap
+        bool CollideConvex(const PosedShape& a, const PosedShape& b, float margin, RawManifold& out) {
+            const float radiusA = GetRadius(*a.shape), radiusB = GetRadius(*b.shape);
+            const GjkResult gjk = Gjk(a, b);
+            out.count = 0;
+            if (gjk.overlap)
+                return Epa(a, b, gjk.simplex, out) && out.points[0].depth >= -margin;
+
+            const float separation = gjk.distance - radiusA - radiusB;
+            if (separation > margin)
+                return false;
+            out.normal = (gjk.pointB - gjk.pointA) / gjk.distance;
+            out.points[out.count++] = { gjk.pointA + out.normal * radiusA, gjk.pointB - out.normal * radiusB, -separation };
+            return true;
+        }
+
+        // Shape pairs in canonical order (type of a <= type of b)
+        bool CollideOrdered(const CollisionShape& shapeA, const Math::Vec3& positionA, const Math::Quat& rotationA,
+                            const CollisionShape& shapeB, const Math::Vec3& positionB, const Math::Quat& rotationB,
+                            float margin, RawManifold& out) {
+            out.count = 0;
+            if (shapeB.type <= ShapeType::Capsule) {
+                Math::Vec3 a0, a1, b0, b1;
+                GetSegment(shapeA, positionA, rotationA, a0, a1);
+                GetSegment(shapeB, positionB, rotationB, b0, b1);
+                const RawContact contact = SegmentContact(a0, a1, shapeA.radius, b0, b1, shapeB.radius, out.normal);
+                if (contact.depth < -margin)
+                    return false;
+                out.points[out.count++] = contact;
+                return true;
+            }
+            if (shapeA.type == ShapeType::Sphere && shapeB.type == ShapeType::Box) {
+                const RawContact contact = SphereBoxContact(positionA, shapeA.radius, MakeBoxFrame(shapeB, positionB, rotationB), out.normal);
+                if (contact.depth < -margin)
+                    return false;
+                out.points[out.count++] = contact;
+                return true;
+            }
+            if (shapeA.type == ShapeType::Box && shapeB.type == ShapeType::Box)
+                return CollideBoxes(MakeBoxFrame(shapeA, positionA, rotationA), MakeBoxFrame(shapeB, positionB, rotationB), margin, out);
+            return CollideConvex({ &shapeA, positionA, rotationA }, { &shapeB, positionB, rotationB }, margin, out);
+        }
+
+        bool CollideRaw(const CollisionShape& shapeA, const Math::Vec3& positionA, const Math::Quat& rotationA,
+                        const CollisionShape& shapeB, const Math::Vec3& positionB, const Math::Quat& rotationB,
+                        float margin, RawManifold& out) {
+            if (shapeA.type <= shapeB.type)
+                return CollideOrdered(shapeA, positionA, rotationA, shapeB, positionB, rotationB, margin, out);
+            if (!CollideOrdered(shapeB, positionB, rotationB, shapeA, positionA, rotationA, margin, out))
+                return false;
+            Flip(out);
+            return true;
+        }
+
+    } // namespace
+
+    bool Collide(const CollisionShape& shapeA, const Math::Vec3& positionA, const Math::Quat& rotationA,
+                 const CollisionShape& shapeB, const Math::Vec3& positionB, const Math::Quat& rotationB,
+                 float margin, ContactManifold& outManifold) {
+        RawManifold raw;
+        if (!CollideRaw(shapeA, positionA, rotationA, shapeB, positionB, rotationB, margin, raw))
+            return false;
+        FinishManifold(raw, positionA, rotationA, positionB, rotationB, outManifold);
+        return true;
+    }
+
+    // ----------------------------------------------------------
+    // BATCHED KERNELS
+    // ----------------------------------------------------------
+
+    void SegmentPairBatch::Resize(size_t count) {
+        for (int k = 0; k < 3; ++k) {
+            for (std::vector<float>* array : { &a0[k], &a1[k], &b0[k], &b1[k], &normal[k], &pointA[k], &pointB[k] })
+                array->resize(count);
+        }
+        radiusA.resize(count);
+        radiusB.resize(count);
+        depth.resize(count);
+    }
+
+    void SphereBoxBatch::Resize(size_t count) {
+        for (int k = 0; k < 3; ++k) {
+            for (std::vector<float>* array : { &center[k], &boxCenter[k], &axisX[k], &axisY[k], &axisZ[k], &halfExtents[k], &normal[k], &pointA[k], &pointB[k] })
+                array->resize(count);
+        }
+        radius.resize(count);
+        depth.resize(count);
+    }
+
+    namespace {
+
+        /*
+         * The kernels are written once against this lane interface; the build's
+         * SIMD level (Math/Simd.h) decides how many pairs one step covers.
+         */
+#if MATH_SIMD_AVX2
+        struct Lanes {
+            using Float = __m256;
+            using Mask = __m256;
+            static constexpr int kWidth = 8;
+
+            static Float Set(float v) { return _mm256_set1_ps(v); }
+            static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+            static void  Store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+            static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+            static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+            static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+            static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+            static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+            static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+            static Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+            static Float Abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+            static Mask  Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static Mask  LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+            static Mask  Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static Mask  And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+            static Float Select(Mask mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+            static int   MoveMask(Mask mask) { return _mm256_movemask_ps(mask); }
+        };
+#elif MATH_SIMD_SSE
+        struct Lanes {
+            using Float = __m128;
+            using Mask = __m128;
+            static constexpr int kWidth = 4;
+
+            static Float Set(float v) { return _mm_set1_ps(v); }
+            static Float Load(const float* p) { return _mm_loadu_ps(p); }
+            static void  Store(float* p, Float v) { _mm_storeu_ps(p, v); }
+            static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+            static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+            static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+            static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+            static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+            static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+            static Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+            static Float Abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            static Mask  Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+            static Mask  LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+            static Mask  Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+            static Mask  And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+            static Float Select(Mask mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+            static int   MoveMask(Mask mask) { return _mm_movemask_ps(mask); }
+        };
+#else
+        struct Lanes {
+            // One pair per step; masks are plain booleans
+            using Float = float;
+            using Mask = bool;
+            static constexpr int kWidth = 1;
+
+            static Float Set(float v) { return v; }
+            static Float Load(const float* p) { return *p; }
+            static void  Store(float* p, Float v) { *p = v; }
+            static Float Add(Float a, Float b) { return a + b; }
+            static Float Sub(Float a, Float b) { return a - b; }
+            static Float Mul(Float a, Float b) { return a * b; }
+            static Float Div(Float a, Float b) { return a / b; }
+            static Float Min(Float a, Float b) { return a < b ? a : b; }
+            static Float Max(Float a, Float b) { return a > b ? a : b; }
+            static Float Sqrt(Float a) { return std::sqrt(a); }
+            static Float Abs(Float a) { return std::fabs(a); }
+            static Mask  Less(Float a, Float b) { return a < b; }
+            static Mask  LessEqual(Float a, Float b) { return a <= b; }
+            static Mask  Greater(Float a, Float b) { return a > b; }
+            static Mask  And(Mask a, Mask b) { return a && b; }
+            static Float Select(Mask mask, Float a, Float b) { return mask ? a : b; }
+            static int   MoveMask(Mask mask) { return mask ? 1 : 0; }
+        };
+#endif
+
+        using Float = Lanes::Float;
+        using Mask = Lanes::Mask;
+
+        struct LaneVec3 {
+            Float x, y, z;
+        };
+
+        LaneVec3 LoadVec3(const std::vector<float> (&v)[3], size_t i) {
+            return { Lanes::Load(&v[0][i]), Lanes::Load(&v[1][i]), Lanes::Load(&v[2][i]) };
+        }
+
+        void StoreVec3(std::vector<float> (&v)[3], size_t i, const LaneVec3& a) {
+            Lanes::Store(&v[0][i], a.x);
+            Lanes::Store(&v[1][i], a.y);
+            Lanes::Store(&v[2][i], a.z);
+        }
+
+        LaneVec3 Sub(const LaneVec3& a, const LaneVec3& b) { return { Lanes::Sub(a.x, b.x), Lanes::Sub(a.y, b.y), Lanes::Sub(a.z, b.z) }; }
+        LaneVec3 Scale(const LaneVec3& a, Float s) { return { Lanes::Mul(a.x, s), Lanes::Mul(a.y, s), Lanes::Mul(a.z, s) }; }
+        // a + b * s
+        LaneVec3 MulAdd(const LaneVec3& a, const LaneVec3& b, Float s) {
+            return { Lanes::Add(a.x, Lanes::Mul(b.x, s)), Lanes::Add(a.y, Lanes::Mul(b.y, s)), Lanes::Add(a.z, Lanes::Mul(b.z, s)) };
+        }
+        Float Dot(const LaneVec3& a, const LaneVec3& b) {
+            return Lanes::Add(Lanes::Add(Lanes::Mul(a.x, b.x), Lanes::Mul(a.y, b.y)), Lanes::Mul(a.z, b.z));
+        }
+        Float ClampUnit(Float x) { return Lanes::Min(Lanes::Max(x, Lanes::Set(0.0f)), Lanes::Set(1.0f)); }
+
+        // Branch-free ClosestPointsOnSegments() + SegmentContact() over one step of pairs
+        void SegmentStep(SegmentPairBatch& batch, size_t i) {
+            const Float zero = Lanes::Set(0.0f), one = Lanes::Set(1.0f), epsilon = Lanes::Set(kDegenerateLengthSq);
+            const LaneVec3 p1 = LoadVec3(batch.a0, i), p2 = LoadVec3(batch.b0, i);
+            const LaneVec3 d1 = Sub(LoadVec3(batch.a1, i), p1), d2 = Sub(LoadVec3(batch.b1, i), p2), r = Sub(p1, p2);
+            const Float a = Dot(d1, d1), e = Dot(d2, d2), b = Dot(d1, d2), c = Dot(d1, r), f = Dot(d2, r);
+            const Float safeA = Lanes::Max(a, epsilon), safeE = Lanes::Max(e, epsilon);
+            const Mask hasA = Lanes::Greater(a, epsilon), hasE = Lanes::Greater(e, epsilon);
+
+            const Float ae = Lanes::Mul(a, e);
+            const Float denom = Lanes::Sub(ae, Lanes::Mul(b, b));
+            const Mask skew = Lanes::Greater(denom, Lanes::Mul(Lanes::Set(kParallelTolerance), ae));
+            const Float sLine = ClampUnit(Lanes::Div(Lanes::Sub(Lanes::Mul(b, f), Lanes::Mul(c, e)), Lanes::Max(denom, epsilon)));
+            const Float sStart = ClampUnit(Lanes::Div(Lanes::Sub(zero, c), safeA));
+            const Float sEnd = ClampUnit(Lanes::Div(Lanes::Sub(b, c), safeA));
+            Float s = Lanes::Select(hasE, Lanes::Select(skew, sLine, zero), sStart);
+            s = Lanes::Select(hasA, s, zero);
+            const Float t = Lanes::Select(hasE, Lanes::Div(Lanes::Add(Lanes::Mul(b, s), f), safeE), zero);
+            // t outside B: clamp it and redo s for that end of B
+            s = Lanes::Select(Lanes::Less(t, zero), sStart, Lanes::Select(Lanes::Greater(t, one), sEnd, s));
+            s = Lanes::Select(hasA, s, zero);
+
+            const LaneVec3 c1 = MulAdd(p1, d1, s), c2 = MulAdd(p2, d2, ClampUnit(t));
+            const LaneVec3 delta = Sub(c2, c1);
+            const Float distSq = Dot(delta, delta);
+            const Float dist = Lanes::Sqrt(distSq);
+            const Mask apart = Lanes::Greater(distSq, epsilon);
+            const LaneVec3 n = Scale(delta, Lanes::Div(one, Lanes::Max(dist, epsilon)));
+            const LaneVec3 normal = { Lanes::Select(apart, n.x, zero), Lanes::Select(apart, n.y, one), Lanes::Select(apart, n.z, zero) };
+
+            const Float radiusA = Lanes::Load(&batch.radiusA[i]), radiusB = Lanes::Load(&batch.radiusB[i]);
+            StoreVec3(batch.normal, i, normal);
+            Lanes::Store(&batch.depth[i], Lanes::Sub(Lanes::Add(radiusA, radiusB), dist));
+            StoreVec3(batch.pointA, i, MulAdd(c1, normal, radiusA));
+            StoreVec3(batch.pointB, i, MulAdd(c2, normal, Lanes::Sub(zero, radiusB)));
+        }
+
+        // Branch-free SphereBoxContact() over one step of pairs
+        void SphereBoxStep(SphereBoxBatch& batch, size_t i) {
+            const Float zero = Lanes::Set(0.0f), one = Lanes::Set(1.0f), minusOne = Lanes::Set(-1.0f);
+            const LaneVec3 center = LoadVec3(batch.center, i);
+            const LaneVec3 boxCenter = LoadVec3(batch.boxCenter, i);
+            const LaneVec3 ax = LoadVec3(batch.axisX, i), ay = LoadVec3(batch.axisY, i), az = LoadVec3(batch.axisZ, i);
+            const LaneVec3 h = LoadVec3(batch.halfExtents, i);
+            const Float radius = Lanes::Load(&batch.radius[i]);
+
+            const LaneVec3 d = Sub(center, boxCenter);
+            const LaneVec3 local = { Dot(d, ax), Dot(d, ay), Dot(d, az) };
+            const LaneVec3 clamped = { Lanes::Min(Lanes::Max(local.x, Lanes::Sub(zero, h.x)), h.x),
+                                       Lanes::Min(Lanes::Max(local.y, Lanes::Sub(zero, h.y)), h.y),
+                                       Lanes::Min(Lanes::Max(local.z, Lanes::Sub(zero, h.z)), h.z) };
+
+            // Outside: towards the clamped point
+            const LaneVec3 delta = Sub(local, clamped);
+            const Float dist = Lanes::Sqrt(Dot(delta, delta));
+            const LaneVec3 outwardOut = Scale(delta, Lanes::Div(one, Lanes::Max(dist, Lanes::Set(kDegenerateLengthSq))));
+
+            // Inside: out through the face with the least penetration
+            const LaneVec3 pen = { Lanes::Sub(h.x, Lanes::Abs(local.x)), Lanes::Sub(h.y, Lanes::Abs(local.y)), Lanes::Sub(h.z, Lanes::Abs(local.z)) };
+            const LaneVec3 sign = { Lanes::Select(Lanes::Less(local.x, zero), minusOne, one),
+                                    Lanes::Select(Lanes::Less(local.y, zero), minusOne, one),
+                                    Lanes::Select(Lanes::Less(local.z, zero), minusOne, one) };
+            const Mask useY = Lanes::Less(pen.y, pen.x);
+            const Float minXY = Lanes::Select(useY, pen.y, pen.x);
+            const Mask useZ = Lanes::Less(pen.z, minXY);
+            const LaneVec3 outwardIn = { Lanes::Select(useZ, zero, Lanes::Select(useY, zero, sign.x)),
+                                         Lanes::Select(useZ, zero, Lanes::Select(useY, sign.y, zero)),
+                                         Lanes::Select(useZ, sign.z, zero) };
+            const LaneVec3 surfaceIn = { Lanes::Select(useZ, local.x, Lanes::Select(useY, local.x, Lanes::Mul(sign.x, h.x))),
+                                         Lanes::Select(useZ, local.y, Lanes::Select(useY, Lanes::Mul(sign.y, h.y), local.y)),
+                                         Lanes::Select(useZ, Lanes::Mul(sign.z, h.z), local.z) };
+            const Float penIn = Lanes::Select(useZ, pen.z, minXY);
+
+            const Mask inside = Lanes::And(Lanes::And(Lanes::LessEqual(Lanes::Abs(local.x), h.x), Lanes::LessEqual(Lanes::Abs(local.y), h.y)),
+                                           Lanes::LessEqual(Lanes::Abs(local.z), h.z));
+            const LaneVec3 outward = { Lanes::Select(inside, outwardIn.x, outwardOut.x), Lanes::Select(inside, outwardIn.y, outwardOut.y),
+                                       Lanes::Select(inside, outwardIn.z, outwardOut.z) };
+            const LaneVec3 surface = { Lanes::Select(inside, surfaceIn.x, clamped.x), Lanes::Select(inside, surfaceIn.y, clamped.y),
+                                       Lanes::Select(inside, surfaceIn.z, clamped.z) };
+            const Float depth = Lanes::Select(inside, Lanes::Add(radius, penIn), Lanes::Sub(radius, dist));
+
+            // Back to world space; the normal points from the sphere into the box
+            const LaneVec3 outwardWorld = MulAdd(MulAdd(Scale(ax, outward.x), ay, outward.y), az, outward.z);
+            const LaneVec3 normal = Scale(outwardWorld, minusOne);
+            const LaneVec3 pointB = MulAdd(MulAdd(MulAdd(boxCenter, ax, surface.x), ay, surface.y), az, surface.z);
+            StoreVec3(batch.normal, i, normal);
+            Lanes::Store(&batch.depth[i], depth);
+            StoreVec3(batch.pointA, i, MulAdd(center, normal, radius));
+            StoreVec3(batch.pointB, i, pointB);
+        }
+
+        void CopyInputs(const SegmentPairBatch& from, size_t i, SegmentPairBatch& to, size_t j) {
+            for (int k = 0; k < 3; ++k) {
+                to.a0[k][j] = from.a0[k][i];
+                to.a1[k][j] = from.a1[k][i];
+                to.b0[k][j] = from.b0[k][i];
+                to.b1[k][j] = from.b1[k][i];
+            }
+            to.radiusA[j] = from.radiusA[i];
+            to.radiusB[j] = from.radiusB[i];
+        }
+
+        void CopyInputs(const SphereBoxBatch& from, size_t i, SphereBoxBatch& to, size_t j) {
+            for (int k = 0; k < 3; ++k) {
+                to.center[k][j] = from.center[k][i];
+                to.boxCenter[k][j] = from.boxCenter[k][i];
+                to.axisX[k][j] = from.axisX[k][i];
+                to.axisY[k][j] = from.axisY[k][i];
+                to.axisZ[k][j] = from.axisZ[k][i];
+                to.halfExtents[k][j] = from.halfExtents[k][i];
+            }
+            to.radius[j] = from.radius[i];
+        }
+
+        template <typename Batch>
+        void CopyOutputs(const Batch& from, size_t i, Batch& to, size_t j) {
+            for (int k = 0; k < 3; ++k) {
+                to.normal[k][j] = from.normal[k][i];
+                to.pointA[k][j] = from.pointA[k][i];
+                to.pointB[k][j] = from.pointB[k][i];
+            }
+            to.depth[j] = from.depth[i];
+        }
+
+        // Whole steps in place; a trailing partial step runs on a padded copy so
+        // every pair takes the same code path
+        template <typename Batch, typename Step>
+        void RunSteps(Batch& batch, size_t begin, size_t end, Step step) {
+            size_t i = begin;
+            for (; i + Lanes::kWidth <= end; i += Lanes::kWidth)
+                step(batch, i);
+            if (i < end) {
+                Batch tail;
+                tail.Resize(Lanes::kWidth);
+                for (size_t k = 0; k < static_cast<size_t>(Lanes::kWidth); ++k)
+                    CopyInputs(batch, std::min(i + k, end - 1), tail, k);
+                step(tail, 0);
+                for (size_t k = 0; i + k < end; ++k)
+                    CopyOutputs(tail, k, batch, i + k);
+            }
+        }
+
+    } // namespace
+
+    void CollideSegments(SegmentPairBatch& batch, size_t begin, size_t end) {
+        RunSteps(batch, begin, end, SegmentStep);
+    }
+
+    void CollideSphereBoxes(SphereBoxBatch& batch, size_t begin, size_t end) {
+        RunSteps(batch, begin, end, SphereBoxStep);
+    }
+
+    namespace Scalar {
+
+        void CollideSegments(SegmentPairBatch& batch, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Math::Vec3 a0(batch.a0[0][i], batch.a0[1][i], batch.a0[2][i]), a1(batch.a1[0][i], batch.a1[1][i], batch.a1[2][i]);
+                const Math::Vec3 b0(batch.b0[0][i], batch.b0[1][i], batch.b0[2][i]), b1(batch.b1[0][i], batch.b1[1][i], batch.b1[2][i]);
+                Math::Vec3 normal;
+                const RawContact contact = SegmentContact(a0, a1, batch.radiusA[i], b0, b1, batch.radiusB[i], normal);
+                for (int k = 0; k < 3; ++k) {
+                    batch.normal[k][i] = normal[k];
+                    batch.pointA[k][i] = contact.pointA[k];
+                    batch.pointB[k][i] = contact.pointB[k];
+                }
+                batch.depth[i] = contact.depth;
+            }
+        }
+
+        void CollideSphereBoxes(SphereBoxBatch& batch, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                BoxFrame box;
+                for (int k = 0; k < 3; ++k) {
+                    box.center[k] = batch.boxCenter[k][i];
+                    box.axes[0][k] = batch.axisX[k][i];
+                    box.axes[1][k] = batch.axisY[k][i];
+                    box.axes[2][k] = batch.axisZ[k][i];
+                    box.half[k] = batch.halfExtents[k][i];
+                }
+                const Math::Vec3 center(batch.center[0][i], batch.center[1][i], batch.center[2][i]);
+                Math::Vec3 normal;
+                const RawContact contact = SphereBoxContact(center, batch.radius[i], box, normal);
+                for (int k = 0; k < 3; ++k) {
+                    batch.normal[k][i] = normal[k];
+                    batch.pointA[k][i] = contact.pointA[k];
+                    batch.pointB[k][i] = contact.pointB[k];
+                }
+                batch.depth[i] = contact.depth;
+            }
+        }
+
+    } // namespace Scalar
+
+    // ----------------------------------------------------------
+    // RAY CASTS
+    // ----------------------------------------------------------
+
+    namespace {
+
+        // Stands in for zero direction components, so slab tests never compute 0 * inf
+        constexpr float kMinDirection = 1e-20f;
+        constexpr int   kCastMaxIterations = 32;
+
+        float SafeInverse(float d) {
+            return 1.0f / (std::fabs(d) < kMinDirection ? std::copysign(kMinDirection, d) : d);
+        }
+
+        // Slab test of a box swept along a ray against a fat box, within [0, maxDistance]
+        bool SweptBoxHits(const BroadphaseRay& ray, const Math::AABB& box, float maxDistance) {
+            float tNear = 0.0f, tFar = maxDistance;
+            for (int k = 0; k < 3; ++k) {
+                const float inverse = SafeInverse(ray.direction[k]);
+                const float lo = (box.min[k] - ray.extents[k] - ray.origin[k]) * inverse;
+                const float hi = (box.max[k] + ray.extents[k] - ray.origin[k]) * inverse;
+                tNear = std::max(tNear, std::min(lo, hi));
+                tFar = std::min(tFar, std::max(lo, hi));
+            }
+            return tNear <= tFar;
+        }
+
+        // Entry distance of a ray starting outside a sphere; false if it misses
+        bool RaySphere(const Math::Vec3& origin, const Math::Vec3& direction, const Math::Vec3& center, float radius, float& outT) {
+            const Math::Vec3 m = origin - center;
+            const float b = Math::Dot(m, direction);
+            const float disc = b * b - (Math::Dot(m, m) - radius * radius);
+            if (b > 0.0f || disc < 0.0f)
+                return false;
+            outT = -b - std::sqrt(disc);
+            return true;
+        }
+
+    } // namespace
+
+    void DynamicAABBTree::RayCast(const BroadphaseRay* rays, uint32_t count, const RayCastCallback& callback) const {
+        if (m_Root == kNullNode)
+            return;
+
+        constexpr int kWidth = Lanes::kWidth;
+        constexpr int kMaxStack = 256;
+        uint32_t stack[kMaxStack];
+        float origin[3][kWidth], inverse[3][kWidth], extents[3][kWidth], direction[3][kWidth], maxDistance[kWidth];
+        for (uint32_t first = 0; first < count; first += kWidth) {
+            // The last packet is padded with rays that can never hit
+            for (int lane = 0; lane < kWidth; ++lane) {
+                const bool active = first + lane < count;
+                const BroadphaseRay& ray = rays[active ? first + lane : first];
+                for (int k = 0; k < 3; ++k) {
+                    origin[k][lane] = ray.origin[k];
+                    inverse[k][lane] = SafeInverse(ray.direction[k]);
+                    extents[k][lane] = ray.extents[k];
+                    direction[k][lane] = ray.direction[k];
+                }
+                maxDistance[lane] = active ? ray.maxDistance : -1.0f;
+            }
+            Float o[3], inv[3], e[3];
+            for (int k = 0; k < 3; ++k) {
+                o[k] = Lanes::Load(origin[k]);
+                inv[k] = Lanes::Load(inverse[k]);
+                e[k] = Lanes::Load(extents[k]);
+            }
+
+            int top = 0;
+            stack[top++] = m_Root;
+            while (top > 0) {
+                const uint32_t index = stack[--top];
+                const Node& node = m_Nodes[index];
+                // One slab test of the node against the whole packet, with each ray
+                // clipped to its closest hit so far
+                Float tNear = Lanes::Set(0.0f), tFar = Lanes::Load(maxDistance);
+                for (int k = 0; k < 3; ++k) {
+                    const Float lo = Lanes::Mul(Lanes::Sub(Lanes::Sub(Lanes::Set(node.box.min[k]), e[k]), o[k]), inv[k]);
+                    const Float hi = Lanes::Mul(Lanes::Sub(Lanes::Add(Lanes::Set(node.box.max[k]), e[k]), o[k]), inv[k]);
+                    tNear = Lanes::Max(tNear, Lanes::Min(lo, hi));
+                    tFar = Lanes::Min(tFar, Lanes::Max(lo, hi));
+                }
+                const int hits = Lanes::MoveMask(Lanes::LessEqual(tNear, tFar));
+                if (hits == 0)
+                    continue;
+
+                if (node.IsLeaf()) {
+                    for (int lane = 0; lane < kWidth; ++lane) {
+                        if (hits & (1 << lane))
+                            maxDistance[lane] = callback(first + lane, index, maxDistance[lane]);
+                    }
+                    continue;
+                }
+                // Near child on top, judged along the first ray that reached this node
+                int lane = 0;
+                while (!(hits & (1 << lane)))
+                    ++lane;
+                const Math::Vec3 d(direction[0][lane], direction[1][lane], direction[2][lane]);
+                const bool child1Near = Math::Dot(m_Nodes[node.child2].box.Center() - m_Nodes[node.child1].box.Center(), d) >= 0.0f;
+                stack[top++] = child1Near ? node.child2 : node.child1;
+                stack[top++] = child1Near ? node.child1 : node.child2;
+            }
+        }
+    }
+
+    void SweepAndPruneBroadphase::RayCast(const BroadphaseRay* rays, uint32_t count, const RayCastCallback& callback) const {
+        for (uint32_t i = 0; i < count; ++i) {
+            float maxDistance = rays[i].maxDistance;
+            for (const Entry& entry : m_Sorted) {
+                if (entry.proxy != InvalidProxy && SweptBoxHits(rays[i], entry.box, maxDistance))
+                    maxDistance = callback(i, entry.proxy, maxDistance);
+            }
+        }
+    }
+
+    bool RayCast(const CollisionShape& shape, const Math::Vec3& position, const Math::Quat& rotation,
+                 const Math::Vec3& origin, const Math::Vec3& direction, float maxDistance, CastHit& outHit) {
+        if (shape.type == ShapeType::ConvexHull)
+            return ShapeCast(CollisionShape::Sphere(0.0f), origin, Math::Quat(), direction, maxDistance, shape, position, rotation, outHit);
+
+        // In the shape's frame: spheres and capsules are centred on the origin, boxes axis aligned
+        const Math::Quat inverse = Math::Conjugate(rotation);
+        const Math::Vec3 o = Math::Rotate(inverse, origin - position);
+        const Math::Vec3 d = Math::Rotate(inverse, direction);
+        const float r = shape.radius;
+        float t = FLT_MAX;
+        Math::Vec3 normal;
+        bool inside = false;
+        switch (shape.type) {
+        case ShapeType::Sphere:
+            inside = Math::Dot(o, o) <= r * r;
+            if (!inside && RaySphere(o, d, Math::Vec3(0.0f), r, t))
+                normal = (o + d * t) / r;
+            break;
+        case ShapeType::Capsule: {
+            const float h = shape.halfHeight;
+            inside = Math::LengthSquared(o - Math::Vec3(0.0f, std::min(std::max(o.y, -h), h), 0.0f)) <= r * r;
+            if (inside)
+                break;
+            // The side of the infinite cylinder first: the caps lie inside it, so
+            // a side hit within the segment is the first hit
+            const float a = d.x * d.x + d.z * d.z;
+            if (a > kDegenerateLengthSq) {
+                const float b = o.x * d.x + o.z * d.z;
+                const float disc = b * b - a * (o.x * o.x + o.z * o.z - r * r);
+                const float side = (-b - std::sqrt(std::max(disc, 0.0f))) / a;
+                if (disc >= 0.0f && side >= 0.0f && std::fabs(o.y + d.y * side) <= h) {
+                    t = side;
+                    normal = Math::Vec3(o.x + d.x * side, 0.0f, o.z + d.z * side) / r;
+                }
+            }
+            if (t == FLT_MAX) {
+                for (float y : { -h, h }) {
+                    float capT;
+                    if (RaySphere(o, d, Math::Vec3(0.0f, y, 0.0f), r, capT) && capT < t) {
+                        t = capT;
+                        normal = (o + d * capT - Math::Vec3(0.0f, y, 0.0f)) / r;
+                    }
+                }
+            }
+            break;
+        }
+        default: {
+            inside = true;
+            float tNear = -FLT_MAX, tFar = FLT_MAX;
+            for (int k = 0; k < 3; ++k) {
+                inside &= std::fabs(o[k]) <= shape.halfExtents[k];
+                const float inverseD = SafeInverse(d[k]);
+                float lo = (-shape.halfExtents[k] - o[k]) * inverseD, hi = (shape.halfExtents[k] - o[k]) * inverseD;
+                if (lo > hi)
+                    std::swap(lo, hi);
+                if (lo > tNear) {
+                    tNear = lo;
+                    normal = Math::Vec3(0.0f);
+                    normal[k] = d[k] > 0.0f ? -1.0f : 1.0f;
+                }
+                tFar = std::min(tFar, hi);
+            }
+            if (!inside && tNear <= tFar && tNear >= 0.0f)
+                t = tNear;
+            break;
+        }
+        }
+
+        if (inside) {
+            outHit = { 0.0f, origin, -direction };
+            return true;
+        }
+        if (t > maxDistance)
+            return false;
+        outHit = { t, origin + direction * t, Math::Rotate(rotation, normal) };
+        return true;
+    }
+
+    bool ShapeCast(const CollisionShape& castShape, const Math::Vec3& castPosition, const Math::Quat& castRotation,
+                   const Math::Vec3& direction, float maxDistance,
+                   const CollisionShape& shape, const Math::Vec3& position, const Math::Quat& rotation, CastHit& outHit) {
+        PosedShape cast = { &castShape, castPosition, castRotation };
+        const PosedShape target = { &shape, position, rotation };
+        const float radius = GetRadius(castShape) + GetRadius(shape);
+        float t = 0.0f;
+        for (int iteration = 0; iteration < kCastMaxIterations; ++iteration) {
+            cast.position = castPosition + direction * t;
+            const GjkResult gjk = Gjk(cast, target);
+            if (gjk.overlap || gjk.distance < radius) {
+                // Overlapping from the start (or, through rounding, after a step)
+                outHit = { t, cast.position, -direction };
+                return true;
+            }
+            const Math::Vec3 normal = (gjk.pointB - gjk.pointA) / gjk.distance;
+            const float separation = gjk.distance - radius;
+            if (separation <= kCastTolerance) {
+                outHit = { t, gjk.pointB - normal * GetRadius(shape), -normal };
+                return true;
+            }
+            // B lies beyond the plane through its closest point, so the cast shape
+            // cannot touch it before reaching that plane
+            const float closing = Math::Dot(direction, normal);
+            if (closing <= 0.0f)
+                return false;
+            t += (separation - 0.5f * kCastTolerance) / closing;
+            if (t > maxDistance)
+                return false;
+        }
+        return false;
+    }
+
+    // ----------------------------------------------------------
+    // NARROWPHASE
+    // ----------------------------------------------------------
+
+    namespace {
+
+        /*
+         * Carries accumulated impulses over from last frame's contacts with nearby
+         * anchors. With accumulate set, old contacts that still touch along the
+         * new normal are kept too (for generators that find one point per frame).
+         */
+        void MergeManifold(ContactManifold& manifold, const ContactManifold& old, bool accumulate, float margin,
+                           const Math::Vec3& positionA, const Math::Quat& rotationA,
+                           const Math::Vec3& positionB, const Math::Quat& rotationB) {
+            const float thresholdSq = kPersistentThreshold * kPersistentThreshold;
+            bool used[kMaxManifoldPoints] = {};
+            for (uint32_t i = 0; i < manifold.pointCount; ++i) {
+                ContactPoint& point = manifold.points[i];
+                int match = -1;
+                float bestDistSq = thresholdSq;
+                for (uint32_t j = 0; j < old.pointCount; ++j) {
+                    const float distSq = Math::LengthSquared(point.localA - old.points[j].localA);
+                    if (!used[j] && distSq < bestDistSq) {
+                        bestDistSq = distSq;
+                        match = static_cast<int>(j);
+                    }
+                }
+                if (match >= 0) {
+                    used[match] = true;
+                    point.normalImpulse = old.points[match].normalImpulse;
+                    point.tangentImpulse[0] = old.points[match].tangentImpulse[0];
+                    point.tangentImpulse[1] = old.points[match].tangentImpulse[1];
+                }
+            }
+            if (!accumulate || manifold.pointCount != 1)
+                return;
+
+            ContactPoint candidates[kMaxManifoldPoints + 1] = { manifold.points[0] };
+            uint32_t count = 1;
+            for (uint32_t j = 0; j < old.pointCount; ++j) {
+                if (used[j])
+                    continue;
+                ContactPoint point = old.points[j];
+                const Math::Vec3 pointA = positionA + Math::Rotate(rotationA, point.localA);
+                const Math::Vec3 pointB = positionB + Math::Rotate(rotationB, point.localB);
+                const float depth = Math::Dot(manifold.normal, pointA - pointB);
+                const Math::Vec3 drift = pointA - pointB - manifold.normal * depth;
+                if (depth < -margin || Math::LengthSquared(drift) > thresholdSq)
+                    continue;
+                point.position = (pointA + pointB) * 0.5f;
+                point.depth = depth;
+                candidates[count++] = point;
+            }
+
+            Math::Vec3 positions[kMaxManifoldPoints + 1];
+            float depths[kMaxManifoldPoints + 1];
+            for (uint32_t i = 0; i < count; ++i) {
+                positions[i] = candidates[i].position;
+                depths[i] = candidates[i].depth;
+            }
+            uint32_t selected[kMaxManifoldPoints];
+            manifold.pointCount = SelectFour(positions, depths, count, manifold.normal, selected);
+            for (uint32_t i = 0; i < manifold.pointCount; ++i)
+                manifold.points[i] = candidates[selected[i]];
+        }
+
+    } // namespace
+
+    void NarrowPhase::Collide(const CollisionShape* shapes, const Math::Vec3* positions, const Math::Quat* rotations,
+                              const BodyPair* pairs, uint32_t pairCount, float margin) {
+        ProfileScope scope("Physics::NarrowPhase");
+        std::swap(m_Previous, m_Manifolds);
+        std::swap(m_PreviousKeys, m_ManifoldKeys);
+        m_Fresh.resize(pairCount);
+        m_Swapped.resize(pairCount);
+        m_SegmentPairs.clear();
+        m_SphereBoxPairs.clear();
+        m_GeneralPairs.clear();
+
+        // Bucket pairs by kernel; each pair is computed with its lower shape type first
+        for (uint32_t i = 0; i < pairCount; ++i) {
+            ContactManifold& manifold = m_Fresh[i];
+            manifold.bodyA = std::min(pairs[i].a, pairs[i].b);
+            manifold.bodyB = std::max(pairs[i].a, pairs[i].b);
+            manifold.pointCount = 0;
+            const ShapeType typeA = shapes[manifold.bodyA].type, typeB = shapes[manifold.bodyB].type;
+            m_Swapped[i] = typeA > typeB;
+            const ShapeType low = std::min(typeA, typeB), high = std::max(typeA, typeB);
+            if (high <= ShapeType::Capsule)
+                m_SegmentPairs.push_back(i);
+            else if (low == ShapeType::Sphere && high == ShapeType::Box)
+                m_SphereBoxPairs.push_back(i);
+            else
+                m_GeneralPairs.push_back(i);
+        }
+        m_SegmentBatch.Resize(m_SegmentPairs.size());
+        m_SphereBoxBatch.Resize(m_SphereBoxPairs.size());
+
+        auto first = [&](uint32_t pair) { return m_Swapped[pair] ? m_Fresh[pair].bodyB : m_Fresh[pair].bodyA; };
+        auto second = [&](uint32_t pair) { return m_Swapped[pair] ? m_Fresh[pair].bodyA : m_Fresh[pair].bodyB; };
+
+        // Turns one pair's raw result into its manifold, merged with last frame's
+        auto finish = [&](uint32_t pair, RawManifold& raw) {
+            ContactManifold& manifold = m_Fresh[pair];
+            if (raw.count == 0)
+                return;
+            if (m_Swapped[pair])
+                Flip(raw);
+            const uint32_t a = manifold.bodyA, b = manifold.bodyB;
+            FinishManifold(raw, positions[a], rotations[a], positions[b], rotations[b], manifold);
+            // Keys are searched instead of the manifolds: 8 bytes apart, not 236
+            const uint64_t key = (uint64_t(a) << 32) | b;
+            const auto found = std::lower_bound(m_PreviousKeys.begin(), m_PreviousKeys.end(), key);
+            const size_t index = static_cast<size_t>(found - m_PreviousKeys.begin());
+            if (found != m_PreviousKeys.end() && *found == key && index < m_Previous.size()) {
+                const bool accumulate = shapes[a].type != ShapeType::Sphere && shapes[b].type != ShapeType::Sphere;
+                MergeManifold(manifold, m_Previous[index], accumulate, margin, positions[a], rotations[a], positions[b], rotations[b]);
+            }
+        };
+
+        // Copies one kernel result out of a batch's SoA outputs
+        auto finishBatched = [&](uint32_t pair, const auto& batch, size_t k) {
+            RawManifold raw;
+            if (batch.depth[k] >= -margin) {
+                RawContact& contact = raw.points[raw.count++];
+                for (int c = 0; c < 3; ++c) {
+                    raw.normal[c] = batch.normal[c][k];
+                    contact.pointA[c] = batch.pointA[c][k];
+                    contact.pointB[c] = batch.pointB[c][k];
+                }
+                contact.depth = batch.depth[k];
+            }
+            finish(pair, raw);
+        };
+
+        const uint32_t segmentJobs = static_cast<uint32_t>((m_SegmentPairs.size() + kKernelPairsPerJob - 1) / kKernelPairsPerJob);
+        const uint32_t sphereBoxJobs = static_cast<uint32_t>((m_SphereBoxPairs.size() + kKernelPairsPerJob - 1) / kKernelPairsPerJob);
+        const uint32_t generalJobs = static_cast<uint32_t>((m_GeneralPairs.size() + kGeneralPairsPerJob - 1) / kGeneralPairsPerJob);
+
+        // Every pair owns its slot in m_Fresh, so chunks never share output
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, segmentJobs + sphereBoxJobs + generalJobs, 1, [&](Threading::JobArgs args) {
+            uint32_t job = args.jobIndex;
+            if (job < segmentJobs) {
+                const size_t begin = size_t(job) * kKernelPairsPerJob;
+                const size_t end = std::min(begin + kKernelPairsPerJob, m_SegmentPairs.size());
+                SegmentPairBatch& batch = m_SegmentBatch;
+                for (size_t k = begin; k < end; ++k) {
+                    const uint32_t pair = m_SegmentPairs[k];
+                    const uint32_t a = first(pair), b = second(pair);
+                    Math::Vec3 a0, a1, b0, b1;
+                    GetSegment(shapes[a], positions[a], rotations[a], a0, a1);
+                    GetSegment(shapes[b], positions[b], rotations[b], b0, b1);
+                    for (int c = 0; c < 3; ++c) {
+                        batch.a0[c][k] = a0[c];
+                        batch.a1[c][k] = a1[c];
+                        batch.b0[c][k] = b0[c];
+                        batch.b1[c][k] = b1[c];
+                    }
+                    batch.radiusA[k] = shapes[a].radius;
+                    batch.radiusB[k] = shapes[b].radius;
+                }
+                CollideSegments(batch, begin, end);
+                for (size_t k = begin; k < end; ++k)
+                    finishBatched(m_SegmentPairs[k], batch, k);
+                return;
+            }
+            job -= segmentJobs;
+            if (job < sphereBoxJobs) {
+                const size_t begin = size_t(job) * kKernelPairsPerJob;
+                const size_t end = std::min(begin + kKernelPairsPerJob, m_SphereBoxPairs.size());
+                SphereBoxBatch& batch = m_SphereBoxBatch;
+                for (size_t k = begin; k < end; ++k) {
+                    const uint32_t pair = m_SphereBoxPairs[k];
+                    const uint32_t a = first(pair), b = second(pair);
+                    const BoxFrame box = MakeBoxFrame(shapes[b], positions[b], rotations[b]);
+                    for (int c = 0; c < 3; ++c) {
+                        batch.center[c][k] = positions[a][c];
+                        batch.boxCenter[c][k] = box.center[c];
+                        batch.axisX[c][k] = box.axes[0][c];
+                        batch.axisY[c][k] = box.axes[1][c];
+                        batch.axisZ[c][k] = box.axes[2][c];
+                        batch.halfExtents[c][k] = box.half[c];
+                    }
+                    batch.radius[k] = shapes[a].radius;
+                }
+                CollideSphereBoxes(batch, begin, end);
+                for (size_t k = begin; k < end; ++k)
+                    finishBatched(m_SphereBoxPairs[k], batch, k);
+                return;
+            }
+            job -= sphereBoxJobs;
+            const size_t begin = size_t(job) * kGeneralPairsPerJob;
+            const size_t end = std::min(begin + kGeneralPairsPerJob, m_GeneralPairs.size());
+            for (size_t k = begin; k < end; ++k) {
+                const uint32_t pair = m_GeneralPairs[k];
+                const uint32_t a = first(pair), b = second(pair);
+                RawManifold raw;
+                if (!CollideOrdered(shapes[a], positions[a], rotations[a], shapes[b], positions[b], rotations[b], margin, raw))
+                    raw.count = 0;
+                finish(pair, raw);
+            }
+        });
+        Threading::JobSystem::Wait(ctx);
+
+        // Sort keys rather than whole manifolds, then gather the touching ones
+        m_SortKeys.clear();
+        for (uint32_t i = 0; i < pairCount; ++i) {
+            const ContactManifold& manifold = m_Fresh[i];
+            if (manifold.pointCount > 0)
+                m_SortKeys.push_back({ (uint64_t(manifold.bodyA) << 32) | manifold.bodyB, i });
+        }
+        std::sort(m_SortKeys.begin(), m_SortKeys.end());
+        m_Manifolds.resize(m_SortKeys.size());
+        m_ManifoldKeys.resize(m_SortKeys.size());
+        for (size_t i = 0; i < m_SortKeys.size(); ++i) {
+            m_Manifolds[i] = m_Fresh[m_SortKeys[i].second];
+            m_ManifoldKeys[i] = m_SortKeys[i].first;
+        }
+
+        Profiling::SetCounter("NarrowPhase.Pairs", static_cast<double>(pairCount));
+        Profiling::SetCounter("NarrowPhase.Manifolds", static_cast<double>(m_Manifolds.size()));
+    }
+
+    void NarrowPhase::SaveState(StateWriter& writer) const {
+        writer.WriteArray(m_Manifolds);
+        writer.WriteArray(m_ManifoldKeys);
+    }
+
+    void NarrowPhase::LoadState(StateReader& reader) {
+        reader.ReadArray(m_Manifolds);
+        reader.ReadArray(m_ManifoldKeys);
+    }
+
+} // namespace Physics
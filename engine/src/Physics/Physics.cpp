@@ -0,0 +1,931 @@
+#include "Physics/Physics.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+
+namespace Physics {
+
+    namespace {
+
+        // Small islands are packed into jobs of at least this many bodies
+        constexpr uint32_t kBodiesPerJob = 64;
+        // Largest movement per step, so one bad step cannot fling a body away
+        constexpr float kMaxTranslation = 2.0f;
+        constexpr float kMaxRotation = 0.5f * 3.14159265f;
+        // Queries per job; rays are cheap, and a multiple of every SIMD packet width
+        constexpr uint32_t kRaysPerJob = 256;
+        constexpr uint32_t kShapeQueriesPerJob = 32;
+
+        // Tells snapshots of different worlds apart
+        std::atomic<uint64_t> s_NextWorldId{ 1 };
+
+        bool PairLess(const BodyPair& l, const BodyPair& r) {
+            return l.a < r.a || (l.a == r.a && l.b < r.b);
+        }
+
+        // 3x3 matrices are stored as three row vectors
+        Math::Vec3 Multiply(const Math::Vec3 rows[3], const Math::Vec3& v) {
+            return { Math::Dot(rows[0], v), Math::Dot(rows[1], v), Math::Dot(rows[2], v) };
+        }
+
+        // Inverse of a symmetric matrix; zero if it is singular
+        void InvertSymmetric(const Math::Vec3 m[3], Math::Vec3 out[3]) {
+            const Math::Vec3 c0 = Math::Cross(m[1], m[2]);
+            const Math::Vec3 c1 = Math::Cross(m[2], m[0]);
+            const Math::Vec3 c2 = Math::Cross(m[0], m[1]);
+            float det = Math::Dot(m[0], c0);
+            det = (det != 0.0f) ? 1.0f / det : 0.0f;
+            out[0] = c0 * det;
+            out[1] = c1 * det;
+            out[2] = c2 * det;
+        }
+
+        // Diagonal of the inverse inertia tensor in body space. The centre of mass
+        // is the shape origin; hulls use the box of their vertex bounds.
+        Math::Vec3 ComputeInverseInertia(const CollisionShape& shape, float mass) {
+            Math::Vec3 inertia;
+            switch (shape.type) {
+            case ShapeType::Sphere:
+                inertia = Math::Vec3(0.4f * mass * shape.radius * shape.radius);
+                break;
+            case ShapeType::Capsule: {
+                // Cylinder plus two hemispheres, mass split by volume
+                const float r = shape.radius, h = 2.0f * shape.halfHeight;
+                const float cylinder = r * r * h, sphere = 4.0f / 3.0f * r * r * r;
+                const float mc = mass * cylinder / (cylinder + sphere), ms = mass - mc;
+                const float axial = mc * 0.5f * r * r + ms * 0.4f * r * r;
+                const float lateral = mc * (h * h / 12.0f + 0.25f * r * r) + ms * (0.4f * r * r + 0.25f * h * h + 0.375f * h * r);
+                inertia = { lateral, axial, lateral };
+                break;
+            }
+            default: {
+                Math::Vec3 e = shape.halfExtents;
+                if (shape.type == ShapeType::ConvexHull) {
+                    Math::AABB bounds;
+                    for (uint32_t i = 0; i < shape.hullVertexCount; ++i)
+                        bounds.Merge(shape.hullVertices[i]);
+                    e = bounds.Extents();
+                }
+                const float k = mass / 3.0f;
+                inertia = { k * (e.y * e.y + e.z * e.z), k * (e.x * e.x + e.z * e.z), k * (e.x * e.x + e.y * e.y) };
+                break;
+            }
+            }
+            return { inertia.x > 0.0f ? 1.0f / inertia.x : 0.0f,
+                     inertia.y > 0.0f ? 1.0f / inertia.y : 0.0f,
+                     inertia.z > 0.0f ? 1.0f / inertia.z : 0.0f };
+        }
+
+        // R * diag(local) * R^T
+        void ComputeWorldInverseInertia(const Math::Quat& rotation, const Math::Vec3& local, Math::Vec3 rows[3]) {
+            const Math::Vec3 axes[3] = {
+                Math::Rotate(rotation, { 1.0f, 0.0f, 0.0f }) * local.x,
+                Math::Rotate(rotation, { 0.0f, 1.0f, 0.0f }) * local.y,
+                Math::Rotate(rotation, { 0.0f, 0.0f, 1.0f }) * local.z,
+            };
+            const Math::Vec3 unit[3] = {
+                Math::Rotate(rotation, { 1.0f, 0.0f, 0.0f }),
+                Math::Rotate(rotation, { 0.0f, 1.0f, 0.0f }),
+                Math::Rotate(rotation, { 0.0f, 0.0f, 1.0f }),
+            };
+            for (int r = 0; r < 3; ++r)
+                rows[r] = unit[0] * axes[0][r] + unit[1] * axes[1][r] + unit[2] * axes[2][r];
+        }
+
+        // Two directions perpendicular to the normal
+        void ComputeTangents(const Math::Vec3& n, Math::Vec3& t0, Math::Vec3& t1) {
+            if (std::fabs(n.x) >= 0.57735f)
+                t0 = Math::Normalize(Math::Vec3(n.y, -n.x, 0.0f));
+            else
+                t0 = Math::Normalize(Math::Vec3(0.0f, n.z, -n.y));
+            t1 = Math::Cross(n, t0);
+        }
+
+    } // namespace
+
+    PhysicsWorld::PhysicsWorld(const WorldSettings& settings)
+        : m_Settings(settings), m_Broadphase(Broadphase::Create(settings.broadphase)), m_WorldId(s_NextWorldId++) {}
+
+    BodyId PhysicsWorld::CreateBody(const BodyDesc& desc) {
+        const BodyId body = GetBodyCount();
+        const bool dynamic = desc.type == BodyType::Dynamic && desc.mass > 0.0f;
+        const Math::Quat rotation = Math::Normalize(desc.rotation);
+
+        m_Positions.push_back(desc.position);
+        m_Rotations.push_back(rotation);
+        m_LinearVelocities.push_back(dynamic ? desc.linearVelocity : Math::Vec3());
+        m_AngularVelocities.push_back(dynamic ? desc.angularVelocity : Math::Vec3());
+        m_Shapes.push_back(desc.shape);
+        m_InvMasses.push_back(dynamic ? 1.0f / desc.mass : 0.0f);
+        m_InvInertiaLocal.push_back(dynamic ? ComputeInverseInertia(desc.shape, desc.mass) : Math::Vec3());
+        m_Friction.push_back(desc.friction);
+        m_Restitution.push_back(desc.restitution);
+        m_LinearDamping.push_back(desc.linearDamping);
+        m_AngularDamping.push_back(desc.angularDamping);
+        m_AllowSleep.push_back(desc.allowSleep ? 1 : 0);
+        m_SleepTime.push_back(0.0f);
+        m_SleepingIsland.push_back(kAwake);
+        m_Proxies.push_back(m_Broadphase->CreateProxy(desc.shape.ComputeAABB(desc.position, rotation), body));
+        m_Parent.push_back(body);
+        m_Slot.push_back(kStaticSlot);
+        m_Changed.push_back(m_Version);
+
+        if (dynamic)
+            m_AwakeBodies.push_back(body);
+        return body;
+    }
+
+    JointId PhysicsWorld::CreateBallJoint(BodyId a, BodyId b, const Math::Vec3& worldAnchor) {
+        BallJoint joint;
+        joint.bodyA = a;
+        joint.bodyB = b;
+        joint.localAnchorA = Math::Rotate(Math::Conjugate(m_Rotations[a]), worldAnchor - m_Positions[a]);
+        joint.localAnchorB = Math::Rotate(Math::Conjugate(m_Rotations[b]), worldAnchor - m_Positions[b]);
+        m_Joints.push_back(joint);
+
+        // Jointed bodies stop colliding, including pairs found before the joint existed
+        const BodyPair pair = { std::min(a, b), std::max(a, b) };
+        m_JointPairs.insert(std::lower_bound(m_JointPairs.begin(), m_JointPairs.end(), pair, PairLess), pair);
+        m_Pairs.erase(std::remove_if(m_Pairs.begin(), m_Pairs.end(), [&](const BodyPair& p) {
+            return p.a == pair.a && p.b == pair.b;
+        }), m_Pairs.end());
+
+        WakeBody(a);
+        WakeBody(b);
+        return static_cast<JointId>(m_Joints.size() - 1);
+    }
+
+    BodyType PhysicsWorld::GetBodyType(BodyId body) const {
+        return IsDynamic(body) ? BodyType::Dynamic : BodyType::Static;
+    }
+
+    void PhysicsWorld::SetTransform(BodyId body, const Math::Vec3& position, const Math::Quat& rotation) {
+        m_Positions[body] = position;
+        m_Rotations[body] = Math::Normalize(rotation);
+        m_Broadphase->MoveProxy(m_Proxies[body], m_Shapes[body].ComputeAABB(position, m_Rotations[body]), Math::Vec3(0.0f));
+        m_Changed[body] = m_Version;
+        WakeBody(body);
+    }
+
+    void PhysicsWorld::SetLinearVelocity(BodyId body, const Math::Vec3& velocity) {
+        if (!IsDynamic(body))
+            return;
+        m_LinearVelocities[body] = velocity;
+        m_Changed[body] = m_Version;
+        WakeBody(body);
+    }
+
+    void PhysicsWorld::SetAngularVelocity(BodyId body, const Math::Vec3& velocity) {
+        if (!IsDynamic(body))
+            return;
+        m_AngularVelocities[body] = velocity;
+        m_Changed[body] = m_Version;
+        WakeBody(body);
+    }
+
+    void PhysicsWorld::ApplyLinearImpulse(BodyId body, const Math::Vec3& impulse, const Math::Vec3& worldPoint) {
+        if (!IsDynamic(body))
+            return;
+        Math::Vec3 invInertia[3];
+        ComputeWorldInverseInertia(m_Rotations[body], m_InvInertiaLocal[body], invInertia);
+        m_LinearVelocities[body] += impulse * m_InvMasses[body];
+        m_AngularVelocities[body] += Multiply(invInertia, Math::Cross(worldPoint - m_Positions[body], impulse));
+        m_Changed[body] = m_Version;
+        WakeBody(body);
+    }
+
+    bool PhysicsWorld::IsAwake(BodyId body) const {
+        return IsAwakeDynamic(body);
+    }
+
+    void PhysicsWorld::WakeBody(BodyId body) {
+        if (IsDynamic(body) && m_SleepingIsland[body] != kAwake)
+            WakeIsland(m_SleepingIsland[body]);
+    }
+
+    uint32_t PhysicsWorld::GetSleepingIslandCount() const {
+        return static_cast<uint32_t>(m_SleepingIslands.size() - m_FreeSleepingIslands.size());
+    }
+
+    bool PhysicsWorld::ShouldCollide(BodyId a, BodyId b) const {
+        if (!IsDynamic(a) && !IsDynamic(b))
+            return false;
+        const BodyPair pair = { std::min(a, b), std::max(a, b) };
+        return !std::binary_search(m_JointPairs.begin(), m_JointPairs.end(), pair, PairLess);
+    }
+
+    void PhysicsWorld::WakeIsland(uint32_t sleepingIsland) {
+        SleepingIsland& island = m_SleepingIslands[sleepingIsland];
+        for (uint32_t i = island.bodyStart; i < island.bodyStart + island.bodyCount; ++i) {
+            const BodyId body = m_SleepingBodies[i];
+            m_SleepingIsland[body] = kAwake;
+            m_SleepTime[body] = 0.0f;
+            m_Changed[body] = m_Version;
+            m_AwakeBodies.push_back(body);
+        }
+        // Only used if the island wakes during a step; Collide() drops older ones
+        const auto contacts = m_SleepingContacts.begin() + island.contactStart;
+        m_WokenContacts.insert(m_WokenContacts.end(), contacts, contacts + island.contactCount);
+        island = SleepingIsland();
+        m_FreeSleepingIslands.push_back(sleepingIsland);
+    }
+
+    // ----------------------------------------------------------
+    // Step
+    // ----------------------------------------------------------
+
+    void PhysicsWorld::Step(float dt) {
+        ProfileScope scope("Physics::Step");
+        if (dt <= 0.0f)
+            return;
+
+        UpdatePairs();
+        Collide();
+        BuildIslands();
+
+        {
+            ProfileScope solveScope("Physics::Solve");
+            // Islands share no dynamic bodies, so each job owns everything it writes
+            Threading::JobContext ctx;
+            Threading::JobSystem::Dispatch(ctx, static_cast<uint32_t>(m_JobStart.size() - 1), 1, [&](Threading::JobArgs args) {
+                for (uint32_t k = m_JobStart[args.jobIndex]; k < m_JobStart[args.jobIndex + 1]; ++k)
+                    SolveIsland(m_IslandOrder[k], dt);
+            });
+            Threading::JobSystem::Wait(ctx);
+        }
+
+        SleepIslands();
+        MoveProxies(dt);
+
+        Profiling::SetCounter("Physics.Islands", static_cast<double>(m_IslandCount));
+        Profiling::SetCounter("Physics.AwakeBodies", static_cast<double>(m_AwakeBodies.size()));
+        Profiling::SetCounter("Physics.Contacts", static_cast<double>(m_Contacts.size()));
+        Profiling::SetCounter("Physics.SleepingIslands", static_cast<double>(GetSleepingIslandCount()));
+    }
+
+    void PhysicsWorld::MoveProxies(float dt) {
+        // At the end of the step, so queries between steps see the new poses; the
+        // fat boxes are stretched along the movement expected over the next step
+        ProfileScope scope("Physics::MoveProxies");
+        for (BodyId body : m_AwakeBodies) {
+            const Math::AABB bounds = m_Shapes[body].ComputeAABB(m_Positions[body], m_Rotations[body]);
+            m_Broadphase->MoveProxy(m_Proxies[body], bounds, m_LinearVelocities[body] * dt);
+        }
+    }
+
+    void PhysicsWorld::UpdatePairs() {
+        ProfileScope scope("Physics::Broadphase");
+        m_Broadphase->UpdatePairs(m_NewProxyPairs);
+
+        m_Pairs.erase(std::remove_if(m_Pairs.begin(), m_Pairs.end(), [&](const BodyPair& pair) {
+            return !m_Broadphase->TestOverlap(m_Proxies[pair.a], m_Proxies[pair.b]);
+        }), m_Pairs.end());
+
+        // Re-fattened proxies report pairs that may already be known
+        m_NewPairs.clear();
+        for (const ProxyPair& proxies : m_NewProxyPairs) {
+            const BodyId a = m_Broadphase->GetUserData(proxies.a);
+            const BodyId b = m_Broadphase->GetUserData(proxies.b);
+            if (ShouldCollide(a, b))
+                m_NewPairs.push_back({ std::min(a, b), std::max(a, b) });
+        }
+        std::sort(m_NewPairs.begin(), m_NewPairs.end(), PairLess);
+
+        m_ActivePairs.clear();
+        std::set_union(m_Pairs.begin(), m_Pairs.end(), m_NewPairs.begin(), m_NewPairs.end(),
+                       std::back_inserter(m_ActivePairs), PairLess);
+        m_Pairs.swap(m_ActivePairs);
+    }
+
+    void PhysicsWorld::Collide() {
+        m_WokenContacts.clear();
+
+        m_ActivePairs.clear();
+        for (const BodyPair& pair : m_Pairs) {
+            if (IsAwakeDynamic(pair.a) || IsAwakeDynamic(pair.b))
+                m_ActivePairs.push_back(pair);
+        }
+        m_NarrowPhase.Collide(m_Shapes.data(), m_Positions.data(), m_Rotations.data(),
+                              m_ActivePairs.data(), static_cast<uint32_t>(m_ActivePairs.size()));
+
+        // Anything touching or jointed to an awake body wakes with its whole island.
+        // Sleeping islands never touch each other (they would be one island), so
+        // one pass is enough.
+        for (const ContactManifold& manifold : m_NarrowPhase.GetManifolds()) {
+            WakeBody(manifold.bodyA);
+            WakeBody(manifold.bodyB);
+        }
+        for (const BallJoint& joint : m_Joints) {
+            if (IsAwakeDynamic(joint.bodyA) || IsAwakeDynamic(joint.bodyB)) {
+                WakeBody(joint.bodyA);
+                WakeBody(joint.bodyB);
+            }
+        }
+
+        // Woken islands bring the contacts they fell asleep with; their own pairs
+        // were not collided this step
+        m_Contacts.clear();
+        for (ContactManifold& manifold : m_NarrowPhase.GetManifolds())
+            m_Contacts.push_back(&manifold);
+        for (ContactManifold& manifold : m_WokenContacts)
+            m_Contacts.push_back(&manifold);
+    }
+
+    void PhysicsWorld::BuildIslands() {
+        ProfileScope scope("Physics::BuildIslands");
+        std::sort(m_AwakeBodies.begin(), m_AwakeBodies.end());
+        for (BodyId body : m_AwakeBodies)
+            m_Parent[body] = body;
+
+        // Union-find over contacts and joints between dynamic bodies. The root of
+        // a set is its smallest body, so numbering does not depend on link order.
+        auto find = [this](uint32_t body) {
+            while (m_Parent[body] != body) {
+                m_Parent[body] = m_Parent[m_Parent[body]];
+                body = m_Parent[body];
+            }
+            return body;
+        };
+        auto link = [&](BodyId a, BodyId b) {
+            if (!IsDynamic(a) || !IsDynamic(b))
+                return;
+            a = find(a);
+            b = find(b);
+            if (a != b)
+                m_Parent[std::max(a, b)] = std::min(a, b);
+        };
+        for (const ContactManifold* manifold : m_Contacts)
+            link(manifold->bodyA, manifold->bodyB);
+        for (const BallJoint& joint : m_Joints) {
+            if (IsAwakeDynamic(joint.bodyA) || IsAwakeDynamic(joint.bodyB))
+                link(joint.bodyA, joint.bodyB);
+        }
+
+        // Number islands in order of their smallest body; roots come first
+        m_IslandCount = 0;
+        for (BodyId body : m_AwakeBodies) {
+            const uint32_t root = find(body);
+            m_Slot[body] = (root == body) ? m_IslandCount++ : m_Slot[root];
+        }
+        for (BodyId body : m_AwakeBodies)
+            m_Parent[body] = m_Slot[body];
+
+        // Scatter bodies, contacts and joints into per-island ranges
+        auto scatter = [&](std::vector<uint32_t>& start, uint32_t count, auto&& islandOf, auto&& emit) {
+            start.assign(m_IslandCount + 1, 0);
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint32_t island = islandOf(i);
+                if (island != kAwake)
+                    ++start[island + 1];
+            }
+            std::partial_sum(start.begin(), start.end(), start.begin());
+            m_Cursor.assign(start.begin(), start.end() - 1);
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint32_t island = islandOf(i);
+                if (island != kAwake)
+                    emit(i, m_Cursor[island]++);
+            }
+            return start.back();
+        };
+
+        m_IslandBodies.resize(m_AwakeBodies.size());
+        scatter(m_IslandBodyStart, static_cast<uint32_t>(m_AwakeBodies.size()),
+            [&](uint32_t i) { return m_Parent[m_AwakeBodies[i]]; },
+            [&](uint32_t i, uint32_t slot) {
+                m_IslandBodies[slot] = m_AwakeBodies[i];
+                m_Slot[m_AwakeBodies[i]] = slot;
+            });
+
+        m_IslandContacts.resize(m_Contacts.size());
+        scatter(m_IslandContactStart, static_cast<uint32_t>(m_Contacts.size()),
+            [&](uint32_t i) {
+                const ContactManifold& manifold = *m_Contacts[i];
+                return m_Parent[IsDynamic(manifold.bodyA) ? manifold.bodyA : manifold.bodyB];
+            },
+            [&](uint32_t i, uint32_t slot) { m_IslandContacts[slot] = m_Contacts[i]; });
+
+        m_IslandJoints.resize(m_Joints.size());
+        const uint32_t jointCount = scatter(m_IslandJointStart, static_cast<uint32_t>(m_Joints.size()),
+            [&](uint32_t i) {
+                const BallJoint& joint = m_Joints[i];
+                if (IsAwakeDynamic(joint.bodyA))
+                    return m_Parent[joint.bodyA];
+                return IsAwakeDynamic(joint.bodyB) ? m_Parent[joint.bodyB] : kAwake;
+            },
+            [&](uint32_t i, uint32_t slot) { m_IslandJoints[slot] = i; });
+        m_IslandJoints.resize(jointCount);
+
+        m_IslandSleepy.assign(m_IslandCount, 0);
+        m_SolverBodies.resize(m_IslandBodies.size());
+        m_ContactConstraints.resize(m_IslandContacts.size());
+        m_JointConstraints.resize(m_IslandJoints.size());
+
+        // Largest islands first, then the small ones packed together
+        m_IslandOrder.resize(m_IslandCount);
+        std::iota(m_IslandOrder.begin(), m_IslandOrder.end(), 0u);
+        auto islandSize = [&](uint32_t island) { return m_IslandBodyStart[island + 1] - m_IslandBodyStart[island]; };
+        std::sort(m_IslandOrder.begin(), m_IslandOrder.end(), [&](uint32_t l, uint32_t r) {
+            const uint32_t sl = islandSize(l), sr = islandSize(r);
+            return sl > sr || (sl == sr && l < r);
+        });
+        m_JobStart.assign(1, 0);
+        uint32_t bodies = 0;
+        for (uint32_t k = 0; k < m_IslandCount; ++k) {
+            bodies += islandSize(m_IslandOrder[k]);
+            if (bodies >= kBodiesPerJob) {
+                m_JobStart.push_back(k + 1);
+                bodies = 0;
+            }
+        }
+        if (m_JobStart.back() != m_IslandCount)
+            m_JobStart.push_back(m_IslandCount);
+    }
+
+    void PhysicsWorld::SolveIsland(uint32_t island, float dt) {
+        const WorldSettings& settings = m_Settings;
+        const uint32_t bodyBegin = m_IslandBodyStart[island], bodyEnd = m_IslandBodyStart[island + 1];
+        const uint32_t contactBegin = m_IslandContactStart[island], contactEnd = m_IslandContactStart[island + 1];
+        const uint32_t jointBegin = m_IslandJointStart[island], jointEnd = m_IslandJointStart[island + 1];
+
+        // Static bodies share this one: no mass, no velocity, so impulses leave it at rest
+        SolverBody staticBody = {};
+        auto get = [&](uint32_t slot) -> SolverBody& {
+            return slot == kStaticSlot ? staticBody : m_SolverBodies[slot];
+        };
+        auto velocityAt = [](const SolverBody& body, const Math::Vec3& r) {
+            return body.linearVelocity + Math::Cross(body.angularVelocity, r);
+        };
+        auto apply = [](SolverBody& a, SolverBody& b, const Math::Vec3& rA, const Math::Vec3& rB, const Math::Vec3& impulse) {
+            a.linearVelocity -= impulse * a.invMass;
+            a.angularVelocity -= Multiply(a.invInertia, Math::Cross(rA, impulse));
+            b.linearVelocity += impulse * b.invMass;
+            b.angularVelocity += Multiply(b.invInertia, Math::Cross(rB, impulse));
+        };
+        auto effectiveMass = [](const SolverBody& a, const SolverBody& b, const Math::Vec3& rA, const Math::Vec3& rB, const Math::Vec3& dir) {
+            const Math::Vec3 rnA = Math::Cross(rA, dir), rnB = Math::Cross(rB, dir);
+            const float k = a.invMass + b.invMass + Math::Dot(rnA, Multiply(a.invInertia, rnA)) + Math::Dot(rnB, Multiply(b.invInertia, rnB));
+            return k > 0.0f ? 1.0f / k : 0.0f;
+        };
+
+        // ------ INTEGRATE VELOCITIES ------
+        for (uint32_t slot = bodyBegin; slot < bodyEnd; ++slot) {
+            const BodyId body = m_IslandBodies[slot];
+            SolverBody& solverBody = m_SolverBodies[slot];
+            solverBody.invMass = m_InvMasses[body];
+            ComputeWorldInverseInertia(m_Rotations[body], m_InvInertiaLocal[body], solverBody.invInertia);
+            solverBody.linearVelocity = (m_LinearVelocities[body] + settings.gravity * dt) * (1.0f / (1.0f + dt * m_LinearDamping[body]));
+            solverBody.angularVelocity = m_AngularVelocities[body] * (1.0f / (1.0f + dt * m_AngularDamping[body]));
+        }
+
+        // ------ PREPARE ------
+        for (uint32_t c = contactBegin; c < contactEnd; ++c) {
+            ContactManifold& manifold = *m_IslandContacts[c];
+            ContactConstraint& constraint = m_ContactConstraints[c];
+            const BodyId a = manifold.bodyA, b = manifold.bodyB;
+            constraint.manifold = &manifold;
+            constraint.slotA = m_Slot[a];
+            constraint.slotB = m_Slot[b];
+            constraint.friction = std::sqrt(m_Friction[a] * m_Friction[b]);
+            ComputeTangents(manifold.normal, constraint.tangent[0], constraint.tangent[1]);
+            const float restitution = std::max(m_Restitution[a], m_Restitution[b]);
+            const SolverBody& bodyA = get(constraint.slotA);
+            const SolverBody& bodyB = get(constraint.slotB);
+
+            for (uint32_t p = 0; p < manifold.pointCount; ++p) {
+                const ContactPoint& contact = manifold.points[p];
+                ContactConstraintPoint& point = constraint.points[p];
+                point.rA = contact.position - m_Positions[a];
+                point.rB = contact.position - m_Positions[b];
+                point.normalMass = effectiveMass(bodyA, bodyB, point.rA, point.rB, manifold.normal);
+                point.tangentMass[0] = effectiveMass(bodyA, bodyB, point.rA, point.rB, constraint.tangent[0]);
+                point.tangentMass[1] = effectiveMass(bodyA, bodyB, point.rA, point.rB, constraint.tangent[1]);
+
+                // Penetration is pushed out a fraction per step; a gap (speculative
+                // contact) may be closed within the step but not crossed
+                float bias;
+                if (contact.depth < 0.0f)
+                    bias = contact.depth / dt;
+                else
+                    bias = std::min(settings.baumgarte * std::max(contact.depth - settings.linearSlop, 0.0f) / dt, settings.maxCorrectionVelocity);
+                const float approach = Math::Dot(velocityAt(bodyB, point.rB) - velocityAt(bodyA, point.rA), manifold.normal);
+                if (restitution > 0.0f && approach < -settings.restitutionThreshold)
+                    bias = std::max(bias, -restitution * approach);
+                point.velocityBias = bias;
+            }
+        }
+
+        for (uint32_t j = jointBegin; j < jointEnd; ++j) {
+            const BallJoint& joint = m_Joints[m_IslandJoints[j]];
+            JointConstraint& constraint = m_JointConstraints[j];
+            constraint.joint = m_IslandJoints[j];
+            constraint.slotA = m_Slot[joint.bodyA];
+            constraint.slotB = m_Slot[joint.bodyB];
+            constraint.rA = Math::Rotate(m_Rotations[joint.bodyA], joint.localAnchorA);
+            constraint.rB = Math::Rotate(m_Rotations[joint.bodyB], joint.localAnchorB);
+            const SolverBody& bodyA = get(constraint.slotA);
+            const SolverBody& bodyB = get(constraint.slotB);
+
+            // K * e = response of the anchors' relative velocity to a unit impulse
+            // along e; K is symmetric, so its columns are its rows
+            Math::Vec3 k[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                Math::Vec3 e(0.0f);
+                e[axis] = 1.0f;
+                k[axis] = e * (bodyA.invMass + bodyB.invMass)
+                        + Math::Cross(Multiply(bodyA.invInertia, Math::Cross(constraint.rA, e)), constraint.rA)
+                        + Math::Cross(Multiply(bodyB.invInertia, Math::Cross(constraint.rB, e)), constraint.rB);
+            }
+            InvertSymmetric(k, constraint.mass);
+            const Math::Vec3 error = (m_Positions[joint.bodyB] + constraint.rB) - (m_Positions[joint.bodyA] + constraint.rA);
+            constraint.bias = error * (settings.baumgarte / dt);
+        }
+
+        // ------ WARM START ------
+        // Normal impulses only. Four friction points can push against each other
+        // (twisting the patch) without changing any velocity; carried over, that
+        // internal part grows step after step until a resting stack wobbles.
+        for (uint32_t c = contactBegin; c < contactEnd; ++c) {
+            const ContactConstraint& constraint = m_ContactConstraints[c];
+            ContactManifold& manifold = *constraint.manifold;
+            SolverBody& bodyA = get(constraint.slotA);
+            SolverBody& bodyB = get(constraint.slotB);
+            for (uint32_t p = 0; p < manifold.pointCount; ++p) {
+                ContactPoint& contact = manifold.points[p];
+                contact.tangentImpulse[0] = 0.0f;
+                contact.tangentImpulse[1] = 0.0f;
+                apply(bodyA, bodyB, constraint.points[p].rA, constraint.points[p].rB, manifold.normal * contact.normalImpulse);
+            }
+        }
+        for (uint32_t j = jointBegin; j < jointEnd; ++j) {
+            const JointConstraint& constraint = m_JointConstraints[j];
+            apply(get(constraint.slotA), get(constraint.slotB), constraint.rA, constraint.rB, m_Joints[constraint.joint].impulse);
+        }
+
+        // ------ ITERATE ------
+        for (uint32_t iteration = 0; iteration < settings.velocityIterations; ++iteration) {
+            for (uint32_t j = jointBegin; j < jointEnd; ++j) {
+                const JointConstraint& constraint = m_JointConstraints[j];
+                SolverBody& bodyA = get(constraint.slotA);
+                SolverBody& bodyB = get(constraint.slotB);
+                const Math::Vec3 velocity = velocityAt(bodyB, constraint.rB) - velocityAt(bodyA, constraint.rA);
+                const Math::Vec3 impulse = -Multiply(constraint.mass, velocity + constraint.bias);
+                m_Joints[constraint.joint].impulse += impulse;
+                apply(bodyA, bodyB, constraint.rA, constraint.rB, impulse);
+            }
+
+            for (uint32_t c = contactBegin; c < contactEnd; ++c) {
+                const ContactConstraint& constraint = m_ContactConstraints[c];
+                ContactManifold& manifold = *constraint.manifold;
+                SolverBody& bodyA = get(constraint.slotA);
+                SolverBody& bodyB = get(constraint.slotB);
+
+                // Friction first: the normal impulses are the more important ones to get right
+                for (uint32_t p = 0; p < manifold.pointCount; ++p) {
+                    ContactPoint& contact = manifold.points[p];
+                    const ContactConstraintPoint& point = constraint.points[p];
+                    const float limit = constraint.friction * contact.normalImpulse;
+                    for (int t = 0; t < 2; ++t) {
+                        const Math::Vec3 velocity = velocityAt(bodyB, point.rB) - velocityAt(bodyA, point.rA);
+                        const float lambda = -point.tangentMass[t] * Math::Dot(velocity, constraint.tangent[t]);
+                        const float total = std::max(-limit, std::min(contact.tangentImpulse[t] + lambda, limit));
+                        apply(bodyA, bodyB, point.rA, point.rB, constraint.tangent[t] * (total - contact.tangentImpulse[t]));
+                        contact.tangentImpulse[t] = total;
+                    }
+                }
+                for (uint32_t p = 0; p < manifold.pointCount; ++p) {
+                    ContactPoint& contact = manifold.points[p];
+                    const ContactConstraintPoint& point = constraint.points[p];
+                    const Math::Vec3 velocity = velocityAt(bodyB, point.rB) - velocityAt(bodyA, point.rA);
+                    const float lambda = -point.normalMass * (Math::Dot(velocity, manifold.normal) - point.velocityBias);
+                    const float total = std::max(contact.normalImpulse + lambda, 0.0f);
+                    apply(bodyA, bodyB, point.rA, point.rB, manifold.normal * (total - contact.normalImpulse));
+                    contact.normalImpulse = total;
+                }
+            }
+        }
+
+        // ------ INTEGRATE POSITIONS ------
+        const float sleepLinear = settings.sleepLinearVelocity * settings.sleepLinearVelocity;
+        const float sleepAngular = settings.sleepAngularVelocity * settings.sleepAngularVelocity;
+        float minSleepTime = FLT_MAX;
+        for (uint32_t slot = bodyBegin; slot < bodyEnd; ++slot) {
+            const BodyId body = m_IslandBodies[slot];
+            Math::Vec3 v = m_SolverBodies[slot].linearVelocity;
+            Math::Vec3 w = m_SolverBodies[slot].angularVelocity;
+            const float translation = Math::Length(v) * dt;
+            if (translation > kMaxTranslation)
+                v *= kMaxTranslation / translation;
+            const float rotation = Math::Length(w) * dt;
+            if (rotation > kMaxRotation)
+                w *= kMaxRotation / rotation;
+
+            m_Positions[body] += v * dt;
+            const Math::Quat& q = m_Rotations[body];
+            const Math::Quat spin = Math::Quat(w.x, w.y, w.z, 0.0f) * q;
+            const float h = 0.5f * dt;
+            m_Rotations[body] = Math::Normalize(Math::Quat(q.x + h * spin.x, q.y + h * spin.y, q.z + h * spin.z, q.w + h * spin.w));
+            m_LinearVelocities[body] = v;
+            m_AngularVelocities[body] = w;
+            m_Changed[body] = m_Version;
+
+            if (!m_AllowSleep[body] || Math::LengthSquared(v) > sleepLinear || Math::LengthSquared(w) > sleepAngular)
+                m_SleepTime[body] = 0.0f;
+            else
+                m_SleepTime[body] += dt;
+            minSleepTime = std::min(minSleepTime, m_SleepTime[body]);
+        }
+        m_IslandSleepy[island] = minSleepTime >= settings.timeToSleep ? 1 : 0;
+    }
+
+    void PhysicsWorld::SleepIslands() {
+        bool anySlept = false;
+        for (uint32_t island = 0; island < m_IslandCount; ++island) {
+            if (!m_IslandSleepy[island])
+                continue;
+            anySlept = true;
+
+            uint32_t index;
+            if (!m_FreeSleepingIslands.empty()) {
+                index = m_FreeSleepingIslands.back();
+                m_FreeSleepingIslands.pop_back();
+            } else {
+                index = static_cast<uint32_t>(m_SleepingIslands.size());
+                m_SleepingIslands.emplace_back();
+            }
+            SleepingIsland& sleeping = m_SleepingIslands[index];
+            sleeping.bodyStart = static_cast<uint32_t>(m_SleepingBodies.size());
+            sleeping.bodyCount = m_IslandBodyStart[island + 1] - m_IslandBodyStart[island];
+            sleeping.contactStart = static_cast<uint32_t>(m_SleepingContacts.size());
+            sleeping.contactCount = m_IslandContactStart[island + 1] - m_IslandContactStart[island];
+            for (uint32_t slot = m_IslandBodyStart[island]; slot < m_IslandBodyStart[island + 1]; ++slot) {
+                const BodyId body = m_IslandBodies[slot];
+                m_SleepingIsland[body] = index;
+                m_LinearVelocities[body] = Math::Vec3(0.0f);
+                m_AngularVelocities[body] = Math::Vec3(0.0f);
+                m_Changed[body] = m_Version;
+                m_SleepingBodies.push_back(body);
+            }
+            for (uint32_t c = m_IslandContactStart[island]; c < m_IslandContactStart[island + 1]; ++c)
+                m_SleepingContacts.push_back(*m_IslandContacts[c]);
+        }
+
+        if (anySlept) {
+            m_AwakeBodies.erase(std::remove_if(m_AwakeBodies.begin(), m_AwakeBodies.end(), [&](BodyId body) {
+                return !IsAwakeDynamic(body);
+            }), m_AwakeBodies.end());
+        }
+        CompactSleepingIslands();
+    }
+
+    void PhysicsWorld::CompactSleepingIslands() {
+        // Woken islands leave holes in the flat arrays; rebuild them once the
+        // holes outweigh the live ranges. Island indices do not change.
+        uint32_t liveBodies = 0, liveContacts = 0;
+        for (const SleepingIsland& island : m_SleepingIslands) {
+            liveBodies += island.bodyCount;
+            liveContacts += island.contactCount;
+        }
+        if (m_SleepingBodies.size() <= 2 * size_t(liveBodies) && m_SleepingContacts.size() <= 2 * size_t(liveContacts))
+            return;
+
+        std::vector<BodyId> bodies;
+        std::vector<ContactManifold> contacts;
+        bodies.reserve(liveBodies);
+        contacts.reserve(liveContacts);
+        for (SleepingIsland& island : m_SleepingIslands) {
+            const auto islandBodies = m_SleepingBodies.begin() + island.bodyStart;
+            const auto islandContacts = m_SleepingContacts.begin() + island.contactStart;
+            island.bodyStart = static_cast<uint32_t>(bodies.size());
+            island.contactStart = static_cast<uint32_t>(contacts.size());
+            bodies.insert(bodies.end(), islandBodies, islandBodies + island.bodyCount);
+            contacts.insert(contacts.end(), islandContacts, islandContacts + island.contactCount);
+        }
+        m_SleepingBodies.swap(bodies);
+        m_SleepingContacts.swap(contacts);
+    }
+
+    // ----------------------------------------------------------
+    // SCENE QUERIES
+    // ----------------------------------------------------------
+
+    void PhysicsWorld::RayCast(const RayQuery* rays, uint32_t count, QueryHit* outHits) const {
+        ProfileScope scope("Physics::RayCast");
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, (count + kRaysPerJob - 1) / kRaysPerJob, 1, [&](Threading::JobArgs args) {
+            const uint32_t begin = args.jobIndex * kRaysPerJob, end = std::min(count, begin + kRaysPerJob);
+            BroadphaseRay batch[kRaysPerJob];
+            for (uint32_t i = begin; i < end; ++i) {
+                batch[i - begin] = { rays[i].origin, rays[i].direction, Math::Vec3(0.0f), rays[i].maxDistance };
+                outHits[i] = QueryHit();
+            }
+            m_Broadphase->RayCast(batch, end - begin, [&](uint32_t ray, ProxyId proxy, float maxDistance) {
+                const RayQuery& query = rays[begin + ray];
+                const BodyId body = m_Broadphase->GetUserData(proxy);
+                CastHit hit;
+                if (body == query.ignore
+                    || !Physics::RayCast(m_Shapes[body], m_Positions[body], m_Rotations[body], query.origin, query.direction, maxDistance, hit))
+                    return maxDistance;
+                outHits[begin + ray] = { body, hit.distance, hit.position, hit.normal };
+                return hit.distance;
+            });
+        });
+        Threading::JobSystem::Wait(ctx);
+    }
+
+    void PhysicsWorld::ShapeCast(const ShapeCastQuery* casts, uint32_t count, QueryHit* outHits) const {
+        ProfileScope scope("Physics::ShapeCast");
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, (count + kShapeQueriesPerJob - 1) / kShapeQueriesPerJob, 1, [&](Threading::JobArgs args) {
+            const uint32_t begin = args.jobIndex * kShapeQueriesPerJob, end = std::min(count, begin + kShapeQueriesPerJob);
+            // The broadphase sweeps the shape's bounds, which translate rigidly with it
+            BroadphaseRay batch[kShapeQueriesPerJob];
+            for (uint32_t i = begin; i < end; ++i) {
+                const Math::AABB bounds = casts[i].shape.ComputeAABB(casts[i].position, casts[i].rotation);
+                batch[i - begin] = { bounds.Center(), casts[i].direction, bounds.Extents(), casts[i].maxDistance };
+                outHits[i] = QueryHit();
+            }
+            m_Broadphase->RayCast(batch, end - begin, [&](uint32_t ray, ProxyId proxy, float maxDistance) {
+                const ShapeCastQuery& query = casts[begin + ray];
+                const BodyId body = m_Broadphase->GetUserData(proxy);
+                CastHit hit;
+                if (body == query.ignore
+                    || !Physics::ShapeCast(query.shape, query.position, query.rotation, query.direction, maxDistance,
+                                           m_Shapes[body], m_Positions[body], m_Rotations[body], hit))
+                    return maxDistance;
+                outHits[begin + ray] = { body, hit.distance, hit.position, hit.normal };
+                return hit.distance;
+            });
+        });
+        Threading::JobSystem::Wait(ctx);
+    }
+
+    void PhysicsWorld::Overlap(const OverlapQuery* queries, uint32_t count, BodyId* outBodies, uint32_t maxBodiesPerQuery, uint32_t* outCounts) const {
+        ProfileScope scope("Physics::Overlap");
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, (count + kShapeQueriesPerJob - 1) / kShapeQueriesPerJob, 1, [&](Threading::JobArgs args) {
+            const uint32_t begin = args.jobIndex * kShapeQueriesPerJob, end = std::min(count, begin + kShapeQueriesPerJob);
+            std::vector<ProxyId> candidates;
+            std::vector<BodyId> touching;
+            for (uint32_t i = begin; i < end; ++i) {
+                const OverlapQuery& query = queries[i];
+                candidates.clear();
+                touching.clear();
+                m_Broadphase->Query(query.shape.ComputeAABB(query.position, query.rotation), candidates);
+                for (ProxyId proxy : candidates) {
+                    const BodyId body = m_Broadphase->GetUserData(proxy);
+                    ContactManifold manifold;
+                    if (body != query.ignore
+                        && Physics::Collide(query.shape, query.position, query.rotation, m_Shapes[body], m_Positions[body], m_Rotations[body], 0.0f, manifold))
+                        touching.push_back(body);
+                }
+                std::sort(touching.begin(), touching.end());
+                std::copy_n(touching.begin(), std::min<size_t>(touching.size(), maxBodiesPerQuery), outBodies + size_t(i) * maxBodiesPerQuery);
+                outCounts[i] = static_cast<uint32_t>(touching.size());
+            }
+        });
+        Threading::JobSystem::Wait(ctx);
+    }
+
+    // ----------------------------------------------------------
+    // SNAPSHOTS
+    // ----------------------------------------------------------
+
+    template <typename F>
+    void PhysicsWorld::ForEachBodyArray(F&& f) {
+        f(m_Positions);
+        f(m_Rotations);
+        f(m_LinearVelocities);
+        f(m_AngularVelocities);
+        f(m_Shapes);
+        f(m_InvMasses);
+        f(m_InvInertiaLocal);
+        f(m_Friction);
+        f(m_Restitution);
+        f(m_LinearDamping);
+        f(m_AngularDamping);
+        f(m_AllowSleep);
+        f(m_SleepTime);
+        f(m_SleepingIsland);
+        f(m_Proxies);
+    }
+
+    void PhysicsWorld::FindChangedRuns(uint64_t since) {
+        m_ChangedRuns.clear();
+        const uint32_t count = GetBodyCount();
+        for (uint32_t body = 0; body < count;) {
+            if (m_Changed[body] <= since) {
+                ++body;
+                continue;
+            }
+            const uint32_t start = body;
+            while (body < count && m_Changed[body] > since)
+                ++body;
+            m_ChangedRuns.push_back(start);
+            m_ChangedRuns.push_back(body - start);
+        }
+    }
+
+    void PhysicsWorld::SaveSnapshot(PhysicsSnapshot& snapshot, SnapshotMode mode) {
+        ProfileScope scope("Physics::SaveSnapshot");
+        const uint32_t count = GetBodyCount();
+        const bool delta = mode == SnapshotMode::Delta && snapshot.m_WorldId == m_WorldId && snapshot.m_BodyCount == count;
+        if (delta) {
+            FindChangedRuns(snapshot.m_Version);
+        } else {
+            m_ChangedRuns.assign({ 0u, count });
+            size_t bytesPerBody = 0;
+            ForEachBodyArray([&](auto& array) { bytesPerBody += sizeof(array[0]); });
+            snapshot.m_BodyData.resize(bytesPerBody * count);
+        }
+
+        // Each per-body array is one block of the buffer; copy the changed runs of each
+        size_t offset = 0, copied = 0;
+        ForEachBodyArray([&](auto& array) {
+            using T = typename std::decay_t<decltype(array)>::value_type;
+            static_assert(std::is_trivially_copyable<T>::value, "per-body state must be plain data");
+            uint8_t* block = snapshot.m_BodyData.data() + offset;
+            for (size_t r = 0; r < m_ChangedRuns.size(); r += 2) {
+                std::memcpy(block + m_ChangedRuns[r] * sizeof(T), array.data() + m_ChangedRuns[r], m_ChangedRuns[r + 1] * sizeof(T));
+                copied += m_ChangedRuns[r + 1] * sizeof(T);
+            }
+            offset += count * sizeof(T);
+        });
+
+        // Everything else is small next to the bodies, or changes every step anyway
+        StateWriter writer(snapshot.m_Shared);
+        writer.WriteArray(m_Joints);
+        writer.WriteArray(m_JointPairs);
+        writer.WriteArray(m_Pairs);
+        writer.WriteArray(m_AwakeBodies);
+        m_NarrowPhase.SaveState(writer);
+        writer.WriteArray(m_SleepingIslands);
+        writer.WriteArray(m_FreeSleepingIslands);
+        writer.WriteArray(m_SleepingBodies);
+        writer.WriteArray(m_SleepingContacts);
+        m_Broadphase->SaveState(writer);
+        snapshot.m_SharedSize = writer.GetOffset();
+
+        snapshot.m_WorldId = m_WorldId;
+        snapshot.m_BodyCount = count;
+        snapshot.m_Version = m_Version++;
+        Profiling::SetCounter("Physics.SnapshotBytes", static_cast<double>(copied + snapshot.m_SharedSize));
+    }
+
+    void PhysicsWorld::RestoreSnapshot(const PhysicsSnapshot& snapshot, SnapshotMode mode) {
+        ProfileScope scope("Physics::RestoreSnapshot");
+        if (snapshot.m_WorldId == 0)
+            return;   // Never saved
+
+        const uint32_t count = snapshot.m_BodyCount;
+        const bool delta = mode == SnapshotMode::Delta && snapshot.m_WorldId == m_WorldId && count == GetBodyCount();
+        if (delta) {
+            FindChangedRuns(snapshot.m_Version);
+        } else {
+            ForEachBodyArray([&](auto& array) { array.resize(count); });
+            m_Parent.resize(count);
+            m_Slot.resize(count, kStaticSlot);
+            m_Changed.resize(count);
+            m_ChangedRuns.assign({ 0u, count });
+        }
+
+        size_t offset = 0, copied = 0;
+        ForEachBodyArray([&](auto& array) {
+            using T = typename std::decay_t<decltype(array)>::value_type;
+            const uint8_t* block = snapshot.m_BodyData.data() + offset;
+            for (size_t r = 0; r < m_ChangedRuns.size(); r += 2) {
+                std::memcpy(array.data() + m_ChangedRuns[r], block + m_ChangedRuns[r] * sizeof(T), m_ChangedRuns[r + 1] * sizeof(T));
+                copied += m_ChangedRuns[r + 1] * sizeof(T);
+            }
+            offset += count * sizeof(T);
+        });
+        // Restored bodies differ from what any other snapshot may hold for them
+        for (size_t r = 0; r < m_ChangedRuns.size(); r += 2)
+            std::fill_n(m_Changed.begin() + m_ChangedRuns[r], m_ChangedRuns[r + 1], m_Version);
+
+        StateReader reader(snapshot.m_Shared.data());
+        reader.ReadArray(m_Joints);
+        reader.ReadArray(m_JointPairs);
+        reader.ReadArray(m_Pairs);
+        reader.ReadArray(m_AwakeBodies);
+        m_NarrowPhase.LoadState(reader);
+        reader.ReadArray(m_SleepingIslands);
+        reader.ReadArray(m_FreeSleepingIslands);
+        reader.ReadArray(m_SleepingBodies);
+        reader.ReadArray(m_SleepingContacts);
+        m_Broadphase->LoadState(reader);
+
+        // Results of the last step point into state that was just replaced
+        m_WokenContacts.clear();
+        m_Contacts.clear();
+        m_IslandCount = 0;
+        Profiling::SetCounter("Physics.SnapshotBytes", static_cast<double>(copied + snapshot.m_SharedSize));
+    }
+
+} // namespace Physics
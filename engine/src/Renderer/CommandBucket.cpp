@@ -0,0 +1,160 @@
+#include "Renderer/CommandBucket.h"
+#include "Renderer/Renderer.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace Renderer {
+
+    CommandBucket::CommandBucket() {
+        Reset();
+    }
+
+    void CommandBucket::Submit(uint64_t key, const DrawCommand& command) {
+        const uint32_t thread = Threading::JobSystem::GetThreadIndex();
+        if (thread < m_ThreadLists.size()) {
+            ThreadList& list = m_ThreadLists[thread];
+            assert(list.commands.size() <= kIndexMask && "Too many commands recorded on one thread");
+            list.keys.push_back(key);
+            list.commands.push_back(command);
+            return;
+        }
+
+        // The JobSystem gained threads since the last Reset()
+        std::lock_guard<std::mutex> lock(m_SharedMutex);
+        if (!m_SharedWarned) {
+            m_SharedWarned = true;
+            LOG_ENGINE_WARN("[CommandBucket] Thread {} has no command list; Reset() the bucket after JobSystem::Init().", thread);
+        }
+        assert(m_SharedList.commands.size() <= kIndexMask && "Too many commands recorded on one thread");
+        m_SharedList.keys.push_back(key);
+        m_SharedList.commands.push_back(command);
+    }
+
+    void CommandBucket::Sort() {
+        ProfileScope scope("Renderer::SortCommands");
+
+        size_t total = m_SharedList.keys.size();
+        for (const auto& list : m_ThreadLists)
+            total += list.keys.size();
+
+        m_SortedKeys.resize(total);
+        m_SortedIndices.resize(total);
+        m_ScratchKeys.resize(total);
+        m_ScratchIndices.resize(total);
+
+        size_t offset = 0;
+        auto gather = [&](const ThreadList& list, uint32_t thread) {
+            const size_t count = list.keys.size();
+            if (count == 0)
+                return;
+            std::memcpy(m_SortedKeys.data() + offset, list.keys.data(), count * sizeof(uint64_t));
+            for (size_t i = 0; i < count; ++i)
+                m_SortedIndices[offset + i] = (thread << kThreadShift) | static_cast<uint32_t>(i);
+            offset += count;
+        };
+        for (uint32_t thread = 0; thread < m_ThreadLists.size(); ++thread)
+            gather(m_ThreadLists[thread], thread);
+        gather(m_SharedList, kSharedList);
+
+        RadixSort(m_SortedKeys.data(), m_SortedIndices.data(), m_ScratchKeys.data(), m_ScratchIndices.data(), total);
+
+        Profiling::SetCounter("Renderer.Commands", static_cast<double>(total));
+    }
+
+    void CommandBucket::Execute(RenderBackend& backend) const {
+        ProfileScope scope("Renderer::ExecuteCommands");
+
+        backend.BeginFrame();
+
+        bool first = true;
+        uint32_t shader = 0, material = 0;
+        for (size_t i = 0; i < m_SortedIndices.size(); ++i) {
+            const DrawCommand& command = Resolve(m_SortedIndices[i]);
+            if (first || command.shader != shader) {
+                shader = command.shader;
+                backend.BindShader(shader);
+                // A new shader invalidates the material binding
+                first = true;
+            }
+            if (first || command.material != material) {
+                material = command.material;
+                backend.BindMaterial(material);
+            }
+            first = false;
+            backend.Draw(command);
+        }
+
+        backend.EndFrame();
+    }
+
+    void CommandBucket::Reset() {
+        // Threads past the last list index share m_SharedList
+        const uint32_t threads = std::min(Threading::JobSystem::GetMaxThreadCount(), kSharedList);
+        if (m_ThreadLists.size() < threads)
+            m_ThreadLists.resize(threads);
+
+        for (auto& list : m_ThreadLists) {
+            list.keys.clear();
+            list.commands.clear();
+        }
+        m_SharedList.keys.clear();
+        m_SharedList.commands.clear();
+        m_SharedWarned = false;
+        m_SortedKeys.clear();
+        m_SortedIndices.clear();
+    }
+
+    void RadixSort(uint64_t* keys, uint32_t* values, uint64_t* scratchKeys, uint32_t* scratchValues, size_t count) {
+        if (count < 2)
+            return;
+
+        // One read pass builds the histograms of all eight bytes
+        size_t histograms[8][256] = {};
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t key = keys[i];
+            for (int pass = 0; pass < 8; ++pass)
+                histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+
+        uint64_t* srcKeys = keys;
+        uint32_t* srcValues = values;
+        uint64_t* dstKeys = scratchKeys;
+        uint32_t* dstValues = scratchValues;
+
+        for (int pass = 0; pass < 8; ++pass) {
+            size_t* histogram = histograms[pass];
+            const int shift = pass * 8;
+
+            // Every key has the same byte here: the pass would be an identity copy
+            if (histogram[(srcKeys[0] >> shift) & 0xFF] == count)
+                continue;
+
+            size_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket) {
+                size_t n = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += n;
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                size_t dst = histogram[(srcKeys[i] >> shift) & 0xFF]++;
+                dstKeys[dst] = srcKeys[i];
+                dstValues[dst] = srcValues[i];
+            }
+
+            std::swap(srcKeys, dstKeys);
+            std::swap(srcValues, dstValues);
+        }
+
+        if (srcKeys != keys) {
+            std::memcpy(keys, srcKeys, count * sizeof(uint64_t));
+            std::memcpy(values, srcValues, count * sizeof(uint32_t));
+        }
+    }
+
+} // namespace Renderer
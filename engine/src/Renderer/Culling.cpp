@@ -0,0 +1,329 @@
+#include "Renderer/Culling.h"
+#include "Math/Batch.h"
+#include "Memory/LinearAllocator.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace Renderer {
+
+    // Objects per leaf; a multiple of the widest SIMD batch
+    static constexpr uint32_t kLeafSize = 8;
+    // Subtrees with fewer objects than this are not split into further jobs
+    static constexpr uint32_t kMinTaskObjects = 2048;
+    // Rebuild once refitting has grown the summed node surface area by this factor
+    static constexpr float kRebuildCostRatio = 1.5f;
+
+    CullProxy CullingBVH::Insert(const Math::AABB& bounds, uint32_t userData) {
+        CullProxy proxy;
+        if (!m_FreeProxies.empty()) {
+            proxy = m_FreeProxies.back();
+            m_FreeProxies.pop_back();
+        } else {
+            proxy = static_cast<CullProxy>(m_Bounds.size());
+            m_Bounds.emplace_back();
+            m_UserData.push_back(0);
+            m_LeafOf.push_back(0);
+            m_PositionOf.push_back(0);
+            m_Alive.push_back(0);
+        }
+
+        m_Bounds[proxy] = bounds;
+        m_UserData[proxy] = userData;
+        m_Alive[proxy] = 1;
+        ++m_AliveCount;
+        m_StructureDirty = true;
+        return proxy;
+    }
+
+    void CullingBVH::Move(CullProxy proxy, const Math::AABB& bounds) {
+        if (!IsValid(proxy))
+            return;
+
+        m_Bounds[proxy] = bounds;
+        if (m_StructureDirty)
+            return; // The rebuild picks the new bounds up
+
+        const uint32_t position = m_PositionOf[proxy];
+        m_MinX[position] = bounds.min.x; m_MinY[position] = bounds.min.y; m_MinZ[position] = bounds.min.z;
+        m_MaxX[position] = bounds.max.x; m_MaxY[position] = bounds.max.y; m_MaxZ[position] = bounds.max.z;
+        m_NodeDirty[m_LeafOf[proxy]] = 1;
+        m_BoundsDirty = true;
+    }
+
+    void CullingBVH::Remove(CullProxy proxy) {
+        if (!IsValid(proxy))
+            return;
+
+        m_Alive[proxy] = 0;
+        m_FreeProxies.push_back(proxy);
+        --m_AliveCount;
+        m_StructureDirty = true;
+    }
+
+    bool CullingBVH::IsValid(CullProxy proxy) const {
+        return proxy < m_Alive.size() && m_Alive[proxy] != 0;
+    }
+
+    void CullingBVH::Update() {
+        if (m_StructureDirty) {
+            Rebuild();
+            return;
+        }
+        if (!m_BoundsDirty)
+            return;
+
+        ProfileScope scope("Renderer::RefitBVH");
+        Refit();
+        if (ComputeCost() > m_BuiltCost * kRebuildCostRatio)
+            Rebuild();
+    }
+
+    void CullingBVH::Rebuild() {
+        ProfileScope scope("Renderer::BuildBVH");
+
+        // Build over a compact copy so partitioning does not chase proxy indices
+        std::vector<BuildItem> items;
+        items.reserve(m_AliveCount);
+        for (CullProxy proxy = 0; proxy < m_Alive.size(); ++proxy) {
+            if (m_Alive[proxy])
+                items.push_back({ m_Bounds[proxy], proxy });
+        }
+
+        const uint32_t count = static_cast<uint32_t>(items.size());
+        m_Nodes.clear();
+        m_Nodes.reserve(count > 0 ? 2 * (count / kLeafSize + 1) : 0);
+        if (count > 0)
+            BuildNode(items.data(), 0, count);
+
+        // Lay the object data out in tree order
+        for (auto* array : { &m_MinX, &m_MinY, &m_MinZ, &m_MaxX, &m_MaxY, &m_MaxZ })
+            array->resize(count);
+        m_ItemOf.resize(count);
+        for (uint32_t position = 0; position < count; ++position) {
+            const Math::AABB& b = items[position].bounds;
+            const CullProxy proxy = items[position].proxy;
+            m_MinX[position] = b.min.x; m_MinY[position] = b.min.y; m_MinZ[position] = b.min.z;
+            m_MaxX[position] = b.max.x; m_MaxY[position] = b.max.y; m_MaxZ[position] = b.max.z;
+            m_ItemOf[position] = m_UserData[proxy];
+            m_PositionOf[proxy] = position;
+        }
+        for (uint32_t node = 0; node < m_Nodes.size(); ++node) {
+            if (m_Nodes[node].skip != node + 1)
+                continue;
+            for (uint32_t position = m_Nodes[node].first; position < m_Nodes[node].first + m_Nodes[node].count; ++position)
+                m_LeafOf[items[position].proxy] = node;
+        }
+
+        m_NodeDirty.assign(m_Nodes.size(), 0);
+        m_BuiltCost = ComputeCost();
+        m_StructureDirty = false;
+        m_BoundsDirty = false;
+        ++m_RebuildCount;
+    }
+
+    uint32_t CullingBVH::BuildNode(BuildItem* items, uint32_t first, uint32_t count) {
+        const uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+
+        Math::AABB bounds;
+        Math::AABB centroids;
+        for (uint32_t i = first; i < first + count; ++i) {
+            bounds.Merge(items[i].bounds);
+            centroids.Merge(items[i].bounds.min + items[i].bounds.max);
+        }
+
+        if (count > kLeafSize) {
+            // Median split on the axis where the centroids spread the most
+            // (centroids are kept doubled, min + max, which does not change the order)
+            const Math::Vec3 extent = centroids.max - centroids.min;
+            const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+            const uint32_t half = count / 2;
+            BuildItem* begin = items + first;
+            std::nth_element(begin, begin + half, begin + count, [axis](const BuildItem& a, const BuildItem& b) {
+                return a.bounds.min[axis] + a.bounds.max[axis] < b.bounds.min[axis] + b.bounds.max[axis];
+            });
+
+            BuildNode(items, first, half);
+            BuildNode(items, first + half, count - half);
+        }
+
+        Node& node = m_Nodes[index];
+        node.bounds = bounds;
+        node.first = first;
+        node.count = count;
+        node.skip = static_cast<uint32_t>(m_Nodes.size());
+        return index;
+    }
+
+    void CullingBVH::Refit() {
+        // Children always follow their parent, so a reverse pass sees them first
+        for (uint32_t i = static_cast<uint32_t>(m_Nodes.size()); i-- > 0;) {
+            Node& node = m_Nodes[i];
+            if (node.skip == i + 1) {
+                if (!m_NodeDirty[i])
+                    continue;
+                Math::AABB bounds;
+                for (uint32_t p = node.first; p < node.first + node.count; ++p)
+                    bounds.Merge(Math::AABB({ m_MinX[p], m_MinY[p], m_MinZ[p] }, { m_MaxX[p], m_MaxY[p], m_MaxZ[p] }));
+                node.bounds = bounds;
+                continue;
+            }
+
+            const uint32_t left = i + 1;
+            const uint32_t right = m_Nodes[left].skip;
+            if (!m_NodeDirty[left] && !m_NodeDirty[right])
+                continue;
+            node.bounds = Math::Union(m_Nodes[left].bounds, m_Nodes[right].bounds);
+            m_NodeDirty[i] = 1;
+        }
+
+        std::fill(m_NodeDirty.begin(), m_NodeDirty.end(), 0);
+        m_BoundsDirty = false;
+    }
+
+    float CullingBVH::ComputeCost() const {
+        float cost = 0.0f;
+        for (const Node& node : m_Nodes)
+            cost += node.bounds.SurfaceArea();
+        return cost;
+    }
+
+    uint32_t CullingBVH::CullSubtree(const Math::Frustum& frustum, uint32_t rootNode, uint32_t* out, uint32_t& tested) const {
+        uint32_t written = 0;
+        const uint32_t end = m_Nodes[rootNode].skip;
+
+        // Stackless: descending is node + 1, skipping a subtree is node.skip
+        uint32_t i = rootNode;
+        while (i < end) {
+            const Node& node = m_Nodes[i];
+            ++tested;
+            const Math::Containment containment = frustum.Test(node.bounds);
+            if (containment == Math::Containment::Outside) {
+                i = node.skip;
+                continue;
+            }
+            if (containment == Math::Containment::Inside) {
+                std::memcpy(out + written, m_ItemOf.data() + node.first, node.count * sizeof(uint32_t));
+                written += node.count;
+                i = node.skip;
+                continue;
+            }
+            if (node.skip == i + 1) {
+                const Math::AABBSoA boxes{ m_MinX.data() + node.first, m_MinY.data() + node.first, m_MinZ.data() + node.first,
+                                           m_MaxX.data() + node.first, m_MaxY.data() + node.first, m_MaxZ.data() + node.first };
+                const size_t visible = Math::CullAABBs(frustum, boxes, node.count, out + written);
+                for (size_t v = 0; v < visible; ++v)
+                    out[written + v] = m_ItemOf[node.first + out[written + v]];
+                written += static_cast<uint32_t>(visible);
+                tested += node.count;
+            }
+            ++i;
+        }
+        return written;
+    }
+
+    VisibleList CullingBVH::Cull(const Math::Frustum& frustum, LinearAllocator& scratch) const {
+        ProfileScope scope("Renderer::Cull");
+
+        VisibleList result;
+        if (m_Nodes.empty())
+            return result;
+
+        // 1) Split the tree into independent subtrees on this thread. Nodes fully
+        //    inside or outside are resolved here and never become jobs.
+        struct Task {
+            uint32_t node;
+            bool     inside;
+        };
+        std::vector<Task> tasks;
+        std::vector<uint32_t> frontier{ 0 };
+        uint32_t frontTested = 0;
+
+        const bool parallel = Threading::JobSystem::IsInitialized() && Threading::JobSystem::GetWorkerCount() > 0;
+        const size_t targetTasks = parallel ? 4 * Threading::JobSystem::GetMaxThreadCount() : 1;
+
+        while (!frontier.empty()) {
+            std::vector<uint32_t> next;
+            for (uint32_t index : frontier) {
+                const Node& node = m_Nodes[index];
+                const bool split = parallel && node.count >= kMinTaskObjects && node.skip != index + 1
+                                && tasks.size() + frontier.size() + next.size() < targetTasks;
+                if (!split) {
+                    tasks.push_back({ index, false });
+                    continue;
+                }
+
+                ++frontTested;
+                const Math::Containment containment = frustum.Test(node.bounds);
+                if (containment == Math::Containment::Outside)
+                    continue;
+                if (containment == Math::Containment::Inside) {
+                    tasks.push_back({ index, true });
+                    continue;
+                }
+                next.push_back(index + 1);
+                next.push_back(m_Nodes[index + 1].skip);
+            }
+            frontier.swap(next);
+        }
+
+        // Subtrees are disjoint and nodes are numbered depth-first, so sorting by
+        // node keeps the output in tree order whatever the frontier looked like
+        std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.node < b.node; });
+
+        // 2) Every task gets a slice as large as its subtree, so jobs never contend
+        std::vector<uint32_t> offsets(tasks.size() + 1, 0);
+        for (size_t t = 0; t < tasks.size(); ++t)
+            offsets[t + 1] = offsets[t] + m_Nodes[tasks[t].node].count;
+
+        uint32_t* items = scratch.AllocateArray<uint32_t>(std::max<uint32_t>(offsets.back(), 1));
+        if (!items)
+            return result;
+
+        std::vector<uint32_t> written(tasks.size(), 0);
+        std::atomic<uint32_t> tested{ frontTested };
+        auto runTask = [&](size_t t) {
+            const Node& node = m_Nodes[tasks[t].node];
+            uint32_t* out = items + offsets[t];
+            if (tasks[t].inside) {
+                std::memcpy(out, m_ItemOf.data() + node.first, node.count * sizeof(uint32_t));
+                written[t] = node.count;
+                return;
+            }
+            uint32_t localTested = 0;
+            written[t] = CullSubtree(frustum, tasks[t].node, out, localTested);
+            tested += localTested;
+        };
+
+        if (tasks.size() > 1 && parallel) {
+            Threading::JobContext ctx;
+            Threading::JobSystem::Dispatch(ctx, static_cast<uint32_t>(tasks.size()), 1, [&](Threading::JobArgs args) {
+                runTask(args.jobIndex);
+            });
+            Threading::JobSystem::Wait(ctx);
+        } else {
+            for (size_t t = 0; t < tasks.size(); ++t)
+                runTask(t);
+        }
+
+        // 3) Compact the slices; tasks are in tree order, so the output is too
+        uint32_t count = 0;
+        for (size_t t = 0; t < tasks.size(); ++t) {
+            if (offsets[t] != count)
+                std::memmove(items + count, items + offsets[t], written[t] * sizeof(uint32_t));
+            count += written[t];
+        }
+
+        Profiling::SetCounter("Culling.Visible", static_cast<double>(count));
+        Profiling::SetCounter("Culling.Tested", static_cast<double>(tested.load()));
+
+        result.items = items;
+        result.count = count;
+        return result;
+    }
+
+} // namespace Renderer
@@ -0,0 +1,91 @@
+#include "Renderer/Renderer.h"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    void NullRenderBackend::BeginFrame() {
+        // Per-frame stats restart; only the frame counter accumulates
+        uint32_t frames = m_Stats.frames;
+        m_Stats = {};
+        m_Stats.frames = frames;
+        m_Draws.clear();
+    }
+
+    void NullRenderBackend::BindShader(uint32_t) {
+        m_Stats.shaderBinds++;
+    }
+
+    void NullRenderBackend::BindMaterial(uint32_t) {
+        m_Stats.materialBinds++;
+    }
+
+    void NullRenderBackend::Draw(const DrawCommand& command) {
+        m_Stats.draws++;
+        if (m_RecordDraws)
+            m_Draws.push_back(command);
+    }
+
+    void NullRenderBackend::EndFrame() {
+        m_Stats.frames++;
+    }
+
+    void SoftwareRenderBackend::RegisterMesh(uint32_t mesh, std::vector<Math::Vec3> positions, std::vector<uint32_t> indices) {
+        m_Meshes[mesh] = { std::move(positions), std::move(indices) };
+    }
+
+    void SoftwareRenderBackend::BeginFrame() {
+        m_Rasterizer.Clear();
+    }
+
+    void SoftwareRenderBackend::BindShader(uint32_t) {
+        // Everything is flat-shaded
+    }
+
+    void SoftwareRenderBackend::BindMaterial(uint32_t material) {
+        auto it = m_MaterialColors.find(material);
+        if (it != m_MaterialColors.end()) {
+            m_Color = it->second;
+            return;
+        }
+
+        // Stable, reasonably bright colour derived from the id
+        uint32_t h = (material + 1) * 2654435761u;
+        m_Color = 0xFF000000u | ((h >> 8) & 0x7F7F7F) | 0x404040;
+    }
+
+    void SoftwareRenderBackend::Draw(const DrawCommand& command) {
+        auto it = m_Meshes.find(command.mesh);
+        if (it == m_Meshes.end())
+            return;
+
+        const Mesh& mesh = it->second;
+        const uint32_t first = std::min<uint32_t>(command.firstIndex, static_cast<uint32_t>(mesh.indices.size()));
+        const uint32_t available = static_cast<uint32_t>(mesh.indices.size()) - first;
+        const uint32_t count = (command.indexCount == 0) ? available : std::min(command.indexCount, available);
+
+        // Instances carry no per-instance data here, so one draw covers them all.
+        // Each triangle gets a fixed directional light so faces stay distinguishable.
+        const Math::Mat4 mvp = m_ViewProjection * command.world;
+        const Math::Vec3 light = Math::Normalize(Math::Vec3(0.4f, 1.0f, 0.6f));
+        for (uint32_t i = first; i + 2 < first + count; i += 3) {
+            const Math::Vec3 a = Math::TransformPoint(command.world, mesh.positions[mesh.indices[i]]);
+            const Math::Vec3 b = Math::TransformPoint(command.world, mesh.positions[mesh.indices[i + 1]]);
+            const Math::Vec3 c = Math::TransformPoint(command.world, mesh.positions[mesh.indices[i + 2]]);
+            const float lambert = std::max(0.0f, Math::Dot(Math::Normalize(Math::Cross(b - a, c - a)), light));
+            const float shade = 0.35f + 0.65f * lambert;
+
+            uint32_t color = m_Color & 0xFF000000u;
+            for (int channel = 0; channel < 3; ++channel) {
+                const float value = static_cast<float>((m_Color >> (channel * 8)) & 0xFF) * shade;
+                color |= static_cast<uint32_t>(value + 0.5f) << (channel * 8);
+            }
+            m_Rasterizer.SubmitTriangles(mvp, mesh.positions.data(), mesh.indices.data() + i, 3, color);
+        }
+    }
+
+    void SoftwareRenderBackend::EndFrame() {
+        m_Rasterizer.Rasterize();
+    }
+
+} // namespace Renderer
@@ -0,0 +1,389 @@
+#include "Renderer/SoftwareRasterizer.h"
+#include "Math/Simd.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace Renderer {
+
+    namespace {
+
+        /*
+         * The tile kernel is written once against this small lane interface; the
+         * build's SIMD level (Math/Simd.h) decides how many pixels it covers per step.
+         */
+#if MATH_SIMD_AVX2
+        struct Lanes {
+            using Float = __m256;
+            static constexpr int kWidth = 8;
+
+            static Float Set(float v) { return _mm256_set1_ps(v); }
+            static Float PixelCenters(float x) { return _mm256_add_ps(_mm256_set1_ps(x), _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f)); }
+            static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+            static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+            static Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+            static Float GreaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            static Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static Float Select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+            static bool  Any(Float mask) { return _mm256_movemask_ps(mask) != 0; }
+            static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+            static void  Store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+            static Float LoadBits(const uint32_t* p) { return _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+            static void  StoreBits(uint32_t* p, Float v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_castps_si256(v)); }
+            static Float SetBits(uint32_t v) { return _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(v))); }
+        };
+#elif MATH_SIMD_SSE
+        struct Lanes {
+            using Float = __m128;
+            static constexpr int kWidth = 4;
+
+            static Float Set(float v) { return _mm_set1_ps(v); }
+            static Float PixelCenters(float x) { return _mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f)); }
+            static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+            static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+            static Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+            static Float GreaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+            static Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+            static Float Select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+            static bool  Any(Float mask) { return _mm_movemask_ps(mask) != 0; }
+            static Float Load(const float* p) { return _mm_loadu_ps(p); }
+            static void  Store(float* p, Float v) { _mm_storeu_ps(p, v); }
+            static Float LoadBits(const uint32_t* p) { return _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+            static void  StoreBits(uint32_t* p, Float v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_castps_si128(v)); }
+            static Float SetBits(uint32_t v) { return _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(v))); }
+        };
+#else
+        struct Lanes {
+            // One pixel per step; masks are plain booleans
+            struct Float {
+                float    value;
+                bool     mask;
+                uint32_t bits;
+            };
+            static constexpr int kWidth = 1;
+
+            static Float Set(float v) { return { v, false, 0 }; }
+            static Float PixelCenters(float x) { return { x + 0.5f, false, 0 }; }
+            static Float Add(Float a, Float b) { return { a.value + b.value, false, 0 }; }
+            static Float Mul(Float a, Float b) { return { a.value * b.value, false, 0 }; }
+            static Float And(Float a, Float b) { return { 0.0f, a.mask && b.mask, 0 }; }
+            static Float GreaterEqual(Float a, Float b) { return { 0.0f, a.value >= b.value, 0 }; }
+            static Float Less(Float a, Float b) { return { 0.0f, a.value < b.value, 0 }; }
+            static Float Select(Float mask, Float a, Float b) { return mask.mask ? a : b; }
+            static bool  Any(Float mask) { return mask.mask; }
+            static Float Load(const float* p) { return { *p, false, 0 }; }
+            static void  Store(float* p, Float v) { *p = v.value; }
+            static Float LoadBits(const uint32_t* p) { return { 0.0f, false, *p }; }
+            static void  StoreBits(uint32_t* p, Float v) { *p = v.bits; }
+            static Float SetBits(uint32_t v) { return { 0.0f, false, v }; }
+        };
+#endif
+
+        static_assert(SoftwareRasterizer::kTileSize % Lanes::kWidth == 0, "Tiles must hold whole SIMD steps");
+
+        // Clip-space vertex interpolation for near-plane clipping
+        Math::Vec4 ClipLerp(const Math::Vec4& a, const Math::Vec4& b, float t) {
+            return a + (b - a) * t;
+        }
+
+    } // namespace
+
+    SoftwareRasterizer::SoftwareRasterizer(uint32_t width, uint32_t height)
+        : m_Width(width)
+        , m_Height(height)
+        , m_TilesX((width + kTileSize - 1) / kTileSize)
+        , m_TilesY((height + kTileSize - 1) / kTileSize)
+    {
+        m_Stride = m_TilesX * kTileSize;
+        m_Depth.resize(static_cast<size_t>(m_Stride) * m_TilesY * kTileSize);
+        m_Color.resize(m_Depth.size());
+        m_Tiles.resize(static_cast<size_t>(m_TilesX) * m_TilesY);
+        Clear();
+    }
+
+    void SoftwareRasterizer::Clear(float depth, uint32_t color) {
+        std::fill(m_Depth.begin(), m_Depth.end(), depth);
+        if (m_ColorEnabled)
+            std::fill(m_Color.begin(), m_Color.end(), color);
+        for (Tile& tile : m_Tiles) {
+            tile.triangles.clear();
+            tile.maxDepth = depth;
+        }
+        m_Triangles.clear();
+        m_RasterizedCount = 0;
+    }
+
+    void SoftwareRasterizer::SubmitTriangles(const Math::Mat4& modelViewProjection, const Math::Vec3* positions,
+                                             const uint32_t* indices, uint32_t indexCount, uint32_t color) {
+        for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+            Math::Vec4 clip[3];
+            for (int v = 0; v < 3; ++v)
+                clip[v] = modelViewProjection * Math::Vec4(positions[indices[i + v]], 1.0f);
+
+            // Trivially outside one side of the frustum (near is handled by clipping)
+            bool outside = false;
+            for (int axis = 0; axis < 2 && !outside; ++axis) {
+                outside = (clip[0][axis] > clip[0].w && clip[1][axis] > clip[1].w && clip[2][axis] > clip[2].w)
+                       || (clip[0][axis] < -clip[0].w && clip[1][axis] < -clip[1].w && clip[2][axis] < -clip[2].w);
+            }
+            if (outside || (clip[0].z > clip[0].w && clip[1].z > clip[1].w && clip[2].z > clip[2].w))
+                continue;
+
+            // Clip against the near plane (z >= -w); a triangle becomes at most a quad
+            Math::Vec4 polygon[4];
+            int count = 0;
+            for (int v = 0; v < 3; ++v) {
+                const Math::Vec4& a = clip[v];
+                const Math::Vec4& b = clip[(v + 1) % 3];
+                const float da = a.z + a.w;
+                const float db = b.z + b.w;
+                if (da >= 0.0f)
+                    polygon[count++] = a;
+                if ((da >= 0.0f) != (db >= 0.0f))
+                    polygon[count++] = ClipLerp(a, b, da / (da - db));
+            }
+            for (int v = 1; v + 1 < count; ++v)
+                SetupTriangle(polygon[0], polygon[v], polygon[v + 1], color);
+        }
+    }
+
+    void SoftwareRasterizer::SetupTriangle(const Math::Vec4& c0, const Math::Vec4& c1, const Math::Vec4& c2, uint32_t color) {
+        // Clip space -> pixels (y down) and depth in [0, 1]
+        float x[3], y[3], z[3];
+        const Math::Vec4* clip[3] = { &c0, &c1, &c2 };
+        for (int v = 0; v < 3; ++v) {
+            const float invW = 1.0f / std::max(clip[v]->w, 1e-6f);
+            x[v] = (clip[v]->x * invW * 0.5f + 0.5f) * static_cast<float>(m_Width);
+            y[v] = (0.5f - clip[v]->y * invW * 0.5f) * static_cast<float>(m_Height);
+            z[v] = clip[v]->z * invW * 0.5f + 0.5f;
+        }
+
+        // Counter-clockwise (front-facing) triangles have a positive area here
+        const float area = (x[2] - x[0]) * (y[1] - y[0]) - (y[2] - y[0]) * (x[1] - x[0]);
+        if (!(area > 0.0f))
+            return;
+
+        Triangle tri;
+        tri.minX = std::max(0, static_cast<int32_t>(std::ceil(std::min({ x[0], x[1], x[2] }) - 0.5f)));
+        tri.minY = std::max(0, static_cast<int32_t>(std::ceil(std::min({ y[0], y[1], y[2] }) - 0.5f)));
+        tri.maxX = std::min(static_cast<int32_t>(m_Width) - 1, static_cast<int32_t>(std::floor(std::max({ x[0], x[1], x[2] }) - 0.5f)));
+        tri.maxY = std::min(static_cast<int32_t>(m_Height) - 1, static_cast<int32_t>(std::floor(std::max({ y[0], y[1], y[2] }) - 0.5f)));
+        if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+            return;
+
+        // Edge i is opposite vertex i: E(p) = A*p.x + B*p.y + C, >= 0 inside
+        const float invArea = 1.0f / area;
+        tri.depthA = tri.depthB = tri.depthC = 0.0f;
+        for (int e = 0; e < 3; ++e) {
+            const int a = (e + 1) % 3;
+            const int b = (e + 2) % 3;
+            const float A = y[b] - y[a];
+            const float B = x[a] - x[b];
+            tri.edgeA[e] = A;
+            tri.edgeB[e] = B;
+            tri.edgeC[e] = -x[a] * A - y[a] * B;
+
+            // Top-left rule: pixels exactly on a shared edge belong to one triangle only
+            const bool topLeft = A > 0.0f || (A == 0.0f && B > 0.0f);
+            tri.edgeBias[e] = topLeft ? 0.0f : std::numeric_limits<float>::denorm_min();
+
+            // The normalized edge functions are the barycentrics, so depth is a plane
+            tri.depthA += A * invArea * z[e];
+            tri.depthB += B * invArea * z[e];
+            tri.depthC += tri.edgeC[e] * invArea * z[e];
+        }
+        tri.color = color;
+
+        const uint32_t index = static_cast<uint32_t>(m_Triangles.size());
+        m_Triangles.push_back(tri);
+
+        // Bin by bounding box
+        for (int32_t ty = tri.minY / static_cast<int32_t>(kTileSize); ty <= tri.maxY / static_cast<int32_t>(kTileSize); ++ty) {
+            for (int32_t tx = tri.minX / static_cast<int32_t>(kTileSize); tx <= tri.maxX / static_cast<int32_t>(kTileSize); ++tx)
+                m_Tiles[ty * m_TilesX + tx].triangles.push_back(index);
+        }
+    }
+
+    void SoftwareRasterizer::RasterizeTile(uint32_t tileIndex) {
+        Tile& tile = m_Tiles[tileIndex];
+        const int32_t tileX = static_cast<int32_t>((tileIndex % m_TilesX) * kTileSize);
+        const int32_t tileY = static_cast<int32_t>((tileIndex / m_TilesX) * kTileSize);
+
+        for (uint32_t t : tile.triangles) {
+            const Triangle& tri = m_Triangles[t];
+            const int32_t minY = std::max(tri.minY, tileY);
+            const int32_t maxY = std::min(tri.maxY, tileY + static_cast<int32_t>(kTileSize) - 1);
+            // Steps start aligned, so they never cross into a neighbouring tile
+            const int32_t minX = std::max(tri.minX, tileX) & ~(Lanes::kWidth - 1);
+            const int32_t maxX = std::min(tri.maxX, tileX + static_cast<int32_t>(kTileSize) - 1);
+
+            const Lanes::Float a0 = Lanes::Set(tri.edgeA[0]);
+            const Lanes::Float a1 = Lanes::Set(tri.edgeA[1]);
+            const Lanes::Float a2 = Lanes::Set(tri.edgeA[2]);
+            const Lanes::Float bias0 = Lanes::Set(tri.edgeBias[0]);
+            const Lanes::Float bias1 = Lanes::Set(tri.edgeBias[1]);
+            const Lanes::Float bias2 = Lanes::Set(tri.edgeBias[2]);
+            const Lanes::Float depthA = Lanes::Set(tri.depthA);
+            const Lanes::Float color = Lanes::SetBits(tri.color);
+
+            for (int32_t py = minY; py <= maxY; ++py) {
+                const float centerY = static_cast<float>(py) + 0.5f;
+                // Row constants: B*y + C per edge, and the depth plane
+                const Lanes::Float r0 = Lanes::Set(tri.edgeB[0] * centerY + tri.edgeC[0]);
+                const Lanes::Float r1 = Lanes::Set(tri.edgeB[1] * centerY + tri.edgeC[1]);
+                const Lanes::Float r2 = Lanes::Set(tri.edgeB[2] * centerY + tri.edgeC[2]);
+                const Lanes::Float rz = Lanes::Set(tri.depthB * centerY + tri.depthC);
+
+                float*    depthRow = m_Depth.data() + static_cast<size_t>(py) * m_Stride;
+                uint32_t* colorRow = m_Color.data() + static_cast<size_t>(py) * m_Stride;
+
+                for (int32_t px = minX; px <= maxX; px += Lanes::kWidth) {
+                    const Lanes::Float cx = Lanes::PixelCenters(static_cast<float>(px));
+                    Lanes::Float inside = Lanes::GreaterEqual(Lanes::Add(Lanes::Mul(a0, cx), r0), bias0);
+                    inside = Lanes::And(inside, Lanes::GreaterEqual(Lanes::Add(Lanes::Mul(a1, cx), r1), bias1));
+                    inside = Lanes::And(inside, Lanes::GreaterEqual(Lanes::Add(Lanes::Mul(a2, cx), r2), bias2));
+                    if (!Lanes::Any(inside))
+                        continue;
+
+                    const Lanes::Float depth = Lanes::Add(Lanes::Mul(depthA, cx), rz);
+                    const Lanes::Float stored = Lanes::Load(depthRow + px);
+                    const Lanes::Float pass = Lanes::And(inside, Lanes::Less(depth, stored));
+                    if (!Lanes::Any(pass))
+                        continue;
+
+                    Lanes::Store(depthRow + px, Lanes::Select(pass, depth, stored));
+                    if (m_ColorEnabled)
+                        Lanes::StoreBits(colorRow + px, Lanes::Select(pass, color, Lanes::LoadBits(colorRow + px)));
+                }
+            }
+        }
+        tile.triangles.clear();
+
+        // Farthest depth in the visible part of the tile, for coarse occlusion rejects
+        const uint32_t endX = std::min<uint32_t>(tileX + kTileSize, m_Width);
+        const uint32_t endY = std::min<uint32_t>(tileY + kTileSize, m_Height);
+        float maxDepth = 0.0f;
+        for (uint32_t py = tileY; py < endY; ++py) {
+            const float* row = m_Depth.data() + static_cast<size_t>(py) * m_Stride;
+            for (uint32_t px = tileX; px < endX; ++px)
+                maxDepth = std::max(maxDepth, row[px]);
+        }
+        tile.maxDepth = maxDepth;
+    }
+
+    void SoftwareRasterizer::Rasterize() {
+        ProfileScope scope("Renderer::Rasterize");
+
+        std::vector<uint32_t> busyTiles;
+        for (uint32_t i = 0; i < m_Tiles.size(); ++i) {
+            if (!m_Tiles[i].triangles.empty())
+                busyTiles.push_back(i);
+        }
+
+        // Tiles own disjoint pixels, so they need no synchronization
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, static_cast<uint32_t>(busyTiles.size()), 1, [&](Threading::JobArgs args) {
+            RasterizeTile(busyTiles[args.jobIndex]);
+        });
+        Threading::JobSystem::Wait(ctx);
+
+        Profiling::SetCounter("Rasterizer.Triangles", static_cast<double>(m_Triangles.size() - m_RasterizedCount));
+        m_RasterizedCount = m_Triangles.size();
+    }
+
+    bool SoftwareRasterizer::TestAABB(const Math::Mat4& viewProjection, const Math::AABB& box) const {
+        float minX = std::numeric_limits<float>::max(), minY = minX, minDepth = minX;
+        float maxX = -minX, maxY = -minX;
+        for (int corner = 0; corner < 8; ++corner) {
+            const Math::Vec3 p((corner & 1) ? box.max.x : box.min.x,
+                               (corner & 2) ? box.max.y : box.min.y,
+                               (corner & 4) ? box.max.z : box.min.z);
+            const Math::Vec4 clip = viewProjection * Math::Vec4(p, 1.0f);
+
+            // Crossing the near plane: the box may cover anything
+            if (clip.z < -clip.w)
+                return true;
+
+            const float invW = 1.0f / clip.w;
+            const float x = (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(m_Width);
+            const float y = (0.5f - clip.y * invW * 0.5f) * static_cast<float>(m_Height);
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+            minDepth = std::min(minDepth, clip.z * invW * 0.5f + 0.5f);
+        }
+
+        // Every pixel the projected box touches, conservatively
+        const int32_t x0 = std::max(0, static_cast<int32_t>(std::floor(minX)));
+        const int32_t y0 = std::max(0, static_cast<int32_t>(std::floor(minY)));
+        const int32_t x1 = std::min(static_cast<int32_t>(m_Width) - 1, static_cast<int32_t>(std::ceil(maxX)) - 1);
+        const int32_t y1 = std::min(static_cast<int32_t>(m_Height) - 1, static_cast<int32_t>(std::ceil(maxY)) - 1);
+        if (x0 > x1 || y0 > y1)
+            return false; // Off screen
+
+        for (int32_t ty = y0 / static_cast<int32_t>(kTileSize); ty <= y1 / static_cast<int32_t>(kTileSize); ++ty) {
+            for (int32_t tx = x0 / static_cast<int32_t>(kTileSize); tx <= x1 / static_cast<int32_t>(kTileSize); ++tx) {
+                // Whole tile closer than the box: nothing to look at
+                if (m_Tiles[ty * m_TilesX + tx].maxDepth < minDepth)
+                    continue;
+
+                const int32_t rowBegin = std::max(y0, ty * static_cast<int32_t>(kTileSize));
+                const int32_t rowEnd = std::min(y1, (ty + 1) * static_cast<int32_t>(kTileSize) - 1);
+                const int32_t colBegin = std::max(x0, tx * static_cast<int32_t>(kTileSize));
+                const int32_t colEnd = std::min(x1, (tx + 1) * static_cast<int32_t>(kTileSize) - 1);
+                for (int32_t py = rowBegin; py <= rowEnd; ++py) {
+                    const float* row = m_Depth.data() + static_cast<size_t>(py) * m_Stride;
+                    for (int32_t px = colBegin; px <= colEnd; ++px) {
+                        if (row[px] >= minDepth)
+                            return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    uint32_t SoftwareRasterizer::TestAABBs(const Math::Mat4& viewProjection, const Math::AABB* boxes, uint32_t count, uint8_t* visible) const {
+        ProfileScope scope("Renderer::OcclusionTest");
+
+        std::atomic<uint32_t> culled{ 0 };
+        Threading::JobContext ctx;
+        Threading::JobSystem::Dispatch(ctx, count, 256, [&](Threading::JobArgs args) {
+            const bool isVisible = TestAABB(viewProjection, boxes[args.jobIndex]);
+            visible[args.jobIndex] = isVisible ? 1 : 0;
+            if (!isVisible)
+                culled.fetch_add(1, std::memory_order_relaxed);
+        });
+        Threading::JobSystem::Wait(ctx);
+
+        Profiling::SetCounter("Occlusion.Tested", static_cast<double>(count));
+        Profiling::SetCounter("Occlusion.Culled", static_cast<double>(culled.load()));
+        return culled.load();
+    }
+
+    std::vector<uint32_t> SoftwareRasterizer::ReadColor() const {
+        std::vector<uint32_t> pixels(static_cast<size_t>(m_Width) * m_Height);
+        for (uint32_t y = 0; y < m_Height; ++y)
+            std::copy_n(m_Color.data() + static_cast<size_t>(y) * m_Stride, m_Width, pixels.data() + static_cast<size_t>(y) * m_Width);
+        return pixels;
+    }
+
+    bool SoftwareRasterizer::SaveColorPPM(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        file << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+        for (uint32_t pixel : ReadColor()) {
+            const char rgb[3] = { static_cast<char>(pixel & 0xFF), static_cast<char>((pixel >> 8) & 0xFF),
+                                  static_cast<char>((pixel >> 16) & 0xFF) };
+            file.write(rgb, 3);
+        }
+        return static_cast<bool>(file);
+    }
+
+} // namespace Renderer
@@ -0,0 +1,175 @@
+#include "Threading/JobSystem.h"
+#include "Utils/Logger.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threading {
+
+    namespace {
+
+        // A queued unit of work together with the context it reports back to
+        struct QueuedJob {
+            JobSystem::Job work;
+            JobContext*    ctx;
+        };
+
+        std::vector<std::thread> s_Workers;
+        std::deque<QueuedJob>    s_Queue;
+        std::mutex               s_QueueMutex;
+        std::condition_variable  s_WakeCondition;
+        std::atomic<bool>        s_Running{ false };
+
+        // 0 for the main thread (and any other thread that is not a worker)
+        thread_local uint32_t    t_ThreadIndex = 0;
+
+        void Push(JobContext& ctx, JobSystem::Job work) {
+            {
+                std::lock_guard<std::mutex> lock(s_QueueMutex);
+                s_Queue.push_back({ std::move(work), &ctx });
+            }
+            s_WakeCondition.notify_one();
+        }
+
+    } // namespace
+
+    void JobSystem::Init(uint32_t workerCount) {
+        if (s_Running)
+            return;
+
+        if (workerCount == 0) {
+            uint32_t hw = std::thread::hardware_concurrency();
+            workerCount = (hw > 1) ? hw - 1 : 1;
+        }
+
+        s_Running = true;
+        s_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            s_Workers.emplace_back(&JobSystem::WorkerLoop, i + 1);
+        }
+
+        LOG_ENGINE_INFO("[JobSystem] Initialized with {} worker threads.", workerCount);
+    }
+
+    void JobSystem::Shutdown() {
+        if (!s_Running)
+            return;
+
+        // Let the workers finish whatever is still queued before they exit
+        {
+            std::lock_guard<std::mutex> lock(s_QueueMutex);
+            s_Running = false;
+        }
+        s_WakeCondition.notify_all();
+
+        for (auto& worker : s_Workers) {
+            if (worker.joinable())
+                worker.join();
+        }
+        s_Workers.clear();
+
+        LOG_ENGINE_INFO("[JobSystem] Shut down.");
+    }
+
+    bool JobSystem::IsInitialized() {
+        return s_Running;
+    }
+
+    uint32_t JobSystem::GetWorkerCount() {
+        return static_cast<uint32_t>(s_Workers.size());
+    }
+
+    uint32_t JobSystem::GetMaxThreadCount() {
+        return GetWorkerCount() + 1;
+    }
+
+    uint32_t JobSystem::GetThreadIndex() {
+        return t_ThreadIndex;
+    }
+
+    void JobSystem::Execute(JobContext& ctx, Job job) {
+        if (!s_Running) {
+            job();
+            return;
+        }
+
+        ctx.pending.fetch_add(1, std::memory_order_relaxed);
+        Push(ctx, std::move(job));
+    }
+
+    void JobSystem::Dispatch(JobContext& ctx, uint32_t jobCount, uint32_t groupSize, const DispatchJob& job) {
+        if (jobCount == 0)
+            return;
+        groupSize = std::max(groupSize, 1u);
+
+        const uint32_t groupCount = (jobCount + groupSize - 1) / groupSize;
+
+        for (uint32_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
+            auto group = [jobCount, groupSize, groupIndex, job]() {
+                const uint32_t begin = groupIndex * groupSize;
+                const uint32_t end = std::min(begin + groupSize, jobCount);
+                JobArgs args{};
+                args.groupIndex = groupIndex;
+                for (uint32_t i = begin; i < end; ++i) {
+                    args.jobIndex = i;
+                    args.groupID = i - begin;
+                    job(args);
+                }
+            };
+
+            if (!s_Running) {
+                group();
+                continue;
+            }
+
+            ctx.pending.fetch_add(1, std::memory_order_relaxed);
+            Push(ctx, std::move(group));
+        }
+    }
+
+    bool JobSystem::IsBusy(const JobContext& ctx) {
+        return ctx.pending.load(std::memory_order_acquire) > 0;
+    }
+
+    void JobSystem::Wait(const JobContext& ctx) {
+        while (IsBusy(ctx)) {
+            // Help out instead of sleeping; this also keeps nested waits from deadlocking
+            if (!RunOneJob())
+                std::this_thread::yield();
+        }
+    }
+
+    bool JobSystem::RunOneJob() {
+        QueuedJob job;
+        {
+            std::lock_guard<std::mutex> lock(s_QueueMutex);
+            if (s_Queue.empty())
+                return false;
+            job = std::move(s_Queue.front());
+            s_Queue.pop_front();
+        }
+
+        job.work();
+        job.ctx->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void JobSystem::WorkerLoop(uint32_t threadIndex) {
+        t_ThreadIndex = threadIndex;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(s_QueueMutex);
+                s_WakeCondition.wait(lock, [] { return !s_Queue.empty() || !s_Running; });
+                if (s_Queue.empty() && !s_Running)
+                    return;
+            }
+            RunOneJob();
+        }
+    }
+
+} // namespace Threading
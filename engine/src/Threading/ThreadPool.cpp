@@ -0,0 +1,48 @@
+#include "Threading/ThreadPool.h"
+
+#include <algorithm>
+
+namespace Threading {
+
+    ThreadPool::ThreadPool(uint32_t threadCount) {
+        threadCount = std::max(threadCount, 1u);
+        m_Threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+            m_Threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_WakeCondition.notify_all();
+        for (std::thread& thread : m_Threads)
+            thread.join();
+    }
+
+    void ThreadPool::Submit(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push_back(std::move(task));
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop() {
+        while (true) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WakeCondition.wait(lock, [this] { return !m_Tasks.empty() || !m_Running; });
+                // Drain the queue before exiting, like JobSystem::Shutdown()
+                if (m_Tasks.empty())
+                    return;
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+} // namespace Threading
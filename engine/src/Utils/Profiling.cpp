@@ -1,8 +1,11 @@
 #include "Utils/Profiling.h"
 #include "Utils/Logger.h"         // For logging macros
 #include "Memory/MemoryManager.h" // For querying memory stats
+#include "Threading/JobSystem.h"    // For tagging events with the thread index
 
 #include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <thread>
 #include <spdlog/spdlog.h>
 
@@ -17,6 +20,9 @@ double               Profiling::s_FrameTime = 0.0;
 double               Profiling::s_FPS = 0.0;
 Profiling::TimerMap  Profiling::s_Timers = {};
 std::mutex           Profiling::s_Mutex;
+std::vector<ProfileEvent> Profiling::s_FrameEvents = {};
+uint64_t             Profiling::s_DroppedEvents = 0;
+Profiling::CounterMap Profiling::s_Counters = {};
 
 // ----------------------------------------------------------
 // Singleton instance retrieval
@@ -38,6 +44,11 @@ void Profiling::StartFrame() {
     // Acquire the lock in case other profiling methods are running concurrently
     std::lock_guard<std::mutex> lock(s_Mutex);
     s_LastFrameTime = high_resolution_clock::now();
+    s_FrameEvents.clear();
+    if (s_DroppedEvents != 0) {
+        s_DroppedEvents = 0;
+        s_Counters["Profiling.DroppedEvents"] = 0.0;
+    }
 }
 
 /**
@@ -121,3 +132,81 @@ void Profiling::LogMemoryUsage() {
     spdlog::info("[Profiling] Memory Usage - Allocated: {} bytes, Deallocated: {} bytes, Current: {} bytes",
         totalAllocated, totalDeallocated, currentUsage);
 }
+
+// ----------------------------------------------------------
+// FRAME EVENTS
+// ----------------------------------------------------------
+
+/**
+ * @brief Store a finished span relative to the current frame start.
+ */
+void Profiling::RecordEvent(const std::string& name, TimePoint start, TimePoint end) {
+    const uint32_t threadIndex = Threading::JobSystem::GetThreadIndex();
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_FrameEvents.size() >= kMaxFrameEvents) {
+        s_Counters["Profiling.DroppedEvents"] = static_cast<double>(++s_DroppedEvents);
+        return;
+    }
+    double startMs = duration<double, std::milli>(start - s_LastFrameTime).count();
+    double durationMs = duration<double, std::milli>(end - start).count();
+    s_FrameEvents.push_back({ name, threadIndex, startMs, durationMs });
+}
+
+std::vector<ProfileEvent> Profiling::GetFrameEvents() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_FrameEvents;
+}
+
+uint64_t Profiling::GetDroppedEvents() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_DroppedEvents;
+}
+
+/**
+ * @brief Complete ("X") events in microseconds; names are JSON-escaped.
+ */
+bool Profiling::ExportTrace(const std::string& path, const std::vector<ProfileEvent>& events) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        std::string name;
+        for (char c : events[i].name) {
+            if (c == '"' || c == '\\')
+                name += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                name += c;
+        }
+        file << (i ? ",\n" : "\n") << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << events[i].threadIndex
+             << ",\"ts\":" << events[i].startMs * 1000.0 << ",\"dur\":" << events[i].durationMs * 1000.0 << "}";
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file.flush());
+}
+
+// ----------------------------------------------------------
+// COUNTERS
+// ----------------------------------------------------------
+
+void Profiling::SetCounter(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Counters[name] = value;
+}
+
+void Profiling::AddCounter(const std::string& name, double delta) {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Counters[name] += delta;
+}
+
+double Profiling::GetCounter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    auto it = s_Counters.find(name);
+    return (it != s_Counters.end()) ? it->second : 0.0;
+}
+
+std::unordered_map<std::string, double> Profiling::GetCounters() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_Counters;
+}
@@ -0,0 +1,604 @@
+#include "Utils/Telemetry.h"
+#include "Utils/Logger.h"
+#include "Memory/MemoryManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ENGINE_TELEMETRY_POSIX 1
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+    enum class MessageType : uint8_t {
+        String = 1,
+        Frame = 2,
+    };
+
+    constexpr char     kMagic[4] = { 'E', 'T', 'L', 'M' };
+    constexpr size_t   kHeaderSize = sizeof(kMagic) + 1;
+    constexpr size_t   kMaxQueuedFrames = 256;
+    constexpr size_t   kMaxClientBacklog = 4u << 20;    // Unsent bytes past which a viewer misses frames
+    constexpr uint64_t kMaxMessageSize = 64u << 20;
+    constexpr int      kStopFlushMs = 200;
+
+    // ----------------------------------------------------------
+    // ENCODING
+    // ----------------------------------------------------------
+
+    void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void PutDouble(std::vector<uint8_t>& out, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+
+    void PutMessage(std::vector<uint8_t>& out, MessageType type, const std::vector<uint8_t>& payload) {
+        out.push_back(static_cast<uint8_t>(type));
+        PutVarint(out, payload.size());
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+
+    uint64_t ZigZag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t UnZigZag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Reads a byte range; any read past its end fails it
+    struct Cursor {
+        const uint8_t* at;
+        const uint8_t* end;
+        bool           ok = true;
+
+        uint64_t Varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (at == end)
+                    break;
+                const uint8_t byte = *at++;
+                value |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            ok = false;
+            return 0;
+        }
+
+        double Double() {
+            if (end - at < 8) {
+                ok = false;
+                return 0.0;
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i)
+                bits |= uint64_t(at[i]) << (8 * i);
+            at += 8;
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+
+    // ----------------------------------------------------------
+    // ENDPOINTS
+    // ----------------------------------------------------------
+
+#if ENGINE_TELEMETRY_POSIX
+    struct Address {
+        sockaddr_storage storage{};
+        socklen_t        length = 0;
+        std::string      socketPath;    // Unix sockets only
+    };
+
+    // "unix:<path>" or "tcp:<port>" on the loopback address
+    bool ParseEndpoint(const std::string& endpoint, Address& address) {
+        if (endpoint.rfind("unix:", 0) == 0) {
+            sockaddr_un& local = reinterpret_cast<sockaddr_un&>(address.storage);
+            address.socketPath = endpoint.substr(5);
+            if (address.socketPath.empty() || address.socketPath.size() >= sizeof(local.sun_path))
+                return false;
+            local.sun_family = AF_UNIX;
+            std::memcpy(local.sun_path, address.socketPath.c_str(), address.socketPath.size() + 1);
+            address.length = sizeof(sockaddr_un);
+            return true;
+        }
+        if (endpoint.rfind("tcp:", 0) == 0) {
+            const std::string port = endpoint.substr(4);
+            char* end = nullptr;
+            const unsigned long value = std::strtoul(port.c_str(), &end, 10);
+            if (port.empty() || *end != '\0' || value > 0xFFFF)
+                return false;
+            sockaddr_in& inet = reinterpret_cast<sockaddr_in&>(address.storage);
+            inet.sin_family = AF_INET;
+            inet.sin_port = htons(static_cast<uint16_t>(value));
+            inet.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.length = sizeof(sockaddr_in);
+            return true;
+        }
+        return false;
+    }
+
+    void SetNonBlocking(int descriptor) {
+        fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    int OpenSocket(const Address& address) {
+        const int descriptor = socket(address.storage.ss_family, SOCK_STREAM, 0);
+#ifdef SO_NOSIGPIPE
+        if (descriptor >= 0) {
+            const int on = 1;
+            setsockopt(descriptor, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+        }
+#endif
+        return descriptor;
+    }
+
+    // A socket file left behind by a process that did not stop would fail bind(). Only
+    // a socket nothing listens on is removed; any other file, or a live server, is kept.
+    bool RemoveStaleSocket(const Address& address) {
+        const char* path = address.socketPath.c_str();
+        struct stat info;
+        if (lstat(path, &info) != 0)
+            return errno == ENOENT;
+        if (!S_ISSOCK(info.st_mode)) {
+            LOG_ENGINE_ERROR("[Telemetry] '{}' exists and is not a socket; not replacing it.", path);
+            return false;
+        }
+        const int probe = OpenSocket(address);
+        const bool refused = probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 &&
+                             errno == ECONNREFUSED;
+        if (probe >= 0)
+            close(probe);
+        if (!refused) {
+            LOG_ENGINE_ERROR("[Telemetry] Another server is listening on '{}'.", path);
+            return false;
+        }
+        if (unlink(path) != 0) {
+            LOG_ENGINE_ERROR("[Telemetry] Cannot remove stale socket '{}': {}.", path, std::strerror(errno));
+            return false;
+        }
+        return true;
+    }
+#endif
+
+} // namespace
+
+// ----------------------------------------------------------
+// SERVER
+// ----------------------------------------------------------
+
+TelemetryServer::~TelemetryServer() {
+    Stop();
+}
+
+#if ENGINE_TELEMETRY_POSIX
+
+bool TelemetryServer::Start(const std::string& endpoint) {
+    if (IsRunning())
+        return false;
+    Address address;
+    if (!ParseEndpoint(endpoint, address)) {
+        LOG_ENGINE_ERROR("[Telemetry] Bad endpoint '{}'; expected unix:<path> or tcp:<port>.", endpoint);
+        return false;
+    }
+
+    if (!address.socketPath.empty() && !RemoveStaleSocket(address))
+        return false;
+    m_Listener = OpenSocket(address);
+    if (address.storage.ss_family == AF_INET) {
+        const int on = 1;
+        setsockopt(m_Listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    if (m_Listener < 0 || bind(m_Listener, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 ||
+        listen(m_Listener, 8) != 0 || pipe(m_Wake) != 0) {
+        LOG_ENGINE_ERROR("[Telemetry] Cannot listen on '{}': {}.", endpoint, std::strerror(errno));
+        if (m_Listener >= 0)
+            close(m_Listener);
+        m_Listener = -1;
+        return false;
+    }
+    SetNonBlocking(m_Listener);
+    SetNonBlocking(m_Wake[0]);
+    SetNonBlocking(m_Wake[1]);
+
+    m_Endpoint = endpoint;
+    m_SocketPath = address.socketPath;
+    if (address.storage.ss_family == AF_INET) {
+        sockaddr_in bound{};
+        socklen_t length = sizeof(bound);
+        getsockname(m_Listener, reinterpret_cast<sockaddr*>(&bound), &length);
+        m_Endpoint = "tcp:" + std::to_string(ntohs(bound.sin_port));
+    }
+    m_Stopping = false;
+    m_Thread = std::thread(&TelemetryServer::ThreadMain, this);
+    LOG_ENGINE_INFO("[Telemetry] Streaming on {}.", m_Endpoint);
+    return true;
+}
+
+void TelemetryServer::Stop() {
+    if (!IsRunning())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Stopping = true;
+    }
+    const char byte = 0;
+    (void)!write(m_Wake[1], &byte, 1);
+    m_Thread.join();
+
+    close(m_Listener);
+    close(m_Wake[0]);
+    close(m_Wake[1]);
+    m_Listener = m_Wake[0] = m_Wake[1] = -1;
+    if (!m_SocketPath.empty())
+        unlink(m_SocketPath.c_str());
+    m_Queue.clear();
+}
+
+void TelemetryServer::Publish(TelemetryFrame frame) {
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        frame.index = m_NextFrame++;
+        if (GetClientCount() == 0)
+            return;
+        if (m_Queue.size() >= kMaxQueuedFrames) {
+            m_DroppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_Queue.push_back(std::move(frame));
+    }
+    // A full pipe already has the thread awake
+    const char byte = 0;
+    (void)!write(m_Wake[1], &byte, 1);
+}
+
+void TelemetryServer::ThreadMain() {
+    std::vector<pollfd> descriptors;
+    std::vector<TelemetryFrame> frames;
+    while (true) {
+        descriptors.clear();
+        descriptors.push_back({ m_Wake[0], POLLIN, 0 });
+        descriptors.push_back({ m_Listener, POLLIN, 0 });
+        for (const Client& client : m_Clients)
+            descriptors.push_back({ client.socket, short(POLLIN | (client.sent < client.outbox.size() ? POLLOUT : 0)), 0 });
+        if (poll(descriptors.data(), descriptors.size(), -1) < 0 && errno != EINTR)
+            break;
+
+        char drain[64];
+        while (read(m_Wake[0], drain, sizeof(drain)) > 0) {}
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            frames.assign(std::make_move_iterator(m_Queue.begin()), std::make_move_iterator(m_Queue.end()));
+            m_Queue.clear();
+            stopping = m_Stopping;
+        }
+
+        // Viewers never send anything; readable means closed
+        for (size_t i = 0; i < m_Clients.size(); ++i) {
+            Client& client = m_Clients[i];
+            const short events = descriptors[i + 2].revents;
+            char ignored[256];
+            if ((events & (POLLERR | POLLHUP | POLLNVAL)) || ((events & POLLIN) && recv(client.socket, ignored, sizeof(ignored), 0) <= 0))
+                Disconnect(client);
+        }
+        if (descriptors[1].revents & POLLIN)
+            Accept();
+        Send(frames);
+        frames.clear();
+        for (Client& client : m_Clients) {
+            if (client.socket >= 0 && !Flush(client))
+                Disconnect(client);
+        }
+
+        if (stopping) {
+            // Give viewers a moment to take what is left
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kStopFlushMs);
+            for (Client& client : m_Clients) {
+                while (client.socket >= 0 && client.sent < client.outbox.size() && std::chrono::steady_clock::now() < deadline) {
+                    pollfd descriptor = { client.socket, POLLOUT, 0 };
+                    poll(&descriptor, 1, 10);
+                    if (!Flush(client))
+                        Disconnect(client);
+                }
+            }
+            for (Client& client : m_Clients)
+                Disconnect(client);
+        }
+        m_Clients.erase(std::remove_if(m_Clients.begin(), m_Clients.end(), [](const Client& client) { return client.socket < 0; }),
+                        m_Clients.end());
+        m_ClientCount.store(static_cast<uint32_t>(m_Clients.size()), std::memory_order_relaxed);
+        if (stopping)
+            return;
+    }
+}
+
+void TelemetryServer::Accept() {
+    while (true) {
+        const int socket = accept(m_Listener, nullptr, nullptr);
+        if (socket < 0)
+            return;
+        SetNonBlocking(socket);
+#ifdef SO_NOSIGPIPE
+        const int on = 1;
+        setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        Client client;
+        client.socket = socket;
+        client.outbox.assign(kMagic, kMagic + sizeof(kMagic));
+        client.outbox.push_back(kTelemetryVersion);
+        m_Clients.push_back(std::move(client));
+        LOG_ENGINE_INFO("[Telemetry] Viewer connected to {}.", m_Endpoint);
+    }
+}
+
+bool TelemetryServer::Flush(Client& client) {
+    while (client.sent < client.outbox.size()) {
+        const ssize_t written = send(client.socket, client.outbox.data() + client.sent, client.outbox.size() - client.sent,
+                                     MSG_NOSIGNAL);
+        if (written > 0)
+            client.sent += static_cast<size_t>(written);
+        else if (written < 0 && errno == EINTR)
+            continue;
+        else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            return false;
+    }
+    if (client.sent == client.outbox.size()) {
+        client.outbox.clear();
+        client.sent = 0;
+    } else if (client.sent >= kMaxClientBacklog) {
+        client.outbox.erase(client.outbox.begin(), client.outbox.begin() + static_cast<std::ptrdiff_t>(client.sent));
+        client.sent = 0;
+    }
+    return true;
+}
+
+void TelemetryServer::Disconnect(Client& client) {
+    if (client.socket < 0)
+        return;
+    close(client.socket);
+    client.socket = -1;
+    LOG_ENGINE_INFO("[Telemetry] Viewer disconnected from {}.", m_Endpoint);
+}
+
+#else
+
+bool TelemetryServer::Start(const std::string& endpoint) {
+    LOG_ENGINE_WARN("[Telemetry] Sockets are not supported on this platform; not streaming on '{}'.", endpoint);
+    return false;
+}
+
+void TelemetryServer::Stop() {}
+
+void TelemetryServer::Publish(TelemetryFrame frame) {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    frame.index = m_NextFrame++;
+}
+
+void TelemetryServer::ThreadMain() {}
+void TelemetryServer::Accept() {}
+bool TelemetryServer::Flush(Client&) { return false; }
+void TelemetryServer::Disconnect(Client&) {}
+
+#endif
+
+void TelemetryServer::Send(const std::vector<TelemetryFrame>& frames) {
+    std::vector<uint8_t> body, payload;
+    for (const TelemetryFrame& frame : frames) {
+        auto intern = [this](const std::string& name) {
+            auto it = m_NameIds.find(name);
+            if (it != m_NameIds.end())
+                return it->second;
+            const uint32_t id = static_cast<uint32_t>(m_Names.size());
+            m_Names.push_back(name);
+            m_NameIds.emplace(name, id);
+            return id;
+        };
+        body.clear();
+        PutVarint(body, frame.index);
+        PutDouble(body, frame.frameMs);
+        PutVarint(body, frame.events.size());
+        for (const ProfileEvent& event : frame.events) {
+            PutVarint(body, intern(event.name));
+            PutVarint(body, event.threadIndex);
+            PutVarint(body, ZigZag(std::llround(event.startMs * 1e6)));
+            PutVarint(body, static_cast<uint64_t>(std::max<int64_t>(std::llround(event.durationMs * 1e6), 0)));
+        }
+        PutVarint(body, frame.counters.size());
+        for (const auto& [name, value] : frame.counters) {
+            PutVarint(body, intern(name));
+            PutDouble(body, value);
+        }
+
+        for (Client& client : m_Clients) {
+            if (client.socket < 0)
+                continue;
+            // Skipping a frame whole keeps the stream valid; its names go with the next one sent
+            if (client.outbox.size() - client.sent > kMaxClientBacklog) {
+                m_DroppedFrames.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            for (; client.namesSent < m_Names.size(); ++client.namesSent) {
+                payload.clear();
+                PutVarint(payload, client.namesSent);
+                payload.insert(payload.end(), m_Names[client.namesSent].begin(), m_Names[client.namesSent].end());
+                PutMessage(client.outbox, MessageType::String, payload);
+            }
+            PutMessage(client.outbox, MessageType::Frame, body);
+        }
+    }
+}
+
+void TelemetryServer::PublishProfilingFrame(double frameMs) {
+    TelemetryFrame frame;
+    frame.frameMs = frameMs;
+    // Nobody is watching: only the frame number moves
+    if (GetClientCount() > 0) {
+        frame.events = Profiling::GetFrameEvents();
+        for (const auto& counter : Profiling::GetCounters())
+            frame.counters.push_back(counter);
+        std::sort(frame.counters.begin(), frame.counters.end());
+        const MemoryManager& memory = MemoryManager::GetInstance();
+        frame.counters.emplace_back("Memory.Allocated", double(memory.GetTotalAllocated()));
+        frame.counters.emplace_back("Memory.Deallocated", double(memory.GetTotalDeallocated()));
+        frame.counters.emplace_back("Memory.Current", double(memory.GetTotalAllocated() - memory.GetTotalDeallocated()));
+    }
+    Publish(std::move(frame));
+}
+
+// ----------------------------------------------------------
+// DECODER
+// ----------------------------------------------------------
+
+bool TelemetryDecoder::Feed(const void* data, size_t size, const std::function<void(const TelemetryFrame&)>& onFrame) {
+    if (m_Broken)
+        return false;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_Pending.insert(m_Pending.end(), bytes, bytes + size);
+
+    Cursor cursor{ m_Pending.data(), m_Pending.data() + m_Pending.size() };
+    if (!m_HeaderRead) {
+        if (m_Pending.size() < kHeaderSize)
+            return true;
+        if (std::memcmp(m_Pending.data(), kMagic, sizeof(kMagic)) != 0 || m_Pending[sizeof(kMagic)] != kTelemetryVersion) {
+            m_Broken = true;
+            return false;
+        }
+        cursor.at += kHeaderSize;
+        m_HeaderRead = true;
+    }
+
+    TelemetryFrame frame;
+    while (cursor.at < cursor.end) {
+        // Stop at an incomplete message; the rest arrives with the next bytes
+        Cursor message = cursor;
+        const uint8_t type = *message.at++;
+        const uint64_t length = message.Varint();
+        if (length > kMaxMessageSize) {
+            m_Broken = true;
+            return false;
+        }
+        if (!message.ok || uint64_t(message.end - message.at) < length)
+            break;
+        Cursor payload{ message.at, message.at + length };
+        cursor.at = payload.end;
+
+        if (type == uint8_t(MessageType::String)) {
+            const uint64_t id = payload.Varint();
+            if (!payload.ok || id > m_Names.size()) {
+                m_Broken = true;
+                return false;
+            }
+            std::string name(reinterpret_cast<const char*>(payload.at), payload.end - payload.at);
+            if (id == m_Names.size())
+                m_Names.push_back(std::move(name));
+            else
+                m_Names[id] = std::move(name);
+        } else if (type == uint8_t(MessageType::Frame)) {
+            auto name = [&](uint64_t id) -> const std::string& {
+                static const std::string unknown;
+                if (id < m_Names.size())
+                    return m_Names[id];
+                payload.ok = false;
+                return unknown;
+            };
+            frame.index = payload.Varint();
+            frame.frameMs = payload.Double();
+            frame.events.resize(std::min<uint64_t>(payload.Varint(), length));
+            for (ProfileEvent& event : frame.events) {
+                event.name = name(payload.Varint());
+                event.threadIndex = static_cast<uint32_t>(payload.Varint());
+                event.startMs = double(UnZigZag(payload.Varint())) * 1e-6;
+                event.durationMs = double(payload.Varint()) * 1e-6;
+            }
+            frame.counters.resize(std::min<uint64_t>(payload.Varint(), length));
+            for (auto& [counter, value] : frame.counters) {
+                counter = name(payload.Varint());
+                value = payload.Double();
+            }
+            if (!payload.ok) {
+                m_Broken = true;
+                return false;
+            }
+            onFrame(frame);
+        }
+    }
+    m_Pending.erase(m_Pending.begin(), m_Pending.begin() + (cursor.at - m_Pending.data()));
+    return true;
+}
+
+// ----------------------------------------------------------
+// CLIENT
+// ----------------------------------------------------------
+
+#if ENGINE_TELEMETRY_POSIX
+
+bool TelemetryClient::Connect(const std::string& endpoint) {
+    Close();
+    Address address;
+    if (!ParseEndpoint(endpoint, address))
+        return false;
+    m_Socket = OpenSocket(address);
+    if (m_Socket < 0 || connect(m_Socket, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void TelemetryClient::Close() {
+    if (m_Socket >= 0)
+        close(m_Socket);
+    m_Socket = -1;
+}
+
+bool TelemetryClient::Receive(std::vector<uint8_t>& bytes, int timeoutMs) {
+    if (m_Socket < 0)
+        return false;
+    pollfd descriptor = { m_Socket, POLLIN, 0 };
+    if (poll(&descriptor, 1, timeoutMs) <= 0)
+        return true;
+    uint8_t chunk[64 * 1024];
+    const ssize_t received = recv(m_Socket, chunk, sizeof(chunk), 0);
+    if (received > 0)
+        bytes.insert(bytes.end(), chunk, chunk + received);
+    return received > 0 || (received < 0 && (errno == EINTR || errno == EAGAIN));
+}
+
+#else
+
+bool TelemetryClient::Connect(const std::string&) { return false; }
+void TelemetryClient::Close() {}
+bool TelemetryClient::Receive(std::vector<uint8_t>&, int) { return false; }
+
+#endif
@@ -0,0 +1,105 @@
+#include "Core/Replay.h"
+#include "Utils/Logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * 3DGameEngineReplay [<replay file>] [--threads 1,2,4] [--frames N] [--warmup N] [--bodies N] [--report <path>]
+ * 3DGameEngineReplay --generate <replay file> [--frames N] [--bodies N] [--seed S]
+ *
+ * Runs a replay (Core/Replay.h) headless once per thread count and prints a
+ * frame-time report for each: percentiles per named scope, and the checksum
+ * of the simulation state. Every run must end with the same checksum; if one
+ * does not, the first frame where it diverged is printed and the exit code is
+ * 1. Without a replay file, the built-in benchmark replay is run (--bodies and
+ * --frames size it; --frames also shortens a loaded replay).
+ *
+ * --generate writes the built-in benchmark replay to a file, as a fixed
+ * workload to compare builds against.
+ */
+
+int main(int argc, char* argv[]) {
+    std::string replayPath, reportPath, generatePath;
+    std::vector<uint32_t> threads;
+    uint32_t frames = 0, warmup = 0, bodies = 500, seed = 1;
+    bool valid = true;
+    for (int i = 1; valid && i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            std::istringstream list(argv[++i]);
+            std::string count;
+            while (std::getline(list, count, ','))
+                threads.push_back(static_cast<uint32_t>(std::strtoul(count.c_str(), nullptr, 10)));
+        } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+            frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+            warmup = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--bodies") == 0 && hasValue)
+            bodies = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--report") == 0 && hasValue)
+            reportPath = argv[++i];
+        else if (std::strcmp(argv[i], "--generate") == 0 && hasValue)
+            generatePath = argv[++i];
+        else if (argv[i][0] != '-' && replayPath.empty())
+            replayPath = argv[i];
+        else
+            valid = false;
+    }
+    if (!valid) {
+        std::fprintf(stderr, "usage: %s [<replay file>] [--threads 1,2,4] [--frames N] [--warmup N] [--bodies N] [--report <path>]\n"
+                             "       %s --generate <replay file> [--frames N] [--bodies N] [--seed S]\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    Logger::Init();
+    Core::Replay replay;
+    if (!replayPath.empty()) {
+        if (!Core::LoadReplay(replayPath, replay))
+            return 1;
+        if (frames > 0 && frames < replay.input.size())
+            replay.input.resize(frames);
+    } else {
+        replay = Core::MakeBenchmarkReplay(bodies, frames > 0 ? frames : 600, seed);
+    }
+    if (!generatePath.empty())
+        return Core::SaveReplay(generatePath, replay) ? 0 : 1;
+    if (threads.empty())
+        threads.push_back(0);
+
+    std::string reports;
+    std::vector<Core::ReplayReport> runs;
+    int result = 0;
+    for (uint32_t threadCount : threads) {
+        Core::ReplayOptions options;
+        options.workerCount = threadCount;
+        options.warmupFrames = warmup;
+        runs.push_back(Core::RunReplay(replay, options));
+        if (runs.back().frameChecksums.size() != replay.input.size()) {
+            std::fprintf(stderr, "the replay did not run\n");
+            return 1;
+        }
+        const std::string report = Core::FormatReplayReport(runs.back());
+        std::printf("%s\n", report.c_str());
+        reports += report + "\n";
+
+        if (runs.back().checksum != runs.front().checksum || runs.back().frames != runs.front().frames) {
+            const uint32_t frame = Core::FindDivergence(runs.front(), runs.back());
+            std::printf("NOT DETERMINISTIC: %u workers diverged from %u workers at frame %u\n\n", runs.back().workerCount,
+                        runs.front().workerCount, frame);
+            result = 1;
+        }
+    }
+    if (!reportPath.empty()) {
+        std::ofstream out(reportPath, std::ios::trunc);
+        out << reports;
+    }
+    return result;
+}
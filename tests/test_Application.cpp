@@ -1,7 +1,16 @@
 #include <catch2/catch_all.hpp>
 #include "Core/Application.h"
+#include "Core/Startup.h"
+#include "Threading/JobSystem.h"
 #include "Utils/Logger.h"
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 TEST_CASE("Application lifecycle", "[application]") {
     Logger::Init();  // Ensure logger is initialized
 
@@ -38,3 +47,156 @@ TEST_CASE("Application lifecycle", "[application]") {
         SUCCEED("Application started and shut down without crashing.");
     }
 }
+
+TEST_CASE("Startup steps run after their dependencies, independent ones concurrently", "[application]") {
+    std::atomic<uint32_t> order{ 0 };
+    std::atomic<uint32_t> running{ 0 }, peakRunning{ 0 };
+    std::thread::id mainThread = std::this_thread::get_id(), windowThread;
+    uint32_t loggerAt = 0, assetsAt = 0, fileSystemAt = 0;
+    bool rendezvous = false;
+
+    // With rendezvous, a slow step waits until all three slow steps are running, so
+    // the test does not depend on how fast the machine starts threads
+    auto slow = [&](uint32_t* at) {
+        return [&, at] {
+            if (at)
+                *at = order++;
+            const uint32_t now = ++running;
+            for (uint32_t peak = peakRunning; now > peak && !peakRunning.compare_exchange_weak(peak, now);) {}
+            if (rendezvous) {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                while (peakRunning < 3 && std::chrono::steady_clock::now() < deadline)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(40));
+            }
+            --running;
+            return true;
+        };
+    };
+
+    Core::StartupGraph graph;
+    graph.Add("Logger", {}, [&] { loggerAt = order++; return true; });
+    graph.Add("FileSystem", { "Logger" }, slow(&fileSystemAt));
+    graph.Add("JobSystem", { "Logger" }, slow(nullptr));
+    graph.Add("Window", { "Logger" }, [&] { windowThread = std::this_thread::get_id(); return slow(nullptr)(); }, true);
+    graph.Add("Assets", { "FileSystem", "JobSystem" }, [&] { assetsAt = order++; return true; });
+
+    SECTION("With helper threads") {
+        rendezvous = true;
+        REQUIRE(graph.Run(3));
+        CHECK(loggerAt == 0);
+        CHECK(assetsAt > fileSystemAt);
+        CHECK(fileSystemAt > loggerAt);
+        CHECK(windowThread == mainThread);
+        CHECK(graph.GetCriticalPathMs() < graph.GetTotalMs() + 1.0);
+        for (const Core::StartupStep& step : graph.GetSteps()) {
+            CHECK(step.succeeded);
+            CHECK(step.durationMs >= 0.0);
+        }
+
+        // The recorded spans of the three independent steps overlap, each on its own thread
+        const std::vector<Core::StartupStep>& steps = graph.GetSteps();
+        const Core::StartupStep* independent[] = { &steps[1], &steps[2], &steps[3] };
+        CHECK(steps[3].threadIndex == 0);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = i + 1; j < 3; ++j) {
+                const Core::StartupStep& a = *independent[i];
+                const Core::StartupStep& b = *independent[j];
+                CHECK(a.threadIndex != b.threadIndex);
+                CHECK(a.startMs < b.startMs + b.durationMs);
+                CHECK(b.startMs < a.startMs + a.durationMs);
+            }
+        }
+    }
+    SECTION("Without helper threads everything runs in order on the caller") {
+        REQUIRE(graph.Run(0));
+        CHECK(peakRunning == 1);
+        CHECK(graph.GetTotalMs() >= 120.0);
+        for (const Core::StartupStep& step : graph.GetSteps())
+            CHECK(step.threadIndex == 0);
+    }
+}
+
+TEST_CASE("A failed startup step skips its dependents", "[application]") {
+    bool assetsRan = false;
+    Core::StartupGraph graph;
+    graph.Add("Logger", {}, [] { return true; });
+    graph.Add("FileSystem", { "Logger" }, [] { return false; });
+    graph.Add("Window", { "Logger" }, [] { return true; }, true);
+    graph.Add("Manifest", { "FileSystem" }, [&] { assetsRan = true; return true; });
+    graph.Add("Assets", { "Manifest", "Window" }, [&] { assetsRan = true; return true; });
+
+    CHECK_FALSE(graph.Run(2));
+    CHECK_FALSE(assetsRan);
+    const std::vector<Core::StartupStep>& steps = graph.GetSteps();
+    CHECK(steps[0].succeeded);
+    CHECK_FALSE(steps[1].succeeded);
+    CHECK_FALSE(steps[1].skipped);
+    CHECK(steps[2].succeeded);
+    CHECK(steps[3].skipped);
+    CHECK(steps[4].skipped);
+}
+
+TEST_CASE("Headless startup exports a trace of its steps", "[application]") {
+    Logger::Init();
+    const std::string tracePath = (std::filesystem::temp_directory_path() / "engine_startup_trace.json").string();
+    std::filesystem::remove(tracePath);
+
+    Core::ApplicationSettings settings;
+    settings.headless = true;
+    settings.workerCount = 2;
+    settings.startupTracePath = tracePath;
+    Core::Application app(settings);
+    REQUIRE(app.Init());
+    CHECK(app.GetWindow() == nullptr);
+    REQUIRE(app.GetFileSystem() != nullptr);
+    CHECK(Threading::JobSystem::GetWorkerCount() == 2);
+    CHECK(app.GetStartup().GetSteps().size() == 7);
+    CHECK(Profiling::GetCounter("Startup.TotalMs") == app.GetStartup().GetTotalMs());
+
+    std::ifstream file(tracePath);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    CHECK(trace.str().rfind("{\"traceEvents\":[", 0) == 0);
+    for (const char* step : { "Logger", "Memory", "JobSystem", "FileSystem", "AssetManifest", "Telemetry", "Window" })
+        CHECK(trace.str().find(std::string("\"name\":\"") + step + "\"") != std::string::npos);
+    app.Shutdown();
+
+    SECTION("A missing archive fails startup") {
+        settings.contentArchive = tracePath + ".missing";
+        Core::Application broken(settings);
+        CHECK_FALSE(broken.Init());
+        broken.Shutdown();
+    }
+}
+
+TEST_CASE("Headless Run() steps the systems without a window", "[application]") {
+    Logger::Init();
+    Core::ApplicationSettings settings;
+    settings.headless = true;
+    settings.workerCount = 1;
+    settings.maxFrames = 5;
+    Core::Application app(settings);
+    REQUIRE(app.Init());
+
+    uint32_t frames = 0;
+    bool stopEarly = false;
+    app.GetScheduler().AddSystem("Count", ECS::SystemAccess(), [&](const ECS::SystemContext&) {
+        if (++frames == 2 && stopEarly)
+            app.RequestStop();
+    });
+
+    Profiling::SetCounter("Startup.TimeToFirstFrameMs", -1.0);
+    app.Run();
+    CHECK(frames == 5);
+    CHECK(Profiling::GetCounter("Startup.TimeToFirstFrameMs") >= app.GetStartup().GetTotalMs());
+
+    SECTION("RequestStop ends the loop after the current frame") {
+        frames = 0;
+        stopEarly = true;
+        app.Run();
+        CHECK(frames == 2);
+    }
+    app.Shutdown();
+}
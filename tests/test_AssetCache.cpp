@@ -0,0 +1,203 @@
+#include <catch2/catch_all.hpp>
+#include "IO/AssetCache.h"
+#include "IO/CookedAsset.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * The cache is driven with in-memory loaders that count their calls, so the
+ * tests can tell a hit, a coalesced request and a reload apart. The last test
+ * loads through a real FileSystem.
+ */
+
+namespace {
+
+    // Loads "<n>" as an int of n bytes; "fail" fails. Can hold loads until opened
+    struct FakeLoader {
+        std::atomic<uint32_t>   calls{ 0 };
+        std::mutex              mutex;
+        std::condition_variable condition;
+        bool                    open = true;
+
+        IO::AssetLoadFn Fn() {
+            return [this](IO::FileSystem&, const std::string& path, IO::AssetPayload& out) {
+                ++calls;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [&] { return open; });
+                }
+                if (path == "fail")
+                    return false;
+                const int size = std::stoi(path);
+                out = { std::make_shared<int>(size), static_cast<uint64_t>(size) };
+                return true;
+            };
+        }
+
+        void SetOpen(bool value) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                open = value;
+            }
+            condition.notify_all();
+        }
+    };
+
+} // namespace
+
+TEST_CASE("Identical requests in flight are loaded once", "[assets]") {
+    IO::FileSystem fs;
+    IO::AssetCache cache(fs, 2);
+    FakeLoader loader;
+    const IO::AssetType type = cache.RegisterType({ "Fake", loader.Fn() });
+
+    loader.SetOpen(false);
+    std::vector<IO::AssetHandle> handles(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < handles.size(); ++i)
+        threads.emplace_back([&, i] { handles[i] = cache.Request(type, "./100"); });
+    for (std::thread& thread : threads)
+        thread.join();
+    CHECK(cache.GetState(handles[0]) == IO::AssetState::Loading);
+    CHECK(cache.Get<int>(handles[0]) == nullptr);
+    loader.SetOpen(true);
+
+    for (IO::AssetHandle handle : handles) {
+        CHECK(handle == handles[0]);
+        REQUIRE(cache.Wait(handle) == IO::AssetState::Ready);
+    }
+    CHECK(*cache.Get<int>(handles[0]) == 100);
+    CHECK(loader.calls == 1);
+    const IO::AssetCacheStats stats = cache.GetStats();
+    CHECK(stats.misses == 1);
+    CHECK(stats.coalesced == 7);
+    CHECK(stats.residentBytes == 100);
+    CHECK(Profiling::GetCounter("Assets.Fake.ResidentBytes") == 100.0);
+
+    for (IO::AssetHandle handle : handles)
+        cache.Release(handle);
+}
+
+TEST_CASE("Unreferenced assets are evicted least recently released first", "[assets]") {
+    IO::FileSystem fs;
+    IO::AssetCache cache(fs, 1);
+    FakeLoader loader;
+    const IO::AssetType small = cache.RegisterType({ "Small", loader.Fn(), 250 });
+    const IO::AssetType large = cache.RegisterType({ "Large", loader.Fn() });
+
+    const IO::AssetHandle a = cache.Load(small, "100");
+    const IO::AssetHandle b = cache.Load(small, "101");
+    const IO::AssetHandle c = cache.Load(small, "102");
+    // Referenced assets stay, even over budget
+    CHECK(cache.GetResidentBytes(small) == 303);
+    CHECK(cache.GetStats().evictions == 0);
+
+    cache.Release(b);
+    cache.Release(a);
+    CHECK(cache.GetResidentBytes(small) == 202);   // b went first
+    CHECK(cache.GetStats().evictions == 1);
+    cache.Release(c);
+    CHECK(cache.GetResidentBytes(small) == 202);
+
+    // a is still resident: a hit, and taken off the eviction list
+    const IO::AssetHandle a2 = cache.Load(small, "100");
+    CHECK(loader.calls == 3);
+    CHECK(cache.GetStats().hits == 1);
+    // b was evicted: a reload, which pushes c (released last, but before a2 was taken) out
+    const IO::AssetHandle b2 = cache.Load(small, "101");
+    CHECK(loader.calls == 4);
+    CHECK(*cache.Get<int>(a2) == 100);
+    CHECK(*cache.Get<int>(b2) == 101);
+    CHECK(cache.GetResidentBytes(small) == 201);
+    CHECK(cache.GetStats().evictions == 2);
+
+    // Budgets are per type
+    const IO::AssetHandle big = cache.Load(large, "1000");
+    cache.Release(big);
+    CHECK(cache.GetResidentBytes(large) == 1000);
+    cache.SetBudget(large, 999);
+    CHECK(cache.GetResidentBytes(large) == 0);
+
+    cache.Release(a2);
+    cache.Release(b2);
+    cache.SetBudget(small, 0);
+    CHECK(cache.GetStats().residentBytes == 0);
+    CHECK(Profiling::GetCounter("Assets.Evictions") == 5.0);
+}
+
+TEST_CASE("Failed loads are reported and retried", "[assets]") {
+    IO::FileSystem fs;
+    IO::AssetCache cache(fs, 1);
+    FakeLoader loader;
+    const IO::AssetType type = cache.RegisterType({ "Fake", loader.Fn() });
+
+    const IO::AssetHandle handle = cache.Load(type, "fail");
+    CHECK(cache.GetState(handle) == IO::AssetState::Failed);
+    CHECK(cache.Get<int>(handle) == nullptr);
+    const IO::AssetHandle again = cache.Acquire(handle);
+    cache.Release(handle);
+    cache.Release(again);
+
+    const IO::AssetHandle retry = cache.Load(type, "fail");
+    CHECK(loader.calls == 2);
+    CHECK(retry != handle);   // Same slot, new generation
+    cache.Release(retry);
+
+    // Reusing a slot many times never hands out an old handle again
+    std::vector<IO::AssetHandle> handles{ handle, retry };
+    for (int i = 0; i < 300; ++i) {
+        handles.push_back(cache.Load(type, "fail"));
+        cache.Release(handles.back());
+    }
+    std::sort(handles.begin(), handles.end());
+    CHECK(std::adjacent_find(handles.begin(), handles.end()) == handles.end());
+}
+
+TEST_CASE("Assets load through the FileSystem", "[assets]") {
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "engine_cache_content";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "meshes");
+    std::ofstream(root / "meshes" / "quad.obj") << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n";
+    std::ofstream(root / "notes.txt") << "hello";
+    IO::MeshData quadMesh;
+    REQUIRE(IO::AssetLoader::LoadOBJ((root / "meshes" / "quad.obj").string(), quadMesh));
+    const std::vector<uint8_t> cooked = IO::CookMesh(IO::AssetLoader::ImportMesh(quadMesh));
+    std::ofstream(root / "meshes" / "quad.mesh", std::ios::binary)
+        .write(reinterpret_cast<const char*>(cooked.data()), static_cast<std::streamsize>(cooked.size()));
+    const std::string archivePath = root.string() + ".pak";
+    std::string error;
+    REQUIRE(IO::Archive::Build(root.string(), IO::Archive::ListFiles(root.string()), archivePath, IO::PackSettings(), error));
+
+    IO::FileSystem fs;
+    REQUIRE(fs.Mount(archivePath));
+    IO::AssetCache cache(fs);
+    const IO::AssetType meshes = cache.RegisterType({ "Mesh", IO::LoadMeshAsset });
+    const IO::AssetType bytes = cache.RegisterType({ "Bytes", IO::LoadBytesAsset });
+    const IO::AssetType cookedMeshes = cache.RegisterType({ "CookedMesh", IO::LoadCookedMeshAsset });
+
+    const IO::AssetHandle quad = cache.Load(meshes, "meshes/quad.obj");
+    REQUIRE(cache.GetState(quad) == IO::AssetState::Ready);
+    CHECK(cache.Get<IO::MeshData>(quad)->indices.size() == 6);
+    const IO::AssetHandle notes = cache.Load(bytes, "notes.txt");
+    REQUIRE(cache.GetState(notes) == IO::AssetState::Ready);
+    CHECK(cache.Get<std::vector<uint8_t>>(notes)->size() == 5);
+    const IO::AssetHandle cookedQuad = cache.Load(cookedMeshes, "meshes/quad.mesh");
+    REQUIRE(cache.GetState(cookedQuad) == IO::AssetState::Ready);
+    CHECK(cache.Get<IO::CookedMesh>(cookedQuad)->indices.size() == 6);
+    const IO::AssetHandle missing = cache.Load(bytes, "missing.txt");
+    CHECK(cache.GetState(missing) == IO::AssetState::Failed);
+
+    cache.Release(quad);
+    cache.Release(notes);
+    cache.Release(cookedQuad);
+    cache.Release(missing);
+}
@@ -0,0 +1,503 @@
+#include <catch2/catch_all.hpp>
+#include "IO/AssetLoader.h"
+#include "IO/ContentCooker.h"
+#include "IO/CookedAsset.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+/*
+ * Tests for the mesh import stage: every optimization is checked against a
+ * property of the input (same triangles, bounded error, conservative culling).
+ */
+
+namespace {
+
+    // Height-field grid of (n x n) quads in the XZ plane, counter-clockwise seen from +Y
+    IO::MeshData MakeGrid(uint32_t n, float amplitude) {
+        IO::MeshData mesh;
+        for (uint32_t z = 0; z <= n; ++z) {
+            for (uint32_t x = 0; x <= n; ++x) {
+                IO::MeshVertex v;
+                v.position = { float(x), amplitude * std::sin(x * 0.3f) * std::cos(z * 0.2f), float(z) };
+                v.normal = { 0.0f, 1.0f, 0.0f };
+                v.u = float(x) / n;
+                v.v = float(z) / n;
+                mesh.vertices.push_back(v);
+            }
+        }
+        for (uint32_t z = 0; z < n; ++z) {
+            for (uint32_t x = 0; x < n; ++x) {
+                const uint32_t i = z * (n + 1) + x;
+                mesh.indices.insert(mesh.indices.end(), { i, i + n + 1, i + 1, i + 1, i + n + 1, i + n + 2 });
+            }
+        }
+        return mesh;
+    }
+
+    // UV sphere with a duplicated seam; triangles wound outwards, degenerate ones dropped
+    IO::MeshData MakeSphere(uint32_t rings, uint32_t segments) {
+        IO::MeshData mesh;
+        for (uint32_t r = 0; r <= rings; ++r) {
+            for (uint32_t s = 0; s <= segments; ++s) {
+                const float theta = 3.14159265f * r / rings;
+                const float phi = 6.28318531f * s / segments;
+                IO::MeshVertex v;
+                v.normal = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                v.position = v.normal * 2.0f;
+                v.u = float(s) / segments;
+                v.v = float(r) / rings;
+                mesh.vertices.push_back(v);
+            }
+        }
+        auto add = [&](uint32_t a, uint32_t b, uint32_t c) {
+            const Math::Vec3& pa = mesh.vertices[a].position;
+            const Math::Vec3 n = Math::Cross(mesh.vertices[b].position - pa, mesh.vertices[c].position - pa);
+            if (Math::Length(n) < 1e-6f)
+                return;
+            if (Math::Dot(n, pa + mesh.vertices[b].position + mesh.vertices[c].position) < 0.0f)
+                std::swap(b, c);
+            mesh.indices.insert(mesh.indices.end(), { a, b, c });
+        };
+        for (uint32_t r = 0; r < rings; ++r) {
+            for (uint32_t s = 0; s < segments; ++s) {
+                const uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+                add(a, b, a + 1);
+                add(a + 1, b, b + 1);
+            }
+        }
+        return mesh;
+    }
+
+    void ShuffleTriangles(std::vector<uint32_t>& indices, uint32_t seed) {
+        std::vector<uint32_t> order(indices.size() / 3);
+        for (uint32_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+        std::vector<uint32_t> shuffled;
+        for (uint32_t t : order)
+            shuffled.insert(shuffled.end(), { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] });
+        indices.swap(shuffled);
+    }
+
+    // Triangles as rotation-normalized triples, sorted, to compare index buffers
+    std::vector<std::array<uint32_t, 3>> CanonicalTriangles(const uint32_t* indices, size_t count) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < count; i += 3) {
+            std::array<uint32_t, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    void WriteText(const std::filesystem::path& path, const std::string& text) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+    }
+
+    void WriteOBJ(const std::filesystem::path& path, const IO::MeshData& mesh) {
+        std::string text;
+        for (const IO::MeshVertex& v : mesh.vertices)
+            text += "v " + std::to_string(v.position.x) + " " + std::to_string(v.position.y) + " " + std::to_string(v.position.z) + "\n";
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+            text += "f " + std::to_string(mesh.indices[i] + 1) + " " + std::to_string(mesh.indices[i + 1] + 1) + " " +
+                    std::to_string(mesh.indices[i + 2] + 1) + "\n";
+        WriteText(path, text);
+    }
+
+} // namespace
+
+TEST_CASE("ACMR counts misses of a FIFO cache of the given size", "[assets]") {
+    // The same triangle over and over only misses the first time
+    std::vector<uint32_t> repeated;
+    for (int i = 0; i < 10; ++i)
+        repeated.insert(repeated.end(), { 0, 1, 2 });
+    REQUIRE(IO::ComputeACMR(repeated.data(), repeated.size(), 3, 3) == Catch::Approx(0.3f));
+    REQUIRE(IO::ComputeACMR(repeated.data(), repeated.size(), 3, 2) == Catch::Approx(3.0f));
+
+    // A single-entry cache still hits on a repeated vertex
+    const uint32_t point[] = { 0, 0, 0 };
+    REQUIRE(IO::ComputeACMR(point, 3, 1, 1) == Catch::Approx(1.0f));
+
+    // A strip as a list: two vertices carry over, one is new per triangle
+    std::vector<uint32_t> strip;
+    for (uint32_t i = 0; i < 8; ++i)
+        strip.insert(strip.end(), { i, i + 1, i + 2 });
+    REQUIRE(IO::ComputeACMR(strip.data(), strip.size(), 10, 3) == Catch::Approx(10.0f / 8.0f));
+    REQUIRE(IO::ComputeACMR(strip.data(), strip.size(), 10, 1) == Catch::Approx(3.0f));
+}
+
+TEST_CASE("Vertex cache optimization keeps triangles and lowers ACMR", "[assets]") {
+    IO::MeshData mesh = MakeGrid(64, 0.0f);
+    ShuffleTriangles(mesh.indices, 7);
+    const auto before = CanonicalTriangles(mesh.indices.data(), mesh.indices.size());
+    const float acmrBefore = IO::ComputeACMR(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+    IO::OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+    const float acmrAfter = IO::ComputeACMR(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+    REQUIRE(CanonicalTriangles(mesh.indices.data(), mesh.indices.size()) == before);
+    REQUIRE(acmrBefore > 2.0f);
+    REQUIRE(acmrAfter < 0.8f);
+}
+
+TEST_CASE("Vertex fetch optimization orders vertices by first use", "[assets]") {
+    IO::MeshData mesh = MakeGrid(16, 1.0f);
+    ShuffleTriangles(mesh.indices, 3);
+    mesh.vertices.push_back(IO::MeshVertex()); // Unreferenced
+    const IO::MeshData original = mesh;
+
+    REQUIRE(IO::OptimizeVertexFetch(mesh) == original.vertices.size() - 1);
+
+    uint32_t next = 0;
+    for (size_t i = 0; i < mesh.indices.size(); ++i) {
+        REQUIRE(mesh.indices[i] <= next);
+        if (mesh.indices[i] == next)
+            ++next;
+        REQUIRE(mesh.vertices[mesh.indices[i]].position == original.vertices[original.indices[i]].position);
+    }
+    REQUIRE(next == mesh.vertices.size());
+}
+
+TEST_CASE("Half floats round-trip", "[assets]") {
+    REQUIRE(IO::FloatToHalf(1.0f) == 0x3C00);
+    REQUIRE(IO::FloatToHalf(-2.0f) == 0xC000);
+    REQUIRE(IO::FloatToHalf(65504.0f) == 0x7BFF);
+    REQUIRE(IO::FloatToHalf(1e6f) == 0x7C00);
+    REQUIRE(IO::FloatToHalf(5.9604645e-8f) == 0x0001);
+    REQUIRE(IO::FloatToHalf(1.0f + 1.0f / 4096.0f) == 0x3C00); // Ties to even
+    REQUIRE(std::fabs(IO::HalfToFloat(IO::FloatToHalf(0.1f)) - 0.1f) < 1e-4f);
+
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        if (((h >> 10) & 0x1F) == 0x1F)
+            continue; // Inf / NaN
+        REQUIRE(IO::FloatToHalf(IO::HalfToFloat(static_cast<uint16_t>(h))) == h);
+    }
+}
+
+TEST_CASE("Quantized vertices stay within precision bounds", "[assets]") {
+    IO::MeshData mesh = MakeSphere(24, 48);
+    const IO::QuantizedMesh quantized = IO::Quantize(mesh);
+    REQUIRE(quantized.vertices.size() == mesh.vertices.size());
+
+    const Math::Vec3 step = quantized.positionScale / 65535.0f;
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const IO::MeshVertex v = IO::Dequantize(quantized, i);
+        const Math::Vec3 error = Math::Abs(v.position - mesh.vertices[i].position);
+        for (int axis = 0; axis < 3; ++axis)
+            REQUIRE(error[axis] <= step[axis] * 0.5f + 1e-6f);
+        REQUIRE(Math::Dot(v.normal, mesh.vertices[i].normal) > 0.995f);
+        REQUIRE(v.u == IO::HalfToFloat(IO::FloatToHalf(mesh.vertices[i].u)));
+    }
+}
+
+TEST_CASE("Simplification reduces triangles and keeps the border", "[assets]") {
+    SECTION("Flat grid collapses with no error") {
+        IO::MeshData mesh = MakeGrid(32, 0.0f);
+        float error = -1.0f;
+        std::vector<uint32_t> lod = IO::Simplify(mesh, mesh.indices, mesh.indices.size() / 4, &error);
+        REQUIRE(lod.size() <= mesh.indices.size() / 4);
+        REQUIRE(error < 1e-3f);
+    }
+
+    SECTION("Curved grid") {
+        IO::MeshData mesh = MakeGrid(48, 2.0f);
+        float error = -1.0f;
+        std::vector<uint32_t> lod = IO::Simplify(mesh, mesh.indices, mesh.indices.size() / 2, &error);
+        REQUIRE(lod.size() <= mesh.indices.size() / 2);
+        REQUIRE(lod.size() > 0);
+        REQUIRE(error >= 0.0f);
+        REQUIRE(error < 0.5f);
+
+        // Every border vertex is still referenced
+        std::vector<uint8_t> used(mesh.vertices.size(), 0);
+        for (uint32_t index : lod)
+            used[index] = 1;
+        for (uint32_t i = 0; i <= 48; ++i) {
+            REQUIRE(used[i]);
+            REQUIRE(used[48 * 49 + i]);
+            REQUIRE(used[i * 49]);
+            REQUIRE(used[i * 49 + 48]);
+        }
+
+        // Surviving triangles still face up
+        for (size_t i = 0; i < lod.size(); i += 3) {
+            const Math::Vec3& a = mesh.vertices[lod[i]].position;
+            const Math::Vec3 n = Math::Cross(mesh.vertices[lod[i + 1]].position - a, mesh.vertices[lod[i + 2]].position - a);
+            REQUIRE(n.y > 0.0f);
+        }
+    }
+}
+
+TEST_CASE("Meshlets respect limits and cover every triangle", "[assets]") {
+    IO::MeshData mesh = MakeSphere(32, 64);
+    IO::OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+    const IO::MeshletData data = IO::BuildMeshlets(mesh, mesh.indices.data(), mesh.indices.size(), 64, 124);
+    REQUIRE(!data.meshlets.empty());
+
+    std::vector<uint32_t> rebuilt;
+    for (const IO::Meshlet& m : data.meshlets) {
+        REQUIRE(m.vertexCount <= 64);
+        REQUIRE(m.triangleCount <= 124);
+        REQUIRE(m.triangleCount > 0);
+        for (uint32_t t = 0; t < m.triangleCount * 3; ++t) {
+            const uint8_t local = data.triangles[m.triangleOffset + t];
+            REQUIRE(local < m.vertexCount);
+            const uint32_t index = data.vertices[m.vertexOffset + local];
+            rebuilt.push_back(index);
+            REQUIRE(Math::Length(mesh.vertices[index].position - m.center) <= m.radius + 1e-5f);
+        }
+    }
+    REQUIRE(CanonicalTriangles(rebuilt.data(), rebuilt.size()) == CanonicalTriangles(mesh.indices.data(), mesh.indices.size()));
+}
+
+TEST_CASE("Meshlet cone culling is conservative", "[assets]") {
+    IO::MeshData mesh = MakeSphere(32, 64);
+    IO::OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+    const IO::MeshletData data = IO::BuildMeshlets(mesh, mesh.indices.data(), mesh.indices.size());
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coordinate(-8.0f, 8.0f);
+    size_t culled = 0, total = 0;
+    for (int sample = 0; sample < 200; ++sample) {
+        const Math::Vec3 camera(coordinate(rng), coordinate(rng), coordinate(rng));
+        for (const IO::Meshlet& m : data.meshlets) {
+            ++total;
+            if (!IO::IsMeshletBackfacing(m, camera))
+                continue;
+            ++culled;
+            for (uint32_t t = 0; t < m.triangleCount; ++t) {
+                const uint8_t* tri = &data.triangles[m.triangleOffset + t * 3];
+                const Math::Vec3& a = mesh.vertices[data.vertices[m.vertexOffset + tri[0]]].position;
+                const Math::Vec3& b = mesh.vertices[data.vertices[m.vertexOffset + tri[1]]].position;
+                const Math::Vec3& c = mesh.vertices[data.vertices[m.vertexOffset + tri[2]]].position;
+                REQUIRE(Math::Dot(Math::Cross(b - a, c - a), camera - a) <= 0.0f);
+            }
+        }
+    }
+    // Roughly half of a sphere faces away; the cones should catch a good part of it
+    REQUIRE(culled > total / 5);
+}
+
+TEST_CASE("OBJ parsing", "[assets]") {
+    const std::string cube =
+        "# unit cube, quads with shared normals\n"
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+        "v 0 0 1\nv 1 0 1\nv 1 1 1\nv 0 1 1\n"
+        "vn 0 0 -1\nvn 0 0 1\nvn 0 -1 0\nvn 0 1 0\nvn -1 0 0\nvn 1 0 0\n"
+        "f 1//1 4//1 3//1 2//1\n"
+        "f 5//2 6//2 7//2 8//2\n"
+        "f 1//3 2//3 6//3 5//3\n"
+        "f 4//4 8//4 7//4 3//4\r\n"
+        "f 1//5 5//5 8//5 4//5\n"
+        "f -7//6 -6//6 -2//6 -3//6\n"; // Relative indices: 2 3 7 6
+
+    IO::MeshData mesh;
+    REQUIRE(IO::AssetLoader::ParseOBJ(cube, mesh));
+    REQUIRE(mesh.indices.size() == 36);
+    REQUIRE(mesh.vertices.size() == 24);
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const Math::Vec3& a = mesh.vertices[mesh.indices[i]].position;
+        const Math::Vec3 n = Math::Cross(mesh.vertices[mesh.indices[i + 1]].position - a, mesh.vertices[mesh.indices[i + 2]].position - a);
+        REQUIRE(Math::Dot(Math::Normalize(n), mesh.vertices[mesh.indices[i]].normal) == Catch::Approx(1.0f));
+    }
+
+    SECTION("Generated normals and UVs") {
+        IO::MeshData triangle;
+        REQUIRE(IO::AssetLoader::ParseOBJ("v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nf 1/1 2/2 3/3\n", triangle));
+        REQUIRE(triangle.vertices.size() == 3);
+        REQUIRE(triangle.vertices[1].u == 1.0f);
+        REQUIRE(triangle.vertices[2].normal == Math::Vec3(0.0f, 0.0f, 1.0f));
+    }
+
+    SECTION("Invalid input") {
+        IO::MeshData invalid;
+        REQUIRE_FALSE(IO::AssetLoader::ParseOBJ("v 0 0 0\nf 1 2 3\n", invalid));
+        REQUIRE_FALSE(IO::AssetLoader::ParseOBJ("# nothing\n", invalid));
+        REQUIRE_FALSE(IO::AssetLoader::LoadOBJ("does/not/exist.obj", invalid));
+    }
+}
+
+TEST_CASE("Mesh import produces a consistent LOD chain", "[assets]") {
+    const IO::MeshData source = MakeSphere(48, 96);
+    const IO::ImportedMesh imported = IO::AssetLoader::ImportMesh(source);
+
+    REQUIRE(imported.lods.size() >= 3);
+    REQUIRE(imported.lods[0].indexCount == source.indices.size());
+    REQUIRE(imported.quantized.vertices.size() == imported.mesh.vertices.size());
+    REQUIRE(imported.mesh.vertices.size() <= source.vertices.size());
+
+    uint32_t expectedMeshlet = 0;
+    for (size_t level = 0; level < imported.lods.size(); ++level) {
+        const IO::MeshLod& lod = imported.lods[level];
+        REQUIRE(lod.firstMeshlet == expectedMeshlet);
+        REQUIRE(lod.meshletCount > 0);
+        expectedMeshlet += lod.meshletCount;
+        if (level > 0) {
+            REQUIRE(lod.indexCount < imported.lods[level - 1].indexCount);
+            REQUIRE(lod.error >= imported.lods[level - 1].error);
+        }
+
+        uint32_t meshletTriangles = 0;
+        for (uint32_t m = 0; m < lod.meshletCount; ++m)
+            meshletTriangles += imported.meshlets.meshlets[lod.firstMeshlet + m].triangleCount;
+        REQUIRE(meshletTriangles * 3 == lod.indexCount);
+    }
+    REQUIRE(expectedMeshlet == imported.meshlets.meshlets.size());
+    for (uint32_t index : imported.mesh.indices)
+        REQUIRE(index < imported.mesh.vertices.size());
+}
+
+TEST_CASE("Cooked meshes load with one read and a pointer fixup", "[assets]") {
+    const IO::ImportedMesh imported = IO::AssetLoader::ImportMesh(MakeSphere(16, 32));
+    std::vector<uint8_t> blob = IO::CookMesh(imported);
+    const std::string path = (std::filesystem::temp_directory_path() / "engine_cooked_sphere.mesh").string();
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+
+    const std::shared_ptr<IO::CookedMesh> mesh = IO::LoadCookedMesh(path);
+    REQUIRE(mesh);
+    auto same = [](const auto& cooked, const auto& source) {
+        return cooked.size() == source.size() &&
+               (source.empty() || std::memcmp(cooked.data(), source.data(), source.size() * sizeof(source[0])) == 0);
+    };
+    CHECK(same(mesh->vertices, imported.mesh.vertices));
+    CHECK(same(mesh->indices, imported.mesh.indices));
+    CHECK(same(mesh->quantizedVertices, imported.quantized.vertices));
+    CHECK(same(mesh->lods, imported.lods));
+    CHECK(same(mesh->meshlets, imported.meshlets.meshlets));
+    CHECK(same(mesh->meshletVertices, imported.meshlets.vertices));
+    CHECK(same(mesh->meshletTriangles, imported.meshlets.triangles));
+    CHECK(mesh->positionScale.x == imported.quantized.positionScale.x);
+    // Pointers land inside the one blob, aligned
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(mesh.get());
+    CHECK(reinterpret_cast<const uint8_t*>(mesh->meshletTriangles.end()) <= base + mesh->header.size);
+    CHECK(reinterpret_cast<uintptr_t>(mesh->vertices.data()) % IO::kCookedAlignment == 0);
+
+    SECTION("Other versions and malformed blobs are rejected untouched") {
+        alignas(IO::kCookedAlignment) static uint8_t aligned[1 << 20];
+        REQUIRE(blob.size() <= sizeof(aligned));
+        auto fixup = [&](const std::vector<uint8_t>& bytes) {
+            std::memcpy(aligned, bytes.data(), bytes.size());
+            return IO::FixupCookedMesh(aligned, bytes.size());
+        };
+        REQUIRE(fixup(blob));
+
+        std::vector<uint8_t> bad = blob;
+        reinterpret_cast<IO::CookedMesh*>(bad.data())->header.version = IO::kCookedMeshVersion + 1;
+        CHECK_FALSE(fixup(bad));
+        CHECK(std::memcmp(aligned, bad.data(), bad.size()) == 0);
+        bad = blob;
+        bad.pop_back();
+        CHECK_FALSE(fixup(bad));
+        bad = blob;
+        reinterpret_cast<IO::CookedMesh*>(bad.data())->indices.count += 1ull << 40;
+        CHECK_FALSE(fixup(bad));
+        bad = blob;
+        reinterpret_cast<IO::CookedMesh*>(bad.data())->lods.value += 4;
+        CHECK_FALSE(fixup(bad));
+        CHECK_FALSE(IO::LoadCookedMesh(path + ".missing"));
+    }
+}
+
+TEST_CASE("Content cooking only re-cooks what changed", "[assets]") {
+    namespace fs = std::filesystem;
+    const fs::path source = fs::temp_directory_path() / "engine_content_source";
+    const fs::path output = fs::temp_directory_path() / "engine_content_cooked";
+    fs::remove_all(source);
+    fs::remove_all(output);
+    fs::create_directories(source / "meshes");
+    fs::create_directories(source / "textures");
+    WriteOBJ(source / "meshes/grid.obj", MakeGrid(12, 1.0f));
+    WriteOBJ(source / "meshes/sphere.obj", MakeSphere(8, 16));
+    WriteText(source / "meshes/cook.settings", "# every mesh in this directory\nlodCount 2\n");
+    WriteText(source / "meshes/sphere.obj.settings", "quantize false\n");
+    WriteText(source / "textures/a.png", std::string(1000, 'a'));
+    WriteText(source / "textures/b.png", std::string(2000, 'b'));
+
+    Threading::JobSystem::Init(4);
+    IO::ContentCooker cooker(source.string(), output.string());
+    const IO::CookReport first = cooker.Cook();
+    CHECK(first.cooked == 4);
+    CHECK(first.upToDate == 0);
+    CHECK(first.failed == 0);
+    CHECK(first.hashedInputs == 6);
+
+    IO::AssetManifest manifest;
+    REQUIRE(manifest.Load(output.string()));
+    CHECK(manifest.GetEntries().size() == 4);
+    CHECK(manifest.Resolve("textures/a.png") == output.string() + "/textures/a.png");
+    CHECK(manifest.Resolve("./meshes/grid.obj") == output.string() + "/meshes/grid.mesh");
+    CHECK(manifest.Resolve("meshes/cook.settings").empty());
+    std::shared_ptr<IO::CookedMesh> grid = IO::LoadCookedMesh(manifest, "meshes/grid.obj");
+    std::shared_ptr<IO::CookedMesh> sphere = IO::LoadCookedMesh(manifest, "meshes/sphere.obj");
+    REQUIRE(grid);
+    REQUIRE(sphere);
+    CHECK(grid->lods.size() == 2);
+    CHECK_FALSE(grid->quantizedVertices.empty());
+    CHECK(sphere->lods.size() == 2);
+    CHECK(sphere->quantizedVertices.empty());
+
+    SECTION("A build with nothing changed reads and cooks nothing") {
+        const IO::CookReport report = cooker.Cook();
+        CHECK(report.cooked == 0);
+        CHECK(report.upToDate == 4);
+        CHECK(report.hashedInputs == 0);
+    }
+    SECTION("Changing one texture re-cooks only it") {
+        WriteText(source / "textures/a.png", std::string(1500, 'c'));
+        const IO::CookReport report = cooker.Cook();
+        CHECK(report.cooked == 1);
+        CHECK(report.upToDate == 3);
+        CHECK(report.hashedInputs == 1);
+        CHECK(fs::file_size(output / "textures/a.png") == 1500);
+    }
+    SECTION("Touching a file without changing it re-hashes it but cooks nothing") {
+        fs::last_write_time(source / "meshes/grid.obj", fs::last_write_time(source / "meshes/grid.obj") + std::chrono::seconds(5));
+        const IO::CookReport report = cooker.Cook();
+        CHECK(report.hashedInputs == 1);
+        CHECK(report.cooked == 0);
+        CHECK(cooker.Cook().hashedInputs == 0);
+    }
+    SECTION("A shared settings file re-cooks every mesh that uses it") {
+        WriteText(source / "meshes/cook.settings", "lodCount 3\nlodReduction 0.5\n");
+        const IO::CookReport report = cooker.Cook();
+        CHECK(report.cooked == 2);
+        CHECK(report.upToDate == 2);
+        REQUIRE(manifest.Load(output.string()));
+        grid = IO::LoadCookedMesh(manifest, "meshes/grid.obj");
+        REQUIRE(grid);
+        CHECK(grid->lods.size() == 3);
+    }
+    SECTION("Deleted sources lose their outputs") {
+        fs::remove(source / "textures/b.png");
+        const IO::CookReport report = cooker.Cook();
+        CHECK(report.removed == 1);
+        CHECK_FALSE(fs::exists(output / "textures/b.png"));
+        REQUIRE(manifest.Load(output.string()));
+        CHECK(manifest.Find("textures/b.png") == nullptr);
+    }
+    SECTION("Deleted outputs are cooked again") {
+        fs::remove(output / "meshes/grid.mesh");
+        CHECK(cooker.Cook().cooked == 1);
+        CHECK(fs::exists(output / "meshes/grid.mesh"));
+    }
+    SECTION("Assets that fail stay out of the manifest and are retried") {
+        WriteText(source / "meshes/sphere.obj.settings", "lodCount none\n");
+        CHECK(cooker.Cook().failed == 1);
+        REQUIRE(manifest.Load(output.string()));
+        CHECK(manifest.Find("meshes/sphere.obj") == nullptr);
+        CHECK(cooker.Cook().failed == 1);
+        WriteText(source / "meshes/sphere.obj.settings", "lodCount 1\n");
+        CHECK(cooker.Cook().cooked == 1);
+    }
+    Threading::JobSystem::Shutdown();
+}
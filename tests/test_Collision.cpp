@@ -0,0 +1,720 @@
+#include <catch2/catch_all.hpp>
+#include "Physics/Collision.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Broadphase tests. Both implementations are driven like a contact manager would
+ * (keep pairs, add the reported ones, drop those whose fat boxes separated) and
+ * the resulting pair set is compared with a brute-force sweep over all proxies.
+ */
+
+namespace {
+
+    using UserPair = std::pair<uint32_t, uint32_t>;
+
+    struct Body {
+        Math::AABB      bounds;
+        Physics::ProxyId proxy = Physics::InvalidProxy;
+    };
+
+    Math::AABB RandomBox(std::mt19937& rng, float worldSize) {
+        std::uniform_real_distribution<float> p(-worldSize, worldSize);
+        std::uniform_real_distribution<float> e(0.2f, 1.5f);
+        return Math::AABB::FromCenterExtents({ p(rng), p(rng) * 0.2f, p(rng) }, { e(rng), e(rng), e(rng) });
+    }
+
+    UserPair MakeUserPair(const Physics::Broadphase& broadphase, Physics::ProxyId a, Physics::ProxyId b) {
+        const uint32_t ua = broadphase.GetUserData(a), ub = broadphase.GetUserData(b);
+        return { std::min(ua, ub), std::max(ua, ub) };
+    }
+
+    void RunScenario(Physics::BroadphaseType type, uint32_t count, float moveRatio, uint32_t seed) {
+        std::unique_ptr<Physics::Broadphase> broadphase = Physics::Broadphase::Create(type);
+        REQUIRE(broadphase->GetType() == type);
+
+        std::mt19937 rng(seed);
+        const float worldSize = 40.0f;
+        std::vector<Body> bodies(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            bodies[i].bounds = RandomBox(rng, worldSize);
+            bodies[i].proxy = broadphase->CreateProxy(bodies[i].bounds, i);
+        }
+
+        // Persistent pairs by proxy, as a contact manager would keep them
+        std::set<Physics::ProxyPair> pairs;
+        std::vector<Physics::ProxyPair> reported;
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float> step(-0.6f, 0.6f);
+
+        for (int frame = 0; frame < 25; ++frame) {
+            if (frame > 0) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    Body& body = bodies[i];
+                    const float roll = unit(rng);
+                    if (roll < 0.01f) {
+                        // Respawn somewhere else: destroy + create
+                        for (auto it = pairs.begin(); it != pairs.end();) {
+                            if (it->a == body.proxy || it->b == body.proxy)
+                                it = pairs.erase(it);
+                            else
+                                ++it;
+                        }
+                        broadphase->DestroyProxy(body.proxy);
+                        body.bounds = RandomBox(rng, worldSize);
+                        body.proxy = broadphase->CreateProxy(body.bounds, i);
+                    } else if (roll < moveRatio) {
+                        const Math::Vec3 d(step(rng), step(rng) * 0.2f, step(rng));
+                        body.bounds = Math::AABB(body.bounds.min + d, body.bounds.max + d);
+                        broadphase->MoveProxy(body.proxy, body.bounds, d);
+                    }
+                }
+            }
+
+            broadphase->UpdatePairs(reported);
+            REQUIRE(std::is_sorted(reported.begin(), reported.end()));
+            REQUIRE(std::adjacent_find(reported.begin(), reported.end()) == reported.end());
+            for (const Physics::ProxyPair& pair : reported) {
+                REQUIRE(pair.a < pair.b);
+                pairs.insert(pair);
+            }
+            for (auto it = pairs.begin(); it != pairs.end();) {
+                if (!broadphase->TestOverlap(it->a, it->b))
+                    it = pairs.erase(it);
+                else
+                    ++it;
+            }
+
+            // Brute force over fat boxes
+            std::set<UserPair> expected, actual;
+            for (uint32_t i = 0; i < count; ++i) {
+                for (uint32_t j = i + 1; j < count; ++j) {
+                    if (broadphase->GetFatAABB(bodies[i].proxy).Overlaps(broadphase->GetFatAABB(bodies[j].proxy)))
+                        expected.insert({ i, j });
+                }
+            }
+            for (const Physics::ProxyPair& pair : pairs)
+                actual.insert(MakeUserPair(*broadphase, pair.a, pair.b));
+            REQUIRE(actual == expected);
+
+            // Fat boxes always contain the real bounds
+            for (const Body& body : bodies)
+                REQUIRE(broadphase->GetFatAABB(body.proxy).Contains(body.bounds));
+        }
+        REQUIRE(broadphase->GetProxyCount() == count);
+    }
+
+} // namespace
+
+TEST_CASE("Broadphase reports every new overlapping pair", "[collision]") {
+    SECTION("Dynamic tree, serial pair search") {
+        RunScenario(Physics::BroadphaseType::DynamicTree, 600, 0.3f, 1);
+    }
+    SECTION("Dynamic tree, parallel pair search") {
+        // Enough moved proxies for UpdatePairs() to split into jobs
+        Threading::JobSystem::Init(4);
+        RunScenario(Physics::BroadphaseType::DynamicTree, 2500, 0.9f, 2);
+        Threading::JobSystem::Shutdown();
+    }
+    SECTION("Sweep and prune, mostly static") {
+        RunScenario(Physics::BroadphaseType::SweepAndPrune, 600, 0.05f, 3);
+    }
+    SECTION("Sweep and prune, heavy motion") {
+        RunScenario(Physics::BroadphaseType::SweepAndPrune, 1500, 0.9f, 4);
+    }
+}
+
+TEST_CASE("Dynamic tree stays balanced", "[collision]") {
+    Physics::DynamicAABBTree tree;
+
+    // Boxes along a line are the worst case for insertion without rotations
+    std::vector<Physics::ProxyId> proxies;
+    for (uint32_t i = 0; i < 4096; ++i)
+        proxies.push_back(tree.CreateProxy(Math::AABB::FromCenterExtents({ float(i) * 2.0f, 0.0f, 0.0f }, Math::Vec3(0.5f)), i));
+    // AVL bound: height < 1.44 * log2(n + 2)
+    REQUIRE(tree.GetHeight() <= 18);
+
+    // Remove every other proxy and move the rest far away
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> p(-500.0f, 500.0f);
+    for (uint32_t i = 0; i < proxies.size(); i += 2)
+        tree.DestroyProxy(proxies[i]);
+    for (uint32_t i = 1; i < proxies.size(); i += 2) {
+        const Math::AABB box = Math::AABB::FromCenterExtents({ p(rng), p(rng), p(rng) }, Math::Vec3(0.5f));
+        REQUIRE(tree.MoveProxy(proxies[i], box, Math::Vec3(0.0f)));
+    }
+    REQUIRE(tree.GetProxyCount() == 2048);
+    REQUIRE(tree.GetHeight() <= 16);
+    REQUIRE(tree.GetAreaRatio() > 1.0f);
+    REQUIRE(tree.GetAreaRatio() < 200.0f);
+
+    std::vector<Physics::ProxyPair> pairs;
+    tree.UpdatePairs(pairs);
+
+    // A small motion inside the fat box does not touch the tree
+    const Math::AABB fat = tree.GetFatAABB(proxies[1]);
+    const Math::Vec3 nudge(0.05f, 0.0f, 0.0f);
+    REQUIRE_FALSE(tree.MoveProxy(proxies[1], Math::AABB(fat.min + Math::Vec3(0.1f) + nudge, fat.max - Math::Vec3(0.1f) + nudge), Math::Vec3(0.0f)));
+}
+
+TEST_CASE("Broadphase box queries match brute force", "[collision]") {
+    for (Physics::BroadphaseType type : { Physics::BroadphaseType::DynamicTree, Physics::BroadphaseType::SweepAndPrune }) {
+        std::unique_ptr<Physics::Broadphase> broadphase = Physics::Broadphase::Create(type);
+        std::mt19937 rng(17);
+        std::vector<Physics::ProxyId> proxies;
+        for (uint32_t i = 0; i < 1000; ++i)
+            proxies.push_back(broadphase->CreateProxy(RandomBox(rng, 50.0f), i));
+        std::vector<Physics::ProxyPair> pairs;
+        broadphase->UpdatePairs(pairs);
+
+        for (int q = 0; q < 50; ++q) {
+            const Math::AABB query = Math::AABB::FromCenterExtents(RandomBox(rng, 50.0f).Center(), Math::Vec3(6.0f));
+            std::vector<Physics::ProxyId> found;
+            broadphase->Query(query, found);
+            std::sort(found.begin(), found.end());
+
+            std::vector<Physics::ProxyId> expected;
+            for (Physics::ProxyId proxy : proxies) {
+                if (broadphase->GetFatAABB(proxy).Overlaps(query))
+                    expected.push_back(proxy);
+            }
+            std::sort(expected.begin(), expected.end());
+            REQUIRE(found == expected);
+        }
+    }
+}
+
+TEST_CASE("Broadphase ray casts match brute force", "[collision]") {
+    // Slab test written out independently of the broadphase
+    auto entry = [](const Physics::BroadphaseRay& ray, const Math::AABB& box, float& outT) {
+        float tNear = 0.0f, tFar = ray.maxDistance;
+        for (int k = 0; k < 3; ++k) {
+            const float lo = box.min[k] - ray.extents[k], hi = box.max[k] + ray.extents[k];
+            if (ray.direction[k] == 0.0f) {
+                if (ray.origin[k] < lo || ray.origin[k] > hi)
+                    return false;
+                continue;
+            }
+            const float t0 = (lo - ray.origin[k]) / ray.direction[k], t1 = (hi - ray.origin[k]) / ray.direction[k];
+            tNear = std::max(tNear, std::min(t0, t1));
+            tFar = std::min(tFar, std::max(t0, t1));
+        }
+        outT = tNear;
+        return tNear <= tFar;
+    };
+
+    for (Physics::BroadphaseType type : { Physics::BroadphaseType::DynamicTree, Physics::BroadphaseType::SweepAndPrune }) {
+        std::unique_ptr<Physics::Broadphase> broadphase = Physics::Broadphase::Create(type);
+        std::mt19937 rng(19);
+        std::vector<Physics::ProxyId> proxies;
+        for (uint32_t i = 0; i < 1000; ++i)
+            proxies.push_back(broadphase->CreateProxy(RandomBox(rng, 50.0f), i));
+
+        // An odd count leaves a partial packet; every fourth ray sweeps a box, some
+        // run along an axis
+        std::vector<Physics::BroadphaseRay> rays(101);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        for (uint32_t i = 0; i < rays.size(); ++i) {
+            Physics::BroadphaseRay& ray = rays[i];
+            ray.origin = RandomBox(rng, 60.0f).Center();
+            ray.direction = (i % 7 == 0) ? Math::Vec3(0.0f, 0.0f, 1.0f) : Math::Normalize(Math::Vec3(unit(rng), unit(rng) * 0.2f, unit(rng)));
+            ray.extents = (i % 4 == 0) ? Math::Vec3(0.5f, 1.0f, 0.25f) : Math::Vec3(0.0f);
+            ray.maxDistance = 80.0f;
+        }
+
+        SECTION(std::string(type == Physics::BroadphaseType::DynamicTree ? "Tree" : "SAP") + ", every box along the ray") {
+            std::vector<std::vector<Physics::ProxyId>> found(rays.size());
+            broadphase->RayCast(rays.data(), static_cast<uint32_t>(rays.size()), [&](uint32_t ray, Physics::ProxyId proxy, float maxDistance) {
+                found[ray].push_back(proxy);
+                return maxDistance;
+            });
+            for (uint32_t i = 0; i < rays.size(); ++i) {
+                std::vector<Physics::ProxyId> expected;
+                float t;
+                for (Physics::ProxyId proxy : proxies) {
+                    if (entry(rays[i], broadphase->GetFatAABB(proxy), t))
+                        expected.push_back(proxy);
+                }
+                std::sort(found[i].begin(), found[i].end());
+                REQUIRE(found[i] == expected);
+            }
+        }
+
+        SECTION(std::string(type == Physics::BroadphaseType::DynamicTree ? "Tree" : "SAP") + ", clipped to the closest box") {
+            std::vector<float> closest(rays.size(), FLT_MAX);
+            broadphase->RayCast(rays.data(), static_cast<uint32_t>(rays.size()), [&](uint32_t ray, Physics::ProxyId proxy, float maxDistance) {
+                float t;
+                REQUIRE(entry(rays[ray], broadphase->GetFatAABB(proxy), t));
+                REQUIRE(t <= maxDistance);
+                closest[ray] = std::min(closest[ray], t);
+                return t;
+            });
+            for (uint32_t i = 0; i < rays.size(); ++i) {
+                float expected = FLT_MAX, t;
+                for (Physics::ProxyId proxy : proxies) {
+                    if (entry(rays[i], broadphase->GetFatAABB(proxy), t))
+                        expected = std::min(expected, t);
+                }
+                REQUIRE(closest[i] == Catch::Approx(expected).margin(1e-4));
+            }
+        }
+    }
+}
+
+/*
+ * Narrowphase: the batched kernels against their scalar references, analytic
+ * contacts for the primitive pairs, GJK/EPA against SAT, and manifold caching.
+ */
+
+namespace {
+
+    Math::Vec3 RandomVec3(std::mt19937& rng, float range) {
+        std::uniform_real_distribution<float> p(-range, range);
+        return { p(rng), p(rng), p(rng) };
+    }
+
+    Math::Quat RandomRotation(std::mt19937& rng) {
+        std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+        return Math::Quat::FromAxisAngle(Math::Normalize(RandomVec3(rng, 1.0f) + Math::Vec3(0.0f, 0.01f, 0.0f)), angle(rng));
+    }
+
+    template <typename Batch>
+    void RequireSameContacts(const Batch& simd, const Batch& scalar) {
+        for (size_t i = 0; i < simd.Size(); ++i) {
+            REQUIRE(simd.depth[i] == Catch::Approx(scalar.depth[i]).margin(1e-4));
+            for (int k = 0; k < 3; ++k) {
+                REQUIRE(simd.normal[k][i] == Catch::Approx(scalar.normal[k][i]).margin(1e-3));
+                REQUIRE(simd.pointA[k][i] == Catch::Approx(scalar.pointA[k][i]).margin(1e-3));
+                REQUIRE(simd.pointB[k][i] == Catch::Approx(scalar.pointB[k][i]).margin(1e-3));
+            }
+        }
+    }
+
+    // Collide() for a single posed pair; fails the test if there is no contact
+    Physics::ContactManifold RequireContact(const Physics::CollisionShape& a, const Math::Vec3& pa, const Math::Quat& qa,
+                                            const Physics::CollisionShape& b, const Math::Vec3& pb, const Math::Quat& qb) {
+        Physics::ContactManifold manifold;
+        REQUIRE(Physics::Collide(a, pa, qa, b, pb, qb, Physics::kContactMargin, manifold));
+        REQUIRE(manifold.pointCount > 0);
+        REQUIRE(Math::Length(manifold.normal) == Catch::Approx(1.0f).margin(1e-4));
+        return manifold;
+    }
+
+    void RequireVec3(const Math::Vec3& actual, const Math::Vec3& expected, float margin = 1e-4f) {
+        REQUIRE(actual.x == Catch::Approx(expected.x).margin(margin));
+        REQUIRE(actual.y == Catch::Approx(expected.y).margin(margin));
+        REQUIRE(actual.z == Catch::Approx(expected.z).margin(margin));
+    }
+
+    const Math::Vec3 kCubeVertices[8] = {
+        { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f },
+        { -0.5f, -0.5f, 0.5f },  { 0.5f, -0.5f, 0.5f },  { -0.5f, 0.5f, 0.5f },  { 0.5f, 0.5f, 0.5f },
+    };
+
+} // namespace
+
+TEST_CASE("Batched contact kernels match the scalar reference", "[collision]") {
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    // Not a whole number of SIMD steps, so the padded tail is covered too
+    const size_t count = 1003;
+
+    SECTION("Spheres and capsules") {
+        Physics::SegmentPairBatch simd;
+        simd.Resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Math::Vec3 ca = RandomVec3(rng, 2.0f), cb = RandomVec3(rng, 2.0f);
+            // Mix of spheres (zero-length cores), capsules and parallel capsules
+            const float kind = unit(rng);
+            const Math::Vec3 axisA = kind < 0.3f ? Math::Vec3(0.0f) : RandomVec3(rng, 1.0f);
+            const Math::Vec3 axisB = kind < 0.5f ? Math::Vec3(0.0f) : (kind < 0.6f ? axisA * 0.5f : RandomVec3(rng, 1.0f));
+            for (int k = 0; k < 3; ++k) {
+                simd.a0[k][i] = ca[k] - axisA[k];
+                simd.a1[k][i] = ca[k] + axisA[k];
+                simd.b0[k][i] = cb[k] - axisB[k];
+                simd.b1[k][i] = cb[k] + axisB[k];
+            }
+            simd.radiusA[i] = 0.1f + unit(rng);
+            simd.radiusB[i] = 0.1f + unit(rng);
+        }
+        Physics::SegmentPairBatch scalar = simd;
+        Physics::CollideSegments(simd, 0, count);
+        Physics::Scalar::CollideSegments(scalar, 0, count);
+
+        for (size_t i = 0; i < count; ++i) {
+            // Parallel cores have many closest pairs; only the distance is unique
+            const Math::Vec3 da(simd.a1[0][i] - simd.a0[0][i], simd.a1[1][i] - simd.a0[1][i], simd.a1[2][i] - simd.a0[2][i]);
+            const Math::Vec3 db(simd.b1[0][i] - simd.b0[0][i], simd.b1[1][i] - simd.b0[1][i], simd.b1[2][i] - simd.b0[2][i]);
+            if (Math::LengthSquared(Math::Cross(da, db)) < 1e-6f && Math::LengthSquared(da) > 0.0f && Math::LengthSquared(db) > 0.0f) {
+                REQUIRE(simd.depth[i] == Catch::Approx(scalar.depth[i]).margin(1e-4));
+                simd.depth[i] = scalar.depth[i];
+                for (int k = 0; k < 3; ++k) {
+                    simd.normal[k][i] = scalar.normal[k][i];
+                    simd.pointA[k][i] = scalar.pointA[k][i];
+                    simd.pointB[k][i] = scalar.pointB[k][i];
+                }
+            }
+        }
+        RequireSameContacts(simd, scalar);
+    }
+
+    SECTION("Spheres against boxes") {
+        Physics::SphereBoxBatch simd;
+        simd.Resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Math::Quat rotation = RandomRotation(rng);
+            const Math::Vec3 axes[3] = { Math::Rotate(rotation, { 1, 0, 0 }), Math::Rotate(rotation, { 0, 1, 0 }), Math::Rotate(rotation, { 0, 0, 1 }) };
+            const Math::Vec3 half(0.2f + unit(rng), 0.2f + unit(rng), 0.2f + unit(rng));
+            // A third of the centers start inside the box
+            const Math::Vec3 center = unit(rng) < 0.33f ? RandomVec3(rng, 0.2f) : RandomVec3(rng, 2.5f);
+            for (int k = 0; k < 3; ++k) {
+                simd.center[k][i] = center[k];
+                simd.boxCenter[k][i] = 0.0f;
+                simd.axisX[k][i] = axes[0][k];
+                simd.axisY[k][i] = axes[1][k];
+                simd.axisZ[k][i] = axes[2][k];
+                simd.halfExtents[k][i] = half[k];
+            }
+            simd.radius[i] = 0.1f + unit(rng);
+        }
+        Physics::SphereBoxBatch scalar = simd;
+        Physics::CollideSphereBoxes(simd, 0, count);
+        Physics::Scalar::CollideSphereBoxes(scalar, 0, count);
+        RequireSameContacts(simd, scalar);
+    }
+}
+
+TEST_CASE("Primitive pairs give analytic contacts", "[collision]") {
+    const Math::Quat identity = Math::Quat::Identity();
+
+    SECTION("Sphere-sphere") {
+        const Physics::ContactManifold m = RequireContact(Physics::CollisionShape::Sphere(1.0f), { 0, 0, 0 }, identity,
+                                                          Physics::CollisionShape::Sphere(0.5f), { 1.2f, 0, 0 }, identity);
+        REQUIRE(m.pointCount == 1);
+        RequireVec3(m.normal, { 1, 0, 0 });
+        REQUIRE(m.points[0].depth == Catch::Approx(0.3f).margin(1e-5));
+        RequireVec3(m.points[0].localA, { 1, 0, 0 });
+        RequireVec3(m.points[0].localB, { -0.5f, 0, 0 });
+    }
+
+    SECTION("Sphere-capsule, in either order") {
+        const Physics::CollisionShape sphere = Physics::CollisionShape::Sphere(0.5f);
+        const Physics::CollisionShape capsule = Physics::CollisionShape::Capsule(0.5f, 1.0f);
+        const Physics::ContactManifold m = RequireContact(sphere, { 0.8f, 0.5f, 0 }, identity, capsule, { 0, 0, 0 }, identity);
+        RequireVec3(m.normal, { -1, 0, 0 });
+        REQUIRE(m.points[0].depth == Catch::Approx(0.2f).margin(1e-5));
+        const Physics::ContactManifold flipped = RequireContact(capsule, { 0, 0, 0 }, identity, sphere, { 0.8f, 0.5f, 0 }, identity);
+        RequireVec3(flipped.normal, { 1, 0, 0 });
+        REQUIRE(flipped.points[0].depth == Catch::Approx(0.2f).margin(1e-5));
+        RequireVec3(flipped.points[0].localA, { 0.5f, 0.5f, 0 });
+    }
+
+    SECTION("Crossed capsules") {
+        const Physics::CollisionShape capsule = Physics::CollisionShape::Capsule(0.25f, 1.0f);
+        const Math::Quat lying = Math::Quat::FromAxisAngle({ 0, 0, 1 }, 1.5707963f);
+        const Physics::ContactManifold m = RequireContact(capsule, { 0, 0, 0 }, identity, capsule, { 0, 0, 0.4f }, lying);
+        RequireVec3(m.normal, { 0, 0, 1 });
+        REQUIRE(m.points[0].depth == Catch::Approx(0.1f).margin(1e-5));
+    }
+
+    SECTION("Sphere-box, outside and inside") {
+        const Physics::CollisionShape box = Physics::CollisionShape::Box({ 1.0f, 0.5f, 2.0f });
+        const Physics::CollisionShape sphere = Physics::CollisionShape::Sphere(0.5f);
+        // Against the rounded corner region
+        const Physics::ContactManifold corner = RequireContact(sphere, { 1.3f, 0.8f, 0 }, identity, box, { 0, 0, 0 }, identity);
+        RequireVec3(corner.normal, Math::Normalize(Math::Vec3(-1, -1, 0)));
+        REQUIRE(corner.points[0].depth == Catch::Approx(0.5f - std::sqrt(0.18f)).margin(1e-5));
+        // Centre inside the box: out through the nearest face (+y)
+        const Physics::ContactManifold inside = RequireContact(box, { 0, 0, 0 }, identity, sphere, { 0.2f, 0.3f, 0 }, identity);
+        RequireVec3(inside.normal, { 0, 1, 0 });
+        REQUIRE(inside.points[0].depth == Catch::Approx(0.7f).margin(1e-5));
+    }
+
+    SECTION("Box resting on a box") {
+        const Physics::CollisionShape ground = Physics::CollisionShape::Box({ 5.0f, 0.5f, 5.0f });
+        const Physics::CollisionShape box = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+        const Math::Quat yaw = Math::Quat::FromAxisAngle({ 0, 1, 0 }, 0.3f);
+        const Physics::ContactManifold m = RequireContact(ground, { 0, 0, 0 }, identity, box, { 0.5f, 0.99f, -1.0f }, yaw);
+        REQUIRE(m.pointCount == 4);
+        RequireVec3(m.normal, { 0, 1, 0 });
+        for (uint32_t i = 0; i < m.pointCount; ++i) {
+            REQUIRE(m.points[i].depth == Catch::Approx(0.01f).margin(1e-4));
+            REQUIRE(std::fabs(m.points[i].localB.x) == Catch::Approx(0.5f).margin(1e-4));
+            REQUIRE(m.points[i].localB.y == Catch::Approx(-0.5f).margin(1e-4));
+        }
+    }
+
+    SECTION("Box edge across a box edge") {
+        const Physics::CollisionShape box = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+        // B stands on one edge along z, A lies with an edge along x on top of it
+        const Math::Quat edgeZ = Math::Quat::FromAxisAngle({ 0, 0, 1 }, 0.7853982f);
+        const Math::Quat edgeX = Math::Quat::FromAxisAngle({ 1, 0, 0 }, 0.7853982f);
+        const float reach = 0.5f * std::sqrt(2.0f);
+        const Physics::ContactManifold m = RequireContact(box, { 0, 2.0f * reach - 0.05f, 0 }, edgeX, box, { 0, 0, 0 }, edgeZ);
+        REQUIRE(m.pointCount == 1);
+        RequireVec3(m.normal, { 0, -1, 0 }, 1e-3f);
+        REQUIRE(m.points[0].depth == Catch::Approx(0.05f).margin(1e-4));
+        RequireVec3(m.points[0].position, { 0, reach - 0.025f, 0 }, 1e-3f);
+    }
+
+    SECTION("Capsule lying on a box (GJK)") {
+        const Physics::CollisionShape box = Physics::CollisionShape::Box({ 2.0f, 0.5f, 2.0f });
+        const Physics::CollisionShape capsule = Physics::CollisionShape::Capsule(0.25f, 1.0f);
+        const Math::Quat lying = Math::Quat::FromAxisAngle({ 0, 0, 1 }, 1.5707963f);
+        const Physics::ContactManifold m = RequireContact(capsule, { 0.3f, 0.74f, 0 }, lying, box, { 0, 0, 0 }, identity);
+        RequireVec3(m.normal, { 0, -1, 0 });
+        REQUIRE(m.points[0].depth == Catch::Approx(0.01f).margin(1e-4));
+        REQUIRE(m.points[0].position.y == Catch::Approx(0.495f).margin(1e-4));
+    }
+}
+
+TEST_CASE("GJK and EPA agree with the box contact on hulls", "[collision]") {
+    const Physics::CollisionShape cubeBox = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+    const Physics::CollisionShape cubeHull = Physics::CollisionShape::ConvexHull(kCubeVertices, 8);
+    const Math::Quat identity = Math::Quat::Identity();
+
+    SECTION("Separated hulls report speculative contacts within the margin only") {
+        Physics::ContactManifold m;
+        REQUIRE(Physics::Collide(cubeHull, { 0, 0, 0 }, identity, cubeHull, { 1.01f, 0.2f, 0 }, identity, 0.02f, m));
+        RequireVec3(m.normal, { 1, 0, 0 });
+        REQUIRE(m.points[0].depth == Catch::Approx(-0.01f).margin(1e-4));
+        REQUIRE_FALSE(Physics::Collide(cubeHull, { 0, 0, 0 }, identity, cubeHull, { 1.01f, 0.2f, 0 }, identity, 0.0f, m));
+        REQUIRE_FALSE(Physics::Collide(cubeHull, { 0, 0, 0 }, identity, cubeHull, { 3.0f, 0, 0 }, identity, 0.02f, m));
+        // A sphere near a hull corner: GJK distance to the rounded core
+        REQUIRE(Physics::Collide(Physics::CollisionShape::Sphere(0.5f), { 0.8f, 0.8f, 0.0f }, identity, cubeHull, { 0, 0, 0 }, identity, 0.02f, m));
+        REQUIRE(m.points[0].depth == Catch::Approx(0.5f - std::sqrt(0.18f)).margin(1e-4));
+        RequireVec3(m.normal, Math::Normalize(Math::Vec3(-1, -1, 0)));
+    }
+
+    SECTION("Penetrating hulls match SAT depth and normal") {
+        std::mt19937 rng(31);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        int compared = 0;
+        for (int i = 0; i < 200; ++i) {
+            const Math::Quat qa = RandomRotation(rng), qb = RandomRotation(rng);
+            const Math::Vec3 pb = Math::Normalize(RandomVec3(rng, 1.0f)) * (0.5f + 0.4f * unit(rng));
+            Physics::ContactManifold sat, epa;
+            const bool hitSat = Physics::Collide(cubeBox, { 0, 0, 0 }, qa, cubeBox, pb, qb, 0.0f, sat);
+            const bool hitEpa = Physics::Collide(cubeHull, { 0, 0, 0 }, qa, cubeHull, pb, qb, 0.0f, epa);
+            if (!hitSat || !hitEpa)
+                continue;
+            // SAT prefers face axes within a small tolerance of the minimum
+            float satDepth = 0.0f;
+            for (uint32_t k = 0; k < sat.pointCount; ++k)
+                satDepth = std::max(satDepth, sat.points[k].depth);
+            REQUIRE(epa.points[0].depth <= satDepth + 1e-3f);
+            REQUIRE(epa.points[0].depth >= satDepth * 0.97f - 2e-3f);
+            // The EPA contact separates the cubes when pushed apart by its depth
+            Physics::ContactManifold after;
+            const Math::Vec3 separated = pb + epa.normal * (epa.points[0].depth + 2e-3f);
+            REQUIRE_FALSE(Physics::Collide(cubeHull, { 0, 0, 0 }, qa, cubeHull, separated, qb, 0.0f, after));
+            ++compared;
+        }
+        REQUIRE(compared > 100);
+    }
+}
+
+TEST_CASE("Ray and shape casts stop at the surface", "[collision]") {
+    const Math::Quat identity = Math::Quat::Identity();
+    const Physics::CollisionShape sphere = Physics::CollisionShape::Sphere(1.0f);
+    const Physics::CollisionShape capsule = Physics::CollisionShape::Capsule(0.4f, 0.6f);
+    const Physics::CollisionShape cubeBox = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+    const Physics::CollisionShape cubeHull = Physics::CollisionShape::ConvexHull(kCubeVertices, 8);
+    const Physics::CollisionShape point = Physics::CollisionShape::Sphere(0.0f);
+    Physics::CastHit hit;
+
+    SECTION("Rays against primitives") {
+        REQUIRE(Physics::RayCast(sphere, { 0, 0, 0 }, identity, { -5, 0, 0 }, { 1, 0, 0 }, 10.0f, hit));
+        REQUIRE(hit.distance == Catch::Approx(4.0f).margin(1e-5));
+        RequireVec3(hit.position, { -1, 0, 0 });
+        RequireVec3(hit.normal, { -1, 0, 0 });
+        REQUIRE_FALSE(Physics::RayCast(sphere, { 0, 0, 0 }, identity, { -5, 0, 0 }, { 1, 0, 0 }, 3.9f, hit));
+        REQUIRE_FALSE(Physics::RayCast(sphere, { 0, 0, 0 }, identity, { -5, 1.1f, 0 }, { 1, 0, 0 }, 10.0f, hit));
+        REQUIRE_FALSE(Physics::RayCast(sphere, { 0, 0, 0 }, identity, { -5, 0, 0 }, { -1, 0, 0 }, 10.0f, hit));
+
+        // Starting inside reports distance 0, against the direction
+        REQUIRE(Physics::RayCast(cubeBox, { 0, 0, 0 }, identity, { 0.2f, 0, 0 }, { 0, 1, 0 }, 10.0f, hit));
+        REQUIRE(hit.distance == 0.0f);
+        RequireVec3(hit.normal, { 0, -1, 0 });
+
+        // Capsule side and cap, lying along x
+        const Math::Quat lying = Math::Quat::FromAxisAngle({ 0, 0, 1 }, 1.5707963f);
+        REQUIRE(Physics::RayCast(capsule, { 0, 0, 0 }, lying, { 0.3f, 5, 0 }, { 0, -1, 0 }, 10.0f, hit));
+        REQUIRE(hit.distance == Catch::Approx(4.6f).margin(1e-4));
+        RequireVec3(hit.normal, { 0, 1, 0 });
+        REQUIRE(Physics::RayCast(capsule, { 0, 0, 0 }, lying, { 5, 0, 0 }, { -1, 0, 0 }, 10.0f, hit));
+        REQUIRE(hit.distance == Catch::Approx(4.0f).margin(1e-4));
+        RequireVec3(hit.normal, { 1, 0, 0 });
+
+        // Rotated box: the face normal comes back in world space
+        const Math::Quat turned = Math::Quat::FromAxisAngle({ 0, 1, 0 }, 0.5f);
+        REQUIRE(Physics::RayCast(cubeBox, { 0, 0, 0 }, turned, { 0, 5, 0 }, { 0, -1, 0 }, 10.0f, hit));
+        REQUIRE(hit.distance == Catch::Approx(4.5f).margin(1e-4));
+        RequireVec3(hit.normal, { 0, 1, 0 });
+    }
+
+    SECTION("Analytic rays agree with casting a point through GJK") {
+        std::mt19937 rng(37);
+        for (int i = 0; i < 500; ++i) {
+            const bool useCapsule = (i % 2) == 0;
+            const Math::Quat rotation = RandomRotation(rng);
+            const Math::Vec3 origin = Math::Normalize(RandomVec3(rng, 1.0f)) * 4.0f;
+            // Aimed inside the core so neither test grazes an edge
+            const Math::Vec3 direction = Math::Normalize(RandomVec3(rng, 0.2f) - origin);
+            const Physics::CollisionShape& shape = useCapsule ? capsule : cubeBox;
+            Physics::CastHit analytic, cast;
+            REQUIRE(Physics::RayCast(shape, { 0, 0, 0 }, rotation, origin, direction, 10.0f, analytic));
+            REQUIRE(Physics::ShapeCast(point, origin, identity, direction, 10.0f, shape, { 0, 0, 0 }, rotation, cast));
+            REQUIRE(cast.distance <= analytic.distance + 1e-4f);
+            REQUIRE(cast.distance == Catch::Approx(analytic.distance).margin(2e-3));
+            RequireVec3(cast.position, analytic.position, 2e-3f);
+        }
+    }
+
+    SECTION("Hull rays match box rays") {
+        std::mt19937 rng(41);
+        for (int i = 0; i < 200; ++i) {
+            const Math::Quat rotation = RandomRotation(rng);
+            const Math::Vec3 origin = Math::Normalize(RandomVec3(rng, 1.0f)) * 4.0f;
+            const Math::Vec3 direction = Math::Normalize(RandomVec3(rng, 0.3f) - origin);
+            Physics::CastHit box, hull;
+            REQUIRE(Physics::RayCast(cubeBox, { 1, 2, 3 }, rotation, origin + Math::Vec3(1, 2, 3), direction, 10.0f, box));
+            REQUIRE(Physics::RayCast(cubeHull, { 1, 2, 3 }, rotation, origin + Math::Vec3(1, 2, 3), direction, 10.0f, hull));
+            REQUIRE(hull.distance == Catch::Approx(box.distance).margin(2e-3));
+        }
+    }
+
+    SECTION("Shape casts") {
+        const Physics::CollisionShape ball = Physics::CollisionShape::Sphere(0.5f);
+        REQUIRE(Physics::ShapeCast(ball, { -5, 0, 0 }, identity, { 1, 0, 0 }, 10.0f, cubeBox, { 0, 0, 0 }, identity, hit));
+        REQUIRE(hit.distance <= 4.0f);
+        REQUIRE(hit.distance >= 4.0f - Physics::kCastTolerance);
+        RequireVec3(hit.position, { -0.5f, 0, 0 }, 1e-3f);
+        RequireVec3(hit.normal, { -1, 0, 0 }, 1e-3f);
+
+        // Passing by, too short, moving away
+        REQUIRE_FALSE(Physics::ShapeCast(ball, { -5, 1.1f, 0 }, identity, { 1, 0, 0 }, 10.0f, cubeBox, { 0, 0, 0 }, identity, hit));
+        REQUIRE_FALSE(Physics::ShapeCast(ball, { -5, 0, 0 }, identity, { 1, 0, 0 }, 3.5f, cubeBox, { 0, 0, 0 }, identity, hit));
+        REQUIRE_FALSE(Physics::ShapeCast(ball, { -5, 0, 0 }, identity, { -1, 0, 0 }, 10.0f, cubeBox, { 0, 0, 0 }, identity, hit));
+
+        // A tilted box dropped on a box lands on its lowest corner
+        const Math::Quat tilted = Math::Quat::FromAxisAngle({ 0, 0, 1 }, 0.7853982f);
+        REQUIRE(Physics::ShapeCast(cubeBox, { 0, 3, 0 }, tilted, { 0, -1, 0 }, 10.0f, cubeBox, { 0, 0, 0 }, identity, hit));
+        REQUIRE(hit.distance == Catch::Approx(2.5f - std::sqrt(0.5f)).margin(2e-3));
+        RequireVec3(hit.normal, { 0, 1, 0 }, 1e-2f);
+
+        // Overlapping at the start
+        REQUIRE(Physics::ShapeCast(capsule, { 0.3f, 0, 0 }, identity, { 1, 0, 0 }, 10.0f, cubeHull, { 0, 0, 0 }, identity, hit));
+        REQUIRE(hit.distance == 0.0f);
+        RequireVec3(hit.normal, { -1, 0, 0 });
+    }
+}
+
+TEST_CASE("Narrowphase caches manifolds for warm starting", "[collision]") {
+    const Math::Quat identity = Math::Quat::Identity();
+    Physics::NarrowPhase narrowPhase;
+
+    SECTION("Impulses follow their contact points") {
+        const Physics::CollisionShape shapes[2] = { Physics::CollisionShape::Box({ 5.0f, 0.5f, 5.0f }), Physics::CollisionShape::Box(Math::Vec3(0.5f)) };
+        Math::Vec3 positions[2] = { { 0, 0, 0 }, { 0, 0.99f, 0 } };
+        const Math::Quat rotations[2] = { identity, identity };
+        const Physics::BodyPair pair = { 1, 0 };
+
+        narrowPhase.Collide(shapes, positions, rotations, &pair, 1);
+        REQUIRE(narrowPhase.GetManifolds().size() == 1);
+        Physics::ContactManifold& first = narrowPhase.GetManifolds()[0];
+        REQUIRE(first.bodyA == 0);
+        REQUIRE(first.bodyB == 1);
+        REQUIRE(first.pointCount == 4);
+        for (uint32_t i = 0; i < 4; ++i)
+            first.points[i].normalImpulse = first.points[i].localB.x + 2.0f * first.points[i].localB.z + 10.0f;
+
+        positions[1] = { 0.002f, 0.985f, 0.001f };
+        narrowPhase.Collide(shapes, positions, rotations, &pair, 1);
+        const Physics::ContactManifold& second = narrowPhase.GetManifolds()[0];
+        REQUIRE(second.pointCount == 4);
+        for (uint32_t i = 0; i < 4; ++i) {
+            const Physics::ContactPoint& p = second.points[i];
+            REQUIRE(p.normalImpulse == Catch::Approx(p.localB.x + 2.0f * p.localB.z + 10.0f).margin(1e-4));
+        }
+
+        // Pairs that stop touching drop their manifold
+        positions[1] = { 0, 3.0f, 0 };
+        narrowPhase.Collide(shapes, positions, rotations, &pair, 1);
+        REQUIRE(narrowPhase.GetManifolds().empty());
+    }
+
+    SECTION("Single-point contacts build up a manifold") {
+        const Physics::CollisionShape shapes[2] = { Physics::CollisionShape::Capsule(0.25f, 1.0f), Physics::CollisionShape::Box({ 2.0f, 0.5f, 2.0f }) };
+        const Math::Vec3 positions[2] = { { 0, 0.74f, 0 }, { 0, 0, 0 } };
+        const Physics::BodyPair pair = { 0, 1 };
+        // Rocking the capsule a little moves the single GJK point from end to end
+        for (float tilt : { 0.005f, -0.005f }) {
+            const Math::Quat rotations[2] = { Math::Quat::FromAxisAngle({ 0, 0, 1 }, 1.5707963f + tilt), identity };
+            narrowPhase.Collide(shapes, positions, rotations, &pair, 1);
+        }
+        const Physics::ContactManifold& m = narrowPhase.GetManifolds()[0];
+        REQUIRE(m.pointCount == 2);
+        REQUIRE(std::fabs(m.points[0].position.x - m.points[1].position.x) == Catch::Approx(2.0f).margin(0.01));
+    }
+}
+
+TEST_CASE("Narrowphase results do not depend on the thread count", "[collision]") {
+    // A jumble of every shape type in a small volume
+    std::mt19937 rng(41);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const uint32_t count = 3000;
+    std::vector<Physics::CollisionShape> shapes;
+    std::vector<Math::Vec3> positions;
+    std::vector<Math::Quat> rotations;
+    Physics::DynamicAABBTree tree;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float kind = unit(rng);
+        if (kind < 0.3f)
+            shapes.push_back(Physics::CollisionShape::Sphere(0.3f + 0.3f * unit(rng)));
+        else if (kind < 0.55f)
+            shapes.push_back(Physics::CollisionShape::Capsule(0.2f + 0.2f * unit(rng), 0.5f * unit(rng)));
+        else if (kind < 0.9f)
+            shapes.push_back(Physics::CollisionShape::Box({ 0.2f + 0.4f * unit(rng), 0.2f + 0.4f * unit(rng), 0.2f + 0.4f * unit(rng) }));
+        else
+            shapes.push_back(Physics::CollisionShape::ConvexHull(kCubeVertices, 8));
+        positions.push_back(RandomVec3(rng, 12.0f));
+        rotations.push_back(RandomRotation(rng));
+        tree.CreateProxy(shapes.back().ComputeAABB(positions.back(), rotations.back()), i);
+    }
+    std::vector<Physics::ProxyPair> proxyPairs;
+    tree.UpdatePairs(proxyPairs);
+    std::vector<Physics::BodyPair> pairs;
+    for (const Physics::ProxyPair& pair : proxyPairs)
+        pairs.push_back({ tree.GetUserData(pair.a), tree.GetUserData(pair.b) });
+    REQUIRE(pairs.size() > 1000);
+
+    auto run = [&](Physics::NarrowPhase& narrowPhase) {
+        for (int frame = 0; frame < 2; ++frame)
+            narrowPhase.Collide(shapes.data(), positions.data(), rotations.data(), pairs.data(), static_cast<uint32_t>(pairs.size()));
+    };
+    Physics::NarrowPhase serial, parallel;
+    run(serial);
+    Threading::JobSystem::Init(4);
+    run(parallel);
+    Threading::JobSystem::Shutdown();
+
+    const std::vector<Physics::ContactManifold>& a = serial.GetManifolds();
+    const std::vector<Physics::ContactManifold>& b = parallel.GetManifolds();
+    REQUIRE(a.size() == b.size());
+    REQUIRE(!a.empty());
+    REQUIRE(std::memcmp(a.data(), b.data(), a.size() * sizeof(Physics::ContactManifold)) == 0);
+    for (const Physics::ContactManifold& m : a) {
+        REQUIRE(m.bodyA < m.bodyB);
+        REQUIRE(m.pointCount <= Physics::kMaxManifoldPoints);
+    }
+}
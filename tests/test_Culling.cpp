@@ -0,0 +1,151 @@
+#include <catch2/catch_all.hpp>
+#include "Memory/LinearAllocator.h"
+#include "Renderer/Culling.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/*
+ * Tests for the culling BVH. Every result is checked against a brute-force
+ * Frustum::Test() over all live proxies.
+ */
+
+namespace {
+
+    Math::Frustum MakeFrustum(const Math::Vec3& eye, const Math::Vec3& target) {
+        Math::Mat4 viewProj = Math::Mat4::Perspective(1.2f, 16.0f / 9.0f, 0.1f, 150.0f)
+                            * Math::Mat4::LookAt(eye, target, { 0.0f, 1.0f, 0.0f });
+        return Math::Frustum::FromMatrix(viewProj);
+    }
+
+    Math::AABB RandomBox(std::mt19937& rng) {
+        std::uniform_real_distribution<float> p(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> e(0.1f, 3.0f);
+        return Math::AABB::FromCenterExtents({ p(rng), p(rng) * 0.25f, p(rng) }, { e(rng), e(rng), e(rng) });
+    }
+
+    std::vector<uint32_t> BruteForce(const Renderer::CullingBVH& bvh, const std::vector<Renderer::CullProxy>& proxies,
+                                     const Math::Frustum& frustum) {
+        std::vector<uint32_t> visible;
+        for (uint32_t i = 0; i < proxies.size(); ++i) {
+            if (bvh.IsValid(proxies[i]) && frustum.Test(bvh.GetBounds(proxies[i])) != Math::Containment::Outside)
+                visible.push_back(i);
+        }
+        return visible;
+    }
+
+    std::vector<uint32_t> Sorted(const Renderer::VisibleList& list) {
+        std::vector<uint32_t> items(list.items, list.items + list.count);
+        std::sort(items.begin(), items.end());
+        return items;
+    }
+
+} // namespace
+
+TEST_CASE("CullingBVH matches brute force", "[renderer][culling]") {
+    std::mt19937 rng(3);
+    Renderer::CullingBVH bvh;
+    std::vector<Renderer::CullProxy> proxies;
+
+    // User data is the index into proxies
+    const uint32_t count = 20000;
+    for (uint32_t i = 0; i < count; ++i)
+        proxies.push_back(bvh.Insert(RandomBox(rng), i));
+    bvh.Update();
+    REQUIRE(bvh.GetCount() == count);
+    REQUIRE(bvh.GetRebuildCount() == 1);
+
+    LinearAllocator scratch(count * sizeof(uint32_t) * 4);
+    Math::Frustum frustum = MakeFrustum({ 0.0f, 10.0f, 0.0f }, { 50.0f, 0.0f, 30.0f });
+
+    SECTION("Static scene") {
+        std::vector<uint32_t> expected = BruteForce(bvh, proxies, frustum);
+        REQUIRE_FALSE(expected.empty());
+        REQUIRE(expected.size() < count);
+        REQUIRE(Sorted(bvh.Cull(frustum, scratch)) == expected);
+    }
+
+    SECTION("Moves are refitted without a rebuild") {
+        std::uniform_real_distribution<float> nudge(-0.5f, 0.5f);
+        for (uint32_t i = 0; i < count; i += 17) {
+            Math::AABB b = bvh.GetBounds(proxies[i]);
+            Math::Vec3 offset(nudge(rng), nudge(rng), nudge(rng));
+            bvh.Move(proxies[i], { b.min + offset, b.max + offset });
+        }
+        bvh.Update();
+        REQUIRE(bvh.GetRebuildCount() == 1);
+        REQUIRE(Sorted(bvh.Cull(frustum, scratch)) == BruteForce(bvh, proxies, frustum));
+
+        // Teleporting objects across the world degrades the tree enough to rebuild it
+        for (uint32_t i = 0; i < count; i += 2)
+            bvh.Move(proxies[i], RandomBox(rng));
+        bvh.Update();
+        REQUIRE(bvh.GetRebuildCount() == 2);
+        REQUIRE(Sorted(bvh.Cull(frustum, scratch)) == BruteForce(bvh, proxies, frustum));
+    }
+
+    SECTION("Remove and insert") {
+        // Removed proxies are recycled by the inserts, so forget their handles
+        for (uint32_t i = 0; i < count; i += 3) {
+            bvh.Remove(proxies[i]);
+            proxies[i] = Renderer::InvalidCullProxy;
+        }
+        for (uint32_t i = 0; i < 100; ++i)
+            proxies.push_back(bvh.Insert(RandomBox(rng), static_cast<uint32_t>(proxies.size())));
+        bvh.Update();
+        REQUIRE(bvh.GetCount() == count - (count + 2) / 3 + 100);
+        REQUIRE(Sorted(bvh.Cull(frustum, scratch)) == BruteForce(bvh, proxies, frustum));
+    }
+}
+
+TEST_CASE("CullingBVH parallel traversal matches serial", "[renderer][culling]") {
+    std::mt19937 rng(5);
+    Renderer::CullingBVH bvh;
+    const uint32_t count = 50000;
+    for (uint32_t i = 0; i < count; ++i)
+        bvh.Insert(RandomBox(rng), i);
+    bvh.Update();
+
+    Math::Frustum frustum = MakeFrustum({ -150.0f, 20.0f, -150.0f }, { 0.0f, 0.0f, 0.0f });
+    LinearAllocator scratch(count * sizeof(uint32_t) * 2);
+
+    // Without workers everything runs on this thread
+    Threading::JobSystem::Shutdown();
+    Renderer::VisibleList serial = bvh.Cull(frustum, scratch);
+    std::vector<uint32_t> expected(serial.items, serial.items + serial.count);
+    REQUIRE_FALSE(expected.empty());
+
+    Threading::JobSystem::Init(4);
+    for (int frame = 0; frame < 3; ++frame) {
+        scratch.Reset();
+        Renderer::VisibleList parallel = bvh.Cull(frustum, scratch);
+        // Same items in the same (tree) order
+        REQUIRE(std::vector<uint32_t>(parallel.items, parallel.items + parallel.count) == expected);
+    }
+    REQUIRE(Profiling::GetCounter("Culling.Visible") == Catch::Approx(static_cast<double>(expected.size())));
+    Threading::JobSystem::Shutdown();
+}
+
+TEST_CASE("CullingBVH handles empty and tiny trees", "[renderer][culling]") {
+    Renderer::CullingBVH bvh;
+    LinearAllocator scratch(1024);
+    Math::Frustum frustum = MakeFrustum({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f });
+
+    bvh.Update();
+    REQUIRE(bvh.Cull(frustum, scratch).count == 0);
+
+    Renderer::CullProxy inside = bvh.Insert(Math::AABB::FromCenterExtents({ 0.0f, 0.0f, -10.0f }, Math::Vec3(1.0f)), 42);
+    bvh.Insert(Math::AABB::FromCenterExtents({ 0.0f, 0.0f, 10.0f }, Math::Vec3(1.0f)), 7);
+    bvh.Update();
+
+    Renderer::VisibleList visible = bvh.Cull(frustum, scratch);
+    REQUIRE(visible.count == 1);
+    REQUIRE(visible.items[0] == 42);
+
+    bvh.Remove(inside);
+    bvh.Update();
+    REQUIRE(bvh.Cull(frustum, scratch).count == 0);
+}
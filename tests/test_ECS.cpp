@@ -0,0 +1,132 @@
+#include <catch2/catch_all.hpp>
+#include "ECS/SystemScheduler.h"
+#include "ECS/World.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <atomic>
+
+namespace {
+    struct Position { float x = 0.0f; };
+    struct Velocity { float x = 0.0f; };
+    struct Health   { int value = 100; };
+}
+
+TEST_CASE("World entities and components", "[ecs]") {
+    ECS::World world;
+
+    ECS::Entity a = world.CreateEntity();
+    ECS::Entity b = world.CreateEntity();
+    world.AddComponent<Position>(a, { 1.0f });
+    world.AddComponent<Position>(b, { 2.0f });
+    world.AddComponent<Velocity>(b, { 3.0f });
+
+    REQUIRE(world.GetEntityCount() == 2);
+    REQUIRE(world.HasComponent<Position>(a));
+    REQUIRE_FALSE(world.HasComponent<Velocity>(a));
+    REQUIRE(world.GetComponent<Velocity>(b).x == 3.0f);
+
+    SECTION("Destroying an entity removes its components and keeps pools packed") {
+        world.DestroyEntity(a);
+        REQUIRE_FALSE(world.IsAlive(a));
+        REQUIRE(world.GetPool<Position>().Size() == 1);
+        REQUIRE(world.GetComponent<Position>(b).x == 2.0f);
+
+        // The id is recycled
+        REQUIRE(world.CreateEntity() == a);
+    }
+}
+
+TEST_CASE("SystemScheduler builds conflict-free stages", "[ecs]") {
+    ECS::SystemScheduler scheduler;
+    auto noop = [](const ECS::SystemContext&) {};
+
+    auto integrate = scheduler.AddSystem("Integrate", ECS::SystemAccess().Read<Velocity>().Write<Position>(), noop);
+    auto regen     = scheduler.AddSystem("Regen", ECS::SystemAccess().Write<Health>(), noop);
+    auto render    = scheduler.AddSystem("Render", ECS::SystemAccess().Read<Position>(), noop);
+    auto damp      = scheduler.AddSystem("Damp", ECS::SystemAccess().Write<Velocity>(), noop);
+    auto readVel   = scheduler.AddSystem("ReadVel", ECS::SystemAccess().Read<Velocity>(), noop);
+    scheduler.Build();
+
+    const auto& stages = scheduler.GetStages();
+    REQUIRE(stages.size() == 3);
+    // Integrate, Regen and Render only conflict with later systems or not at all
+    REQUIRE(stages[0] == std::vector<ECS::SystemScheduler::SystemId>{ integrate, regen });
+    // Render reads what Integrate writes; Damp writes what Integrate reads
+    REQUIRE(stages[1] == std::vector<ECS::SystemScheduler::SystemId>{ render, damp });
+    REQUIRE(stages[2] == std::vector<ECS::SystemScheduler::SystemId>{ readVel });
+
+    const auto& conflicts = scheduler.GetConflicts();
+    REQUIRE(conflicts.size() == 3);
+    REQUIRE(conflicts[0] == std::make_pair(integrate, render));
+    REQUIRE(conflicts[1] == std::make_pair(integrate, damp));
+    REQUIRE(conflicts[2] == std::make_pair(damp, readVel));
+}
+
+TEST_CASE("SystemScheduler runs chunked systems in parallel", "[ecs]") {
+    Threading::JobSystem::Init(4);
+
+    ECS::World world;
+    for (int i = 0; i < 10000; ++i) {
+        ECS::Entity e = world.CreateEntity();
+        world.AddComponent<Position>(e, { 0.0f });
+        world.AddComponent<Velocity>(e, { 1.0f });
+    }
+
+    ECS::SystemScheduler scheduler;
+    auto integrate = scheduler.AddChunkedSystem("Integrate",
+        ECS::SystemAccess().Read<Velocity>().Write<Position>(),
+        [](ECS::World& w) { return w.GetPool<Position>().Size(); }, 256,
+        [](const ECS::SystemContext& ctx) {
+            auto& positions = ctx.world.GetPool<Position>();
+            auto& velocities = ctx.world.GetPool<Velocity>();
+            for (uint32_t i = ctx.begin; i < ctx.end; ++i) {
+                ECS::Entity e = positions.EntityAt(i);
+                positions.At(i).x += velocities.Get(e).x * ctx.deltaTime;
+            }
+        });
+
+    std::atomic<float> sum{ 0.0f };
+    auto sumSystem = scheduler.AddSystem("Sum", ECS::SystemAccess().Read<Position>(),
+        [&](const ECS::SystemContext& ctx) {
+            float total = 0.0f;
+            auto& positions = ctx.world.GetPool<Position>();
+            for (uint32_t i = 0; i < positions.Size(); ++i)
+                total += positions.At(i).x;
+            sum = total;
+        });
+
+    Profiling::StartFrame();
+    scheduler.Run(world, 0.5f);
+
+    REQUIRE(sum == Catch::Approx(5000.0f));
+
+    // The profiler sees one event per chunk plus the reader, and the critical path
+    REQUIRE(scheduler.GetCriticalPath() == std::vector<ECS::SystemScheduler::SystemId>{ integrate, sumSystem });
+    REQUIRE(scheduler.GetCriticalPathMs() >= scheduler.GetSystemTimeMs(integrate));
+    REQUIRE(Profiling::GetCounter("ECS.CriticalPathMs") == scheduler.GetCriticalPathMs());
+
+    size_t integrateEvents = 0;
+    for (const auto& event : Profiling::GetFrameEvents()) {
+        if (event.name == "ECS::Integrate")
+            integrateEvents++;
+    }
+    REQUIRE(integrateEvents == (10000 + 255) / 256);
+
+    Threading::JobSystem::Shutdown();
+}
+
+TEST_CASE("Frame events stay bounded when no frame is started", "[ecs][profiling]") {
+    Profiling::StartFrame();
+    for (size_t i = 0; i < Profiling::kMaxFrameEvents + 100; ++i) {
+        ProfileScope scope("Unframed");
+    }
+    CHECK(Profiling::GetFrameEvents().size() == Profiling::kMaxFrameEvents);
+    CHECK(Profiling::GetDroppedEvents() == 100);
+    CHECK(Profiling::GetCounter("Profiling.DroppedEvents") == 100.0);
+
+    Profiling::StartFrame();
+    CHECK(Profiling::GetFrameEvents().empty());
+    CHECK(Profiling::GetDroppedEvents() == 0);
+    CHECK(Profiling::GetCounter("Profiling.DroppedEvents") == 0.0);
+}
@@ -0,0 +1,395 @@
+#include <catch2/catch_all.hpp>
+#include "IO/FileSystem.h"
+#include "Threading/JobSystem.h"
+#include "Utils/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Every test runs on both backends: the thread pool, and io_uring where the
+ * kernel allows it (Auto falls back to the thread pool otherwise).
+ */
+
+namespace {
+
+    std::string WriteTempFile(const std::string& name, const std::vector<uint8_t>& bytes) {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / ("engine_fs_" + name);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return path.string();
+    }
+
+    std::vector<uint8_t> Pattern(size_t size, uint32_t seed) {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i)
+            bytes[i] = static_cast<uint8_t>((i * 2654435761u + seed) >> 13);
+        return bytes;
+    }
+
+    // Text with the repetition of a real OBJ file
+    std::vector<uint8_t> MeshText(size_t size) {
+        std::string text;
+        for (uint32_t i = 0; text.size() < size; ++i)
+            text += "v " + std::to_string(i % 97) + ".5 " + std::to_string(i % 13) + ".25 -1.0\nf " + std::to_string(i) + " " +
+                    std::to_string(i + 1) + " " + std::to_string(i + 2) + "\n";
+        return std::vector<uint8_t>(text.begin(), text.begin() + size);
+    }
+
+    std::vector<uint8_t> Noise(size_t size, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t& byte : bytes)
+            byte = static_cast<uint8_t>(rng());
+        return bytes;
+    }
+
+    IO::FileSystemSettings Settings(IO::IOBackendType backend, uint32_t concurrency = 4) {
+        IO::FileSystemSettings settings;
+        settings.backend = backend;
+        settings.queueDepth = concurrency;
+        settings.threadCount = concurrency;
+        return settings;
+    }
+
+} // namespace
+
+TEST_CASE("FileSystem reads whole files and ranges", "[io]") {
+    const IO::IOBackendType backend = GENERATE(IO::IOBackendType::ThreadPool, IO::IOBackendType::Auto);
+    IO::FileSystem fs(Settings(backend));
+    INFO("backend " << static_cast<int>(fs.GetBackendType()));
+
+    std::vector<std::vector<uint8_t>> contents;
+    std::vector<std::string> paths;
+    for (uint32_t i = 0; i < 16; ++i) {
+        contents.push_back(Pattern(1000 + i * 37011, i));
+        paths.push_back(WriteTempFile("whole" + std::to_string(i), contents.back()));
+    }
+
+    SECTION("Whole files into allocated buffers, with callbacks") {
+        std::vector<IO::ReadRequest> requests(paths.size());
+        std::atomic<int> callbacks{ 0 };
+        for (size_t i = 0; i < paths.size(); ++i) {
+            requests[i].path = paths[i];
+            requests[i].onComplete = [&](IO::ReadRequest&, IO::IOStatus status) {
+                if (status == IO::IOStatus::Completed)
+                    callbacks++;
+            };
+            REQUIRE(fs.Read(requests[i]));
+        }
+        for (size_t i = 0; i < paths.size(); ++i) {
+            fs.Wait(requests[i]);
+            REQUIRE(requests[i].status == IO::IOStatus::Completed);
+            REQUIRE(requests[i].bytesRead == contents[i].size());
+            CHECK(std::memcmp(requests[i].data, contents[i].data(), contents[i].size()) == 0);
+            IO::FileSystem::FreeBuffer(requests[i].data);
+        }
+        CHECK(callbacks == static_cast<int>(paths.size()));
+        CHECK(fs.GetPendingCount() == 0);
+    }
+
+    SECTION("Ranges into caller buffers, clipped at the end of the file") {
+        const std::vector<uint8_t>& file = contents.back();
+        std::vector<uint8_t> buffer(5000, 0xCD);
+        IO::ReadRequest request;
+        request.path = paths.back();
+        request.offset = 12345;
+        request.size = 4000;
+        request.buffer = buffer.data();
+        REQUIRE(fs.Read(request));
+        fs.Wait(request);
+        REQUIRE(request.status == IO::IOStatus::Completed);
+        CHECK(request.data == buffer.data());
+        CHECK(request.bytesRead == 4000);
+        CHECK(std::memcmp(buffer.data(), file.data() + 12345, 4000) == 0);
+        CHECK(buffer[4000] == 0xCD);
+
+        // The request is reusable once done
+        request.offset = file.size() - 100;
+        REQUIRE(fs.Read(request));
+        fs.Wait(request);
+        CHECK(request.bytesRead == 100);
+        CHECK(std::memcmp(buffer.data(), file.data() + file.size() - 100, 100) == 0);
+
+        request.offset = file.size() + 10;
+        REQUIRE(fs.Read(request));
+        fs.Wait(request);
+        CHECK(request.status == IO::IOStatus::Completed);
+        CHECK(request.bytesRead == 0);
+    }
+
+    SECTION("Missing files fail with errno") {
+        IO::ReadRequest request;
+        request.path = paths[0] + ".missing";
+        REQUIRE(fs.Read(request));
+        fs.Wait(request);
+        CHECK(request.status == IO::IOStatus::Failed);
+        CHECK(request.error == ENOENT);
+        CHECK(request.data == nullptr);
+    }
+}
+
+TEST_CASE("FileSystem starts urgent reads first and cancels queued ones", "[io]") {
+    const IO::IOBackendType backend = GENERATE(IO::IOBackendType::ThreadPool, IO::IOBackendType::Auto);
+    // One read at a time, so the queue order is observable
+    IO::FileSystem fs(Settings(backend, 1));
+    const std::string path = WriteTempFile("priority", Pattern(4096, 7));
+
+    // The first read's callback holds the only backend slot until released
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+    std::vector<std::string> order;
+    std::vector<std::unique_ptr<IO::ReadRequest>> requests;
+    auto record = [&](IO::ReadRequest& request, IO::IOStatus status) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (&request == requests.front().get())
+            released.wait(lock, [&] { return release; });
+        order.push_back(std::to_string(static_cast<int>(request.priority)) + (status == IO::IOStatus::Cancelled ? "x" : ""));
+    };
+
+    auto read = [&](IO::IOPriority priority) {
+        requests.push_back(std::make_unique<IO::ReadRequest>());
+        IO::ReadRequest& request = *requests.back();
+        request.path = path;
+        request.priority = priority;
+        request.onComplete = record;
+        REQUIRE(fs.Read(request));
+        return &request;
+    };
+
+    IO::ReadRequest* blocker = read(IO::IOPriority::Normal);
+    while (blocker->status == IO::IOStatus::Queued) {}
+    read(IO::IOPriority::Low);
+    IO::ReadRequest* cancelled = read(IO::IOPriority::Normal);
+    read(IO::IOPriority::Critical);
+    read(IO::IOPriority::High);
+    read(IO::IOPriority::Normal);
+    CHECK(fs.GetPendingCount() == 6);
+
+    CHECK(fs.Cancel(*cancelled));
+    CHECK(cancelled->status == IO::IOStatus::Cancelled);
+    CHECK_FALSE(fs.Cancel(*blocker));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    released.notify_all();
+    for (auto& request : requests) {
+        fs.Wait(*request);
+        IO::FileSystem::FreeBuffer(request->data);
+    }
+
+    // The cancelled read reported first (on this thread), then the blocker, then by priority
+    const std::vector<std::string> expected = { "1x", "1", "3", "2", "1", "0" };
+    CHECK(order == expected);
+}
+
+TEST_CASE("FileSystem cancels queued reads on destruction", "[io]") {
+    const std::string path = WriteTempFile("shutdown", Pattern(1 << 16, 3));
+    std::vector<IO::ReadRequest> requests(64);
+    std::atomic<int> completed{ 0 }, cancelled{ 0 };
+    {
+        IO::FileSystem fs(Settings(IO::IOBackendType::Auto, 1));
+        for (IO::ReadRequest& request : requests) {
+            request.path = path;
+            request.onComplete = [&](IO::ReadRequest& r, IO::IOStatus status) {
+                (status == IO::IOStatus::Completed ? completed : cancelled)++;
+                IO::FileSystem::FreeBuffer(r.data);
+            };
+            fs.Read(request);
+        }
+    }
+    CHECK(completed + cancelled == 64);
+    for (const IO::ReadRequest& request : requests)
+        CHECK(IO::FileSystem::IsDone(request));
+}
+
+TEST_CASE("Archives map entries by path hash, with loose overrides", "[io]") {
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "engine_fs_content";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "meshes" / "props");
+    std::filesystem::create_directories(root / "textures");
+    const std::vector<std::string> names = { "meshes/rock.obj", "meshes/props/crate.obj", "textures/rock.png", "empty.txt", "readme" };
+    std::vector<std::vector<uint8_t>> contents;
+    for (size_t i = 0; i < names.size(); ++i) {
+        contents.push_back(Pattern(names[i] == "empty.txt" ? 0 : 100 + i * 5003, static_cast<uint32_t>(i)));
+        std::ofstream(root / names[i], std::ios::binary)
+            .write(reinterpret_cast<const char*>(contents.back().data()), static_cast<std::streamsize>(contents.back().size()));
+    }
+
+    const std::vector<std::string> listed = IO::Archive::ListFiles(root.string());
+    REQUIRE(listed.size() == names.size());
+    CHECK(std::is_sorted(listed.begin(), listed.end()));
+
+    const std::string archivePath = (std::filesystem::temp_directory_path() / "engine_fs_content.pak").string();
+    std::string error;
+    IO::PackSettings stored;
+    stored.alignment = 256;
+    stored.chooseCodec = [](std::string_view) { return IO::Codec::None; };
+    REQUIRE(IO::Archive::Build(root.string(), listed, archivePath, stored, error));
+
+    IO::Archive archive;
+    REQUIRE(archive.Open(archivePath));
+    REQUIRE(archive.GetEntryCount() == names.size());
+    for (uint32_t i = 1; i < archive.GetEntryCount(); ++i)
+        CHECK(archive.GetEntries()[i - 1].pathHash < archive.GetEntries()[i].pathHash);
+    for (size_t i = 0; i < names.size(); ++i) {
+        const IO::ArchiveEntry* entry = archive.Find(names[i]);
+        REQUIRE(entry);
+        CHECK(entry == archive.Find(IO::HashPath(names[i])));
+        CHECK(archive.GetPath(*entry) == names[i]);
+        const IO::ArchiveView view = archive.GetData(*entry);
+        CHECK(reinterpret_cast<uintptr_t>(view.data) % 256 == 0);
+        REQUIRE(view.size == contents[i].size());
+        CHECK(std::memcmp(view.data, contents[i].data(), view.size) == 0);
+    }
+    CHECK_FALSE(archive.Find("meshes/missing.obj"));
+
+    SECTION("The FileSystem serves archive views and loose overrides") {
+        IO::FileSystem fs(Settings(IO::IOBackendType::ThreadPool, 1));
+        REQUIRE(fs.Mount(archivePath));
+        IO::FileView view;
+        REQUIRE(fs.OpenView("./meshes\\rock.obj", view));
+        CHECK(reinterpret_cast<uintptr_t>(view.data) % 256 == 0);
+        CHECK_FALSE(view.looseFile);
+        CHECK(std::memcmp(view.data, contents[0].data(), view.size) == 0);
+        REQUIRE(fs.OpenView(IO::HashPath("textures/rock.png"), view));
+        CHECK(view.size == contents[2].size());
+        CHECK_FALSE(fs.OpenView("textures/missing.png", view));
+
+        // In development, an edited loose file wins over the packed one
+        const std::filesystem::path loose = std::filesystem::temp_directory_path() / "engine_fs_loose";
+        std::filesystem::remove_all(loose);
+        std::filesystem::create_directories(loose / "meshes");
+        std::ofstream(loose / "meshes" / "rock.obj", std::ios::binary) << "edited";
+        fs.SetLooseRoot(loose.string());
+        REQUIRE(fs.OpenView("meshes/rock.obj", view));
+        CHECK(view.looseFile);
+        CHECK(std::string(reinterpret_cast<const char*>(view.data), view.size) == "edited");
+        REQUIRE(fs.OpenView("meshes/props/crate.obj", view));
+        CHECK_FALSE(view.looseFile);
+        CHECK(view.size == contents[1].size());
+    }
+
+    SECTION("Malformed archives are rejected") {
+        std::vector<uint8_t> bytes;
+        REQUIRE(IO::FileSystem::ReadFile(archivePath, bytes));
+        const std::string truncated = WriteTempFile("truncated.pak", std::vector<uint8_t>(bytes.begin(), bytes.end() - 1));
+        CHECK_FALSE(archive.Open(truncated));
+        bytes[0] ^= 0xFF;
+        CHECK_FALSE(archive.Open(WriteTempFile("badmagic.pak", bytes)));
+        CHECK_FALSE(archive.Open(archivePath + ".missing"));
+        stored.alignment = 3;
+        CHECK_FALSE(IO::Archive::Build(root.string(), listed, archivePath + ".bad", stored, error));
+    }
+}
+
+TEST_CASE("Block codecs round-trip and reject malformed input", "[io]") {
+    const IO::Codec codec = GENERATE(IO::Codec::None, IO::Codec::LZ4, IO::Codec::LZ4HC);
+    INFO("codec " << static_cast<int>(codec));
+
+    std::vector<std::vector<uint8_t>> inputs = { {}, { 7 }, std::vector<uint8_t>(12, 1), std::vector<uint8_t>(13, 1),
+                                                 std::vector<uint8_t>(70000, 0), MeshText(300000), Noise(100000, 3) };
+    // Long literal runs between long matches exercise the length continuation bytes
+    std::vector<uint8_t> mixed = Noise(1000, 4);
+    mixed.insert(mixed.end(), 5000, 'a');
+    const std::vector<uint8_t> tail = Noise(600, 5);
+    mixed.insert(mixed.end(), tail.begin(), tail.end());
+    mixed.insert(mixed.end(), mixed.begin(), mixed.begin() + 1600);
+    inputs.push_back(mixed);
+
+    for (const std::vector<uint8_t>& input : inputs) {
+        INFO("size " << input.size());
+        const std::vector<uint8_t> stream = IO::CompressBlocks(codec, input.data(), input.size());
+        std::vector<uint8_t> output(input.size() + 1, 0xCD);
+        REQUIRE(IO::DecompressBlocks(codec, stream.data(), stream.size(), output.data(), input.size()));
+        CHECK(std::equal(input.begin(), input.end(), output.begin()));
+        CHECK(output.back() == 0xCD);
+        // Noise does not shrink, so its blocks are stored rather than grown
+        CHECK(stream.size() <= input.size() + sizeof(uint32_t) * (1 + IO::GetBlockCount(input.size())));
+    }
+
+    const std::vector<uint8_t> text = MeshText(IO::kCompressionBlockSize);
+    std::vector<uint8_t> block(IO::CompressBound(text.size()));
+    const size_t size = IO::CompressBlock(codec, text.data(), text.size(), block.data(), block.size());
+    REQUIRE(size > 0);
+    if (codec != IO::Codec::None) {
+        CHECK(size < text.size() * 2 / 3);
+        block.resize(size);
+        std::vector<uint8_t> output(text.size());
+        CHECK_FALSE(IO::DecompressBlock(codec, block.data(), block.size() - 1, output.data(), output.size()));
+        CHECK_FALSE(IO::DecompressBlock(codec, block.data(), block.size(), output.data(), output.size() - 1));
+        // Corrupt offsets must not reach before the output
+        std::vector<uint8_t> corrupt = { 0x04, 'a', 0xFF, 0x00, 0x00 };
+        CHECK_FALSE(IO::DecompressBlock(codec, corrupt.data(), corrupt.size(), output.data(), 9));
+    }
+}
+
+TEST_CASE("Compressed entries stream straight into the destination", "[io]") {
+    const IO::IOBackendType backend = GENERATE(IO::IOBackendType::ThreadPool, IO::IOBackendType::Auto);
+    const bool workers = GENERATE(false, true);
+    if (workers)
+        Threading::JobSystem::Init(4);
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "engine_fs_compressed";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "meshes");
+    std::filesystem::create_directories(root / "textures");
+    const std::vector<std::string> names = { "meshes/level.obj", "textures/stone.dds", "textures/photo.png", "noise.bin", "small.txt" };
+    const std::vector<std::vector<uint8_t>> contents = { MeshText(3000000), MeshText(200000), MeshText(50000), Noise(300000, 9), MeshText(40) };
+    for (size_t i = 0; i < names.size(); ++i)
+        std::ofstream(root / names[i], std::ios::binary)
+            .write(reinterpret_cast<const char*>(contents[i].data()), static_cast<std::streamsize>(contents[i].size()));
+
+    const std::string archivePath = (std::filesystem::temp_directory_path() / "engine_fs_compressed.pak").string();
+    std::string error;
+    REQUIRE(IO::Archive::Build(root.string(), IO::Archive::ListFiles(root.string()), archivePath, IO::PackSettings(), error));
+
+    // The codec follows the asset type; data that does not shrink is stored
+    IO::Archive archive;
+    REQUIRE(archive.Open(archivePath));
+    CHECK(archive.Find("meshes/level.obj")->codec == IO::Codec::LZ4);
+    CHECK(archive.Find("textures/stone.dds")->codec == IO::Codec::LZ4HC);
+    CHECK(archive.Find("textures/photo.png")->codec == IO::Codec::None);
+    CHECK(archive.Find("noise.bin")->codec == IO::Codec::None);
+    CHECK(archive.Find("meshes/level.obj")->size < contents[0].size() * 2 / 3);
+
+    IO::FileSystem fs(Settings(backend, 2));
+    REQUIRE(fs.Mount(archivePath));
+    for (size_t i = 0; i < names.size(); ++i) {
+        INFO(names[i]);
+        uint64_t size = 0;
+        REQUIRE(fs.GetEntrySize(names[i], size));
+        REQUIRE(size == contents[i].size());
+        std::vector<uint8_t> output(size + 1, 0xCD);
+        REQUIRE(fs.ReadEntry(names[i], output.data(), size, IO::IOPriority::High));
+        CHECK(std::equal(contents[i].begin(), contents[i].end(), output.begin()));
+        CHECK(output.back() == 0xCD);
+        CHECK_FALSE(fs.ReadEntry(names[i], output.data(), size - 1));
+    }
+    CHECK(Profiling::GetCounter("IO.EndToEndMBps") > 0.0);
+    CHECK(Profiling::GetCounter("IO.DecompressMBps") > 0.0);
+
+    // Compressed entries have no view; stored ones still do
+    IO::FileView view;
+    CHECK_FALSE(fs.OpenView("meshes/level.obj", view));
+    CHECK(fs.OpenView("textures/photo.png", view));
+    std::vector<uint8_t> extracted(contents[1].size());
+    REQUIRE(archive.Extract(*archive.Find("textures/stone.dds"), extracted.data()));
+    CHECK(extracted == contents[1]);
+    CHECK_FALSE(fs.ReadEntry("meshes/missing.obj", extracted.data(), extracted.size()));
+
+    if (workers)
+        Threading::JobSystem::Shutdown();
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch_all.hpp>
+#include "Threading/JobSystem.h"
+
+#include <atomic>
+#include <vector>
+
+/*
+ * Tests for the JobSystem. Each test initializes the system itself, since other
+ * tests (e.g. Application) may have shut it down.
+ */
+
+TEST_CASE("JobSystem runs inline without workers", "[jobsystem]") {
+    Threading::JobSystem::Shutdown();
+
+    Threading::JobContext ctx;
+    int counter = 0;
+    Threading::JobSystem::Execute(ctx, [&]() { counter++; });
+    // Without workers the job has already run on this thread
+    REQUIRE(counter == 1);
+    REQUIRE_FALSE(Threading::JobSystem::IsBusy(ctx));
+}
+
+TEST_CASE("JobSystem Execute and Wait", "[jobsystem]") {
+    Threading::JobSystem::Init(4);
+    REQUIRE(Threading::JobSystem::GetWorkerCount() == 4);
+    REQUIRE(Threading::JobSystem::GetMaxThreadCount() == 5);
+    REQUIRE(Threading::JobSystem::GetThreadIndex() == 0);
+
+    Threading::JobContext ctx;
+    std::atomic<int> counter{ 0 };
+    for (int i = 0; i < 100; ++i)
+        Threading::JobSystem::Execute(ctx, [&]() { counter++; });
+
+    Threading::JobSystem::Wait(ctx);
+    REQUIRE(counter == 100);
+    REQUIRE_FALSE(Threading::JobSystem::IsBusy(ctx));
+}
+
+TEST_CASE("JobSystem Dispatch covers every index once", "[jobsystem]") {
+    Threading::JobSystem::Init(4);
+
+    const uint32_t count = 1000;
+    std::vector<std::atomic<int>> hits(count);
+    std::atomic<uint32_t> maxThread{ 0 };
+    std::atomic<bool> argsValid{ true };
+
+    Threading::JobContext ctx;
+    Threading::JobSystem::Dispatch(ctx, count, 64, [&](Threading::JobArgs args) {
+        // Catch2 assertions are not thread-safe, so only record results here
+        hits[args.jobIndex]++;
+        if (args.jobIndex != args.groupIndex * 64 + args.groupID)
+            argsValid = false;
+
+        uint32_t index = Threading::JobSystem::GetThreadIndex();
+        uint32_t current = maxThread.load();
+        while (index > current && !maxThread.compare_exchange_weak(current, index)) {}
+    });
+    Threading::JobSystem::Wait(ctx);
+
+    for (uint32_t i = 0; i < count; ++i)
+        REQUIRE(hits[i] == 1);
+    REQUIRE(argsValid);
+    REQUIRE(maxThread < Threading::JobSystem::GetMaxThreadCount());
+}
+
+TEST_CASE("JobSystem nested jobs", "[jobsystem]") {
+    Threading::JobSystem::Init(2);
+
+    std::atomic<int> counter{ 0 };
+    Threading::JobContext outer;
+    Threading::JobSystem::Dispatch(outer, 8, 1, [&](Threading::JobArgs) {
+        Threading::JobContext inner;
+        Threading::JobSystem::Dispatch(inner, 8, 1, [&](Threading::JobArgs) { counter++; });
+        // Waiting inside a job must not deadlock; the worker helps run the queue
+        Threading::JobSystem::Wait(inner);
+    });
+    Threading::JobSystem::Wait(outer);
+
+    REQUIRE(counter == 64);
+    Threading::JobSystem::Shutdown();
+    REQUIRE_FALSE(Threading::JobSystem::IsInitialized());
+}
@@ -0,0 +1,195 @@
+#include <catch2/catch_all.hpp>
+#include "Math/Batch.h"
+#include "Math/Matrix.h"
+#include "Math/Quaternion.h"
+
+#include <random>
+#include <vector>
+
+/*
+ * Tests for the Math module. The SIMD path compiled into the engine (see
+ * Math::GetSimdName()) is checked against the Math::Scalar reference.
+ */
+
+namespace {
+
+    bool ApproxEqual(const Math::Mat4& a, const Math::Mat4& b, float eps = 1e-4f) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                if (std::fabs(a[c][r] - b[c][r]) > eps * (1.0f + std::fabs(b[c][r])))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool ApproxEqual(const Math::Vec3& a, const Math::Vec3& b, float eps = 1e-4f) {
+        return std::fabs(a.x - b.x) <= eps && std::fabs(a.y - b.y) <= eps && std::fabs(a.z - b.z) <= eps;
+    }
+
+    Math::Mat4 RandomTransform(std::mt19937& rng) {
+        std::uniform_real_distribution<float> d(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> s(0.5f, 2.0f);
+        return Math::Mat4::FromTRS({ d(rng), d(rng), d(rng) },
+            Math::Quat::FromAxisAngle({ d(rng), d(rng), d(rng) + 0.1f }, d(rng)), { s(rng), s(rng), s(rng) });
+    }
+
+} // namespace
+
+TEST_CASE("Vector and quaternion basics", "[math]") {
+    Math::Vec3 a(1.0f, 0.0f, 0.0f), b(0.0f, 1.0f, 0.0f);
+    REQUIRE(Math::Dot(a, b) == 0.0f);
+    REQUIRE(Math::Cross(a, b) == Math::Vec3(0.0f, 0.0f, 1.0f));
+    REQUIRE(Math::Length(Math::Normalize(Math::Vec3(3.0f, 4.0f, 0.0f))) == Catch::Approx(1.0f));
+
+    Math::Vec4 v(1.0f, 2.0f, 3.0f, 4.0f);
+    REQUIRE(v + v == Math::Vec4(2.0f, 4.0f, 6.0f, 8.0f));
+    REQUIRE(v * 0.5f == Math::Vec4(0.5f, 1.0f, 1.5f, 2.0f));
+
+    Math::Quat q = Math::Quat::FromAxisAngle({ 0.0f, 0.0f, 1.0f }, 3.14159265f * 0.5f);
+    REQUIRE(ApproxEqual(Math::Rotate(q, a), b));
+    REQUIRE(ApproxEqual(Math::Rotate(q * q, a), -a));
+
+    Math::Quat half = Math::Slerp(Math::Quat::Identity(), q, 0.5f);
+    Math::Vec3 diagonal = Math::Normalize(Math::Vec3(1.0f, 1.0f, 0.0f));
+    REQUIRE(ApproxEqual(Math::Rotate(half, a), diagonal));
+}
+
+TEST_CASE("Mat4 operations match the scalar reference", "[math]") {
+    std::mt19937 rng(42);
+
+    for (int i = 0; i < 100; ++i) {
+        Math::Mat4 a = RandomTransform(rng);
+        Math::Mat4 b = RandomTransform(rng);
+        REQUIRE(ApproxEqual(a * b, Math::Scalar::Multiply(a, b)));
+
+        Math::Vec4 p(1.0f, -2.0f, 3.0f, 1.0f);
+        Math::Vec4 simd = a * p, scalar = Math::Scalar::Transform(a, p);
+        REQUIRE(ApproxEqual(simd.XYZ(), scalar.XYZ(), 1e-3f));
+
+        // Rotation matrix agrees with quaternion rotation
+        Math::Quat q = Math::Quat::FromAxisAngle({ 1.0f, 2.0f, 3.0f }, 0.1f * i);
+        Math::Vec3 v(0.3f, -0.7f, 2.0f);
+        REQUIRE(ApproxEqual(Math::TransformVector(Math::Mat4::Rotation(q), v), Math::Rotate(q, v)));
+
+        // Both inverses undo the transform
+        REQUIRE(ApproxEqual(a * Math::Inverse(a), Math::Mat4::Identity()));
+        REQUIRE(ApproxEqual(Math::InverseAffine(a) * a, Math::Mat4::Identity()));
+    }
+}
+
+TEST_CASE("Projection and view matrices", "[math]") {
+    Math::Mat4 view = Math::Mat4::LookAt({ 0.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+    REQUIRE(ApproxEqual(Math::TransformPoint(view, { 0.0f, 0.0f, 0.0f }), { 0.0f, 0.0f, -5.0f }));
+
+    Math::Mat4 proj = Math::Mat4::Perspective(1.0f, 1.0f, 1.0f, 100.0f);
+    Math::Vec4 nearPoint = proj * Math::Vec4(0.0f, 0.0f, -1.0f, 1.0f);
+    Math::Vec4 farPoint = proj * Math::Vec4(0.0f, 0.0f, -100.0f, 1.0f);
+    REQUIRE(nearPoint.z / nearPoint.w == Catch::Approx(-1.0f));
+    REQUIRE(farPoint.z / farPoint.w == Catch::Approx(1.0f));
+}
+
+TEST_CASE("Batch kernels match the scalar reference", "[math]") {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> d(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> s(0.0f, 10.0f);
+
+    // Odd count so the SIMD tail handling is exercised
+    const size_t count = 1003;
+
+    SECTION("TransformPoints") {
+        std::vector<float> x(count), y(count), z(count);
+        for (size_t i = 0; i < count; ++i) { x[i] = d(rng); y[i] = d(rng); z[i] = d(rng); }
+
+        std::vector<float> sx(count), sy(count), sz(count), rx(count), ry(count), rz(count);
+        Math::Mat4 m = RandomTransform(rng);
+        Math::TransformPoints(m, { x.data(), y.data(), z.data() }, { sx.data(), sy.data(), sz.data() }, count);
+        Math::Scalar::TransformPoints(m, { x.data(), y.data(), z.data() }, { rx.data(), ry.data(), rz.data() }, count);
+
+        for (size_t i = 0; i < count; ++i) {
+            REQUIRE(sx[i] == Catch::Approx(rx[i]).margin(1e-3));
+            REQUIRE(sy[i] == Catch::Approx(ry[i]).margin(1e-3));
+            REQUIRE(sz[i] == Catch::Approx(rz[i]).margin(1e-3));
+        }
+
+        // In-place transform gives the same answer
+        Math::TransformPoints(m, { x.data(), y.data(), z.data() }, { x.data(), y.data(), z.data() }, count);
+        REQUIRE(x == sx);
+    }
+
+    SECTION("MultiplyMatrices") {
+        std::vector<Math::Mat4> a(count), b(count), simd(count), scalar(count);
+        for (size_t i = 0; i < count; ++i) { a[i] = RandomTransform(rng); b[i] = RandomTransform(rng); }
+
+        Math::MultiplyMatrices(a.data(), b.data(), simd.data(), count);
+        Math::Scalar::MultiplyMatrices(a.data(), b.data(), scalar.data(), count);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(ApproxEqual(simd[i], scalar[i]));
+    }
+
+    SECTION("OverlapAABBs") {
+        std::vector<float> minX(count), minY(count), minZ(count), maxX(count), maxY(count), maxZ(count);
+        for (size_t i = 0; i < count; ++i) {
+            minX[i] = d(rng); minY[i] = d(rng); minZ[i] = d(rng);
+            maxX[i] = minX[i] + s(rng); maxY[i] = minY[i] + s(rng); maxZ[i] = minZ[i] + s(rng);
+        }
+        Math::AABBSoA boxes{ minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() };
+        Math::AABB query({ -20.0f, -20.0f, -20.0f }, { 20.0f, 25.0f, 20.0f });
+
+        std::vector<uint32_t> simd(count), scalar(count);
+        size_t simdCount = Math::OverlapAABBs(query, boxes, count, simd.data());
+        size_t scalarCount = Math::Scalar::OverlapAABBs(query, boxes, count, scalar.data());
+
+        REQUIRE(simdCount > 0);
+        REQUIRE(simdCount == scalarCount);
+        simd.resize(simdCount);
+        scalar.resize(scalarCount);
+        REQUIRE(simd == scalar);
+    }
+    SECTION("CullAABBs") {
+        std::vector<float> minX(count), minY(count), minZ(count), maxX(count), maxY(count), maxZ(count);
+        for (size_t i = 0; i < count; ++i) {
+            minX[i] = d(rng); minY[i] = d(rng); minZ[i] = d(rng);
+            maxX[i] = minX[i] + s(rng); maxY[i] = minY[i] + s(rng); maxZ[i] = minZ[i] + s(rng);
+        }
+        Math::AABBSoA boxes{ minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() };
+        Math::Mat4 viewProj = Math::Mat4::Perspective(1.0f, 1.5f, 0.1f, 60.0f)
+                            * Math::Mat4::LookAt({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.2f, 0.5f }, { 0.0f, 1.0f, 0.0f });
+        Math::Frustum frustum = Math::Frustum::FromMatrix(viewProj);
+
+        std::vector<uint32_t> simd(count), scalar(count);
+        size_t simdCount = Math::CullAABBs(frustum, boxes, count, simd.data());
+        size_t scalarCount = Math::Scalar::CullAABBs(frustum, boxes, count, scalar.data());
+
+        REQUIRE(simdCount > 0);
+        REQUIRE(simdCount < count);
+        REQUIRE(simdCount == scalarCount);
+        simd.resize(simdCount);
+        scalar.resize(scalarCount);
+        REQUIRE(simd == scalar);
+
+        // Agrees with the per-box classification
+        for (size_t i = 0, next = 0; i < count; ++i) {
+            Math::AABB box({ minX[i], minY[i], minZ[i] }, { maxX[i], maxY[i], maxZ[i] });
+            bool visible = frustum.Test(box) != Math::Containment::Outside;
+            bool listed = next < simd.size() && simd[next] == i;
+            REQUIRE(visible == listed);
+            if (listed)
+                ++next;
+        }
+    }
+}
+
+TEST_CASE("Frustum planes and containment", "[math]") {
+    Math::Mat4 proj = Math::Mat4::Perspective(1.5707964f, 1.0f, 1.0f, 100.0f);
+    Math::Frustum frustum = Math::Frustum::FromMatrix(proj);
+
+    // Camera at the origin looking down -Z
+    REQUIRE(frustum.planes[4].Distance({ 0.0f, 0.0f, -1.0f }) == Catch::Approx(0.0f).margin(1e-4));
+    REQUIRE(frustum.planes[5].Distance({ 0.0f, 0.0f, -100.0f }) == Catch::Approx(0.0f).margin(1e-3));
+
+    REQUIRE(frustum.Test(Math::AABB::FromCenterExtents({ 0.0f, 0.0f, -10.0f }, Math::Vec3(1.0f))) == Math::Containment::Inside);
+    REQUIRE(frustum.Test(Math::AABB::FromCenterExtents({ 0.0f, 0.0f, 10.0f }, Math::Vec3(1.0f))) == Math::Containment::Outside);
+    REQUIRE(frustum.Test(Math::AABB::FromCenterExtents({ 10.0f, 0.0f, -10.0f }, Math::Vec3(1.0f))) == Math::Containment::Intersects);
+    REQUIRE(frustum.Test(Math::AABB::FromCenterExtents({ 0.0f, 0.0f, -200.0f }, Math::Vec3(1.0f))) == Math::Containment::Outside);
+}
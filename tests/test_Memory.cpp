@@ -2,6 +2,7 @@
 
 // Include your MemoryManager and Logger
 #include "../../engine/include/Memory/MemoryManager.h"
+#include "../../engine/include/Memory/LinearAllocator.h"
 #include "../../engine/include/Utils/Logger.h"
 
 // Optional: spdlog sink includes (for capturing log output)
@@ -98,3 +99,23 @@ TEST_CASE("Memory Profiling Logs", "[memory][profiling]") {
     Logger::GetProfileLogger()->sinks().pop_back();
 }
 
+TEST_CASE("LinearAllocator bump allocation", "[memory]") {
+    LinearAllocator arena(1024, "TestArena");
+    REQUIRE(arena.GetCapacity() == 1024);
+
+    void* a = arena.Allocate(10, 1);
+    void* b = arena.Allocate(16, 64);
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+    REQUIRE(static_cast<uint8_t*>(b) >= static_cast<uint8_t*>(a) + 10);
+
+    // Exhausting the arena fails without corrupting it
+    REQUIRE(arena.Allocate(2048) == nullptr);
+    REQUIRE(arena.GetUsed() <= 1024);
+
+    arena.Reset();
+    REQUIRE(arena.GetUsed() == 0);
+    REQUIRE(arena.AllocateArray<uint32_t>(256) != nullptr);
+    REQUIRE(arena.Allocate(1) == nullptr);
+}
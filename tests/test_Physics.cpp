@@ -0,0 +1,456 @@
+#include <catch2/catch_all.hpp>
+#include "Physics/Physics.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr float kDt = 1.0f / 60.0f;
+
+    Physics::BodyId AddGround(Physics::PhysicsWorld& world, const Math::Quat& rotation = Math::Quat::Identity(), float friction = 0.6f) {
+        Physics::BodyDesc desc;
+        desc.type = Physics::BodyType::Static;
+        desc.shape = Physics::CollisionShape::Box({ 50.0f, 0.5f, 50.0f });
+        desc.position = Math::Rotate(rotation, { 0.0f, -0.5f, 0.0f });
+        desc.rotation = rotation;
+        desc.friction = friction;
+        return world.CreateBody(desc);
+    }
+
+    Physics::BodyId AddBox(Physics::PhysicsWorld& world, const Math::Vec3& position, const Math::Quat& rotation = Math::Quat::Identity()) {
+        Physics::BodyDesc desc;
+        desc.shape = Physics::CollisionShape::Box(Math::Vec3(0.5f));
+        desc.position = position;
+        desc.rotation = rotation;
+        return world.CreateBody(desc);
+    }
+
+    std::vector<Physics::BodyId> AddStack(Physics::PhysicsWorld& world, float x, uint32_t height) {
+        std::vector<Physics::BodyId> boxes;
+        for (uint32_t i = 0; i < height; ++i)
+            boxes.push_back(AddBox(world, { x, 0.5f + 1.001f * i, 0.0f }));
+        return boxes;
+    }
+
+    void Run(Physics::PhysicsWorld& world, float seconds) {
+        for (int i = 0, steps = static_cast<int>(seconds / kDt + 0.5f); i < steps; ++i)
+            world.Step(kDt);
+    }
+
+} // namespace
+
+TEST_CASE("Bodies fall and come to rest on the ground", "[physics]") {
+    Physics::PhysicsWorld world;
+    AddGround(world);
+
+    SECTION("Free fall matches the integrator") {
+        Physics::BodyDesc desc;
+        desc.shape = Physics::CollisionShape::Sphere(0.5f);
+        desc.position = { 0.0f, 100.0f, 0.0f };
+        desc.angularDamping = 0.0f;
+        const Physics::BodyId sphere = world.CreateBody(desc);
+        Run(world, 1.0f);
+        // Semi-implicit Euler: the velocity is updated before the position
+        const float expected = 100.0f - 9.81f * kDt * kDt * 60.0f * 61.0f * 0.5f;
+        CHECK(world.GetPosition(sphere).y == Catch::Approx(expected).margin(1e-3f));
+        CHECK(world.GetLinearVelocity(sphere).y == Catch::Approx(-9.81f).margin(1e-3f));
+    }
+
+    SECTION("A dropped box settles and falls asleep") {
+        const Physics::BodyId box = AddBox(world, { 0.0f, 2.0f, 0.0f }, Math::Quat::FromAxisAngle({ 1.0f, 0.0f, 1.0f }, 0.3f));
+        Run(world, 4.0f);
+        CHECK(world.GetPosition(box).y == Catch::Approx(0.5f).margin(0.02f));
+        CHECK(std::fabs(Math::Rotate(world.GetRotation(box), { 0.0f, 1.0f, 0.0f }).y) > 0.999f);
+        CHECK_FALSE(world.IsAwake(box));
+        CHECK(world.GetAwakeBodyCount() == 0);
+        CHECK(world.GetSleepingIslandCount() == 1);
+        CHECK(Math::Length(world.GetLinearVelocity(box)) == 0.0f);
+    }
+
+    SECTION("A stack of boxes stays upright") {
+        const std::vector<Physics::BodyId> stack = AddStack(world, 0.0f, 8);
+        Run(world, 6.0f);
+        for (uint32_t i = 0; i < stack.size(); ++i) {
+            const Math::Vec3 p = world.GetPosition(stack[i]);
+            CHECK(std::fabs(p.x) < 0.05f);
+            CHECK(std::fabs(p.z) < 0.05f);
+            CHECK(p.y == Catch::Approx(0.5f + i).margin(0.05f));
+        }
+        CHECK(world.GetAwakeBodyCount() == 0);
+    }
+}
+
+TEST_CASE("Sleeping islands wake as a whole", "[physics]") {
+    Physics::PhysicsWorld world;
+    AddGround(world);
+    const std::vector<Physics::BodyId> left = AddStack(world, -3.0f, 4);
+    const std::vector<Physics::BodyId> right = AddStack(world, 3.0f, 4);
+
+    // Ground contacts do not join islands: two stacks, two islands
+    world.Step(kDt);
+    CHECK(world.GetIslandCount() == 2);
+    Run(world, 4.0f);
+    REQUIRE(world.GetSleepingIslandCount() == 2);
+    CHECK(world.GetIslandCount() == 0);
+    const Math::Vec3 rightTop = world.GetPosition(right.back());
+
+    // A ball thrown at the top of the left stack wakes every box in it
+    Physics::BodyDesc ball;
+    ball.shape = Physics::CollisionShape::Sphere(0.3f);
+    ball.position = { -6.0f, 3.5f, 0.0f };
+    ball.linearVelocity = { 12.0f, 1.5f, 0.0f };
+    ball.mass = 4.0f;
+    world.CreateBody(ball);
+
+    bool woke = false;
+    for (int i = 0; i < 30 && !woke; ++i) {
+        world.Step(kDt);
+        woke = world.IsAwake(left.front());
+    }
+    REQUIRE(woke);
+    for (Physics::BodyId box : left)
+        CHECK(world.IsAwake(box));
+    CHECK(world.GetSleepingIslandCount() == 1);
+
+    // The other stack never moved
+    for (Physics::BodyId box : right)
+        CHECK_FALSE(world.IsAwake(box));
+    CHECK(world.GetPosition(right.back()) == rightTop);
+
+    // Changing a body through the API wakes its island too
+    world.SetLinearVelocity(right.front(), { 0.0f, 0.0f, 0.1f });
+    for (Physics::BodyId box : right)
+        CHECK(world.IsAwake(box));
+    CHECK(world.GetSleepingIslandCount() == 0);
+}
+
+TEST_CASE("Friction holds a box on a gentle slope", "[physics]") {
+    const Math::Quat slope = Math::Quat::FromAxisAngle({ 0.0f, 0.0f, 1.0f }, 0.35f);  // 20 degrees
+    const Math::Vec3 start = Math::Rotate(slope, { 0.0f, 0.5f, 0.0f });
+
+    SECTION("Friction above tan(20 degrees) holds") {
+        Physics::PhysicsWorld world;
+        AddGround(world, slope, 0.6f);
+        const Physics::BodyId box = AddBox(world, start, slope);
+        Run(world, 2.0f);
+        CHECK(Math::Length(world.GetPosition(box) - start) < 0.05f);
+    }
+
+    SECTION("No friction slides") {
+        Physics::PhysicsWorld world;
+        AddGround(world, slope, 0.0f);
+        const Physics::BodyId box = AddBox(world, start, slope);
+        Run(world, 2.0f);
+        // a = g sin(20 degrees), so about 6.7 m in 2 s
+        CHECK(Math::Length(world.GetPosition(box) - start) > 5.0f);
+    }
+}
+
+TEST_CASE("Ball joints keep their anchors together", "[physics]") {
+    Physics::PhysicsWorld world;
+    Physics::BodyDesc desc;
+    desc.type = Physics::BodyType::Static;
+    desc.shape = Physics::CollisionShape::Sphere(0.1f);
+    desc.position = { 0.0f, 5.0f, 0.0f };
+    const Physics::BodyId pivot = world.CreateBody(desc);
+
+    // A chain of three capsules hanging sideways off the pivot; links touch but
+    // jointed neighbours do not collide
+    desc.type = Physics::BodyType::Dynamic;
+    desc.shape = Physics::CollisionShape::Capsule(0.2f, 0.3f);
+    desc.rotation = Math::Quat::FromAxisAngle({ 0.0f, 0.0f, 1.0f }, 1.5707963f);
+    std::vector<Physics::BodyId> links;
+    for (int i = 0; i < 3; ++i) {
+        desc.position = { 0.5f + i * 1.0f, 5.0f, 0.0f };
+        links.push_back(world.CreateBody(desc));
+        world.CreateBallJoint(i == 0 ? pivot : links[i - 1], links[i], { i * 1.0f, 5.0f, 0.0f });
+    }
+    world.Step(kDt);
+    CHECK(world.GetIslandCount() == 1);
+    CHECK(world.GetContactCount() == 0);
+
+    float maxError = 0.0f, lowest = 5.0f;
+    for (int i = 0; i < 180; ++i) {
+        world.Step(kDt);
+        lowest = std::min(lowest, world.GetPosition(links.back()).y);
+        for (int k = 0; k < 3; ++k) {
+            const Math::Vec3 anchor = (k == 0) ? world.GetPosition(pivot)
+                : world.GetPosition(links[k - 1]) + Math::Rotate(world.GetRotation(links[k - 1]), { 0.0f, -0.5f, 0.0f });
+            const Math::Vec3 own = world.GetPosition(links[k]) + Math::Rotate(world.GetRotation(links[k]), { 0.0f, 0.5f, 0.0f });
+            maxError = std::max(maxError, Math::Length(anchor - own));
+        }
+    }
+    // The tip whips through at several m/s; the drift stays within a few centimetres
+    CHECK(maxError < 0.1f);
+    // The chain swung down below the pivot
+    CHECK(lowest < 3.0f);
+}
+
+TEST_CASE("Simulation results do not depend on the thread count", "[physics]") {
+    auto simulate = [](std::vector<Math::Vec3>& positions, std::vector<Math::Quat>& rotations) {
+        Physics::PhysicsWorld world;
+        AddGround(world);
+        for (int s = 0; s < 6; ++s)
+            AddStack(world, -7.5f + 3.0f * s, 6);
+        // Ragdoll-ish capsule pairs dropped onto the stacks
+        Physics::BodyDesc desc;
+        desc.shape = Physics::CollisionShape::Capsule(0.25f, 0.4f);
+        for (int i = 0; i < 8; ++i) {
+            desc.position = { -8.0f + 2.1f * i, 9.0f, 0.3f * (i % 3) };
+            desc.rotation = Math::Quat::FromAxisAngle({ 0.3f, 0.0f, 1.0f }, 0.4f * i);
+            const Physics::BodyId a = world.CreateBody(desc);
+            desc.position = desc.position + Math::Rotate(desc.rotation, { 0.0f, 1.3f, 0.0f });
+            const Physics::BodyId b = world.CreateBody(desc);
+            world.CreateBallJoint(a, b, (world.GetPosition(a) + world.GetPosition(b)) * 0.5f);
+        }
+        Run(world, 2.0f);
+        for (Physics::BodyId body = 0; body < world.GetBodyCount(); ++body) {
+            positions.push_back(world.GetPosition(body));
+            rotations.push_back(world.GetRotation(body));
+        }
+    };
+
+    std::vector<Math::Vec3> serialPositions, parallelPositions;
+    std::vector<Math::Quat> serialRotations, parallelRotations;
+    simulate(serialPositions, serialRotations);
+    Threading::JobSystem::Init(4);
+    simulate(parallelPositions, parallelRotations);
+    Threading::JobSystem::Shutdown();
+
+    REQUIRE(serialPositions.size() == parallelPositions.size());
+    CHECK(std::memcmp(serialPositions.data(), parallelPositions.data(), serialPositions.size() * sizeof(Math::Vec3)) == 0);
+    CHECK(std::memcmp(serialRotations.data(), parallelRotations.data(), serialRotations.size() * sizeof(Math::Quat)) == 0);
+}
+
+TEST_CASE("Snapshots roll the world back exactly", "[physics]") {
+    struct State {
+        std::vector<Math::Vec3> positions, linear, angular;
+        std::vector<Math::Quat> rotations;
+        uint32_t                awake = 0, sleepingIslands = 0;
+    };
+    auto capture = [](const Physics::PhysicsWorld& world) {
+        State state;
+        for (Physics::BodyId body = 0; body < world.GetBodyCount(); ++body) {
+            state.positions.push_back(world.GetPosition(body));
+            state.rotations.push_back(world.GetRotation(body));
+            state.linear.push_back(world.GetLinearVelocity(body));
+            state.angular.push_back(world.GetAngularVelocity(body));
+        }
+        state.awake = world.GetAwakeBodyCount();
+        state.sleepingIslands = world.GetSleepingIslandCount();
+        return state;
+    };
+    auto same = [](const State& l, const State& r) {
+        return l.positions.size() == r.positions.size() && l.awake == r.awake && l.sleepingIslands == r.sleepingIslands &&
+               std::memcmp(l.positions.data(), r.positions.data(), l.positions.size() * sizeof(Math::Vec3)) == 0 &&
+               std::memcmp(l.rotations.data(), r.rotations.data(), l.rotations.size() * sizeof(Math::Quat)) == 0 &&
+               std::memcmp(l.linear.data(), r.linear.data(), l.linear.size() * sizeof(Math::Vec3)) == 0 &&
+               std::memcmp(l.angular.data(), r.angular.data(), l.angular.size() * sizeof(Math::Vec3)) == 0;
+    };
+
+    // Three sleeping stacks, a ball thrown at them, and jointed capsules
+    // falling next to them
+    Physics::PhysicsWorld world;
+    AddGround(world);
+    for (int s = 0; s < 3; ++s)
+        AddStack(world, -3.0f + 3.0f * s, 4);
+    Run(world, 4.0f);
+    REQUIRE(world.GetSleepingIslandCount() == 3);
+
+    Physics::BodyDesc desc;
+    desc.shape = Physics::CollisionShape::Sphere(0.3f);
+    desc.position = { -6.0f, 3.5f, 0.0f };
+    desc.linearVelocity = { 12.0f, 1.5f, 0.0f };
+    desc.mass = 4.0f;
+    world.CreateBody(desc);
+    desc = Physics::BodyDesc();
+    desc.shape = Physics::CollisionShape::Capsule(0.25f, 0.4f);
+    for (int i = 0; i < 4; ++i) {
+        desc.position = { -1.5f + 3.0f * i, 6.0f, 2.0f };
+        const Physics::BodyId a = world.CreateBody(desc);
+        desc.position.y += 1.3f;
+        const Physics::BodyId b = world.CreateBody(desc);
+        world.CreateBallJoint(a, b, (world.GetPosition(a) + world.GetPosition(b)) * 0.5f);
+        desc.position.y -= 1.3f;
+    }
+    world.Step(kDt);
+
+    Physics::PhysicsSnapshot start;
+    world.SaveSnapshot(start);
+    constexpr int kFrames = 40, kRing = 8;
+    std::vector<State> reference;
+    std::vector<Physics::PhysicsSnapshot> deltaRing(kRing), fullRing(kRing);
+    for (int frame = 0; frame < kFrames; ++frame) {
+        world.SaveSnapshot(deltaRing[frame % kRing], Physics::SnapshotMode::Delta);
+        world.SaveSnapshot(fullRing[frame % kRing]);
+        reference.push_back(capture(world));
+        world.Step(kDt);
+    }
+    const State end = capture(world);
+    // Stacks woke up during the run
+    REQUIRE(reference.front().sleepingIslands == 3);
+    REQUIRE(end.sleepingIslands < 3);
+
+    SECTION("A full restore replays the same steps") {
+        desc.position = { 0.0f, 10.0f, 0.0f };
+        world.CreateBody(desc);
+        world.RestoreSnapshot(start);
+        CHECK(world.GetBodyCount() == start.GetBodyCount());
+        CHECK(same(capture(world), reference.front()));
+        Run(world, kFrames * kDt);
+        CHECK(same(capture(world), end));
+    }
+
+    SECTION("Delta snapshots in a ring match full ones") {
+        for (int frame = kFrames - kRing; frame < kFrames; ++frame) {
+            world.RestoreSnapshot(deltaRing[frame % kRing], Physics::SnapshotMode::Delta);
+            CHECK(same(capture(world), reference[frame]));
+            world.RestoreSnapshot(fullRing[frame % kRing]);
+            CHECK(same(capture(world), reference[frame]));
+        }
+        // Roll back eight frames and resimulate, saving into the ring as a game would
+        world.RestoreSnapshot(deltaRing[(kFrames - kRing) % kRing], Physics::SnapshotMode::Delta);
+        for (int frame = kFrames - kRing; frame < kFrames; ++frame) {
+            world.SaveSnapshot(deltaRing[frame % kRing], Physics::SnapshotMode::Delta);
+            world.Step(kDt);
+        }
+        CHECK(same(capture(world), end));
+        world.RestoreSnapshot(deltaRing[(kFrames - 3) % kRing], Physics::SnapshotMode::Delta);
+        CHECK(same(capture(world), reference[kFrames - 3]));
+    }
+
+    SECTION("Snapshots restore into another world") {
+        Physics::PhysicsWorld copy;
+        copy.RestoreSnapshot(start);
+        Run(copy, kFrames * kDt);
+        CHECK(same(capture(copy), end));
+    }
+}
+
+TEST_CASE("Batched scene queries match brute force", "[physics]") {
+    static const Math::Vec3 kWedge[6] = {
+        { -0.5f, -0.4f, -0.5f }, { 0.5f, -0.4f, -0.5f }, { -0.5f, 0.4f, -0.5f },
+        { -0.5f, -0.4f, 0.5f },  { 0.5f, -0.4f, 0.5f },  { -0.5f, 0.4f, 0.5f },
+    };
+    Physics::PhysicsWorld world;
+    AddGround(world);
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> p(-12.0f, 12.0f), h(0.5f, 6.0f), angle(-3.0f, 3.0f);
+    for (int i = 0; i < 300; ++i) {
+        Physics::BodyDesc desc;
+        desc.type = (i % 3 == 0) ? Physics::BodyType::Static : Physics::BodyType::Dynamic;
+        switch (i % 4) {
+        case 0: desc.shape = Physics::CollisionShape::Sphere(0.4f); break;
+        case 1: desc.shape = Physics::CollisionShape::Capsule(0.3f, 0.5f); break;
+        case 2: desc.shape = Physics::CollisionShape::Box({ 0.5f, 0.3f, 0.4f }); break;
+        default: desc.shape = Physics::CollisionShape::ConvexHull(kWedge, 6); break;
+        }
+        desc.position = { p(rng), h(rng), p(rng) };
+        desc.rotation = Math::Quat::FromAxisAngle(Math::Normalize(Math::Vec3(p(rng), p(rng), p(rng) + 0.01f)), angle(rng));
+        world.CreateBody(desc);
+    }
+    // Let things fall and move, so queries see poses the broadphase has caught up with
+    Run(world, 0.5f);
+
+    std::vector<Physics::RayQuery> rays(777);
+    for (Physics::RayQuery& ray : rays) {
+        ray.origin = { p(rng), h(rng) + 2.0f, p(rng) };
+        ray.direction = Math::Normalize(Math::Vec3(p(rng), p(rng) - 6.0f, p(rng)));
+        ray.maxDistance = 30.0f;
+    }
+    rays[0].ignore = 0;   // Looks through the ground
+    std::vector<Physics::ShapeCastQuery> casts(150);
+    for (uint32_t i = 0; i < casts.size(); ++i) {
+        casts[i].shape = (i % 2) ? Physics::CollisionShape::Sphere(0.3f) : Physics::CollisionShape::Box({ 0.3f, 0.2f, 0.3f });
+        casts[i].position = { p(rng), 8.0f, p(rng) };
+        casts[i].direction = Math::Normalize(Math::Vec3(p(rng) * 0.1f, -1.0f, p(rng) * 0.1f));
+        casts[i].maxDistance = 20.0f;
+    }
+    std::vector<Physics::OverlapQuery> overlaps(150);
+    for (Physics::OverlapQuery& query : overlaps) {
+        query.shape = Physics::CollisionShape::Sphere(1.5f);
+        query.position = { p(rng), h(rng), p(rng) };
+    }
+
+    auto runQueries = [&](std::vector<Physics::QueryHit>& rayHits, std::vector<Physics::QueryHit>& castHits,
+                          std::vector<Physics::BodyId>& bodies, std::vector<uint32_t>& counts) {
+        rayHits.resize(rays.size());
+        castHits.resize(casts.size());
+        bodies.assign(overlaps.size() * 8, Physics::InvalidBody);
+        counts.resize(overlaps.size());
+        world.RayCast(rays.data(), static_cast<uint32_t>(rays.size()), rayHits.data());
+        world.ShapeCast(casts.data(), static_cast<uint32_t>(casts.size()), castHits.data());
+        world.Overlap(overlaps.data(), static_cast<uint32_t>(overlaps.size()), bodies.data(), 8, counts.data());
+    };
+    std::vector<Physics::QueryHit> rayHits, castHits;
+    std::vector<Physics::BodyId> bodies;
+    std::vector<uint32_t> counts;
+    runQueries(rayHits, castHits, bodies, counts);
+
+    // Brute force over every body
+    uint32_t rayHitCount = 0;
+    for (uint32_t i = 0; i < rays.size(); ++i) {
+        float closest = rays[i].maxDistance;
+        Physics::BodyId expected = Physics::InvalidBody;
+        for (Physics::BodyId body = 0; body < world.GetBodyCount(); ++body) {
+            Physics::CastHit hit;
+            if (body != rays[i].ignore
+                && Physics::RayCast(world.GetShape(body), world.GetPosition(body), world.GetRotation(body), rays[i].origin, rays[i].direction, closest, hit)) {
+                closest = hit.distance;
+                expected = body;
+            }
+        }
+        REQUIRE(rayHits[i].body == expected);
+        if (expected != Physics::InvalidBody) {
+            REQUIRE(rayHits[i].distance == closest);
+            ++rayHitCount;
+        }
+    }
+    CHECK(rayHitCount > rays.size() / 2);
+    CHECK(rayHits[0].body != 0);
+
+    for (uint32_t i = 0; i < casts.size(); ++i) {
+        float closest = casts[i].maxDistance;
+        Physics::BodyId expected = Physics::InvalidBody;
+        for (Physics::BodyId body = 0; body < world.GetBodyCount(); ++body) {
+            Physics::CastHit hit;
+            if (Physics::ShapeCast(casts[i].shape, casts[i].position, casts[i].rotation, casts[i].direction, closest,
+                                   world.GetShape(body), world.GetPosition(body), world.GetRotation(body), hit)) {
+                closest = hit.distance;
+                expected = body;
+            }
+        }
+        REQUIRE(castHits[i].body == expected);
+        REQUIRE(castHits[i].distance == Catch::Approx(closest).margin(2.0f * Physics::kCastTolerance));
+    }
+
+    for (uint32_t i = 0; i < overlaps.size(); ++i) {
+        std::vector<Physics::BodyId> expected;
+        for (Physics::BodyId body = 0; body < world.GetBodyCount(); ++body) {
+            Physics::ContactManifold manifold;
+            if (Physics::Collide(overlaps[i].shape, overlaps[i].position, overlaps[i].rotation,
+                                 world.GetShape(body), world.GetPosition(body), world.GetRotation(body), 0.0f, manifold))
+                expected.push_back(body);
+        }
+        REQUIRE(counts[i] == expected.size());
+        expected.resize(std::min<size_t>(expected.size(), 8));
+        REQUIRE(std::equal(expected.begin(), expected.end(), bodies.begin() + i * 8));
+    }
+
+    // Workers split the batches without changing any result
+    std::vector<Physics::QueryHit> parallelRayHits, parallelCastHits;
+    std::vector<Physics::BodyId> parallelBodies;
+    std::vector<uint32_t> parallelCounts;
+    Threading::JobSystem::Init(3);
+    runQueries(parallelRayHits, parallelCastHits, parallelBodies, parallelCounts);
+    Threading::JobSystem::Shutdown();
+    CHECK(std::memcmp(rayHits.data(), parallelRayHits.data(), rayHits.size() * sizeof(Physics::QueryHit)) == 0);
+    CHECK(std::memcmp(castHits.data(), parallelCastHits.data(), castHits.size() * sizeof(Physics::QueryHit)) == 0);
+    CHECK(parallelBodies == bodies);
+    CHECK(parallelCounts == counts);
+}
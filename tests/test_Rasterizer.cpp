@@ -0,0 +1,273 @@
+#include <catch2/catch_all.hpp>
+#include "Renderer/CommandBucket.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/SoftwareRasterizer.h"
+#include "Threading/JobSystem.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Tests for the software rasterizer and the headless SoftwareRenderBackend.
+ *
+ * Golden images live in tests/golden/. Run with ENGINE_UPDATE_GOLDEN=1 to
+ * rewrite them after an intentional change, and review the new images.
+ */
+
+namespace {
+
+    struct MeshData {
+        std::vector<Math::Vec3> positions;
+        std::vector<uint32_t>   indices;
+    };
+
+    // Unit cube centred at the origin, counter-clockwise seen from outside
+    MeshData MakeCube() {
+        MeshData mesh;
+        for (int i = 0; i < 8; ++i)
+            mesh.positions.emplace_back((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+
+        const uint32_t quads[6][4] = { { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 } };
+        for (const auto& q : quads) {
+            uint32_t tris[2][3] = { { q[0], q[1], q[2] }, { q[0], q[2], q[3] } };
+            for (auto& t : tris) {
+                const Math::Vec3& a = mesh.positions[t[0]];
+                const Math::Vec3& b = mesh.positions[t[1]];
+                const Math::Vec3& c = mesh.positions[t[2]];
+                // Outward normal points away from the centre
+                if (Math::Dot(Math::Cross(b - a, c - a), a) < 0.0f)
+                    std::swap(t[1], t[2]);
+                mesh.indices.insert(mesh.indices.end(), { t[0], t[1], t[2] });
+            }
+        }
+        return mesh;
+    }
+
+    // Screen-aligned quad in NDC (identity transform), counter-clockwise
+    MeshData MakeQuad(float x0, float y0, float x1, float y1, float z) {
+        return { { { x0, y0, z }, { x1, y0, z }, { x1, y1, z }, { x0, y1, z } }, { 0, 1, 2, 0, 2, 3 } };
+    }
+
+    uint32_t CountColor(const Renderer::SoftwareRasterizer& r, uint32_t color) {
+        uint32_t count = 0;
+        for (uint32_t pixel : r.ReadColor())
+            count += (pixel == color) ? 1 : 0;
+        return count;
+    }
+
+    bool LoadPPM(const std::string& path, uint32_t& width, uint32_t& height, std::vector<uint32_t>& pixels) {
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        int maxValue = 0;
+        if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" || maxValue != 255)
+            return false;
+        file.get();
+
+        pixels.resize(static_cast<size_t>(width) * height);
+        for (uint32_t& pixel : pixels) {
+            unsigned char rgb[3];
+            if (!file.read(reinterpret_cast<char*>(rgb), 3))
+                return false;
+            pixel = 0xFF000000u | (rgb[2] << 16) | (rgb[1] << 8) | rgb[0];
+        }
+        return true;
+    }
+
+    /**
+     * Compares against tests/golden/<name>.ppm. A handful of differing edge pixels
+     * is tolerated so SIMD levels and FMA contraction do not break the test.
+     */
+    void RequireMatchesGolden(const Renderer::SoftwareRasterizer& r, const std::string& name) {
+        const std::string path = std::string(ENGINE_GOLDEN_DIR) + "/" + name + ".ppm";
+        if (std::getenv("ENGINE_UPDATE_GOLDEN")) {
+            REQUIRE(r.SaveColorPPM(path));
+            WARN("Updated golden image " << path);
+            return;
+        }
+
+        uint32_t width = 0, height = 0;
+        std::vector<uint32_t> golden;
+        REQUIRE(LoadPPM(path, width, height, golden));
+        REQUIRE(width == r.GetWidth());
+        REQUIRE(height == r.GetHeight());
+
+        std::vector<uint32_t> actual = r.ReadColor();
+        size_t differing = 0;
+        for (size_t i = 0; i < golden.size(); ++i)
+            differing += ((actual[i] | 0xFF000000u) != golden[i]) ? 1 : 0;
+        INFO("Differing pixels: " << differing << " of " << golden.size());
+        REQUIRE(differing <= golden.size() / 500);
+    }
+
+} // namespace
+
+TEST_CASE("Rasterizer covers pixels exactly once", "[renderer][rasterizer]") {
+    Renderer::SoftwareRasterizer r(64, 64);
+    const Math::Mat4 identity = Math::Mat4::Identity();
+
+    // NDC quad from pixel 16 to 48 on both axes: 32x32 pixel centres inside
+    MeshData quad = MakeQuad(-0.5f, -0.5f, 0.5f, 0.5f, 0.0f);
+    r.SubmitTriangles(identity, quad.positions.data(), quad.indices.data(), 6, 0xFF0000FFu);
+    r.Rasterize();
+    REQUIRE(r.GetTriangleCount() == 2);
+    REQUIRE(CountColor(r, 0xFF0000FFu) == 32 * 32);
+    REQUIRE(r.GetColor(16, 16) == 0xFF0000FFu);
+    REQUIRE(r.GetColor(47, 47) == 0xFF0000FFu);
+    REQUIRE(r.GetColor(15, 16) != 0xFF0000FFu);
+    REQUIRE(r.GetColor(48, 48) != 0xFF0000FFu);
+    REQUIRE(r.GetDepth(20, 20) == Catch::Approx(0.5f));
+
+    // Back faces are culled
+    r.Clear();
+    std::vector<uint32_t> reversed = { 0, 2, 1, 0, 3, 2 };
+    r.SubmitTriangles(identity, quad.positions.data(), reversed.data(), 6, 0xFF0000FFu);
+    r.Rasterize();
+    REQUIRE(r.GetTriangleCount() == 0);
+    REQUIRE(CountColor(r, 0xFF0000FFu) == 0);
+}
+
+TEST_CASE("Rasterizer depth test is order independent", "[renderer][rasterizer]") {
+    const Math::Mat4 identity = Math::Mat4::Identity();
+    MeshData nearQuad = MakeQuad(-0.5f, -0.5f, 0.5f, 0.5f, -0.5f);
+    MeshData farQuad = MakeQuad(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f);
+
+    for (int order = 0; order < 2; ++order) {
+        Renderer::SoftwareRasterizer r(64, 64);
+        if (order == 0) {
+            r.SubmitTriangles(identity, nearQuad.positions.data(), nearQuad.indices.data(), 6, 0xFF00FF00u);
+            r.SubmitTriangles(identity, farQuad.positions.data(), farQuad.indices.data(), 6, 0xFFFF0000u);
+        } else {
+            r.SubmitTriangles(identity, farQuad.positions.data(), farQuad.indices.data(), 6, 0xFFFF0000u);
+            r.SubmitTriangles(identity, nearQuad.positions.data(), nearQuad.indices.data(), 6, 0xFF00FF00u);
+        }
+        r.Rasterize();
+        REQUIRE(CountColor(r, 0xFF00FF00u) == 32 * 32);
+        REQUIRE(CountColor(r, 0xFFFF0000u) == 64 * 64 - 32 * 32);
+    }
+}
+
+TEST_CASE("Rasterizer clips against the near plane", "[renderer][rasterizer]") {
+    Renderer::SoftwareRasterizer r(64, 64);
+    Math::Mat4 viewProj = Math::Mat4::Perspective(1.5f, 1.0f, 0.5f, 50.0f);
+
+    // A floor passing under and behind the camera
+    std::vector<Math::Vec3> floor = { { -10.0f, -1.0f, 10.0f }, { 10.0f, -1.0f, 10.0f }, { 10.0f, -1.0f, -10.0f }, { -10.0f, -1.0f, -10.0f } };
+    std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+    r.SubmitTriangles(viewProj, floor.data(), indices.data(), 6, 0xFFFFFFFFu);
+    r.Rasterize();
+
+    // Bottom half covered, top half (sky) empty
+    REQUIRE(r.GetColor(32, 60) == 0xFFFFFFFFu);
+    REQUIRE(r.GetColor(32, 4) != 0xFFFFFFFFu);
+    REQUIRE(r.GetDepth(32, 63) < r.GetDepth(32, 40));
+}
+
+TEST_CASE("Rasterizer output does not depend on the thread count", "[renderer][rasterizer]") {
+    MeshData cube = MakeCube();
+    Math::Mat4 viewProj = Math::Mat4::Perspective(1.0f, 4.0f / 3.0f, 0.1f, 100.0f)
+                        * Math::Mat4::LookAt({ 4.0f, 5.0f, 9.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+    auto render = [&]() {
+        Renderer::SoftwareRasterizer r(160, 120);
+        for (int i = 0; i < 27; ++i) {
+            Math::Mat4 world = Math::Mat4::Translation({ float(i % 3) * 1.5f - 1.5f, float(i / 3 % 3) * 1.5f - 1.5f, float(i / 9) * 1.5f - 1.5f });
+            r.SubmitTriangles(viewProj * world, cube.positions.data(), cube.indices.data(),
+                              static_cast<uint32_t>(cube.indices.size()), 0xFF000000u | (i * 0x090705u));
+        }
+        r.Rasterize();
+        return r.ReadColor();
+    };
+
+    Threading::JobSystem::Shutdown();
+    std::vector<uint32_t> serial = render();
+    Threading::JobSystem::Init(4);
+    std::vector<uint32_t> parallel = render();
+    Threading::JobSystem::Shutdown();
+    REQUIRE(serial == parallel);
+}
+
+TEST_CASE("Occlusion queries against the depth buffer", "[renderer][rasterizer]") {
+    Renderer::SoftwareRasterizer r(128, 128);
+    r.SetColorEnabled(false);
+    Math::Mat4 viewProj = Math::Mat4::Perspective(1.2f, 1.0f, 0.1f, 100.0f)
+                        * Math::Mat4::LookAt({ 0.0f, 0.0f, 10.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+    // A 4x4 wall at the origin facing the camera
+    MeshData cube = MakeCube();
+    Math::Mat4 wall = Math::Mat4::Scale({ 4.0f, 4.0f, 0.2f });
+    r.SubmitTriangles(viewProj * wall, cube.positions.data(), cube.indices.data(), static_cast<uint32_t>(cube.indices.size()));
+    r.Rasterize();
+
+    const Math::AABB boxes[] = {
+        Math::AABB::FromCenterExtents({ 0.0f, 0.0f, -5.0f }, Math::Vec3(0.5f)),  // Behind the wall
+        Math::AABB::FromCenterExtents({ 0.0f, 0.0f, 3.0f }, Math::Vec3(0.5f)),   // In front of it
+        Math::AABB::FromCenterExtents({ 6.0f, 0.0f, -5.0f }, Math::Vec3(0.5f)),  // Beside it
+        Math::AABB::FromCenterExtents({ 2.0f, 0.0f, -5.0f }, Math::Vec3(1.0f)),  // Peeking past the edge
+        Math::AABB::FromCenterExtents({ 0.0f, 0.0f, 10.0f }, Math::Vec3(1.0f)),  // Around the camera
+    };
+    REQUIRE_FALSE(r.TestAABB(viewProj, boxes[0]));
+    REQUIRE(r.TestAABB(viewProj, boxes[1]));
+    REQUIRE(r.TestAABB(viewProj, boxes[2]));
+    REQUIRE(r.TestAABB(viewProj, boxes[3]));
+    REQUIRE(r.TestAABB(viewProj, boxes[4]));
+
+    uint8_t visible[5] = {};
+    REQUIRE(r.TestAABBs(viewProj, boxes, 5, visible) == 1);
+    REQUIRE(visible[0] == 0);
+    REQUIRE(visible[1] == 1);
+}
+
+TEST_CASE("Software backend matches golden images", "[renderer][rasterizer][golden]") {
+    MeshData cube = MakeCube();
+    Renderer::SoftwareRenderBackend backend(160, 120);
+    backend.RegisterMesh(1, cube.positions, cube.indices);
+    backend.SetMaterialColor(1, 0xFF3050E0u);
+    backend.SetMaterialColor(2, 0xFF40C040u);
+    backend.SetMaterialColor(3, 0xFFC08030u);
+
+    SECTION("Cube stack") {
+        backend.SetViewProjection(Math::Mat4::Perspective(1.0f, 4.0f / 3.0f, 0.1f, 100.0f)
+                                * Math::Mat4::LookAt({ 3.0f, 3.5f, 6.0f }, { 0.0f, 0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f }));
+
+        // Submission order is deliberately not front-to-back
+        Renderer::CommandBucket bucket;
+        const Math::Mat4 worlds[] = {
+            Math::Mat4::Scale({ 6.0f, 0.2f, 6.0f }),
+            Math::Mat4::FromTRS({ 0.0f, 0.6f, 0.0f }, Math::Quat::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, 0.4f), Math::Vec3(1.0f)),
+            Math::Mat4::FromTRS({ 0.3f, 1.5f, 0.2f }, Math::Quat::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, 1.1f), Math::Vec3(0.7f)),
+        };
+        for (uint32_t i = 0; i < 3; ++i) {
+            Renderer::DrawCommand command;
+            command.world = worlds[i];
+            command.mesh = 1;
+            command.material = i + 1;
+            bucket.Submit(Renderer::SortKey::Make(0, 0, 0, command.material, 0), command);
+        }
+        bucket.Sort();
+
+        backend.BeginFrame();
+        bucket.Execute(backend);
+        backend.EndFrame();
+        RequireMatchesGolden(backend.GetRasterizer(), "cube_stack");
+    }
+
+    SECTION("Camera inside the scene") {
+        // Near-plane clipping and many overlapping tiles
+        backend.SetViewProjection(Math::Mat4::Perspective(1.4f, 4.0f / 3.0f, 0.1f, 60.0f)
+                                * Math::Mat4::LookAt({ 0.0f, 0.5f, 0.0f }, { 5.0f, 0.0f, -3.0f }, { 0.0f, 1.0f, 0.0f }));
+
+        backend.BeginFrame();
+        for (int i = 0; i < 64; ++i) {
+            Renderer::DrawCommand command;
+            command.world = Math::Mat4::FromTRS({ float(i % 8) * 2.0f - 7.0f, float(i % 3) - 1.0f, float(i / 8) * -2.0f + 4.0f },
+                                                Math::Quat::FromAxisAngle({ 0.3f, 1.0f, 0.1f }, float(i) * 0.7f), Math::Vec3(1.2f));
+            command.mesh = 1;
+            backend.BindMaterial(1 + i % 3);
+            backend.Draw(command);
+        }
+        backend.EndFrame();
+        RequireMatchesGolden(backend.GetRasterizer(), "camera_inside");
+    }
+}
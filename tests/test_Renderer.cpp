@@ -0,0 +1,132 @@
+#include <catch2/catch_all.hpp>
+#include "Renderer/CommandBucket.h"
+#include "Renderer/Renderer.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/*
+ * Tests for the backend-agnostic command layer, replayed into the NullRenderBackend.
+ */
+
+TEST_CASE("Sort keys pack and unpack", "[renderer]") {
+    uint64_t key = Renderer::SortKey::Make(3, 2, 1000, 70000, 123456);
+    REQUIRE(Renderer::SortKey::GetLayer(key) == 3);
+    REQUIRE(Renderer::SortKey::GetPass(key) == 2);
+    REQUIRE(Renderer::SortKey::GetShader(key) == 1000);
+    REQUIRE(Renderer::SortKey::GetMaterial(key) == 70000);
+    REQUIRE(Renderer::SortKey::GetDepth(key) == 123456);
+
+    // Layer dominates everything below it
+    REQUIRE(Renderer::SortKey::Make(1, 0, 0, 0, 0) > Renderer::SortKey::Make(0, 15, 4095, 0xFFFFF, 0xFFFFFF));
+
+    // Back-to-front inverts the depth order
+    REQUIRE(Renderer::SortKey::QuantizeDepth(0.25f) < Renderer::SortKey::QuantizeDepth(0.75f));
+    REQUIRE(Renderer::SortKey::QuantizeDepth(0.25f, true) > Renderer::SortKey::QuantizeDepth(0.75f, true));
+}
+
+TEST_CASE("RadixSort matches std::stable_sort", "[renderer]") {
+    std::mt19937_64 rng(11);
+    const size_t count = 5000;
+    std::vector<uint64_t> keys(count), scratchKeys(count);
+    std::vector<uint32_t> values(count), scratchValues(count);
+    std::vector<std::pair<uint64_t, uint32_t>> reference(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        // Few distinct keys so stability matters
+        keys[i] = (rng() % 64) << 40;
+        values[i] = static_cast<uint32_t>(i);
+        reference[i] = { keys[i], values[i] };
+    }
+
+    Renderer::RadixSort(keys.data(), values.data(), scratchKeys.data(), scratchValues.data(), count);
+    std::stable_sort(reference.begin(), reference.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < count; ++i) {
+        REQUIRE(keys[i] == reference[i].first);
+        REQUIRE(values[i] == reference[i].second);
+    }
+}
+
+TEST_CASE("CommandBucket records on workers and replays sorted", "[renderer]") {
+    Threading::JobSystem::Init(4);
+
+    Renderer::CommandBucket bucket;
+    const uint32_t count = 4096;
+
+    Threading::JobContext ctx;
+    Threading::JobSystem::Dispatch(ctx, count, 64, [&](Threading::JobArgs args) {
+        Renderer::DrawCommand command;
+        command.shader = args.jobIndex % 3;
+        command.material = args.jobIndex % 7;
+        command.mesh = args.jobIndex;
+        uint32_t depth = (count - args.jobIndex) * 16;
+        bucket.Submit(Renderer::SortKey::Make(0, 0, command.shader, command.material, depth), command);
+    });
+    Threading::JobSystem::Wait(ctx);
+
+    bucket.Sort();
+    REQUIRE(bucket.GetCount() == count);
+    for (size_t i = 1; i < bucket.GetCount(); ++i)
+        REQUIRE(bucket.GetKey(i - 1) <= bucket.GetKey(i));
+
+    Renderer::NullRenderBackend backend(true);
+    bucket.Execute(backend);
+
+    const auto& stats = backend.GetStats();
+    REQUIRE(stats.frames == 1);
+    REQUIRE(stats.draws == count);
+    // Sorting by shader then material means each pair is bound exactly once
+    REQUIRE(stats.shaderBinds == 3);
+    REQUIRE(stats.materialBinds == 21);
+
+    // Within one shader/material group draws are front to back
+    const auto& draws = backend.GetRecordedDraws();
+    REQUIRE(draws.size() == count);
+    REQUIRE(draws[0].shader == 0);
+    REQUIRE(draws[0].material == 0);
+    REQUIRE(draws[0].mesh > draws[1].mesh);
+
+    bucket.Reset();
+    bucket.Sort();
+    REQUIRE(bucket.GetCount() == 0);
+
+    Threading::JobSystem::Shutdown();
+}
+
+TEST_CASE("CommandBucket created before JobSystem::Init keeps every command", "[renderer]") {
+    Renderer::CommandBucket bucket;
+    Threading::JobSystem::Init(4);
+
+    // No Reset() since the workers came up: they all record into the shared list
+    const uint32_t count = 2048;
+    Threading::JobContext ctx;
+    Threading::JobSystem::Dispatch(ctx, count, 16, [&](Threading::JobArgs args) {
+        Renderer::DrawCommand command;
+        command.mesh = args.jobIndex;
+        bucket.Submit(Renderer::SortKey::Make(0, 0, 0, 0, args.jobIndex), command);
+    });
+    Threading::JobSystem::Wait(ctx);
+
+    bucket.Sort();
+    REQUIRE(bucket.GetCount() == count);
+    for (size_t i = 0; i < bucket.GetCount(); ++i)
+        REQUIRE(bucket.GetCommand(i).mesh == i);
+
+    // After a Reset() every worker has its own list again
+    bucket.Reset();
+    Threading::JobSystem::Dispatch(ctx, count, 16, [&](Threading::JobArgs args) {
+        Renderer::DrawCommand command;
+        command.mesh = args.jobIndex;
+        bucket.Submit(Renderer::SortKey::Make(0, 0, 0, 0, args.jobIndex), command);
+    });
+    Threading::JobSystem::Wait(ctx);
+    bucket.Sort();
+    REQUIRE(bucket.GetCount() == count);
+    REQUIRE(bucket.GetCommand(count - 1).mesh == count - 1);
+
+    Threading::JobSystem::Shutdown();
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_all.hpp>
+#include "Core/Replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+    bool SameBody(const Physics::BodyDesc& a, const Physics::BodyDesc& b) {
+        auto same = [](const Math::Vec3& x, const Math::Vec3& y) { return std::memcmp(&x, &y, sizeof(x)) == 0; };
+        return a.type == b.type && a.shape.type == b.shape.type && a.shape.radius == b.shape.radius &&
+               a.shape.halfHeight == b.shape.halfHeight && same(a.shape.halfExtents, b.shape.halfExtents) &&
+               same(a.position, b.position) && std::memcmp(&a.rotation, &b.rotation, sizeof(a.rotation)) == 0 &&
+               same(a.linearVelocity, b.linearVelocity) && same(a.angularVelocity, b.angularVelocity) && a.mass == b.mass &&
+               a.friction == b.friction && a.restitution == b.restitution && a.allowSleep == b.allowSleep;
+    }
+
+    const Core::ScopeTiming* FindScope(const Core::ReplayReport& report, const std::string& name) {
+        auto it = std::find_if(report.scopes.begin(), report.scopes.end(), [&](const Core::ScopeTiming& s) { return s.name == name; });
+        return it != report.scopes.end() ? &*it : nullptr;
+    }
+
+} // namespace
+
+TEST_CASE("Replays save and load exactly", "[replay]") {
+    const Core::Replay replay = Core::MakeBenchmarkReplay(60, 300, 7);
+    REQUIRE(replay.scene.bodies.size() == 60);
+    REQUIRE(replay.input.size() == 300);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "engine_replay.txt").string();
+    REQUIRE(Core::SaveReplay(path, replay));
+    Core::Replay loaded;
+    REQUIRE(Core::LoadReplay(path, loaded));
+    CHECK(loaded.deltaTime == replay.deltaTime);
+    CHECK(loaded.scene.player == replay.scene.player);
+    REQUIRE(loaded.scene.bodies.size() == replay.scene.bodies.size());
+    for (size_t i = 0; i < replay.scene.bodies.size(); ++i)
+        CHECK(SameBody(loaded.scene.bodies[i], replay.scene.bodies[i]));
+    REQUIRE(loaded.input.size() == replay.input.size());
+    for (size_t frame = 0; frame < replay.input.size(); ++frame) {
+        CHECK(std::equal(std::begin(loaded.input[frame].keysDown), std::end(loaded.input[frame].keysDown),
+                         std::begin(replay.input[frame].keysDown)));
+        CHECK(loaded.input[frame].mouseX == replay.input[frame].mouseX);
+    }
+
+    SECTION("Generating is repeatable") {
+        const Core::Replay again = Core::MakeBenchmarkReplay(60, 300, 7);
+        for (size_t i = 0; i < replay.scene.bodies.size(); ++i)
+            CHECK(SameBody(again.scene.bodies[i], replay.scene.bodies[i]));
+    }
+
+    SECTION("Other files are rejected") {
+        const std::string broken = path + ".broken";
+        std::filesystem::copy_file(path, broken, std::filesystem::copy_options::overwrite_existing);
+        std::ofstream(broken, std::ios::app) << "input\t100000\t0\t0\t0\t0\n";
+        CHECK_FALSE(Core::LoadReplay(broken, loaded));
+        CHECK_FALSE(Core::LoadReplay(path + ".missing", loaded));
+    }
+}
+
+TEST_CASE("Replays simulate the same with any thread count", "[replay]") {
+    const Core::Replay replay = Core::MakeBenchmarkReplay(150, 90);
+
+    Core::ReplayOptions options;
+    options.workerCount = 1;
+    options.warmupFrames = 10;
+    const Core::ReplayReport single = Core::RunReplay(replay, options);
+    options.workerCount = 3;
+    const Core::ReplayReport several = Core::RunReplay(replay, options);
+
+    REQUIRE(single.frameChecksums.size() == 90);
+    CHECK(single.workerCount == 1);
+    CHECK(several.workerCount == 3);
+    CHECK(single.checksum == several.checksum);
+    CHECK(Core::FindDivergence(single, several) == 90);
+
+    // The simulation moves, so the state differs from frame to frame
+    CHECK(single.frameChecksums[0] != single.frameChecksums[89]);
+
+    // Timings leave out the warmup and cover the systems and the physics inside them
+    REQUIRE(!single.scopes.empty());
+    CHECK(single.scopes[0].name == "Frame");
+    CHECK(single.scopes[0].frames == 80);
+    CHECK(single.scopes[0].p50Ms <= single.scopes[0].p99Ms);
+    CHECK(single.scopes[0].p99Ms <= single.scopes[0].maxMs);
+    for (const char* scope : { "ECS::Replay::Physics", "ECS::Replay::Poses", "ECS::Replay::Bounds", "Physics::Step" }) {
+        const Core::ScopeTiming* timing = FindScope(single, scope);
+        REQUIRE(timing != nullptr);
+        CHECK(timing->frames == 80);
+    }
+    CHECK(Core::FormatReplayReport(single).find("Physics::Step") != std::string::npos);
+
+    SECTION("Different input is caught") {
+        Core::Replay steered = replay;
+        for (Core::InputState& state : steered.input)
+            std::fill(std::begin(state.keysDown), std::end(state.keysDown), false);
+        options.workerCount = 1;
+        const Core::ReplayReport idle = Core::RunReplay(steered, options);
+        CHECK(idle.checksum != single.checksum);
+        // The first frame already pushes the player
+        CHECK(Core::FindDivergence(single, idle) == 0);
+    }
+}
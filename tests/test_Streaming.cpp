@@ -0,0 +1,190 @@
+#include <catch2/catch_all.hpp>
+#include "IO/Streaming.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+/*
+ * A row of textures is streamed from one file while a simulated camera flies
+ * past it. Every level is filled with a byte naming its asset and level, so
+ * resident data can be checked against what was asked for.
+ */
+
+namespace {
+
+    constexpr uint32_t kAssetCount = 16;
+    constexpr float    kSpacing = 10.0f;
+
+    struct Scene {
+        std::string                              path;
+        std::vector<std::vector<IO::StreamingLevel>> levels;
+        uint64_t                                 firstLevelBytes = 0;  // Coarsest levels, which ignore the budget
+    };
+
+    uint8_t LevelByte(uint32_t asset, uint32_t level) {
+        return static_cast<uint8_t>(asset * 16 + level + 1);
+    }
+
+    // 128x128 RGBA textures, each 4 world units wide, mips stored back to back
+    Scene WriteScene() {
+        Scene scene;
+        scene.path = (std::filesystem::temp_directory_path() / "engine_streaming_scene.bin").string();
+        std::ofstream file(scene.path, std::ios::binary | std::ios::trunc);
+        uint64_t offset = 0;
+        for (uint32_t asset = 0; asset < kAssetCount; ++asset) {
+            scene.levels.push_back(IO::BuildMipLevels(128, 128, 32, 4.0f, offset));
+            for (uint32_t level = 0; level < scene.levels.back().size(); ++level) {
+                const std::vector<char> bytes(scene.levels.back()[level].size, char(LevelByte(asset, level)));
+                file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                offset += bytes.size();
+            }
+            scene.firstLevelBytes += scene.levels.back().back().size;
+        }
+        return scene;
+    }
+
+    void RegisterScene(IO::StreamingManager& manager, const Scene& scene) {
+        for (uint32_t asset = 0; asset < kAssetCount; ++asset)
+            manager.Register(scene.path, scene.levels[asset], { asset * kSpacing, 0.0f, 0.0f }, 2.0f);
+    }
+
+    // Updates until a frame reads nothing and nothing is in flight
+    void Settle(IO::StreamingManager& manager, const IO::StreamingView& view) {
+        for (uint32_t frame = 0; frame < 5000; ++frame) {
+            const uint64_t issued = manager.GetStats().readsIssued;
+            manager.Update(view);
+            if (manager.GetStats().readsIssued == issued && manager.GetStats().pendingBytes == 0)
+                return;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    bool ResidentDataMatches(const IO::StreamingManager& manager, uint32_t asset, const Scene& scene) {
+        for (uint32_t level = 0; level < scene.levels[asset].size(); ++level) {
+            const uint8_t* data = static_cast<const uint8_t*>(manager.GetLevelData(asset, level));
+            if ((data != nullptr) != (level >= manager.GetResidentLevel(asset)))
+                return false;
+            if (data && (data[0] != LevelByte(asset, level) || data[scene.levels[asset][level].size - 1] != LevelByte(asset, level)))
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+TEST_CASE("Mip levels and LOD selection", "[io]") {
+    const std::vector<IO::StreamingLevel> levels = IO::BuildMipLevels(256, 64, 32, 8.0f, 100);
+    REQUIRE(levels.size() == 9);
+    CHECK(levels[0].offset == 100);
+    CHECK(levels[0].size == 256 * 64 * 4);
+    CHECK(levels[1].offset == 100 + 256 * 64 * 4);
+    CHECK(levels[1].size == 128 * 32 * 4);
+    CHECK(levels[8].size == 4);
+    CHECK(levels[0].error == Catch::Approx(8.0f / 256));
+    CHECK(levels[8].error == Catch::Approx(8.0f));
+
+    // Level 1 texels (1/16 unit) are a pixel wide from 1000 / 16 units away
+    IO::StreamingView view;
+    CHECK(IO::SelectStreamingLevel(levels, 1.0f, view) == 0);
+    CHECK(IO::SelectStreamingLevel(levels, 60.0f, view) == 0);
+    CHECK(IO::SelectStreamingLevel(levels, 70.0f, view) == 1);
+    CHECK(IO::SelectStreamingLevel(levels, 1e6f, view) == 8);
+    uint32_t previous = 0;
+    for (float distance = 1.0f; distance < 1e5f; distance *= 1.3f) {
+        const uint32_t level = IO::SelectStreamingLevel(levels, distance, view);
+        CHECK(level >= previous);
+        previous = level;
+    }
+    view.maxPixelError = 4.0f;
+    CHECK(IO::SelectStreamingLevel(levels, 40.0f, view) == 2);
+
+    std::vector<IO::MeshLod> lods(2);
+    lods[0] = { 0, 300, 0.0f };
+    lods[1] = { 300, 90, 0.5f };
+    const std::vector<IO::StreamingLevel> meshLevels = IO::BuildLodLevels(lods, 64);
+    CHECK(meshLevels[1].offset == 64 + 300 * 4);
+    CHECK(meshLevels[1].size == 90 * 4);
+    CHECK(IO::SelectStreamingLevel(meshLevels, 1.0f, view) == 0);
+    CHECK(IO::SelectStreamingLevel(meshLevels, 1000.0f, view) == 1);
+}
+
+TEST_CASE("Streaming follows a camera path to full detail", "[io]") {
+    const Scene scene = WriteScene();
+    IO::FileSystem fs;
+    IO::StreamingManager manager(fs, ~0ull);
+    RegisterScene(manager, scene);
+
+    IO::StreamingView view;
+    view.position = { -20.0f, 5.0f, 10.0f };
+    for (uint32_t frame = 0; frame < 60; ++frame) {
+        view.position.x += 3.0f;
+        manager.Update(view);
+    }
+    Settle(manager, view);
+    const IO::StreamingStats& stats = manager.GetStats();
+    REQUIRE(stats.assetsAtWantedLevel == kAssetCount);
+    CHECK(stats.missingBytes == 0);
+    CHECK(stats.bytesStreamed >= stats.residentBytes);
+    for (uint32_t asset = 0; asset < kAssetCount; ++asset) {
+        CHECK(manager.GetResidentLevel(asset) <= manager.GetWantedLevel(asset));
+        CHECK(ResidentDataMatches(manager, asset, scene));
+    }
+    // The nearest texture is at full detail, the farthest is not
+    CHECK(manager.GetWantedLevel(kAssetCount - 3) == 0);
+    CHECK(manager.GetWantedLevel(0) > 0);
+
+    SECTION("Nothing more is read once settled") {
+        const uint64_t streamed = stats.bytesStreamed;
+        for (uint32_t frame = 0; frame < 10; ++frame)
+            manager.Update(view);
+        CHECK(stats.bytesStreamed == streamed);
+    }
+}
+
+TEST_CASE("Streaming stays within its budget and sheds distant detail first", "[io]") {
+    const Scene scene = WriteScene();
+    IO::FileSystem fs;
+    const uint64_t levelZero = scene.levels[0][0].size;
+    const uint64_t budget = scene.firstLevelBytes + 3 * levelZero;
+    IO::StreamingManager manager(fs, budget);
+    RegisterScene(manager, scene);
+
+    // Close to the whole row, every texture wants its finest level
+    IO::StreamingView view;
+    view.position = { 0.0f, 5.0f, 5.0f };
+    view.maxPixelError = 0.01f;
+    uint64_t peak = 0;
+    for (uint32_t frame = 0; frame < 300; ++frame) {
+        view.position.x = frame * (kAssetCount * kSpacing) / 300.0f;
+        manager.Update(view);
+        peak = std::max(peak, manager.GetStats().residentBytes + manager.GetStats().pendingBytes);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    // First levels may go over, nothing else does
+    CHECK(peak <= budget + scene.firstLevelBytes);
+    CHECK(manager.GetStats().residentBytes + manager.GetStats().pendingBytes <= budget);
+    CHECK(manager.GetStats().bytesEvicted > 0);
+
+    Settle(manager, view);
+    // Whatever is resident is right, and detail falls off away from the camera
+    const uint32_t nearest = kAssetCount - 1;
+    CHECK(manager.GetResidentLevel(nearest) == 0);
+    CHECK(manager.GetResidentLevel(0) > 0);
+    for (uint32_t asset = 0; asset < kAssetCount; ++asset) {
+        CHECK(ResidentDataMatches(manager, asset, scene));
+        CHECK(manager.GetResidentLevel(asset) < scene.levels[asset].size());
+        if (asset + 1 < kAssetCount)
+            CHECK(manager.GetResidentLevel(asset) >= manager.GetResidentLevel(asset + 1));
+    }
+
+    SECTION("Lowering the budget evicts down to it") {
+        manager.SetBudget(scene.firstLevelBytes);
+        manager.Update(view);
+        CHECK(manager.GetStats().residentBytes <= scene.firstLevelBytes + manager.GetStats().pendingBytes);
+        for (uint32_t asset = 0; asset < kAssetCount; ++asset)
+            CHECK(manager.GetResidentLevel(asset) == scene.levels[asset].size() - 1);
+    }
+}
@@ -0,0 +1,249 @@
+#include <catch2/catch_all.hpp>
+#include "Core/Application.h"
+#include "Utils/Telemetry.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // Waits until the server has taken every connection made so far
+    bool WaitForClients(const TelemetryServer& server, uint32_t count) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (server.GetClientCount() != count) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // A connection and the decoder of its stream
+    struct Viewer {
+        TelemetryClient  client;
+        TelemetryDecoder decoder;
+    };
+
+    // Receives and decodes until count frames arrived, the connection closed or time ran out
+    std::vector<TelemetryFrame> ReceiveFrames(Viewer& viewer, size_t count, std::vector<uint8_t>* capture = nullptr) {
+        std::vector<TelemetryFrame> frames;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (frames.size() < count && std::chrono::steady_clock::now() < deadline) {
+            std::vector<uint8_t> bytes;
+            const bool open = viewer.client.Receive(bytes, 10);
+            if (capture)
+                capture->insert(capture->end(), bytes.begin(), bytes.end());
+            if (!viewer.decoder.Feed(bytes.data(), bytes.size(), [&](const TelemetryFrame& frame) { frames.push_back(frame); }) || !open)
+                break;
+        }
+        return frames;
+    }
+
+    TelemetryFrame MakeFrame(uint32_t eventCount) {
+        TelemetryFrame frame;
+        frame.frameMs = 16.5;
+        for (uint32_t i = 0; i < eventCount; ++i)
+            frame.events.push_back({ "Scope" + std::to_string(i % 7), i % 3, 0.25 * i, 0.125 + i });
+        frame.counters = { { "ECS.CriticalPathMs", 3.75 }, { "Streaming.ResidentBytes", 1048576.0 } };
+        return frame;
+    }
+
+} // namespace
+
+TEST_CASE("Telemetry frames round-trip over a Unix socket", "[telemetry]") {
+    const std::string path = (std::filesystem::temp_directory_path() / "engine_telemetry.sock").string();
+    TelemetryServer server;
+    REQUIRE(server.Start("unix:" + path));
+    CHECK(server.GetEndpoint() == "unix:" + path);
+
+    Viewer viewer;
+    REQUIRE(viewer.client.Connect(server.GetEndpoint()));
+    REQUIRE(WaitForClients(server, 1));
+
+    TelemetryFrame sent = MakeFrame(20);
+    sent.events[3].startMs = -0.5;  // Began before the frame did
+    for (int i = 0; i < 3; ++i)
+        server.Publish(sent);
+    std::vector<uint8_t> capture;
+    const std::vector<TelemetryFrame> frames = ReceiveFrames(viewer, 3, &capture);
+    REQUIRE(frames.size() == 3);
+    for (uint64_t i = 0; i < 3; ++i) {
+        const TelemetryFrame& frame = frames[i];
+        CHECK(frame.index == i);
+        CHECK(frame.frameMs == 16.5);
+        REQUIRE(frame.events.size() == sent.events.size());
+        for (size_t e = 0; e < frame.events.size(); ++e) {
+            CHECK(frame.events[e].name == sent.events[e].name);
+            CHECK(frame.events[e].threadIndex == sent.events[e].threadIndex);
+            CHECK(frame.events[e].startMs == Catch::Approx(sent.events[e].startMs).margin(1e-6));
+            CHECK(frame.events[e].durationMs == Catch::Approx(sent.events[e].durationMs).margin(1e-6));
+        }
+        CHECK(frame.counters == sent.counters);
+    }
+
+    SECTION("A capture decodes the same a byte at a time") {
+        TelemetryDecoder decoder;
+        size_t decoded = 0;
+        for (uint8_t byte : capture)
+            REQUIRE(decoder.Feed(&byte, 1, [&](const TelemetryFrame& frame) { CHECK(frame.index == decoded++); }));
+        CHECK(decoded == 3);
+    }
+
+    SECTION("Stopping disconnects viewers and removes the socket") {
+        server.Stop();
+        std::vector<uint8_t> bytes;
+        bool open = true;
+        for (int i = 0; i < 100 && open; ++i)
+            open = viewer.client.Receive(bytes, 10);
+        CHECK_FALSE(open);
+        CHECK_FALSE(std::filesystem::exists(path));
+    }
+}
+
+TEST_CASE("Telemetry only replaces stale sockets", "[telemetry]") {
+    const std::string path = (std::filesystem::temp_directory_path() / "engine_telemetry_owned.sock").string();
+    std::filesystem::remove(path);
+
+    SECTION("A file that is not a socket is kept") {
+        std::ofstream(path) << "precious";
+        TelemetryServer server;
+        CHECK_FALSE(server.Start("unix:" + path));
+        std::ifstream file(path);
+        std::string contents;
+        file >> contents;
+        CHECK(contents == "precious");
+    }
+
+    SECTION("A live server keeps its socket") {
+        TelemetryServer first;
+        REQUIRE(first.Start("unix:" + path));
+        TelemetryServer second;
+        CHECK_FALSE(second.Start("unix:" + path));
+
+        Viewer viewer;
+        REQUIRE(viewer.client.Connect(first.GetEndpoint()));
+        REQUIRE(WaitForClients(first, 1));
+        first.Publish(MakeFrame(3));
+        CHECK(ReceiveFrames(viewer, 1).size() == 1);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    SECTION("A socket nothing listens on is replaced") {
+        // What a process that died without Stop() leaves behind
+        const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+        REQUIRE(descriptor >= 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        REQUIRE(bind(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        close(descriptor);
+        REQUIRE(std::filesystem::is_socket(path));
+
+        TelemetryServer server;
+        CHECK(server.Start("unix:" + path));
+    }
+#endif
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Telemetry serves late and stalled viewers", "[telemetry]") {
+    TelemetryServer server;
+    REQUIRE(server.Start("tcp:0"));
+    REQUIRE(server.GetEndpoint() != "tcp:0");
+
+    Viewer early;
+    REQUIRE(early.client.Connect(server.GetEndpoint()));
+    REQUIRE(WaitForClients(server, 1));
+    server.Publish(MakeFrame(7));
+    REQUIRE(ReceiveFrames(early, 1).size() == 1);
+
+    // Joining later still gets the names the first frames interned
+    Viewer late;
+    REQUIRE(late.client.Connect(server.GetEndpoint()));
+    REQUIRE(WaitForClients(server, 2));
+    server.Publish(MakeFrame(7));
+    const std::vector<TelemetryFrame> frames = ReceiveFrames(late, 1);
+    REQUIRE(frames.size() == 1);
+    CHECK(frames[0].index == 1);
+    CHECK(frames[0].events[6].name == "Scope6");
+
+    // Neither viewer reads from here on; publishing would never finish if it waited on them
+    const TelemetryFrame large = MakeFrame(2000);
+    for (int i = 0; i < 1000; ++i)
+        server.Publish(large);
+    CHECK(server.GetDroppedFrames() > 0);
+
+    // A viewer that catches up again gets whole frames, in order
+    std::vector<TelemetryFrame> caughtUp = ReceiveFrames(late, 8);
+    REQUIRE(caughtUp.size() >= 8);
+    for (size_t i = 1; i < caughtUp.size(); ++i)
+        CHECK(caughtUp[i].index > caughtUp[i - 1].index);
+    CHECK(caughtUp.back().events.size() == 2000);
+}
+
+TEST_CASE("Telemetry decoder rejects other streams", "[telemetry]") {
+    auto ignore = [](const TelemetryFrame&) {};
+    const char text[] = "GET / HTTP/1.1\r\n";
+    TelemetryDecoder http;
+    CHECK_FALSE(http.Feed(text, sizeof(text) - 1, ignore));
+    CHECK_FALSE(http.Feed("ETLM\x01", 5, ignore));
+
+    // A frame naming a string never sent
+    const uint8_t frame[] = { 'E', 'T', 'L', 'M', kTelemetryVersion, 2, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 5 };
+    TelemetryDecoder unnamed;
+    CHECK_FALSE(unnamed.Feed(frame, sizeof(frame), ignore));
+
+    TelemetryServer server;
+    CHECK_FALSE(server.Start("udp:9000"));
+    CHECK_FALSE(server.Start("tcp:99999"));
+    CHECK_FALSE(server.IsRunning());
+}
+
+TEST_CASE("Application streams profiler frames when asked", "[telemetry][application]") {
+    Core::ApplicationSettings settings;
+    settings.headless = true;
+    settings.workerCount = 1;
+    settings.telemetryEndpoint = "tcp:0";
+    Core::Application app(settings);
+    REQUIRE(app.Init());
+    TelemetryServer* server = app.GetTelemetry();
+    REQUIRE(server != nullptr);
+    REQUIRE(server->IsRunning());
+
+    Viewer viewer;
+    REQUIRE(viewer.client.Connect(server->GetEndpoint()));
+    REQUIRE(WaitForClients(*server, 1));
+    Profiling::StartFrame();
+    {
+        ProfileScope scope("Telemetry::Test");
+    }
+    Profiling::SetCounter("Telemetry.TestCounter", 42.0);
+    server->PublishProfilingFrame(8.0);
+
+    const std::vector<TelemetryFrame> frames = ReceiveFrames(viewer, 1);
+    REQUIRE(frames.size() == 1);
+    CHECK(frames[0].frameMs == 8.0);
+    REQUIRE(frames[0].events.size() == 1);
+    CHECK(frames[0].events[0].name == "Telemetry::Test");
+    auto counter = [&](const std::string& name) {
+        for (const auto& [counterName, value] : frames[0].counters) {
+            if (counterName == name)
+                return value;
+        }
+        return -1.0;
+    };
+    CHECK(counter("Telemetry.TestCounter") == 42.0);
+    CHECK(counter("Memory.Current") >= 0.0);
+    app.Shutdown();
+    CHECK(app.GetTelemetry() == nullptr);
+}
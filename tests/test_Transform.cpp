@@ -0,0 +1,125 @@
+#include <catch2/catch_all.hpp>
+#include "Core/Transform.h"
+#include "Threading/JobSystem.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+    bool ApproxEqual(const Math::Vec3& a, const Math::Vec3& b, float eps = 1e-4f) {
+        return std::fabs(a.x - b.x) <= eps && std::fabs(a.y - b.y) <= eps && std::fabs(a.z - b.z) <= eps;
+    }
+
+    Math::Vec3 WorldPosition(const Core::TransformHierarchy& h, Core::TransformHandle node) {
+        return h.GetWorldMatrix(node).columns[3].XYZ();
+    }
+
+} // namespace
+
+TEST_CASE("TransformHierarchy composes parent and child", "[transform]") {
+    Core::TransformHierarchy hierarchy;
+    auto root = hierarchy.Create();
+    auto child = hierarchy.Create(root);
+    auto grandChild = hierarchy.Create(child);
+
+    hierarchy.SetLocalPosition(root, { 10.0f, 0.0f, 0.0f });
+    hierarchy.SetLocalRotation(root, Math::Quat::FromAxisAngle({ 0.0f, 0.0f, 1.0f }, 3.14159265f * 0.5f));
+    hierarchy.SetLocalPosition(child, { 1.0f, 0.0f, 0.0f });
+    hierarchy.SetLocal(grandChild, { 0.0f, 1.0f, 0.0f }, Math::Quat::Identity(), Math::Vec3(2.0f));
+
+    REQUIRE(hierarchy.Update() == 3);
+    REQUIRE(hierarchy.GetMaxDepth() == 2);
+    REQUIRE(ApproxEqual(WorldPosition(hierarchy, child), { 10.0f, 1.0f, 0.0f }));
+    REQUIRE(ApproxEqual(WorldPosition(hierarchy, grandChild), { 9.0f, 1.0f, 0.0f }));
+
+    SECTION("Clean nodes are not recomputed") {
+        REQUIRE(hierarchy.Update() == 0);
+        REQUIRE_FALSE(hierarchy.WasUpdated(root));
+    }
+
+    SECTION("A dirty node updates only its subtree") {
+        auto other = hierarchy.Create();
+        hierarchy.Update();
+
+        hierarchy.SetLocalPosition(child, { 2.0f, 0.0f, 0.0f });
+        REQUIRE(hierarchy.Update() == 2);
+        REQUIRE(hierarchy.WasUpdated(child));
+        REQUIRE(hierarchy.WasUpdated(grandChild));
+        REQUIRE_FALSE(hierarchy.WasUpdated(root));
+        REQUIRE_FALSE(hierarchy.WasUpdated(other));
+        REQUIRE(ApproxEqual(WorldPosition(hierarchy, grandChild), { 9.0f, 2.0f, 0.0f }));
+    }
+
+    SECTION("Re-parenting moves the node into the new subtree") {
+        auto other = hierarchy.Create();
+        hierarchy.SetLocalPosition(other, { 0.0f, 0.0f, 5.0f });
+        hierarchy.SetParent(child, other);
+        hierarchy.Update();
+
+        REQUIRE(hierarchy.GetParent(child) == other);
+        REQUIRE(ApproxEqual(WorldPosition(hierarchy, child), { 1.0f, 0.0f, 5.0f }));
+        REQUIRE(ApproxEqual(WorldPosition(hierarchy, grandChild), { 1.0f, 1.0f, 5.0f }));
+
+        // Cycles are rejected
+        hierarchy.SetParent(other, grandChild);
+        REQUIRE(hierarchy.GetParent(other) == Core::InvalidTransform);
+    }
+
+    SECTION("Destroying a node releases its subtree") {
+        auto sibling = hierarchy.Create(child);
+        auto moved = hierarchy.Create(child);
+        hierarchy.SetParent(moved, root);
+
+        // The whole subtree is gone before the next Update()
+        hierarchy.Destroy(child);
+        REQUIRE(hierarchy.IsValid(root));
+        REQUIRE(hierarchy.IsValid(moved));
+        REQUIRE_FALSE(hierarchy.IsValid(child));
+        REQUIRE_FALSE(hierarchy.IsValid(grandChild));
+        REQUIRE_FALSE(hierarchy.IsValid(sibling));
+        REQUIRE(hierarchy.GetCount() == 2);
+
+        hierarchy.Update();
+        REQUIRE(hierarchy.GetCount() == 2);
+        REQUIRE(hierarchy.GetParent(moved) == root);
+
+        // Released handles come back as fresh nodes
+        auto reused = hierarchy.Create(moved);
+        hierarchy.Destroy(moved);
+        REQUIRE_FALSE(hierarchy.IsValid(reused));
+        REQUIRE(hierarchy.GetCount() == 1);
+    }
+}
+
+TEST_CASE("TransformHierarchy parallel update matches serial update", "[transform]") {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+
+    // Wide enough levels to be split across workers
+    auto build = [&](Core::TransformHierarchy& h, std::vector<Core::TransformHandle>& nodes) {
+        rng.seed(99);
+        for (int i = 0; i < 20000; ++i) {
+            Core::TransformHandle parent = (i < 8) ? Core::InvalidTransform : nodes[rng() % nodes.size()];
+            auto node = h.Create(parent);
+            h.SetLocal(node, { d(rng), d(rng), d(rng) }, Math::Quat::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, d(rng)), Math::Vec3(1.0f));
+            nodes.push_back(node);
+        }
+    };
+
+    Core::TransformHierarchy serial, parallel;
+    std::vector<Core::TransformHandle> serialNodes, parallelNodes;
+
+    Threading::JobSystem::Shutdown();
+    build(serial, serialNodes);
+    serial.Update();
+
+    Threading::JobSystem::Init(4);
+    build(parallel, parallelNodes);
+    REQUIRE(parallel.Update() == 20000);
+
+    for (size_t i = 0; i < serialNodes.size(); ++i)
+        REQUIRE(WorldPosition(serial, serialNodes[i]) == WorldPosition(parallel, parallelNodes[i]));
+
+    Threading::JobSystem::Shutdown();
+}
@@ -0,0 +1,48 @@
+#include "IO/Archive.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/*
+ * AssetPacker <content dir> <output archive> [--align N] [--codec auto|none|lz4|lz4hc]
+ *
+ * Packs every file below the content directory into one archive for
+ * IO::FileSystem::Mount(). N (default 16) is the alignment of every entry's
+ * data; use 4096 for entries that are uploaded or mapped page by page. The
+ * codec defaults to auto, which picks one per asset type (IO::ChooseCodec).
+ */
+
+int main(int argc, char* argv[]) {
+    IO::PackSettings settings;
+    bool valid = argc >= 3 && argc % 2 == 1;
+    for (int i = 3; valid && i + 1 < argc; i += 2) {
+        const std::string value = argv[i + 1];
+        if (std::strcmp(argv[i], "--align") == 0) {
+            settings.alignment = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (std::strcmp(argv[i], "--codec") == 0) {
+            if (value == "none" || value == "lz4" || value == "lz4hc") {
+                const IO::Codec codec = value == "none" ? IO::Codec::None : (value == "lz4" ? IO::Codec::LZ4 : IO::Codec::LZ4HC);
+                settings.chooseCodec = [codec](std::string_view) { return codec; };
+            } else {
+                valid = value == "auto";
+            }
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::fprintf(stderr, "usage: %s <content dir> <output archive> [--align N] [--codec auto|none|lz4|lz4hc]\n", argv[0]);
+        return 2;
+    }
+
+    const std::vector<std::string> paths = IO::Archive::ListFiles(argv[1]);
+    std::string error;
+    if (!IO::Archive::Build(argv[1], paths, argv[2], settings, error)) {
+        std::fprintf(stderr, "AssetPacker: %s\n", error.c_str());
+        return 1;
+    }
+    std::printf("Packed %zu files into %s\n", paths.size(), argv[2]);
+    return 0;
+}
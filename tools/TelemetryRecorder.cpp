@@ -0,0 +1,182 @@
+#include "Utils/Telemetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * TelemetryRecorder <endpoint> <capture file> [--frames N] [--seconds S]
+ * TelemetryRecorder --summary <capture file>
+ *
+ * Connects to a running engine's TelemetryServer ("unix:<path>" or
+ * "tcp:<port>", see ApplicationSettings::telemetryEndpoint) and saves the
+ * stream to disk as it arrives, printing a line per second of what it sees.
+ * Recording stops after N frames or S seconds, when the engine goes away, or
+ * on Ctrl+C, then prints a summary of the capture.
+ *
+ * --summary prints the same summary for an earlier capture: frame times,
+ * the scopes that took longest and the last value of every counter.
+ */
+
+namespace {
+
+    std::atomic<bool> g_Interrupted{ false };
+
+    // What a capture holds, frame by frame
+    struct Summary {
+        std::vector<double> frameMs;
+        std::unordered_map<std::string, double> scopeMs;        // Summed over frames
+        std::vector<std::pair<std::string, double>> counters;   // Of the last frame
+        uint64_t firstIndex = 0;
+        uint64_t lastIndex = 0;
+
+        void Add(const TelemetryFrame& frame) {
+            if (frameMs.empty())
+                firstIndex = frame.index;
+            lastIndex = frame.index;
+            frameMs.push_back(frame.frameMs);
+            for (const ProfileEvent& event : frame.events)
+                scopeMs[event.name] += event.durationMs;
+            counters = frame.counters;
+        }
+
+        void Print() const {
+            if (frameMs.empty()) {
+                std::printf("no frames\n");
+                return;
+            }
+            std::vector<double> sorted = frameMs;
+            std::sort(sorted.begin(), sorted.end());
+            auto percentile = [&](double p) { return sorted[std::min(sorted.size() - 1, size_t(p * sorted.size()))]; };
+            double total = 0.0;
+            for (double ms : frameMs)
+                total += ms;
+            // Frames the server skipped for this viewer leave gaps in the numbering
+            std::printf("%zu frames (%llu to %llu, %llu missed)\n", frameMs.size(), (unsigned long long)firstIndex,
+                        (unsigned long long)lastIndex, (unsigned long long)(lastIndex - firstIndex + 1 - frameMs.size()));
+            std::printf("frame ms: avg %.3f  p50 %.3f  p99 %.3f  max %.3f\n", total / frameMs.size(), percentile(0.5),
+                        percentile(0.99), sorted.back());
+
+            std::vector<std::pair<std::string, double>> scopes(scopeMs.begin(), scopeMs.end());
+            std::sort(scopes.begin(), scopes.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+            if (scopes.size() > 10)
+                scopes.resize(10);
+            std::printf("longest scopes (ms per frame):\n");
+            for (const auto& [name, ms] : scopes)
+                std::printf("  %10.3f  %s\n", ms / frameMs.size(), name.c_str());
+            std::printf("counters:\n");
+            for (const auto& [name, value] : counters)
+                std::printf("  %14.3f  %s\n", value, name.c_str());
+        }
+    };
+
+    int PrintSummary(const char* capturePath) {
+        std::ifstream file(capturePath, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot open '%s'\n", capturePath);
+            return 1;
+        }
+        TelemetryDecoder decoder;
+        Summary summary;
+        std::vector<char> chunk(1 << 16);
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            if (!decoder.Feed(chunk.data(), static_cast<size_t>(file.gcount()), [&](const TelemetryFrame& frame) { summary.Add(frame); })) {
+                std::fprintf(stderr, "'%s' is not a telemetry capture, or is corrupt\n", capturePath);
+                return 1;
+            }
+        }
+        summary.Print();
+        return 0;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::strcmp(argv[1], "--summary") == 0)
+        return PrintSummary(argv[2]);
+
+    uint64_t maxFrames = 0;
+    double maxSeconds = 0.0;
+    bool valid = argc >= 3;
+    for (int i = 3; valid && i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            maxFrames = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            maxSeconds = std::strtod(argv[++i], nullptr);
+        else
+            valid = false;
+    }
+    if (!valid) {
+        std::fprintf(stderr, "usage: %s <endpoint> <capture file> [--frames N] [--seconds S]\n"
+                             "       %s --summary <capture file>\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    // The engine may still be starting
+    TelemetryClient client;
+    const auto start = std::chrono::steady_clock::now();
+    while (!client.Connect(argv[1])) {
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+            std::fprintf(stderr, "cannot connect to '%s'\n", argv[1]);
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::ofstream capture(argv[2], std::ios::binary | std::ios::trunc);
+    if (!capture) {
+        std::fprintf(stderr, "cannot write '%s'\n", argv[2]);
+        return 1;
+    }
+    std::signal(SIGINT, [](int) { g_Interrupted = true; });
+
+    TelemetryDecoder decoder;
+    Summary summary;
+    std::vector<uint8_t> bytes;
+    uint64_t totalBytes = 0;
+    size_t reportedFrames = 0;
+    auto nextReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    const auto recordStart = std::chrono::steady_clock::now();
+    bool open = true;
+    while (open && !g_Interrupted) {
+        bytes.clear();
+        open = client.Receive(bytes, 100);
+        capture.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        totalBytes += bytes.size();
+        if (!decoder.Feed(bytes.data(), bytes.size(), [&](const TelemetryFrame& frame) { summary.Add(frame); })) {
+            std::fprintf(stderr, "'%s' does not speak the telemetry protocol\n", argv[1]);
+            return 1;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextReport && summary.frameMs.size() > reportedFrames) {
+            double sum = 0.0, worst = 0.0;
+            for (size_t i = reportedFrames; i < summary.frameMs.size(); ++i) {
+                sum += summary.frameMs[i];
+                worst = std::max(worst, summary.frameMs[i]);
+            }
+            const size_t frames = summary.frameMs.size() - reportedFrames;
+            std::printf("frame %llu: %zu frames, %.3f ms avg, %.3f ms max, %.1f KiB received\n",
+                        (unsigned long long)summary.lastIndex, frames, sum / frames, worst, totalBytes / 1024.0);
+            std::fflush(stdout);
+            reportedFrames = summary.frameMs.size();
+            nextReport = now + std::chrono::seconds(1);
+        }
+        if ((maxFrames > 0 && summary.frameMs.size() >= maxFrames) ||
+            (maxSeconds > 0.0 && std::chrono::duration<double>(now - recordStart).count() >= maxSeconds))
+            break;
+    }
+    capture.close();
+    std::printf("recorded %.1f KiB to %s\n", totalBytes / 1024.0, argv[2]);
+    summary.Print();
+    return 0;
+}